@@ -0,0 +1,694 @@
+/*
+ * CC3GLCommandTool.c
+ *
+ * cocos3d 0.7.1
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2012 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+
+/**
+ * Offline analysis of the GL command streams recorded by CC3OpenGLES11Recorder.
+ *
+ * This tool does not need OpenGL ES, or a GPU, and builds with any C99 compiler:
+ *
+ *   cc -std=c99 -O2 -I../cocos3d/cocos3d/OpenGLES11 -o CC3GLCommandTool CC3GLCommandTool.c
+ *
+ * Usage:
+ *
+ *   CC3GLCommandTool [-commands] [-replay iterations] capture-file
+ *
+ * By default, the tool reports, for each frame in the command stream, the number of GL
+ * calls, the number of draw calls, the number of state-setting calls and how many of
+ * those were redundant, and the number of bytes of buffer, texture and client vertex data
+ * uploaded to GL. A state-setting call is redundant if it sets a piece of GL state to the
+ * value it already had. Commands recorded before the first frame marker are reported as
+ * the setup frame.
+ *
+ * With -commands, the tool also reports the number of calls, and redundant calls, for
+ * each GL function over the whole stream.
+ *
+ * With -replay, the tool replays each frame the specified number of times against a null
+ * driver, which decodes and dispatches every command and copies uploaded data as a driver
+ * would, but does nothing else. The resulting times are a repeatable measure of the CPU
+ * cost of submitting each frame, independent of any GPU.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "CC3OpenGLES11CommandStream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// The few GL enumeration values needed to work out which piece of GL state a command sets.
+#define kCC3GL_TEXTURE_2D				0x0DE1
+#define kCC3GL_TEXTURE_COORD_ARRAY		0x8078
+#define kCC3GL_TEXTURE0					0x84C0
+#define kCC3GL_ARRAY_BUFFER				0x8892
+
+/** The maximum number of texture units whose bindings are tracked. */
+#define kCC3MaxTextureUnits				8
+
+
+#pragma mark Command descriptions
+
+#define CC3GLCommandNameEntry(glName, category)		#glName,
+#define CC3GLCommandCategoryEntry(glName, category)	kCC3GLCommandCategory##category,
+
+static const char* commandNames[kCC3GLCmdCount] = {
+	"Frame",
+	"ClientArray",
+	CC3GLCommandList(CC3GLCommandNameEntry)
+};
+
+static const CC3GLCommandCategory commandCategories[kCC3GLCmdCount] = {
+	kCC3GLCommandCategoryMarker,
+	kCC3GLCommandCategoryUpload,
+	CC3GLCommandList(CC3GLCommandCategoryEntry)
+};
+
+/** A command read from a command stream. */
+typedef struct {
+	uint32_t opcode;
+	uint32_t wordCount;
+	const uint32_t* words;
+	const uint8_t* data;
+	uint32_t dataLength;
+} CC3GLCommand;
+
+/**
+ * Reads the command at the specified offset in the stream into the specified command,
+ * and returns the offset of the next command, or zero if the stream is truncated.
+ */
+static size_t CC3GLReadCommand(const uint8_t* stream, size_t streamLength, size_t offset, CC3GLCommand* cmd) {
+	CC3GLCommandHeader header;
+	if (offset + sizeof(header) > streamLength) return 0;
+	memcpy(&header, stream + offset, sizeof(header));
+	offset += sizeof(header);
+
+	size_t wordsLength = header.wordCount * sizeof(uint32_t);
+	size_t paddedLength = CC3GLCommandPaddedDataLength(header.dataLength);
+	if (offset + wordsLength + paddedLength > streamLength) return 0;
+
+	cmd->opcode = header.opcode;
+	cmd->wordCount = header.wordCount;
+	cmd->words = (const uint32_t*)(stream + offset);
+	cmd->data = stream + offset + wordsLength;
+	cmd->dataLength = header.dataLength;
+	return offset + wordsLength + paddedLength;
+}
+
+/** Returns the parameter word at the specified index, or zero if the command has fewer words. */
+static uint32_t CC3GLCommandWord(const CC3GLCommand* cmd, uint32_t index) {
+	return (index < cmd->wordCount) ? cmd->words[index] : 0;
+}
+
+
+#pragma mark Redundant state detection
+
+/** A hash table mapping a piece of GL state to a hash of the last value it was set to. */
+typedef struct {
+	uint64_t* keys;
+	uint64_t* values;
+	size_t capacity;
+	size_t count;
+} CC3GLStateTable;
+
+/** FNV-1a hash of the specified bytes, continuing from the specified hash. */
+static uint64_t CC3Hash(uint64_t hash, const void* bytes, size_t length) {
+	const uint8_t* p = bytes;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= p[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+#define kCC3HashSeed		14695981039346656037ULL
+
+static int CC3GLStateTableSet(CC3GLStateTable* table, uint64_t key, uint64_t value);
+
+static void CC3GLStateTableGrow(CC3GLStateTable* table) {
+	CC3GLStateTable old = *table;
+	table->capacity = old.capacity ? old.capacity * 2 : 1024;
+	table->count = 0;
+	table->keys = calloc(table->capacity, sizeof(uint64_t));
+	table->values = calloc(table->capacity, sizeof(uint64_t));
+	if ( !table->keys || !table->values ) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+	for (size_t i = 0; i < old.capacity; i++) {
+		if (old.keys[i]) CC3GLStateTableSet(table, old.keys[i], old.values[i]);
+	}
+	free(old.keys);
+	free(old.values);
+}
+
+/**
+ * Sets the value of the specified state, and returns whether it already had that value.
+ * Keys are never zero, because zero marks an empty slot.
+ */
+static int CC3GLStateTableSet(CC3GLStateTable* table, uint64_t key, uint64_t value) {
+	if (key == 0) key = 1;
+	if ((table->count + 1) * 2 > table->capacity) CC3GLStateTableGrow(table);
+
+	size_t mask = table->capacity - 1;
+	size_t i = (size_t)(key ^ (key >> 29)) & mask;
+	while (table->keys[i] && table->keys[i] != key) i = (i + 1) & mask;
+
+	if (table->keys[i] == key) {
+		int isSame = (table->values[i] == value);
+		table->values[i] = value;
+		return isSame;
+	}
+	table->keys[i] = key;
+	table->values[i] = value;
+	table->count++;
+	return 0;
+}
+
+/** How the piece of GL state set by a command depends on other GL state. */
+typedef enum {
+	kCC3GLStateScopeGlobal = 0,			/**< The state is global. */
+	kCC3GLStateScopeTextureUnit,		/**< The state belongs to the active texture unit. */
+	kCC3GLStateScopeClientTextureUnit,	/**< The state belongs to the client active texture unit. */
+	kCC3GLStateScopeBoundTexture,		/**< The state belongs to the texture bound to the active texture unit. */
+	kCC3GLStateScopeArrayBuffer			/**< The state is global, and its value includes the bound array buffer. */
+} CC3GLStateScope;
+
+/** The GL bindings that determine which piece of state a command sets. */
+typedef struct {
+	CC3GLStateTable table;
+	uint32_t textureUnit;
+	uint32_t clientTextureUnit;
+	uint32_t arrayBuffer;
+	uint32_t boundTextures[kCC3MaxTextureUnits];
+} CC3GLStateTracker;
+
+/**
+ * Describes the piece of GL state set by the specified state command. Commands that set
+ * the same state share a slot opcode (eg. glEnable and glDisable). The first selector
+ * words of the command identify the piece of state (eg. the light and parameter name of
+ * glLightfv), and the remaining words and the data are its value.
+ */
+static void CC3GLStateSlot(const CC3GLCommand* cmd, uint32_t* slotOpcode,
+						   uint32_t* selectorCount, CC3GLStateScope* scope) {
+	*slotOpcode = cmd->opcode;
+	*selectorCount = 0;
+	*scope = kCC3GLStateScopeGlobal;
+
+	switch (cmd->opcode) {
+		case kCC3GLCmd_glEnable:
+		case kCC3GLCmd_glDisable:
+			*slotOpcode = kCC3GLCmd_glEnable;
+			*selectorCount = 1;
+			if (CC3GLCommandWord(cmd, 0) == kCC3GL_TEXTURE_2D) *scope = kCC3GLStateScopeTextureUnit;
+			return;
+		case kCC3GLCmd_glEnableClientState:
+		case kCC3GLCmd_glDisableClientState:
+			*slotOpcode = kCC3GLCmd_glEnableClientState;
+			*selectorCount = 1;
+			if (CC3GLCommandWord(cmd, 0) == kCC3GL_TEXTURE_COORD_ARRAY) *scope = kCC3GLStateScopeClientTextureUnit;
+			return;
+		case kCC3GLCmd_glLightf:
+		case kCC3GLCmd_glLightfv:
+		case kCC3GLCmd_glLightx:
+		case kCC3GLCmd_glLightxv:
+		case kCC3GLCmd_glMaterialf:
+		case kCC3GLCmd_glMaterialfv:
+		case kCC3GLCmd_glMaterialx:
+		case kCC3GLCmd_glMaterialxv:
+			*selectorCount = 2;
+			return;
+		case kCC3GLCmd_glTexEnvf:
+		case kCC3GLCmd_glTexEnvfv:
+		case kCC3GLCmd_glTexEnvi:
+		case kCC3GLCmd_glTexEnviv:
+		case kCC3GLCmd_glTexEnvx:
+		case kCC3GLCmd_glTexEnvxv:
+			*selectorCount = 2;
+			*scope = kCC3GLStateScopeTextureUnit;
+			return;
+		case kCC3GLCmd_glTexParameterf:
+		case kCC3GLCmd_glTexParameterfv:
+		case kCC3GLCmd_glTexParameteri:
+		case kCC3GLCmd_glTexParameteriv:
+		case kCC3GLCmd_glTexParameterx:
+		case kCC3GLCmd_glTexParameterxv:
+			*selectorCount = 2;
+			*scope = kCC3GLStateScopeBoundTexture;
+			return;
+		case kCC3GLCmd_glBindTexture:
+			*selectorCount = 1;
+			*scope = kCC3GLStateScopeTextureUnit;
+			return;
+		case kCC3GLCmd_glLightModelf:
+		case kCC3GLCmd_glLightModelfv:
+		case kCC3GLCmd_glLightModelx:
+		case kCC3GLCmd_glLightModelxv:
+		case kCC3GLCmd_glFogf:
+		case kCC3GLCmd_glFogfv:
+		case kCC3GLCmd_glFogx:
+		case kCC3GLCmd_glFogxv:
+		case kCC3GLCmd_glPointParameterf:
+		case kCC3GLCmd_glPointParameterfv:
+		case kCC3GLCmd_glPointParameterx:
+		case kCC3GLCmd_glPointParameterxv:
+		case kCC3GLCmd_glClipPlanef:
+		case kCC3GLCmd_glClipPlanex:
+		case kCC3GLCmd_glHint:
+		case kCC3GLCmd_glPixelStorei:
+		case kCC3GLCmd_glBindBuffer:
+		case kCC3GLCmd_glBindFramebufferOES:
+		case kCC3GLCmd_glBindRenderbufferOES:
+			*selectorCount = 1;
+			return;
+		case kCC3GLCmd_glTexCoordPointer:
+			*scope = kCC3GLStateScopeClientTextureUnit;
+			return;
+		case kCC3GLCmd_glVertexPointer:
+		case kCC3GLCmd_glNormalPointer:
+		case kCC3GLCmd_glColorPointer:
+		case kCC3GLCmd_glPointSizePointerOES:
+		case kCC3GLCmd_glWeightPointerOES:
+		case kCC3GLCmd_glMatrixIndexPointerOES:
+			*scope = kCC3GLStateScopeArrayBuffer;
+			return;
+		default:
+			return;
+	}
+}
+
+/**
+ * Updates the tracked GL state from the specified state command,
+ * and returns whether the command was redundant.
+ */
+static int CC3GLStateTrackerApply(CC3GLStateTracker* st, const CC3GLCommand* cmd) {
+	uint32_t slotOpcode, selectorCount;
+	CC3GLStateScope scope;
+	CC3GLStateSlot(cmd, &slotOpcode, &selectorCount, &scope);
+	if (selectorCount > cmd->wordCount) selectorCount = cmd->wordCount;
+
+	// Pointer specifications include the array buffer, and texture parameters belong to the
+	// bound texture, so look those up before this command changes any bindings.
+	uint32_t scopeValue = 0;
+	switch (scope) {
+		case kCC3GLStateScopeTextureUnit:
+			scopeValue = st->textureUnit;
+			break;
+		case kCC3GLStateScopeClientTextureUnit:
+			scopeValue = st->clientTextureUnit;
+			break;
+		case kCC3GLStateScopeBoundTexture:
+			scopeValue = (st->textureUnit < kCC3MaxTextureUnits) ? st->boundTextures[st->textureUnit] : 0;
+			break;
+		default:
+			break;
+	}
+
+	uint64_t key = CC3Hash(kCC3HashSeed, &slotOpcode, sizeof(slotOpcode));
+	key = CC3Hash(key, &scope, sizeof(scope));
+	key = CC3Hash(key, &scopeValue, sizeof(scopeValue));
+	key = CC3Hash(key, cmd->words, selectorCount * sizeof(uint32_t));
+
+	uint64_t value = CC3Hash(kCC3HashSeed, &cmd->opcode, sizeof(cmd->opcode));
+	value = CC3Hash(value, cmd->words + selectorCount, (cmd->wordCount - selectorCount) * sizeof(uint32_t));
+	value = CC3Hash(value, cmd->data, cmd->dataLength);
+	if (scope == kCC3GLStateScopeArrayBuffer) value = CC3Hash(value, &st->arrayBuffer, sizeof(st->arrayBuffer));
+
+	// Track the bindings that scope other state
+	switch (cmd->opcode) {
+		case kCC3GLCmd_glActiveTexture:
+			st->textureUnit = CC3GLCommandWord(cmd, 0) - kCC3GL_TEXTURE0;
+			break;
+		case kCC3GLCmd_glClientActiveTexture:
+			st->clientTextureUnit = CC3GLCommandWord(cmd, 0) - kCC3GL_TEXTURE0;
+			break;
+		case kCC3GLCmd_glBindBuffer:
+			if (CC3GLCommandWord(cmd, 0) == kCC3GL_ARRAY_BUFFER) st->arrayBuffer = CC3GLCommandWord(cmd, 1);
+			break;
+		case kCC3GLCmd_glBindTexture:
+			if (st->textureUnit < kCC3MaxTextureUnits) st->boundTextures[st->textureUnit] = CC3GLCommandWord(cmd, 1);
+			break;
+		default:
+			break;
+	}
+
+	return CC3GLStateTableSet(&st->table, key, value);
+}
+
+
+#pragma mark Analysis
+
+/** Statistics gathered over a frame, or over the whole stream. */
+typedef struct {
+	uint64_t calls;
+	uint64_t draws;
+	uint64_t stateCalls;
+	uint64_t redundantCalls;
+	uint64_t bytesUploaded;
+} CC3GLFrameStats;
+
+/** Statistics gathered for each GL function over the whole stream. */
+typedef struct {
+	uint64_t calls;
+	uint64_t redundantCalls;
+} CC3GLCommandStats;
+
+static void CC3GLAddStats(CC3GLFrameStats* total, const CC3GLFrameStats* fs) {
+	total->calls += fs->calls;
+	total->draws += fs->draws;
+	total->stateCalls += fs->stateCalls;
+	total->redundantCalls += fs->redundantCalls;
+	total->bytesUploaded += fs->bytesUploaded;
+}
+
+static double CC3Percent(uint64_t part, uint64_t whole) {
+	return whole ? (100.0 * (double)part / (double)whole) : 0.0;
+}
+
+static void CC3GLPrintFrameStats(const char* label, const CC3GLFrameStats* fs) {
+	printf("%-8s %8llu %8llu %8llu %10llu %8.1f%% %12llu\n", label,
+		   (unsigned long long)fs->calls, (unsigned long long)fs->draws,
+		   (unsigned long long)fs->stateCalls, (unsigned long long)fs->redundantCalls,
+		   CC3Percent(fs->redundantCalls, fs->stateCalls), (unsigned long long)fs->bytesUploaded);
+}
+
+/** Reports the statistics of each frame of the command stream, and the totals. Returns zero on success. */
+static int CC3GLAnalyze(const uint8_t* stream, size_t streamLength, size_t offset, int showCommands) {
+	CC3GLStateTracker st;
+	CC3GLFrameStats frame, total;
+	CC3GLCommandStats cmdStats[kCC3GLCmdCount];
+	CC3GLCommand cmd;
+	char label[32];
+	uint64_t frameCount = 0;
+	int inFrame = 0;
+
+	memset(&st, 0, sizeof(st));
+	memset(&frame, 0, sizeof(frame));
+	memset(&total, 0, sizeof(total));
+	memset(cmdStats, 0, sizeof(cmdStats));
+
+	printf("%-8s %8s %8s %8s %10s %9s %12s\n", "frame", "calls", "draws", "state", "redundant", "ratio", "uploaded");
+
+	while (offset < streamLength) {
+		size_t next = CC3GLReadCommand(stream, streamLength, offset, &cmd);
+		if ( !next ) {
+			fprintf(stderr, "Command stream is truncated at offset %lu\n", (unsigned long)offset);
+			break;
+		}
+		offset = next;
+		if (cmd.opcode >= kCC3GLCmdCount) {
+			fprintf(stderr, "Unknown opcode %u at offset %lu\n", cmd.opcode, (unsigned long)offset);
+			return 1;
+		}
+
+		if (cmd.opcode == kCC3GLCmdFrame) {
+			if (inFrame) {
+				snprintf(label, sizeof(label), "%llu", (unsigned long long)(frameCount - 1));
+				CC3GLPrintFrameStats(label, &frame);
+			} else if (frame.calls) {
+				CC3GLPrintFrameStats("setup", &frame);
+			}
+			CC3GLAddStats(&total, &frame);
+			memset(&frame, 0, sizeof(frame));
+			inFrame = 1;
+			frameCount++;
+			continue;
+		}
+
+		CC3GLCommandCategory category = commandCategories[cmd.opcode];
+		if (category == kCC3GLCommandCategoryUpload) frame.bytesUploaded += cmd.dataLength;
+		if (cmd.opcode == kCC3GLCmdClientArray) continue;
+
+		frame.calls++;
+		cmdStats[cmd.opcode].calls++;
+		if (category == kCC3GLCommandCategoryDraw) frame.draws++;
+		if (cmd.opcode == kCC3GLCmd_glDrawElements) frame.bytesUploaded += cmd.dataLength;
+		if (category == kCC3GLCommandCategoryState) {
+			frame.stateCalls++;
+			if (CC3GLStateTrackerApply(&st, &cmd)) {
+				frame.redundantCalls++;
+				cmdStats[cmd.opcode].redundantCalls++;
+			}
+		}
+	}
+
+	if (inFrame) {
+		snprintf(label, sizeof(label), "%llu", (unsigned long long)(frameCount - 1));
+		CC3GLPrintFrameStats(label, &frame);
+	} else if (frame.calls) {
+		CC3GLPrintFrameStats("setup", &frame);
+	}
+	CC3GLAddStats(&total, &frame);
+	CC3GLPrintFrameStats("total", &total);
+	printf("%llu frames, %.1f calls and %.1f draws per frame\n", (unsigned long long)frameCount,
+		   frameCount ? (double)total.calls / (double)frameCount : 0.0,
+		   frameCount ? (double)total.draws / (double)frameCount : 0.0);
+
+	if (showCommands) {
+		printf("\n%-42s %10s %10s\n", "command", "calls", "redundant");
+		for (uint32_t op = 0; op < kCC3GLCmdCount; op++) {
+			if ( !cmdStats[op].calls ) continue;
+			printf("%-42s %10llu %10llu\n", commandNames[op],
+				   (unsigned long long)cmdStats[op].calls, (unsigned long long)cmdStats[op].redundantCalls);
+		}
+	}
+
+	free(st.table.keys);
+	free(st.table.values);
+	return 0;
+}
+
+
+#pragma mark Null driver replay
+
+/** Memory that the null driver copies uploaded data into, as a real driver would. */
+static uint8_t* nullDriverMemory = NULL;
+static size_t nullDriverMemoryLength = 0;
+
+/** Accumulates the decoded parameters, so that the decoding cannot be optimized away. */
+static volatile uint32_t nullDriverSink = 0;
+
+typedef void (*CC3NullGLFunction)(const CC3GLCommand* cmd);
+
+static void CC3NullGLCall(const CC3GLCommand* cmd) {
+	uint32_t sum = cmd->opcode;
+	for (uint32_t i = 0; i < cmd->wordCount; i++) sum += cmd->words[i];
+	nullDriverSink += sum;
+}
+
+static void CC3NullGLUpload(const CC3GLCommand* cmd) {
+	CC3NullGLCall(cmd);
+	if (cmd->dataLength > nullDriverMemoryLength) {
+		free(nullDriverMemory);
+		nullDriverMemory = malloc(cmd->dataLength);
+		nullDriverMemoryLength = nullDriverMemory ? cmd->dataLength : 0;
+		if ( !nullDriverMemory ) return;
+	}
+	memcpy(nullDriverMemory, cmd->data, cmd->dataLength);
+	nullDriverSink += nullDriverMemory[cmd->dataLength ? cmd->dataLength - 1 : 0];
+}
+
+static double CC3Seconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/** Replays the commands in the specified range of the stream through the null driver. */
+static uint64_t CC3GLReplayFrame(const uint8_t* stream, size_t start, size_t end,
+								 const CC3NullGLFunction* driver) {
+	CC3GLCommand cmd;
+	uint64_t calls = 0;
+	size_t offset = start;
+	while (offset < end) {
+		offset = CC3GLReadCommand(stream, end, offset, &cmd);
+		if ( !offset ) break;
+		driver[cmd.opcode](&cmd);
+		if (commandCategories[cmd.opcode] != kCC3GLCommandCategoryMarker && cmd.opcode != kCC3GLCmdClientArray) calls++;
+	}
+	return calls;
+}
+
+/** Replays each frame of the command stream the specified number of times, and reports the timings. */
+static int CC3GLReplay(const uint8_t* stream, size_t streamLength, size_t offset, unsigned int iterations) {
+	CC3NullGLFunction driver[kCC3GLCmdCount];
+	CC3GLCommand cmd;
+	char label[32];
+	uint64_t frameCount = 0;
+	double totalBest = 0.0, totalMean = 0.0;
+
+	for (uint32_t op = 0; op < kCC3GLCmdCount; op++) {
+		int hasData = (commandCategories[op] == kCC3GLCommandCategoryUpload || op == kCC3GLCmd_glDrawElements);
+		driver[op] = hasData ? CC3NullGLUpload : CC3NullGLCall;
+	}
+
+	printf("\n%-8s %8s %12s %12s %10s\n", "frame", "calls", "best us", "mean us", "ns/call");
+
+	while (offset < streamLength) {
+		// Find the extent of the next frame
+		size_t start = offset, end = offset;
+		while (end < streamLength) {
+			size_t next = CC3GLReadCommand(stream, streamLength, end, &cmd);
+			if ( !next ) break;
+			if (cmd.opcode >= kCC3GLCmdCount) return 1;
+			if (cmd.opcode == kCC3GLCmdFrame && end != start) break;
+			end = next;
+		}
+		if (end == start) break;
+		offset = end;
+
+		// Commands before the first frame marker are the setup frame
+		int isSetup = (CC3GLReadCommand(stream, streamLength, start, &cmd) && cmd.opcode != kCC3GLCmdFrame);
+
+		uint64_t calls = 0;
+		double best = 1e30, sum = 0.0;
+		for (unsigned int i = 0; i < iterations; i++) {
+			double t0 = CC3Seconds();
+			calls = CC3GLReplayFrame(stream, start, end, driver);
+			double dt = CC3Seconds() - t0;
+			if (dt < best) best = dt;
+			sum += dt;
+		}
+		double mean = sum / iterations;
+		if (isSetup) {
+			snprintf(label, sizeof(label), "setup");
+		} else {
+			snprintf(label, sizeof(label), "%llu", (unsigned long long)frameCount);
+		}
+		printf("%-8s %8llu %12.2f %12.2f %10.1f\n", label, (unsigned long long)calls,
+			   best * 1e6, mean * 1e6, calls ? (best * 1e9 / (double)calls) : 0.0);
+		if (isSetup) continue;
+
+		totalBest += best;
+		totalMean += mean;
+		frameCount++;
+	}
+
+	if (frameCount) {
+		printf("%llu frames replayed %u times, best %.2f us and mean %.2f us per frame\n",
+			   (unsigned long long)frameCount, iterations,
+			   totalBest * 1e6 / (double)frameCount, totalMean * 1e6 / (double)frameCount);
+	}
+	free(nullDriverMemory);
+	return 0;
+}
+
+
+#pragma mark Main
+
+static uint8_t* CC3ReadFile(const char* path, size_t* length) {
+	FILE* f = fopen(path, "rb");
+	if ( !f ) return NULL;
+
+	uint8_t* buffer = NULL;
+	size_t capacity = 0, used = 0;
+	for (;;) {
+		if (used == capacity) {
+			capacity = capacity ? capacity * 2 : (1 << 20);
+			uint8_t* newBuffer = realloc(buffer, capacity);
+			if ( !newBuffer ) {
+				free(buffer);
+				fclose(f);
+				return NULL;
+			}
+			buffer = newBuffer;
+		}
+		size_t n = fread(buffer + used, 1, capacity - used, f);
+		used += n;
+		if (n == 0) break;
+	}
+	fclose(f);
+	*length = used;
+	return buffer;
+}
+
+static void CC3PrintUsage(void) {
+	fprintf(stderr, "Usage: CC3GLCommandTool [-commands] [-replay iterations] capture-file\n");
+}
+
+int main(int argc, char* argv[]) {
+	const char* path = NULL;
+	int showCommands = 0;
+	unsigned int replayIterations = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-commands") == 0) {
+			showCommands = 1;
+		} else if (strcmp(argv[i], "-replay") == 0 && i + 1 < argc) {
+			replayIterations = (unsigned int)strtoul(argv[++i], NULL, 10);
+		} else if (argv[i][0] != '-' && !path) {
+			path = argv[i];
+		} else {
+			CC3PrintUsage();
+			return 1;
+		}
+	}
+	if ( !path ) {
+		CC3PrintUsage();
+		return 1;
+	}
+
+	size_t length = 0;
+	uint8_t* stream = CC3ReadFile(path, &length);
+	if ( !stream ) {
+		fprintf(stderr, "Could not read %s\n", path);
+		return 1;
+	}
+
+	CC3GLCommandStreamHeader header;
+	if (length < sizeof(header)) {
+		fprintf(stderr, "%s is not a GL command stream\n", path);
+		free(stream);
+		return 1;
+	}
+	memcpy(&header, stream, sizeof(header));
+	if (memcmp(header.magic, kCC3GLCommandStreamMagic, sizeof(header.magic)) != 0) {
+		fprintf(stderr, "%s is not a GL command stream\n", path);
+		free(stream);
+		return 1;
+	}
+	if (header.byteOrderMark != kCC3GLCommandStreamByteOrderMark) {
+		fprintf(stderr, "%s was recorded with a different byte order, which is not supported\n", path);
+		free(stream);
+		return 1;
+	}
+	if (header.version != kCC3GLCommandStreamVersion) {
+		fprintf(stderr, "%s has format version %u, but this tool reads version %u\n",
+				path, header.version, kCC3GLCommandStreamVersion);
+		free(stream);
+		return 1;
+	}
+
+	int result = CC3GLAnalyze(stream, length, sizeof(header), showCommands);
+	if (result == 0 && replayIterations) {
+		result = CC3GLReplay(stream, length, sizeof(header), replayIterations);
+	}
+
+	free(stream);
+	return result;
+}
@@ -0,0 +1,278 @@
+/*
+ * CC3PODCooker.cpp
+ *
+ * cocos3d 0.7.1
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2012 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+
+/**
+ * Offline cooking of POD files into the cooked format loaded by CPVRTModelPOD::ReadFromFileCooked.
+ *
+ * This tool is built from the PVRT sources used by cocos3d, and does not need OpenGL ES:
+ *
+ *   PVRT="../cocos3d/cc3PVR/PVRT 2.10"
+ *   c++ -O2 -I"$PVRT" -I"$PVRT/OGLES" -o CC3PODCooker CC3PODCooker.cpp \
+ *       "$PVRT"/PVRTModelPOD.cpp "$PVRT"/PVRTResourceFile.cpp "$PVRT"/PVRTString.cpp \
+ *       "$PVRT"/PVRTMatrixF.cpp "$PVRT"/PVRTQuaternionF.cpp "$PVRT"/PVRTVector.cpp \
+ *       "$PVRT"/PVRTVertex.cpp "$PVRT"/PVRTBoneBatch.cpp "$PVRT"/PVRTTrans.cpp \
+ *       "$PVRT"/PVRTError.cpp "$PVRT"/PVRTFixedPoint.cpp "$PVRT"/PVRTVertexCache.cpp \
+ *       "$PVRT"/PVRTParallel.cpp -lpthread
+ *
+ * Usage:
+ *
+ *   CC3PODCooker [-threads count] [-vcache] [-pack flags] input-directory output-directory
+ *
+ * Each .pod file in the input directory is loaded, its meshes are split for 16-bit indices
+ * and interleaved, and it is written to the output directory as a cooked .cpod file of the
+ * same name. Files are cooked in parallel, one per thread, using as many threads as there
+ * are processors by default. CC3PODResource loads a cooked file in place of the POD file
+ * beside it, so the cooked files can be copied into the application resources.
+ *
+ * With -vcache, the triangles and vertices of each indexed triangle list mesh are first
+ * reordered for the vertex cache, using PVRTModelPODOptimiseVertexCache.
+ *
+ * With -pack, the vertex data of each mesh is quantised with PVRTModelPODPackVertexData,
+ * using the specified EPODPackData flags. The renderer must then undo the quantisation.
+ * In particular, OpenGL ES 1.1 matrix palette skinning cannot read packed bone weights.
+ *
+ * Cooked files hold the scene in the memory layout of the machine that cooked them, so
+ * they must be cooked by a build of this tool with the same byte order, pointer size and
+ * VERTTYPE as the application that loads them.
+ *
+ * Each cooked file records the size and modification time of the POD file it was cooked
+ * from. CC3PODResource loads the POD file instead once either of them changes, so the POD
+ * files must be copied into the application with their modification times kept.
+ */
+
+#include "PVRTModelPOD.h"
+#include "PVRTParallel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+/** The file extension of the files cooked by this tool. */
+#define kCC3CookedPODExtension		".cpod"
+
+/** The options and work list of a cooking run. */
+typedef struct {
+	const char* inDir;
+	const char* outDir;
+	bool shouldOptimizeVertexCache;
+	unsigned int packFlags;
+	unsigned int fileCount;
+	char** fileNames;
+	int* results;
+	unsigned long* inSizes;
+	unsigned long* outSizes;
+	double* durations;
+} CC3PODCookRun;
+
+/** Returns the current time in seconds. */
+static double CC3Now(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+/** Returns the size of the specified file, or zero if it cannot be found. */
+static unsigned long CC3FileSize(const char* path) {
+	struct stat st;
+	return (stat(path, &st) == 0) ? (unsigned long)st.st_size : 0;
+}
+
+/** Returns whether the specified file name ends in .pod, in any case. */
+static bool CC3IsPODFileName(const char* name) {
+	size_t len = strlen(name);
+	return len > 4 && strcasecmp(name + len - 4, ".pod") == 0;
+}
+
+/** Prepares each mesh of the specified model, read from inPath, for rendering, then writes the model to outPath. */
+static int CC3CookPOD(CPVRTModelPOD& pod, const CC3PODCookRun* run, const char* inPath, const char* outPath) {
+	// CC3PODResource splits the meshes of POD files as it loads them, but cannot change a cooked scene
+	if (pod.SplitMeshes() != PVR_SUCCESS) return 1;
+
+	for (unsigned int i = 0; i < pod.nNumMesh; i++) {
+		SPODMesh& mesh = pod.pMesh[i];
+
+		if (run->shouldOptimizeVertexCache && mesh.sFaces.pData && !mesh.nNumStrips) {
+			if (PVRTModelPODOptimiseVertexCache(mesh) != PVR_SUCCESS) return 1;
+		}
+
+		if (run->packFlags) {
+			if (PVRTModelPODPackVertexData(pod, mesh, run->packFlags) != PVR_SUCCESS) return 1;
+		} else if ( !mesh.pInterleaved ) {
+			PVRTModelPODToggleInterleaved(mesh, 4);
+		}
+	}
+	// The cooked file records the POD file it came from, so CC3PODResource can tell when it is stale
+	return (pod.SaveCooked(outPath, inPath) == PVR_SUCCESS) ? 0 : 1;
+}
+
+/** Cooks the file at the specified index of the work list. Invoked by PVRTParallelFor. */
+static void CC3CookPODJob(void* userData, const unsigned int fileIdx) {
+	CC3PODCookRun* run = (CC3PODCookRun*)userData;
+	const char* name = run->fileNames[fileIdx];
+	double startTime = CC3Now();
+
+	size_t nameLen = strlen(name);
+	char* inPath = (char*)malloc(strlen(run->inDir) + nameLen + 2);
+	char* outPath = (char*)malloc(strlen(run->outDir) + nameLen + sizeof(kCC3CookedPODExtension) + 1);
+	if ( !inPath || !outPath ) {
+		free(inPath);
+		free(outPath);
+		run->results[fileIdx] = 1;
+		return;
+	}
+	sprintf(inPath, "%s/%s", run->inDir, name);
+	sprintf(outPath, "%s/%.*s%s", run->outDir, (int)(nameLen - 4), name, kCC3CookedPODExtension);
+
+	CPVRTModelPOD pod;
+	if (pod.ReadFromFile(inPath) != PVR_SUCCESS) {
+		run->results[fileIdx] = 1;
+	} else {
+		run->results[fileIdx] = CC3CookPOD(pod, run, inPath, outPath);
+	}
+
+	run->inSizes[fileIdx] = CC3FileSize(inPath);
+	run->outSizes[fileIdx] = run->results[fileIdx] ? 0 : CC3FileSize(outPath);
+	run->durations[fileIdx] = CC3Now() - startTime;
+
+	free(inPath);
+	free(outPath);
+}
+
+/** Fills the work list with the names of the POD files in the input directory. */
+static bool CC3ListPODFiles(CC3PODCookRun* run) {
+	DIR* dir = opendir(run->inDir);
+	if ( !dir ) return false;
+
+	unsigned int capacity = 0;
+	struct dirent* entry;
+	while ( (entry = readdir(dir)) ) {
+		if ( !CC3IsPODFileName(entry->d_name) ) continue;
+
+		if (run->fileCount == capacity) {
+			capacity = capacity ? capacity * 2 : 64;
+			char** names = (char**)realloc(run->fileNames, capacity * sizeof(char*));
+			if ( !names ) {
+				closedir(dir);
+				return false;
+			}
+			run->fileNames = names;
+		}
+		run->fileNames[run->fileCount] = strdup(entry->d_name);
+		if ( !run->fileNames[run->fileCount] ) {
+			closedir(dir);
+			return false;
+		}
+		run->fileCount++;
+	}
+	closedir(dir);
+	return true;
+}
+
+static void CC3PrintUsage(void) {
+	fprintf(stderr, "Usage: CC3PODCooker [-threads count] [-vcache] [-pack flags] input-directory output-directory\n");
+}
+
+int main(int argc, char* argv[]) {
+	CC3PODCookRun run;
+	memset(&run, 0, sizeof(run));
+	unsigned int threadCount = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc) {
+			threadCount = (unsigned int)strtoul(argv[++i], NULL, 10);
+		} else if (strcmp(argv[i], "-vcache") == 0) {
+			run.shouldOptimizeVertexCache = true;
+		} else if (strcmp(argv[i], "-pack") == 0 && i + 1 < argc) {
+			run.packFlags = (unsigned int)strtoul(argv[++i], NULL, 0) & ePODPackAll;
+		} else if (argv[i][0] != '-' && !run.inDir) {
+			run.inDir = argv[i];
+		} else if (argv[i][0] != '-' && !run.outDir) {
+			run.outDir = argv[i];
+		} else {
+			CC3PrintUsage();
+			return 1;
+		}
+	}
+	if ( !run.inDir || !run.outDir ) {
+		CC3PrintUsage();
+		return 1;
+	}
+
+	if ( !CC3ListPODFiles(&run) ) {
+		fprintf(stderr, "Could not list the POD files in %s\n", run.inDir);
+		return 1;
+	}
+
+	int result = 0;
+	if (run.fileCount) {
+		run.results = (int*)calloc(run.fileCount, sizeof(int));
+		run.inSizes = (unsigned long*)calloc(run.fileCount, sizeof(unsigned long));
+		run.outSizes = (unsigned long*)calloc(run.fileCount, sizeof(unsigned long));
+		run.durations = (double*)calloc(run.fileCount, sizeof(double));
+		if ( !run.results || !run.inSizes || !run.outSizes || !run.durations ) {
+			fprintf(stderr, "Out of memory\n");
+			return 1;
+		}
+
+		double startTime = CC3Now();
+		PVRTParallelFor(CC3CookPODJob, &run, run.fileCount, threadCount);
+		double duration = CC3Now() - startTime;
+
+		unsigned long inTotal = 0, outTotal = 0;
+		unsigned int failCount = 0;
+		for (unsigned int i = 0; i < run.fileCount; i++) {
+			if (run.results[i]) {
+				fprintf(stderr, "Could not cook %s\n", run.fileNames[i]);
+				failCount++;
+				continue;
+			}
+			printf("%-40s %10lu -> %10lu bytes  %8.1f ms\n",
+				   run.fileNames[i], run.inSizes[i], run.outSizes[i], run.durations[i] * 1000.0);
+			inTotal += run.inSizes[i];
+			outTotal += run.outSizes[i];
+		}
+		printf("Cooked %u of %u files, %lu -> %lu bytes, in %.1f ms\n",
+			   run.fileCount - failCount, run.fileCount, inTotal, outTotal, duration * 1000.0);
+		result = failCount ? 1 : 0;
+	} else {
+		printf("No POD files found in %s\n", run.inDir);
+	}
+
+	for (unsigned int i = 0; i < run.fileCount; i++) free(run.fileNames[i]);
+	free(run.fileNames);
+	free(run.results);
+	free(run.inSizes);
+	free(run.outSizes);
+	free(run.durations);
+	return result;
+}
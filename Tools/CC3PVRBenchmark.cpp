@@ -0,0 +1,1427 @@
+/*
+ * CC3PVRBenchmark.cpp
+ *
+ * cocos3d 0.7.1
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2012 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+
+/**
+ * Timing and result checks for the PVRT code paths used by cocos3d.
+ *
+ * This tool is built from the PVRT sources used by cocos3d, and does not need OpenGL ES:
+ *
+ *   PVRT="../cocos3d/cc3PVR/PVRT 2.10"
+ *   c++ -O2 -I"$PVRT" -I"$PVRT/OGLES" -o CC3PVRBenchmark CC3PVRBenchmark.cpp \
+ *       "$PVRT"/PVRTModelPOD.cpp "$PVRT"/PVRTResourceFile.cpp "$PVRT"/PVRTString.cpp \
+ *       "$PVRT"/PVRTMatrixF.cpp "$PVRT"/PVRTQuaternionF.cpp "$PVRT"/PVRTVector.cpp \
+ *       "$PVRT"/PVRTVertex.cpp "$PVRT"/PVRTBoneBatch.cpp "$PVRT"/PVRTTrans.cpp \
+ *       "$PVRT"/PVRTError.cpp "$PVRT"/PVRTFixedPoint.cpp "$PVRT"/PVRTVertexCache.cpp \
+ *       "$PVRT"/PVRTParallel.cpp -lpthread
+ *
+ * The tangent and batch benchmarks can also be built from an older copy of the PVRT sources,
+ * to compare their results and times against those of the current sources. To do so, define
+ * CC3_PVRT_BASELINE, which leaves out the benchmarks of functions the older sources do not
+ * have, and leave out any source files that the older copy does not contain.
+ *
+ * Usage:
+ *
+ *   CC3PVRBenchmark anim|world pod-file...
+ *   CC3PVRBenchmark cull box-count...
+ *   CC3PVRBenchmark tangent grid-size...
+ *   CC3PVRBenchmark batch grid-size...
+ *   CC3PVRBenchmark vcache pod-file...
+ *   CC3PVRBenchmark vcachegrid grid-size...
+ *   CC3PVRBenchmark pack pod-file...
+ *   CC3PVRBenchmark cooked pod-file...
+ *   CC3PVRBenchmark lazy pod-file...
+ *
+ * Each benchmark prints the time taken by each path it compares, and how much their results
+ * differ, and exits with a non-zero status if the results do not agree.
+ *
+ *   anim	Compares CPVRTModelPOD::EvaluateAllNodes, with and without BakeAnimation, against
+ *			the scale, rotation and translation getters called for each node, at every half frame.
+ *
+ *   world	Compares CPVRTModelPOD::GetAllWorldMatrices, with and without BakeAnimation, against
+ *			GetWorldMatrixNoCache called for each node, at every half frame.
+ *
+ *   cull	Compares PVRTBoundingBoxArrayIsVisible and PVRTBoundingBoxSoAIsVisible against
+ *			PVRTBoundingBoxIsVisible called for each box, on the specified number of boxes
+ *			scattered around a perspective camera.
+ *
+ *   tangent	Times PVRTVertexGenerateTangentSpace on a grid of the specified number of quads
+ *			along each side, whose texture coordinates have seams and mirrored strips, so that
+ *			vertices are split. It prints a checksum of the output vertices and indices, which
+ *			should be the same for every build, and checks that the same result is produced
+ *			when all threads are used. It also checks that a fan of 200 triangles around a
+ *			single vertex can be processed.
+ *
+ *   batch	Times CPVRTBoneBatches::Create on a skinned grid of the specified number of quads
+ *			along each side, with several bone palette sizes. Each vertex is weighted to bones
+ *			picked at random around its position in a square grid of bones. It prints the number
+ *			of batches and output vertices, and checks that every weighted bone of every output
+ *			vertex resolves to its original bone through the palette of its batch.
+ *
+ *   vcache	Runs PVRTModelPODOptimiseVertexCache on each mesh of each POD file, converting
+ *			stripped meshes to triangle lists first. It prints the average cache miss ratio
+ *			(ACMR) of each mesh before and after, and checks that each bone batch still draws
+ *			the same triangles, with the same vertex content and winding.
+ *
+ *   vcachegrid	Runs PVRTVertexCacheOptimise on a grid of the specified number of quads along
+ *			each side, whose triangles are first shuffled. It prints the ACMR before and after,
+ *			and checks that the same triangles are drawn.
+ *
+ *   pack	Runs PVRTModelPODPackVertexData on each mesh of each POD file. The file is first
+ *			rewritten by SavePOD to a temporary file, which aligns most of its arrays, and loaded
+ *			from there by ReadFromFileMapped, so that arrays borrowed from the mapping are replaced.
+ *			It then unpacks every attribute of every vertex and compares it against the file read
+ *			by ReadFromFile. Positions, normals, texture coordinates and bone weights must be within
+ *			the errors reported by the packing, and all else must be equal. It also checks that
+ *			the meshes of the same scene, cooked by SaveCooked, are refused.
+ *
+ *   cooked	Times loading each POD file as CC3PODResource does, with ReadFromFile and SplitMeshes,
+ *			against loading the same scene cooked as CC3PODCooker does, with ReadFromFileCooked.
+ *			Each load includes releasing the scene again, and reads the file from the file cache,
+ *			as on a second launch of an application. It checks that the cooked scene has the same
+ *			nodes and the same vertex and index data as the scene it was cooked from, and that a
+ *			cooked file is refused once the POD file it was cooked from changes.
+ *
+ *   lazy	Times ReadFromFile against ReadFromFileLazy alone, which is what an application
+ *			that uses few of the meshes and animations of a file pays up front, and against
+ *			ReadFromFileLazy followed by LoadMesh and LoadNodeAnimation for everything. It checks
+ *			that the fully loaded lazy scene has the same nodes, animation, and vertex and index
+ *			data as the scene read by ReadFromFile. It also bakes the animation of a lazy scene
+ *			before loading it, and checks that the world matrices then follow the animation at
+ *			every half frame, and return to the frame 0 pose once the animation is unloaded.
+ */
+
+#include "PVRTModelPOD.h"
+#include "PVRTTrans.h"
+#include "PVRTVertex.h"
+#include "PVRTBoneBatch.h"
+#ifndef CC3_PVRT_BASELINE
+#include "PVRTVertexCache.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stddef.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+/** The minimum time, in seconds, over which each path is timed. */
+#define kCC3BenchmarkMinDuration	0.25
+
+/** The largest difference allowed between the results of two paths that should agree. */
+#define kCC3BenchmarkTolerance		1.0e-4f
+
+/** Returns the current time in seconds. */
+static double CC3Now(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+/** The state of the pseudo-random generator, which gives the same values on every run. */
+static unsigned int gCC3RandomState = 1;
+
+/** Returns a pseudo-random float between the specified values. */
+static float CC3RandomFloat(float min, float max) {
+	gCC3RandomState = gCC3RandomState * 1664525u + 1013904223u;
+	return min + ((gCC3RandomState >> 8) / 16777216.0f) * (max - min);
+}
+
+/**
+ * Invokes the specified function repeatedly, until at least kCC3BenchmarkMinDuration
+ * has elapsed, and returns the average number of microseconds taken by one call.
+ */
+template <typename Fn>
+static double CC3TimePerCall(Fn fn) {
+	unsigned long callCount = 0;
+	double startTime = CC3Now();
+	double duration;
+	do {
+		fn();
+		callCount++;
+	} while ((duration = CC3Now() - startTime) < kCC3BenchmarkMinDuration);
+	return duration * 1000000.0 / callCount;
+}
+
+/** Returns the file name part of the specified path. */
+static const char* CC3BaseName(const char* path) {
+	const char* slash = strrchr(path, '/');
+	return slash ? slash + 1 : path;
+}
+
+/** The starting value of the 64-bit FNV-1a hash. */
+#define kCC3ChecksumStart		14695981039346656037ULL
+
+/** Continues the specified 64-bit FNV-1a hash over the specified bytes, and returns the new hash. */
+static unsigned long long CC3ChecksumContinue(unsigned long long hash, const void* pData, size_t byteCount) {
+	const unsigned char* pBytes = (const unsigned char*)pData;
+	for (size_t i = 0; i < byteCount; i++) {
+		hash ^= pBytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/** Returns the 64-bit FNV-1a hash of the specified bytes. */
+static unsigned long long CC3Checksum(const void* pData, size_t byteCount) {
+	return CC3ChecksumContinue(kCC3ChecksumStart, pData, byteCount);
+}
+
+#ifndef CC3_PVRT_BASELINE
+
+/**
+ * Returns the largest difference between corresponding elements of the specified matrix arrays,
+ * relative to the size of the elements when they are larger than one.
+ */
+static float CC3MatrixArrayDiff(const PVRTMATRIX* pmA, const PVRTMATRIX* pmB, unsigned int count) {
+	float maxDiff = 0.0f;
+	for (unsigned int i = 0; i < count; i++) {
+		for (unsigned int j = 0; j < 16; j++) {
+			float a = vt2f(pmA[i].f[j]), b = vt2f(pmB[i].f[j]);
+			float diff = fabsf(a - b) / PVRT_MAX(1.0f, PVRT_MAX(fabsf(a), fabsf(b)));
+			if (diff > maxDiff || diff != diff) maxDiff = diff;
+		}
+	}
+	return maxDiff;
+}
+
+/**
+ * Returns the number of frames at which each benchmark evaluates the specified model.
+ * The model is sampled at every half frame, so that blending between frames is included.
+ */
+static unsigned int CC3SampleCount(const CPVRTModelPOD& pod) {
+	// The last frame cannot be blended towards a following frame, so is skipped.
+	return (pod.nNumFrame > 1) ? (pod.nNumFrame - 1) * 2 : 1;
+}
+
+/** Returns the frame at the specified sample index. */
+static VERTTYPE CC3SampleFrame(unsigned int sampleIdx) {
+	return f2vt(sampleIdx * 0.5f);
+}
+
+/**
+ * Invokes the specified function repeatedly, once for each sample of the specified model,
+ * until at least kCC3BenchmarkMinDuration has elapsed, and returns the average number of
+ * microseconds taken to process one frame.
+ */
+template <typename Fn>
+static double CC3TimePerFrame(CPVRTModelPOD& pod, Fn fn) {
+	unsigned int sampleCount = CC3SampleCount(pod);
+	unsigned long evalCount = 0;
+	double startTime = CC3Now();
+	double duration;
+	do {
+		for (unsigned int i = 0; i < sampleCount; i++) fn(pod, CC3SampleFrame(i));
+		evalCount += sampleCount;
+	} while ((duration = CC3Now() - startTime) < kCC3BenchmarkMinDuration);
+	return duration * 1000000.0 / evalCount;
+}
+
+/**
+ * Fills the local transforms of the nodes of a model through the per-node getters,
+ * composing them as the recursive world matrix path does.
+ */
+struct CC3NodeGetters {
+	PVRTMATRIX* pmLocal;
+	void operator()(CPVRTModelPOD& pod, VERTTYPE fFrame) const {
+		pod.SetFrame(fFrame);
+		for (unsigned int i = 0; i < pod.nNumNode; i++) {
+			const SPODNode& node = pod.pNode[i];
+			if (node.pfAnimMatrix) {
+				pod.GetTransformationMatrix(pmLocal[i], node);
+				continue;
+			}
+			PVRTMATRIX mTmp;
+			pod.GetScalingMatrix(pmLocal[i], node);
+			pod.GetRotationMatrix(mTmp, node);
+			PVRTMatrixMultiply(pmLocal[i], pmLocal[i], mTmp);
+			pod.GetTranslationMatrix(mTmp, node);
+			PVRTMatrixMultiply(pmLocal[i], pmLocal[i], mTmp);
+		}
+	}
+};
+
+/** Fills the local transforms of the nodes of a model in one pass. */
+struct CC3AllNodes {
+	PVRTMATRIX* pmLocal;
+	void operator()(CPVRTModelPOD& pod, VERTTYPE fFrame) const {
+		pod.EvaluateAllNodes(pmLocal, fFrame);
+	}
+};
+
+/** Returns the largest difference between the local transforms of the two paths over every sample. */
+static float CC3CompareLocalTransforms(CPVRTModelPOD& pod, PVRTMATRIX* pmA, PVRTMATRIX* pmB) {
+	CC3NodeGetters getters = { pmA };
+	CC3AllNodes allNodes = { pmB };
+	float maxDiff = 0.0f;
+	for (unsigned int i = 0; i < CC3SampleCount(pod); i++) {
+		getters(pod, CC3SampleFrame(i));
+		allNodes(pod, CC3SampleFrame(i));
+		float diff = CC3MatrixArrayDiff(pmA, pmB, pod.nNumNode);
+		if (diff > maxDiff || diff != diff) maxDiff = diff;
+	}
+	return maxDiff;
+}
+
+/** Runs the anim benchmark on the specified POD file. Returns whether the results agree. */
+static bool CC3BenchmarkAnim(const char* path) {
+	CPVRTModelPOD pod;
+	if (pod.ReadFromFile(path) != PVR_SUCCESS) {
+		fprintf(stderr, "Could not read %s\n", path);
+		return false;
+	}
+	if ( !pod.nNumNode ) return true;
+
+	PVRTMATRIX* pmA = (PVRTMATRIX*)malloc(pod.nNumNode * sizeof(PVRTMATRIX));
+	PVRTMATRIX* pmB = (PVRTMATRIX*)malloc(pod.nNumNode * sizeof(PVRTMATRIX));
+	if ( !pmA || !pmB ) {
+		free(pmA);
+		free(pmB);
+		fprintf(stderr, "Out of memory\n");
+		return false;
+	}
+	CC3NodeGetters getters = { pmA };
+	CC3AllNodes allNodes = { pmB };
+
+	double gettersTime = CC3TimePerFrame(pod, getters);
+	double allTime = CC3TimePerFrame(pod, allNodes);
+	float allDiff = CC3CompareLocalTransforms(pod, pmA, pmB);
+
+	bool isBaked = (pod.BakeAnimation() == PVR_SUCCESS);
+	double bakedTime = isBaked ? CC3TimePerFrame(pod, allNodes) : 0.0;
+	float bakedDiff = isBaked ? CC3CompareLocalTransforms(pod, pmA, pmB) : 0.0f;
+
+	printf("%-28s %4u nodes %4u frames  getters %8.2f us  all %8.2f us (diff %g)  baked %8.2f us (diff %g)\n",
+		   CC3BaseName(path), pod.nNumNode, pod.nNumFrame, gettersTime, allTime, allDiff, bakedTime, bakedDiff);
+
+	free(pmA);
+	free(pmB);
+	return allDiff <= kCC3BenchmarkTolerance && bakedDiff <= kCC3BenchmarkTolerance;
+}
+
+/** Fills the world matrices of the nodes of a model by solving each node up its chain of ancestors. */
+struct CC3NodeWorldGetters {
+	PVRTMATRIX* pmWorld;
+	void operator()(CPVRTModelPOD& pod, VERTTYPE fFrame) const {
+		pod.SetFrame(fFrame);
+		for (unsigned int i = 0; i < pod.nNumNode; i++) pod.GetWorldMatrixNoCache(pmWorld[i], pod.pNode[i]);
+	}
+};
+
+/** Fills the world matrices of the nodes of a model in one sweep of the hierarchy. */
+struct CC3AllWorld {
+	PVRTMATRIX* pmWorld;
+	void operator()(CPVRTModelPOD& pod, VERTTYPE fFrame) const {
+		pod.GetAllWorldMatrices(pmWorld, fFrame);
+	}
+};
+
+/** Returns the largest difference between the world matrices of the two paths over every sample. */
+static float CC3CompareWorldMatrices(CPVRTModelPOD& pod, PVRTMATRIX* pmA, PVRTMATRIX* pmB) {
+	CC3NodeWorldGetters getters = { pmA };
+	CC3AllWorld allWorld = { pmB };
+	float maxDiff = 0.0f;
+	for (unsigned int i = 0; i < CC3SampleCount(pod); i++) {
+		getters(pod, CC3SampleFrame(i));
+		allWorld(pod, CC3SampleFrame(i));
+		float diff = CC3MatrixArrayDiff(pmA, pmB, pod.nNumNode);
+		if (diff > maxDiff || diff != diff) maxDiff = diff;
+	}
+	return maxDiff;
+}
+
+/** Runs the world benchmark on the specified POD file. Returns whether the results agree. */
+static bool CC3BenchmarkWorld(const char* path) {
+	CPVRTModelPOD pod;
+	if (pod.ReadFromFile(path) != PVR_SUCCESS) {
+		fprintf(stderr, "Could not read %s\n", path);
+		return false;
+	}
+	if ( !pod.nNumNode ) return true;
+
+	PVRTMATRIX* pmA = (PVRTMATRIX*)malloc(pod.nNumNode * sizeof(PVRTMATRIX));
+	PVRTMATRIX* pmB = (PVRTMATRIX*)malloc(pod.nNumNode * sizeof(PVRTMATRIX));
+	if ( !pmA || !pmB ) {
+		free(pmA);
+		free(pmB);
+		fprintf(stderr, "Out of memory\n");
+		return false;
+	}
+	CC3NodeWorldGetters getters = { pmA };
+	CC3AllWorld allWorld = { pmB };
+
+	double gettersTime = CC3TimePerFrame(pod, getters);
+	double allTime = CC3TimePerFrame(pod, allWorld);
+	float allDiff = CC3CompareWorldMatrices(pod, pmA, pmB);
+
+	bool isBaked = (pod.BakeAnimation() == PVR_SUCCESS);
+	double bakedTime = isBaked ? CC3TimePerFrame(pod, allWorld) : 0.0;
+	float bakedDiff = isBaked ? CC3CompareWorldMatrices(pod, pmA, pmB) : 0.0f;
+
+	printf("%-28s %4u nodes %4u frames  no cache %8.2f us  all %8.2f us (diff %g)  baked %8.2f us (diff %g)\n",
+		   CC3BaseName(path), pod.nNumNode, pod.nNumFrame, gettersTime, allTime, allDiff, bakedTime, bakedDiff);
+
+	free(pmA);
+	free(pmB);
+	return allDiff <= kCC3BenchmarkTolerance && bakedDiff <= kCC3BenchmarkTolerance;
+}
+
+/** The boxes of the cull benchmark, in each of the forms the culling functions take. */
+struct CC3CullBoxes {
+	int boxCount;
+	PVRTBOUNDINGBOX* pBoxes;
+	PVRTBOUNDINGBOXSOA soa;
+	PVRTMATRIX mViewProj;
+	PVRTuint32* pu32Visible;
+	bool* pbVisible;
+};
+
+/** Tests the boxes one at a time. */
+struct CC3CullEachBox {
+	CC3CullBoxes* pCull;
+	void operator()() const {
+		for (int i = 0; i < pCull->boxCount; i++) {
+			bool bNeedsZClipping;
+			pCull->pbVisible[i] = PVRTBoundingBoxIsVisible(&pCull->pBoxes[i], &pCull->mViewProj, &bNeedsZClipping);
+		}
+	}
+};
+
+/** Tests the array of boxes in one call. */
+struct CC3CullBoxArray {
+	CC3CullBoxes* pCull;
+	void operator()() const {
+		PVRTBoundingBoxArrayIsVisible(pCull->pu32Visible, pCull->pBoxes, pCull->boxCount, &pCull->mViewProj);
+	}
+};
+
+/** Tests the boxes in structure of arrays form in one call. */
+struct CC3CullBoxSoA {
+	CC3CullBoxes* pCull;
+	void operator()() const {
+		PVRTBoundingBoxSoAIsVisible(pCull->pu32Visible, &pCull->soa, pCull->boxCount, &pCull->mViewProj);
+	}
+};
+
+/** Returns the number of boxes for which the visibility bitmask disagrees with the per-box results. */
+static int CC3CountCullMismatches(const CC3CullBoxes* pCull) {
+	int mismatchCount = 0;
+	for (int i = 0; i < pCull->boxCount; i++) {
+		bool isVisible = (pCull->pu32Visible[i >> 5] >> (i & 31)) & 1;
+		if (isVisible != pCull->pbVisible[i]) mismatchCount++;
+	}
+	return mismatchCount;
+}
+
+/** Runs the cull benchmark on the number of boxes in the specified string. Returns whether the results agree. */
+static bool CC3BenchmarkCull(const char* boxCountString) {
+	CC3CullBoxes cull;
+	cull.boxCount = atoi(boxCountString);
+	if (cull.boxCount <= 0) {
+		fprintf(stderr, "Invalid box count %s\n", boxCountString);
+		return false;
+	}
+
+	VERTTYPE* pfSoA = (VERTTYPE*)malloc(cull.boxCount * 6 * sizeof(VERTTYPE));
+	cull.pBoxes = (PVRTBOUNDINGBOX*)malloc(cull.boxCount * sizeof(PVRTBOUNDINGBOX));
+	cull.pu32Visible = (PVRTuint32*)calloc((cull.boxCount + 31) / 32, sizeof(PVRTuint32));
+	cull.pbVisible = (bool*)calloc(cull.boxCount, sizeof(bool));
+	if ( !pfSoA || !cull.pBoxes || !cull.pu32Visible || !cull.pbVisible ) {
+		free(pfSoA);
+		free(cull.pBoxes);
+		free(cull.pu32Visible);
+		free(cull.pbVisible);
+		fprintf(stderr, "Out of memory\n");
+		return false;
+	}
+
+	// The camera is at the origin looking down -Z, and the boxes are all around it,
+	// so some are fully inside the frustum, some outside and some straddle it.
+	PVRTMATRIX mView, mProj;
+	PVRTVECTOR3 vEye = { 0.0f, 0.0f, 0.0f }, vAt = { 0.0f, 0.0f, -1.0f }, vUp = { 0.0f, 1.0f, 0.0f };
+	PVRTMatrixLookAtRH(mView, vEye, vAt, vUp);
+	PVRTMatrixPerspectiveFovRH(mProj, 1.0f, 1.5f, 1.0f, 200.0f);
+	PVRTMatrixMultiply(cull.mViewProj, mView, mProj);
+
+	cull.soa.pfCentreX = &pfSoA[cull.boxCount * 0];
+	cull.soa.pfCentreY = &pfSoA[cull.boxCount * 1];
+	cull.soa.pfCentreZ = &pfSoA[cull.boxCount * 2];
+	cull.soa.pfExtentX = &pfSoA[cull.boxCount * 3];
+	cull.soa.pfExtentY = &pfSoA[cull.boxCount * 4];
+	cull.soa.pfExtentZ = &pfSoA[cull.boxCount * 5];
+	for (int i = 0; i < cull.boxCount; i++) {
+		PVRTVECTOR3 avCorner[2];
+		for (int j = 0; j < 3; j++) {
+			float fCentre = CC3RandomFloat(-100.0f, 100.0f);
+			float fExtent = CC3RandomFloat(0.1f, 5.0f);
+			(&avCorner[0].x)[j] = fCentre - fExtent;
+			(&avCorner[1].x)[j] = fCentre + fExtent;
+			pfSoA[cull.boxCount * j + i] = fCentre;
+			pfSoA[cull.boxCount * (j + 3) + i] = fExtent;
+		}
+		PVRTBoundingBoxCompute(&cull.pBoxes[i], avCorner, 2);
+	}
+
+	CC3CullEachBox eachBox = { &cull };
+	CC3CullBoxArray boxArray = { &cull };
+	CC3CullBoxSoA boxSoA = { &cull };
+
+	double eachTime = CC3TimePerCall(eachBox);
+	double arrayTime = CC3TimePerCall(boxArray);
+	int arrayMismatchCount = CC3CountCullMismatches(&cull);
+	double soaTime = CC3TimePerCall(boxSoA);
+	int soaMismatchCount = CC3CountCullMismatches(&cull);
+
+	int visibleCount = 0;
+	for (int i = 0; i < cull.boxCount; i++) visibleCount += cull.pbVisible[i];
+
+	printf("%d boxes, %d visible  each box %8.1f us  array %8.1f us (%.1fx, %d differ)  SoA %8.1f us (%.1fx, %d differ)\n",
+		   cull.boxCount, visibleCount, eachTime, arrayTime, eachTime / arrayTime, arrayMismatchCount,
+		   soaTime, eachTime / soaTime, soaMismatchCount);
+
+	free(pfSoA);
+	free(cull.pBoxes);
+	free(cull.pu32Visible);
+	free(cull.pbVisible);
+	return !arrayMismatchCount && !soaMismatchCount;
+}
+
+#endif	// CC3_PVRT_BASELINE
+
+/** The vertex layout of the tangent benchmark. */
+struct CC3TangentVertex {
+	float position[3];
+	float normal[3];
+	float texCoord[2];
+	float tangent[3];
+	float bitangent[3];
+};
+
+/** The mesh of the tangent benchmark, and the most recent tangent space generated for it. */
+struct CC3TangentMesh {
+	const CC3TangentVertex* pVertices;
+	unsigned int vertexCount;
+	const unsigned int* pIndices;
+	unsigned int* pWorkIndices;
+	unsigned int triangleCount;
+	unsigned int vertexCountOut;
+	char* pVerticesOut;
+	EPVRTError error;
+};
+
+/** Returns a checksum of the most recent tangent space generated for the specified mesh. */
+static unsigned long long CC3TangentMeshChecksum(const CC3TangentMesh* pMesh) {
+	if (pMesh->error != PVR_SUCCESS) return 0;
+	return CC3Checksum(pMesh->pVerticesOut, pMesh->vertexCountOut * sizeof(CC3TangentVertex)) ^
+		   CC3Checksum(pMesh->pWorkIndices, pMesh->triangleCount * 3 * sizeof(unsigned int));
+}
+
+/** Generates the tangent space of a mesh, starting from its original indices on each call. */
+struct CC3GenerateTangents {
+	CC3TangentMesh* pMesh;
+	unsigned int maxThreads;
+	void operator()() const {
+		free(pMesh->pVerticesOut);
+		pMesh->pVerticesOut = NULL;
+		memcpy(pMesh->pWorkIndices, pMesh->pIndices, pMesh->triangleCount * 3 * sizeof(unsigned int));
+		pMesh->error = PVRTVertexGenerateTangentSpace(&pMesh->vertexCountOut, &pMesh->pVerticesOut, pMesh->pWorkIndices,
+														  pMesh->vertexCount, (const char*)pMesh->pVertices, sizeof(CC3TangentVertex),
+														  offsetof(CC3TangentVertex, position), EPODDataFloat,
+														  offsetof(CC3TangentVertex, normal), EPODDataFloat,
+														  offsetof(CC3TangentVertex, texCoord), EPODDataFloat,
+														  offsetof(CC3TangentVertex, tangent), EPODDataFloat,
+														  offsetof(CC3TangentVertex, bitangent), EPODDataFloat,
+														  pMesh->triangleCount, 0.5f
+#ifndef CC3_PVRT_BASELINE
+														  , maxThreads
+#endif
+														  );
+	}
+};
+
+/** Returns whether the tangent space of a fan of 200 triangles around a single vertex can be generated. */
+static bool CC3GenerateTangentsForFan(void) {
+	const unsigned int triangleCount = 200;
+	CC3TangentVertex vertices[triangleCount + 1];
+	unsigned int indices[triangleCount * 3];
+	unsigned int workIndices[triangleCount * 3];
+
+	memset(vertices, 0, sizeof(vertices));
+	vertices[0].normal[2] = 1.0f;
+	vertices[0].texCoord[0] = vertices[0].texCoord[1] = 0.5f;
+	for (unsigned int i = 0; i < triangleCount; i++) {
+		float angle = i * 2.0f * PVRT_PIf / triangleCount;
+		CC3TangentVertex& v = vertices[i + 1];
+		v.position[0] = cosf(angle);
+		v.position[1] = sinf(angle);
+		v.normal[2] = 1.0f;
+		v.texCoord[0] = 0.5f + 0.5f * cosf(angle);
+		v.texCoord[1] = 0.5f + 0.5f * sinf(angle);
+		indices[i * 3 + 0] = 0;
+		indices[i * 3 + 1] = i + 1;
+		indices[i * 3 + 2] = (i + 1) % triangleCount + 1;
+	}
+
+	CC3TangentMesh fan = { vertices, triangleCount + 1, indices, workIndices, triangleCount, 0, NULL, PVR_FAIL };
+	CC3GenerateTangents generate = { &fan, 1 };
+	generate();
+	free(fan.pVerticesOut);
+	return fan.error == PVR_SUCCESS;
+}
+
+/** Runs the tangent benchmark on a grid of the size in the specified string. Returns whether the results agree. */
+static bool CC3BenchmarkTangent(const char* gridSizeString) {
+	int gridSize = atoi(gridSizeString);
+	if (gridSize <= 0) {
+		fprintf(stderr, "Invalid grid size %s\n", gridSizeString);
+		return false;
+	}
+
+	unsigned int rowLength = gridSize + 1;
+	unsigned int vertexCount = rowLength * rowLength;
+	unsigned int triangleCount = gridSize * gridSize * 2;
+	CC3TangentVertex* pVertices = (CC3TangentVertex*)calloc(vertexCount, sizeof(CC3TangentVertex));
+	unsigned int* pIndices = (unsigned int*)malloc(triangleCount * 3 * sizeof(unsigned int));
+	unsigned int* pWorkIndices = (unsigned int*)malloc(triangleCount * 3 * sizeof(unsigned int));
+	if ( !pVertices || !pIndices || !pWorkIndices ) {
+		free(pVertices);
+		free(pIndices);
+		free(pWorkIndices);
+		fprintf(stderr, "Out of memory\n");
+		return false;
+	}
+
+	// A gently rolling sheet whose texture coordinates jump at random seams, and are
+	// mirrored in alternate strips, so that some vertices must be split.
+	gCC3RandomState = 1;
+	for (unsigned int y = 0; y < rowLength; y++) {
+		for (unsigned int x = 0; x < rowLength; x++) {
+			CC3TangentVertex& v = pVertices[y * rowLength + x];
+			float fx = x / (float)gridSize, fy = y / (float)gridSize;
+			v.position[0] = fx;
+			v.position[1] = sinf(fx * 6.0f) * 0.2f;
+			v.position[2] = fy;
+			v.normal[1] = 1.0f;
+			v.texCoord[0] = fx * 3.0f + (CC3RandomFloat(0.0f, 7.0f) < 1.0f ? 0.5f : 0.0f);
+			v.texCoord[1] = fy * ((x & 8) ? -2.0f : 2.0f);
+		}
+	}
+	unsigned int* pIdx = pIndices;
+	for (unsigned int y = 0; y < (unsigned int)gridSize; y++) {
+		for (unsigned int x = 0; x < (unsigned int)gridSize; x++) {
+			unsigned int a = y * rowLength + x, b = a + 1, c = a + rowLength, d = c + 1;
+			*pIdx++ = a; *pIdx++ = c; *pIdx++ = b;
+			*pIdx++ = b; *pIdx++ = c; *pIdx++ = d;
+		}
+	}
+
+	CC3TangentMesh mesh = { pVertices, vertexCount, pIndices, pWorkIndices, triangleCount, 0, NULL, PVR_FAIL };
+	CC3GenerateTangents oneThread = { &mesh, 1 };
+	double oneTime = CC3TimePerCall(oneThread);
+	bool isOK = (mesh.error == PVR_SUCCESS);
+	unsigned long long checksum = CC3TangentMeshChecksum(&mesh);
+
+	printf("%u vertices, %u triangles -> %u vertices (checksum %016llx)  1 thread %8.1f ms",
+		   vertexCount, triangleCount, isOK ? mesh.vertexCountOut : 0, checksum, oneTime / 1000.0);
+
+#ifndef CC3_PVRT_BASELINE
+	// The result does not depend on the number of threads used.
+	CC3GenerateTangents allThreads = { &mesh, 0 };
+	double allTime = CC3TimePerCall(allThreads);
+	bool isSame = isOK && (CC3TangentMeshChecksum(&mesh) == checksum);
+	printf("  all threads %8.1f ms (%.1fx, %s)", allTime / 1000.0, oneTime / allTime, isSame ? "same" : "differs");
+	isOK = isSame;
+#endif
+
+	bool isFanOK = CC3GenerateTangentsForFan();
+	printf("  200 triangle fan %s\n", isFanOK ? "ok" : "failed");
+
+	free(mesh.pVerticesOut);
+	free(pVertices);
+	free(pIndices);
+	free(pWorkIndices);
+	return isOK && isFanOK;
+}
+
+/** The vertex layout of the batch benchmark. */
+struct CC3SkinnedVertex {
+	float weights[4];
+	float boneIndices[4];
+	float sourceIndex;		// The index of the input vertex, so output vertices can be traced back.
+};
+
+/** The skinned mesh of the batch benchmark, and the most recent batching of it. */
+struct CC3SkinnedMesh {
+	const CC3SkinnedVertex* pVertices;
+	int vertexCount;
+	const unsigned int* pIndices;
+	unsigned int* pWorkIndices;
+	int triangleCount;
+	int batchBoneMax;
+	int vertexBoneCount;
+	CPVRTBoneBatches batches;
+	int vertexCountOut;
+	char* pVerticesOut;
+	EPVRTError error;
+};
+
+/** Batches the bones of a skinned mesh, starting from its original indices on each call. */
+struct CC3CreateBoneBatches {
+	CC3SkinnedMesh* pMesh;
+	void operator()() const {
+		pMesh->batches.Release();
+		free(pMesh->pVerticesOut);
+		pMesh->pVerticesOut = NULL;
+		memcpy(pMesh->pWorkIndices, pMesh->pIndices, pMesh->triangleCount * 3 * sizeof(unsigned int));
+		pMesh->error = pMesh->batches.Create(&pMesh->vertexCountOut, &pMesh->pVerticesOut, pMesh->pWorkIndices,
+											 pMesh->vertexCount, (const char*)pMesh->pVertices, sizeof(CC3SkinnedVertex),
+											 offsetof(CC3SkinnedVertex, weights), EPODDataFloat,
+											 offsetof(CC3SkinnedVertex, boneIndices), EPODDataFloat,
+											 pMesh->triangleCount, pMesh->batchBoneMax, pMesh->vertexBoneCount);
+	}
+};
+
+/**
+ * Returns the number of weighted bones of the output vertices of the specified mesh
+ * that do not resolve to their original bone through the palette of their batch.
+ */
+static int CC3CountBoneMismatches(const CC3SkinnedMesh* pMesh) {
+	const CPVRTBoneBatches& bb = pMesh->batches;
+	int mismatchCount = 0;
+	for (int b = 0; b < bb.nBatchCnt; b++) {
+		int triEnd = (b + 1 < bb.nBatchCnt) ? bb.pnBatchOffset[b + 1] : pMesh->triangleCount;
+		for (int tri = bb.pnBatchOffset[b]; tri < triEnd; tri++) {
+			for (int j = 0; j < 3; j++) {
+				const CC3SkinnedVertex* pOut = (const CC3SkinnedVertex*)&pMesh->pVerticesOut[pMesh->pWorkIndices[tri * 3 + j] * sizeof(CC3SkinnedVertex)];
+				const CC3SkinnedVertex& src = pMesh->pVertices[(int)pOut->sourceIndex];
+				for (int k = 0; k < pMesh->vertexBoneCount; k++) {
+					if (src.weights[k] == 0.0f) continue;
+					int paletteIdx = (int)pOut->boneIndices[k];
+					if (paletteIdx < 0 || paletteIdx >= bb.pnBatchBoneCnt[b] ||
+						bb.pnBatches[b * bb.nBatchBoneMax + paletteIdx] != (int)src.boneIndices[k]) mismatchCount++;
+				}
+			}
+		}
+	}
+	return mismatchCount;
+}
+
+/** A bone palette configuration of the batch benchmark. */
+struct CC3BoneBatchConfig {
+	int boneGridSize;		// The number of bones along each side of the square grid of bones.
+	int batchBoneMax;		// The number of bones in each palette.
+	int vertexBoneCount;	// The number of bones weighted to each vertex.
+};
+
+/** Runs the batch benchmark on a grid of the size in the specified string. Returns whether the results agree. */
+static bool CC3BenchmarkBatch(const char* gridSizeString) {
+	static const CC3BoneBatchConfig configs[] = { { 8, 12, 4 }, { 8, 20, 3 }, { 12, 30, 4 } };
+
+	int gridSize = atoi(gridSizeString);
+	if (gridSize <= 0) {
+		fprintf(stderr, "Invalid grid size %s\n", gridSizeString);
+		return false;
+	}
+
+	int rowLength = gridSize + 1;
+	int vertexCount = rowLength * rowLength;
+	int triangleCount = gridSize * gridSize * 2;
+	CC3SkinnedVertex* pVertices = (CC3SkinnedVertex*)calloc(vertexCount, sizeof(CC3SkinnedVertex));
+	unsigned int* pIndices = (unsigned int*)malloc(triangleCount * 3 * sizeof(unsigned int));
+	unsigned int* pWorkIndices = (unsigned int*)malloc(triangleCount * 3 * sizeof(unsigned int));
+	if ( !pVertices || !pIndices || !pWorkIndices ) {
+		free(pVertices);
+		free(pIndices);
+		free(pWorkIndices);
+		fprintf(stderr, "Out of memory\n");
+		return false;
+	}
+
+	unsigned int* pIdx = pIndices;
+	for (int y = 0; y < gridSize; y++) {
+		for (int x = 0; x < gridSize; x++) {
+			unsigned int a = y * rowLength + x, b = a + 1, c = a + rowLength, d = c + 1;
+			*pIdx++ = a; *pIdx++ = c; *pIdx++ = b;
+			*pIdx++ = b; *pIdx++ = c; *pIdx++ = d;
+		}
+	}
+
+	bool isOK = true;
+	for (unsigned int c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+		const CC3BoneBatchConfig& config = configs[c];
+
+		// Each vertex is weighted to bones near the bone under it, with some weights left empty.
+		gCC3RandomState = 1;
+		for (int y = 0; y < rowLength; y++) {
+			for (int x = 0; x < rowLength; x++) {
+				CC3SkinnedVertex& v = pVertices[y * rowLength + x];
+				int boneX = x * config.boneGridSize / rowLength;
+				int boneY = y * config.boneGridSize / rowLength;
+				v.sourceIndex = (float)(y * rowLength + x);
+				for (int k = 0; k < config.vertexBoneCount; k++) {
+					int bx = boneX + (int)CC3RandomFloat(0.0f, 3.0f) - 1;
+					int by = boneY + (int)CC3RandomFloat(0.0f, 3.0f) - 1;
+					bx = PVRT_CLAMP(bx, 0, config.boneGridSize - 1);
+					by = PVRT_CLAMP(by, 0, config.boneGridSize - 1);
+					v.boneIndices[k] = (float)(by * config.boneGridSize + bx);
+					v.weights[k] = (k && CC3RandomFloat(0.0f, 4.0f) < 1.0f) ? 0.0f : 0.25f;
+				}
+			}
+		}
+
+		// CPVRTBoneBatches has no constructor, and must be empty before it is first released.
+		CC3SkinnedMesh mesh;
+		memset(&mesh.batches, 0, sizeof(mesh.batches));
+		mesh.pVertices = pVertices;
+		mesh.vertexCount = vertexCount;
+		mesh.pIndices = pIndices;
+		mesh.pWorkIndices = pWorkIndices;
+		mesh.triangleCount = triangleCount;
+		mesh.batchBoneMax = config.batchBoneMax;
+		mesh.vertexBoneCount = config.vertexBoneCount;
+		mesh.vertexCountOut = 0;
+		mesh.pVerticesOut = NULL;
+		mesh.error = PVR_FAIL;
+		CC3CreateBoneBatches create = { &mesh };
+		double createTime = CC3TimePerCall(create);
+
+		if (mesh.error != PVR_SUCCESS) {
+			printf("%d triangles, %d bones, %d per palette, %d per vertex  failed\n", triangleCount,
+				   config.boneGridSize * config.boneGridSize, config.batchBoneMax, config.vertexBoneCount);
+			isOK = false;
+			continue;
+		}
+		int mismatchCount = CC3CountBoneMismatches(&mesh);
+		printf("%d triangles, %d bones, %d per palette, %d per vertex  %3d batches  %d -> %d vertices  %9.1f ms (%d differ)\n",
+			   triangleCount, config.boneGridSize * config.boneGridSize, config.batchBoneMax, config.vertexBoneCount,
+			   mesh.batches.nBatchCnt, vertexCount, mesh.vertexCountOut, createTime / 1000.0, mismatchCount);
+		isOK = isOK && !mismatchCount;
+
+		mesh.batches.Release();
+		free(mesh.pVerticesOut);
+	}
+
+	free(pVertices);
+	free(pIndices);
+	free(pWorkIndices);
+	return isOK;
+}
+
+#ifndef CC3_PVRT_BASELINE
+
+/** Continues the specified hash over the content of the specified vertex of a mesh, and returns the new hash. */
+static unsigned long long CC3VertexChecksum(unsigned long long hash, const SPODMesh& mesh, unsigned int vtxIdx) {
+	if (mesh.pInterleaved) {
+		return CC3ChecksumContinue(hash, mesh.pInterleaved + vtxIdx * mesh.sVertex.nStride, mesh.sVertex.nStride);
+	}
+	const CPODData* apData[] = { &mesh.sVertex, &mesh.sNormals, &mesh.sTangents, &mesh.sBinormals,
+								 &mesh.sVtxColours, &mesh.sBoneIdx, &mesh.sBoneWeight };
+	for (unsigned int i = 0; i < sizeof(apData) / sizeof(apData[0]); i++) {
+		if (apData[i]->pData) hash = CC3ChecksumContinue(hash, apData[i]->pData + vtxIdx * apData[i]->nStride, apData[i]->nStride);
+	}
+	for (unsigned int i = 0; i < mesh.nNumUVW; i++) {
+		if (mesh.psUVW[i].pData) hash = CC3ChecksumContinue(hash, mesh.psUVW[i].pData + vtxIdx * mesh.psUVW[i].nStride, mesh.psUVW[i].nStride);
+	}
+	return hash;
+}
+
+/**
+ * Fills the specified array, which has an entry for each bone batch of the specified mesh, or one
+ * entry if the mesh has no bone batches, with the sum of the hashes of the triangles of each batch.
+ * The hash of a triangle covers the content of its vertices, in order, so the sums do not change
+ * when the triangles within a batch, or the vertices of the mesh, are reordered.
+ */
+static void CC3BatchTriangleChecksums(unsigned long long* pChecksums, const SPODMesh& mesh) {
+	const CPVRTBoneBatches& bb = mesh.sBoneBatches;
+	int batchCount = PVRT_MAX(bb.nBatchCnt, 1);
+	memset(pChecksums, 0, batchCount * sizeof(unsigned long long));
+	int batchIdx = 0;
+	for (unsigned int triIdx = 0; triIdx < mesh.nNumFaces; triIdx++) {
+		while (batchIdx + 1 < bb.nBatchCnt && (unsigned int)bb.pnBatchOffset[batchIdx + 1] <= triIdx) batchIdx++;
+		unsigned long long hash = kCC3ChecksumStart;
+		for (unsigned int j = 0; j < 3; j++) {
+			unsigned int vtxIdx;
+			PVRTVertexRead(&vtxIdx, mesh.sFaces.pData + (triIdx * 3 + j) * mesh.sFaces.nStride, mesh.sFaces.eType);
+			hash = CC3VertexChecksum(hash, mesh, vtxIdx);
+		}
+		pChecksums[batchIdx] += hash;
+	}
+}
+
+/** Runs the vcache benchmark on the specified POD file. Returns whether the results agree. */
+static bool CC3BenchmarkVertexCache(const char* path) {
+	CPVRTModelPOD pod;
+	if (pod.ReadFromFile(path) != PVR_SUCCESS) {
+		fprintf(stderr, "Could not read %s\n", path);
+		return false;
+	}
+
+	bool isOK = true;
+	for (unsigned int i = 0; i < pod.nNumMesh; i++) {
+		SPODMesh& mesh = pod.pMesh[i];
+		if ( !mesh.sFaces.pData ) continue;		// Not indexed
+		if (mesh.nNumStrips && PVRTModelPODToggleStrips(pod, mesh) != PVR_SUCCESS) {
+			fprintf(stderr, "%s mesh %u: could not convert strips to a triangle list\n", CC3BaseName(path), i);
+			isOK = false;
+			continue;
+		}
+
+		int batchCount = PVRT_MAX(mesh.sBoneBatches.nBatchCnt, 1);
+		unsigned long long* pBefore = (unsigned long long*)malloc(batchCount * sizeof(unsigned long long));
+		unsigned long long* pAfter = (unsigned long long*)malloc(batchCount * sizeof(unsigned long long));
+		if ( !pBefore || !pAfter ) {
+			free(pBefore);
+			free(pAfter);
+			fprintf(stderr, "Out of memory\n");
+			return false;
+		}
+
+		CC3BatchTriangleChecksums(pBefore, mesh);
+		float acmrBefore = 0.0f, acmrAfter = 0.0f;
+		double startTime = CC3Now();
+		EPVRTError error = PVRTModelPODOptimiseVertexCache(mesh, &acmrBefore, &acmrAfter);
+		double optimiseTime = CC3Now() - startTime;
+		CC3BatchTriangleChecksums(pAfter, mesh);
+		bool isSame = (memcmp(pBefore, pAfter, batchCount * sizeof(unsigned long long)) == 0);
+
+		if (error == PVR_SUCCESS) {
+			printf("%-28s mesh %2u %6u triangles %6u vertices %3d batches  ACMR %.3f -> %.3f (%.0f%%)  %8.1f us (%s)\n",
+				   CC3BaseName(path), i, mesh.nNumFaces, mesh.nNumVertex, mesh.sBoneBatches.nBatchCnt,
+				   acmrBefore, acmrAfter, 100.0f * (acmrAfter - acmrBefore) / acmrBefore,
+				   optimiseTime * 1000000.0, isSame ? "same triangles" : "triangles differ");
+		} else {
+			printf("%-28s mesh %2u failed\n", CC3BaseName(path), i);
+		}
+		isOK = isOK && (error == PVR_SUCCESS) && isSame;
+
+		free(pBefore);
+		free(pAfter);
+	}
+	return isOK;
+}
+
+/** Returns the sum of the hashes of the triangles of the specified index list, which does not depend on their order. */
+static unsigned long long CC3TriangleListChecksum(const unsigned int* pIndices, unsigned int triangleCount) {
+	unsigned long long checksum = 0;
+	for (unsigned int i = 0; i < triangleCount; i++) checksum += CC3Checksum(&pIndices[i * 3], 3 * sizeof(unsigned int));
+	return checksum;
+}
+
+/** Runs the vcachegrid benchmark on a grid of the size in the specified string. Returns whether the results agree. */
+static bool CC3BenchmarkVertexCacheGrid(const char* gridSizeString) {
+	int gridSize = atoi(gridSizeString);
+	if (gridSize <= 0) {
+		fprintf(stderr, "Invalid grid size %s\n", gridSizeString);
+		return false;
+	}
+
+	unsigned int rowLength = gridSize + 1;
+	unsigned int vertexCount = rowLength * rowLength;
+	unsigned int triangleCount = gridSize * gridSize * 2;
+	unsigned int* pIndices = (unsigned int*)malloc(triangleCount * 3 * sizeof(unsigned int));
+	if ( !pIndices ) {
+		fprintf(stderr, "Out of memory\n");
+		return false;
+	}
+
+	unsigned int* pIdx = pIndices;
+	for (unsigned int y = 0; y < (unsigned int)gridSize; y++) {
+		for (unsigned int x = 0; x < (unsigned int)gridSize; x++) {
+			unsigned int a = y * rowLength + x, b = a + 1, c = a + rowLength, d = c + 1;
+			*pIdx++ = a; *pIdx++ = c; *pIdx++ = b;
+			*pIdx++ = b; *pIdx++ = c; *pIdx++ = d;
+		}
+	}
+
+	// Shuffle the triangles, keeping the vertices of each triangle in order
+	gCC3RandomState = 1;
+	for (unsigned int i = triangleCount - 1; i > 0; i--) {
+		unsigned int j = PVRT_MIN((unsigned int)CC3RandomFloat(0.0f, (float)(i + 1)), i);
+		for (unsigned int k = 0; k < 3; k++) {
+			unsigned int tmp = pIndices[i * 3 + k];
+			pIndices[i * 3 + k] = pIndices[j * 3 + k];
+			pIndices[j * 3 + k] = tmp;
+		}
+	}
+
+	unsigned long long checksum = CC3TriangleListChecksum(pIndices, triangleCount);
+	float acmrBefore = PVRTVertexCacheACMR(pIndices, triangleCount, vertexCount);
+	double startTime = CC3Now();
+	EPVRTError error = PVRTVertexCacheOptimise(pIndices, triangleCount, vertexCount);
+	double optimiseTime = CC3Now() - startTime;
+	float acmrAfter = PVRTVertexCacheACMR(pIndices, triangleCount, vertexCount);
+	bool isSame = (CC3TriangleListChecksum(pIndices, triangleCount) == checksum);
+
+	if (error == PVR_SUCCESS) {
+		printf("%u triangles shuffled  ACMR %.3f -> %.3f  %8.1f ms (%s)\n", triangleCount,
+			   acmrBefore, acmrAfter, optimiseTime * 1000.0, isSame ? "same triangles" : "triangles differ");
+	} else {
+		printf("%u triangles shuffled  failed\n", triangleCount);
+	}
+
+	free(pIndices);
+	return (error == PVR_SUCCESS) && isSame;
+}
+
+/** Reads the specified vertex of the specified attribute of a mesh, filling the unused components with zero. */
+static PVRTVECTOR4f CC3ReadVertexAttribute(const SPODMesh& mesh, const CPODData& data, unsigned int vtxIdx) {
+	PVRTVECTOR4f v = { 0.0f, 0.0f, 0.0f, 0.0f };
+	const PVRTuint8* pData = mesh.pInterleaved ? mesh.pInterleaved + (size_t)data.pData : data.pData;
+	PVRTVertexRead(&v, pData + vtxIdx * data.nStride, data.eType, data.n * PVRTModelPODDataTypeComponentCount(data.eType));
+	return v;
+}
+
+/** Returns the angle, in radians, between the specified directions. */
+static float CC3AngleBetween(const PVRTVECTOR4f& a, const PVRTVECTOR4f& b) {
+	float lenA = sqrtf(a.x * a.x + a.y * a.y + a.z * a.z);
+	float lenB = sqrtf(b.x * b.x + b.y * b.y + b.z * b.z);
+	if (lenA == 0.0f || lenB == 0.0f) return (lenA == lenB) ? 0.0f : (float)PVRT_PIf;
+	float cosAngle = (a.x * b.x + a.y * b.y + a.z * b.z) / (lenA * lenB);
+	return acosf(PVRT_MIN(1.0f, PVRT_MAX(-1.0f, cosAngle)));
+}
+
+/** The largest errors found by comparing a packed mesh with the original. */
+struct CC3PackErrors {
+	float position;
+	float normal;
+	float uvw;
+	float boneWeight;
+	int mismatchCount;		// Values outside the reported errors, and unpacked values that changed.
+};
+
+/** Compares each attribute of each vertex of the specified packed mesh with the original mesh. */
+static void CC3ComparePackedMesh(CC3PackErrors* pErrors, const SPODMesh& orig, const SPODMesh& packed,
+								 const SPODPackReport& report) {
+	// Errors are allowed a small margin, for rounding in the reported values and the unpacking.
+	// Normals get more, as PVRTVertexRead decodes signed bytes with a different scale than the packing.
+	const float kMargin = 1.0e-5f;
+	const float kNormalMargin = 1.0e-3f;
+	const CPODData* apOrig[] = { &orig.sVertex, &orig.sNormals, &orig.sTangents, &orig.sBinormals,
+								 &orig.sVtxColours, &orig.sBoneIdx, &orig.sBoneWeight };
+	const CPODData* apPacked[] = { &packed.sVertex, &packed.sNormals, &packed.sTangents, &packed.sBinormals,
+								   &packed.sVtxColours, &packed.sBoneIdx, &packed.sBoneWeight };
+	const unsigned int arrayCount = sizeof(apOrig) / sizeof(apOrig[0]);
+
+	for (unsigned int k = 0; k < arrayCount + orig.nNumUVW; k++) {
+		const CPODData& a = (k < arrayCount) ? *apOrig[k] : orig.psUVW[k - arrayCount];
+		const CPODData& b = (k < arrayCount) ? *apPacked[k] : packed.psUVW[k - arrayCount];
+		if ( !a.n ) continue;
+
+		for (unsigned int v = 0; v < orig.nNumVertex; v++) {
+			PVRTVECTOR4f x = CC3ReadVertexAttribute(orig, a, v);
+			PVRTVECTOR4f y = CC3ReadVertexAttribute(packed, b, v);
+
+			if (k == 0) {
+				// Compare positions in model space, through the unpacking matrix of each mesh
+				PVRTVECTOR4f xIn = { x.x, x.y, x.z, 1.0f }, yIn = { y.x, y.y, y.z, 1.0f };
+				PVRTTransform(&x, &xIn, &orig.mUnpackMatrix);
+				PVRTTransform(&y, &yIn, &packed.mUnpackMatrix);
+				for (unsigned int j = 0; j < 3; j++) {
+					float error = fabsf((&x.x)[j] - (&y.x)[j]);
+					pErrors->position = PVRT_MAX(pErrors->position, error);
+					if (error > report.fPositionError + kMargin * PVRT_MAX(1.0f, fabsf((&x.x)[j]))) pErrors->mismatchCount++;
+				}
+			} else if (k <= 3 && a.eType != b.eType) {
+				float error = CC3AngleBetween(x, y);
+				pErrors->normal = PVRT_MAX(pErrors->normal, error);
+				if (error > report.fNormalError + kNormalMargin) pErrors->mismatchCount++;
+			} else if (k == 6 && a.eType != b.eType) {
+				for (unsigned int j = 0; j < a.n; j++) {
+					float error = fabsf((&x.x)[j] - (&y.x)[j]);
+					pErrors->boneWeight = PVRT_MAX(pErrors->boneWeight, error);
+					if (error > report.fBoneWeightError + kMargin) pErrors->mismatchCount++;
+				}
+			} else if (k >= arrayCount && a.eType != b.eType) {
+				const float* pfScale = &report.avUVWScale[k - arrayCount].x;
+				const float* pfOffset = &report.avUVWOffset[k - arrayCount].x;
+				for (unsigned int j = 0; j < a.n; j++) {
+					float error = fabsf((&x.x)[j] - ((&y.x)[j] * pfScale[j] + pfOffset[j]));
+					pErrors->uvw = PVRT_MAX(pErrors->uvw, error);
+					if (error > report.fUVWError + kMargin * PVRT_MAX(1.0f, fabsf((&x.x)[j]))) pErrors->mismatchCount++;
+				}
+			} else {
+				// Copied unchanged, or bone indices narrowed to bytes
+				for (unsigned int j = 0; j < 4; j++)
+					if ((&x.x)[j] != (&y.x)[j]) pErrors->mismatchCount++;
+			}
+		}
+	}
+}
+
+/**
+ * Creates an empty temporary file, and fills the specified buffer, of at least
+ * kCC3TemporaryPathLength characters, with its path. Returns whether it was created.
+ */
+#define kCC3TemporaryPathLength		32
+static bool CC3CreateTemporaryFile(char* path) {
+	strcpy(path, "/tmp/CC3PVRBenchmarkXXXXXX");
+	int fd = mkstemp(path);
+	if (fd < 0) {
+		fprintf(stderr, "Could not create a temporary file\n");
+		return false;
+	}
+	close(fd);
+	return true;
+}
+
+/** Runs the pack benchmark on the specified POD file. Returns whether the results agree. */
+static bool CC3BenchmarkPack(const char* path) {
+	CPVRTModelPOD orig, packed, cooked;
+	if (orig.ReadFromFile(path) != PVR_SUCCESS) {
+		fprintf(stderr, "Could not read %s\n", path);
+		return false;
+	}
+
+	char podPath[kCC3TemporaryPathLength], cookedPath[kCC3TemporaryPathLength];
+	if ( !CC3CreateTemporaryFile(podPath) ) return false;
+	if ( !CC3CreateTemporaryFile(cookedPath) ) {
+		unlink(podPath);
+		return false;
+	}
+
+	bool isLoaded = (orig.SavePOD(podPath) == PVR_SUCCESS && packed.ReadFromFileMapped(podPath) == PVR_SUCCESS &&
+					 orig.SaveCooked(cookedPath) == PVR_SUCCESS && cooked.ReadFromFileCooked(cookedPath) == PVR_SUCCESS);
+	unlink(podPath);
+	unlink(cookedPath);
+	if ( !isLoaded ) {
+		fprintf(stderr, "Could not rewrite %s\n", path);
+		return false;
+	}
+
+	bool isOK = true;
+	for (unsigned int i = 0; i < cooked.nNumMesh; i++) {
+		if (PVRTModelPODPackVertexData(cooked, cooked.pMesh[i]) != PVR_FAIL) {
+			printf("%-28s mesh %2u of the cooked scene was not refused\n", CC3BaseName(path), i);
+			isOK = false;
+		}
+	}
+
+	for (unsigned int i = 0; i < packed.nNumMesh; i++) {
+		SPODMesh& mesh = packed.pMesh[i];
+		bool wasMapped = packed.IsMappedData(mesh.pInterleaved ? mesh.pInterleaved : mesh.sVertex.pData);
+
+		SPODPackReport report;
+		if (PVRTModelPODPackVertexData(packed, mesh, ePODPackAll, 4, &report) != PVR_SUCCESS) {
+			printf("%-28s mesh %2u failed\n", CC3BaseName(path), i);
+			isOK = false;
+			continue;
+		}
+
+		CC3PackErrors errors;
+		memset(&errors, 0, sizeof(errors));
+		CC3ComparePackedMesh(&errors, orig.pMesh[i], mesh, report);
+		printf("%-28s mesh %2u %6u vertices %s  %6u -> %6u bytes  position %.2g  normal %.2g rad  uvw %.2g  weight %.2g  (%d differ)\n",
+			   CC3BaseName(path), i, mesh.nNumVertex, wasMapped ? "mapped" : "copied",
+			   report.nBytesBefore, report.nBytesAfter, errors.position, errors.normal, errors.uvw,
+			   errors.boneWeight, errors.mismatchCount);
+		isOK = isOK && !errors.mismatchCount;
+	}
+	return isOK;
+}
+
+/** Loads a POD file as CC3PODResource does. */
+struct CC3LoadPOD {
+	const char* path;
+	bool* pIsOK;
+	void operator()() const {
+		CPVRTModelPOD pod;
+		*pIsOK = *pIsOK && pod.ReadFromFile(path) == PVR_SUCCESS && pod.SplitMeshes() == PVR_SUCCESS;
+	}
+};
+
+/** Loads a cooked POD file, checking it against the POD file it was cooked from, as CC3PODResource does. */
+struct CC3LoadCookedPOD {
+	const char* cookedPath;
+	const char* path;
+	bool* pIsOK;
+	void operator()() const {
+		CPVRTModelPOD pod;
+		*pIsOK = *pIsOK && pod.ReadFromFileCooked(cookedPath, path) == PVR_SUCCESS;
+	}
+};
+
+/** Returns a checksum of the nodes, and of the vertices and indices of the meshes, of the specified scene. */
+static unsigned long long CC3SceneChecksum(const CPVRTModelPOD& pod) {
+	unsigned long long hash = kCC3ChecksumStart;
+	for (unsigned int i = 0; i < pod.nNumNode; i++) {
+		const SPODNode& node = pod.pNode[i];
+		hash = CC3ChecksumContinue(hash, &node.nIdx, sizeof(node.nIdx));
+		hash = CC3ChecksumContinue(hash, &node.nIdxParent, sizeof(node.nIdxParent));
+		hash = CC3ChecksumContinue(hash, &node.nIdxMaterial, sizeof(node.nIdxMaterial));
+		if (node.pszName) hash = CC3ChecksumContinue(hash, node.pszName, strlen(node.pszName));
+	}
+	for (unsigned int i = 0; i < pod.nNumMesh; i++) {
+		const SPODMesh& mesh = pod.pMesh[i];
+		for (unsigned int v = 0; v < mesh.nNumVertex; v++) hash = CC3VertexChecksum(hash, mesh, v);
+		if (mesh.sFaces.pData) {
+			hash = CC3ChecksumContinue(hash, mesh.sFaces.pData, PVRTModelPODCountIndices(mesh) * PVRTModelPODDataStride(mesh.sFaces));
+		}
+	}
+	return hash;
+}
+
+/** Returns a checksum of the animation of the nodes of the specified scene. */
+static unsigned long long CC3AnimationChecksum(const CPVRTModelPOD& pod) {
+	unsigned long long hash = kCC3ChecksumStart;
+	for (unsigned int i = 0; i < pod.nNumNode; i++) {
+		const SPODNode& node = pod.pNode[i];
+		const unsigned int animFlags[] = { ePODHasPositionAni, ePODHasRotationAni, ePODHasScaleAni, ePODHasMatrixAni };
+		PVRTuint32* const pnIdx[] = { node.pnAnimPositionIdx, node.pnAnimRotationIdx, node.pnAnimScaleIdx, node.pnAnimMatrixIdx };
+		const VERTTYPE* const pfData[] = { node.pfAnimPosition, node.pfAnimRotation, node.pfAnimScale, node.pfAnimMatrix };
+		const unsigned int componentCounts[] = { 3, 4, 7, 16 };
+
+		hash = CC3ChecksumContinue(hash, &node.nAnimFlags, sizeof(node.nAnimFlags));
+		for (unsigned int j = 0; j < 4; j++) {
+			if ( !pfData[j] ) continue;
+			unsigned int valueCount = (node.nAnimFlags & animFlags[j])
+										? PVRTModelPODGetAnimArraySize(pnIdx[j], pod.nNumFrame, componentCounts[j])
+										: componentCounts[j];
+			if (pnIdx[j] && (node.nAnimFlags & animFlags[j])) hash = CC3ChecksumContinue(hash, pnIdx[j], pod.nNumFrame * sizeof(PVRTuint32));
+			hash = CC3ChecksumContinue(hash, pfData[j], valueCount * sizeof(VERTTYPE));
+		}
+	}
+	return hash;
+}
+
+/** Reads a POD file with ReadFromFile. */
+struct CC3ReadPOD {
+	const char* path;
+	bool* pIsOK;
+	void operator()() const {
+		CPVRTModelPOD pod;
+		*pIsOK = *pIsOK && pod.ReadFromFile(path) == PVR_SUCCESS;
+	}
+};
+
+/** Reads a POD file with ReadFromFileLazy, then loads the specified number of its meshes and node animations. */
+struct CC3ReadPODLazily {
+	const char* path;
+	bool* pIsOK;
+	bool shouldLoadAll;
+	void operator()() const {
+		CPVRTModelPOD pod;
+		*pIsOK = *pIsOK && pod.ReadFromFileLazy(path) == PVR_SUCCESS;
+		if ( !shouldLoadAll ) return;
+		for (unsigned int i = 0; i < pod.nNumMesh; i++) *pIsOK = *pIsOK && pod.LoadMesh(i) == PVR_SUCCESS;
+		for (unsigned int i = 0; i < pod.nNumNode; i++) *pIsOK = *pIsOK && pod.LoadNodeAnimation(i) == PVR_SUCCESS;
+	}
+};
+
+/** Fills the specified array with the world matrices of the nodes of the specified scene at the specified frame. */
+static void CC3GetWorldMatrices(CPVRTModelPOD& pod, VERTTYPE fFrame, PVRTMATRIX* pmWorld) {
+	pod.SetFrame(fFrame);
+	for (unsigned int i = 0; i < pod.nNumNode; i++) pod.GetWorldMatrix(pmWorld[i], pod.pNode[i]);
+}
+
+/**
+ * Bakes the animation of the specified lazily read scene before loading it, and checks that the world
+ * matrices then match those of the specified baked eager scene at every sample, and that they return
+ * to the frame 0 pose once the animation is unloaded again. Returns whether they do, and sets the
+ * number of samples at which some node has moved from its frame 0 pose.
+ */
+static bool CC3CheckLazyBakedAnimation(CPVRTModelPOD& eager, CPVRTModelPOD& lazy, unsigned int* pMovedCount) {
+	const float kMargin = 1e-5f;
+	unsigned int nodeCount = eager.nNumNode, sampleCount = CC3SampleCount(eager);
+	PVRTMATRIX* pmEager = new PVRTMATRIX[nodeCount];
+	PVRTMATRIX* pmLazy = new PVRTMATRIX[nodeCount];
+	PVRTMATRIX* pmPose = new PVRTMATRIX[nodeCount];
+	bool isSame = (eager.BakeAnimation() == PVR_SUCCESS && lazy.BakeAnimation() == PVR_SUCCESS);
+
+	*pMovedCount = 0;
+	CC3GetWorldMatrices(lazy, f2vt(0.0f), pmPose);
+	for (unsigned int i = 0; isSame && i < nodeCount; i++) isSame = (lazy.LoadNodeAnimation(i) == PVR_SUCCESS);
+	for (unsigned int i = 0; isSame && i < sampleCount; i++) {
+		CC3GetWorldMatrices(eager, CC3SampleFrame(i), pmEager);
+		CC3GetWorldMatrices(lazy, CC3SampleFrame(i), pmLazy);
+		isSame = (CC3MatrixArrayDiff(pmEager, pmLazy, nodeCount) <= kMargin);
+		if (CC3MatrixArrayDiff(pmPose, pmLazy, nodeCount) > kMargin) (*pMovedCount)++;
+	}
+
+	for (unsigned int i = 0; isSame && i < nodeCount; i++) lazy.UnloadNodeAnimation(i);
+	for (unsigned int i = 0; isSame && i < sampleCount; i++) {
+		CC3GetWorldMatrices(lazy, CC3SampleFrame(i), pmLazy);
+		isSame = (CC3MatrixArrayDiff(pmPose, pmLazy, nodeCount) <= kMargin);
+	}
+
+	delete[] pmEager;
+	delete[] pmLazy;
+	delete[] pmPose;
+	return isSame;
+}
+
+/** Runs the lazy benchmark on the specified POD file. Returns whether the results agree. */
+static bool CC3BenchmarkLazy(const char* path) {
+	CPVRTModelPOD eager, lazy;
+	bool isOK = (eager.ReadFromFile(path) == PVR_SUCCESS && lazy.ReadFromFileLazy(path) == PVR_SUCCESS);
+	for (unsigned int i = 0; isOK && i < lazy.nNumMesh; i++) isOK = (lazy.LoadMesh(i) == PVR_SUCCESS);
+	for (unsigned int i = 0; isOK && i < lazy.nNumNode; i++) isOK = (lazy.LoadNodeAnimation(i) == PVR_SUCCESS);
+	if ( !isOK ) {
+		fprintf(stderr, "Could not read %s\n", path);
+		return false;
+	}
+	bool isSame = (eager.nNumNode == lazy.nNumNode && eager.nNumMesh == lazy.nNumMesh &&
+				   CC3SceneChecksum(eager) == CC3SceneChecksum(lazy) &&
+				   CC3AnimationChecksum(eager) == CC3AnimationChecksum(lazy));
+
+	CPVRTModelPOD baked;
+	unsigned int movedCount = 0;
+	bool isBakedSame = (baked.ReadFromFileLazy(path) == PVR_SUCCESS && CC3CheckLazyBakedAnimation(eager, baked, &movedCount));
+
+	CC3ReadPOD readPOD = { path, &isOK };
+	CC3ReadPODLazily readHeaders = { path, &isOK, false };
+	CC3ReadPODLazily readAll = { path, &isOK, true };
+	double eagerTime = CC3TimePerCall(readPOD);
+	double headerTime = CC3TimePerCall(readHeaders);
+	double allTime = CC3TimePerCall(readAll);
+
+	printf("%-28s ReadFromFile %9.1f us  ReadFromFileLazy %9.1f us (%.1fx)  then loading all %9.1f us (%.2fx)  %s  baked %s (%u of %u samples moved)\n",
+		   CC3BaseName(path), eagerTime, headerTime, eagerTime / headerTime, allTime, eagerTime / allTime,
+		   !isOK ? "failed" : (isSame ? "same scene" : "scene differs"),
+		   isBakedSame ? "same" : "differs", movedCount, CC3SampleCount(eager));
+	return isOK && isSame && isBakedSame;
+}
+
+/** Returns whether a cooked file of the specified scene is refused once the POD file it was cooked from changes. */
+static bool CC3IsStaleCookedFileRefused(CPVRTModelPOD& pod, const char* cookedPath) {
+	char sourcePath[kCC3TemporaryPathLength];
+	if ( !CC3CreateTemporaryFile(sourcePath) ) return false;
+
+	CPVRTModelPOD cooked;
+	bool isFreshLoaded = (pod.SaveCooked(cookedPath, sourcePath) == PVR_SUCCESS &&
+						  cooked.ReadFromFileCooked(cookedPath, sourcePath) == PVR_SUCCESS);
+
+	FILE* pFile = fopen(sourcePath, "ab");
+	bool isChanged = (pFile != NULL);
+	if (pFile) isChanged = (fputc(0, pFile) != EOF) & (fclose(pFile) == 0);
+	bool isStaleRefused = isChanged && cooked.ReadFromFileCooked(cookedPath, sourcePath) == PVR_FAIL;
+
+	unlink(sourcePath);
+	return isFreshLoaded && isStaleRefused;
+}
+
+/** Runs the cooked benchmark on the specified POD file. Returns whether the results agree. */
+static bool CC3BenchmarkCooked(const char* path) {
+	// Cook the scene as CC3PODCooker does
+	CPVRTModelPOD orig, cooked;
+	if (orig.ReadFromFile(path) != PVR_SUCCESS || orig.SplitMeshes() != PVR_SUCCESS) {
+		fprintf(stderr, "Could not read %s\n", path);
+		return false;
+	}
+	for (unsigned int i = 0; i < orig.nNumMesh; i++) {
+		if ( !orig.pMesh[i].pInterleaved ) PVRTModelPODToggleInterleaved(orig.pMesh[i], 4);
+	}
+
+	char cookedPath[kCC3TemporaryPathLength];
+	if ( !CC3CreateTemporaryFile(cookedPath) ) return false;
+
+	bool isOK = (orig.SaveCooked(cookedPath, path) == PVR_SUCCESS && cooked.ReadFromFileCooked(cookedPath, path) == PVR_SUCCESS);
+	if ( !isOK ) {
+		unlink(cookedPath);
+		fprintf(stderr, "Could not cook %s\n", path);
+		return false;
+	}
+	bool isSame = (orig.nNumNode == cooked.nNumNode && orig.nNumMesh == cooked.nNumMesh &&
+				   CC3SceneChecksum(orig) == CC3SceneChecksum(cooked));
+
+	CC3LoadPOD loadPOD = { path, &isOK };
+	CC3LoadCookedPOD loadCooked = { cookedPath, path, &isOK };
+	double podTime = CC3TimePerCall(loadPOD);
+	double cookedTime = CC3TimePerCall(loadCooked);
+
+	struct stat st;
+	unsigned long cookedSize = (stat(cookedPath, &st) == 0) ? (unsigned long)st.st_size : 0;
+	bool isStaleRefused = CC3IsStaleCookedFileRefused(orig, cookedPath);
+	unlink(cookedPath);
+
+	printf("%-28s %7lu byte cooked file  ReadFromFile %9.1f us  ReadFromFileCooked %9.1f us (%.1fx)  %s, %s\n",
+		   CC3BaseName(path), cookedSize, podTime, cookedTime, podTime / cookedTime,
+		   !isOK ? "failed" : (isSame ? "same scene" : "scene differs"),
+		   isStaleRefused ? "stale file refused" : "stale file loaded");
+	return isOK && isSame && isStaleRefused;
+}
+
+#endif	// CC3_PVRT_BASELINE
+
+static void CC3PrintUsage(void) {
+	fprintf(stderr, "Usage: CC3PVRBenchmark anim|world pod-file...\n");
+	fprintf(stderr, "       CC3PVRBenchmark cull box-count...\n");
+	fprintf(stderr, "       CC3PVRBenchmark tangent grid-size...\n");
+	fprintf(stderr, "       CC3PVRBenchmark batch grid-size...\n");
+	fprintf(stderr, "       CC3PVRBenchmark vcache pod-file...\n");
+	fprintf(stderr, "       CC3PVRBenchmark vcachegrid grid-size...\n");
+	fprintf(stderr, "       CC3PVRBenchmark pack pod-file...\n");
+	fprintf(stderr, "       CC3PVRBenchmark cooked pod-file...\n");
+	fprintf(stderr, "       CC3PVRBenchmark lazy pod-file...\n");
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 3) {
+		CC3PrintUsage();
+		return 1;
+	}
+
+	const char* benchmark = argv[1];
+	int failCount = 0;
+	for (int i = 2; i < argc; i++) {
+		bool isOK;
+#ifndef CC3_PVRT_BASELINE
+		if (strcmp(benchmark, "anim") == 0) {
+			isOK = CC3BenchmarkAnim(argv[i]);
+		} else if (strcmp(benchmark, "world") == 0) {
+			isOK = CC3BenchmarkWorld(argv[i]);
+		} else if (strcmp(benchmark, "cull") == 0) {
+			isOK = CC3BenchmarkCull(argv[i]);
+		} else if (strcmp(benchmark, "vcache") == 0) {
+			isOK = CC3BenchmarkVertexCache(argv[i]);
+		} else if (strcmp(benchmark, "vcachegrid") == 0) {
+			isOK = CC3BenchmarkVertexCacheGrid(argv[i]);
+		} else if (strcmp(benchmark, "pack") == 0) {
+			isOK = CC3BenchmarkPack(argv[i]);
+		} else if (strcmp(benchmark, "cooked") == 0) {
+			isOK = CC3BenchmarkCooked(argv[i]);
+		} else if (strcmp(benchmark, "lazy") == 0) {
+			isOK = CC3BenchmarkLazy(argv[i]);
+		} else
+#endif
+		if (strcmp(benchmark, "tangent") == 0) {
+			isOK = CC3BenchmarkTangent(argv[i]);
+		} else if (strcmp(benchmark, "batch") == 0) {
+			isOK = CC3BenchmarkBatch(argv[i]);
+		} else {
+			CC3PrintUsage();
+			return 1;
+		}
+		if ( !isOK ) {
+			fprintf(stderr, "%s: %s failed\n", argv[i], benchmark);
+			failCount++;
+		}
+	}
+	return failCount ? 1 : 0;
+}
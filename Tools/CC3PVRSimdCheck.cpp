@@ -0,0 +1,499 @@
+/*
+ * CC3PVRSimdCheck.cpp
+ *
+ * cocos3d 0.7.1
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2012 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+
+/**
+ * Checks that the SIMD paths of the PVRT math functions give the same results as their
+ * scalar reference code, which is selected by defining PVRT_NO_SIMD.
+ *
+ * The same checks are built twice from the PVRT sources used by cocos3d, once with each
+ * kind of code. The scalar build writes its results to a file, and the SIMD build compares
+ * its own results against them:
+ *
+ *   PVRT="../cocos3d/cc3PVR/PVRT 2.10"
+ *   SRC="CC3PVRSimdCheck.cpp $PVRT/PVRTMatrixF.cpp $PVRT/PVRTQuaternionF.cpp \
+ *        $PVRT/PVRTVector.cpp $PVRT/PVRTTrans.cpp $PVRT/PVRTFixedPoint.cpp"
+ *   c++ -O2 -I"$PVRT" -I"$PVRT/OGLES" -o CC3PVRSimdCheck $SRC
+ *   c++ -O2 -DPVRT_NO_SIMD -I"$PVRT" -I"$PVRT/OGLES" -o CC3PVRSimdCheckScalar $SRC
+ *   ./CC3PVRSimdCheckScalar -write scalar.dat
+ *   ./CC3PVRSimdCheck -compare scalar.dat
+ *
+ * Usage:
+ *
+ *   CC3PVRSimdCheck [-write file | -compare file] [-tolerance t]
+ *
+ * Each check runs one function over the same pseudo-random inputs in both builds, and also
+ * prints the time taken per call, or per box for the bounding box checks. When comparing,
+ * each check prints the number of results that differ in any bit, and the largest difference,
+ * relative to the size of the results when they are larger than one. The tool exits with a
+ * non-zero status if any difference exceeds the tolerance, which is 1e-6 by default.
+ */
+
+#include "PVRTMatrix.h"
+#include "PVRTQuaternion.h"
+#include "PVRTVector.h"
+#include "PVRTTrans.h"
+#include "PVRTSimd.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+
+/** The number of inputs each check is run over. */
+#define kCC3SimdCheckCount			4096
+
+/** The number of times each check is repeated when it is timed. */
+#define kCC3SimdCheckTimingRepeats	200
+
+/** The tolerance used when none is specified. */
+#define kCC3SimdCheckDefaultTolerance	1.0e-6f
+
+/** The results of one check. */
+typedef struct {
+	const char* name;
+	float* results;
+	unsigned int resultCount;
+	double nsPerCall;
+} CC3SimdCheck;
+
+/** Returns the current time in seconds. */
+static double CC3Now(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+/** The state of the pseudo-random input generator, which gives the same inputs on every build. */
+static unsigned int gCC3RandomState = 1;
+
+/** Returns a pseudo-random float between -2 and 2. */
+static float CC3RandomFloat(void) {
+	gCC3RandomState = gCC3RandomState * 1664525u + 1013904223u;
+	return ((gCC3RandomState >> 8) / 16777216.0f) * 4.0f - 2.0f;
+}
+
+/** Fills the specified matrix with pseudo-random values. If isAffine, the last column is [0 0 0 1]. */
+static void CC3RandomMatrix(PVRTMATRIXf& m, bool isAffine) {
+	for (int i = 0; i < 16; i++) m.f[i] = CC3RandomFloat();
+	if (isAffine) {
+		m.f[3] = m.f[7] = m.f[11] = 0.0f;
+		m.f[15] = 1.0f;
+	}
+}
+
+/** Fills the specified matrix with a recognizable value, to show whether a function writes to it. */
+static void CC3SentinelMatrix(PVRTMATRIXf& m) {
+	for (int i = 0; i < 16; i++) m.f[i] = 12345.0f + i;
+}
+
+/** Allocates the result array of the specified check, which holds count floats. */
+static float* CC3AllocResults(CC3SimdCheck* check, const char* name, unsigned int count) {
+	check->name = name;
+	check->resultCount = count;
+	check->results = (float*)calloc(count, sizeof(float));
+	if ( !check->results ) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+	return check->results;
+}
+
+/** Returns the average time in nanoseconds taken by one call, given the time taken by a timing loop. */
+static double CC3NsPerCall(double duration) {
+	return duration * 1.0e9 / ((double)kCC3SimdCheckTimingRepeats * kCC3SimdCheckCount);
+}
+
+/** Checks PVRTMatrixMultiplyF, including writing over each of its operands. */
+static void CC3CheckMatrixMultiply(CC3SimdCheck* check) {
+	PVRTMATRIXf* pmA = new PVRTMATRIXf[kCC3SimdCheckCount];
+	PVRTMATRIXf* pmB = new PVRTMATRIXf[kCC3SimdCheckCount];
+	PVRTMATRIXf* pmOut = new PVRTMATRIXf[kCC3SimdCheckCount];
+	float* pfOut = CC3AllocResults(check, "PVRTMatrixMultiplyF", kCC3SimdCheckCount * 16 * 3);
+
+	for (int i = 0; i < kCC3SimdCheckCount; i++) {
+		CC3RandomMatrix(pmA[i], false);
+		CC3RandomMatrix(pmB[i], false);
+	}
+
+	for (int i = 0; i < kCC3SimdCheckCount; i++) {
+		PVRTMATRIXf mA = pmA[i], mB = pmB[i];
+		PVRTMatrixMultiplyF(pmOut[i], pmA[i], pmB[i]);
+		PVRTMatrixMultiplyF(mA, mA, pmB[i]);
+		PVRTMatrixMultiplyF(mB, pmA[i], mB);
+		memcpy(&pfOut[(i * 3 + 0) * 16], pmOut[i].f, sizeof(pmOut[i].f));
+		memcpy(&pfOut[(i * 3 + 1) * 16], mA.f, sizeof(mA.f));
+		memcpy(&pfOut[(i * 3 + 2) * 16], mB.f, sizeof(mB.f));
+	}
+
+	double startTime = CC3Now();
+	for (int r = 0; r < kCC3SimdCheckTimingRepeats; r++) {
+		for (int i = 0; i < kCC3SimdCheckCount; i++) PVRTMatrixMultiplyF(pmOut[i], pmA[i], pmB[i]);
+	}
+	check->nsPerCall = CC3NsPerCall(CC3Now() - startTime);
+
+	delete [] pmA;
+	delete [] pmB;
+	delete [] pmOut;
+}
+
+/** Checks PVRTMat4::operator*. */
+static void CC3CheckMat4Multiply(CC3SimdCheck* check) {
+	PVRTMat4* pmA = new PVRTMat4[kCC3SimdCheckCount];
+	PVRTMat4* pmB = new PVRTMat4[kCC3SimdCheckCount];
+	PVRTMat4* pmOut = new PVRTMat4[kCC3SimdCheckCount];
+	float* pfOut = CC3AllocResults(check, "PVRTMat4::operator*", kCC3SimdCheckCount * 16);
+
+	for (int i = 0; i < kCC3SimdCheckCount; i++) {
+		for (int j = 0; j < 16; j++) pmA[i].f[j] = CC3RandomFloat();
+		for (int j = 0; j < 16; j++) pmB[i].f[j] = CC3RandomFloat();
+	}
+
+	for (int i = 0; i < kCC3SimdCheckCount; i++) {
+		pmOut[i] = pmA[i] * pmB[i];
+		memcpy(&pfOut[i * 16], pmOut[i].f, sizeof(pmOut[i].f));
+	}
+
+	double startTime = CC3Now();
+	for (int r = 0; r < kCC3SimdCheckTimingRepeats; r++) {
+		for (int i = 0; i < kCC3SimdCheckCount; i++) pmOut[i] = pmA[i] * pmB[i];
+	}
+	check->nsPerCall = CC3NsPerCall(CC3Now() - startTime);
+
+	delete [] pmA;
+	delete [] pmB;
+	delete [] pmOut;
+}
+
+/**
+ * Checks PVRTMatrixInverseF, including writing over its input. Every sixteenth input is
+ * singular, in which case the output must be left unchanged.
+ */
+static void CC3CheckMatrixInverse(CC3SimdCheck* check) {
+	PVRTMATRIXf* pmIn = new PVRTMATRIXf[kCC3SimdCheckCount];
+	PVRTMATRIXf* pmOut = new PVRTMATRIXf[kCC3SimdCheckCount];
+	float* pfOut = CC3AllocResults(check, "PVRTMatrixInverseF", kCC3SimdCheckCount * 16 * 2);
+
+	for (int i = 0; i < kCC3SimdCheckCount; i++) {
+		CC3RandomMatrix(pmIn[i], true);
+		if (i % 16 == 0) {
+			// The second row of the 3x3 part is a multiple of the first
+			for (int j = 0; j < 3; j++) pmIn[i].f[4 + j] = pmIn[i].f[j] * 2.0f;
+		}
+	}
+
+	for (int i = 0; i < kCC3SimdCheckCount; i++) {
+		PVRTMATRIXf mInPlace = pmIn[i];
+		CC3SentinelMatrix(pmOut[i]);
+		PVRTMatrixInverseF(pmOut[i], pmIn[i]);
+		PVRTMatrixInverseF(mInPlace, mInPlace);
+		memcpy(&pfOut[(i * 2 + 0) * 16], pmOut[i].f, sizeof(pmOut[i].f));
+		memcpy(&pfOut[(i * 2 + 1) * 16], mInPlace.f, sizeof(mInPlace.f));
+	}
+
+	double startTime = CC3Now();
+	for (int r = 0; r < kCC3SimdCheckTimingRepeats; r++) {
+		for (int i = 0; i < kCC3SimdCheckCount; i++) PVRTMatrixInverseF(pmOut[i], pmIn[i]);
+	}
+	check->nsPerCall = CC3NsPerCall(CC3Now() - startTime);
+
+	delete [] pmIn;
+	delete [] pmOut;
+}
+
+/** Checks PVRTMatrixRotationQuaternionF, with both unit and non-unit quaternions. */
+static void CC3CheckRotationQuaternion(CC3SimdCheck* check) {
+	PVRTQUATERNIONf* pqIn = new PVRTQUATERNIONf[kCC3SimdCheckCount];
+	PVRTMATRIXf* pmOut = new PVRTMATRIXf[kCC3SimdCheckCount];
+	float* pfOut = CC3AllocResults(check, "PVRTMatrixRotationQuaternionF", kCC3SimdCheckCount * 16);
+
+	for (int i = 0; i < kCC3SimdCheckCount; i++) {
+		pqIn[i].x = CC3RandomFloat();
+		pqIn[i].y = CC3RandomFloat();
+		pqIn[i].z = CC3RandomFloat();
+		pqIn[i].w = CC3RandomFloat();
+		if (i % 2) PVRTMatrixQuaternionNormalizeF(pqIn[i]);
+	}
+
+	for (int i = 0; i < kCC3SimdCheckCount; i++) {
+		CC3SentinelMatrix(pmOut[i]);
+		PVRTMatrixRotationQuaternionF(pmOut[i], pqIn[i]);
+		memcpy(&pfOut[i * 16], pmOut[i].f, sizeof(pmOut[i].f));
+	}
+
+	double startTime = CC3Now();
+	for (int r = 0; r < kCC3SimdCheckTimingRepeats; r++) {
+		for (int i = 0; i < kCC3SimdCheckCount; i++) PVRTMatrixRotationQuaternionF(pmOut[i], pqIn[i]);
+	}
+	check->nsPerCall = CC3NsPerCall(CC3Now() - startTime);
+
+	delete [] pqIn;
+	delete [] pmOut;
+}
+
+/** Checks PVRTTransformArray for positions and normals, including transforming in place. */
+static void CC3CheckTransformArray(CC3SimdCheck* check) {
+	PVRTVECTOR3* pvIn = new PVRTVECTOR3[kCC3SimdCheckCount];
+	PVRTVECTOR3* pvOut = new PVRTVECTOR3[kCC3SimdCheckCount];
+	PVRTMATRIX m;
+	float* pfOut = CC3AllocResults(check, "PVRTTransformArray", kCC3SimdCheckCount * 3 * 3);
+
+	CC3RandomMatrix(m, false);
+	for (int i = 0; i < kCC3SimdCheckCount; i++) {
+		pvIn[i].x = CC3RandomFloat();
+		pvIn[i].y = CC3RandomFloat();
+		pvIn[i].z = CC3RandomFloat();
+	}
+
+	PVRTTransformArray(pvOut, pvIn, kCC3SimdCheckCount, &m);
+	memcpy(&pfOut[kCC3SimdCheckCount * 3 * 0], pvOut, kCC3SimdCheckCount * sizeof(PVRTVECTOR3));
+	PVRTTransformArray(pvOut, pvIn, kCC3SimdCheckCount, &m, 0.0f);
+	memcpy(&pfOut[kCC3SimdCheckCount * 3 * 1], pvOut, kCC3SimdCheckCount * sizeof(PVRTVECTOR3));
+	memcpy(pvOut, pvIn, kCC3SimdCheckCount * sizeof(PVRTVECTOR3));
+	PVRTTransformArray(pvOut, pvOut, kCC3SimdCheckCount, &m);
+	memcpy(&pfOut[kCC3SimdCheckCount * 3 * 2], pvOut, kCC3SimdCheckCount * sizeof(PVRTVECTOR3));
+
+	double startTime = CC3Now();
+	for (int r = 0; r < kCC3SimdCheckTimingRepeats; r++) PVRTTransformArray(pvOut, pvIn, kCC3SimdCheckCount, &m);
+	check->nsPerCall = CC3NsPerCall(CC3Now() - startTime);
+
+	delete [] pvIn;
+	delete [] pvOut;
+}
+
+/** Checks PVRTTransformVec3Array, reading from and writing to interleaved arrays. */
+static void CC3CheckTransformVec3Array(CC3SimdCheck* check) {
+	const int inStride = sizeof(PVRTVECTOR3) + sizeof(float);
+	const int outStride = sizeof(PVRTVECTOR4) + sizeof(float);
+	char* pIn = (char*)calloc(kCC3SimdCheckCount, inStride);
+	char* pOut = (char*)calloc(kCC3SimdCheckCount, outStride);
+	PVRTMATRIX m;
+	float* pfOut = CC3AllocResults(check, "PVRTTransformVec3Array", kCC3SimdCheckCount * 4);
+
+	if ( !pIn || !pOut ) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	CC3RandomMatrix(m, false);
+	for (int i = 0; i < kCC3SimdCheckCount; i++) {
+		PVRTVECTOR3* pv = (PVRTVECTOR3*)(pIn + i * inStride);
+		pv->x = CC3RandomFloat();
+		pv->y = CC3RandomFloat();
+		pv->z = CC3RandomFloat();
+	}
+
+	PVRTTransformVec3Array((PVRTVECTOR4*)pOut, outStride, (PVRTVECTOR3*)pIn, inStride, &m, kCC3SimdCheckCount);
+	for (int i = 0; i < kCC3SimdCheckCount; i++) memcpy(&pfOut[i * 4], pOut + i * outStride, sizeof(PVRTVECTOR4));
+
+	double startTime = CC3Now();
+	for (int r = 0; r < kCC3SimdCheckTimingRepeats; r++) {
+		PVRTTransformVec3Array((PVRTVECTOR4*)pOut, outStride, (PVRTVECTOR3*)pIn, inStride, &m, kCC3SimdCheckCount);
+	}
+	check->nsPerCall = CC3NsPerCall(CC3Now() - startTime);
+
+	free(pIn);
+	free(pOut);
+}
+
+/**
+ * Checks PVRTBoundingBoxSoAIsVisible and PVRTBoundingBoxArrayIsVisible, on boxes scattered
+ * around a perspective camera so that some are inside, some outside and some straddle
+ * the frustum. Each visibility bit is recorded as a result of 0 or 1.
+ */
+static void CC3CheckBoundingBoxIsVisible(CC3SimdCheck* check) {
+	const int wordCount = (kCC3SimdCheckCount + 31) / 32;
+	float* pfSoA = (float*)malloc(kCC3SimdCheckCount * 6 * sizeof(float));
+	PVRTBOUNDINGBOX* pBoxes = new PVRTBOUNDINGBOX[kCC3SimdCheckCount];
+	PVRTuint32* pu32Visible = new PVRTuint32[wordCount];
+	PVRTBOUNDINGBOXSOA soa;
+	PVRTMATRIX mView, mProj, mViewProj;
+	float* pfOut = CC3AllocResults(check, "PVRTBoundingBox*IsVisible", kCC3SimdCheckCount * 2);
+
+	if ( !pfSoA ) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	PVRTVECTOR3 vEye = { 0.0f, 0.0f, 0.0f }, vAt = { 0.0f, 0.0f, -1.0f }, vUp = { 0.0f, 1.0f, 0.0f };
+	PVRTMatrixLookAtRH(mView, vEye, vAt, vUp);
+	PVRTMatrixPerspectiveFovRH(mProj, 1.0f, 1.5f, 1.0f, 50.0f);
+	PVRTMatrixMultiply(mViewProj, mView, mProj);
+
+	soa.pfCentreX = &pfSoA[kCC3SimdCheckCount * 0];
+	soa.pfCentreY = &pfSoA[kCC3SimdCheckCount * 1];
+	soa.pfCentreZ = &pfSoA[kCC3SimdCheckCount * 2];
+	soa.pfExtentX = &pfSoA[kCC3SimdCheckCount * 3];
+	soa.pfExtentY = &pfSoA[kCC3SimdCheckCount * 4];
+	soa.pfExtentZ = &pfSoA[kCC3SimdCheckCount * 5];
+	for (int i = 0; i < kCC3SimdCheckCount; i++) {
+		PVRTVECTOR3 avCorner[2];
+		for (int j = 0; j < 3; j++) {
+			float fCentre = CC3RandomFloat() * 10.0f;
+			float fExtent = fabsf(CC3RandomFloat());
+			(&avCorner[0].x)[j] = fCentre - fExtent;
+			(&avCorner[1].x)[j] = fCentre + fExtent;
+			pfSoA[kCC3SimdCheckCount * j + i] = fCentre;
+			pfSoA[kCC3SimdCheckCount * (j + 3) + i] = fExtent;
+		}
+		PVRTBoundingBoxCompute(&pBoxes[i], avCorner, 2);
+	}
+
+	PVRTBoundingBoxSoAIsVisible(pu32Visible, &soa, kCC3SimdCheckCount, &mViewProj);
+	for (int i = 0; i < kCC3SimdCheckCount; i++) pfOut[i] = (float)((pu32Visible[i >> 5] >> (i & 31)) & 1);
+	PVRTBoundingBoxArrayIsVisible(pu32Visible, pBoxes, kCC3SimdCheckCount, &mViewProj);
+	for (int i = 0; i < kCC3SimdCheckCount; i++) pfOut[kCC3SimdCheckCount + i] = (float)((pu32Visible[i >> 5] >> (i & 31)) & 1);
+
+	double startTime = CC3Now();
+	for (int r = 0; r < kCC3SimdCheckTimingRepeats; r++) {
+		PVRTBoundingBoxSoAIsVisible(pu32Visible, &soa, kCC3SimdCheckCount, &mViewProj);
+	}
+	check->nsPerCall = CC3NsPerCall(CC3Now() - startTime);
+
+	free(pfSoA);
+	delete [] pBoxes;
+	delete [] pu32Visible;
+}
+
+/** The checks, in the order their results are written. */
+static void (* const kCC3SimdChecks[])(CC3SimdCheck*) = {
+	CC3CheckMatrixMultiply,
+	CC3CheckMat4Multiply,
+	CC3CheckMatrixInverse,
+	CC3CheckRotationQuaternion,
+	CC3CheckTransformArray,
+	CC3CheckTransformVec3Array,
+	CC3CheckBoundingBoxIsVisible,
+};
+
+#define kCC3SimdCheckKindCount	(sizeof(kCC3SimdChecks) / sizeof(kCC3SimdChecks[0]))
+
+/** Writes the results of the specified checks to the specified file. Returns whether successful. */
+static bool CC3WriteResults(const CC3SimdCheck* checks, const char* path) {
+	FILE* file = fopen(path, "wb");
+	if ( !file ) return false;
+
+	bool isOK = true;
+	for (unsigned int i = 0; i < kCC3SimdCheckKindCount && isOK; i++) {
+		const CC3SimdCheck* check = &checks[i];
+		isOK = fwrite(&check->resultCount, sizeof(check->resultCount), 1, file) == 1
+			&& fwrite(check->results, sizeof(float), check->resultCount, file) == check->resultCount;
+	}
+	return (fclose(file) == 0) && isOK;
+}
+
+/**
+ * Compares the results of the specified checks against those in the specified file,
+ * printing the differences. Returns whether all differences are within the tolerance.
+ */
+static bool CC3CompareResults(const CC3SimdCheck* checks, const char* path, float tolerance) {
+	FILE* file = fopen(path, "rb");
+	if ( !file ) {
+		fprintf(stderr, "Could not open %s\n", path);
+		return false;
+	}
+
+	bool isOK = true;
+	for (unsigned int i = 0; i < kCC3SimdCheckKindCount; i++) {
+		const CC3SimdCheck* check = &checks[i];
+		unsigned int refCount = 0;
+		float* pfRef = (float*)malloc(check->resultCount * sizeof(float));
+		if ( !pfRef
+			|| fread(&refCount, sizeof(refCount), 1, file) != 1 || refCount != check->resultCount
+			|| fread(pfRef, sizeof(float), refCount, file) != refCount ) {
+			fprintf(stderr, "%s does not hold results for %s\n", path, check->name);
+			free(pfRef);
+			fclose(file);
+			return false;
+		}
+
+		unsigned int bitDiffCount = 0;
+		float maxDiff = 0.0f;
+		for (unsigned int j = 0; j < refCount; j++) {
+			float a = check->results[j], b = pfRef[j];
+			if (memcmp(&a, &b, sizeof(float)) == 0) continue;
+			bitDiffCount++;
+			float diff = fabsf(a - b) / PVRT_MAX(1.0f, PVRT_MAX(fabsf(a), fabsf(b)));
+			if (diff > maxDiff || diff != diff) maxDiff = diff;
+		}
+
+		bool isCheckOK = (maxDiff <= tolerance);
+		printf("%-30s %8u results  %6u differ  max diff %-10g %s\n",
+			   check->name, refCount, bitDiffCount, maxDiff, isCheckOK ? "" : "FAILED");
+		isOK = isOK && isCheckOK;
+		free(pfRef);
+	}
+	fclose(file);
+	return isOK;
+}
+
+static void CC3PrintUsage(void) {
+	fprintf(stderr, "Usage: CC3PVRSimdCheck [-write file | -compare file] [-tolerance t]\n");
+}
+
+int main(int argc, char* argv[]) {
+	const char* writePath = NULL;
+	const char* comparePath = NULL;
+	float tolerance = kCC3SimdCheckDefaultTolerance;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-write") == 0 && i + 1 < argc) {
+			writePath = argv[++i];
+		} else if (strcmp(argv[i], "-compare") == 0 && i + 1 < argc) {
+			comparePath = argv[++i];
+		} else if (strcmp(argv[i], "-tolerance") == 0 && i + 1 < argc) {
+			tolerance = (float)atof(argv[++i]);
+		} else {
+			CC3PrintUsage();
+			return 1;
+		}
+	}
+
+#ifdef PVRT_SIMD
+	printf("Built with SIMD code\n");
+#else
+	printf("Built with scalar code\n");
+#endif
+
+	CC3SimdCheck checks[kCC3SimdCheckKindCount];
+	memset(checks, 0, sizeof(checks));
+	for (unsigned int i = 0; i < kCC3SimdCheckKindCount; i++) {
+		kCC3SimdChecks[i](&checks[i]);
+		printf("%-30s %8.2f ns per call\n", checks[i].name, checks[i].nsPerCall);
+	}
+
+	int result = 0;
+	if (writePath && !CC3WriteResults(checks, writePath)) {
+		fprintf(stderr, "Could not write %s\n", writePath);
+		result = 1;
+	}
+	if (comparePath && !CC3CompareResults(checks, comparePath, tolerance)) result = 1;
+
+	for (unsigned int i = 0; i < kCC3SimdCheckKindCount; i++) free(checks[i].results);
+	return result;
+}
@@ -36,6 +36,44 @@
 
 #pragma mark CC3VertexArrayMesh extensions for PVR POD data
 
+/**
+ * If the specified array lies within the file loaded by the specified model, replaces it
+ * with a copy of the specified number of bytes. Returns NO if the copy cannot be allocated.
+ */
+static BOOL CC3CopyMappedPODArray(CPVRTModelPOD* pod, PVRTuint8** pArray, size_t byteCount) {
+	if ( !pod->IsMappedData(*pArray) ) return YES;
+	PVRTuint8* copy = (PVRTuint8*)malloc(MAX(byteCount, 1));
+	if ( !copy ) return NO;
+	memcpy(copy, *pArray, byteCount);
+	*pArray = copy;
+	return YES;
+}
+
+/**
+ * Replaces each vertex and index array of the specified mesh that lies within the file
+ * loaded by the specified model, as all arrays of a cooked POD file do, with a copy.
+ * The vertex arrays built from the mesh take over its arrays and free them later, and
+ * can only do so with arrays that were allocated on their own.
+ */
+static BOOL CC3CopyMappedSPODMeshData(CPVRTModelPOD* pod, SPODMesh* psm) {
+	if (psm->sFaces.n) {
+		size_t faceBytes = PVRTModelPODCountIndices(*psm) * PVRTModelPODDataStride(psm->sFaces);
+		if ( !CC3CopyMappedPODArray(pod, &psm->sFaces.pData, faceBytes) ) return NO;
+	}
+	if (psm->pInterleaved) {
+		return CC3CopyMappedPODArray(pod, &psm->pInterleaved, psm->nNumVertex * psm->sVertex.nStride);
+	}
+	CPODData* vtxData[] = { &psm->sVertex, &psm->sNormals, &psm->sTangents, &psm->sBinormals,
+							&psm->sVtxColours, &psm->sBoneIdx, &psm->sBoneWeight };
+	for (uint i = 0; i < sizeof(vtxData) / sizeof(vtxData[0]); i++) {
+		if ( !CC3CopyMappedPODArray(pod, &vtxData[i]->pData, psm->nNumVertex * vtxData[i]->nStride) ) return NO;
+	}
+	for (uint i = 0; i < psm->nNumUVW; i++) {
+		if ( !CC3CopyMappedPODArray(pod, &psm->psUVW[i].pData, psm->nNumVertex * psm->psUVW[i].nStride) ) return NO;
+	}
+	return YES;
+}
+
 @implementation CC3VertexArrayMesh (PVRPOD)
 
 -(id) initAtIndex: (int) aPODIndex fromPODResource: (CC3PODResource*) aPODRez {
@@ -43,6 +81,15 @@
 		SPODMesh* psm = (SPODMesh*)[aPODRez meshPODStructAtIndex: aPODIndex];
 		LogCleanRez(@"Creating %@ at index %i from: %@", [self class], aPODIndex, NSStringFromSPODMesh(psm));
 		
+		// Arrays within a cooked file belong to the file, so the vertex arrays are given copies.
+		CPVRTModelPOD* pod = (CPVRTModelPOD*)aPODRez.pvrtModel;
+		PVRTuint8* podInterleaved = psm->pInterleaved;
+		if ( !CC3CopyMappedSPODMeshData(pod, psm) ) {
+			LogError(@"%@ could not copy the vertex data of mesh %i of %@", self, aPODIndex, aPODRez);
+			[self release];
+			return nil;
+		}
+
 		self.vertexLocations = [CC3VertexLocations arrayFromSPODMesh: psm];
 		
 		self.vertexNormals = [CC3VertexNormals arrayFromSPODMesh: psm];
@@ -67,10 +114,11 @@
 		// CPVRTModelPOD that the data is contained within the individual vertex arrays, and
 		// it will try to free those instead. So, we create a "dummy" memory allocation for
 		// CPVRTModelPOD to free when it needs to. The original pointer is now being managed
-		// by the CC3VertexLocations instance.
+		// by the CC3VertexLocations instance. A cooked model never frees the arrays of its
+		// meshes, so the SPODMesh can simply point at its original data again instead.
 		if (psm->pInterleaved != NULL) {
 			shouldInterleaveVertices = YES;
-			psm->pInterleaved = (unsigned char*)calloc(1, sizeof(GLint));
+			psm->pInterleaved = pod->IsMappedData(psm) ? podInterleaved : (unsigned char*)calloc(1, sizeof(GLint));
 		}
 		
 	}
@@ -61,6 +61,11 @@
  * The array of nodes accessible via the nodes property are the root nodes of a hierarchical
  * structure of nodes. The loading step takes care of assembling this structural assembly.
  *
+ * If a cooked .cpod file, written by the CC3PODCooker tool, sits beside the POD file with the
+ * same name, the cooked file is loaded instead, which avoids parsing and converting the POD
+ * file at runtime. If the cooked file cannot be loaded, perhaps because it was cooked for a
+ * different kind of device, the POD file is loaded as usual.
+ *
  * If this resource contains soft-body components such as skinned meshes, the corresponding
  * skinned mesh nodes and skeleton bone nodes are collected together and wrapped in a single
  * soft body node that appears in the nodes array.
@@ -99,6 +104,7 @@
 	CCArray* materials;
 	CCArray* textures;
 	ccTexParams textureParameters;
+	GLuint* boneNodeBits;
 }
 
 /**
@@ -247,6 +253,11 @@
 /**
  * Returns whether the specified node index represents a bone node that is part
  * of a skeleton node assembly that will be used to control vertex skinning.
+ *
+ * A node is a bone node if it is referenced by a bone batch of any mesh, or if it
+ * is an ancestor of such a node. On the first invocation, this method marks all such
+ * nodes in a bitmap, in a single upward sweep from the bones of all bone batches.
+ * Subsequent invocations simply look up the node in that bitmap.
  */
 -(BOOL) isBoneNode: (uint) nodeIndex;
 
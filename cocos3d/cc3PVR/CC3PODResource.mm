@@ -68,6 +68,7 @@ static const id placeHolder = [NSObject new];
 	[meshes release];
 	[materials release];
 	[textures release];
+	free(boneNodeBits);
 	if (self.pvrtModelImpl) delete (CPVRTModelPOD*)self.pvrtModelImpl;
 	pvrtModel = NULL;
 	[super dealloc];
@@ -91,8 +92,28 @@ static const id placeHolder = [NSObject new];
 }
 
 -(BOOL) processFile: (NSString*) anAbsoluteFilePath {
+	// A cooked file beside the POD file holds the scene ready to use, and meshes already split.
+	// It is only used if it was cooked from the POD file as it is now.
+	NSString* cookedFilePath = [[anAbsoluteFilePath stringByDeletingPathExtension] stringByAppendingPathExtension: @"cpod"];
+	if ([[NSFileManager defaultManager] fileExistsAtPath: cookedFilePath]) {
+		wasLoaded = (self.pvrtModelImpl->ReadFromFileCooked([cookedFilePath cStringUsingEncoding:NSUTF8StringEncoding],
+															[anAbsoluteFilePath cStringUsingEncoding:NSUTF8StringEncoding]) == PVR_SUCCESS);
+		if (wasLoaded) {
+			LogCleanRez(@"%@ loaded cooked file %@", self, cookedFilePath);
+			[self build];
+			return wasLoaded;
+		}
+		LogError(@"%@ could not load cooked file %@, or it is out of date, and is loading %@ instead", self, cookedFilePath, anAbsoluteFilePath);
+	}
+
 	wasLoaded = (self.pvrtModelImpl->ReadFromFile([anAbsoluteFilePath cStringUsingEncoding:NSUTF8StringEncoding]) == PVR_SUCCESS);
-	if (wasLoaded) [self build];
+	if (wasLoaded) {
+		// OpenGL ES 1.1 can only draw 16-bit indices, so split any mesh too large for them.
+		if (self.pvrtModelImpl->SplitMeshes() != PVR_SUCCESS) {
+			LogError(@"%@ could not split all meshes of %@ for 16-bit indices", self, anAbsoluteFilePath);
+		}
+		[self build];
+	}
 	return wasLoaded;
 }
 
@@ -188,7 +209,17 @@ static const id placeHolder = [NSObject new];
 	return [self isNodeIndex: aNodeIndex ancestorOfNodeIndex: parentIndex];
 }
 
--(BOOL) isBoneNode: (uint) aNodeIndex {
+/**
+ * Marks each node that is a bone in a bone batch of any mesh, and all the ancestors of
+ * those nodes, in the boneNodeBits bitmap. The walk up from each bone stops as soon as
+ * it reaches a node that is already marked, because all of its ancestors are marked too.
+ * As a result, each node is visited at most once, regardless of the number of bones.
+ */
+-(void) buildBoneNodeBits {
+	uint nCount = self.nodeCount;
+	boneNodeBits = (GLuint*)calloc((nCount + 31) / 32 + 1, sizeof(GLuint));
+	if ( !boneNodeBits ) return;
+
 	uint mCount = self.meshCount;
 	// Cycle through the meshes
 	for (uint mi = 0; mi < mCount; mi++) {
@@ -200,16 +231,26 @@ static const id placeHolder = [NSObject new];
 			int boneCount = pbb->pnBatchBoneCnt[batchIndex];
 			int* boneNodeIndices = &(pbb->pnBatches[batchIndex * pbb->nBatchBoneMax]);
 
-			// Cycle through the bones of each batch. If the bone node is a child of
-			// the specified node, then the specified node is a bone as well.
+			// Cycle through the bones of each batch, marking the bone node and
+			// each of its ancestors that has not already been marked.
 			for (int boneIndex = 0; boneIndex < boneCount; boneIndex++) {
-				if ( [self isNodeIndex: aNodeIndex ancestorOfNodeIndex: boneNodeIndices[boneIndex]] ) {
-					return YES;
+				int nodeIndex = boneNodeIndices[boneIndex];
+				while (nodeIndex >= 0 && (uint)nodeIndex < nCount) {
+					GLuint mask = 1U << (nodeIndex & 31);
+					GLuint* word = &boneNodeBits[nodeIndex >> 5];
+					if (*word & mask) break;
+					*word |= mask;
+					nodeIndex = ((SPODNode*)[self nodePODStructAtIndex: nodeIndex])->nIdxParent;
 				}
 			}
 		}
 	}
-	return NO;
+}
+
+-(BOOL) isBoneNode: (uint) aNodeIndex {
+	if ( !boneNodeBits ) [self buildBoneNodeBits];
+	if ( !boneNodeBits || aNodeIndex >= self.nodeCount ) return NO;
+	return (boneNodeBits[aNodeIndex >> 5] & (1U << (aNodeIndex & 31))) != 0;
 }
 
 -(void) buildSoftBodyNode {
@@ -21,7 +21,6 @@
 #include "PVRTContext.h"
 
 #include <vector>
-#include <list>
 
 #include "PVRTMatrix.h"
 #include "PVRTVertex.h"
@@ -30,6 +29,8 @@
 /****************************************************************************
 ** Defines
 ****************************************************************************/
+/* Most bones a triangle can reference: 3 vertices of up to 4 bones each */
+#define PVRT_MAX_TRI_BONES	(12)
 
 /****************************************************************************
 ** Macros
@@ -45,9 +46,11 @@
 class CBatch
 {
 protected:
-	int	m_nCapacity, 		// Maximum size of the batch
-	m_nCnt, 				// Number of elements currently contained in the batch
-	*m_pnPalette;			// Array of palette indices
+	int			m_nCapacity, 	// Maximum size of the batch
+				m_nCnt, 		// Number of elements currently contained in the batch
+				*m_pnPalette;	// Array of palette indices
+	PVRTuint32	*m_pu32Bits;	// Bitset of the palette indices
+	int			m_nBoneNum;		// Number of bone indices the bitset covers
 
 public:
 /*!***************************************************************************
@@ -56,21 +59,10 @@ public:
 *****************************************************************************/
 	CBatch()
 	{
-		m_pnPalette = NULL;
+		m_pnPalette	= NULL;
+		m_pu32Bits	= NULL;
 	}
 
-/*!***************************************************************************
- @Function		CBatch
- @Input			src				CBatch to copy
- @Description	Copy constructor
-*****************************************************************************/
-	CBatch(const CBatch &src)
-	{
-		m_pnPalette = NULL;
-		SetSize(src.m_nCapacity);
-		*this = src;
-	}
-	
 /*!***************************************************************************
  @Function		~CBatch
  @Description	Destructor
@@ -78,69 +70,53 @@ public:
 	~CBatch()
 	{
 		FREE(m_pnPalette);
+		FREE(m_pu32Bits);
 	}
-	
-/*!***************************************************************************
- @Function		operator=
- @Description	Operator overload for the '=' operand
-*****************************************************************************/
-	void operator= (const CBatch &src)
-	{
-		_ASSERT(m_nCapacity == src.m_nCapacity);
-		m_nCnt = src.m_nCnt;
-		memcpy(m_pnPalette, src.m_pnPalette, m_nCnt * sizeof(*m_pnPalette));
-	}
-	
+
 /*!***************************************************************************
  @Function		SetSize
  @Input			nSize			The new size of the batch
+ @Input			nBoneNum		One more than the largest bone index
+ @Return		bool			false if out of memory
  @Description	Delete all current information and resizes the batch 
 				to the value that has been passed in.
 *****************************************************************************/
-	void SetSize(const int nSize)
+	bool SetSize(const int nSize, const int nBoneNum)
 	{
 		FREE(m_pnPalette);
+		FREE(m_pu32Bits);
 
 		m_nCapacity	= nSize;
 		m_nCnt		= 0;
-		m_pnPalette		= (int*)malloc(m_nCapacity * sizeof(*m_pnPalette));
-	}
-	
-/*!***************************************************************************
- @Function		Clear
- @Description	Resets the count
-*****************************************************************************/
-	void Clear()
-	{
-		m_nCnt = 0;
+		m_nBoneNum	= nBoneNum;
+		m_pnPalette	= (int*)malloc(m_nCapacity * sizeof(*m_pnPalette));
+		m_pu32Bits	= (PVRTuint32*)calloc((nBoneNum + 31) / 32 + 1, sizeof(*m_pu32Bits));
+
+		return m_pnPalette && m_pu32Bits;
 	}
 
 /*!***************************************************************************
- @Function		Clear
+ @Function		Add
  @Input			n			The index of the new item
- Return			bool		Returns true if the item already exists or has been added.
+ @Return		bool		Returns true if the item already exists or has been added.
  @Description	Adds a new item to the batch, providing it has not already
 				been added to the batch and the count doesn't exceed the
 				maximum number of bones the batch can hold.
 *****************************************************************************/
 	bool Add(const int n)
 	{
-		int i;
-
-		if(n < 0)
+		if(n < 0 || n >= m_nBoneNum)
 			return false;
 
 		// If we already have this item, do nothing
-		for(i = 0; i < m_nCnt; ++i)
-		{
-			if(m_pnPalette[i] == n)
-				return true;
-		}
+		if(Contains(n))
+			return true;
 
 		// Add the new item
 		if(m_nCnt < m_nCapacity)
 		{
 			m_pnPalette[m_nCnt] = n;
+			m_pu32Bits[n >> 5] |= 1u << (n & 31);
 			++m_nCnt;
 			return true;
 		}
@@ -151,76 +127,59 @@ public:
 	}
 
 /*!***************************************************************************
- @Function		Merge
- @Input			src				The batch to merge with
- @Description	Merges the input batch with the current batch.
+ @Function		CountMissing
+ @Input			pn				Array of items
+ @Input			nCnt			Number of items in pn
+ @Input			nLimit			Counting stops once this many are found
+ @Return		int				The number of items of pn not in the batch,
+								at most nLimit
+ @Description	Counts how many items would be added by merging pn into
+				the batch.
 *****************************************************************************/
-	void Merge(const CBatch &src)
+	int CountMissing(
+		const int * const pn,
+		const int nCnt,
+		const int nLimit) const
 	{
-		int i;
+		int i, nMissing;
+
+		nMissing = 0;
+		for(i = 0; i < nCnt && nMissing < nLimit; ++i)
+			if(!Contains(pn[i]))
+				++nMissing;
 
-		for(i = 0; i < src.m_nCnt; ++i)
-			Add(src.m_pnPalette[i]);
+		return nMissing;
 	}
 
 /*!***************************************************************************
- @Function		TestMerge
- @Input			src				The batch to merge with
- @Return		int				The number of items that are not already
-								present in the batch. -1 if the merge will
-								exceed the capacity of the batch
- @Description	Tests how many of the items of the input batch are not
-				already contained in the batch. This returns the number of
-				items that would need to be added, or -1 if the number
-				of additional items would exceed the capacity of the batch.
+ @Function		Contains
+ @Input			n				The index of the item
+ @Return		bool			Returns true if the batch contains the item
+ @Description	Returns true if the batch contains the item.
 *****************************************************************************/
-	int TestMerge(const CBatch &src)
+	bool Contains(const int n) const
 	{
-		int i, nCnt;
-
-		nCnt = 0;
-		for(i = 0; i < src.m_nCnt; ++i)
-			if(!Contains(src.m_pnPalette[i]))
-				++nCnt;
-
-		return m_nCnt+nCnt > m_nCapacity ? -1 : nCnt;
+		return n >= 0 && n < m_nBoneNum && (m_pu32Bits[n >> 5] & (1u << (n & 31)));
 	}
 
 /*!***************************************************************************
- @Function		Contains
- @Input			src				The batch to compare
- @Return		bool			Returns true if the batch and the input batch
-								have at least one item in common
- @Description	Returns true if the batch's have at least one item in common
+ @Function		Count
+ @Return		int				Number of items in the batch
 *****************************************************************************/
-	bool Contains(const CBatch &batch) const
+	int Count() const
 	{
-		int i;
-
-		for(i = 0; i < batch.m_nCnt; ++i)
-			if(!Contains(batch.m_pnPalette[i]))
-				return false;
-
-		return true;
+		return m_nCnt;
 	}
-	
+
 /*!***************************************************************************
- @Function		Contains
- @Input			n				The index of the new item
- @Return		bool			Returns true if the batch contains the item
- @Description	Returns true if the batch contains the item.
+ @Function		Palette
+ @Return		const int*		The items in the batch, in the order added
 *****************************************************************************/
-	bool Contains(const int n) const
+	const int *Palette() const
 	{
-		int i;
-
-		for(i = 0; i < m_nCnt; ++i)
-			if(m_pnPalette[i] == n)
-				return true;
-
-		return false;
+		return m_pnPalette;
 	}
-	
+
 /*!***************************************************************************
  @Function		Write
  @Output		pn				The array of items to overwrite
@@ -277,6 +236,17 @@ public:
 	}
 };
 
+/*!***************************************************************************
+@Struct SBoneSet
+@Brief A distinct set of bones used by one or more triangles
+*****************************************************************************/
+struct SBoneSet
+{
+	int	nTri;		// First triangle using this set; its bones are in the per-triangle bone array
+	int	nBoneCnt;	// Number of bones in the set
+	int	nBatch;		// Batch the set was placed in
+};
+
 /*!***************************************************************************
 @Class CGrowableArray
 @Brief Class that provides an array structure that can change its size dynamically.
@@ -287,6 +257,7 @@ protected:
 	char	*m_p;
 	int		m_nSize;
 	int		m_nCnt;
+	int		m_nCapacity;
 
 public:
 /*!***************************************************************************
@@ -298,9 +269,10 @@ public:
 *****************************************************************************/
 	CGrowableArray(const int nSize)
 	{
-		m_p		= NULL;
-		m_nSize	= nSize;
-		m_nCnt	= 0;
+		m_p			= NULL;
+		m_nSize		= nSize;
+		m_nCnt		= 0;
+		m_nCapacity	= 0;
 	}
 	
 /*!***************************************************************************
@@ -316,12 +288,17 @@ public:
  @Function		Append
  @Input			pData			The data to append
  @Input			nCnt			The amount of data elements to append
- @Description	Resizes the array and appends the new data that has been passed in.
+ @Description	Appends the new data that has been passed in, doubling the
+				size of the array whenever it runs out of space.
 *****************************************************************************/
 	void Append(const void * const pData, const int nCnt)
 	{
-		m_p = (char*)realloc(m_p, (m_nCnt + nCnt) * m_nSize);
-		_ASSERT(m_p);
+		if(m_nCnt + nCnt > m_nCapacity)
+		{
+			m_nCapacity = PVRT_MAX(m_nCnt + nCnt, m_nCapacity * 2);
+			m_p = (char*)realloc(m_p, m_nCapacity * m_nSize);
+			_ASSERT(m_p);
+		}
 
 		memcpy(&m_p[m_nCnt * m_nSize], pData, nCnt * m_nSize);
 		m_nCnt += nCnt;
@@ -362,19 +339,21 @@ public:
  @Function		Surrender
  @Output		pData			The pointer to surrender the data to
  @Description	Assigns the memory address of the data to the pointer that has
-				been passed in. Sets the class's number of elements and 
-				data pointer back to their default values.
+				been passed in, trimmed to the number of elements. Sets the
+				class's number of elements and data pointer back to their
+				default values.
 *****************************************************************************/
 	int Surrender(
 		char ** const pData)
 	{
 		int nCnt;
 
-		*pData = m_p;
+		*pData = m_nCnt ? (char*)realloc(m_p, m_nCnt * m_nSize) : m_p;
 		nCnt = m_nCnt;
 
-		m_p		= NULL;
-		m_nCnt	= 0;
+		m_p			= NULL;
+		m_nCnt		= 0;
+		m_nCapacity	= 0;
 
 		return nCnt;
 	}
@@ -387,9 +366,10 @@ public:
 /****************************************************************************
 ** Local function definitions
 ****************************************************************************/
-static bool FillBatch(
-	CBatch					&batch,
-	const unsigned int	* const pui32Idx,	// input AND output; index array for triangle list
+static bool ReadTriangleBones(
+	int						* const pnBones,	// Output: sorted bone indices used by the triangle
+	int						&nBoneCnt,		// Output: number of bone indices
+	const unsigned int	* const pui32Idx,	// Index array for the triangle
 	const char				* const pVtx,	// Input vertices
 	const int				nStride,		// Size of a vertex (in bytes)
 	const int				nOffsetWeight,	// Offset in bytes to the vertex bone-weights
@@ -398,10 +378,29 @@ static bool FillBatch(
 	EPVRTDataType			eTypeIdx,		// Data type of the vertex bone-indices
 	const int				nVertexBones);	// Number of bones affecting each vertex
 
+static unsigned int HashBones(
+	const int * const pnBones,
+	const int nBoneCnt);
+
 static bool BonesMatch(
 	const float * const pfIdx0,
 	const float * const pfIdx1);
 
+static bool BonesContain(
+	const int * const pnBones,
+	const int nBoneCnt,
+	const int * const pnSub,
+	const int nSubCnt);
+
+static bool BatchSetsInOrder(
+	std::vector<CBatch*>	&vpBatch,		// Output: the batches
+	int						* const pnSetBatch,	// Output: batch of each set
+	const SBoneSet			* const psSet,	// Distinct bone sets, in order of first use
+	const int				nSetCnt,		// Number of bone sets
+	const int				* const pnTriBones,	// Sorted bone indices of each triangle
+	const int				nBatchBoneMax,	// Number of bones a batch can reference
+	const int				nBoneNum);		// One more than the largest bone index
+
 /*****************************************************************************
 ** Functions
 *****************************************************************************/
@@ -439,18 +438,31 @@ EPVRTError CPVRTBoneBatches::Create(
 	const int			nBatchBoneMax,
 	const int			nVertexBones)
 {
-	int							i, j, k, nTriCnt;
-	CBatch						batch;
-	std::list<CBatch>			lBatch;
-	std::list<CBatch>::iterator	iBatch, iBatch2;
-	CBatch						**ppBatch;
+	int							i, j, k, n, nTriCnt, nBoneNum;
+	int							*pnTriBones;	// Sorted bone indices of each triangle, PVRT_MAX_TRI_BONES per triangle
+	int							*pnTriBoneCnt;	// Number of bone indices of each triangle
+	int							*pnTriSet;		// Bone set of each triangle
+	SBoneSet					*psSet;			// Distinct bone sets
+	int							nSetCnt;
+	int							*pnHash;		// Open addressing hash of bone sets
+	unsigned int				ui32HashMask;
+	int							*pnOrder;		// Bone sets not yet placed in a batch, largest first
+	int							nRemain, nBest, nBestCost, nCost;
+	int							*pnBatchTri;	// Triangles sorted by batch
+	int							*pnBatchTriOffset;
+	std::vector<CBatch*>		vpBatch;
+	std::vector<CBatch*>		vpInOrder;		// Batches built the original way
+	int							*pnInOrder;		// Batch of each set in vpInOrder
+	CBatch						*pBatch;
 	unsigned int				*pui32IdxNew;
-	const char					*pV, *pV2;
+	const char					*pV;
 	PVRTVECTOR4					vWeight, vIdx;
-	PVRTVECTOR4					vWeight2, vIdx2;
-	std::vector<int>			*pvDup;
+	int							*pnCopyFirst;	// First output copy of each input vertex, or -1
+	std::vector<int>			vnCopyNext;		// Next output copy of the same input vertex, per output vertex
+	std::vector<PVRTVECTOR4>	vCopyIdx;		// Bone indices written to each output vertex
 	CGrowableArray				*pVtxBuf;
 	unsigned int				ui32SrcIdx;
+	EPVRTError					eRet;
 
 	memset(this, 0, sizeof(*this));
 
@@ -461,126 +473,219 @@ EPVRTError CPVRTBoneBatches::Create(
 	}
 
 	memset(&vWeight, 0, sizeof(vWeight));
-	memset(&vWeight2, 0, sizeof(vWeight2));
 	memset(&vIdx, 0, sizeof(vIdx));
-	memset(&vIdx2, 0, sizeof(vIdx2));
 
-	batch.SetSize(nBatchBoneMax);
+	eRet		= PVR_FAIL;
+	pnOrder		= NULL;
+	pnInOrder	= NULL;
+	pnHash		= NULL;
+	pnBatchTri	= NULL;
+	pnBatchTriOffset = NULL;
+	pnCopyFirst	= NULL;
+	pVtxBuf		= NULL;
 
 	// Allocate some working space
-	ppBatch		= (CBatch**)malloc(nTriNum * sizeof(*ppBatch));
-	pui32IdxNew	= (unsigned int*)malloc(nTriNum * 3 * sizeof(*pui32IdxNew));
-	pvDup		= new std::vector<int>[nVtxNum];
-	pVtxBuf		= new CGrowableArray(nStride);
+	ui32HashMask = 15;
+	while(ui32HashMask < (unsigned int) nTriNum * 2)
+		ui32HashMask = ui32HashMask * 2 + 1;
+
+	pnTriBones		= (int*)malloc(nTriNum * PVRT_MAX_TRI_BONES * sizeof(*pnTriBones));
+	pnTriBoneCnt	= (int*)malloc(nTriNum * sizeof(*pnTriBoneCnt));
+	pnTriSet		= (int*)malloc(nTriNum * sizeof(*pnTriSet));
+	psSet			= (SBoneSet*)malloc(nTriNum * sizeof(*psSet));
+	pnHash			= (int*)malloc((ui32HashMask + 1) * sizeof(*pnHash));
+	pui32IdxNew		= (unsigned int*)malloc(nTriNum * 3 * sizeof(*pui32IdxNew));
+
+	if(!pnHash || (nTriNum && (!pnTriBones || !pnTriBoneCnt || !pnTriSet || !psSet || !pui32IdxNew)))
+		goto fail;
+
+	// Read the bones used by each triangle
+	nBoneNum = 0;
+	for(i = 0; i < nTriNum; ++i)
+	{
+		if(!ReadTriangleBones(&pnTriBones[i * PVRT_MAX_TRI_BONES], pnTriBoneCnt[i], &pui32Idx[i * 3], pVtx, nStride, nOffsetWeight, eTypeWeight, nOffsetIdx, eTypeIdx, nVertexBones)
+			|| pnTriBoneCnt[i] > nBatchBoneMax)
+		{
+			_RPT0(_CRT_WARN, "CPVRTBoneBatching() found a triangle that cannot fit in a batch.\n");
+			goto fail;
+		}
+
+		if(pnTriBoneCnt[i])
+			nBoneNum = PVRT_MAX(nBoneNum, pnTriBones[i * PVRT_MAX_TRI_BONES + pnTriBoneCnt[i] - 1] + 1);
+	}
+
+	// Find the distinct bone sets
+	memset(pnHash, 0xFF, (ui32HashMask + 1) * sizeof(*pnHash));
+	nSetCnt = 0;
 
-	// Check what batches are necessary
 	for(i = 0; i < nTriNum; ++i)
 	{
-		// Build the batch
-		if(!FillBatch(batch, &pui32Idx[i * 3], pVtx, nStride, nOffsetWeight, eTypeWeight, nOffsetIdx, eTypeIdx, nVertexBones))
-			return PVR_FAIL;
+		const int *pnBones = &pnTriBones[i * PVRT_MAX_TRI_BONES];
+		unsigned int ui32Slot = HashBones(pnBones, pnTriBoneCnt[i]) & ui32HashMask;
 
-		// Update the batch list
-		for(iBatch = lBatch.begin(); iBatch != lBatch.end(); ++iBatch)
+		for(;;)
 		{
-			// Do nothing if an existing batch is a superset of this new batch
-			if(iBatch->Contains(batch))
+			n = pnHash[ui32Slot];
+
+			if(n < 0)
 			{
+				// New set
+				n = nSetCnt++;
+				psSet[n].nTri		= i;
+				psSet[n].nBoneCnt	= pnTriBoneCnt[i];
+				psSet[n].nBatch		= -1;
+				pnHash[ui32Slot]	= n;
 				break;
 			}
 
-			// If this new batch is a superset of an existing batch, replace the old with the new
-			if(batch.Contains(*iBatch))
+			if(psSet[n].nBoneCnt == pnTriBoneCnt[i] &&
+				memcmp(&pnTriBones[psSet[n].nTri * PVRT_MAX_TRI_BONES], pnBones, pnTriBoneCnt[i] * sizeof(*pnBones)) == 0)
 			{
-				*iBatch = batch;
 				break;
 			}
-		}
 
-		// If no suitable batch exists, create a new one
-		if(iBatch == lBatch.end())
-		{
-			lBatch.push_back(batch);
+			ui32Slot = (ui32Slot + 1) & ui32HashMask;
 		}
+
+		pnTriSet[i] = n;
 	}
 
-	//	Group batches into fewer batches. This simple greedy algorithm could be improved.
-		int							nCurrent, nShortest;
-		std::list<CBatch>::iterator	iShortest;
+	FREE(pnHash);
+
+	// Order the sets largest first, otherwise in order of first use
+	pnOrder = (int*)malloc((nSetCnt + 1) * sizeof(*pnOrder));
+	if(!pnOrder)
+		goto fail;
+
+	for(n = PVRT_MAX_TRI_BONES, k = 0; n >= 0; --n)
+		for(i = 0; i < nSetCnt; ++i)
+			if(psSet[i].nBoneCnt == n)
+				pnOrder[k++] = i;
+
+	/*
+		Build the batches. Each batch starts with the largest set not yet
+		placed, then repeatedly takes every remaining set it already covers
+		and the set that adds the fewest new bones, until no remaining set
+		fits.
+	*/
+	nRemain = nSetCnt;
+	while(nRemain)
+	{
+		pBatch = new CBatch;
+		vpBatch.push_back(pBatch);
+		if(!pBatch->SetSize(nBatchBoneMax, nBoneNum))
+			goto fail;
 
-		for(iBatch = lBatch.begin(); iBatch != lBatch.end(); ++iBatch)
+		nBest = 0;
+		do
 		{
-			for(;;)
+			// Add the chosen set to the batch
+			n = pnOrder[nBest];
+			for(i = 0; i < psSet[n].nBoneCnt; ++i)
 			{
-				nShortest	= nBatchBoneMax;
-				iBatch2		= iBatch;
-				++iBatch2;
-				for(; iBatch2 != lBatch.end(); ++iBatch2)
-				{
-					nCurrent = iBatch->TestMerge(*iBatch2);
+				bool bOk = pBatch->Add(pnTriBones[psSet[n].nTri * PVRT_MAX_TRI_BONES + i]);
+				_ASSERT(bOk);
+				PVRT_UNREFERENCED_PARAMETER(bOk);
+			}
+			psSet[n].nBatch = (int) vpBatch.size() - 1;
+			pnOrder[nBest] = -1;
 
-					if(nCurrent >= 0 && nCurrent < nShortest)
-					{
-						nShortest	= nCurrent;
-						iShortest	= iBatch2;
-					}
-				}
+			// Scan the remaining sets, compacting the list as we go
+			nBest		= -1;
+			nBestCost	= nBatchBoneMax - pBatch->Count() + 1;
+
+			for(i = 0, j = 0; i < nRemain; ++i)
+			{
+				n = pnOrder[i];
+				if(n < 0)
+					continue;
+
+				nCost = pBatch->CountMissing(&pnTriBones[psSet[n].nTri * PVRT_MAX_TRI_BONES], psSet[n].nBoneCnt, nBestCost);
 
-				if(nShortest < nBatchBoneMax)
+				if(nCost == 0)
 				{
-					iBatch->Merge(*iShortest);
-					lBatch.erase(iShortest);
+					psSet[n].nBatch = (int) vpBatch.size() - 1;
+					continue;
 				}
-				else
+
+				if(nCost < nBestCost)
 				{
-					break;
+					nBestCost	= nCost;
+					nBest		= j;
 				}
+
+				pnOrder[j++] = n;
 			}
-		}
 
-	// Place each triangle in a batch.
-	for(i = 0; i < nTriNum; ++i)
-	{
-		if(!FillBatch(batch, &pui32Idx[i * 3], pVtx, nStride, nOffsetWeight, eTypeWeight, nOffsetIdx, eTypeIdx, nVertexBones))
-			return PVR_FAIL;
+			nRemain = j;
+		} while(nBest >= 0);
+	}
 
-		for(iBatch = lBatch.begin(); iBatch != lBatch.end(); ++iBatch)
-		{
-			if(iBatch->Contains(batch))
-			{
-				ppBatch[i] = &*iBatch;
-				break;
-			}
-		}
+	/*
+		Growing from the largest set usually needs fewer batches than the
+		original first-use order, but not always, so batch the sets that
+		way too and keep whichever needs fewer.
+	*/
+	pnInOrder = (int*)malloc((nSetCnt + 1) * sizeof(*pnInOrder));
+	if(!pnInOrder || !BatchSetsInOrder(vpInOrder, pnInOrder, psSet, nSetCnt, pnTriBones, nBatchBoneMax, nBoneNum))
+		goto fail;
 
-		_ASSERT(iBatch != lBatch.end());
+	if(vpInOrder.size() < vpBatch.size())
+	{
+		vpBatch.swap(vpInOrder);
+		for(i = 0; i < nSetCnt; ++i)
+			psSet[i].nBatch = pnInOrder[i];
 	}
 
+	// Sort the triangles by batch, keeping their order within each batch
+	nBatchCnt			= (int) vpBatch.size();
+	pnBatchTri			= (int*)malloc((nTriNum + 1) * sizeof(*pnBatchTri));
+	pnBatchTriOffset	= (int*)calloc(nBatchCnt + 1, sizeof(*pnBatchTriOffset));
+	if(!pnBatchTri || !pnBatchTriOffset)
+		goto fail;
+
+	for(i = 0; i < nTriNum; ++i)
+		++pnBatchTriOffset[psSet[pnTriSet[i]].nBatch + 1];
+	for(i = 0; i < nBatchCnt; ++i)
+		pnBatchTriOffset[i + 1] += pnBatchTriOffset[i];
+	for(i = 0; i < nTriNum; ++i)
+		pnBatchTri[pnBatchTriOffset[psSet[pnTriSet[i]].nBatch]++] = i;
+	for(i = nBatchCnt; i > 0; --i)
+		pnBatchTriOffset[i] = pnBatchTriOffset[i - 1];
+	pnBatchTriOffset[0] = 0;
+
 	// Now that we know how many batches there are, we can allocate the output arrays
 	CPVRTBoneBatches::nBatchBoneMax = nBatchBoneMax;
-	pnBatches		= (int*) calloc(lBatch.size() * nBatchBoneMax, sizeof(*pnBatches));
-	pnBatchBoneCnt	= (int*) calloc(lBatch.size(), sizeof(*pnBatchBoneCnt));
-	pnBatchOffset	= (int*) calloc(lBatch.size(), sizeof(*pnBatchOffset));
+	pnBatches		= (int*) calloc(nBatchCnt * nBatchBoneMax, sizeof(*pnBatches));
+	pnBatchBoneCnt	= (int*) calloc(nBatchCnt, sizeof(*pnBatchBoneCnt));
+	pnBatchOffset	= (int*) calloc(nBatchCnt, sizeof(*pnBatchOffset));
+	pnCopyFirst		= (int*) malloc((nVtxNum + 1) * sizeof(*pnCopyFirst));
+	pVtxBuf			= new CGrowableArray(nStride);
+	if((nBatchCnt && (!pnBatches || !pnBatchBoneCnt || !pnBatchOffset)) || !pnCopyFirst)
+		goto fail;
+
+	memset(pnCopyFirst, 0xFF, nVtxNum * sizeof(*pnCopyFirst));
 
 	// Create the new triangle index list, the new vertex list, and the batch information.
 	nTriCnt = 0;
-	nBatchCnt = 0;
 
-	for(iBatch = lBatch.begin(); iBatch != lBatch.end(); ++iBatch)
+	for(n = 0; n < nBatchCnt; ++n)
 	{
+		pBatch = vpBatch[n];
+
 		// Write pnBatches, pnBatchBoneCnt and pnBatchOffset for this batch.
-		iBatch->Write(&pnBatches[nBatchCnt * nBatchBoneMax], &pnBatchBoneCnt[nBatchCnt]);
-		pnBatchOffset[nBatchCnt] = nTriCnt;
-		++nBatchCnt;
+		pBatch->Write(&pnBatches[n * nBatchBoneMax], &pnBatchBoneCnt[n]);
+		pnBatchOffset[n] = nTriCnt;
 
-		// Copy any triangle indices for this batch
-		for(i = 0; i < nTriNum; ++i)
+		// Copy the triangle indices for this batch
+		for(k = pnBatchTriOffset[n]; k < pnBatchTriOffset[n + 1]; ++k)
 		{
-			if(ppBatch[i] != &*iBatch)
-				continue;
+			i = pnBatchTri[k];
 
 			for(j = 0; j < 3; ++j)
 			{
+				int nCopy;
+
 				ui32SrcIdx = pui32Idx[3 * i + j];
 
 				// Get desired bone indices for this vertex/tri
@@ -589,40 +694,34 @@ EPVRTError CPVRTBoneBatches::Create(
 				PVRTVertexRead(&vWeight, &pV[nOffsetWeight], eTypeWeight, nVertexBones);
 				PVRTVertexRead(&vIdx, &pV[nOffsetIdx], eTypeIdx, nVertexBones);
 
-				iBatch->GetVertexBoneIndices(&vIdx.x, &vWeight.x, nVertexBones);
+				pBatch->GetVertexBoneIndices(&vIdx.x, &vWeight.x, nVertexBones);
 				_ASSERT(vIdx.x == 0 || vIdx.x != vIdx.y);
 
 				// Check the list of copies of this vertex for one with suitable bone indices
-				for(k = 0; k < (int)pvDup[ui32SrcIdx].size(); ++k)
+				for(nCopy = pnCopyFirst[ui32SrcIdx]; nCopy >= 0; nCopy = vnCopyNext[nCopy])
 				{
-					pV2 = pVtxBuf->at(pvDup[ui32SrcIdx][k]);
-
-					PVRTVertexRead(&vWeight2, &pV2[nOffsetWeight], eTypeWeight, nVertexBones);
-					PVRTVertexRead(&vIdx2, &pV2[nOffsetIdx], eTypeIdx, nVertexBones);
-
-					if(BonesMatch(&vIdx2.x, &vIdx.x))
-					{
-						pui32IdxNew[3 * nTriCnt + j] = pvDup[ui32SrcIdx][k];
+					if(BonesMatch(&vCopyIdx[nCopy].x, &vIdx.x))
 						break;
-					}
 				}
 
-				if(k != (int)pvDup[ui32SrcIdx].size())
-					continue;
-
-				//	Did not find a suitable duplicate of the vertex, so create one
-				pVtxBuf->Append(pV, 1);
-				pvDup[ui32SrcIdx].push_back(pVtxBuf->size() - 1);
-
-				PVRTVertexWrite(&pVtxBuf->last()[nOffsetIdx], eTypeIdx, nVertexBones, &vIdx);
+				if(nCopy < 0)
+				{
+					//	Did not find a suitable duplicate of the vertex, so create one
+					pVtxBuf->Append(pV, 1);
+					PVRTVertexWrite(&pVtxBuf->last()[nOffsetIdx], eTypeIdx, nVertexBones, &vIdx);
+
+					nCopy = pVtxBuf->size() - 1;
+					vnCopyNext.push_back(pnCopyFirst[ui32SrcIdx]);
+					vCopyIdx.push_back(vIdx);
+					pnCopyFirst[ui32SrcIdx] = nCopy;
+				}
 
-				pui32IdxNew[3 * nTriCnt + j] = pVtxBuf->size() - 1;
+				pui32IdxNew[3 * nTriCnt + j] = nCopy;
 			}
 			++nTriCnt;
 		}
 	}
 	_ASSERTE(nTriCnt == nTriNum);
-	_ASSERTE(nBatchCnt == (int)lBatch.size());
 
 	//	Copy indices to output
 	memcpy(pui32Idx, pui32IdxNew, nTriNum * 3 * sizeof(*pui32IdxNew));
@@ -630,13 +729,31 @@ EPVRTError CPVRTBoneBatches::Create(
 	//	Move vertices to output
 	*pnVtxNumOut = pVtxBuf->Surrender(pVtxOut);
 
+	eRet = PVR_SUCCESS;
+
+fail:
+	if(eRet != PVR_SUCCESS)
+		Release();
+
 	//	Free working memory
-	delete [] pvDup;
+	for(i = 0; i < (int) vpBatch.size(); ++i)
+		delete vpBatch[i];
+	for(i = 0; i < (int) vpInOrder.size(); ++i)
+		delete vpInOrder[i];
 	delete pVtxBuf;
-	FREE(ppBatch);
+	FREE(pnCopyFirst);
+	FREE(pnBatchTriOffset);
+	FREE(pnBatchTri);
+	FREE(pnOrder);
+	FREE(pnInOrder);
+	FREE(pnHash);
 	FREE(pui32IdxNew);
+	FREE(psSet);
+	FREE(pnTriSet);
+	FREE(pnTriBoneCnt);
+	FREE(pnTriBones);
 
-	return PVR_SUCCESS;
+	return eRet;
 }
 
 /****************************************************************************
@@ -644,9 +761,10 @@ EPVRTError CPVRTBoneBatches::Create(
 ****************************************************************************/
 
 /*!***********************************************************************
- @Function		FillBatch
- @Modified		batch 			The batch to fill
- @Input			pui32Idx		Input index array for triangle list
+ @Function		ReadTriangleBones
+ @Output		pnBones			Bone indices used by the triangle, sorted
+ @Output		nBoneCnt		Number of bone indices
+ @Input			pui32Idx		Input index array for the triangle
  @Input			pVtx			Input vertices
  @Input			nStride			Size of a vertex (in bytes)
  @Input			nOffsetWeight	Offset in bytes to the vertex bone-weights
@@ -654,11 +772,13 @@ EPVRTError CPVRTBoneBatches::Create(
  @Input			nOffsetIdx		Offset in bytes to the vertex bone-indices
  @Input			eTypeIdx		Data type of the vertex bone-indices
  @Input			nVertexBones	Number of bones affecting each vertex
- @Returns		True if successful
- @Description	Creates a bone batch from a triangle.
+ @Returns		False if the triangle uses a negative bone index
+ @Description	Collects the distinct bones with non-zero weights used by
+				the vertices of a triangle.
 *************************************************************************/
-static bool FillBatch(
-	CBatch					&batch,
+static bool ReadTriangleBones(
+	int						* const pnBones,
+	int						&nBoneCnt,
 	const unsigned int	* const pui32Idx,
 	const char				* const pVtx,
 	const int				nStride,
@@ -670,11 +790,9 @@ static bool FillBatch(
 {
 	PVRTVECTOR4	vWeight, vIdx;
 	const char	*pV;
-	int			i;
-	bool		bOk;
+	int			i, j, k, n;
 
-	bOk = true;
-	batch.Clear();
+	nBoneCnt = 0;
 	for(i = 0; i < 3; ++i)
 	{
 		pV = &pVtx[pui32Idx[i] * nStride];
@@ -683,12 +801,49 @@ static bool FillBatch(
 		PVRTVertexRead(&vWeight, &pV[nOffsetWeight], eTypeWeight, nVertexBones);
 		PVRTVertexRead(&vIdx, &pV[nOffsetIdx], eTypeIdx, nVertexBones);
 
-		if(nVertexBones >= 1 && vWeight.x != 0)	bOk &= batch.Add((int)vIdx.x);
-		if(nVertexBones >= 2 && vWeight.y != 0)	bOk &= batch.Add((int)vIdx.y);
-		if(nVertexBones >= 3 && vWeight.z != 0)	bOk &= batch.Add((int)vIdx.z);
-		if(nVertexBones >= 4 && vWeight.w != 0)	bOk &= batch.Add((int)vIdx.w);
+		for(j = 0; j < nVertexBones; ++j)
+		{
+			if((&vWeight.x)[j] == 0)
+				continue;
+
+			n = (int)(&vIdx.x)[j];
+			if(n < 0)
+				return false;
+
+			// Insert in order, skipping duplicates
+			for(k = nBoneCnt; k > 0 && pnBones[k - 1] > n; --k);
+			if(k > 0 && pnBones[k - 1] == n)
+				continue;
+
+			memmove(&pnBones[k + 1], &pnBones[k], (nBoneCnt - k) * sizeof(*pnBones));
+			pnBones[k] = n;
+			++nBoneCnt;
+		}
+	}
+	return true;
+}
+
+/*!***********************************************************************
+ @Function		HashBones
+ @Input			pnBones			Array of bone indices
+ @Input			nBoneCnt		Number of bone indices
+ @Returns		A hash of the bone indices
+*************************************************************************/
+static unsigned int HashBones(
+	const int * const pnBones,
+	const int nBoneCnt)
+{
+	unsigned int	ui32Hash;
+	int				i;
+
+	ui32Hash = 2166136261u;
+	for(i = 0; i < nBoneCnt; ++i)
+	{
+		ui32Hash ^= (unsigned int) pnBones[i];
+		ui32Hash *= 16777619u;
 	}
-	return bOk;
+
+	return ui32Hash ^ (ui32Hash >> 15);
 }
 
 /*!***********************************************************************
@@ -713,7 +868,145 @@ static bool BonesMatch(
 	return true;
 }
 
+/*!***********************************************************************
+ @Function		BonesContain
+ @Input			pnBones			Sorted bone indices
+ @Input			nBoneCnt		Number of bone indices
+ @Input			pnSub			Sorted bone indices to look for
+ @Input			nSubCnt			Number of bone indices to look for
+ @Returns		True if every bone of pnSub is in pnBones
+*************************************************************************/
+static bool BonesContain(
+	const int * const pnBones,
+	const int nBoneCnt,
+	const int * const pnSub,
+	const int nSubCnt)
+{
+	int i, j;
+
+	for(i = 0, j = 0; j < nSubCnt; ++j)
+	{
+		while(i < nBoneCnt && pnBones[i] < pnSub[j])
+			++i;
+
+		if(i == nBoneCnt || pnBones[i] != pnSub[j])
+			return false;
+	}
+
+	return true;
+}
+
+/*!***********************************************************************
+ @Function		BatchSetsInOrder
+ @Output		vpBatch			The batches
+ @Output		pnSetBatch		Batch of each set
+ @Input			psSet			Distinct bone sets, in order of first use
+ @Input			nSetCnt			Number of bone sets
+ @Input			pnTriBones		Sorted bone indices of each triangle
+ @Input			nBatchBoneMax	Number of bones a batch can reference
+ @Input			nBoneNum		One more than the largest bone index
+ @Returns		False if out of memory
+ @Description	Batches the sets as the original implementation batched the
+				triangles: it keeps the sets that no other set contains, in
+				order of first use, then lets each in turn absorb the later
+				one that adds the fewest bones until none fits, and places
+				each set in the first batch that holds it.
+*************************************************************************/
+static bool BatchSetsInOrder(
+	std::vector<CBatch*>	&vpBatch,
+	int						* const pnSetBatch,
+	const SBoneSet			* const psSet,
+	const int				nSetCnt,
+	const int				* const pnTriBones,
+	const int				nBatchBoneMax,
+	const int				nBoneNum)
+{
+	std::vector<int>	vnSet;	// Sets not contained by another
+	CBatch				*pBatch;
+	int					i, j, k, nBest, nBestCost, nCost;
+
+	for(i = 0; i < nSetCnt; ++i)
+	{
+		const int *pnBones = &pnTriBones[psSet[i].nTri * PVRT_MAX_TRI_BONES];
+
+		for(j = 0; j < (int) vnSet.size(); ++j)
+		{
+			const SBoneSet	&other		= psSet[vnSet[j]];
+			const int		*pnOther	= &pnTriBones[other.nTri * PVRT_MAX_TRI_BONES];
+
+			// Do nothing if an existing set is a superset of this one
+			if(BonesContain(pnOther, other.nBoneCnt, pnBones, psSet[i].nBoneCnt))
+				break;
+
+			// If this set is a superset of an existing one, replace the old with the new
+			if(BonesContain(pnBones, psSet[i].nBoneCnt, pnOther, other.nBoneCnt))
+			{
+				vnSet[j] = i;
+				break;
+			}
+		}
+
+		if(j == (int) vnSet.size())
+			vnSet.push_back(i);
+	}
+
+	for(i = 0; i < (int) vnSet.size(); ++i)
+	{
+		pBatch = new CBatch;
+		vpBatch.push_back(pBatch);
+		if(!pBatch->SetSize(nBatchBoneMax, nBoneNum))
+			return false;
+
+		for(j = 0; j < psSet[vnSet[i]].nBoneCnt; ++j)
+			pBatch->Add(pnTriBones[psSet[vnSet[i]].nTri * PVRT_MAX_TRI_BONES + j]);
+	}
+
+	//	Group batches into fewer batches
+	for(i = 0; i < (int) vpBatch.size(); ++i)
+	{
+		for(;;)
+		{
+			nBest		= -1;
+			nBestCost	= PVRT_MIN(nBatchBoneMax, nBatchBoneMax - vpBatch[i]->Count() + 1);
+
+			for(j = i + 1; j < (int) vpBatch.size(); ++j)
+			{
+				nCost = vpBatch[i]->CountMissing(vpBatch[j]->Palette(), vpBatch[j]->Count(), nBestCost);
+
+				if(nCost < nBestCost)
+				{
+					nBestCost	= nCost;
+					nBest		= j;
+				}
+			}
+
+			if(nBest < 0)
+				break;
+
+			for(k = 0; k < vpBatch[nBest]->Count(); ++k)
+				vpBatch[i]->Add(vpBatch[nBest]->Palette()[k]);
+
+			delete vpBatch[nBest];
+			vpBatch.erase(vpBatch.begin() + nBest);
+		}
+	}
+
+	// Place each set in a batch
+	for(i = 0; i < nSetCnt; ++i)
+	{
+		for(j = 0; j < (int) vpBatch.size(); ++j)
+		{
+			if(vpBatch[j]->CountMissing(&pnTriBones[psSet[i].nTri * PVRT_MAX_TRI_BONES], psSet[i].nBoneCnt, 1) == 0)
+				break;
+		}
+
+		_ASSERT(j < (int) vpBatch.size());
+		pnSetBatch[i] = j;
+	}
+
+	return true;
+}
+
 /*****************************************************************************
  End of file (PVRTBoneBatch.cpp)
 *****************************************************************************/
-
@@ -23,6 +23,7 @@
 #include <string.h>
 #include "PVRTFixedPoint.h"		// Only needed for trig function float lookups
 #include "PVRTMatrix.h"
+#include "PVRTSimd.h"
 
 
 /****************************************************************************
@@ -37,6 +38,29 @@ static const PVRTMATRIXf	c_mIdentity = {
 	}
 };
 
+#ifdef PVRT_SIMD
+/****************************************************************************
+** Local code
+****************************************************************************/
+
+/*!***************************************************************************
+ @Function			PVRTMatrixMinorsF
+ @Input				vA		A row of a 3x3 matrix
+ @Input				vB		A later row of the same matrix
+ @Return			[a.y*b.z - b.y*a.z, a.x*b.z - b.x*a.z, a.x*b.y - b.x*a.y, -]
+ @Description		The 2x2 minors of the two rows, as PVRTMatrixInverseF()
+					computes them before applying the cofactor signs. The last
+					component is not used.
+*****************************************************************************/
+static inline PVRTSIMDVEC PVRTMatrixMinorsF(const PVRTSIMDVEC vA, const PVRTSIMDVEC vB)
+{
+	const PVRTSIMDVEC vP = PVRTSimdMul(PVRTSimdShuffle<1, 0, 0, 3>(vA, vA), PVRTSimdShuffle<2, 2, 1, 3>(vB, vB));
+	const PVRTSIMDVEC vQ = PVRTSimdMul(PVRTSimdShuffle<1, 0, 0, 3>(vB, vB), PVRTSimdShuffle<2, 2, 1, 3>(vA, vA));
+
+	return PVRTSimdSub(vP, vQ);
+}
+#endif
+
 /****************************************************************************
 ** Functions
 ****************************************************************************/
@@ -69,6 +93,24 @@ void PVRTMatrixMultiplyF(
 	const PVRTMATRIXf	&mA,
 	const PVRTMATRIXf	&mB)
 {
+#ifdef PVRT_SIMD
+	/* Each row of the result is a weighted sum of the rows of mB. All of
+	   mB is loaded before anything is stored, as mOut may be mA or mB. */
+	const PVRTSIMDVEC vB0 = PVRTSimdLoad(&mB.f[ 0]);
+	const PVRTSIMDVEC vB1 = PVRTSimdLoad(&mB.f[ 4]);
+	const PVRTSIMDVEC vB2 = PVRTSimdLoad(&mB.f[ 8]);
+	const PVRTSIMDVEC vB3 = PVRTSimdLoad(&mB.f[12]);
+
+	const PVRTSIMDVEC vR0 = PVRTSimdCombine(vB0, vB1, vB2, vB3, &mA.f[ 0]);
+	const PVRTSIMDVEC vR1 = PVRTSimdCombine(vB0, vB1, vB2, vB3, &mA.f[ 4]);
+	const PVRTSIMDVEC vR2 = PVRTSimdCombine(vB0, vB1, vB2, vB3, &mA.f[ 8]);
+	const PVRTSIMDVEC vR3 = PVRTSimdCombine(vB0, vB1, vB2, vB3, &mA.f[12]);
+
+	PVRTSimdStore(&mOut.f[ 0], vR0);
+	PVRTSimdStore(&mOut.f[ 4], vR1);
+	PVRTSimdStore(&mOut.f[ 8], vR2);
+	PVRTSimdStore(&mOut.f[12], vR3);
+#else
 	PVRTMATRIXf mRet;
 
 	/* Perform calculation on a dummy matrix (mRet) */
@@ -94,6 +136,7 @@ void PVRTMatrixMultiplyF(
 
 	/* Copy result to mOut */
 	mOut = mRet;
+#endif
 }
 
 
@@ -288,6 +331,36 @@ void PVRTMatrixInverseF(
 	{
         /* Calculate inverse(A) = adj(A) / det(A) */
         det_1 = 1.0 / det_1;
+#ifdef PVRT_SIMD
+		/* Each column of adj(A) is built from two rows of A, with the same
+		   products, differences and signs as the scalar code. The result is
+		   transposed into rows, then -C * inverse(A) is a weighted sum of
+		   them. All of mIn is loaded before anything is stored. */
+		const PVRTSIMDVEC vA0		= PVRTSimdLoad(&mIn.f[ 0]);
+		const PVRTSIMDVEC vA1		= PVRTSimdLoad(&mIn.f[ 4]);
+		const PVRTSIMDVEC vA2		= PVRTSimdLoad(&mIn.f[ 8]);
+		const PVRTSIMDVEC vSignY	= PVRTSimdSet(0.0f, -0.0f, 0.0f, 0.0f);
+		const PVRTSIMDVEC vSignXZ	= PVRTSimdSet(-0.0f, 0.0f, -0.0f, 0.0f);
+		const float fC[3]			= { mIn.f[12], mIn.f[13], mIn.f[14] };
+		const float fDet			= (float)det_1;
+		PVRTSIMDVEC vR0, vR1, vR2, vR3;
+
+		vR0 = PVRTSimdScale(PVRTSimdXorSign(PVRTMatrixMinorsF(vA1, vA2), vSignY), fDet);
+		vR1 = PVRTSimdScale(PVRTSimdXorSign(PVRTMatrixMinorsF(vA0, vA2), vSignXZ), fDet);
+		vR2 = PVRTSimdScale(PVRTSimdXorSign(PVRTMatrixMinorsF(vA0, vA1), vSignY), fDet);
+		vR3 = PVRTSimdSplat(0.0f);
+		PVRTSimdTranspose(vR0, vR1, vR2, vR3);
+
+		vR3 = PVRTSimdAdd(PVRTSimdScale(vR0, fC[0]), PVRTSimdScale(vR1, fC[1]));
+		vR3 = PVRTSimdNeg(PVRTSimdAdd(vR3, PVRTSimdScale(vR2, fC[2])));
+
+		PVRTSimdStore(&mOut.f[ 0], vR0);
+		PVRTSimdStore(&mOut.f[ 4], vR1);
+		PVRTSimdStore(&mOut.f[ 8], vR2);
+		PVRTSimdStore(&mOut.f[12], vR3);
+		mOut.f[15] = 1.0f;
+		return;
+#else
         mDummyMatrix.f[ 0] =   ( mIn.f[ 5] * mIn.f[10] - mIn.f[ 9] * mIn.f[ 6] ) * (float)det_1;
         mDummyMatrix.f[ 1] = - ( mIn.f[ 1] * mIn.f[10] - mIn.f[ 9] * mIn.f[ 2] ) * (float)det_1;
         mDummyMatrix.f[ 2] =   ( mIn.f[ 1] * mIn.f[ 6] - mIn.f[ 5] * mIn.f[ 2] ) * (float)det_1;
@@ -308,6 +381,7 @@ void PVRTMatrixInverseF(
 		mDummyMatrix.f[ 7] = 0.0f;
 		mDummyMatrix.f[11] = 0.0f;
         mDummyMatrix.f[15] = 1.0f;
+#endif
 	}
 
    	/* Copy contents of dummy matrix in pfMatrix */
@@ -64,6 +64,44 @@ public:
 	*****************************************************************************/
 	static const char* GetFilename(int i32Index);
 
+	/*!***************************************************************************
+	 @Function		MountPack
+	 @Input			pszPackFilename	Name of the pack file, relative to the
+									CPVRTResourceFile read path
+	 @Input			pszDirectory	Prefix for the names of the packed files
+	 @Return		true if the pack was mounted, false otherwise
+	 @Description	Registers every file of a pack written by SavePack. The pack
+	                is mapped into memory where the platform allows, or else
+	                read in one go, and stays there until exit. Each file is
+	                registered as pszDirectory followed by its packed name, so
+	                pass "Textures/" to mount the pack as a Textures directory.
+	*****************************************************************************/
+	static bool MountPack(const char* pszPackFilename, const char* pszDirectory = 0);
+
+	/*!***************************************************************************
+	 @Function		MountPack
+	 @Input			pPack			Pointer to the pack data
+	 @Input			Size			Pack size
+	 @Input			pszDirectory	Prefix for the names of the packed files
+	 @Return		true if the pack was mounted, false otherwise
+	 @Description	Registers every file of a pack that is already in memory,
+	                without copying it. The pack data must outlive its use.
+	*****************************************************************************/
+	static bool MountPack(const void* pPack, size_t Size, const char* pszDirectory = 0);
+
+	/*!***************************************************************************
+	 @Function		SavePack
+	 @Input			pszPackFilename	Name of the pack file to write
+	 @Input			ppszFilenames	Names of the files to pack
+	 @Input			i32NumFiles		Number of files to pack
+	 @Return		true if the pack was written, false otherwise
+	 @Description	Writes a pack for MountPack: a header and an index, then the
+	                names, then the file data. Each file is read through
+	                CPVRTResourceFile and is packed under the name given.
+	                Empty files are packed as entries of size zero.
+	*****************************************************************************/
+	static bool SavePack(const char* pszPackFilename, const char* const* ppszFilenames, int i32NumFiles);
+
 protected:
 	class CAtExit
 	{
@@ -90,6 +128,48 @@ protected:
 	static SFileInfo* s_pFileInfo;
 	static int s_i32NumFiles;
 	static int s_i32Capacity;
+
+	// Open addressed table of indices into s_pFileInfo, -1 for empty slots.
+	// The size is a power of two and the table is kept at most half full.
+	static int* s_pi32Hash;
+	static int s_i32HashSize;
+
+	struct SPackInfo
+	{
+		const void* pData;
+		size_t Size;
+		char* pszNames;		// Prefixed names of the packed files, if any
+		bool bMapped;
+		bool bAllocated;
+	};
+	static SPackInfo* s_pPackInfo;
+	static int s_i32NumPacks;
+
+	/*!***************************************************************************
+	 @Function		FindFile
+	 @Input			pszFilename		Name of file to look up
+	 @Return		Index of the first file registered under the name, or -1
+	*****************************************************************************/
+	static int FindFile(const char* pszFilename);
+
+	/*!***************************************************************************
+	 @Function		HashFile
+	 @Input			i32Index		Index of the file to add to the table
+	 @Description	Adds a file to the name table, growing the table as needed.
+	                A name that is already in the table keeps its first file.
+	*****************************************************************************/
+	static void HashFile(int i32Index);
+
+	/*!***************************************************************************
+	 @Function		AddPack
+	 @Input			pPack			Pointer to the pack data
+	 @Input			Size			Pack size
+	 @Input			pszDirectory	Prefix for the names of the packed files
+	 @Input			bMapped			The pack data is a mapping to release at exit
+	 @Input			bAllocated		The pack data is an allocation to free at exit
+	 @Return		true if the pack was valid and its files were registered
+	*****************************************************************************/
+	static bool AddPack(const void* pPack, size_t Size, const char* pszDirectory, bool bMapped, bool bAllocated);
 };
 
 #endif // _PVRTMEMORYFILE_H_
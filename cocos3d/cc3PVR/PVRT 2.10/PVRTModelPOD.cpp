@@ -14,9 +14,12 @@
 
 ******************************************************************************/
 #include <math.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include "PVRTGlobal.h"
 #include "PVRTContext.h"
@@ -29,6 +32,15 @@
 // #include "PVRTMisc.h"			// patched for cocos3d by Bill Hollings
 #include "PVRTResourceFile.h"
 #include "PVRTTrans.h"
+#include "PVRTParallel.h"
+#include "PVRTVertexCache.h"
+
+#if defined(__APPLE__) || defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#define PVRTMODELPOD_MMAP		// ReadFromFileMapped() can map files
+#endif
 
 /****************************************************************************
 ** Defines
@@ -39,6 +51,11 @@
 
 #define CFAH		(1024)
 
+#define PVRTMODELPOD_COOKED_MAGIC		(0x43444F50)	// "PODC" in the byte order of the machine that cooked the file
+#define PVRTMODELPOD_COOKED_VERSION		(2)
+#define PVRTMODELPOD_COOKED_ALIGN		(16)			// Alignment of the arrays in a cooked file
+#define PVRTMODELPOD_COOKED_LAYOUT		(10)			// Number of type sizes a cooked file is checked against
+
 /****************************************************************************
 ** Enumerations
 ****************************************************************************/
@@ -167,9 +184,74 @@ enum EPODFileName
 	ePODFileData
 };
 
+/*!****************************************************************************
+ @Enum        EPODBlockRead
+ @Brief       Which parts of a mesh or node block to decode
+******************************************************************************/
+enum EPODBlockRead
+{
+	ePODReadAll,		/*!< The whole block */
+	ePODReadHeader,		/*!< All but the vertex and index data, and only the frame 0 key of animation */
+	ePODReadData		/*!< Only the vertex and index data, or the animation */
+};
+
 /****************************************************************************
 ** Structures
 ****************************************************************************/
+/*!***************************************************************************
+ @Struct			SPODCookedHeader
+ @Brief				Start of a cooked scene file. The file is a copy of the
+					scene structures and arrays in this machine's memory
+					layout, with every pointer stored as an offset from the
+					start of the file. The offset table lists where those
+					pointers are, so loading only has to add the load address.
+*****************************************************************************/
+struct SPODCookedHeader
+{
+	PVRTuint32	nMagic;			/*!< PVRTMODELPOD_COOKED_MAGIC */
+	PVRTuint32	nVersion;		/*!< PVRTMODELPOD_COOKED_VERSION */
+	PVRTuint32	nSize;			/*!< Size of the whole file */
+	PVRTuint32	nScene;			/*!< Offset of the SPODScene */
+	PVRTuint32	nFixups;		/*!< Offset of the offset table */
+	PVRTuint32	nNumFixups;		/*!< Number of pointers in the offset table */
+	PVRTuint64	nSourceTime;	/*!< Modification time of the POD file the scene was cooked from, or 0 */
+	PVRTuint32	nSourceSize;	/*!< Size of the POD file the scene was cooked from, or 0 */
+	PVRTuint16	pnLayout[PVRTMODELPOD_COOKED_LAYOUT];	/*!< Sizes of a pointer, VERTTYPE and the scene structures */
+};
+
+/*!***************************************************************************
+ @Struct			SPODAnimTracks
+ @Brief				Node animation resampled into structure-of-arrays form.
+					Each channel holds nNumFrame * nNumNode values, stored
+					frame by frame, so one frame of every node is contiguous.
+*****************************************************************************/
+struct SPODAnimTracks
+{
+	unsigned int	nNumFrame;		/*!< Number of baked frames (at least one) */
+	unsigned int	nNumNode;		/*!< Number of nodes per frame */
+
+	float			*pfData;		/*!< Single allocation holding every channel */
+	float			*pfPos[3];		/*!< Position X, Y, Z */
+	float			*pfRot[4];		/*!< Rotation quaternion X, Y, Z, W */
+	float			*pfScale[3];	/*!< Scale X, Y, Z */
+
+	unsigned char	*pu8Flags;		/*!< Per node: ePODHasRotationAni if the rotation must be interpolated, ePODHasMatrixAni if the node uses matrices */
+};
+
+/*!***************************************************************************
+ @Struct			SPODLazyScene
+ @Brief				Where to find the meshes and node animation of a scene
+					loaded by ReadFromFileLazy(), and which are loaded.
+*****************************************************************************/
+struct SPODLazyScene
+{
+	size_t			*pnMeshPos;		/*!< Per mesh: file position of its block */
+	size_t			*pnNodePos;		/*!< Per node: file position of its block */
+	bool			*pbMeshLoaded;	/*!< Per mesh: whether its vertex and index data is loaded */
+	bool			*pbNodeLoaded;	/*!< Per node: whether its animation is loaded, or it has none */
+	bool			bConvert;		/*!< The file's fixed or floating point animation had to be converted */
+};
+
 struct SPVRTPODImpl
 {
 	VERTTYPE	fFrame;		/*!< Frame number */
@@ -182,6 +264,18 @@ struct SPVRTPODImpl
 
 	bool		bFromMemory;	/*!< Was the mesh data loaded from memory? */
 
+	void		*pMapped;		/*!< File mapping that loaded arrays may point into */
+	size_t		nMappedSize;	/*!< Size of the file mapping */
+	bool		bMappedAlloc;	/*!< pMapped was allocated with malloc() rather than mapped */
+	SPODLazyScene	*pLazy;		/*!< Block positions of a scene loaded by ReadFromFileLazy(), which reads from pMapped */
+
+	SPODAnimTracks	*pTracks;	/*!< Baked animation, if BakeAnimation() was called */
+	unsigned int	*pnNodeOrder;	/*!< Node indices sorted so that parents come before their children */
+
+	PVRTMATRIX		*pWmZeroInvCache;	/*!< Inverses of the frame 0 matrices */
+	PVRTMATRIX		*pmBoneBind;		/*!< Per mesh node and batch bone: mesh frame 0 matrix * inverse bone frame 0 matrix */
+	unsigned int	*pnBoneBindOffset;	/*!< Per mesh node: start of its bones in pmBoneBind */
+
 #ifdef _DEBUG
 	PVRTint64 nWmTotal, nWmCacheHit, nWmZeroCacheHit;
 	float	fHitPerc, fHitPercZero;
@@ -290,6 +384,36 @@ public:
 	virtual bool Read(void* lpBuffer, const unsigned int dwNumberOfBytesToRead) = 0;
 	virtual bool Skip(const unsigned int nBytes) = 0;
 
+	/*!***************************************************************************
+	@Function			Borrow
+	@Input				nBytes			Number of bytes required
+	@Input				nAlign			Required alignment of the returned pointer
+	@Return			Pointer to the data in the source, or NULL
+	@Description		Sources which hold the whole file in memory for the
+						lifetime of the scene may return a pointer to the next
+						nBytes instead of copying them, advancing the read
+						position. Returns NULL (and does not advance) if the
+						data can not be used in place.
+	*****************************************************************************/
+	virtual void* Borrow(const unsigned int /*nBytes*/, const unsigned int /*nAlign*/) { return 0; }
+
+	/*!***************************************************************************
+	@Function			Tell
+	@Return			The current read position
+	@Description		Only meaningful for sources that support CreateView().
+	*****************************************************************************/
+	virtual size_t Tell() const { return 0; }
+
+	/*!***************************************************************************
+	@Function			CreateView
+	@Input				nPos			Read position of the new source
+	@Return			A new source, or NULL
+	@Description		Sources which hold the whole file in memory may return an
+						independent source over the same data, starting at nPos.
+						Views may be read concurrently; the caller deletes them.
+	*****************************************************************************/
+	virtual CSource* CreateView(const size_t /*nPos*/) const { return 0; }
+
 	template <typename T>
 	bool Read(T &n)
 	{
@@ -373,6 +497,51 @@ public:
 
 		return bRet;
 	}
+
+	/*
+		The ReadOrBorrow*() variants behave as the ReadAfterAlloc*() ones but
+		leave lpBuffer pointing into the source when it allows it. Multi-byte
+		data is only borrowed on little-endian platforms, where the file
+		layout matches the in-memory one.
+	*/
+	template <typename T>
+	bool ReadOrBorrow(T* &lpBuffer, const unsigned int dwNumberOfBytesToRead, const unsigned int nAlign)
+	{
+		_ASSERT(!lpBuffer);
+		if(dwNumberOfBytesToRead && (nAlign == 1 || PVRTIsLittleEndian()))
+		{
+			lpBuffer = (T*) Borrow(dwNumberOfBytesToRead, nAlign);
+			if(lpBuffer)
+				return true;
+		}
+		return ReadAfterAlloc(lpBuffer, dwNumberOfBytesToRead);
+	}
+
+	template <typename T>
+	bool ReadOrBorrow32(T* &lpBuffer, const unsigned int dwNumberOfBytesToRead)
+	{
+		check32BitType<T>();
+		if(dwNumberOfBytesToRead && PVRTIsLittleEndian())
+		{
+			lpBuffer = (T*) Borrow(dwNumberOfBytesToRead, 4);
+			if(lpBuffer)
+				return true;
+		}
+		return ReadAfterAlloc32(lpBuffer, dwNumberOfBytesToRead);
+	}
+
+	template <typename T>
+	bool ReadOrBorrow16(T* &lpBuffer, const unsigned int dwNumberOfBytesToRead)
+	{
+		check16BitType<T>();
+		if(dwNumberOfBytesToRead && PVRTIsLittleEndian())
+		{
+			lpBuffer = (T*) Borrow(dwNumberOfBytesToRead, 2);
+			if(lpBuffer)
+				return true;
+		}
+		return ReadAfterAlloc16(lpBuffer, dwNumberOfBytesToRead);
+	}
 };
 
 bool CSource::ReadMarker(unsigned int &nName, unsigned int &nLen)
@@ -411,6 +580,8 @@ public:
 
 	virtual bool Read(void* lpBuffer, const unsigned int dwNumberOfBytesToRead);
 	virtual bool Skip(const unsigned int nBytes);
+	virtual size_t Tell() const { return m_BytesReadCount; }
+	virtual CSource* CreateView(const size_t nPos) const;
 };
 
 /*!***************************************************************************
@@ -504,6 +675,157 @@ bool CSourceStream::Skip(const unsigned int nBytes)
 	return true;
 }
 
+/*!***************************************************************************
+ Class: CSourceView
+*****************************************************************************/
+class CSourceView : public CSource
+{
+protected:
+	unsigned char	*m_pData;
+	size_t			m_nSize, m_nReadPos;
+	bool			m_bBorrow;
+
+public:
+	/*!***************************************************************************
+	@Function			CSourceView
+	@Input				pData			Start of the data
+	@Input				nSize			Size of the data
+	@Input				nReadPos		Initial read position
+	@Input				bBorrow			Whether data may be used in place
+	@Description		Constructor. Reads from a block of memory owned by
+						someone else.
+	*****************************************************************************/
+	CSourceView(unsigned char *pData = 0, const size_t nSize = 0, const size_t nReadPos = 0, const bool bBorrow = false) :
+		m_pData(pData), m_nSize(nSize), m_nReadPos(nReadPos), m_bBorrow(bBorrow) {}
+
+	virtual bool Read(void* lpBuffer, const unsigned int dwNumberOfBytesToRead);
+	virtual bool Skip(const unsigned int nBytes);
+	virtual void* Borrow(const unsigned int nBytes, const unsigned int nAlign);
+	virtual size_t Tell() const { return m_nReadPos; }
+	virtual CSource* CreateView(const size_t nPos) const { return new CSourceView(m_pData, m_nSize, nPos, m_bBorrow); }
+};
+
+bool CSourceView::Read(void* lpBuffer, const unsigned int dwNumberOfBytesToRead)
+{
+	if(m_nReadPos + dwNumberOfBytesToRead > m_nSize)
+		return false;
+
+	_ASSERT(lpBuffer);
+	memcpy(lpBuffer, &m_pData[m_nReadPos], dwNumberOfBytesToRead);
+	m_nReadPos += dwNumberOfBytesToRead;
+	return true;
+}
+
+bool CSourceView::Skip(const unsigned int nBytes)
+{
+	if(m_nReadPos + nBytes > m_nSize)
+		return false;
+
+	m_nReadPos += nBytes;
+	return true;
+}
+
+void* CSourceView::Borrow(const unsigned int nBytes, const unsigned int nAlign)
+{
+	if(!m_bBorrow || m_nReadPos + nBytes > m_nSize)
+		return 0;
+
+	unsigned char *pData = &m_pData[m_nReadPos];
+	if((size_t) pData % nAlign)
+		return 0;
+
+	m_nReadPos += nBytes;
+	return pData;
+}
+
+/*!***************************************************************************
+@Function			CreateView
+@Input				nPos			Read position of the new source
+@Description		Creates a source over the loaded file, starting at nPos.
+*****************************************************************************/
+CSource* CSourceStream::CreateView(const size_t nPos) const
+{
+	_ASSERT(m_pFile);
+	return new CSourceView((unsigned char*) m_pFile->DataPtr(), m_pFile->Size(), nPos, false);
+}
+
+#ifdef PVRTMODELPOD_MMAP
+/*!***************************************************************************
+ Class: CSourceMapped
+*****************************************************************************/
+class CSourceMapped : public CSourceView
+{
+public:
+	/*!***************************************************************************
+	@Function			~CSourceMapped
+	@Description		Destructor. Unmaps the file unless Detach() was called.
+	*****************************************************************************/
+	virtual ~CSourceMapped();
+
+	bool Init(const char * const pszFileName);
+	void Detach(void* &pData, size_t &nSize);
+};
+
+CSourceMapped::~CSourceMapped()
+{
+	if(m_pData)
+		munmap(m_pData, m_nSize);
+}
+
+/*!***************************************************************************
+@Function			Init
+@Input				pszFileName		Source file
+@Description		Maps the file at the current read path into memory. The
+					mapping is private and writable so that loaded data can
+					still be converted in place without touching the file.
+*****************************************************************************/
+bool CSourceMapped::Init(const char * const pszFileName)
+{
+	if(!pszFileName)
+		return false;
+
+	CPVRTString Path(CPVRTResourceFile::GetReadPath());
+	Path += pszFileName;
+
+	int fd = open(Path.c_str(), O_RDONLY);
+	if(fd < 0)
+		return false;
+
+	struct stat sStat;
+	if(fstat(fd, &sStat) != 0 || sStat.st_size <= 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	void *pData = mmap(0, (size_t) sStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);	// The mapping holds its own reference to the file
+
+	if(pData == MAP_FAILED)
+		return false;
+
+	m_pData		= (unsigned char*) pData;
+	m_nSize		= (size_t) sStat.st_size;
+	m_nReadPos	= 0;
+	m_bBorrow	= true;
+	return true;
+}
+
+/*!***************************************************************************
+@Function			Detach
+@Output			pData			Address of the mapping
+@Output			nSize			Size of the mapping
+@Description		Hands ownership of the mapping to the caller.
+*****************************************************************************/
+void CSourceMapped::Detach(void* &pData, size_t &nSize)
+{
+	pData = m_pData;
+	nSize = m_nSize;
+	m_pData = 0;
+	m_nSize = 0;
+}
+#endif /* PVRTMODELPOD_MMAP */
+
 #if defined(WIN32) && !defined(__BADA__)
 /*!***************************************************************************
  Class: CSourceResource
@@ -1162,6 +1484,7 @@ static bool WritePOD(
  @Input				src CSource object to read data from.
  @Input				nSpec
  @Input				bValidData
+ @Input				bSkipData		Leave pData alone and skip the data
  @Return			true if successful
  @Description		Read a CPODData block in  from a pod file
 *****************************************************************************/
@@ -1169,7 +1492,8 @@ static bool ReadCPODData(
 	CPODData			&s,
 	CSource				&src,
 	const unsigned int	nSpec,
-	const bool			bValidData)
+	const bool			bValidData,
+	const bool			bSkipData = false)
 {
 	unsigned int nName, nLen, nBuff;
 
@@ -1184,23 +1508,29 @@ static bool ReadCPODData(
 		case ePODFileN:			if(!src.Read32(s.n)) return false;						break;
 		case ePODFileStride:	if(!src.Read32(s.nStride)) return false;					break;
 		case ePODFileData:
-			if(bValidData)
+			if(bSkipData)
+			{
+				if(!src.Skip(nLen)) return false;
+			}
+			else if(bValidData)
 			{
 				switch(PVRTModelPODDataTypeSize(s.eType))
 				{
-					case 1: if(!src.ReadAfterAlloc(s.pData, nLen)) return false; break;
+					case 1: if(!src.ReadOrBorrow(s.pData, nLen, 1)) return false; break;
 					case 2:
 						{ // reading 16bit data but have 8bit pointer
 							PVRTuint16 *p16Pointer=NULL;
-							if(!src.ReadAfterAlloc16(p16Pointer, nLen)) return false;
-							s.pData = (unsigned char*)p16Pointer;
+							const bool bRead = src.ReadOrBorrow16(p16Pointer, nLen);
+							s.pData = (unsigned char*)p16Pointer;	// Kept on failure, so that it is freed with the scene
+							if(!bRead) return false;
 							break;
 						}
 					case 4:
 						{ // reading 32bit data but have 8bit pointer
 							PVRTuint32 *p32Pointer=NULL;
-							if(!src.ReadAfterAlloc32(p32Pointer, nLen)) return false;
-							s.pData = (unsigned char*)p32Pointer;
+							const bool bRead = src.ReadOrBorrow32(p32Pointer, nLen);
+							s.pData = (unsigned char*)p32Pointer;	// Kept on failure, so that it is freed with the scene
+							if(!bRead) return false;
 							break;
 						}
 					default:
@@ -1461,24 +1791,60 @@ void PVRTFixInterleavedEndianness(SPODMesh &s)
 	PVRTFixInterleavedEndiannessUsingCPODData(s.pInterleaved, s.sBoneWeight, s.nNumVertex);
 }
 
+/*!***************************************************************************
+ @Function			IsMeshDataBlock
+ @Input				nName	Name of a block found inside a mesh block
+ @Return			true if the block holds vertex or index data
+*****************************************************************************/
+static bool IsMeshDataBlock(const unsigned int nName)
+{
+	switch(nName)
+	{
+	case ePODFileMeshInterleaved:
+	case ePODFileMeshFaces:
+	case ePODFileMeshVtx:
+	case ePODFileMeshNor:
+	case ePODFileMeshTan:
+	case ePODFileMeshBin:
+	case ePODFileMeshUVW:
+	case ePODFileMeshVtxCol:
+	case ePODFileMeshBoneIdx:
+	case ePODFileMeshBoneWeight:
+		return true;
+	}
+	return false;
+}
+
 /*!***************************************************************************
  @Function			ReadMesh
  @Modified			s The SPODMesh to read into
  @Input				src	CSource object to read data from.
+ @Input				eRead	Which parts of the mesh to read. ePODReadData
+							needs a mesh already read with ePODReadHeader.
  @Return			true if successful
  @Description		Read a mesh block in from a pod file
 *****************************************************************************/
 static bool ReadMesh(
-	SPODMesh	&s,
-	CSource		&src)
+	SPODMesh			&s,
+	CSource				&src,
+	const EPODBlockRead	eRead = ePODReadAll)
 {
 	unsigned int	nName, nLen;
 	unsigned int	nUVWs=0;
+	const bool		bSkipData = eRead == ePODReadHeader;
 
-	PVRTMatrixIdentity(s.mUnpackMatrix);
+	if(eRead != ePODReadData)
+		PVRTMatrixIdentity(s.mUnpackMatrix);
 
 	while(src.ReadMarker(nName, nLen))
 	{
+		// The header of the mesh is already loaded
+		if(eRead == ePODReadData && nName != (ePODFileMesh | PVRTMODELPOD_TAG_END) && !IsMeshDataBlock(nName))
+		{
+			if(!src.Skip(nLen)) return false;
+			continue;
+		}
+
 		switch(nName)
 		{
 		case ePODFileMesh | PVRTMODELPOD_TAG_END:
@@ -1492,7 +1858,10 @@ static bool ReadMesh(
 		case ePODFileMeshNumUVW:			if(!src.Read32(s.nNumUVW)) return false;	if(!SafeAlloc(s.psUVW, s.nNumUVW)) return false;	break;
 		case ePODFileMeshStripLength:		if(!src.ReadAfterAlloc32(s.pnStripLength, nLen)) return false;								break;
 		case ePODFileMeshNumStrips:			if(!src.Read32(s.nNumStrips)) return false;													break;
-		case ePODFileMeshInterleaved:		if(!src.ReadAfterAlloc(s.pInterleaved, nLen)) return false;									break;
+		case ePODFileMeshInterleaved:
+			if(bSkipData)	{ if(!src.Skip(nLen)) return false; }
+			else			{ if(!src.ReadOrBorrow(s.pInterleaved, nLen, 4)) return false; }
+			break;
 		case ePODFileMeshBoneBatches:		if(!src.ReadAfterAlloc32(s.sBoneBatches.pnBatches, nLen)) return false;						break;
 		case ePODFileMeshBoneBatchBoneCnts:	if(!src.ReadAfterAlloc32(s.sBoneBatches.pnBatchBoneCnt, nLen)) return false;					break;
 		case ePODFileMeshBoneBatchOffsets:	if(!src.ReadAfterAlloc32(s.sBoneBatches.pnBatchOffset, nLen)) return false;					break;
@@ -1500,15 +1869,15 @@ static bool ReadMesh(
 		case ePODFileMeshBoneBatchCnt:		if(!src.Read32(s.sBoneBatches.nBatchCnt)) return false;										break;
 		case ePODFileMeshUnpackMatrix:		if(!src.ReadArray32((unsigned int*)&s.mUnpackMatrix.f[0], 16)) return false;										break;
 
-		case ePODFileMeshFaces:			if(!ReadCPODData(s.sFaces, src, ePODFileMeshFaces, true)) return false;							break;
-		case ePODFileMeshVtx:			if(!ReadCPODData(s.sVertex, src, ePODFileMeshVtx, s.pInterleaved == 0)) return false;			break;
-		case ePODFileMeshNor:			if(!ReadCPODData(s.sNormals, src, ePODFileMeshNor, s.pInterleaved == 0)) return false;			break;
-		case ePODFileMeshTan:			if(!ReadCPODData(s.sTangents, src, ePODFileMeshTan, s.pInterleaved == 0)) return false;			break;
-		case ePODFileMeshBin:			if(!ReadCPODData(s.sBinormals, src, ePODFileMeshBin, s.pInterleaved == 0)) return false;			break;
-		case ePODFileMeshUVW:			if(!ReadCPODData(s.psUVW[nUVWs++], src, ePODFileMeshUVW, s.pInterleaved == 0)) return false;		break;
-		case ePODFileMeshVtxCol:		if(!ReadCPODData(s.sVtxColours, src, ePODFileMeshVtxCol, s.pInterleaved == 0)) return false;		break;
-		case ePODFileMeshBoneIdx:		if(!ReadCPODData(s.sBoneIdx, src, ePODFileMeshBoneIdx, s.pInterleaved == 0)) return false;		break;
-		case ePODFileMeshBoneWeight:	if(!ReadCPODData(s.sBoneWeight, src, ePODFileMeshBoneWeight, s.pInterleaved == 0)) return false;	break;
+		case ePODFileMeshFaces:			if(!ReadCPODData(s.sFaces, src, ePODFileMeshFaces, true, bSkipData)) return false;							break;
+		case ePODFileMeshVtx:			if(!ReadCPODData(s.sVertex, src, ePODFileMeshVtx, s.pInterleaved == 0, bSkipData)) return false;			break;
+		case ePODFileMeshNor:			if(!ReadCPODData(s.sNormals, src, ePODFileMeshNor, s.pInterleaved == 0, bSkipData)) return false;			break;
+		case ePODFileMeshTan:			if(!ReadCPODData(s.sTangents, src, ePODFileMeshTan, s.pInterleaved == 0, bSkipData)) return false;			break;
+		case ePODFileMeshBin:			if(!ReadCPODData(s.sBinormals, src, ePODFileMeshBin, s.pInterleaved == 0, bSkipData)) return false;			break;
+		case ePODFileMeshUVW:			if(!ReadCPODData(s.psUVW[nUVWs++], src, ePODFileMeshUVW, s.pInterleaved == 0, bSkipData)) return false;		break;
+		case ePODFileMeshVtxCol:		if(!ReadCPODData(s.sVtxColours, src, ePODFileMeshVtxCol, s.pInterleaved == 0, bSkipData)) return false;		break;
+		case ePODFileMeshBoneIdx:		if(!ReadCPODData(s.sBoneIdx, src, ePODFileMeshBoneIdx, s.pInterleaved == 0, bSkipData)) return false;		break;
+		case ePODFileMeshBoneWeight:	if(!ReadCPODData(s.sBoneWeight, src, ePODFileMeshBoneWeight, s.pInterleaved == 0, bSkipData)) return false;	break;
 
 		default:
 			if(!src.Skip(nLen)) return false;
@@ -1517,18 +1886,54 @@ static bool ReadMesh(
 	return false;
 }
 
+/*!***************************************************************************
+ @Function			ReadFirstKey
+ @Output			pfKey	The frame 0 key
+ @Input				src		CSource object positioned at the animation
+ @Input				nLen	Size of the animation
+ @Input				nFirst	Index of the first value of the frame 0 key
+ @Input				nStride	Number of values in a key
+ @Return			true if successful
+ @Description		Reads the frame 0 key of a node animation array and skips
+					the other frames.
+*****************************************************************************/
+static bool ReadFirstKey(
+	VERTTYPE			* &pfKey,
+	CSource				&src,
+	const unsigned int	nLen,
+	const unsigned int	nFirst,
+	const unsigned int	nStride)
+{
+	const unsigned int nKeyLen = nStride * sizeof(*pfKey);
+
+	if(nLen <= nKeyLen)
+		return src.ReadAfterAlloc32(pfKey, nLen);
+
+	if(nFirst > (nLen - nKeyLen) / sizeof(*pfKey))
+		return false;
+
+	const unsigned int nSkip = nFirst * sizeof(*pfKey);
+	return src.Skip(nSkip) && src.ReadAfterAlloc32(pfKey, nKeyLen) && src.Skip(nLen - nKeyLen - nSkip);
+}
+
 /*!***************************************************************************
  @Function			ReadNode
  @Modified			s The SPODNode to read into
  @Input				src	CSource object to read data from.
+ @Input				eRead	Which parts of the node to read. With
+							ePODReadHeader, animated nodes only get their
+							frame 0 key; ePODReadData reads the animation
+							alone, into an otherwise empty node.
  @Return			true if successful
  @Description		Read a node block in from a pod file
 *****************************************************************************/
 static bool ReadNode(
-	SPODNode	&s,
-	CSource		&src)
+	SPODNode			&s,
+	CSource				&src,
+	const EPODBlockRead	eRead = ePODReadAll)
 {
 	unsigned int nName, nLen;
+	unsigned int nFirst[4] = {0,0,0,0};
 	bool bOldNodeFormat = false;
 	VERTTYPE fPos[3]   = {0,0,0};
 	VERTTYPE fQuat[4]  = {0,0,0,f2vt(1)};
@@ -1540,6 +1945,43 @@ static bool ReadNode(
 
 	while(src.ReadMarker(nName, nLen))
 	{
+		// The rest of the node is already loaded
+		if(eRead == ePODReadData)
+		{
+			switch(nName)
+			{
+			case ePODFileNodeIdx:
+			case ePODFileNodeName:
+			case ePODFileNodeIdxMat:
+			case ePODFileNodeIdxParent:
+			case ePODFileNodeUserData:
+				if(!src.Skip(nLen)) return false;
+				continue;
+			}
+		}
+
+		// Only the frame 0 key of the animation is wanted
+		if(eRead == ePODReadHeader)
+		{
+			switch(nName)
+			{
+			case ePODFileNodeAnimPosIdx:	case ePODFileNodeAnimRotIdx:
+			case ePODFileNodeAnimScaleIdx:	case ePODFileNodeAnimMatrixIdx:
+				if(nLen >= 4)
+				{
+					if(!src.Read32(nFirst[nName - ePODFileNodeAnimPosIdx])) return false;
+					nLen -= 4;
+				}
+				if(!src.Skip(nLen)) return false;
+				continue;
+
+			case ePODFileNodeAnimPos:		if(!ReadFirstKey(s.pfAnimPosition, src, nLen, nFirst[0], 3)) return false;	continue;
+			case ePODFileNodeAnimRot:		if(!ReadFirstKey(s.pfAnimRotation, src, nLen, nFirst[1], 4)) return false;	continue;
+			case ePODFileNodeAnimScale:		if(!ReadFirstKey(s.pfAnimScale, src, nLen, nFirst[2], 7)) return false;		continue;
+			case ePODFileNodeAnimMatrix:	if(!ReadFirstKey(s.pfAnimMatrix, src, nLen, nFirst[3], 16)) return false;	continue;
+			}
+		}
+
 		switch(nName)
 		{
 		case ePODFileNode | PVRTMODELPOD_TAG_END:
@@ -1577,17 +2019,17 @@ static bool ReadNode(
 		case ePODFileNodeIdxParent:	if(!src.Read32(s.nIdxParent)) return false;						break;
 		case ePODFileNodeAnimFlags:if(!src.Read32(s.nAnimFlags))return false;							break;
 
-		case ePODFileNodeAnimPosIdx:	if(!src.ReadAfterAlloc32(s.pnAnimPositionIdx, nLen)) return false;	break;
-		case ePODFileNodeAnimPos:	if(!src.ReadAfterAlloc32(s.pfAnimPosition, nLen)) return false;	break;
+		case ePODFileNodeAnimPosIdx:	if(!src.ReadOrBorrow32(s.pnAnimPositionIdx, nLen)) return false;	break;
+		case ePODFileNodeAnimPos:	if(!src.ReadOrBorrow32(s.pfAnimPosition, nLen)) return false;	break;
 
-		case ePODFileNodeAnimRotIdx:	if(!src.ReadAfterAlloc32(s.pnAnimRotationIdx, nLen)) return false;	break;
-		case ePODFileNodeAnimRot:	if(!src.ReadAfterAlloc32(s.pfAnimRotation, nLen)) return false;	break;
+		case ePODFileNodeAnimRotIdx:	if(!src.ReadOrBorrow32(s.pnAnimRotationIdx, nLen)) return false;	break;
+		case ePODFileNodeAnimRot:	if(!src.ReadOrBorrow32(s.pfAnimRotation, nLen)) return false;	break;
 
-		case ePODFileNodeAnimScaleIdx:	if(!src.ReadAfterAlloc32(s.pnAnimScaleIdx, nLen)) return false;	break;
-		case ePODFileNodeAnimScale:	if(!src.ReadAfterAlloc32(s.pfAnimScale, nLen)) return false;		break;
+		case ePODFileNodeAnimScaleIdx:	if(!src.ReadOrBorrow32(s.pnAnimScaleIdx, nLen)) return false;	break;
+		case ePODFileNodeAnimScale:	if(!src.ReadOrBorrow32(s.pfAnimScale, nLen)) return false;		break;
 
-		case ePODFileNodeAnimMatrixIdx:	if(!src.ReadAfterAlloc32(s.pnAnimMatrixIdx, nLen)) return false;	break;
-		case ePODFileNodeAnimMatrix:if(!src.ReadAfterAlloc32(s.pfAnimMatrix, nLen)) return false;	break;
+		case ePODFileNodeAnimMatrixIdx:	if(!src.ReadOrBorrow32(s.pnAnimMatrixIdx, nLen)) return false;	break;
+		case ePODFileNodeAnimMatrix:if(!src.ReadOrBorrow32(s.pfAnimMatrix, nLen)) return false;	break;
 
 		case ePODFileNodeUserData:
 			if(!src.ReadAfterAlloc(s.pUserData, nLen))
@@ -1640,81 +2082,306 @@ static bool ReadTexture(
 }
 
 /*!***************************************************************************
- @Function			ReadScene
- @Modified			s The SPODScene to read into
- @Input				src	CSource object to read data from.
+ @Struct			SPODBlock
+ @Brief				A mesh or node block found while scanning a scene, to be
+					decoded later from its own view of the source
+*****************************************************************************/
+struct SPODBlock
+{
+	unsigned int	nName;	/*!< ePODFileMesh or ePODFileNode */
+	void			*pDst;	/*!< The SPODMesh or SPODNode to read into */
+	size_t			nPos;	/*!< Source position just after the block's start marker */
+};
+
+/*!***************************************************************************
+ @Struct			SPODBlockIndex
+ @Brief				The blocks of a scene and the source they came from
+*****************************************************************************/
+struct SPODBlockIndex
+{
+	const CSource	*pSrc;
+	SPODBlock		*pBlock;
+	unsigned int	nNumBlock, nMaxBlock;
+	bool			*pbResult;
+	EPODBlockRead	eRead;	/*!< Which parts of the blocks to decode */
+};
+
+/*!***************************************************************************
+ @Function			SkipBlock
+ @Input				src		CSource object positioned just inside the block
+ @Input				nBlock	The block's name
  @Return			true if successful
- @Description		Read a scene block in from a pod file
+ @Description		Walks the markers of a block up to and including its end
+					marker without decoding anything.
 *****************************************************************************/
-static bool ReadScene(
-	SPODScene	&s,
-	CSource		&src)
+static bool SkipBlock(
+	CSource				&src,
+	const unsigned int	nBlock)
 {
 	unsigned int nName, nLen;
-	unsigned int nCameras=0, nLights=0, nMaterials=0, nMeshes=0, nTextures=0, nNodes=0;
-	s.nFPS = 30;
-
-	// Set default for user data
-	s.pUserData = 0;
-	s.nUserDataSize = 0;
 
 	while(src.ReadMarker(nName, nLen))
 	{
-		switch(nName)
-		{
-		case ePODFileScene | PVRTMODELPOD_TAG_END:
-			if(nCameras		!= s.nNumCamera) return false;
-			if(nLights		!= s.nNumLight) return false;
-			if(nMaterials	!= s.nNumMaterial) return false;
-			if(nMeshes		!= s.nNumMesh) return false;
-			if(nTextures	!= s.nNumTexture) return false;
-			if(nNodes		!= s.nNumNode) return false;
+		if(nName == (nBlock | PVRTMODELPOD_TAG_END))
 			return true;
 
-		case ePODFileColourBackground:	if(!src.ReadArray32((unsigned int*) s.pfColourBackground, sizeof(s.pfColourBackground) / sizeof(*s.pfColourBackground))) return false;	break;
-		case ePODFileColourAmbient:		if(!src.ReadArray32((unsigned int*) s.pfColourAmbient, sizeof(s.pfColourAmbient) / sizeof(*s.pfColourAmbient))) return false;		break;
-		case ePODFileNumCamera:			if(!src.Read32(s.nNumCamera)) return false;			if(!SafeAlloc(s.pCamera, s.nNumCamera)) return false;		break;
-		case ePODFileNumLight:			if(!src.Read32(s.nNumLight)) return false;			if(!SafeAlloc(s.pLight, s.nNumLight)) return false;			break;
-		case ePODFileNumMesh:			if(!src.Read32(s.nNumMesh)) return false;				if(!SafeAlloc(s.pMesh, s.nNumMesh)) return false;			break;
-		case ePODFileNumNode:			if(!src.Read32(s.nNumNode)) return false;				if(!SafeAlloc(s.pNode, s.nNumNode)) return false;			break;
-		case ePODFileNumMeshNode:		if(!src.Read32(s.nNumMeshNode)) return false;			break;
-		case ePODFileNumTexture:		if(!src.Read32(s.nNumTexture)) return false;			if(!SafeAlloc(s.pTexture, s.nNumTexture)) return false;		break;
-		case ePODFileNumMaterial:		if(!src.Read32(s.nNumMaterial)) return false;			if(!SafeAlloc(s.pMaterial, s.nNumMaterial)) return false;	break;
-		case ePODFileNumFrame:			if(!src.Read32(s.nNumFrame)) return false;			break;
-		case ePODFileFPS:				if(!src.Read32(s.nFPS))	return false;				break;
-		case ePODFileFlags:				if(!src.Read32(s.nFlags)) return false;				break;
-
-		case ePODFileCamera:	if(!ReadCamera(s.pCamera[nCameras++], src)) return false;		break;
-		case ePODFileLight:		if(!ReadLight(s.pLight[nLights++], src)) return false;			break;
-		case ePODFileMaterial:	if(!ReadMaterial(s.pMaterial[nMaterials++], src)) return false;	break;
-		case ePODFileMesh:		if(!ReadMesh(s.pMesh[nMeshes++], src)) return false;			break;
-		case ePODFileNode:		if(!ReadNode(s.pNode[nNodes++], src)) return false;				break;
-		case ePODFileTexture:	if(!ReadTexture(s.pTexture[nTextures++], src)) return false;	break;
-
-		case ePODFileUserData:
-			if(!src.ReadAfterAlloc(s.pUserData, nLen))
-				return false;
-			else
-			{
-				s.nUserDataSize = nLen;
-				break;
-			}
-
-		default:
-			if(!src.Skip(nLen)) return false;
-		}
+		if(!src.Skip(nLen))
+			return false;
 	}
 	return false;
 }
 
 /*!***************************************************************************
- @Function			Read
- @Output			pS				SPODScene data. May be NULL.
- @Input				src				CSource object to read data from.
- @Output			pszExpOpt		Export options.
- @Input				count			Data size.
+ @Function			IndexBlock
+ @Modified			index	The block index to add to
+ @Input				src		CSource object positioned just inside the block
+ @Input				nName	The block's name
+ @Input				pDst	Where the block is to be decoded to
+ @Return			true if successful
+ @Description		Records the position of a block and skips over it.
+*****************************************************************************/
+static bool IndexBlock(
+	SPODBlockIndex		&index,
+	CSource				&src,
+	const unsigned int	nName,
+	void				* const pDst)
+{
+	if(index.nNumBlock == index.nMaxBlock)
+	{
+		index.nMaxBlock = PVRT_MAX(index.nMaxBlock * 2, 32u);
+		SafeRealloc(index.pBlock, index.nMaxBlock);
+		if(!index.pBlock)
+			return false;
+	}
+
+	SPODBlock &block = index.pBlock[index.nNumBlock++];
+	block.nName	= nName;
+	block.pDst	= pDst;
+	block.nPos	= src.Tell();
+
+	return SkipBlock(src, nName);
+}
+
+/*!***************************************************************************
+ @Function			DecodeBlock
+ @Input				pUserData	The SPODBlockIndex
+ @Input				ui32Job		Index of the block to decode
+ @Description		PVRTParallelFor job which decodes one indexed block from
+					its own view of the source.
+*****************************************************************************/
+static void DecodeBlock(void *pUserData, const unsigned int ui32Job)
+{
+	SPODBlockIndex	&index = *(SPODBlockIndex*) pUserData;
+	SPODBlock		&block = index.pBlock[ui32Job];
+	CSource			*pView = index.pSrc->CreateView(block.nPos);
+	bool			bRet = false;
+
+	if(pView)
+	{
+		if(block.nName == ePODFileMesh)
+			bRet = ReadMesh(*(SPODMesh*) block.pDst, *pView, index.eRead);
+		else
+			bRet = ReadNode(*(SPODNode*) block.pDst, *pView, index.eRead);
+
+		delete pView;
+	}
+
+	index.pbResult[ui32Job] = bRet;
+}
+
+/*!***************************************************************************
+ @Function			DecodeBlocks
+ @Modified			index	The block index to decode
+ @Return			true if successful
+ @Description		Decodes every indexed block, spread over the available
+					processor cores.
+*****************************************************************************/
+static bool DecodeBlocks(SPODBlockIndex &index)
+{
+	if(!index.nNumBlock)
+		return true;
+
+	if(!SafeAlloc(index.pbResult, index.nNumBlock))
+		return false;
+
+	PVRTParallelFor(DecodeBlock, &index, index.nNumBlock);
+
+	for(unsigned int i = 0; i < index.nNumBlock; ++i)
+	{
+		if(!index.pbResult[i])
+			return false;
+	}
+	return true;
+}
+
+/*!***************************************************************************
+ @Function			ReadSceneBlocks
+ @Modified			s The SPODScene to read into
+ @Input				src	CSource object to read data from.
+ @Modified			pIndex	Block index, or NULL to decode everything in place
+ @Return			true if successful
+ @Description		Read a scene block in from a pod file. If pIndex is
+					supplied, mesh and node blocks are only indexed on this
+					pass and are decoded in parallel once the rest of the
+					scene has been read.
+*****************************************************************************/
+static bool ReadSceneBlocks(
+	SPODScene		&s,
+	CSource			&src,
+	SPODBlockIndex	*pIndex)
+{
+	unsigned int nName, nLen;
+	unsigned int nCameras=0, nLights=0, nMaterials=0, nMeshes=0, nTextures=0, nNodes=0;
+	s.nFPS = 30;
+
+	// Set default for user data
+	s.pUserData = 0;
+	s.nUserDataSize = 0;
+
+	while(src.ReadMarker(nName, nLen))
+	{
+		switch(nName)
+		{
+		case ePODFileScene | PVRTMODELPOD_TAG_END:
+			if(nCameras		!= s.nNumCamera) return false;
+			if(nLights		!= s.nNumLight) return false;
+			if(nMaterials	!= s.nNumMaterial) return false;
+			if(nMeshes		!= s.nNumMesh) return false;
+			if(nTextures	!= s.nNumTexture) return false;
+			if(nNodes		!= s.nNumNode) return false;
+			return pIndex ? DecodeBlocks(*pIndex) : true;
+
+		case ePODFileColourBackground:	if(!src.ReadArray32((unsigned int*) s.pfColourBackground, sizeof(s.pfColourBackground) / sizeof(*s.pfColourBackground))) return false;	break;
+		case ePODFileColourAmbient:		if(!src.ReadArray32((unsigned int*) s.pfColourAmbient, sizeof(s.pfColourAmbient) / sizeof(*s.pfColourAmbient))) return false;		break;
+		case ePODFileNumCamera:			if(!src.Read32(s.nNumCamera)) return false;			if(!SafeAlloc(s.pCamera, s.nNumCamera)) return false;		break;
+		case ePODFileNumLight:			if(!src.Read32(s.nNumLight)) return false;			if(!SafeAlloc(s.pLight, s.nNumLight)) return false;			break;
+		case ePODFileNumMesh:			if(!src.Read32(s.nNumMesh)) return false;				if(!SafeAlloc(s.pMesh, s.nNumMesh)) return false;			break;
+		case ePODFileNumNode:			if(!src.Read32(s.nNumNode)) return false;				if(!SafeAlloc(s.pNode, s.nNumNode)) return false;			break;
+		case ePODFileNumMeshNode:		if(!src.Read32(s.nNumMeshNode)) return false;			break;
+		case ePODFileNumTexture:		if(!src.Read32(s.nNumTexture)) return false;			if(!SafeAlloc(s.pTexture, s.nNumTexture)) return false;		break;
+		case ePODFileNumMaterial:		if(!src.Read32(s.nNumMaterial)) return false;			if(!SafeAlloc(s.pMaterial, s.nNumMaterial)) return false;	break;
+		case ePODFileNumFrame:			if(!src.Read32(s.nNumFrame)) return false;			break;
+		case ePODFileFPS:				if(!src.Read32(s.nFPS))	return false;				break;
+		case ePODFileFlags:				if(!src.Read32(s.nFlags)) return false;				break;
+
+		case ePODFileCamera:	if(!ReadCamera(s.pCamera[nCameras++], src)) return false;		break;
+		case ePODFileLight:		if(!ReadLight(s.pLight[nLights++], src)) return false;			break;
+		case ePODFileMaterial:	if(!ReadMaterial(s.pMaterial[nMaterials++], src)) return false;	break;
+		case ePODFileMesh:
+			if(pIndex)	{ if(!IndexBlock(*pIndex, src, nName, &s.pMesh[nMeshes++])) return false; }
+			else		{ if(!ReadMesh(s.pMesh[nMeshes++], src)) return false; }
+			break;
+		case ePODFileNode:
+			if(pIndex)	{ if(!IndexBlock(*pIndex, src, nName, &s.pNode[nNodes++])) return false; }
+			else		{ if(!ReadNode(s.pNode[nNodes++], src)) return false; }
+			break;
+		case ePODFileTexture:	if(!ReadTexture(s.pTexture[nTextures++], src)) return false;	break;
+
+		case ePODFileUserData:
+			if(!src.ReadAfterAlloc(s.pUserData, nLen))
+				return false;
+			else
+			{
+				s.nUserDataSize = nLen;
+				break;
+			}
+
+		default:
+			if(!src.Skip(nLen)) return false;
+		}
+	}
+	return false;
+}
+
+/*!***************************************************************************
+ @Function			IndexLazyScene
+ @Output			lazy	Where the scene's meshes and node animation are
+ @Modified			s		The scene, with meshes and nodes read with ePODReadHeader
+ @Input				index	The scene's block index
+ @Return			true if successful
+ @Description		Keeps the positions of the mesh and node blocks so that
+					their data can be loaded later. Animated nodes keep their
+					frame 0 key, and are marked as not animated until their
+					animation is loaded.
+*****************************************************************************/
+static bool IndexLazyScene(
+	SPODLazyScene			&lazy,
+	SPODScene				&s,
+	const SPODBlockIndex	&index)
+{
+	const unsigned int nAnimFlags = ePODHasPositionAni | ePODHasRotationAni | ePODHasScaleAni | ePODHasMatrixAni;
+
+	if(!SafeAlloc(lazy.pnMeshPos, s.nNumMesh) || !SafeAlloc(lazy.pbMeshLoaded, s.nNumMesh))
+		return false;
+
+	if(!SafeAlloc(lazy.pnNodePos, s.nNumNode) || !SafeAlloc(lazy.pbNodeLoaded, s.nNumNode))
+		return false;
+
+	for(unsigned int i = 0; i < index.nNumBlock; ++i)
+	{
+		const SPODBlock &block = index.pBlock[i];
+
+		if(block.nName == ePODFileMesh)
+		{
+			lazy.pnMeshPos[(SPODMesh*) block.pDst - s.pMesh] = block.nPos;
+		}
+		else
+		{
+			const unsigned int	nNode	= (unsigned int) ((SPODNode*) block.pDst - s.pNode);
+			SPODNode			&node	= s.pNode[nNode];
+
+			lazy.pnNodePos[nNode]		= block.nPos;
+			lazy.pbNodeLoaded[nNode]	= !(node.nAnimFlags & nAnimFlags);
+			node.nAnimFlags &= ~nAnimFlags;
+		}
+	}
+	return true;
+}
+
+/*!***************************************************************************
+ @Function			ReadScene
+ @Modified			s The SPODScene to read into
+ @Input				src	CSource object to read data from.
+ @Output			pLazy	If not NULL, meshes and node animation are
+							not loaded and their positions are kept here
+ @Return			true if successful
+ @Description		Read a scene block in from a pod file, decoding meshes and
+					nodes in parallel where the source allows it.
+*****************************************************************************/
+static bool ReadScene(
+	SPODScene		&s,
+	CSource			&src,
+	SPODLazyScene	* const pLazy)
+{
+	CSource *pProbe = src.CreateView(0);
+	if(!pProbe)
+		return pLazy ? false : ReadSceneBlocks(s, src, NULL);
+	delete pProbe;
+
+	SPODBlockIndex index;
+	memset(&index, 0, sizeof(index));
+	index.pSrc	= &src;
+	index.eRead	= pLazy ? ePODReadHeader : ePODReadAll;
+
+	bool bRet = ReadSceneBlocks(s, src, &index);
+
+	if(bRet && pLazy)
+		bRet = IndexLazyScene(*pLazy, s, index);
+
+	FREE(index.pBlock);
+	FREE(index.pbResult);
+	return bRet;
+}
+
+/*!***************************************************************************
+ @Function			Read
+ @Output			pS				SPODScene data. May be NULL.
+ @Input				src				CSource object to read data from.
+ @Output			pszExpOpt		Export options.
+ @Input				count			Data size.
  @Output			pszHistory		Export history.
  @Input				historyCount	History data size.
+ @Output			pLazy			If not NULL, the scene is read lazily
  @Description		Loads the specified ".POD" file; returns the scene in
 					pScene. This structure must later be destroyed with
 					PVRTModelPODDestroy() to prevent memory leaks.
@@ -1728,7 +2395,8 @@ static bool Read(
 	char			* const pszExpOpt,
 	const size_t	count,
 	char			* const pszHistory,
-	const size_t	historyCount)
+	const size_t	historyCount,
+	SPODLazyScene	* const pLazy = NULL)
 {
 	unsigned int	nName, nLen;
 	bool			bVersionOK = false, bDone = false;
@@ -1745,17 +2413,16 @@ static bool Read(
 				char *pszVersion = NULL;
 				if(nLen != strlen(PVRTMODELPOD_VERSION)+1) return false;
 				if(!SafeAlloc(pszVersion, nLen)) return false;
-				if(!src.Read(pszVersion, nLen)) return false;
-				if(strcmp(pszVersion, PVRTMODELPOD_VERSION) != 0) return false;
-				bVersionOK = true;
+				bVersionOK = src.Read(pszVersion, nLen) && strcmp(pszVersion, PVRTMODELPOD_VERSION) == 0;
 				FREE(pszVersion);
+				if(!bVersionOK) return false;
 			}
 			continue;
 
 		case ePODFileScene:
 			if(pS)
 			{
-				if(!ReadScene(*pS, src))
+				if(!ReadScene(*pS, src, pLazy))
 					return false;
 				bDone = true;
 			}
@@ -1816,11 +2483,16 @@ static bool Read(
 	*/
 #ifdef PVRT_FIXED_POINT_ENABLE
 	if(!(pS->nFlags & PVRTMODELPODSF_FIXED))
-		PVRTModelPODToggleFixedPoint(*pS);
 #else
 	if(pS->nFlags & PVRTMODELPODSF_FIXED)
-		PVRTModelPODToggleFixedPoint(*pS);
 #endif
+	{
+		PVRTModelPODToggleFixedPoint(*pS);
+
+		// Animation loaded later has to be converted too
+		if(pLazy)
+			pLazy->bConvert = true;
+	}
 
 	return bVersionOK == true && bDone == true;
 }
@@ -1855,388 +2527,2945 @@ static EPVRTError ReadFromSourceStream(
 }
 
 /****************************************************************************
-** Class: CPVRTModelPOD
+** Local code: Hierarchy
 ****************************************************************************/
-
 /*!***************************************************************************
- @Function			ReadFromFile
- @Input				pszFileName		Filename to load
- @Output			pszExpOpt		String in which to place exporter options
- @Input				count			Maximum number of characters to store.
- @Output			pszHistory		String in which to place the pod file history
- @Input				historyCount	Maximum number of characters to store.
- @Return			PVR_SUCCESS if successful, PVR_FAIL if not
- @Description		Loads the specified ".POD" file; returns the scene in
-					pScene. This structure must later be destroyed with
-					PVRTModelPODDestroy() to prevent memory leaks.
-					".POD" files are exported using the PVRGeoPOD exporters.
-					If pszExpOpt is NULL, the scene is loaded; otherwise the
-					scene is not loaded and pszExpOpt is filled in. The same
-					is true for pszHistory.
+ @Function			PODSortNodesByDepth
+ @Input				s				Scene to sort the nodes of
+ @Output			pnOrder			Allocated array of nNumNode node indices,
+									or NULL
+ @Return			true if successful, false if memory ran out
+ @Description		Orders the nodes by their depth in the hierarchy, so that
+					every parent is listed before its children. Nodes of equal
+					depth keep their original order. The array must be freed
+					with FREE().
 *****************************************************************************/
-EPVRTError CPVRTModelPOD::ReadFromFile(
-	const char		* const pszFileName,
-	char			* const pszExpOpt,
-	const size_t	count,
-	char			* const pszHistory,
-	const size_t	historyCount)
+static bool PODSortNodesByDepth(
+	const SPODScene	&s,
+	unsigned int	*&pnOrder)
 {
-	CSourceStream src;
+	unsigned int *pnDepth = 0, *pnCount = 0;
+	unsigned int nMaxDepth = 0;
 
-	if(!src.Init(pszFileName))
-		return PVR_FAIL;
+	pnOrder = 0;
 
-	return ReadFromSourceStream(this, src, pszExpOpt, count, pszHistory, historyCount);
+	if(!s.nNumNode)
+		return true;
+
+	if(!SafeAlloc(pnOrder, s.nNumNode) || !SafeAlloc(pnDepth, s.nNumNode))
+	{
+		FREE(pnOrder);
+		return false;
+	}
+
+	// Depth of each node; a node is one deeper than its parent
+	for(unsigned int i = 0; i < s.nNumNode; ++i)
+	{
+		unsigned int nDepth = 0;
+		for(int nParent = s.pNode[i].nIdxParent; nParent >= 0 && nDepth < s.nNumNode; nParent = s.pNode[nParent].nIdxParent)
+			++nDepth;
+
+		pnDepth[i] = nDepth;
+		nMaxDepth = PVRT_MAX(nMaxDepth, nDepth);
+	}
+
+	// Counting sort by depth
+	if(!SafeAlloc(pnCount, nMaxDepth + 2))
+	{
+		FREE(pnDepth);
+		FREE(pnOrder);
+		return false;
+	}
+
+	for(unsigned int i = 0; i < s.nNumNode; ++i)
+		++pnCount[pnDepth[i] + 1];
+
+	for(unsigned int i = 1; i <= nMaxDepth + 1; ++i)
+		pnCount[i] += pnCount[i - 1];
+
+	for(unsigned int i = 0; i < s.nNumNode; ++i)
+		pnOrder[pnCount[pnDepth[i]]++] = i;
+
+	FREE(pnCount);
+	FREE(pnDepth);
+	return true;
 }
 
 /*!***************************************************************************
- @Function			ReadFromMemory
- @Input				pData			Data to load
- @Input				i32Size			Size of data
- @Output			pszExpOpt		String in which to place exporter options
- @Input				count			Maximum number of characters to store.
- @Output			pszHistory		String in which to place the pod file history
- @Input				historyCount	Maximum number of characters to store.
- @Return			PVR_SUCCESS if successful, PVR_FAIL if not
- @Description		Loads the supplied pod data. This data can be exported
-					directly to a header using one of the pod exporters.
-					If pszExpOpt is NULL, the scene is loaded; otherwise the
-					scene is not loaded and pszExpOpt is filled in. The same
-					is true for pszHistory.
+ @Function			PODGetSkinPalette
+ @Input				s				Scene the mesh node belongs to
+ @Input				impl			Implementation data of the scene
+ @Input				pmWorld			World matrices of all nodes at the wanted frame
+ @Output			pmPalette		Bone matrices of the batch
+ @Input				nMeshNode		Index of the mesh node
+ @Input				nBatch			Bone batch of the mesh
+ @Return			Number of matrices written
+ @Description		Generates the bone world matrix of every bone in a batch,
+					as GetBoneWorldMatrix() would, from the precomputed bind
+					matrices.
 *****************************************************************************/
-EPVRTError CPVRTModelPOD::ReadFromMemory(
-	const char		* pData,
-	const size_t	i32Size,
-	char			* const pszExpOpt,
-	const size_t	count,
-	char			* const pszHistory,
-	const size_t	historyCount)
+static unsigned int PODGetSkinPalette(
+	const SPODScene		&s,
+	const SPVRTPODImpl	&impl,
+	const PVRTMATRIX	* const pmWorld,
+	PVRTMATRIX			* const pmPalette,
+	const unsigned int	nMeshNode,
+	const unsigned int	nBatch)
 {
-	CSourceStream src;
+	_ASSERT(nMeshNode < s.nNumMeshNode);
 
-	if(!src.Init(pData, i32Size))
-		return PVR_FAIL;
+	const CPVRTBoneBatches	&batches	= s.pMesh[s.pNode[nMeshNode].nIdx].sBoneBatches;
+	const unsigned int		nFirst		= nBatch * batches.nBatchBoneMax;
+	const PVRTMATRIX		*pmBind		= &impl.pmBoneBind[impl.pnBoneBindOffset[nMeshNode] + nFirst];
+	const int				*pnBones	= &batches.pnBatches[nFirst];
 
-	return ReadFromSourceStream(this, src, pszExpOpt, count, pszHistory, historyCount);
+	_ASSERT((int) nBatch < batches.nBatchCnt);
+
+	for(int i = 0; i < batches.pnBatchBoneCnt[nBatch]; ++i)
+		PVRTMatrixMultiply(pmPalette[i], pmBind[i], pmWorld[pnBones[i]]);
+
+	return (unsigned int) batches.pnBatchBoneCnt[nBatch];
 }
 
+/****************************************************************************
+** Local code: Cooked scenes
+****************************************************************************/
+
 /*!***************************************************************************
- @Function			ReadFromMemory
- @Input				scene			Scene data from the header file
- @Return			PVR_SUCCESS if successful, PVR_FAIL if not
- @Description		Sets the scene data from the supplied data structure. Use
-					when loading from .H files.
+ @Struct			SPODCookedWriter
+ @Brief				A cooked scene file being built in memory
 *****************************************************************************/
-EPVRTError CPVRTModelPOD::ReadFromMemory(
-	const SPODScene &scene)
+struct SPODCookedWriter
 {
-	Destroy();
-
-	memset(this, 0, sizeof(*this));
+	PVRTuint8		*pData;				/*!< The file so far */
+	size_t			nSize;				/*!< Bytes used */
+	size_t			nCapacity;			/*!< Bytes allocated */
+	PVRTuint32		*pnFixups;			/*!< Offsets of the pointers in the file */
+	unsigned int	nNumFixups;			/*!< Entries used */
+	unsigned int	nFixupCapacity;		/*!< Entries allocated */
+};
 
-	*(SPODScene*)this = scene;
+/*!***************************************************************************
+ @Function			PODCookedLayout
+ @Output			pnLayout		PVRTMODELPOD_COOKED_LAYOUT type sizes
+ @Description		Describes the memory layout a cooked file depends on. A
+					file cooked on a machine with a different layout, such as
+					a 64 bit rather than a 32 bit one, cannot be loaded.
+*****************************************************************************/
+static void PODCookedLayout(PVRTuint16 * const pnLayout)
+{
+	pnLayout[0] = (PVRTuint16) sizeof(void*);
+	pnLayout[1] = (PVRTuint16) sizeof(VERTTYPE);
+	pnLayout[2] = (PVRTuint16) sizeof(CPODData);
+	pnLayout[3] = (PVRTuint16) sizeof(SPODCamera);
+	pnLayout[4] = (PVRTuint16) sizeof(SPODLight);
+	pnLayout[5] = (PVRTuint16) sizeof(SPODMesh);
+	pnLayout[6] = (PVRTuint16) sizeof(SPODNode);
+	pnLayout[7] = (PVRTuint16) sizeof(SPODTexture);
+	pnLayout[8] = (PVRTuint16) sizeof(SPODMaterial);
+	pnLayout[9] = (PVRTuint16) sizeof(SPODScene);
+}
 
-	if(InitImpl() != PVR_SUCCESS)
-		return PVR_FAIL;
+/*!***************************************************************************
+ @Function			PODCookedSource
+ @Input				pszFileName		The POD file a scene is cooked from
+ @Output			sHeader			Header to store its size and time in
+ @Return			false if the file cannot be found
+ @Description		Records the size and modification time of the POD file a
+					cooked scene comes from, so that a cooked file left over
+					from an older version of it can be told apart.
+*****************************************************************************/
+static bool PODCookedSource(const char * const pszFileName, SPODCookedHeader &sHeader)
+{
+	struct stat sStat;
 
-	m_pImpl->bFromMemory = true;
+	if(stat(pszFileName, &sStat) != 0)
+		return false;
 
-	return PVR_SUCCESS;
+	sHeader.nSourceTime	= (PVRTuint64) sStat.st_mtime;
+	sHeader.nSourceSize	= (PVRTuint32) sStat.st_size;
+	return true;
 }
 
 /*!***************************************************************************
- @Function			CopyFromMemory
- @Input				scene			Scene data
- @Return			PVR_SUCCESS if successful, PVR_FAIL if not
- @Description		Sets the scene data from the supplied data structure.
+ @Function			PODCookedAlloc
+ @Modified			w				Writer
+ @Input				nBytes			Size of the block
+ @Input				nAlign			Alignment of the block
+ @Return			Offset of the zeroed block, or 0 if out of memory
 *****************************************************************************/
-EPVRTError CPVRTModelPOD::CopyFromMemory(const SPODScene &scene)
+static size_t PODCookedAlloc(SPODCookedWriter &w, const size_t nBytes, const size_t nAlign)
 {
-	Destroy();
+	const size_t nOffset = (w.nSize + nAlign - 1) / nAlign * nAlign;
 
-	unsigned int i;
+	if(nOffset + nBytes > w.nCapacity)
+	{
+		size_t nCapacity = PVRT_MAX(w.nCapacity * 2, (size_t) 4096);
+		while(nCapacity < nOffset + nBytes)
+			nCapacity *= 2;
 
-	// SPODScene
-	nNumFrame	= scene.nNumFrame;
-	nFPS		= scene.nFPS;
-	nFlags		= scene.nFlags;
+		PVRTuint8 * const pData = (PVRTuint8*) realloc(w.pData, nCapacity);
+		if(!pData)
+			return 0;
 
-	for(i = 0; i < 3; ++i)
-	{
-		pfColourBackground[i] = scene.pfColourBackground[i];
-		pfColourAmbient[i]	  = scene.pfColourAmbient[i];
+		memset(pData + w.nCapacity, 0, nCapacity - w.nCapacity);
+		w.pData		= pData;
+		w.nCapacity	= nCapacity;
 	}
 
-	// Nodes
-	if(scene.nNumNode && SafeAlloc(pNode, sizeof(SPODNode) * scene.nNumNode))
-	{
-		nNumNode     = scene.nNumNode;
-		nNumMeshNode = scene.nNumMeshNode;
+	w.nSize = nOffset + nBytes;
+	return nOffset;
+}
 
-		for(i = 0; i < nNumNode; ++i)
-			PVRTModelPODCopyNode(scene.pNode[i], pNode[i], scene.nNumFrame);
-	}
+/*!***************************************************************************
+ @Function			PODCookedArray
+ @Modified			w				Writer
+ @Input				nSlot			Offset of a pointer in the file
+ @Input				pSrc			Array the pointer should point to
+ @Input				nBytes			Size of the array
+ @Input				nAlign			Alignment of the array
+ @Return			Offset of the copy of the array, 0 if there is no array,
+					or -1 if out of memory
+ @Description		Copies an array into the file, and sets the pointer at
+					nSlot to its offset. A missing or empty array sets the
+					pointer to NULL.
+*****************************************************************************/
+static size_t PODCookedArray(
+	SPODCookedWriter	&w,
+	const size_t		nSlot,
+	const void			* const pSrc,
+	const size_t		nBytes,
+	const size_t		nAlign = PVRTMODELPOD_COOKED_ALIGN)
+{
+	void *pOffset = 0;
 
-	// Meshes
-	if(scene.nNumMesh && SafeAlloc(pMesh, sizeof(SPODMesh) * scene.nNumMesh))
+	if(pSrc && nBytes)
 	{
-		nNumMesh = scene.nNumMesh;
+		const size_t nOffset = PODCookedAlloc(w, nBytes, nAlign);
+		if(!nOffset)
+			return (size_t) -1;
 
-		for(i = 0; i < nNumMesh; ++i)
-			PVRTModelPODCopyMesh(scene.pMesh[i], pMesh[i]);
+		if(w.nNumFixups == w.nFixupCapacity)
+		{
+			const unsigned int nCapacity = PVRT_MAX(w.nFixupCapacity * 2, 256u);
+			PVRTuint32 * const pnFixups = (PVRTuint32*) realloc(w.pnFixups, nCapacity * sizeof(*pnFixups));
+			if(!pnFixups)
+				return (size_t) -1;
+
+			w.pnFixups			= pnFixups;
+			w.nFixupCapacity	= nCapacity;
+		}
+
+		memcpy(w.pData + nOffset, pSrc, nBytes);
+		w.pnFixups[w.nNumFixups++] = (PVRTuint32) nSlot;
+		pOffset = (void*) nOffset;
 	}
 
+	memcpy(w.pData + nSlot, &pOffset, sizeof(pOffset));
+	return (size_t) pOffset;
+}
+
+/*!***************************************************************************
+ @Function			PODCookedString
+ @Modified			w				Writer
+ @Input				nSlot			Offset of a pointer in the file
+ @Input				psz				String the pointer should point to
+ @Return			false if out of memory
+*****************************************************************************/
+static bool PODCookedString(SPODCookedWriter &w, const size_t nSlot, const char * const psz)
+{
+	return PODCookedArray(w, nSlot, psz, psz ? strlen(psz) + 1 : 0, 1) != (size_t) -1;
+}
+
+/*!***************************************************************************
+ @Function			PODCookedData
+ @Modified			w				Writer
+ @Input				nSlot			Offset of a CPODData in the file
+ @Input				data			The CPODData
+ @Input				nEntries		Number of entries of the array
+ @Return			false if out of memory
+*****************************************************************************/
+static bool PODCookedData(SPODCookedWriter &w, const size_t nSlot, const CPODData &data, const unsigned int nEntries)
+{
+	return PODCookedArray(w, nSlot + offsetof(CPODData, pData), data.pData, nEntries * data.nStride) != (size_t) -1;
+}
+
+/*!***************************************************************************
+ @Function			PODCookedAnim
+ @Modified			w				Writer
+ @Input				nSlot			Offset of the node in the file
+ @Input				nIdxSlot		Offset of the animation index pointer in the node
+ @Input				nDataSlot		Offset of the animation data pointer in the node
+ @Input				pnIdx			Animation indices of the node
+ @Input				pfData			Animation data of the node
+ @Input				bAnimated		Whether the node has this kind of animation
+ @Input				nNumFrame		Number of frames of the scene
+ @Input				nComponents		Values per frame
+ @Return			false if out of memory
+*****************************************************************************/
+static bool PODCookedAnim(
+	SPODCookedWriter	&w,
+	const size_t		nSlot,
+	const size_t		nIdxSlot,
+	const size_t		nDataSlot,
+	PVRTuint32			* const pnIdx,
+	const VERTTYPE		* const pfData,
+	const bool			bAnimated,
+	const unsigned int	nNumFrame,
+	const unsigned int	nComponents)
+{
+	const unsigned int nValues = bAnimated ? PVRTModelPODGetAnimArraySize(pnIdx, nNumFrame, nComponents) : nComponents;
+
+	if(PODCookedArray(w, nSlot + nIdxSlot, pnIdx, pnIdx ? nNumFrame * sizeof(*pnIdx) : 0) == (size_t) -1)
+		return false;
+
+	return PODCookedArray(w, nSlot + nDataSlot, pfData, nValues * sizeof(*pfData)) != (size_t) -1;
+}
+
+/*!***************************************************************************
+ @Function			PODCookScene
+ @Modified			w				Writer, with room for the header reserved
+ @Input				s				Scene to cook
+ @Return			Offset of the scene in the file, or 0 if out of memory
+ @Description		Copies the scene structures and arrays into the file.
+*****************************************************************************/
+static size_t PODCookScene(SPODCookedWriter &w, const SPODScene &s)
+{
+	const size_t nScene = PODCookedAlloc(w, sizeof(s), PVRTMODELPOD_COOKED_ALIGN);
+	size_t nArray;
+	unsigned int i, j;
+
+	if(!nScene)
+		return 0;
+
+	memcpy(w.pData + nScene, &s, sizeof(s));
+
+	if(PODCookedArray(w, nScene + offsetof(SPODScene, pUserData), s.pUserData, s.nUserDataSize) == (size_t) -1)
+		return 0;
+
 	// Cameras
-	if(scene.nNumCamera && SafeAlloc(pCamera, sizeof(SPODCamera) * scene.nNumCamera))
+	nArray = PODCookedArray(w, nScene + offsetof(SPODScene, pCamera), s.pCamera, s.nNumCamera * sizeof(*s.pCamera));
+	if(nArray == (size_t) -1)
+		return 0;
+
+	for(i = 0; i < s.nNumCamera; ++i)
 	{
-		nNumCamera = scene.nNumCamera;
+		const size_t nSlot = nArray + i * sizeof(*s.pCamera);
 
-		for(i = 0; i < nNumCamera; ++i)
-			PVRTModelPODCopyCamera(scene.pCamera[i], pCamera[i], scene.nNumFrame);
+		if(PODCookedArray(w, nSlot + offsetof(SPODCamera, pfAnimFOV), s.pCamera[i].pfAnimFOV, s.nNumFrame * sizeof(VERTTYPE)) == (size_t) -1)
+			return 0;
 	}
 
 	// Lights
-	if(scene.nNumLight && SafeAlloc(pLight, sizeof(SPODLight) * scene.nNumLight))
+	if(PODCookedArray(w, nScene + offsetof(SPODScene, pLight), s.pLight, s.nNumLight * sizeof(*s.pLight)) == (size_t) -1)
+		return 0;
+
+	// Meshes
+	nArray = PODCookedArray(w, nScene + offsetof(SPODScene, pMesh), s.pMesh, s.nNumMesh * sizeof(*s.pMesh));
+	if(nArray == (size_t) -1)
+		return 0;
+
+	for(i = 0; i < s.nNumMesh; ++i)
 	{
-		nNumLight = scene.nNumLight;
+		const SPODMesh	&mesh	= s.pMesh[i];
+		const size_t	nSlot	= nArray + i * sizeof(mesh);
+		const int		nBones	= mesh.sBoneBatches.nBatchBoneMax * mesh.sBoneBatches.nBatchCnt;
+		size_t			nUVW;
 
-		for(i = 0; i < nNumLight; ++i)
-			PVRTModelPODCopyLight(scene.pLight[i], pLight[i]);
+		if(!PODCookedData(w, nSlot + offsetof(SPODMesh, sFaces), mesh.sFaces, PVRTModelPODCountIndices(mesh)))
+			return 0;
+
+		if(PODCookedArray(w, nSlot + offsetof(SPODMesh, pnStripLength), mesh.pnStripLength, mesh.nNumStrips * sizeof(*mesh.pnStripLength)) == (size_t) -1)
+			return 0;
+
+		nUVW = PODCookedArray(w, nSlot + offsetof(SPODMesh, psUVW), mesh.psUVW, mesh.nNumUVW * sizeof(*mesh.psUVW));
+		if(nUVW == (size_t) -1)
+			return 0;
+
+		if(mesh.pInterleaved)
+		{
+			// The vertex arrays hold offsets into the interleaved data, which are kept as they are
+			if(PODCookedArray(w, nSlot + offsetof(SPODMesh, pInterleaved), mesh.pInterleaved, mesh.nNumVertex * mesh.sVertex.nStride) == (size_t) -1)
+				return 0;
+		}
+		else
+		{
+			if(!PODCookedData(w, nSlot + offsetof(SPODMesh, sVertex),		mesh.sVertex,		mesh.nNumVertex)
+			|| !PODCookedData(w, nSlot + offsetof(SPODMesh, sNormals),		mesh.sNormals,		mesh.nNumVertex)
+			|| !PODCookedData(w, nSlot + offsetof(SPODMesh, sTangents),		mesh.sTangents,		mesh.nNumVertex)
+			|| !PODCookedData(w, nSlot + offsetof(SPODMesh, sBinormals),	mesh.sBinormals,	mesh.nNumVertex)
+			|| !PODCookedData(w, nSlot + offsetof(SPODMesh, sVtxColours),	mesh.sVtxColours,	mesh.nNumVertex)
+			|| !PODCookedData(w, nSlot + offsetof(SPODMesh, sBoneIdx),		mesh.sBoneIdx,		mesh.nNumVertex)
+			|| !PODCookedData(w, nSlot + offsetof(SPODMesh, sBoneWeight),	mesh.sBoneWeight,	mesh.nNumVertex))
+				return 0;
+
+			for(j = 0; j < mesh.nNumUVW; ++j)
+			{
+				if(!PODCookedData(w, nUVW + j * sizeof(*mesh.psUVW), mesh.psUVW[j], mesh.nNumVertex))
+					return 0;
+			}
+		}
+
+		const size_t nBatches = nSlot + offsetof(SPODMesh, sBoneBatches);
+
+		if(PODCookedArray(w, nBatches + offsetof(CPVRTBoneBatches, pnBatches), mesh.sBoneBatches.pnBatches, nBones * sizeof(int)) == (size_t) -1
+		|| PODCookedArray(w, nBatches + offsetof(CPVRTBoneBatches, pnBatchBoneCnt), mesh.sBoneBatches.pnBatchBoneCnt, mesh.sBoneBatches.nBatchCnt * sizeof(int)) == (size_t) -1
+		|| PODCookedArray(w, nBatches + offsetof(CPVRTBoneBatches, pnBatchOffset), mesh.sBoneBatches.pnBatchOffset, mesh.sBoneBatches.nBatchCnt * sizeof(int)) == (size_t) -1)
+			return 0;
 	}
 
-	// Textures
-	if(scene.nNumTexture && SafeAlloc(pTexture, sizeof(SPODTexture) * scene.nNumTexture))
+	// Nodes
+	nArray = PODCookedArray(w, nScene + offsetof(SPODScene, pNode), s.pNode, s.nNumNode * sizeof(*s.pNode));
+	if(nArray == (size_t) -1)
+		return 0;
+
+	for(i = 0; i < s.nNumNode; ++i)
 	{
-		nNumTexture = scene.nNumTexture;
+		const SPODNode	&node	= s.pNode[i];
+		const size_t	nSlot	= nArray + i * sizeof(node);
+
+		if(!PODCookedString(w, nSlot + offsetof(SPODNode, pszName), node.pszName)
+		|| !PODCookedAnim(w, nSlot, offsetof(SPODNode, pnAnimPositionIdx), offsetof(SPODNode, pfAnimPosition), node.pnAnimPositionIdx, node.pfAnimPosition, (node.nAnimFlags & ePODHasPositionAni) != 0, s.nNumFrame, 3)
+		|| !PODCookedAnim(w, nSlot, offsetof(SPODNode, pnAnimRotationIdx), offsetof(SPODNode, pfAnimRotation), node.pnAnimRotationIdx, node.pfAnimRotation, (node.nAnimFlags & ePODHasRotationAni) != 0, s.nNumFrame, 4)
+		|| !PODCookedAnim(w, nSlot, offsetof(SPODNode, pnAnimScaleIdx), offsetof(SPODNode, pfAnimScale), node.pnAnimScaleIdx, node.pfAnimScale, (node.nAnimFlags & ePODHasScaleAni) != 0, s.nNumFrame, 7)
+		|| !PODCookedAnim(w, nSlot, offsetof(SPODNode, pnAnimMatrixIdx), offsetof(SPODNode, pfAnimMatrix), node.pnAnimMatrixIdx, node.pfAnimMatrix, (node.nAnimFlags & ePODHasMatrixAni) != 0, s.nNumFrame, 16))
+			return 0;
+
+		if(PODCookedArray(w, nSlot + offsetof(SPODNode, pUserData), node.pUserData, node.nUserDataSize) == (size_t) -1)
+			return 0;
+	}
 
-		for(i = 0; i < nNumTexture; ++i)
-			PVRTModelPODCopyTexture(scene.pTexture[i], pTexture[i]);
+	// Textures
+	nArray = PODCookedArray(w, nScene + offsetof(SPODScene, pTexture), s.pTexture, s.nNumTexture * sizeof(*s.pTexture));
+	if(nArray == (size_t) -1)
+		return 0;
+
+	for(i = 0; i < s.nNumTexture; ++i)
+	{
+		if(!PODCookedString(w, nArray + i * sizeof(*s.pTexture) + offsetof(SPODTexture, pszName), s.pTexture[i].pszName))
+			return 0;
 	}
 
 	// Materials
-	if(scene.nNumMaterial && SafeAlloc(pMaterial, sizeof(SPODMaterial) * scene.nNumMaterial))
+	nArray = PODCookedArray(w, nScene + offsetof(SPODScene, pMaterial), s.pMaterial, s.nNumMaterial * sizeof(*s.pMaterial));
+	if(nArray == (size_t) -1)
+		return 0;
+
+	for(i = 0; i < s.nNumMaterial; ++i)
 	{
-		nNumMaterial = scene.nNumMaterial;
+		const SPODMaterial	&mat	= s.pMaterial[i];
+		const size_t		nSlot	= nArray + i * sizeof(mat);
 
-		for(i = 0; i < nNumMaterial; ++i)
-			PVRTModelPODCopyMaterial(scene.pMaterial[i], pMaterial[i]);
-	}
+		if(!PODCookedString(w, nSlot + offsetof(SPODMaterial, pszName), mat.pszName)
+		|| !PODCookedString(w, nSlot + offsetof(SPODMaterial, pszEffectFile), mat.pszEffectFile)
+		|| !PODCookedString(w, nSlot + offsetof(SPODMaterial, pszEffectName), mat.pszEffectName))
+			return 0;
 
-	if(scene.pUserData && SafeAlloc(pUserData, scene.nUserDataSize))
-	{
-		memcpy(pUserData, scene.pUserData, nUserDataSize);
-		nUserDataSize = scene.nUserDataSize;
+		if(PODCookedArray(w, nSlot + offsetof(SPODMaterial, pUserData), mat.pUserData, mat.nUserDataSize) == (size_t) -1)
+			return 0;
 	}
 
-	if(InitImpl() != PVR_SUCCESS)
-		return PVR_FAIL;
-
-	return PVR_SUCCESS;
+	return nScene;
 }
 
-#if defined(WIN32) && !defined(__BADA__)
 /*!***************************************************************************
- @Function			ReadFromResource
- @Input				pszName			Name of the resource to load from
- @Return			PVR_SUCCESS if successful, PVR_FAIL if not
- @Description		Loads the specified ".POD" file; returns the scene in
-					pScene. This structure must later be destroyed with
-					PVRTModelPODDestroy() to prevent memory leaks.
-					".POD" files are exported from 3D Studio MAX using a
-					PowerVR plugin.
+ @Function			PODCookedHasArray
+ @Input				pData			A fixed up cooked file in memory
+ @Input				nSize			Size of the file
+ @Input				p				Array pointer read from the file
+ @Input				nCount			Number of entries the scene gives the array
+ @Input				nEntrySize		Size of an entry
+ @Input				nAlign			Alignment of the array in the file
+ @Return			true if the array lies within the file, or is NULL and empty
 *****************************************************************************/
-EPVRTError CPVRTModelPOD::ReadFromResource(
-	const TCHAR * const pszName)
+static bool PODCookedHasArray(
+	const PVRTuint8	* const pData,
+	const size_t	nSize,
+	const void		* const p,
+	const size_t	nCount,
+	const size_t	nEntrySize,
+	const size_t	nAlign = PVRTMODELPOD_COOKED_ALIGN)
 {
-	CSourceResource src;
+	if(!p)
+		return nCount == 0;
 
-	if(!src.Init(pszName))
-		return PVR_FAIL;
+	// A pointer missing from the offset table would still hold its offset
+	if((const PVRTuint8*) p < pData || (const PVRTuint8*) p >= pData + nSize)
+		return false;
 
-	memset(this, 0, sizeof(*this));
-	if(!Read(this, src, NULL, 0, NULL, 0))
-		return PVR_FAIL;
-	if(InitImpl() != PVR_SUCCESS)
-		return PVR_FAIL;
-	return PVR_SUCCESS;
+	const size_t nOffset = (const PVRTuint8*) p - pData;
+
+	if(nOffset % nAlign)
+		return false;
+
+	return !nEntrySize || nCount <= (nSize - nOffset) / nEntrySize;
 }
-#endif /* WIN32 */
 
-/*!***********************************************************************
- @Function		InitImpl
- @Description	Used by the Read*() fns to initialise implementation
-				details. Should also be called by applications which
-				manually build data in the POD structures for rendering;
-				in this case call it after the data has been created.
-				Otherwise, do not call this function.
-*************************************************************************/
-EPVRTError CPVRTModelPOD::InitImpl()
+/*!***************************************************************************
+ @Function			PODCookedHasString
+ @Input				pData			A fixed up cooked file in memory
+ @Input				nSize			Size of the file
+ @Input				psz				String pointer read from the file
+ @Return			true if the string is NULL, or ends within the file
+*****************************************************************************/
+static bool PODCookedHasString(const PVRTuint8 * const pData, const size_t nSize, const char * const psz)
 {
-	// Allocate space for implementation data
-	delete m_pImpl;
-	m_pImpl = new SPVRTPODImpl;
-	if(!m_pImpl)
-		return PVR_FAIL;
+	if(!psz)
+		return true;
 
-	// Zero implementation data
-	memset(m_pImpl, 0, sizeof(*m_pImpl));
+	if(!PODCookedHasArray(pData, nSize, psz, 1, 1, 1))
+		return false;
 
-#ifdef _DEBUG
-	m_pImpl->nWmTotal = 0;
-#endif
+	return memchr(psz, 0, pData + nSize - (const PVRTuint8*) psz) != 0;
+}
 
-	// Allocate world-matrix cache
-	m_pImpl->pfCache		= new VERTTYPE[nNumNode];
-	m_pImpl->pWmCache		= new PVRTMATRIX[nNumNode];
-	m_pImpl->pWmZeroCache	= new PVRTMATRIX[nNumNode];
-	FlushCache();
+/*!***************************************************************************
+ @Function			PODCookedIsIndex
+ @Input				n				Index read from the file
+ @Input				nCount			Number of objects it indexes
+ @Return			true if the index is -1, for none, or a valid index
+*****************************************************************************/
+static bool PODCookedIsIndex(const PVRTint32 n, const PVRTuint32 nCount)
+{
+	return n == -1 || (n >= 0 && (PVRTuint32) n < nCount);
+}
 
-	return PVR_SUCCESS;
+/*!***************************************************************************
+ @Function			PODCookedIsDataType
+ @Input				eType			Data type read from the file
+ @Return			true if the type is one of EPVRTDataType, other than none
+*****************************************************************************/
+static bool PODCookedIsDataType(const EPVRTDataType &eType)
+{
+	// Read as an integer, since the file may hold any value
+	PVRTuint32 nType;
+
+	memcpy(&nType, &eType, sizeof(nType));
+	return nType > EPODDataNone && nType <= EPODDataUnsignedInt;
 }
 
-/*!***********************************************************************
- @Function		DestroyImpl
- @Description	Used to free memory allocated by the implementation.
-*************************************************************************/
-void CPVRTModelPOD::DestroyImpl()
+/*!***************************************************************************
+ @Function			PODCookedHasData
+ @Input				pData			A fixed up cooked file in memory
+ @Input				nSize			Size of the file
+ @Input				mesh			Mesh holding the vertex data
+ @Input				data			Vertex data to check
+ @Return			true if every vertex of the data lies within the file
+*****************************************************************************/
+static bool PODCookedHasData(const PVRTuint8 * const pData, const size_t nSize, const SPODMesh &mesh, const CPODData &data)
 {
-	if(m_pImpl)
-	{
-		if(m_pImpl->pfCache)		delete [] m_pImpl->pfCache;
-		if(m_pImpl->pWmCache)		delete [] m_pImpl->pWmCache;
-		if(m_pImpl->pWmZeroCache)	delete [] m_pImpl->pWmZeroCache;
+	if(!data.n)
+		return true;
 
-		delete m_pImpl;
-		m_pImpl = 0;
-	}
+	if(!PODCookedIsDataType(data.eType) || data.n > 16)
+		return false;
+
+	const size_t nBytes = PVRTModelPODDataStride(data);
+
+	// Interleaved data holds offsets into pInterleaved, whose extent is checked with the mesh
+	if(mesh.pInterleaved)
+		return data.nStride == mesh.sVertex.nStride && (size_t) data.pData <= data.nStride && nBytes <= data.nStride - (size_t) data.pData;
+
+	return data.pData && data.nStride >= nBytes && PODCookedHasArray(pData, nSize, data.pData, mesh.nNumVertex, data.nStride);
 }
 
-/*!***********************************************************************
- @Function		FlushCache
- @Description	Clears the matrix cache; use this if necessary when you
-				edit the position or animation of a node.
-*************************************************************************/
-void CPVRTModelPOD::FlushCache()
+/*!***************************************************************************
+ @Function			PODCookedHasAnim
+ @Input				pData			A fixed up cooked file in memory
+ @Input				nSize			Size of the file
+ @Input				pnIdx			Animation indices of a node
+ @Input				pfData			Animation data of the node
+ @Input				bAnimated		Whether the node has this kind of animation
+ @Input				nNumFrame		Number of frames of the scene
+ @Input				nComponents		Values per frame
+ @Return			true if every frame of the animation lies within the file
+*****************************************************************************/
+static bool PODCookedHasAnim(
+	const PVRTuint8		* const pData,
+	const size_t		nSize,
+	const PVRTuint32	* const pnIdx,
+	const VERTTYPE		* const pfData,
+	const bool			bAnimated,
+	const unsigned int	nNumFrame,
+	const unsigned int	nComponents)
 {
-	// Pre-calc frame zero matrices
-	SetFrame(0);
-	for(unsigned int i = 0; i < nNumNode; ++i)
-		GetWorldMatrixNoCache(m_pImpl->pWmZeroCache[i], pNode[i]);
+	if(!PODCookedHasArray(pData, nSize, pnIdx, pnIdx ? nNumFrame : 0, sizeof(*pnIdx)))
+		return false;
 
-	// Load cache with frame-zero data
-	memcpy(m_pImpl->pWmCache, m_pImpl->pWmZeroCache, nNumNode * sizeof(*m_pImpl->pWmCache));
-	memset(m_pImpl->pfCache, 0, nNumNode * sizeof(*m_pImpl->pfCache));
+	// Nodes without this kind of transformation have no data
+	if(!pfData)
+		return true;
+
+	if(!PODCookedHasArray(pData, nSize, pfData, nComponents, sizeof(*pfData)))
+		return false;
+
+	const size_t nValues = (pData + nSize - (const PVRTuint8*) pfData) / sizeof(*pfData);
+
+	if(!bAnimated)
+		return true;
+
+	if(!pnIdx)
+		return nNumFrame <= nValues / nComponents;
+
+	for(unsigned int i = 0; i < nNumFrame; ++i)
+	{
+		if(pnIdx[i] > nValues - nComponents)
+			return false;
+	}
+
+	return true;
 }
 
-/*!***********************************************************************
- @Function		IsLoaded
- @Description	Boolean to check whether a POD file has been loaded.
-*************************************************************************/
-bool CPVRTModelPOD::IsLoaded()
+/*!***************************************************************************
+ @Function			PODCookedCheckMesh
+ @Input				pData			A fixed up cooked file in memory
+ @Input				nSize			Size of the file
+ @Input				s				The scene
+ @Input				mesh			Mesh of the scene to check
+ @Return			true if the arrays of the mesh lie within the file, and its
+					indices and bone batches are within the scene
+*****************************************************************************/
+static bool PODCookedCheckMesh(const PVRTuint8 * const pData, const size_t nSize, const SPODScene &s, const SPODMesh &mesh)
 {
-	return (m_pImpl!=NULL);
+	const CPVRTBoneBatches	&batches = mesh.sBoneBatches;
+	unsigned int			i;
+
+	if(!PODCookedHasArray(pData, nSize, mesh.pnStripLength, mesh.nNumStrips, sizeof(*mesh.pnStripLength))
+	|| !PODCookedHasArray(pData, nSize, mesh.psUVW, mesh.nNumUVW, sizeof(*mesh.psUVW)))
+		return false;
+
+	if(mesh.pInterleaved && !PODCookedHasArray(pData, nSize, mesh.pInterleaved, mesh.nNumVertex, mesh.sVertex.nStride))
+		return false;
+
+	if(!PODCookedHasData(pData, nSize, mesh, mesh.sVertex)
+	|| !PODCookedHasData(pData, nSize, mesh, mesh.sNormals)
+	|| !PODCookedHasData(pData, nSize, mesh, mesh.sTangents)
+	|| !PODCookedHasData(pData, nSize, mesh, mesh.sBinormals)
+	|| !PODCookedHasData(pData, nSize, mesh, mesh.sVtxColours)
+	|| !PODCookedHasData(pData, nSize, mesh, mesh.sBoneIdx)
+	|| !PODCookedHasData(pData, nSize, mesh, mesh.sBoneWeight))
+		return false;
+
+	for(i = 0; i < mesh.nNumUVW; ++i)
+	{
+		if(!PODCookedHasData(pData, nSize, mesh, mesh.psUVW[i]))
+			return false;
+	}
+
+	// Strips must cover the triangles of the mesh exactly
+	if(mesh.nNumStrips)
+	{
+		PVRTuint32 nStripFaces = 0;
+
+		for(i = 0; i < mesh.nNumStrips; ++i)
+		{
+			if(mesh.pnStripLength[i] > mesh.nNumFaces - nStripFaces)
+				return false;
+
+			nStripFaces += mesh.pnStripLength[i];
+		}
+
+		if(nStripFaces != mesh.nNumFaces)
+			return false;
+	}
+
+	// Every index must name a vertex of the mesh
+	if(mesh.sFaces.n)
+	{
+		if(mesh.sFaces.n != 1 || !PODCookedIsDataType(mesh.sFaces.eType)
+		|| (mesh.sFaces.eType != EPODDataUnsignedShort && mesh.sFaces.eType != EPODDataUnsignedInt))
+			return false;
+
+		if(mesh.nNumFaces > 0x3FFFFFFF)
+			return false;
+
+		const unsigned int nIndices = PVRTModelPODCountIndices(mesh);
+
+		if(!PODCookedHasArray(pData, nSize, mesh.sFaces.pData, nIndices, PVRTModelPODDataStride(mesh.sFaces)))
+			return false;
+
+		for(i = 0; i < nIndices; ++i)
+		{
+			const PVRTuint32 nIdx = mesh.sFaces.eType == EPODDataUnsignedShort ? ((PVRTuint16*) mesh.sFaces.pData)[i] : ((PVRTuint32*) mesh.sFaces.pData)[i];
+
+			if(nIdx >= mesh.nNumVertex)
+				return false;
+		}
+	}
+
+	// Bone batches
+	if(batches.nBatchCnt < 0 || batches.nBatchBoneMax < 0 || (size_t) batches.nBatchBoneMax > nSize / sizeof(int))
+		return false;
+
+	if(!PODCookedHasArray(pData, nSize, batches.pnBatchBoneCnt, batches.nBatchCnt, sizeof(int))
+	|| !PODCookedHasArray(pData, nSize, batches.pnBatchOffset, batches.nBatchCnt, sizeof(int))
+	|| !PODCookedHasArray(pData, nSize, batches.pnBatches, batches.nBatchBoneMax ? batches.nBatchCnt : 0, batches.nBatchBoneMax * sizeof(int)))
+		return false;
+
+	for(int j = 0; j < batches.nBatchCnt; ++j)
+	{
+		if(batches.pnBatchBoneCnt[j] < 0 || batches.pnBatchBoneCnt[j] > batches.nBatchBoneMax)
+			return false;
+
+		if(batches.pnBatchOffset[j] < 0 || (PVRTuint32) batches.pnBatchOffset[j] > mesh.nNumFaces)
+			return false;
+
+		for(int k = 0; k < batches.pnBatchBoneCnt[j]; ++k)
+		{
+			const int nBone = batches.pnBatches[j * batches.nBatchBoneMax + k];
+
+			if(nBone < 0 || (PVRTuint32) nBone >= s.nNumNode)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/*!***************************************************************************
+ @Function			PODCookedCheckScene
+ @Input				pData			A fixed up cooked file in memory
+ @Input				nSize			Size of the file
+ @Input				s				The scene
+ @Return			true if the scene is consistent
+ @Description		Checks the counts, arrays and indices of a cooked scene,
+					so that a damaged or hostile file cannot lead the scene or
+					its users outside of the file. Every array must lie within
+					the file, and every index must name an object of the scene.
+*****************************************************************************/
+static bool PODCookedCheckScene(const PVRTuint8 * const pData, const size_t nSize, const SPODScene &s)
+{
+	unsigned int i;
+
+	if(!PODCookedHasArray(pData, nSize, s.pCamera, s.nNumCamera, sizeof(*s.pCamera))
+	|| !PODCookedHasArray(pData, nSize, s.pLight, s.nNumLight, sizeof(*s.pLight))
+	|| !PODCookedHasArray(pData, nSize, s.pMesh, s.nNumMesh, sizeof(*s.pMesh))
+	|| !PODCookedHasArray(pData, nSize, s.pNode, s.nNumNode, sizeof(*s.pNode))
+	|| !PODCookedHasArray(pData, nSize, s.pTexture, s.nNumTexture, sizeof(*s.pTexture))
+	|| !PODCookedHasArray(pData, nSize, s.pMaterial, s.nNumMaterial, sizeof(*s.pMaterial))
+	|| !PODCookedHasArray(pData, nSize, s.pUserData, s.nUserDataSize, 1))
+		return false;
+
+	// Nodes are sorted as mesh nodes, then lights, then cameras, then everything else
+	if(s.nNumMeshNode > s.nNumNode || s.nNumLight > s.nNumNode - s.nNumMeshNode || s.nNumCamera > s.nNumNode - s.nNumMeshNode - s.nNumLight)
+		return false;
+
+	for(i = 0; i < s.nNumCamera; ++i)
+	{
+		const SPODCamera &camera = s.pCamera[i];
+
+		if(!PODCookedIsIndex(camera.nIdxTarget, s.nNumNode))
+			return false;
+
+		if(camera.pfAnimFOV && !PODCookedHasArray(pData, nSize, camera.pfAnimFOV, s.nNumFrame, sizeof(*camera.pfAnimFOV)))
+			return false;
+	}
+
+	for(i = 0; i < s.nNumLight; ++i)
+	{
+		if(!PODCookedIsIndex(s.pLight[i].nIdxTarget, s.nNumNode))
+			return false;
+	}
+
+	for(i = 0; i < s.nNumMesh; ++i)
+	{
+		if(!PODCookedCheckMesh(pData, nSize, s, s.pMesh[i]))
+			return false;
+	}
+
+	for(i = 0; i < s.nNumNode; ++i)
+	{
+		const SPODNode		&node = s.pNode[i];
+		const PVRTuint32	nObjects = i < s.nNumMeshNode ? s.nNumMesh :
+									   i < s.nNumMeshNode + s.nNumLight ? s.nNumLight :
+									   i < s.nNumMeshNode + s.nNumLight + s.nNumCamera ? s.nNumCamera : 0;
+
+		if(nObjects && (node.nIdx < 0 || (PVRTuint32) node.nIdx >= nObjects))
+			return false;
+
+		if(!PODCookedIsIndex(node.nIdxMaterial, s.nNumMaterial) || !PODCookedIsIndex(node.nIdxParent, s.nNumNode))
+			return false;
+
+		if(!PODCookedHasString(pData, nSize, node.pszName)
+		|| !PODCookedHasArray(pData, nSize, node.pUserData, node.nUserDataSize, 1))
+			return false;
+
+		if(!PODCookedHasAnim(pData, nSize, node.pnAnimPositionIdx, node.pfAnimPosition, (node.nAnimFlags & ePODHasPositionAni) != 0, s.nNumFrame, 3)
+		|| !PODCookedHasAnim(pData, nSize, node.pnAnimRotationIdx, node.pfAnimRotation, (node.nAnimFlags & ePODHasRotationAni) != 0, s.nNumFrame, 4)
+		|| !PODCookedHasAnim(pData, nSize, node.pnAnimScaleIdx, node.pfAnimScale, (node.nAnimFlags & ePODHasScaleAni) != 0, s.nNumFrame, 7)
+		|| !PODCookedHasAnim(pData, nSize, node.pnAnimMatrixIdx, node.pfAnimMatrix, (node.nAnimFlags & ePODHasMatrixAni) != 0, s.nNumFrame, 16))
+			return false;
+	}
+
+	// Every chain of parents must end, or world matrices would recurse forever
+	for(i = 0; i < s.nNumNode; ++i)
+	{
+		PVRTint32		nParent	= s.pNode[i].nIdxParent;
+		unsigned int	nDepth	= 0;
+
+		while(nParent >= 0 && nDepth++ < s.nNumNode)
+			nParent = s.pNode[nParent].nIdxParent;
+
+		if(nParent >= 0)
+			return false;
+	}
+
+	for(i = 0; i < s.nNumTexture; ++i)
+	{
+		if(!PODCookedHasString(pData, nSize, s.pTexture[i].pszName))
+			return false;
+	}
+
+	for(i = 0; i < s.nNumMaterial; ++i)
+	{
+		const SPODMaterial &mat = s.pMaterial[i];
+		const PVRTint32 pnIdxTex[] = { mat.nIdxTexDiffuse, mat.nIdxTexAmbient, mat.nIdxTexSpecularColour, mat.nIdxTexSpecularLevel, mat.nIdxTexBump,
+									   mat.nIdxTexEmissive, mat.nIdxTexGlossiness, mat.nIdxTexOpacity, mat.nIdxTexReflection, mat.nIdxTexRefraction };
+
+		for(unsigned int j = 0; j < sizeof(pnIdxTex) / sizeof(*pnIdxTex); ++j)
+		{
+			if(!PODCookedIsIndex(pnIdxTex[j], s.nNumTexture))
+				return false;
+		}
+
+		if(!PODCookedHasString(pData, nSize, mat.pszName)
+		|| !PODCookedHasString(pData, nSize, mat.pszEffectFile)
+		|| !PODCookedHasString(pData, nSize, mat.pszEffectName)
+		|| !PODCookedHasArray(pData, nSize, mat.pUserData, mat.nUserDataSize, 1))
+			return false;
+	}
+
+	return true;
+}
+
+/*!***************************************************************************
+ @Function			PODCookedFixUp
+ @Modified			pData			A cooked file in memory
+ @Input				nSize			Size of the file
+ @Input				pszSourceFileName	If not NULL, the POD file the scene must
+									have been cooked from
+ @Output			s				The scene
+ @Return			false if the file is not a cooked scene this machine can load
+ @Description		Turns the offsets stored in a cooked file into pointers,
+					then checks the scene they give with PODCookedCheckScene().
+*****************************************************************************/
+static bool PODCookedFixUp(PVRTuint8 * const pData, const size_t nSize, const char * const pszSourceFileName, SPODScene &s)
+{
+	SPODCookedHeader	sHeader, sSource;
+	PVRTuint16			pnLayout[PVRTMODELPOD_COOKED_LAYOUT];
+
+	if(nSize < sizeof(sHeader) || (size_t) pData % sizeof(void*))
+		return false;
+
+	memcpy(&sHeader, pData, sizeof(sHeader));
+	PODCookedLayout(pnLayout);
+
+	if(sHeader.nMagic != PVRTMODELPOD_COOKED_MAGIC || sHeader.nVersion != PVRTMODELPOD_COOKED_VERSION)
+		return false;
+
+	if(sHeader.nSize != nSize || memcmp(sHeader.pnLayout, pnLayout, sizeof(pnLayout)))
+		return false;
+
+	// A POD file that has changed since it was cooked makes the cooked file stale
+	if(pszSourceFileName)
+	{
+		if(!PODCookedSource(pszSourceFileName, sSource) ||
+			sSource.nSourceSize != sHeader.nSourceSize || sSource.nSourceTime != sHeader.nSourceTime)
+			return false;
+	}
+
+	if(sHeader.nScene < sizeof(sHeader) || sHeader.nScene > nSize - sizeof(s) || sHeader.nScene % sizeof(void*))
+		return false;
+
+	if(sHeader.nFixups % sizeof(PVRTuint32) || sHeader.nFixups > nSize || sHeader.nNumFixups > (nSize - sHeader.nFixups) / sizeof(PVRTuint32))
+		return false;
+
+	const PVRTuint32 * const pnFixups = (const PVRTuint32*) (pData + sHeader.nFixups);
+
+	for(PVRTuint32 i = 0; i < sHeader.nNumFixups; ++i)
+	{
+		const size_t	nSlot = pnFixups[i];
+		size_t			nOffset;
+
+		if(nSlot % sizeof(void*) || nSlot > nSize - sizeof(void*))
+			return false;
+
+		nOffset = *(size_t*) (pData + nSlot);
+		if(!nOffset || nOffset >= nSize)
+			return false;
+
+		*(PVRTuint8**) (pData + nSlot) = pData + nOffset;
+	}
+
+	memcpy(&s, pData + sHeader.nScene, sizeof(s));
+	return PODCookedCheckScene(pData, nSize, s);
+}
+
+/*!***************************************************************************
+ @Function			PODForgetUnallocated
+ @Modified			s				A scene whose read failed part way
+ @Description		Zeroes each count whose array could not be allocated, so
+					that Destroy() can free what was read.
+*****************************************************************************/
+static void PODForgetUnallocated(SPODScene &s)
+{
+	if(!s.pCamera)		s.nNumCamera = 0;
+	if(!s.pLight)		s.nNumLight = 0;
+	if(!s.pMaterial)	s.nNumMaterial = 0;
+	if(!s.pMesh)		s.nNumMesh = 0;
+	if(!s.pNode)		s.nNumNode = 0;
+	if(!s.pTexture)		s.nNumTexture = 0;
+
+	for(unsigned int i = 0; i < s.nNumMesh; ++i)
+	{
+		if(!s.pMesh[i].psUVW)
+			s.pMesh[i].nNumUVW = 0;
+	}
+}
+
+/*!***************************************************************************
+ @Function			PODGetKey
+ @Input				pfAnim			Animation data of a channel
+ @Input				pnAnimIdx		Optional index array of the channel
+ @Input				nStride			Number of values per key
+ @Input				nFrame			Frame number
+ @Return			Pointer to the key of the given frame
+ @Description		Finds the key of a channel for an integer frame.
+*****************************************************************************/
+static const VERTTYPE* PODGetKey(
+	const VERTTYPE		* const pfAnim,
+	const unsigned int	* const pnAnimIdx,
+	const unsigned int	nStride,
+	const unsigned int	nFrame)
+{
+	return pnAnimIdx ? &pfAnim[pnAnimIdx[nFrame]] : &pfAnim[nStride * nFrame];
+}
+
+#ifndef PVRT_FIXED_POINT_ENABLE
+/*!***************************************************************************
+ @Function			PODBakeNode
+ @Modified			tracks			Baked animation of the scene
+ @Input				node			Node to bake
+ @Input				nNode			Index of the node
+ @Description		Resamples the animation of one node into the baked
+					tracks, replacing whatever was baked for it before.
+*****************************************************************************/
+static void PODBakeNode(
+	SPODAnimTracks		&tracks,
+	const SPODNode		&node,
+	const unsigned int	nNode)
+{
+	static const VERTTYPE	fZero[3]	= { 0, 0, 0 };
+	static const VERTTYPE	fOne[3]		= { 1, 1, 1 };
+	static const VERTTYPE	fQuatId[4]	= { 0, 0, 0, 1 };
+
+	tracks.pu8Flags[nNode] = 0;
+
+	if(node.pfAnimMatrix)
+		tracks.pu8Flags[nNode] |= ePODHasMatrixAni;
+
+	if(node.pfAnimRotation && (node.nAnimFlags & ePODHasRotationAni))
+		tracks.pu8Flags[nNode] |= ePODHasRotationAni;
+
+	for(unsigned int f = 0; f < tracks.nNumFrame; ++f)
+	{
+		const VERTTYPE *pfPos = fZero, *pfRot = fQuatId, *pfScale = fOne;
+
+		if(node.pfAnimPosition)
+			pfPos = node.nAnimFlags & ePODHasPositionAni ? PODGetKey(node.pfAnimPosition, node.pnAnimPositionIdx, 3, f) : node.pfAnimPosition;
+
+		if(node.pfAnimRotation)
+			pfRot = node.nAnimFlags & ePODHasRotationAni ? PODGetKey(node.pfAnimRotation, node.pnAnimRotationIdx, 4, f) : node.pfAnimRotation;
+
+		if(node.pfAnimScale)
+			pfScale = node.nAnimFlags & ePODHasScaleAni ? PODGetKey(node.pfAnimScale, node.pnAnimScaleIdx, 7, f) : node.pfAnimScale;
+
+		const size_t nIdx = (size_t) f * tracks.nNumNode + nNode;
+
+		for(unsigned int c = 0; c < 3; ++c)
+		{
+			tracks.pfPos[c][nIdx]	= pfPos[c];
+			tracks.pfScale[c][nIdx]	= pfScale[c];
+		}
+
+		for(unsigned int c = 0; c < 4; ++c)
+			tracks.pfRot[c][nIdx] = pfRot[c];
+	}
+}
+#endif
+
+
+/****************************************************************************
+** Class: CPVRTModelPOD
+****************************************************************************/
+
+/*!***************************************************************************
+ @Function			ReadFromFile
+ @Input				pszFileName		Filename to load
+ @Output			pszExpOpt		String in which to place exporter options
+ @Input				count			Maximum number of characters to store.
+ @Output			pszHistory		String in which to place the pod file history
+ @Input				historyCount	Maximum number of characters to store.
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Loads the specified ".POD" file; returns the scene in
+					pScene. This structure must later be destroyed with
+					PVRTModelPODDestroy() to prevent memory leaks.
+					".POD" files are exported using the PVRGeoPOD exporters.
+					If pszExpOpt is NULL, the scene is loaded; otherwise the
+					scene is not loaded and pszExpOpt is filled in. The same
+					is true for pszHistory.
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::ReadFromFile(
+	const char		* const pszFileName,
+	char			* const pszExpOpt,
+	const size_t	count,
+	char			* const pszHistory,
+	const size_t	historyCount)
+{
+	CSourceStream src;
+
+	if(!src.Init(pszFileName))
+		return PVR_FAIL;
+
+	return ReadFromSourceStream(this, src, pszExpOpt, count, pszHistory, historyCount);
+}
+
+/*!***************************************************************************
+ @Function			ReadFromFileMapped
+ @Input				pszFileName		Filename to load
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Loads the specified ".POD" file from a memory mapping of
+					the file, leaving suitable vertex, index and animation
+					arrays in place rather than copying them. Falls back to
+					ReadFromFile() where the file can not be mapped.
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::ReadFromFileMapped(
+	const char		* const pszFileName)
+{
+	Destroy();
+
+#ifdef PVRTMODELPOD_MMAP
+	CSourceMapped	mapped;
+	void			*pData = 0;
+	size_t			nSize = 0;
+
+	if(mapped.Init(pszFileName))
+		mapped.Detach(pData, nSize);
+
+	if(pData)
+	{
+		// Arrays may point into the mapping as soon as they are read, so
+		// the mapping belongs to the scene from the start
+		m_pImpl = new SPVRTPODImpl;
+		if(!m_pImpl)
+		{
+			munmap(pData, nSize);
+			return PVR_FAIL;
+		}
+
+		memset(m_pImpl, 0, sizeof(*m_pImpl));
+		m_pImpl->pMapped		= pData;
+		m_pImpl->nMappedSize	= nSize;
+
+		CSourceView src((unsigned char*) pData, nSize, 0, true);
+
+		if(Read(this, src, NULL, 0, NULL, 0) && InitImpl() == PVR_SUCCESS)
+			return PVR_SUCCESS;
+
+		// Free whatever was read, leaving the arrays in the mapping, then unmap it
+		PODForgetUnallocated(*this);
+		Destroy();
+		return PVR_FAIL;
+	}
+#endif
+
+	return ReadFromFile(pszFileName);
+}
+
+/*!***************************************************************************
+ @Function			ReadFromFileCooked
+ @Input				pszFileName			Filename to load
+ @Input				pszSourceFileName	If not NULL, the POD file the scene must
+										have been cooked from
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Loads a cooked scene written by SaveCooked(). The file is
+					mapped, or read in one go where mapping is not available,
+					and its stored offsets are turned into pointers. All of
+					the scene's data stays in that one block, which is
+					released by Destroy().
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::ReadFromFileCooked(
+	const char		* const pszFileName,
+	const char		* const pszSourceFileName)
+{
+	void	*pData = 0;
+	size_t	nSize = 0;
+	bool	bAlloc = false;
+
+	Destroy();
+
+#ifdef PVRTMODELPOD_MMAP
+	CSourceMapped src;
+
+	if(src.Init(pszFileName))
+		src.Detach(pData, nSize);
+#endif
+
+	if(!pData)
+	{
+		CPVRTResourceFile file(pszFileName);
+
+		if(!file.IsOpen() || !file.Size())
+			return PVR_FAIL;
+
+		nSize	= file.Size();
+		pData	= malloc(nSize);
+		bAlloc	= true;
+
+		if(!pData)
+			return PVR_FAIL;
+
+		memcpy(pData, file.DataPtr(), nSize);
+	}
+
+	if(!PODCookedFixUp((PVRTuint8*) pData, nSize, pszSourceFileName, *this) || InitImpl() != PVR_SUCCESS)
+	{
+#ifdef PVRTMODELPOD_MMAP
+		if(!bAlloc)
+			munmap(pData, nSize);
+		else
+#endif
+			free(pData);
+
+		DestroyImpl();
+		memset(this, 0, sizeof(*this));
+		return PVR_FAIL;
+	}
+
+	// The scene lives in the cooked file, so only the file is released
+	m_pImpl->bFromMemory	= true;
+	m_pImpl->pMapped		= pData;
+	m_pImpl->nMappedSize	= nSize;
+	m_pImpl->bMappedAlloc	= bAlloc;
+	return PVR_SUCCESS;
+}
+
+/*!***************************************************************************
+ @Function			ReadFromFileLazy
+ @Input				pszFileName		Filename to load
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Loads the specified ".POD" file without the vertex and
+					index data of its meshes or the animation of its nodes.
+					The file is mapped, or read in one go where mapping is
+					not available, and kept until Destroy() so that they can
+					be loaded by LoadMesh() and LoadNodeAnimation().
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::ReadFromFileLazy(
+	const char		* const pszFileName)
+{
+	void	*pData = 0;
+	size_t	nSize = 0;
+	bool	bAlloc = false;
+
+	Destroy();
+
+#ifdef PVRTMODELPOD_MMAP
+	CSourceMapped mapped;
+
+	if(mapped.Init(pszFileName))
+		mapped.Detach(pData, nSize);
+#endif
+
+	if(!pData)
+	{
+		CPVRTResourceFile file(pszFileName);
+
+		if(!file.IsOpen() || !file.Size())
+			return PVR_FAIL;
+
+		nSize	= file.Size();
+		pData	= malloc(nSize);
+		bAlloc	= true;
+
+		if(!pData)
+			return PVR_FAIL;
+
+		memcpy(pData, file.DataPtr(), nSize);
+	}
+
+	// The file outlives the scene's arrays, so they may point into it
+	CSourceView		src((unsigned char*) pData, nSize, 0, true);
+	SPODLazyScene	*pLazy = new SPODLazyScene;
+
+	if(pLazy)
+	{
+		memset(pLazy, 0, sizeof(*pLazy));
+
+		if(Read(this, src, NULL, 0, NULL, 0, pLazy) && InitImpl() == PVR_SUCCESS)
+		{
+			m_pImpl->pMapped		= pData;
+			m_pImpl->nMappedSize	= nSize;
+			m_pImpl->bMappedAlloc	= bAlloc;
+			m_pImpl->pLazy			= pLazy;
+			return PVR_SUCCESS;
+		}
+
+		FREE(pLazy->pnMeshPos);
+		FREE(pLazy->pnNodePos);
+		FREE(pLazy->pbMeshLoaded);
+		FREE(pLazy->pbNodeLoaded);
+		delete pLazy;
+	}
+
+#ifdef PVRTMODELPOD_MMAP
+	if(!bAlloc)
+		munmap(pData, nSize);
+	else
+#endif
+		free(pData);
+
+	// Forget any arrays that pointed into the file
+	DestroyImpl();
+	memset(this, 0, sizeof(*this));
+	return PVR_FAIL;
+}
+
+/*!***************************************************************************
+ @Function			ReadFromMemory
+ @Input				pData			Data to load
+ @Input				i32Size			Size of data
+ @Output			pszExpOpt		String in which to place exporter options
+ @Input				count			Maximum number of characters to store.
+ @Output			pszHistory		String in which to place the pod file history
+ @Input				historyCount	Maximum number of characters to store.
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Loads the supplied pod data. This data can be exported
+					directly to a header using one of the pod exporters.
+					If pszExpOpt is NULL, the scene is loaded; otherwise the
+					scene is not loaded and pszExpOpt is filled in. The same
+					is true for pszHistory.
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::ReadFromMemory(
+	const char		* pData,
+	const size_t	i32Size,
+	char			* const pszExpOpt,
+	const size_t	count,
+	char			* const pszHistory,
+	const size_t	historyCount)
+{
+	CSourceStream src;
+
+	if(!src.Init(pData, i32Size))
+		return PVR_FAIL;
+
+	return ReadFromSourceStream(this, src, pszExpOpt, count, pszHistory, historyCount);
+}
+
+/*!***************************************************************************
+ @Function			ReadFromMemory
+ @Input				scene			Scene data from the header file
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Sets the scene data from the supplied data structure. Use
+					when loading from .H files.
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::ReadFromMemory(
+	const SPODScene &scene)
+{
+	Destroy();
+
+	memset(this, 0, sizeof(*this));
+
+	*(SPODScene*)this = scene;
+
+	if(InitImpl() != PVR_SUCCESS)
+		return PVR_FAIL;
+
+	m_pImpl->bFromMemory = true;
+
+	return PVR_SUCCESS;
+}
+
+/*!***************************************************************************
+ @Function			CopyFromMemory
+ @Input				scene			Scene data
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Sets the scene data from the supplied data structure.
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::CopyFromMemory(const SPODScene &scene)
+{
+	Destroy();
+
+	unsigned int i;
+
+	// SPODScene
+	nNumFrame	= scene.nNumFrame;
+	nFPS		= scene.nFPS;
+	nFlags		= scene.nFlags;
+
+	for(i = 0; i < 3; ++i)
+	{
+		pfColourBackground[i] = scene.pfColourBackground[i];
+		pfColourAmbient[i]	  = scene.pfColourAmbient[i];
+	}
+
+	// Nodes
+	if(scene.nNumNode && SafeAlloc(pNode, sizeof(SPODNode) * scene.nNumNode))
+	{
+		nNumNode     = scene.nNumNode;
+		nNumMeshNode = scene.nNumMeshNode;
+
+		for(i = 0; i < nNumNode; ++i)
+			PVRTModelPODCopyNode(scene.pNode[i], pNode[i], scene.nNumFrame);
+	}
+
+	// Meshes
+	if(scene.nNumMesh && SafeAlloc(pMesh, sizeof(SPODMesh) * scene.nNumMesh))
+	{
+		nNumMesh = scene.nNumMesh;
+
+		for(i = 0; i < nNumMesh; ++i)
+			PVRTModelPODCopyMesh(scene.pMesh[i], pMesh[i]);
+	}
+
+	// Cameras
+	if(scene.nNumCamera && SafeAlloc(pCamera, sizeof(SPODCamera) * scene.nNumCamera))
+	{
+		nNumCamera = scene.nNumCamera;
+
+		for(i = 0; i < nNumCamera; ++i)
+			PVRTModelPODCopyCamera(scene.pCamera[i], pCamera[i], scene.nNumFrame);
+	}
+
+	// Lights
+	if(scene.nNumLight && SafeAlloc(pLight, sizeof(SPODLight) * scene.nNumLight))
+	{
+		nNumLight = scene.nNumLight;
+
+		for(i = 0; i < nNumLight; ++i)
+			PVRTModelPODCopyLight(scene.pLight[i], pLight[i]);
+	}
+
+	// Textures
+	if(scene.nNumTexture && SafeAlloc(pTexture, sizeof(SPODTexture) * scene.nNumTexture))
+	{
+		nNumTexture = scene.nNumTexture;
+
+		for(i = 0; i < nNumTexture; ++i)
+			PVRTModelPODCopyTexture(scene.pTexture[i], pTexture[i]);
+	}
+
+	// Materials
+	if(scene.nNumMaterial && SafeAlloc(pMaterial, sizeof(SPODMaterial) * scene.nNumMaterial))
+	{
+		nNumMaterial = scene.nNumMaterial;
+
+		for(i = 0; i < nNumMaterial; ++i)
+			PVRTModelPODCopyMaterial(scene.pMaterial[i], pMaterial[i]);
+	}
+
+	if(scene.pUserData && SafeAlloc(pUserData, scene.nUserDataSize))
+	{
+		memcpy(pUserData, scene.pUserData, nUserDataSize);
+		nUserDataSize = scene.nUserDataSize;
+	}
+
+	if(InitImpl() != PVR_SUCCESS)
+		return PVR_FAIL;
+
+	return PVR_SUCCESS;
+}
+
+#if defined(WIN32) && !defined(__BADA__)
+/*!***************************************************************************
+ @Function			ReadFromResource
+ @Input				pszName			Name of the resource to load from
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Loads the specified ".POD" file; returns the scene in
+					pScene. This structure must later be destroyed with
+					PVRTModelPODDestroy() to prevent memory leaks.
+					".POD" files are exported from 3D Studio MAX using a
+					PowerVR plugin.
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::ReadFromResource(
+	const TCHAR * const pszName)
+{
+	CSourceResource src;
+
+	if(!src.Init(pszName))
+		return PVR_FAIL;
+
+	memset(this, 0, sizeof(*this));
+	if(!Read(this, src, NULL, 0, NULL, 0))
+		return PVR_FAIL;
+	if(InitImpl() != PVR_SUCCESS)
+		return PVR_FAIL;
+	return PVR_SUCCESS;
+}
+#endif /* WIN32 */
+
+/*!***********************************************************************
+ @Function		InitImpl
+ @Description	Used by the Read*() fns to initialise implementation
+				details. Should also be called by applications which
+				manually build data in the POD structures for rendering;
+				in this case call it after the data has been created.
+				Otherwise, do not call this function.
+*************************************************************************/
+EPVRTError CPVRTModelPOD::InitImpl()
+{
+	// Keep hold of any file mapping the scene data points into
+	void	*pMapped		= m_pImpl ? m_pImpl->pMapped : 0;
+	size_t	nMappedSize	= m_pImpl ? m_pImpl->nMappedSize : 0;
+	bool	bMappedAlloc	= m_pImpl ? m_pImpl->bMappedAlloc : false;
+	SPODLazyScene	*pLazy	= m_pImpl ? m_pImpl->pLazy : 0;
+
+	// Free the caches of a previous call, e.g. after SplitMeshes() changed the scene
+	if(m_pImpl)
+	{
+		m_pImpl->pMapped	= 0;
+		m_pImpl->bMappedAlloc	= false;
+		m_pImpl->pLazy		= 0;
+		DestroyImpl();
+	}
+
+	// Allocate space for implementation data
+	m_pImpl = new SPVRTPODImpl;
+	if(!m_pImpl)
+		return PVR_FAIL;
+
+	// Zero implementation data
+	memset(m_pImpl, 0, sizeof(*m_pImpl));
+	m_pImpl->pMapped		= pMapped;
+	m_pImpl->nMappedSize	= nMappedSize;
+	m_pImpl->bMappedAlloc	= bMappedAlloc;
+	m_pImpl->pLazy			= pLazy;
+
+#ifdef _DEBUG
+	m_pImpl->nWmTotal = 0;
+#endif
+
+	// Allocate world-matrix cache
+	m_pImpl->pfCache		= new VERTTYPE[nNumNode];
+	m_pImpl->pWmCache		= new PVRTMATRIX[nNumNode];
+	m_pImpl->pWmZeroCache	= new PVRTMATRIX[nNumNode];
+
+	// Order the hierarchy once so world matrices can be solved in one sweep.
+	// If memory runs out, pnNodeOrder is left NULL and GetAllWorldMatrices()
+	// solves each node separately instead.
+	PODSortNodesByDepth(*this, m_pImpl->pnNodeOrder);
+
+	// Space for the inverse bind matrices of every mesh node's bone batches
+	unsigned int nNumBoneBind = 0;
+
+	m_pImpl->pWmZeroInvCache	= new PVRTMATRIX[nNumNode];
+	m_pImpl->pnBoneBindOffset	= new unsigned int[nNumMeshNode];
+
+	for(unsigned int i = 0; i < nNumMeshNode; ++i)
+	{
+		m_pImpl->pnBoneBindOffset[i] = nNumBoneBind;
+
+		if(pNode[i].nIdx >= 0 && (unsigned int) pNode[i].nIdx < nNumMesh)
+		{
+			const CPVRTBoneBatches &batches = pMesh[pNode[i].nIdx].sBoneBatches;
+
+			if(batches.pnBatches)
+				nNumBoneBind += batches.nBatchCnt * batches.nBatchBoneMax;
+		}
+	}
+
+	m_pImpl->pmBoneBind = nNumBoneBind ? new PVRTMATRIX[nNumBoneBind] : 0;
+
+	FlushCache();
+
+	return PVR_SUCCESS;
+}
+
+/*!***********************************************************************
+ @Function		DestroyImpl
+ @Description	Used to free memory allocated by the implementation.
+*************************************************************************/
+void CPVRTModelPOD::DestroyImpl()
+{
+	if(m_pImpl)
+	{
+		if(m_pImpl->pfCache)		delete [] m_pImpl->pfCache;
+		if(m_pImpl->pWmCache)		delete [] m_pImpl->pWmCache;
+		if(m_pImpl->pWmZeroCache)	delete [] m_pImpl->pWmZeroCache;
+		FREE(m_pImpl->pnNodeOrder);
+		if(m_pImpl->pWmZeroInvCache)	delete [] m_pImpl->pWmZeroInvCache;
+		if(m_pImpl->pmBoneBind)			delete [] m_pImpl->pmBoneBind;
+		if(m_pImpl->pnBoneBindOffset)	delete [] m_pImpl->pnBoneBindOffset;
+
+		if(m_pImpl->bMappedAlloc)
+			free(m_pImpl->pMapped);
+#ifdef PVRTMODELPOD_MMAP
+		else if(m_pImpl->pMapped)	munmap(m_pImpl->pMapped, m_pImpl->nMappedSize);
+#endif
+
+		if(m_pImpl->pTracks)
+		{
+			FREE(m_pImpl->pTracks->pfData);
+			FREE(m_pImpl->pTracks->pu8Flags);
+			delete m_pImpl->pTracks;
+		}
+
+		if(m_pImpl->pLazy)
+		{
+			FREE(m_pImpl->pLazy->pnMeshPos);
+			FREE(m_pImpl->pLazy->pnNodePos);
+			FREE(m_pImpl->pLazy->pbMeshLoaded);
+			FREE(m_pImpl->pLazy->pbNodeLoaded);
+			delete m_pImpl->pLazy;
+		}
+
+		delete m_pImpl;
+		m_pImpl = 0;
+	}
+}
+
+/*!***********************************************************************
+ @Function		FlushCache
+ @Description	Clears the matrix cache; use this if necessary when you
+				edit the position or animation of a node.
+*************************************************************************/
+void CPVRTModelPOD::FlushCache()
+{
+	// Pre-calc frame zero matrices
+	SetFrame(0);
+	GetAllWorldMatrices(m_pImpl->pWmZeroCache, 0);
+
+	// Pre-calc their inverses, which are all that is needed of the bind pose
+	for(unsigned int i = 0; i < nNumNode; ++i)
+		PVRTMatrixInverse(m_pImpl->pWmZeroInvCache[i], m_pImpl->pWmZeroCache[i]);
+
+	// Pre-calc the bind matrix of every bone used by each mesh node
+	for(unsigned int i = 0; i < nNumMeshNode; ++i)
+	{
+		if(pNode[i].nIdx < 0 || (unsigned int) pNode[i].nIdx >= nNumMesh)
+			continue;
+
+		const CPVRTBoneBatches	&batches	= pMesh[pNode[i].nIdx].sBoneBatches;
+		PVRTMATRIX				*pmBind		= &m_pImpl->pmBoneBind[m_pImpl->pnBoneBindOffset[i]];
+
+		if(!batches.pnBatches)
+			continue;
+
+		for(int j = 0; j < batches.nBatchCnt; ++j)
+		{
+			for(int k = 0; k < batches.pnBatchBoneCnt[j]; ++k)
+			{
+				const int nBone = batches.pnBatches[j * batches.nBatchBoneMax + k];
+				PVRTMatrixMultiply(pmBind[j * batches.nBatchBoneMax + k], m_pImpl->pWmZeroCache[i], m_pImpl->pWmZeroInvCache[nBone]);
+			}
+		}
+	}
+
+	// Load cache with frame-zero data
+	memcpy(m_pImpl->pWmCache, m_pImpl->pWmZeroCache, nNumNode * sizeof(*m_pImpl->pWmCache));
+	memset(m_pImpl->pfCache, 0, nNumNode * sizeof(*m_pImpl->pfCache));
+}
+
+/*!***********************************************************************
+ @Function		IsLoaded
+ @Description	Boolean to check whether a POD file has been loaded.
+*************************************************************************/
+bool CPVRTModelPOD::IsLoaded()
+{
+	return (m_pImpl!=NULL);
+}
+
+/*!***********************************************************************
+ @Function		IsMappedData
+ @Input			pData			Pointer to test
+ @Return		true if pData points into the file mapped by ReadFromFileMapped()
+								or ReadFromFileLazy(), or loaded by ReadFromFileCooked()
+ @Description	Used to find out whether an array belongs to the mapped file,
+				in which case it is owned by this class and must not be freed.
+*************************************************************************/
+bool CPVRTModelPOD::IsMappedData(const void * const pData) const
+{
+	if(!m_pImpl || !m_pImpl->pMapped || !pData)
+		return false;
+
+	const char *pMapped = (const char*) m_pImpl->pMapped;
+	return (const char*) pData >= pMapped && (const char*) pData < pMapped + m_pImpl->nMappedSize;
+}
+
+/****************************************************************************
+** Local code: Destruction
+****************************************************************************/
+
+/*!***************************************************************************
+ @Function			FreeUnlessMapped
+ @Input				pod				The scene owning the pointer
+ @Modified			ptr				Pointer to free
+ @Description		As FREE(), but leaves arrays borrowed from a file
+					mapping alone; those are released with the mapping.
+*****************************************************************************/
+template <typename T>
+static void FreeUnlessMapped(const CPVRTModelPOD &pod, T* &ptr)
+{
+	if(pod.IsMappedData(ptr))
+		ptr = 0;
+	else
+		FREE(ptr);
+}
+
+/*!***************************************************************************
+ @Function			CopyUnlessOwned
+ @Input				pod				The scene owning the pointer
+ @Modified			ptr				Array to copy
+ @Input				nBytes			Size of the array
+ @Return			false if out of memory
+ @Description		Replaces an array borrowed from a file mapping with a copy
+					of its own, which can be freed or reallocated. Other
+					arrays are left alone.
+*****************************************************************************/
+template <typename T>
+static bool CopyUnlessOwned(const CPVRTModelPOD &pod, T* &ptr, const size_t nBytes)
+{
+	if(!pod.IsMappedData(ptr))
+		return true;
+
+	T *pCopy = (T*) malloc(PVRT_MAX(nBytes, (size_t) 1));
+
+	if(!pCopy)
+		return false;
+
+	memcpy(pCopy, ptr, nBytes);
+	ptr = pCopy;
+	return true;
+}
+
+/*!***************************************************************************
+ @Function			CopyMeshDataUnlessOwned
+ @Input				pod				The scene owning the mesh
+ @Modified			mesh			Mesh to copy the vertex and index data of
+ @Return			false if the mesh itself belongs to a cooked file, or out
+					of memory
+ @Description		Gives the mesh its own copy of each array it borrows from
+					a file mapping, so that the PVRTModelPOD*() tools can
+					free and reallocate them.
+*****************************************************************************/
+static bool CopyMeshDataUnlessOwned(const CPVRTModelPOD &pod, SPODMesh &mesh)
+{
+	// The meshes of a cooked scene are never freed, so neither would the copies be
+	if(pod.IsMappedData(&mesh))
+		return false;
+
+	if(!CopyUnlessOwned(pod, mesh.sFaces.pData, PVRTModelPODCountIndices(mesh) * PVRTModelPODDataStride(mesh.sFaces)))
+		return false;
+
+	if(mesh.pInterleaved)
+		return CopyUnlessOwned(pod, mesh.pInterleaved, mesh.nNumVertex * mesh.sVertex.nStride);
+
+	CPODData * const psArrays[] = { &mesh.sVertex, &mesh.sNormals, &mesh.sTangents, &mesh.sBinormals, &mesh.sVtxColours, &mesh.sBoneIdx, &mesh.sBoneWeight };
+
+	for(unsigned int i = 0; i < sizeof(psArrays) / sizeof(*psArrays); ++i)
+	{
+		if(!CopyUnlessOwned(pod, psArrays[i]->pData, mesh.nNumVertex * psArrays[i]->nStride))
+			return false;
+	}
+
+	for(unsigned int i = 0; i < mesh.nNumUVW; ++i)
+	{
+		if(!CopyUnlessOwned(pod, mesh.psUVW[i].pData, mesh.nNumVertex * mesh.psUVW[i].nStride))
+			return false;
+	}
+
+	return true;
+}
+
+/*!***************************************************************************
+ @Function			FreeMeshData
+ @Input				pod				The scene owning the mesh
+ @Modified			mesh			Mesh to free the vertex and index data of
+ @Description		Frees the vertex and index data of a mesh, leaving every
+					data pointer of the mesh NULL.
+*****************************************************************************/
+static void FreeMeshData(const CPVRTModelPOD &pod, SPODMesh &mesh)
+{
+	FreeUnlessMapped(pod, mesh.sFaces.pData);
+
+	if(mesh.pInterleaved)
+	{
+		FreeUnlessMapped(pod, mesh.pInterleaved);
+
+		// The arrays only hold offsets into the interleaved data
+		mesh.sVertex.pData		= 0;
+		mesh.sNormals.pData		= 0;
+		mesh.sTangents.pData	= 0;
+		mesh.sBinormals.pData	= 0;
+		for(unsigned int j = 0; j < mesh.nNumUVW; ++j)
+			mesh.psUVW[j].pData = 0;
+		mesh.sVtxColours.pData	= 0;
+		mesh.sBoneIdx.pData		= 0;
+		mesh.sBoneWeight.pData	= 0;
+	}
+	else
+	{
+		FreeUnlessMapped(pod, mesh.sVertex.pData);
+		FreeUnlessMapped(pod, mesh.sNormals.pData);
+		FreeUnlessMapped(pod, mesh.sTangents.pData);
+		FreeUnlessMapped(pod, mesh.sBinormals.pData);
+		for(unsigned int j = 0; j < mesh.nNumUVW; ++j)
+			FreeUnlessMapped(pod, mesh.psUVW[j].pData);
+		FreeUnlessMapped(pod, mesh.sVtxColours.pData);
+		FreeUnlessMapped(pod, mesh.sBoneIdx.pData);
+		FreeUnlessMapped(pod, mesh.sBoneWeight.pData);
+	}
+}
+
+/*!***************************************************************************
+ @Function			FreeNodeAnimation
+ @Input				pod				The scene owning the node
+ @Modified			node			Node to free the animation arrays of
+ @Description		Frees the position, rotation, scale and matrix arrays of
+					a node.
+*****************************************************************************/
+static void FreeNodeAnimation(const CPVRTModelPOD &pod, SPODNode &node)
+{
+	FreeUnlessMapped(pod, node.pfAnimPosition);
+	FreeUnlessMapped(pod, node.pnAnimPositionIdx);
+	FreeUnlessMapped(pod, node.pfAnimRotation);
+	FreeUnlessMapped(pod, node.pnAnimRotationIdx);
+	FreeUnlessMapped(pod, node.pfAnimScale);
+	FreeUnlessMapped(pod, node.pnAnimScaleIdx);
+	FreeUnlessMapped(pod, node.pfAnimMatrix);
+	FreeUnlessMapped(pod, node.pnAnimMatrixIdx);
+}
+
+/*!***************************************************************************
+ @Function			Constructor
+ @Description		Initializes the pointer to scene data to NULL
+*****************************************************************************/
+CPVRTModelPOD::CPVRTModelPOD() : m_pImpl(NULL)
+{}
+
+/*!***************************************************************************
+ @Function			Destructor
+ @Description		Frees the memory allocated to store the scene in pScene.
+*****************************************************************************/
+CPVRTModelPOD::~CPVRTModelPOD()
+{
+	Destroy();
+}
+
+/*!***************************************************************************
+ @Function			Destroy
+ @Description		Frees the memory allocated to store the scene in pScene.
+*****************************************************************************/
+void CPVRTModelPOD::Destroy()
+{
+	unsigned int	i;
+
+	if(m_pImpl != NULL)
+	{
+		/*
+			Only attempt to free this memory if it was actually allocated at
+			run-time, as opposed to compiled into the app.
+		*/
+		if(!m_pImpl->bFromMemory)
+		{
+
+			for(i = 0; i < nNumCamera; ++i)
+				FREE(pCamera[i].pfAnimFOV);
+			FREE(pCamera);
+
+			FREE(pLight);
+
+			for(i = 0; i < nNumMaterial; ++i)
+			{
+				FREE(pMaterial[i].pszName);
+				FREE(pMaterial[i].pszEffectFile);
+				FREE(pMaterial[i].pszEffectName);
+				FREE(pMaterial[i].pUserData);
+			}
+			FREE(pMaterial);
+
+			for(i = 0; i < nNumMesh; ++i) {
+				FreeMeshData(*this, pMesh[i]);
+				FREE(pMesh[i].pnStripLength);
+				FREE(pMesh[i].psUVW);
+				pMesh[i].sBoneBatches.Release();
+			}
+			FREE(pMesh);
+
+			for(i = 0; i < nNumNode; ++i) {
+				FREE(pNode[i].pszName);
+				FreeNodeAnimation(*this, pNode[i]);
+				FREE(pNode[i].pUserData);
+				pNode[i].nAnimFlags = 0;
+			}
+
+			FREE(pNode);
+
+			for(i = 0; i < nNumTexture; ++i)
+				FREE(pTexture[i].pszName);
+			FREE(pTexture);
+
+			FREE(pUserData);
+		}
+
+		// Free the working space used by the implementation
+		DestroyImpl();
+	}
+
+	memset(this, 0, sizeof(*this));
+}
+
+/*!***************************************************************************
+ @Function			LoadMesh
+ @Input				ui32Mesh		Index of the mesh
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Loads the vertex and index data of a mesh of a scene read
+					by ReadFromFileLazy(). Does nothing if it is loaded.
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::LoadMesh(const unsigned int ui32Mesh)
+{
+	if(!m_pImpl || ui32Mesh >= nNumMesh)
+		return PVR_FAIL;
+
+	SPODLazyScene * const pLazy = m_pImpl->pLazy;
+
+	if(!pLazy || pLazy->pbMeshLoaded[ui32Mesh])
+		return PVR_SUCCESS;
+
+	CSourceView src((unsigned char*) m_pImpl->pMapped, m_pImpl->nMappedSize, pLazy->pnMeshPos[ui32Mesh], true);
+
+	if(!ReadMesh(pMesh[ui32Mesh], src, ePODReadData))
+	{
+		FreeMeshData(*this, pMesh[ui32Mesh]);
+		return PVR_FAIL;
+	}
+
+	pLazy->pbMeshLoaded[ui32Mesh] = true;
+	return PVR_SUCCESS;
+}
+
+/*!***************************************************************************
+ @Function			UnloadMesh
+ @Input				ui32Mesh		Index of the mesh
+ @Description		Frees the vertex and index data of a mesh loaded by
+					LoadMesh().
+*****************************************************************************/
+void CPVRTModelPOD::UnloadMesh(const unsigned int ui32Mesh)
+{
+	if(!IsMeshLoaded(ui32Mesh) || !m_pImpl->pLazy)
+		return;
+
+	FreeMeshData(*this, pMesh[ui32Mesh]);
+	m_pImpl->pLazy->pbMeshLoaded[ui32Mesh] = false;
+}
+
+/*!***************************************************************************
+ @Function			IsMeshLoaded
+ @Input				ui32Mesh		Index of the mesh
+ @Return			true if the vertex and index data of the mesh is loaded
+*****************************************************************************/
+bool CPVRTModelPOD::IsMeshLoaded(const unsigned int ui32Mesh) const
+{
+	if(!m_pImpl || ui32Mesh >= nNumMesh)
+		return false;
+
+	return !m_pImpl->pLazy || m_pImpl->pLazy->pbMeshLoaded[ui32Mesh];
+}
+
+/*!***************************************************************************
+ @Function			LoadNodeAnimation
+ @Input				ui32Node		Index of the node
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Replaces the frame 0 pose of a node of a scene read by
+					ReadFromFileLazy() with its animation. Does nothing if
+					it is loaded, or if the node is not animated.
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::LoadNodeAnimation(const unsigned int ui32Node)
+{
+	if(!m_pImpl || ui32Node >= nNumNode)
+		return PVR_FAIL;
+
+	SPODLazyScene * const pLazy = m_pImpl->pLazy;
+
+	if(!pLazy || pLazy->pbNodeLoaded[ui32Node])
+		return PVR_SUCCESS;
+
+	/*
+		Animation that has to be converted is copied out of the file, as
+		converting it in place would convert it again the next time it is
+		loaded.
+	*/
+	CSourceView	src((unsigned char*) m_pImpl->pMapped, m_pImpl->nMappedSize, pLazy->pnNodePos[ui32Node], !pLazy->bConvert);
+	SPODNode	anim;
+
+	memset(&anim, 0, sizeof(anim));
+
+	if(!ReadNode(anim, src, ePODReadData))
+	{
+		FreeNodeAnimation(*this, anim);
+		return PVR_FAIL;
+	}
+
+	if(pLazy->bConvert)
+	{
+		SPODScene scene;
+
+		memset(&scene, 0, sizeof(scene));
+		scene.nNumFrame	= nNumFrame;
+		scene.nNumNode	= 1;
+		scene.pNode		= &anim;
+		scene.nFlags	= nFlags ^ PVRTMODELPODSF_FIXED;
+		PVRTModelPODToggleFixedPoint(scene);
+	}
+
+	SPODNode &node = pNode[ui32Node];
+
+	FreeNodeAnimation(*this, node);
+	node.nAnimFlags			= anim.nAnimFlags;
+	node.pfAnimPosition		= anim.pfAnimPosition;
+	node.pnAnimPositionIdx	= anim.pnAnimPositionIdx;
+	node.pfAnimRotation		= anim.pfAnimRotation;
+	node.pnAnimRotationIdx	= anim.pnAnimRotationIdx;
+	node.pfAnimScale		= anim.pfAnimScale;
+	node.pnAnimScaleIdx		= anim.pnAnimScaleIdx;
+	node.pfAnimMatrix		= anim.pfAnimMatrix;
+	node.pnAnimMatrixIdx	= anim.pnAnimMatrixIdx;
+
+	pLazy->pbNodeLoaded[ui32Node] = true;
+
+#ifndef PVRT_FIXED_POINT_ENABLE
+	// Baked animation would otherwise still hold the frame 0 pose
+	if(m_pImpl->pTracks && m_pImpl->pTracks->nNumNode == nNumNode)
+		PODBakeNode(*m_pImpl->pTracks, node, ui32Node);
+#endif
+
+	// Frame 0 stays as solved from the frame 0 keys; other frames are solved again
+	memset(m_pImpl->pfCache, 0, nNumNode * sizeof(*m_pImpl->pfCache));
+	return PVR_SUCCESS;
+}
+
+/*!***************************************************************************
+ @Function			UnloadNodeAnimation
+ @Input				ui32Node		Index of the node
+ @Description		Frees the animation of a node loaded by
+					LoadNodeAnimation(), leaving the node with the frame 0
+					key of each animated array.
+*****************************************************************************/
+void CPVRTModelPOD::UnloadNodeAnimation(const unsigned int ui32Node)
+{
+	if(!m_pImpl || !m_pImpl->pLazy || ui32Node >= nNumNode || !m_pImpl->pLazy->pbNodeLoaded[ui32Node])
+		return;
+
+	static const unsigned int c_nAnimFlag[4]	= { ePODHasPositionAni, ePODHasRotationAni, ePODHasScaleAni, ePODHasMatrixAni };
+	static const unsigned int c_nStride[4]		= { 3, 4, 7, 16 };
+
+	SPODNode		&node		= pNode[ui32Node];
+	VERTTYPE		**ppfAnim[4]	= { &node.pfAnimPosition, &node.pfAnimRotation, &node.pfAnimScale, &node.pfAnimMatrix };
+	unsigned int	**ppnIdx[4]		= { &node.pnAnimPositionIdx, &node.pnAnimRotationIdx, &node.pnAnimScaleIdx, &node.pnAnimMatrixIdx };
+	VERTTYPE		*pfKey[4]		= { 0, 0, 0, 0 };
+	unsigned int	i;
+
+	// Copy out the frame 0 key of each animated array first, so that failing leaves the node as it was
+	for(i = 0; i < 4; ++i)
+	{
+		if(!(node.nAnimFlags & c_nAnimFlag[i]) || !*ppfAnim[i])
+			continue;
+
+		if(!SafeAlloc(pfKey[i], c_nStride[i]))
+		{
+			while(i)
+				FREE(pfKey[--i]);
+			return;
+		}
+
+		const VERTTYPE *pfFirst = *ppnIdx[i] ? &(*ppfAnim[i])[(*ppnIdx[i])[0]] : *ppfAnim[i];
+		memcpy(pfKey[i], pfFirst, c_nStride[i] * sizeof(VERTTYPE));
+	}
+
+	for(i = 0; i < 4; ++i)
+	{
+		FreeUnlessMapped(*this, *ppnIdx[i]);
+
+		if(pfKey[i])
+		{
+			FreeUnlessMapped(*this, *ppfAnim[i]);
+			*ppfAnim[i] = pfKey[i];
+		}
+	}
+
+	node.nAnimFlags &= ~(ePODHasPositionAni | ePODHasRotationAni | ePODHasScaleAni | ePODHasMatrixAni);
+	m_pImpl->pLazy->pbNodeLoaded[ui32Node] = false;
+
+#ifndef PVRT_FIXED_POINT_ENABLE
+	if(m_pImpl->pTracks && m_pImpl->pTracks->nNumNode == nNumNode)
+		PODBakeNode(*m_pImpl->pTracks, node, ui32Node);
+#endif
+
+	memset(m_pImpl->pfCache, 0, nNumNode * sizeof(*m_pImpl->pfCache));
+}
+
+/*!***************************************************************************
+ @Function			IsNodeAnimationLoaded
+ @Input				ui32Node		Index of the node
+ @Return			true if the animation of the node is loaded, or it has
+					none
+*****************************************************************************/
+bool CPVRTModelPOD::IsNodeAnimationLoaded(const unsigned int ui32Node) const
+{
+	if(!m_pImpl || ui32Node >= nNumNode)
+		return false;
+
+	return !m_pImpl->pLazy || m_pImpl->pLazy->pbNodeLoaded[ui32Node];
+}
+
+/****************************************************************************
+** Local code: Mesh splitting
+****************************************************************************/
+
+/*!***************************************************************************
+ @Struct		SPODSplitSegment
+ @Brief			A run of triangles of one chunk that come from one bone batch
+*****************************************************************************/
+struct SPODSplitSegment
+{
+	unsigned int	nChunk;		/*!< Chunk the triangles belong to */
+	unsigned int	nBatch;		/*!< Bone batch they come from */
+	unsigned int	nFirst;		/*!< First of them in the triangle order */
+};
+
+/*!***************************************************************************
+ @Function			FreeSplitChunks
+ @Modified			pChunks		Chunks made by SplitMesh()
+ @Input				nNumChunks	Number of chunks
+ @Description		Frees the chunks and their arrays.
+*****************************************************************************/
+static void FreeSplitChunks(SPODMesh * const pChunks, const unsigned int nNumChunks)
+{
+	if(!pChunks)
+		return;
+
+	for(unsigned int i = 0; i < nNumChunks; ++i)
+	{
+		SPODMesh &chunk = pChunks[i];
+
+		FREE(chunk.sFaces.pData);
+		if(chunk.pInterleaved)
+		{
+			FREE(chunk.pInterleaved);
+		}
+		else
+		{
+			FREE(chunk.sVertex.pData);
+			FREE(chunk.sNormals.pData);
+			FREE(chunk.sTangents.pData);
+			FREE(chunk.sBinormals.pData);
+			for(unsigned int j = 0; j < chunk.nNumUVW; ++j)
+				FREE(chunk.psUVW[j].pData);
+			FREE(chunk.sVtxColours.pData);
+			FREE(chunk.sBoneIdx.pData);
+			FREE(chunk.sBoneWeight.pData);
+		}
+		FREE(chunk.psUVW);
+		chunk.sBoneBatches.Release();
+	}
+	free(pChunks);
+}
+
+/*!***************************************************************************
+ @Function			CopySplitVertices
+ @Output			out			Vertex array of a chunk
+ @Input				in			Vertex array of the mesh
+ @Input				pui32Vtx	Mesh vertex of each chunk vertex
+ @Input				nNumVertex	Number of chunk vertices
+ @Return			false if memory allocation failed
+ @Description		Gathers the vertices of a chunk from a non-interleaved
+					vertex array of the mesh.
+*****************************************************************************/
+static bool CopySplitVertices(
+	CPODData			&out,
+	const CPODData		&in,
+	const unsigned int	* const pui32Vtx,
+	const unsigned int	nNumVertex)
+{
+	out.pData = 0;
+	if(!in.pData || !in.nStride)
+		return true;
+
+	if(!SafeAlloc(out.pData, (size_t) in.nStride * nNumVertex))
+		return false;
+
+	for(unsigned int i = 0; i < nNumVertex; ++i)
+		memcpy(out.pData + (size_t) i * in.nStride, in.pData + (size_t) pui32Vtx[i] * in.nStride, in.nStride);
+	return true;
+}
+
+/*!***************************************************************************
+ @Function			SplitMesh
+ @Input				mesh			Indexed triangle list to split
+ @Input				nMaxVertices	Most vertices a chunk may have; 3 to 65536
+ @Output			pChunks			Chunks, to free with FreeSplitChunks()
+ @Output			nNumChunks		Number of chunks
+ @Return			false if an index is out of range or memory ran out
+ @Description		Splits a mesh into chunks with 16 bit indices. Each chunk
+					is grown from a seed triangle to the triangles that share
+					its vertices, within the seed's bone batch, until the next
+					triangle would take it over nMaxVertices vertices. A chunk
+					that runs out of neighbours carries on from the next
+					unused triangle, then into the next bone batch. The
+					vertices of each chunk are numbered in the order its
+					triangles first use them.
+*****************************************************************************/
+static bool SplitMesh(
+	const SPODMesh		&mesh,
+	const unsigned int	nMaxVertices,
+	SPODMesh			* &pChunks,
+	unsigned int		&nNumChunks)
+{
+	const CPVRTBoneBatches	&batches	= mesh.sBoneBatches;
+	const unsigned int		nNumTri		= mesh.nNumFaces;
+	const unsigned int		nNumVtx		= mesh.nNumVertex;
+	const unsigned int		nBatchCnt	= batches.nBatchCnt ? batches.nBatchCnt : 1;
+	unsigned int	*pui32Idx = 0, *pui32TriOfVtx = 0, *pui32VtxTriStart = 0;
+	unsigned int	*pui32Queue = 0, *pui32TriStamp = 0, *pui32VtxStamp = 0, *pui32Order = 0;
+	unsigned int	*pui32ChunkVtx = 0;
+	int				*pi32NewIdx = 0;
+	bool			*pbUsed = 0;
+	SPODSplitSegment	*psSegments = 0;
+	unsigned int	nNumSegments = 0, nMaxSegments = 0;
+	unsigned int	nOrder = 0, nChunk = 0, nChunkVtx = 0;
+	unsigned int	i, j, b;
+	bool			bRet = false;
+
+	pChunks		= 0;
+	nNumChunks	= 0;
+
+	if(!SafeAlloc(pui32Idx, (size_t) nNumTri * 3)
+		|| !SafeAlloc(pui32VtxTriStart, (size_t) nNumVtx + 1)
+		|| !SafeAlloc(pui32TriOfVtx, (size_t) nNumTri * 3)
+		|| !SafeAlloc(pui32Queue, nNumTri)
+		|| !SafeAlloc(pui32TriStamp, nNumTri)
+		|| !SafeAlloc(pui32VtxStamp, nNumVtx)
+		|| !SafeAlloc(pui32Order, nNumTri)
+		|| !SafeAlloc(pbUsed, nNumTri)
+		|| !SafeAlloc(pi32NewIdx, nNumVtx)
+		|| !SafeAlloc(pui32ChunkVtx, nMaxVertices))
+		goto done;
+
+	for(i = 0; i < nNumTri * 3; ++i)
+	{
+		PVRTVertexRead(&pui32Idx[i], mesh.sFaces.pData + i * mesh.sFaces.nStride, mesh.sFaces.eType);
+		if(pui32Idx[i] >= nNumVtx)
+			goto done;
+
+		++pui32VtxTriStart[pui32Idx[i] + 1];
+	}
+
+	// The triangles that use each vertex, as compressed rows
+	for(i = 0; i < nNumVtx; ++i)
+		pui32VtxTriStart[i + 1] += pui32VtxTriStart[i];
+
+	for(i = 0; i < nNumTri * 3; ++i)
+		pui32TriOfVtx[pui32VtxTriStart[pui32Idx[i]]++] = i / 3;
+
+	for(i = nNumVtx; i > 0; --i)
+		pui32VtxTriStart[i] = pui32VtxTriStart[i - 1];
+	pui32VtxTriStart[0] = 0;
+
+	// Grow the chunks. Stamps are the chunk number plus one, so zeroed arrays mean unstamped
+	for(b = 0; b < nBatchCnt; ++b)
+	{
+		unsigned int nFirst = 0, nEnd = nNumTri, nScan, nHead = 0, nTail = 0;
+
+		if(batches.nBatchCnt)
+		{
+			nFirst = batches.pnBatchOffset[b];
+			nEnd = b + 1 < nBatchCnt ? batches.pnBatchOffset[b + 1] : nNumTri;
+		}
+
+		for(nScan = nFirst; ; )
+		{
+			if(nHead == nTail)
+			{
+				while(nScan < nEnd && pbUsed[nScan])
+					++nScan;
+
+				if(nScan >= nEnd)
+					break;
+
+				nHead = nTail = 0;
+				pui32TriStamp[nScan] = nChunk + 1;
+				pui32Queue[nTail++] = nScan;
+			}
+
+			const unsigned int t = pui32Queue[nHead++];
+			const unsigned int * const pui32Tri = &pui32Idx[3 * t];
+			unsigned int nNew = 0;
+
+			if(pbUsed[t])
+				continue;
+
+			for(j = 0; j < 3; ++j)
+			{
+				if(pui32VtxStamp[pui32Tri[j]] != nChunk + 1 && (j == 0 || pui32Tri[j] != pui32Tri[0]) && (j < 2 || pui32Tri[2] != pui32Tri[1]))
+					++nNew;
+			}
+
+			if(nChunkVtx + nNew > nMaxVertices)
+			{
+				// The chunk is full; start the next one from this triangle
+				++nChunk;
+				nChunkVtx = 0;
+				nHead = nTail = 0;
+				pui32TriStamp[t] = nChunk + 1;
+				pui32Queue[nTail++] = t;
+				continue;
+			}
+
+			if(!nNumSegments || psSegments[nNumSegments - 1].nChunk != nChunk || psSegments[nNumSegments - 1].nBatch != b)
+			{
+				if(nNumSegments == nMaxSegments)
+				{
+					SPODSplitSegment *psGrown = (SPODSplitSegment*) realloc(psSegments, (nMaxSegments ? nMaxSegments * 2 : 16) * sizeof(*psSegments));
+					if(!psGrown)
+						goto done;
+
+					psSegments		= psGrown;
+					nMaxSegments	= nMaxSegments ? nMaxSegments * 2 : 16;
+				}
+				psSegments[nNumSegments].nChunk	= nChunk;
+				psSegments[nNumSegments].nBatch	= b;
+				psSegments[nNumSegments].nFirst	= nOrder;
+				++nNumSegments;
+			}
+
+			pbUsed[t] = true;
+			pui32Order[nOrder++] = t;
+			nChunkVtx += nNew;
+
+			for(j = 0; j < 3; ++j)
+			{
+				const unsigned int v = pui32Tri[j];
+
+				pui32VtxStamp[v] = nChunk + 1;
+
+				for(unsigned int k = pui32VtxTriStart[v]; k < pui32VtxTriStart[v + 1]; ++k)
+				{
+					const unsigned int u = pui32TriOfVtx[k];
+
+					if(u >= nFirst && u < nEnd && !pbUsed[u] && pui32TriStamp[u] != nChunk + 1)
+					{
+						pui32TriStamp[u] = nChunk + 1;
+						pui32Queue[nTail++] = u;
+					}
+				}
+			}
+		}
+	}
+
+	nNumChunks = nNumSegments ? psSegments[nNumSegments - 1].nChunk + 1 : 0;
+	if(!SafeAlloc(pChunks, nNumChunks))
+		goto done;
+
+	for(i = 0; i < nNumVtx; ++i)
+		pi32NewIdx[i] = -1;
+
+	// Build each chunk from its segments
+	for(unsigned int s = 0, c = 0; c < nNumChunks; ++c)
+	{
+		SPODMesh &chunk = pChunks[c];
+		const unsigned int nChunkFirst = psSegments[s].nFirst;
+		unsigned int nSegEnd = s, nChunkEnd;
+		unsigned short *pui16Idx;
+
+		while(nSegEnd < nNumSegments && psSegments[nSegEnd].nChunk == c)
+			++nSegEnd;
+		nChunkEnd = nSegEnd < nNumSegments ? psSegments[nSegEnd].nFirst : nOrder;
+
+		// Take the settings of the mesh, then replace its arrays
+		chunk				= mesh;
+		chunk.nNumFaces		= nChunkEnd - nChunkFirst;
+		chunk.pnStripLength	= 0;
+		chunk.nNumStrips	= 0;
+		chunk.psUVW			= 0;
+		chunk.pInterleaved	= 0;
+		chunk.sFaces.eType	= EPODDataUnsignedShort;
+		chunk.sFaces.n		= 1;
+		chunk.sFaces.nStride	= sizeof(unsigned short);
+		chunk.sFaces.pData	= 0;
+		chunk.sBoneBatches.pnBatches		= 0;
+		chunk.sBoneBatches.pnBatchBoneCnt	= 0;
+		chunk.sBoneBatches.pnBatchOffset	= 0;
+		chunk.sBoneBatches.nBatchCnt		= 0;
+
+		if(!mesh.pInterleaved)
+		{
+			chunk.sVertex.pData = chunk.sNormals.pData = chunk.sTangents.pData = chunk.sBinormals.pData = 0;
+			chunk.sVtxColours.pData = chunk.sBoneIdx.pData = chunk.sBoneWeight.pData = 0;
+		}
+
+		if(!SafeAlloc(chunk.sFaces.pData, (size_t) chunk.nNumFaces * 3 * sizeof(unsigned short)))
+			goto done;
+
+		// Number the vertices by first use
+		pui16Idx	= (unsigned short*) chunk.sFaces.pData;
+		nChunkVtx	= 0;
+		for(i = nChunkFirst; i < nChunkEnd; ++i)
+		{
+			for(j = 0; j < 3; ++j)
+			{
+				const unsigned int v = pui32Idx[3 * pui32Order[i] + j];
+
+				if(pi32NewIdx[v] < 0)
+				{
+					pi32NewIdx[v] = (int) nChunkVtx;
+					pui32ChunkVtx[nChunkVtx++] = v;
+				}
+				*pui16Idx++ = (unsigned short) pi32NewIdx[v];
+			}
+		}
+
+		for(i = 0; i < nChunkVtx; ++i)
+			pi32NewIdx[pui32ChunkVtx[i]] = -1;
+
+		chunk.nNumVertex = nChunkVtx;
+
+		if(mesh.nNumUVW && !SafeAlloc(chunk.psUVW, mesh.nNumUVW))
+			goto done;
+
+		for(j = 0; j < mesh.nNumUVW; ++j)
+			chunk.psUVW[j] = mesh.psUVW[j];
+
+		if(mesh.pInterleaved)
+		{
+			// The arrays hold offsets into the interleaved data, which stay the same
+			const size_t nStride = mesh.sVertex.nStride;
+
+			if(!SafeAlloc(chunk.pInterleaved, nStride * nChunkVtx))
+				goto done;
+
+			for(i = 0; i < nChunkVtx; ++i)
+				memcpy(chunk.pInterleaved + i * nStride, mesh.pInterleaved + pui32ChunkVtx[i] * nStride, nStride);
+		}
+		else
+		{
+			for(j = 0; j < mesh.nNumUVW; ++j)
+				chunk.psUVW[j].pData = 0;
+
+			if(!CopySplitVertices(chunk.sVertex, mesh.sVertex, pui32ChunkVtx, nChunkVtx)
+				|| !CopySplitVertices(chunk.sNormals, mesh.sNormals, pui32ChunkVtx, nChunkVtx)
+				|| !CopySplitVertices(chunk.sTangents, mesh.sTangents, pui32ChunkVtx, nChunkVtx)
+				|| !CopySplitVertices(chunk.sBinormals, mesh.sBinormals, pui32ChunkVtx, nChunkVtx)
+				|| !CopySplitVertices(chunk.sVtxColours, mesh.sVtxColours, pui32ChunkVtx, nChunkVtx)
+				|| !CopySplitVertices(chunk.sBoneIdx, mesh.sBoneIdx, pui32ChunkVtx, nChunkVtx)
+				|| !CopySplitVertices(chunk.sBoneWeight, mesh.sBoneWeight, pui32ChunkVtx, nChunkVtx))
+				goto done;
+
+			for(j = 0; j < mesh.nNumUVW; ++j)
+			{
+				if(!CopySplitVertices(chunk.psUVW[j], mesh.psUVW[j], pui32ChunkVtx, nChunkVtx))
+					goto done;
+			}
+		}
+
+		// One bone batch per segment, with the bones of the batch it came from
+		if(batches.nBatchCnt)
+		{
+			CPVRTBoneBatches &out = chunk.sBoneBatches;
+			const unsigned int nCnt = nSegEnd - s;
+
+			if(!SafeAlloc(out.pnBatches, (size_t) nCnt * batches.nBatchBoneMax)
+				|| !SafeAlloc(out.pnBatchBoneCnt, nCnt)
+				|| !SafeAlloc(out.pnBatchOffset, nCnt))
+				goto done;
+
+			out.nBatchCnt = (int) nCnt;
+			for(i = 0; i < nCnt; ++i)
+			{
+				const SPODSplitSegment &seg = psSegments[s + i];
+
+				memcpy(&out.pnBatches[i * batches.nBatchBoneMax], &batches.pnBatches[seg.nBatch * batches.nBatchBoneMax], batches.nBatchBoneMax * sizeof(*out.pnBatches));
+				out.pnBatchBoneCnt[i]	= batches.pnBatchBoneCnt[seg.nBatch];
+				out.pnBatchOffset[i]	= (int) (seg.nFirst - nChunkFirst);
+			}
+		}
+
+		s = nSegEnd;
+	}
+
+	bRet = true;
+
+done:
+	if(!bRet)
+	{
+		FreeSplitChunks(pChunks, nNumChunks);
+		pChunks		= 0;
+		nNumChunks	= 0;
+	}
+
+	FREE(pui32Idx);
+	FREE(pui32VtxTriStart);
+	FREE(pui32TriOfVtx);
+	FREE(pui32Queue);
+	FREE(pui32TriStamp);
+	FREE(pui32VtxStamp);
+	FREE(pui32Order);
+	FREE(pbUsed);
+	FREE(pi32NewIdx);
+	FREE(pui32ChunkVtx);
+	FREE(psSegments);
+	return bRet;
+}
+
+/*!***************************************************************************
+ @Function			NarrowIndices
+ @Input				pod				The scene owning the mesh
+ @Modified			mesh			Indexed mesh with at most 65536 vertices
+ @Return			false if an index is out of range or memory ran out
+ @Description		Converts the indices of the mesh to 16 bits.
+*****************************************************************************/
+static bool NarrowIndices(const CPVRTModelPOD &pod, SPODMesh &mesh)
+{
+	const unsigned int nIdxNum = PVRTModelPODCountIndices(mesh);
+	unsigned short *pui16Idx = 0;
+
+	if(mesh.sFaces.eType == EPODDataUnsignedShort)
+		return true;
+
+	if(!SafeAlloc(pui16Idx, nIdxNum))
+		return false;
+
+	for(unsigned int i = 0; i < nIdxNum; ++i)
+	{
+		unsigned int ui32Idx;
+
+		PVRTVertexRead(&ui32Idx, mesh.sFaces.pData + i * mesh.sFaces.nStride, mesh.sFaces.eType);
+		if(ui32Idx >= mesh.nNumVertex)
+		{
+			FREE(pui16Idx);
+			return false;
+		}
+		pui16Idx[i] = (unsigned short) ui32Idx;
+	}
+
+	FreeUnlessMapped(pod, mesh.sFaces.pData);
+	mesh.sFaces.eType	= EPODDataUnsignedShort;
+	mesh.sFaces.n		= 1;
+	mesh.sFaces.nStride	= sizeof(unsigned short);
+	mesh.sFaces.pData	= (PVRTuint8*) pui16Idx;
+	return true;
+}
+
+/*!***************************************************************************
+ @Function			ShiftNodeIndex
+ @Modified			i32Idx			Node index
+ @Input				nFrom			First node index to move
+ @Input				nBy				Number of nodes inserted at nFrom
+ @Description		Moves a node index past nodes inserted before it.
+*****************************************************************************/
+static void ShiftNodeIndex(PVRTint32 &i32Idx, const unsigned int nFrom, const unsigned int nBy)
+{
+	if(i32Idx >= 0 && (unsigned int) i32Idx >= nFrom)
+		i32Idx += nBy;
+}
+
+/*!***************************************************************************
+ @Function			SplitMeshes
+ @Input				ui32MaxVertices	Most vertices a mesh may keep; at most 65536
+ @Return			PVR_SUCCESS if every indexed mesh now has 16 bit indices,
+					PVR_FAIL if a mesh could not be split or memory ran out
+ @Description		Splits the meshes that are too large for 16 bit indices.
+					See SplitMesh() for how the chunks are grown. Everything
+					is allocated before the scene is changed, so the scene is
+					left as it was if memory runs out.
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::SplitMeshes(const unsigned int ui32MaxVertices)
+{
+	const unsigned int nMaxVertices = PVRT_MAX(3u, PVRT_MIN(ui32MaxVertices, 65536u));
+	SPODMesh		**ppChunks = 0, *pGrownMesh;
+	unsigned int	*pnNumChunks = 0, *pnFirstExtra = 0;
+	SPODNode		*pNewNode = 0;
+	unsigned int	nNumSplit = 0, nNewMeshNode = 0, nNode, nMeshEnd, i, j, k;
+	bool			bRet = true;
+
+	// Only scenes whose arrays were allocated on loading can be changed
+	if(!m_pImpl || m_pImpl->bFromMemory || m_pImpl->pLazy)
+		return PVR_FAIL;
+
+	if(!nNumMesh)
+		return PVR_SUCCESS;
+
+	if(!SafeAlloc(ppChunks, nNumMesh) || !SafeAlloc(pnNumChunks, nNumMesh) || !SafeAlloc(pnFirstExtra, nNumMesh))
+		goto fail;
+
+	for(i = 0; i < nNumMesh; ++i)
+	{
+		const SPODMesh &mesh = pMesh[i];
+
+		if(!mesh.sFaces.pData || !mesh.nNumFaces || mesh.nNumVertex <= nMaxVertices)
+			continue;
+
+		if(mesh.nNumStrips || mesh.ePrimitiveType != ePODTriangles)
+		{
+			bRet = false;
+			continue;
+		}
+
+		if(!SplitMesh(mesh, nMaxVertices, ppChunks[i], pnNumChunks[i]))
+			goto fail;
+
+		++nNumSplit;
+	}
+
+	if(nNumSplit)
+	{
+		// The first chunk replaces the mesh, and the others go at the end of the mesh array
+		nMeshEnd = nNumMesh;
+		for(i = 0; i < nNumMesh; ++i)
+		{
+			if(pnNumChunks[i])
+			{
+				pnFirstExtra[i] = nMeshEnd;
+				nMeshEnd += pnNumChunks[i] - 1;
+			}
+		}
+
+		// Each mesh node of a split mesh gets a child for each other chunk
+		for(i = 0; i < nNumMeshNode; ++i)
+		{
+			if(pNode[i].nIdx >= 0 && (unsigned int) pNode[i].nIdx < nNumMesh && pnNumChunks[pNode[i].nIdx])
+				nNewMeshNode += pnNumChunks[pNode[i].nIdx] - 1;
+		}
+
+		if(!SafeAlloc(pNewNode, nNumNode + nNewMeshNode))
+			goto fail;
+
+		nNode = nNumMeshNode;
+		for(i = 0; i < nNumMeshNode; ++i)
+		{
+			const PVRTint32 nIdx = pNode[i].nIdx;
+
+			if(nIdx < 0 || (unsigned int) nIdx >= nNumMesh)
+				continue;
+
+			for(j = 1; j < pnNumChunks[nIdx]; ++j)
+			{
+				SPODNode &node = pNewNode[nNode++];
+				const char * const pszName = pNode[i].pszName ? pNode[i].pszName : "";
+
+				node.nIdx			= pnFirstExtra[nIdx] + j - 1;
+				node.nIdxMaterial	= pNode[i].nIdxMaterial;
+				node.nIdxParent		= i;
+
+				if(!SafeAlloc(node.pszName, strlen(pszName) + 12))
+					goto fail;
+
+				sprintf(node.pszName, "%s-%u", pszName, j);
+			}
+		}
+
+		pGrownMesh = (SPODMesh*) realloc(pMesh, nMeshEnd * sizeof(*pMesh));
+		if(!pGrownMesh)
+			goto fail;
+		pMesh = pGrownMesh;
+
+		// Nothing can fail from here on
+		for(i = 0; i < nNumMesh; ++i)
+		{
+			if(!pnNumChunks[i])
+				continue;
+
+			FreeMeshData(*this, pMesh[i]);
+			FREE(pMesh[i].pnStripLength);
+			FREE(pMesh[i].psUVW);
+			pMesh[i].sBoneBatches.Release();
+
+			pMesh[i] = ppChunks[i][0];
+			for(j = 1; j < pnNumChunks[i]; ++j)
+				pMesh[pnFirstExtra[i] + j - 1] = ppChunks[i][j];
+
+			// The chunks' arrays now belong to the scene
+			FREE(ppChunks[i]);
+			pnNumChunks[i] = 0;
+		}
+		nNumMesh = nMeshEnd;
+
+		// The new mesh nodes go after the old ones, so the nodes that follow move up
+		memcpy(pNewNode, pNode, nNumMeshNode * sizeof(*pNode));
+		memcpy(pNewNode + nNumMeshNode + nNewMeshNode, pNode + nNumMeshNode, (nNumNode - nNumMeshNode) * sizeof(*pNode));
+		FREE(pNode);
+		pNode		= pNewNode;
+		pNewNode	= 0;
+
+		for(i = 0; i < nNumNode + nNewMeshNode; ++i)
+			ShiftNodeIndex(pNode[i].nIdxParent, nNumMeshNode, nNewMeshNode);
+
+		for(i = 0; i < nNumMesh; ++i)
+		{
+			CPVRTBoneBatches &batches = pMesh[i].sBoneBatches;
+
+			for(j = 0; j < (unsigned int) batches.nBatchCnt; ++j)
+			{
+				for(k = 0; k < (unsigned int) batches.pnBatchBoneCnt[j]; ++k)
+					ShiftNodeIndex(batches.pnBatches[j * batches.nBatchBoneMax + k], nNumMeshNode, nNewMeshNode);
+			}
+		}
+
+		for(i = 0; i < nNumCamera; ++i)
+			ShiftNodeIndex(pCamera[i].nIdxTarget, nNumMeshNode, nNewMeshNode);
+
+		for(i = 0; i < nNumLight; ++i)
+			ShiftNodeIndex(pLight[i].nIdxTarget, nNumMeshNode, nNewMeshNode);
+
+		nNumNode		+= nNewMeshNode;
+		nNumMeshNode	+= nNewMeshNode;
+	}
+
+	// Meshes that were small enough only need their indices narrowing
+	for(i = 0; i < nNumMesh; ++i)
+	{
+		if(pMesh[i].sFaces.pData && pMesh[i].nNumVertex <= nMaxVertices && !NarrowIndices(*this, pMesh[i]))
+			bRet = false;
+	}
+
+	FREE(ppChunks);
+	FREE(pnNumChunks);
+	FREE(pnFirstExtra);
+
+	// The node and bone caches are sized by the hierarchy
+	if(nNumSplit && InitImpl() != PVR_SUCCESS)
+		return PVR_FAIL;
+
+	return bRet ? PVR_SUCCESS : PVR_FAIL;
+
+fail:
+	if(ppChunks)
+	{
+		for(i = 0; i < nNumMesh; ++i)
+			FreeSplitChunks(ppChunks[i], pnNumChunks[i]);
+	}
+
+	if(pNewNode)
+	{
+		for(i = nNumMeshNode; i < nNumMeshNode + nNewMeshNode; ++i)
+			FREE(pNewNode[i].pszName);
+	}
+
+	FREE(ppChunks);
+	FREE(pnNumChunks);
+	FREE(pnFirstExtra);
+	FREE(pNewNode);
+	return PVR_FAIL;
+}
+
+/****************************************************************************
+** Local code: Animation
+****************************************************************************/
+
+/*!***************************************************************************
+ @Function			PODSplitFrame
+ @Input				s				Scene the frame belongs to
+ @Input				fFrame			Frame number
+ @Output			nFrame			Integer part of the frame number
+ @Output			fBlend			Fractional part of the frame number
+ @Description		Splits a frame number the way SetFrame() does.
+*****************************************************************************/
+static void PODSplitFrame(
+	const SPODScene	&s,
+	const VERTTYPE	fFrame,
+	int				&nFrame,
+	VERTTYPE		&fBlend)
+{
+	if(s.nNumFrame)
+	{
+		_ASSERT(fFrame <= f2vt((float)(s.nNumFrame-1)));
+		nFrame = (int)vt2f(fFrame);
+		fBlend = fFrame - f2vt(nFrame);
+	}
+	else
+	{
+		fBlend = 0;
+		nFrame = 0;
+	}
+}
+
+/*!***************************************************************************
+ @Function			PODGetRotationMatrix
+ @Output			mOut			Rotation matrix
+ @Input				node			Node to get the rotation matrix from
+ @Input				nFrame			Integer part of the frame number
+ @Input				fBlend			Fractional part of the frame number
+ @Description		Generates the rotation matrix of a node at the given frame.
+*****************************************************************************/
+static void PODGetRotationMatrix(
+	PVRTMATRIX		&mOut,
+	const SPODNode	&node,
+	const int		nFrame,
+	const VERTTYPE	fBlend)
+{
+	PVRTQUATERNION	q;
+
+	if(node.pfAnimRotation)
+	{
+		if(node.nAnimFlags & ePODHasRotationAni)
+		{
+			if(node.pnAnimRotationIdx)
+			{
+				PVRTMatrixQuaternionSlerp(
+					q,
+					(PVRTQUATERNION&)node.pfAnimRotation[node.pnAnimRotationIdx[nFrame]],
+					(PVRTQUATERNION&)node.pfAnimRotation[node.pnAnimRotationIdx[nFrame+1]], fBlend);
+			}
+			else
+			{
+				PVRTMatrixQuaternionSlerp(
+					q,
+					(PVRTQUATERNION&)node.pfAnimRotation[4*nFrame],
+					(PVRTQUATERNION&)node.pfAnimRotation[4*(nFrame+1)], fBlend);
+			}
+
+			PVRTMatrixRotationQuaternion(mOut, q);
+		}
+		else
+		{
+			PVRTMatrixRotationQuaternion(mOut, *(PVRTQUATERNION*)node.pfAnimRotation);
+		}
+	}
+	else
+	{
+		PVRTMatrixIdentity(mOut);
+	}
+}
+
+/*!***************************************************************************
+ @Function			PODGetScalingMatrix
+ @Output			mOut			Scaling matrix
+ @Input				node			Node to get the scaling matrix from
+ @Input				nFrame			Integer part of the frame number
+ @Input				fBlend			Fractional part of the frame number
+ @Description		Generates the scaling matrix of a node at the given frame.
+*****************************************************************************/
+static void PODGetScalingMatrix(
+	PVRTMATRIX		&mOut,
+	const SPODNode	&node,
+	const int		nFrame,
+	const VERTTYPE	fBlend)
+{
+	PVRTVECTOR3 v;
+
+	if(node.pfAnimScale)
+	{
+		if(node.nAnimFlags & ePODHasScaleAni)
+		{
+			if(node.pnAnimScaleIdx)
+			{
+				PVRTMatrixVec3Lerp(
+					v,
+					(PVRTVECTOR3&)node.pfAnimScale[node.pnAnimScaleIdx[nFrame+0]],
+					(PVRTVECTOR3&)node.pfAnimScale[node.pnAnimScaleIdx[nFrame+1]], fBlend);
+			}
+			else
+			{
+				PVRTMatrixVec3Lerp(
+					v,
+					(PVRTVECTOR3&)node.pfAnimScale[7*(nFrame+0)],
+					(PVRTVECTOR3&)node.pfAnimScale[7*(nFrame+1)], fBlend);
+			}
+
+			PVRTMatrixScaling(mOut, v.x, v.y, v.z);
+		}
+		else
+		{
+			PVRTMatrixScaling(mOut, node.pfAnimScale[0], node.pfAnimScale[1], node.pfAnimScale[2]);
+		}
+	}
+	else
+	{
+		PVRTMatrixIdentity(mOut);
+	}
+}
+
+/*!***************************************************************************
+ @Function			PODGetTranslation
+ @Output			V				Translation vector
+ @Input				node			Node to get the translation vector from
+ @Input				nFrame			Integer part of the frame number
+ @Input				fBlend			Fractional part of the frame number
+ @Description		Generates the translation vector of a node at the given frame.
+*****************************************************************************/
+static void PODGetTranslation(
+	PVRTVECTOR3		&V,
+	const SPODNode	&node,
+	const int		nFrame,
+	const VERTTYPE	fBlend)
+{
+	if(node.pfAnimPosition)
+	{
+		if(node.nAnimFlags & ePODHasPositionAni)
+		{
+			if(node.pnAnimPositionIdx)
+			{
+				PVRTMatrixVec3Lerp(V,
+					(PVRTVECTOR3&)node.pfAnimPosition[node.pnAnimPositionIdx[nFrame+0]],
+					(PVRTVECTOR3&)node.pfAnimPosition[node.pnAnimPositionIdx[nFrame+1]], fBlend);
+			}
+			else
+			{
+				PVRTMatrixVec3Lerp(V,
+					(PVRTVECTOR3&)node.pfAnimPosition[3 * (nFrame+0)],
+					(PVRTVECTOR3&)node.pfAnimPosition[3 * (nFrame+1)], fBlend);
+			}
+		}
+		else
+		{
+			V = *(PVRTVECTOR3*) node.pfAnimPosition;
+		}
+	}
+	else
+	{
+		_ASSERT(false);
+	}
+}
+
+/*!***************************************************************************
+ @Function			PODGetTranslationMatrix
+ @Output			mOut			Translation matrix
+ @Input				node			Node to get the translation matrix from
+ @Input				nFrame			Integer part of the frame number
+ @Input				fBlend			Fractional part of the frame number
+ @Description		Generates the translation matrix of a node at the given frame.
+*****************************************************************************/
+static void PODGetTranslationMatrix(
+	PVRTMATRIX		&mOut,
+	const SPODNode	&node,
+	const int		nFrame,
+	const VERTTYPE	fBlend)
+{
+	PVRTVECTOR3 v;
+
+	if(node.pfAnimPosition)
+	{
+		if(node.nAnimFlags & ePODHasPositionAni)
+		{
+			if(node.pnAnimPositionIdx)
+			{
+				PVRTMatrixVec3Lerp(v,
+					(PVRTVECTOR3&)node.pfAnimPosition[node.pnAnimPositionIdx[nFrame+0]],
+					(PVRTVECTOR3&)node.pfAnimPosition[node.pnAnimPositionIdx[nFrame+1]], fBlend);
+			}
+			else
+			{
+				PVRTMatrixVec3Lerp(v,
+					(PVRTVECTOR3&)node.pfAnimPosition[3*(nFrame+0)],
+					(PVRTVECTOR3&)node.pfAnimPosition[3*(nFrame+1)], fBlend);
+			}
+
+			PVRTMatrixTranslation(mOut, v.x, v.y, v.z);
+		}
+		else
+		{
+			PVRTMatrixTranslation(mOut, node.pfAnimPosition[0], node.pfAnimPosition[1], node.pfAnimPosition[2]);
+		}
+	}
+	else
+	{
+		PVRTMatrixIdentity(mOut);
+	}
 }
 
 /*!***************************************************************************
- @Function			Constructor
- @Description		Initializes the pointer to scene data to NULL
-*****************************************************************************/
-CPVRTModelPOD::CPVRTModelPOD() : m_pImpl(NULL)
-{}
-
-/*!***************************************************************************
- @Function			Destructor
- @Description		Frees the memory allocated to store the scene in pScene.
+ @Function			PODGetTransformationMatrix
+ @Output			mOut			Transformation matrix
+ @Input				node			Node to get the transformation matrix from
+ @Input				nFrame			Integer part of the frame number
+ @Description		Returns the animation matrix of a node at the given frame.
 *****************************************************************************/
-CPVRTModelPOD::~CPVRTModelPOD()
+static void PODGetTransformationMatrix(
+	PVRTMATRIX		&mOut,
+	const SPODNode	&node,
+	const int		nFrame)
 {
-	Destroy();
+	if(node.pfAnimMatrix)
+	{
+		if(node.nAnimFlags & ePODHasMatrixAni)
+		{
+			if(node.pnAnimMatrixIdx)
+				mOut = *((PVRTMATRIX*) &node.pfAnimMatrix[node.pnAnimMatrixIdx[nFrame]]);
+			else
+				mOut = *((PVRTMATRIX*) &node.pfAnimMatrix[16*nFrame]);
+		}
+		else
+		{
+			mOut = *((PVRTMATRIX*) node.pfAnimMatrix);
+		}
+	}
+	else
+	{
+		PVRTMatrixIdentity(mOut);
+	}
 }
 
 /*!***************************************************************************
- @Function			Destroy
- @Description		Frees the memory allocated to store the scene in pScene.
+ @Function			PODGetLocalMatrix
+ @Output			mOut			Local transformation matrix
+ @Input				node			Node to get the matrix from
+ @Input				nFrame			Integer part of the frame number
+ @Input				fBlend			Fractional part of the frame number
+ @Description		Generates the transformation of a node relative to its
+					parent at the given frame.
 *****************************************************************************/
-void CPVRTModelPOD::Destroy()
+static void PODGetLocalMatrix(
+	PVRTMATRIX		&mOut,
+	const SPODNode	&node,
+	const int		nFrame,
+	const VERTTYPE	fBlend)
 {
-	unsigned int	i;
+	PVRTMATRIX mTmp;
 
-	if(m_pImpl != NULL)
+	if(node.pfAnimMatrix) // The transformations are stored as matrices
 	{
-		/*
-			Only attempt to free this memory if it was actually allocated at
-			run-time, as opposed to compiled into the app.
-		*/
-		if(!m_pImpl->bFromMemory)
-		{
-
-			for(i = 0; i < nNumCamera; ++i)
-				FREE(pCamera[i].pfAnimFOV);
-			FREE(pCamera);
-
-			FREE(pLight);
-
-			for(i = 0; i < nNumMaterial; ++i)
-			{
-				FREE(pMaterial[i].pszName);
-				FREE(pMaterial[i].pszEffectFile);
-				FREE(pMaterial[i].pszEffectName);
-				FREE(pMaterial[i].pUserData);
-			}
-			FREE(pMaterial);
+		PODGetTransformationMatrix(mOut, node, nFrame);
+		return;
+	}
 
-			for(i = 0; i < nNumMesh; ++i) {
-				FREE(pMesh[i].sFaces.pData);
-				FREE(pMesh[i].pnStripLength);
-				if(pMesh[i].pInterleaved)
-				{
-					FREE(pMesh[i].pInterleaved);
-				}
-				else
-				{
-					FREE(pMesh[i].sVertex.pData);
-					FREE(pMesh[i].sNormals.pData);
-					FREE(pMesh[i].sTangents.pData);
-					FREE(pMesh[i].sBinormals.pData);
-					for(unsigned int j = 0; j < pMesh[i].nNumUVW; ++j)
-						FREE(pMesh[i].psUVW[j].pData);
-					FREE(pMesh[i].sVtxColours.pData);
-					FREE(pMesh[i].sBoneIdx.pData);
-					FREE(pMesh[i].sBoneWeight.pData);
-				}
-				FREE(pMesh[i].psUVW);
-				pMesh[i].sBoneBatches.Release();
-			}
-			FREE(pMesh);
+	// Scale
+	PODGetScalingMatrix(mOut, node, nFrame, fBlend);
 
-			for(i = 0; i < nNumNode; ++i) {
-				FREE(pNode[i].pszName);
-				FREE(pNode[i].pfAnimPosition);
-				FREE(pNode[i].pnAnimPositionIdx);
-				FREE(pNode[i].pfAnimRotation);
-				FREE(pNode[i].pnAnimRotationIdx);
-				FREE(pNode[i].pfAnimScale);
-				FREE(pNode[i].pnAnimScaleIdx);
-				FREE(pNode[i].pfAnimMatrix);
-				FREE(pNode[i].pnAnimMatrixIdx);
-				FREE(pNode[i].pUserData);
-				pNode[i].nAnimFlags = 0;
-			}
+	// Rotation
+	PODGetRotationMatrix(mTmp, node, nFrame, fBlend);
+	PVRTMatrixMultiply(mOut, mOut, mTmp);
 
-			FREE(pNode);
+	// Translation
+	PODGetTranslationMatrix(mTmp, node, nFrame, fBlend);
+	PVRTMatrixMultiply(mOut, mOut, mTmp);
+}
 
-			for(i = 0; i < nNumTexture; ++i)
-				FREE(pTexture[i].pszName);
-			FREE(pTexture);
+/*!***************************************************************************
+ @Function			PODGetWorldMatrix
+ @Input				s				Scene the node belongs to
+ @Output			mOut			World matrix
+ @Input				node			Node to get the world matrix from
+ @Input				nFrame			Integer part of the frame number
+ @Input				fBlend			Fractional part of the frame number
+ @Description		Generates the world matrix of a node at the given frame by
+					applying the transform of each of its ancestors in turn.
+*****************************************************************************/
+static void PODGetWorldMatrix(
+	const SPODScene	&s,
+	PVRTMATRIX		&mOut,
+	const SPODNode	&node,
+	const int		nFrame,
+	const VERTTYPE	fBlend)
+{
+	PVRTMATRIX mTmp;
 
-			FREE(pUserData);
-		}
+	PODGetLocalMatrix(mOut, node, nFrame, fBlend);
 
-		// Free the working space used by the implementation
-		DestroyImpl();
-	}
+ 	// Do we have to worry about a parent?
+	if(node.nIdxParent < 0)
+		return;
 
-	memset(this, 0, sizeof(*this));
+	// Apply parent's transform too.
+	PODGetWorldMatrix(s, mTmp, s.pNode[node.nIdxParent], nFrame, fBlend);
+	PVRTMatrixMultiply(mOut, mOut, mTmp);
 }
 
 /*!***************************************************************************
@@ -2279,38 +5508,7 @@ void CPVRTModelPOD::GetRotationMatrix(
 	PVRTMATRIX		&mOut,
 	const SPODNode	&node) const
 {
-	PVRTQUATERNION	q;
-
-	if(node.pfAnimRotation)
-	{
-		if(node.nAnimFlags & ePODHasRotationAni)
-		{
-			if(node.pnAnimRotationIdx)
-			{
-				PVRTMatrixQuaternionSlerp(
-					q,
-					(PVRTQUATERNION&)node.pfAnimRotation[node.pnAnimRotationIdx[m_pImpl->nFrame]],
-					(PVRTQUATERNION&)node.pfAnimRotation[node.pnAnimRotationIdx[m_pImpl->nFrame+1]], m_pImpl->fBlend);
-			}
-			else
-			{
-				PVRTMatrixQuaternionSlerp(
-					q,
-					(PVRTQUATERNION&)node.pfAnimRotation[4*m_pImpl->nFrame],
-					(PVRTQUATERNION&)node.pfAnimRotation[4*(m_pImpl->nFrame+1)], m_pImpl->fBlend);
-			}
-
-			PVRTMatrixRotationQuaternion(mOut, q);
-		}
-		else
-		{
-			PVRTMatrixRotationQuaternion(mOut, *(PVRTQUATERNION*)node.pfAnimRotation);
-		}
-	}
-	else
-	{
-		PVRTMatrixIdentity(mOut);
-	}
+	PODGetRotationMatrix(mOut, node, m_pImpl->nFrame, m_pImpl->fBlend);
 }
 
 /*!***************************************************************************
@@ -2338,38 +5536,7 @@ void CPVRTModelPOD::GetScalingMatrix(
 	PVRTMATRIX		&mOut,
 	const SPODNode	&node) const
 {
-	PVRTVECTOR3 v;
-
-	if(node.pfAnimScale)
-	{
-		if(node.nAnimFlags & ePODHasScaleAni)
-		{
-			if(node.pnAnimScaleIdx)
-			{
-				PVRTMatrixVec3Lerp(
-					v,
-					(PVRTVECTOR3&)node.pfAnimScale[node.pnAnimScaleIdx[m_pImpl->nFrame+0]],
-					(PVRTVECTOR3&)node.pfAnimScale[node.pnAnimScaleIdx[m_pImpl->nFrame+1]], m_pImpl->fBlend);
-			}
-			else
-			{
-				PVRTMatrixVec3Lerp(
-					v,
-					(PVRTVECTOR3&)node.pfAnimScale[7*(m_pImpl->nFrame+0)],
-					(PVRTVECTOR3&)node.pfAnimScale[7*(m_pImpl->nFrame+1)], m_pImpl->fBlend);
-			}
-
-			PVRTMatrixScaling(mOut, v.x, v.y, v.z);
-		}
-		else
-		{
-			PVRTMatrixScaling(mOut, node.pfAnimScale[0], node.pfAnimScale[1], node.pfAnimScale[2]);
-		}
-	}
-	else
-	{
-		PVRTMatrixIdentity(mOut);
-	}
+	PODGetScalingMatrix(mOut, node, m_pImpl->nFrame, m_pImpl->fBlend);
 }
 
 /*!***************************************************************************
@@ -2397,32 +5564,7 @@ void CPVRTModelPOD::GetTranslation(
 	PVRTVECTOR3		&V,
 	const SPODNode	&node) const
 {
-	if(node.pfAnimPosition)
-	{
-		if(node.nAnimFlags & ePODHasPositionAni)
-		{
-			if(node.pnAnimPositionIdx)
-			{
-				PVRTMatrixVec3Lerp(V,
-					(PVRTVECTOR3&)node.pfAnimPosition[node.pnAnimPositionIdx[m_pImpl->nFrame+0]],
-					(PVRTVECTOR3&)node.pfAnimPosition[node.pnAnimPositionIdx[m_pImpl->nFrame+1]], m_pImpl->fBlend);
-			}
-			else
-			{
-				PVRTMatrixVec3Lerp(V,
-					(PVRTVECTOR3&)node.pfAnimPosition[3 * (m_pImpl->nFrame+0)],
-					(PVRTVECTOR3&)node.pfAnimPosition[3 * (m_pImpl->nFrame+1)], m_pImpl->fBlend);
-			}
-		}
-		else
-		{
-			V = *(PVRTVECTOR3*) node.pfAnimPosition;
-		}
-	}
-	else
-	{
-		_ASSERT(false);
-	}
+	PODGetTranslation(V, node, m_pImpl->nFrame, m_pImpl->fBlend);
 }
 
 /*!***************************************************************************
@@ -2450,36 +5592,7 @@ void CPVRTModelPOD::GetTranslationMatrix(
 	PVRTMATRIX		&mOut,
 	const SPODNode	&node) const
 {
-	PVRTVECTOR3 v;
-
-	if(node.pfAnimPosition)
-	{
-		if(node.nAnimFlags & ePODHasPositionAni)
-		{
-			if(node.pnAnimPositionIdx)
-			{
-				PVRTMatrixVec3Lerp(v,
-					(PVRTVECTOR3&)node.pfAnimPosition[node.pnAnimPositionIdx[m_pImpl->nFrame+0]],
-					(PVRTVECTOR3&)node.pfAnimPosition[node.pnAnimPositionIdx[m_pImpl->nFrame+1]], m_pImpl->fBlend);
-			}
-			else
-			{
-				PVRTMatrixVec3Lerp(v,
-					(PVRTVECTOR3&)node.pfAnimPosition[3*(m_pImpl->nFrame+0)],
-					(PVRTVECTOR3&)node.pfAnimPosition[3*(m_pImpl->nFrame+1)], m_pImpl->fBlend);
-			}
-
-			PVRTMatrixTranslation(mOut, v.x, v.y, v.z);
-		}
-		else
-		{
-			PVRTMatrixTranslation(mOut, node.pfAnimPosition[0], node.pfAnimPosition[1], node.pfAnimPosition[2]);
-		}
-	}
-	else
-	{
-		PVRTMatrixIdentity(mOut);
-	}
+	PODGetTranslationMatrix(mOut, node, m_pImpl->nFrame, m_pImpl->fBlend);
 }
 
 /*!***************************************************************************
@@ -2505,61 +5618,20 @@ PVRTMat4 CPVRTModelPOD::GetTranslationMatrix(const SPODNode &node) const
 *****************************************************************************/
 void CPVRTModelPOD::GetTransformationMatrix(PVRTMATRIX &mOut, const SPODNode &node) const
 {
-	if(node.pfAnimMatrix)
-	{
-		if(node.nAnimFlags & ePODHasMatrixAni)
-		{
-			if(node.pnAnimMatrixIdx)
-				mOut = *((PVRTMATRIX*) &node.pfAnimMatrix[node.pnAnimMatrixIdx[m_pImpl->nFrame]]);
-			else
-				mOut = *((PVRTMATRIX*) &node.pfAnimMatrix[16*m_pImpl->nFrame]);
-		}
-		else
-		{
-			mOut = *((PVRTMATRIX*) node.pfAnimMatrix);
-		}
-	}
-	else
-	{
-		PVRTMatrixIdentity(mOut);
-	}
+	PODGetTransformationMatrix(mOut, node, m_pImpl->nFrame);
 }
-/*!***************************************************************************
- @Function			GetWorldMatrixNoCache
- @Output			mOut			World matrix
- @Input				node			Node to get the world matrix from
- @Description		Generates the world matrix for the given Mesh Instance;
-					applies the parent's transform too. Uses animation data.
-*****************************************************************************/
-void CPVRTModelPOD::GetWorldMatrixNoCache(
-	PVRTMATRIX		&mOut,
-	const SPODNode	&node) const
-{
-	PVRTMATRIX mTmp;
-
-    if(node.pfAnimMatrix) // The transformations are stored as matrices
-		GetTransformationMatrix(mOut, node);
-	else
-	{
-		// Scale
-		GetScalingMatrix(mOut, node);
-
-		// Rotation
-		GetRotationMatrix(mTmp, node);
-		PVRTMatrixMultiply(mOut, mOut, mTmp);
-
-		// Translation
-		GetTranslationMatrix(mTmp, node);
-		PVRTMatrixMultiply(mOut, mOut, mTmp);
-	}
-
- 	// Do we have to worry about a parent?
-	if(node.nIdxParent < 0)
-		return;
-
-	// Apply parent's transform too.
-	GetWorldMatrixNoCache(mTmp, pNode[node.nIdxParent]);
-	PVRTMatrixMultiply(mOut, mOut, mTmp);
+/*!***************************************************************************
+ @Function			GetWorldMatrixNoCache
+ @Output			mOut			World matrix
+ @Input				node			Node to get the world matrix from
+ @Description		Generates the world matrix for the given Mesh Instance;
+					applies the parent's transform too. Uses animation data.
+*****************************************************************************/
+void CPVRTModelPOD::GetWorldMatrixNoCache(
+	PVRTMATRIX		&mOut,
+	const SPODNode	&node) const
+{
+	PODGetWorldMatrix(*this, mOut, node, m_pImpl->nFrame, m_pImpl->fBlend);
 }
 
 /*!***************************************************************************
@@ -2618,11 +5690,14 @@ void CPVRTModelPOD::GetWorldMatrix(
 		return;
 	}
 
-	GetWorldMatrixNoCache(mOut, node);
+	// Solve and cache the whole hierarchy for this frame; the other nodes
+	// are normally asked for next
+	GetAllWorldMatrices(m_pImpl->pWmCache, m_pImpl->fFrame);
+
+	for(unsigned int i = 0; i < nNumNode; ++i)
+		m_pImpl->pfCache[i] = m_pImpl->fFrame;
 
-	// Cache the matrix
-	m_pImpl->pfCache[nIdx]	= m_pImpl->fFrame;
-	m_pImpl->pWmCache[nIdx]	= mOut;
+	mOut = m_pImpl->pWmCache[nIdx];
 }
 
 /*!***************************************************************************
@@ -2639,6 +5714,44 @@ PVRTMat4 CPVRTModelPOD::GetWorldMatrix(const SPODNode& node) const
 	return mWorld;
 }
 
+/*!***************************************************************************
+ @Function			GetAllWorldMatrices
+ @Output			pmWorld			Array of nNumNode matrices
+ @Input				fFrame			Frame number
+ @Description		Generates the world matrix of every node at the given frame
+					in one parent-before-child sweep of the hierarchy.
+*****************************************************************************/
+void CPVRTModelPOD::GetAllWorldMatrices(
+	PVRTMATRIX		* const pmWorld,
+	const VERTTYPE	fFrame) const
+{
+	if(!m_pImpl->pnNodeOrder)
+	{
+		// The hierarchy could not be sorted, so solve each node separately
+		int			nFrame;
+		VERTTYPE	fBlend;
+
+		PODSplitFrame(*this, fFrame, nFrame, fBlend);
+
+		for(unsigned int i = 0; i < nNumNode; ++i)
+			PODGetWorldMatrix(*this, pmWorld[i], pNode[i], nFrame, fBlend);
+		return;
+	}
+
+	// Start from the local transforms...
+	EvaluateAllNodes(pmWorld, fFrame);
+
+	// ...and apply each parent's transform, which is already final
+	for(unsigned int i = 0; i < nNumNode; ++i)
+	{
+		const unsigned int	nIdx	= m_pImpl->pnNodeOrder[i];
+		const int			nParent	= pNode[nIdx].nIdxParent;
+
+		if(nParent >= 0)
+			PVRTMatrixMultiply(pmWorld[nIdx], pmWorld[nIdx], pmWorld[nParent]);
+	}
+}
+
 /*!***************************************************************************
  @Function			GetBoneWorldMatrix
  @Output			mOut			Bone world matrix
@@ -2652,25 +5765,16 @@ void CPVRTModelPOD::GetBoneWorldMatrix(
 	const SPODNode	&NodeBone)
 {
 	PVRTMATRIX	mTmp;
-	VERTTYPE	fFrame;
-
-	fFrame = m_pImpl->fFrame;
-
-	SetFrame(0);
 
-	// Transform by object matrix
-	GetWorldMatrix(mOut, NodeMesh);
+	// Transform by object matrix, taken from the frame 0 cache
+	mOut = m_pImpl->pWmZeroCache[&NodeMesh - pNode];
 
 	// Back transform bone from frame 0 position
-	GetWorldMatrix(mTmp, NodeBone);
-	PVRTMatrixInverse(mTmp, mTmp);
-	PVRTMatrixMultiply(mOut, mOut, mTmp);
+	PVRTMatrixMultiply(mOut, mOut, m_pImpl->pWmZeroInvCache[&NodeBone - pNode]);
 
 	// The bone origin should now be at the origin
 
-	SetFrame(fFrame);
-
-	// Transform bone into frame fFrame position
+	// Transform bone into the current frame's position
 	GetWorldMatrix(mTmp, NodeBone);
 	PVRTMatrixMultiply(mOut, mOut, mTmp);
 }
@@ -2691,6 +5795,192 @@ PVRTMat4 CPVRTModelPOD::GetBoneWorldMatrix(
 	return mOut;
 }
 
+/*!***************************************************************************
+ @Function			GetSkinPalette
+ @Output			pmPalette		Bone matrices of the batch
+ @Input				NodeMesh		Mesh node being drawn
+ @Input				nBatch			Bone batch of the mesh
+ @Return			Number of matrices written
+ @Description		Generates the bone world matrices of every bone in a batch
+					at the current frame.
+*****************************************************************************/
+unsigned int CPVRTModelPOD::GetSkinPalette(
+	PVRTMATRIX			* const pmPalette,
+	const SPODNode		&NodeMesh,
+	const unsigned int	nBatch) const
+{
+	// Make sure the whole frame is in the cache
+	PVRTMATRIX mTmp;
+	GetWorldMatrix(mTmp, NodeMesh);
+
+	const PVRTMATRIX *pmWorld = m_pImpl->fFrame == 0 ? m_pImpl->pWmZeroCache : m_pImpl->pWmCache;
+	return PODGetSkinPalette(*this, *m_pImpl, pmWorld, pmPalette, (unsigned int)(&NodeMesh - pNode), nBatch);
+}
+
+/*!***************************************************************************
+ @Function			BakeAnimation
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Resamples the position, rotation and scale animation of
+					every node into contiguous per-channel, per-frame arrays.
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::BakeAnimation()
+{
+#ifdef PVRT_FIXED_POINT_ENABLE
+	return PVR_FAIL;
+#else
+	if(!m_pImpl)
+		return PVR_FAIL;
+
+	SPODAnimTracks *pTracks = m_pImpl->pTracks;
+	if(pTracks)
+	{
+		FREE(pTracks->pfData);
+		FREE(pTracks->pu8Flags);
+	}
+	else
+	{
+		pTracks = new SPODAnimTracks;
+		m_pImpl->pTracks = pTracks;
+	}
+	memset(pTracks, 0, sizeof(*pTracks));
+
+	pTracks->nNumFrame	= PVRT_MAX(nNumFrame, 1u);
+	pTracks->nNumNode	= nNumNode;
+
+	const size_t nChannel = (size_t) pTracks->nNumFrame * nNumNode;
+
+	if(!SafeAlloc(pTracks->pfData, nChannel * 10) || !SafeAlloc(pTracks->pu8Flags, nNumNode))
+	{
+		FREE(pTracks->pfData);
+		delete pTracks;
+		m_pImpl->pTracks = 0;
+		return PVR_FAIL;
+	}
+
+	if(!nChannel)
+		return PVR_SUCCESS;
+
+	for(unsigned int i = 0; i < 3; ++i)
+	{
+		pTracks->pfPos[i]	= &pTracks->pfData[nChannel * i];
+		pTracks->pfScale[i]	= &pTracks->pfData[nChannel * (3 + i)];
+	}
+
+	for(unsigned int i = 0; i < 4; ++i)
+		pTracks->pfRot[i] = &pTracks->pfData[nChannel * (6 + i)];
+
+	for(unsigned int i = 0; i < nNumNode; ++i)
+		PODBakeNode(*pTracks, pNode[i], i);
+
+	return PVR_SUCCESS;
+#endif
+}
+
+/*!***************************************************************************
+ @Function			HasBakedAnimation
+ @Return			true if BakeAnimation() has been called successfully
+*****************************************************************************/
+bool CPVRTModelPOD::HasBakedAnimation() const
+{
+	return m_pImpl && m_pImpl->pTracks;
+}
+
+/*!***************************************************************************
+ @Function			EvaluateAllNodes
+ @Output			pmLocal			Array of nNumNode matrices
+ @Input				fFrame			Frame number
+ @Description		Generates the transformation of every node relative to its
+					parent at the given frame.
+*****************************************************************************/
+void CPVRTModelPOD::EvaluateAllNodes(
+	PVRTMATRIX		* const pmLocal,
+	const VERTTYPE	fFrame) const
+{
+	int			nFrame;
+	VERTTYPE	fBlend;
+
+	PODSplitFrame(*this, fFrame, nFrame, fBlend);
+
+#ifndef PVRT_FIXED_POINT_ENABLE
+	const SPODAnimTracks * const pTracks = m_pImpl ? m_pImpl->pTracks : 0;
+
+	if(pTracks && pTracks->nNumNode == nNumNode)
+	{
+		const unsigned int	nLast	= pTracks->nNumFrame - 1;
+		const size_t		nKey0	= (size_t) PVRT_MIN((unsigned int) nFrame, nLast) * nNumNode;
+		const size_t		nKey1	= (size_t) PVRT_MIN((unsigned int) nFrame + 1, nLast) * nNumNode;
+		const float			t		= fBlend;
+
+		const float *pfPX0 = &pTracks->pfPos[0][nKey0], *pfPX1 = &pTracks->pfPos[0][nKey1];
+		const float *pfPY0 = &pTracks->pfPos[1][nKey0], *pfPY1 = &pTracks->pfPos[1][nKey1];
+		const float *pfPZ0 = &pTracks->pfPos[2][nKey0], *pfPZ1 = &pTracks->pfPos[2][nKey1];
+		const float *pfSX0 = &pTracks->pfScale[0][nKey0], *pfSX1 = &pTracks->pfScale[0][nKey1];
+		const float *pfSY0 = &pTracks->pfScale[1][nKey0], *pfSY1 = &pTracks->pfScale[1][nKey1];
+		const float *pfSZ0 = &pTracks->pfScale[2][nKey0], *pfSZ1 = &pTracks->pfScale[2][nKey1];
+
+		for(unsigned int i = 0; i < nNumNode; ++i)
+		{
+			PVRTQUATERNIONf q;
+
+			q.x = pTracks->pfRot[0][nKey0 + i];
+			q.y = pTracks->pfRot[1][nKey0 + i];
+			q.z = pTracks->pfRot[2][nKey0 + i];
+			q.w = pTracks->pfRot[3][nKey0 + i];
+
+			if(pTracks->pu8Flags[i] & ePODHasRotationAni)
+			{
+				PVRTQUATERNIONf q1;
+
+				q1.x = pTracks->pfRot[0][nKey1 + i];
+				q1.y = pTracks->pfRot[1][nKey1 + i];
+				q1.z = pTracks->pfRot[2][nKey1 + i];
+				q1.w = pTracks->pfRot[3][nKey1 + i];
+
+				PVRTMatrixQuaternionSlerpF(q, q, q1, t);
+			}
+
+			// Scale * Rotation * Translation, written out directly
+			const float sx = pfSX0[i] + t * (pfSX1[i] - pfSX0[i]);
+			const float sy = pfSY0[i] + t * (pfSY1[i] - pfSY0[i]);
+			const float sz = pfSZ0[i] + t * (pfSZ1[i] - pfSZ0[i]);
+
+			float * const f = pmLocal[i].f;
+
+			f[ 0] = sx * (1.0f - 2.0f*q.y*q.y - 2.0f*q.z*q.z);
+			f[ 1] = sx * (2.0f*q.x*q.y - 2.0f*q.z*q.w);
+			f[ 2] = sx * (2.0f*q.x*q.z + 2.0f*q.y*q.w);
+			f[ 3] = 0.0f;
+
+			f[ 4] = sy * (2.0f*q.x*q.y + 2.0f*q.z*q.w);
+			f[ 5] = sy * (1.0f - 2.0f*q.x*q.x - 2.0f*q.z*q.z);
+			f[ 6] = sy * (2.0f*q.y*q.z - 2.0f*q.x*q.w);
+			f[ 7] = 0.0f;
+
+			f[ 8] = sz * (2.0f*q.x*q.z - 2.0f*q.y*q.w);
+			f[ 9] = sz * (2.0f*q.y*q.z + 2.0f*q.x*q.w);
+			f[10] = sz * (1.0f - 2.0f*q.x*q.x - 2.0f*q.y*q.y);
+			f[11] = 0.0f;
+
+			f[12] = pfPX0[i] + t * (pfPX1[i] - pfPX0[i]);
+			f[13] = pfPY0[i] + t * (pfPY1[i] - pfPY0[i]);
+			f[14] = pfPZ0[i] + t * (pfPZ1[i] - pfPZ0[i]);
+			f[15] = 1.0f;
+		}
+
+		// Matrix-animated nodes are not resampled
+		for(unsigned int i = 0; i < nNumNode; ++i)
+		{
+			if(pTracks->pu8Flags[i] & ePODHasMatrixAni)
+				PODGetTransformationMatrix(pmLocal[i], pNode[i], nFrame);
+		}
+		return;
+	}
+#endif
+
+	for(unsigned int i = 0; i < nNumNode; ++i)
+		PODGetLocalMatrix(pmLocal[i], pNode[i], nFrame, fBlend);
+}
+
 /*!***************************************************************************
  @Function			GetCamera
  @Output			vFrom			Position of the camera
@@ -2999,6 +6289,230 @@ EPVRTError CPVRTModelPOD::SavePOD(const char * const pszFilename, const char * c
 	return bRet ? PVR_SUCCESS : PVR_FAIL;
 }
 
+/*!***************************************************************************
+ @Function			SaveCooked
+ @Input				pszFilename			Filename to save to
+ @Input				pszSourceFilename	If not NULL, the POD file the scene was
+										read from
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Save the scene as a cooked file for ReadFromFileCooked().
+*****************************************************************************/
+EPVRTError CPVRTModelPOD::SaveCooked(const char * const pszFilename, const char * const pszSourceFilename)
+{
+	SPODCookedWriter	w;
+	SPODCookedHeader	sHeader;
+	size_t				nScene, nFixups = 0;
+	bool				bRet = false;
+	FILE				*pFile;
+
+	memset(&w, 0, sizeof(w));
+	memset(&sHeader, 0, sizeof(sHeader));
+
+	if(pszSourceFilename && !PODCookedSource(pszSourceFilename, sHeader))
+		return PVR_FAIL;
+
+	// Reserve the header, then add the scene and the offset table. The header is at offset 0
+	PODCookedAlloc(w, sizeof(sHeader), 1);
+	if(!w.pData)
+		goto done;
+
+	nScene = PODCookScene(w, *this);
+	if(!nScene)
+		goto done;
+
+	if(w.nNumFixups)
+	{
+		nFixups = PODCookedAlloc(w, w.nNumFixups * sizeof(*w.pnFixups), sizeof(*w.pnFixups));
+		if(!nFixups)
+			goto done;
+
+		memcpy(w.pData + nFixups, w.pnFixups, w.nNumFixups * sizeof(*w.pnFixups));
+	}
+
+	if(w.nSize > 0xFFFFFFFF)
+		goto done;
+
+	sHeader.nMagic		= PVRTMODELPOD_COOKED_MAGIC;
+	sHeader.nVersion	= PVRTMODELPOD_COOKED_VERSION;
+	sHeader.nSize		= (PVRTuint32) w.nSize;
+	sHeader.nScene		= (PVRTuint32) nScene;
+	sHeader.nFixups		= (PVRTuint32) nFixups;
+	sHeader.nNumFixups	= w.nNumFixups;
+	PODCookedLayout(sHeader.pnLayout);
+	memcpy(w.pData, &sHeader, sizeof(sHeader));
+
+	pFile = fopen(pszFilename, "wb");
+	if(!pFile)
+		goto done;
+
+	bRet = fwrite(w.pData, 1, w.nSize, pFile) == w.nSize;
+	bRet = fclose(pFile) == 0 && bRet;
+
+done:
+	FREE(w.pData);
+	FREE(w.pnFixups);
+	return bRet ? PVR_SUCCESS : PVR_FAIL;
+}
+
+/****************************************************************************
+** Class: CPVRTModelPODContext
+****************************************************************************/
+
+/*!***************************************************************************
+ @Function			Constructor
+ @Description		Initializes the context to an unattached state
+*****************************************************************************/
+CPVRTModelPODContext::CPVRTModelPODContext() :
+	m_pPOD(NULL), m_fFrame(0), m_bValid(false), m_pmWorld(NULL)
+{}
+
+/*!***************************************************************************
+ @Function			Destructor
+ @Description		Frees the memory allocated by the context.
+*****************************************************************************/
+CPVRTModelPODContext::~CPVRTModelPODContext()
+{
+	Destroy();
+}
+
+/*!***************************************************************************
+ @Function			Init
+ @Input				pod				The loaded model to animate
+ @Return			PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description		Attaches the context to a model and sets frame 0.
+*****************************************************************************/
+EPVRTError CPVRTModelPODContext::Init(const CPVRTModelPOD &pod)
+{
+	Destroy();
+
+	if(!pod.m_pImpl)
+		return PVR_FAIL;
+
+	m_pmWorld = new PVRTMATRIX[pod.nNumNode];
+	if(!m_pmWorld)
+		return PVR_FAIL;
+
+	m_pPOD		= &pod;
+	m_fFrame	= 0;
+	m_bValid	= false;
+	return PVR_SUCCESS;
+}
+
+/*!***************************************************************************
+ @Function			Destroy
+ @Description		Frees the context's cache and detaches it from its model.
+*****************************************************************************/
+void CPVRTModelPODContext::Destroy()
+{
+	delete [] m_pmWorld;
+
+	m_pPOD		= NULL;
+	m_fFrame	= 0;
+	m_bValid	= false;
+	m_pmWorld	= NULL;
+}
+
+/*!***************************************************************************
+ @Function			SetFrame
+ @Input				fFrame			Frame number
+ @Description		Set the animation frame for which subsequent Get*() calls
+					should return data.
+*****************************************************************************/
+void CPVRTModelPODContext::SetFrame(const VERTTYPE fFrame)
+{
+	if(fFrame != m_fFrame)
+	{
+		m_fFrame = fFrame;
+		m_bValid = false;
+	}
+}
+
+/*!***************************************************************************
+ @Function			GetFrame
+ @Return			The current frame number
+*****************************************************************************/
+VERTTYPE CPVRTModelPODContext::GetFrame() const
+{
+	return m_fFrame;
+}
+
+/*!***************************************************************************
+ @Function			GetWorldMatrices
+ @Return			Array of the world matrices of all nodes at the current frame
+ @Description		Solves the whole hierarchy the first time it is needed
+					after SetFrame().
+*****************************************************************************/
+const PVRTMATRIX* CPVRTModelPODContext::GetWorldMatrices()
+{
+	_ASSERT(m_pPOD);
+
+	if(!m_bValid)
+	{
+		// Frame 0 is already solved by the model itself
+		if(m_fFrame == 0)
+			memcpy(m_pmWorld, m_pPOD->m_pImpl->pWmZeroCache, m_pPOD->nNumNode * sizeof(*m_pmWorld));
+		else
+			m_pPOD->GetAllWorldMatrices(m_pmWorld, m_fFrame);
+
+		m_bValid = true;
+	}
+
+	return m_pmWorld;
+}
+
+/*!***************************************************************************
+ @Function			GetWorldMatrix
+ @Output			mOut			World matrix
+ @Input				node			Node of the model to get the world matrix of
+ @Description		Generates the world matrix for the given node at the
+					current frame of this context.
+*****************************************************************************/
+void CPVRTModelPODContext::GetWorldMatrix(
+	PVRTMATRIX		&mOut,
+	const SPODNode	&node)
+{
+	mOut = GetWorldMatrices()[&node - m_pPOD->pNode];
+}
+
+/*!***************************************************************************
+ @Function			GetBoneWorldMatrix
+ @Output			mOut			Bone world matrix
+ @Input				NodeMesh		Mesh to take the world matrix from
+ @Input				NodeBone		Bone to take the matrix from
+ @Description		Generates the world matrix for the given bone at the
+					current frame of this context.
+*****************************************************************************/
+void CPVRTModelPODContext::GetBoneWorldMatrix(
+	PVRTMATRIX		&mOut,
+	const SPODNode	&NodeMesh,
+	const SPODNode	&NodeBone)
+{
+	const SPVRTPODImpl * const pImpl = m_pPOD->m_pImpl;
+
+	// Transform by object matrix, then back transform bone from frame 0 position
+	PVRTMatrixMultiply(mOut, pImpl->pWmZeroCache[&NodeMesh - m_pPOD->pNode], pImpl->pWmZeroInvCache[&NodeBone - m_pPOD->pNode]);
+
+	// Transform bone into this context's frame position
+	PVRTMatrixMultiply(mOut, mOut, GetWorldMatrices()[&NodeBone - m_pPOD->pNode]);
+}
+
+/*!***************************************************************************
+ @Function			GetSkinPalette
+ @Output			pmPalette		Bone matrices of the batch
+ @Input				NodeMesh		Mesh node being drawn
+ @Input				nBatch			Bone batch of the mesh
+ @Return			Number of matrices written
+ @Description		Generates the bone world matrices of every bone in a batch
+					at the current frame of this context.
+*****************************************************************************/
+unsigned int CPVRTModelPODContext::GetSkinPalette(
+	PVRTMATRIX			* const pmPalette,
+	const SPODNode		&NodeMesh,
+	const unsigned int	nBatch)
+{
+	return PODGetSkinPalette(*m_pPOD, *m_pPOD->m_pImpl, GetWorldMatrices(), pmPalette, (unsigned int)(&NodeMesh - m_pPOD->pNode), nBatch);
+}
+
 
 /*!***************************************************************************
  @Function			PVRTModelPODDataTypeSize
@@ -3160,6 +6674,26 @@ void PVRTModelPODDataConvert(CPODData &data, const unsigned int nCnt, const EPVR
 	}
 }
 
+/*!***************************************************************************
+ @Function			PVRTModelPODDataConvert
+ @Input				pod			Scene owning the data
+ @Modified			data		Data elements to convert
+ @Input				eNewType	New type of elements
+ @Input				nCnt		Number of elements
+ @Return			PVR_SUCCESS, or PVR_FAIL if the data belongs to a cooked
+					scene or memory runs out
+ @Description		As PVRTModelPODDataConvert(data, ...), but first copies the
+					array if it is borrowed from the scene's file mapping.
+*****************************************************************************/
+EPVRTError PVRTModelPODDataConvert(const CPVRTModelPOD &pod, CPODData &data, const unsigned int nCnt, const EPVRTDataType eNewType)
+{
+	if(pod.IsMappedData(&data) || !CopyUnlessOwned(pod, data.pData, nCnt * data.nStride))
+		return PVR_FAIL;
+
+	PVRTModelPODDataConvert(data, nCnt, eNewType);
+	return PVR_SUCCESS;
+}
+
 /*!***************************************************************************
  @Function		PVRTModelPODScaleAndConvertVtxData
  @Modified		mesh		POD mesh to scale and convert the mesh data
@@ -3296,6 +6830,22 @@ EPVRTError PVRTModelPODScaleAndConvertVtxData(SPODMesh &mesh, const EPVRTDataTyp
 
 	return PVR_SUCCESS;
 }
+
+/*!***************************************************************************
+ @Function		PVRTModelPODScaleAndConvertVtxData
+ @Input			pod			Scene owning the mesh
+ @Modified		mesh		POD mesh to scale and convert the mesh data
+ @Input			eNewType	The data type to scale and convert the vertex data to
+ @Return		PVR_SUCCESS on success and PVR_FAIL on failure.
+ @Description	As PVRTModelPODScaleAndConvertVtxData(mesh, ...), for mapped scenes (see ReadFromFileMapped()).
+*****************************************************************************/
+EPVRTError PVRTModelPODScaleAndConvertVtxData(const CPVRTModelPOD &pod, SPODMesh &mesh, const EPVRTDataType eNewType)
+{
+	if(!CopyMeshDataUnlessOwned(pod, mesh))
+		return PVR_FAIL;
+
+	return PVRTModelPODScaleAndConvertVtxData(mesh, eNewType);
+}
 #endif
 /*!***************************************************************************
  @Function			PVRTModelPODDataShred
@@ -3536,10 +7086,27 @@ void PVRTModelPODToggleInterleaved(SPODMesh &mesh, unsigned int ui32AlignToNByte
 			if(PVRTModelPODDataTypeSize(mesh.sBoneIdx.eType) == nBytes)
 				InterleaveArray((char*)mesh.pInterleaved, mesh.sBoneIdx, mesh.nNumVertex, nStride, nOffset);
 
-			if(PVRTModelPODDataTypeSize(mesh.sBoneWeight.eType) == nBytes)
-				InterleaveArray((char*)mesh.pInterleaved, mesh.sBoneWeight, mesh.nNumVertex, nStride, nOffset);
-		}
-	}
+			if(PVRTModelPODDataTypeSize(mesh.sBoneWeight.eType) == nBytes)
+				InterleaveArray((char*)mesh.pInterleaved, mesh.sBoneWeight, mesh.nNumVertex, nStride, nOffset);
+		}
+	}
+}
+
+/*!***************************************************************************
+ @Function		PVRTModelPODToggleInterleaved
+ @Input			pod			Scene owning the mesh
+ @Modified		mesh		Mesh to modify
+ @Input			ui32AlignToNBytes Align the interleaved data to this no. of bytes.
+ @Return		PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description	As PVRTModelPODToggleInterleaved(mesh, ...), for mapped scenes (see ReadFromFileMapped()).
+*****************************************************************************/
+EPVRTError PVRTModelPODToggleInterleaved(const CPVRTModelPOD &pod, SPODMesh &mesh, unsigned int ui32AlignToNBytes)
+{
+	if(!CopyMeshDataUnlessOwned(pod, mesh))
+		return PVR_FAIL;
+
+	PVRTModelPODToggleInterleaved(mesh, ui32AlignToNBytes);
+	return PVR_SUCCESS;
 }
 
 /*!***************************************************************************
@@ -3585,6 +7152,22 @@ void PVRTModelPODDeIndex(SPODMesh &mesh)
 	mesh.sFaces.nStride	= 0;
 }
 
+/*!***************************************************************************
+ @Function		PVRTModelPODDeIndex
+ @Input			pod			Scene owning the mesh
+ @Modified		mesh		Mesh to modify
+ @Return		PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description	As PVRTModelPODDeIndex(mesh), for mapped scenes (see ReadFromFileMapped()).
+*****************************************************************************/
+EPVRTError PVRTModelPODDeIndex(const CPVRTModelPOD &pod, SPODMesh &mesh)
+{
+	if(!CopyMeshDataUnlessOwned(pod, mesh))
+		return PVR_FAIL;
+
+	PVRTModelPODDeIndex(mesh);
+	return PVR_SUCCESS;
+}
+
 /*!***************************************************************************
  @Function			PVRTModelPODToggleStrips
  @Modified			mesh		Mesh to modify
@@ -3752,6 +7335,614 @@ void PVRTModelPODToggleStrips(SPODMesh &mesh)
 	FREE(old.pData);
 }
 
+/*!***************************************************************************
+ @Function		PVRTModelPODToggleStrips
+ @Input			pod			Scene owning the mesh
+ @Modified		mesh		Mesh to modify
+ @Return		PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description	As PVRTModelPODToggleStrips(mesh), for mapped scenes (see ReadFromFileMapped()).
+*****************************************************************************/
+EPVRTError PVRTModelPODToggleStrips(const CPVRTModelPOD &pod, SPODMesh &mesh)
+{
+	if(!CopyMeshDataUnlessOwned(pod, mesh))
+		return PVR_FAIL;
+
+	PVRTModelPODToggleStrips(mesh);
+	return PVR_SUCCESS;
+}
+
+/*!***************************************************************************
+ @Function			RemapVertexArray
+ @Modified			pData		Vertex array to reorder
+ @Input				nStride		Distance in bytes from one vertex to the next
+ @Input				nNumVertex	Number of vertices
+ @Input				pui32Remap	The new index of each vertex
+ @Modified			pTmp		Scratch space of nStride * nNumVertex bytes
+ @Description		Moves each vertex of the array to its new index.
+*****************************************************************************/
+static void RemapVertexArray(
+	unsigned char		* const pData,
+	const size_t		nStride,
+	const unsigned int	nNumVertex,
+	const unsigned int	* const pui32Remap,
+	unsigned char		* const pTmp)
+{
+	if(!pData || !nStride)
+		return;
+
+	for(unsigned int i = 0; i < nNumVertex; ++i)
+		memcpy(pTmp + pui32Remap[i] * nStride, pData + i * nStride, nStride);
+	memcpy(pData, pTmp, nNumVertex * nStride);
+}
+
+/*!***************************************************************************
+ @Function		PVRTModelPODOptimiseVertexCache
+ @Modified		mesh			Mesh to modify; must be an indexed triangle list
+ @Output		pfACMRBefore	If not NULL, the average cache miss ratio of
+								the original triangle order
+ @Output		pfACMRAfter		If not NULL, the average cache miss ratio of
+								the new triangle order
+ @Return		PVR_SUCCESS, or PVR_FAIL if the mesh is stripped, has an
+				index out of range, or memory runs out
+ @Description	Reorders the triangles of the mesh for post-transform vertex
+				cache reuse, then renumbers the vertices in the order the new
+				triangle list first uses them, so that vertex fetches walk
+				forwards through memory. Each bone batch is reordered on its
+				own, so the triangles stay within their batch ranges. Works
+				on interleaved and non-interleaved meshes. The ratios are
+				measured with a simulated FIFO cache of
+				PVRT_VERTEX_CACHE_SIZE entries.
+*****************************************************************************/
+EPVRTError PVRTModelPODOptimiseVertexCache(
+	SPODMesh	&mesh,
+	float		* const pfACMRBefore,
+	float		* const pfACMRAfter)
+{
+	unsigned int	*pui32Idx = 0, *pui32Remap = 0;
+	unsigned char	*pTmp = 0;
+	unsigned int	i, nIdxNum, nBatchCnt;
+	size_t			nMaxStride;
+	EPVRTError		eRet = PVR_SUCCESS;
+
+	if(pfACMRBefore)	*pfACMRBefore	= 0.0f;
+	if(pfACMRAfter)		*pfACMRAfter	= 0.0f;
+
+	if(!mesh.nNumFaces || !mesh.nNumVertex || !mesh.sFaces.pData)
+		return PVR_SUCCESS;
+
+	if(mesh.nNumStrips)
+		return PVR_FAIL;
+
+	// Widest vertex array, for the scratch space used to reorder them
+	if(mesh.pInterleaved)
+	{
+		nMaxStride = mesh.sVertex.nStride;
+	}
+	else
+	{
+		nMaxStride = PVRT_MAX(mesh.sVertex.nStride, mesh.sNormals.nStride);
+		nMaxStride = PVRT_MAX(nMaxStride, (size_t) mesh.sTangents.nStride);
+		nMaxStride = PVRT_MAX(nMaxStride, (size_t) mesh.sBinormals.nStride);
+		nMaxStride = PVRT_MAX(nMaxStride, (size_t) mesh.sVtxColours.nStride);
+		nMaxStride = PVRT_MAX(nMaxStride, (size_t) mesh.sBoneIdx.nStride);
+		nMaxStride = PVRT_MAX(nMaxStride, (size_t) mesh.sBoneWeight.nStride);
+
+		for(i = 0; i < mesh.nNumUVW; ++i)
+			nMaxStride = PVRT_MAX(nMaxStride, (size_t) mesh.psUVW[i].nStride);
+	}
+
+	nIdxNum = mesh.nNumFaces * 3;
+	if(!SafeAlloc(pui32Idx, nIdxNum) || !SafeAlloc(pui32Remap, mesh.nNumVertex) || !SafeAlloc(pTmp, nMaxStride * mesh.nNumVertex))
+	{
+		eRet = PVR_FAIL;
+		goto done;
+	}
+
+	for(i = 0; i < nIdxNum; ++i)
+	{
+		PVRTVertexRead(&pui32Idx[i], mesh.sFaces.pData + i * mesh.sFaces.nStride, mesh.sFaces.eType);
+		if(pui32Idx[i] >= mesh.nNumVertex)
+		{
+			eRet = PVR_FAIL;
+			goto done;
+		}
+	}
+
+	if(pfACMRBefore)
+		*pfACMRBefore = PVRTVertexCacheACMR(pui32Idx, mesh.nNumFaces, mesh.nNumVertex);
+
+	// Reorder the triangles of each bone batch within the batch
+	nBatchCnt = mesh.sBoneBatches.nBatchCnt ? mesh.sBoneBatches.nBatchCnt : 1;
+	for(i = 0; i < nBatchCnt && eRet == PVR_SUCCESS; ++i)
+	{
+		unsigned int nFirst = 0, nEnd = mesh.nNumFaces;
+
+		if(mesh.sBoneBatches.nBatchCnt)
+		{
+			nFirst = mesh.sBoneBatches.pnBatchOffset[i];
+			if(i + 1 < nBatchCnt)
+				nEnd = mesh.sBoneBatches.pnBatchOffset[i + 1];
+		}
+
+		if(nEnd > nFirst)
+			eRet = PVRTVertexCacheOptimise(&pui32Idx[3 * nFirst], nEnd - nFirst, mesh.nNumVertex);
+	}
+	if(eRet != PVR_SUCCESS)
+		goto done;
+
+	// Renumber the vertices by first use, and move the vertex data to match
+	PVRTVertexCacheRemap(pui32Remap, pui32Idx, nIdxNum, mesh.nNumVertex);
+
+	if(mesh.pInterleaved)
+	{
+		RemapVertexArray(mesh.pInterleaved, mesh.sVertex.nStride, mesh.nNumVertex, pui32Remap, pTmp);
+	}
+	else
+	{
+		RemapVertexArray(mesh.sVertex.pData, mesh.sVertex.nStride, mesh.nNumVertex, pui32Remap, pTmp);
+		RemapVertexArray(mesh.sNormals.pData, mesh.sNormals.nStride, mesh.nNumVertex, pui32Remap, pTmp);
+		RemapVertexArray(mesh.sTangents.pData, mesh.sTangents.nStride, mesh.nNumVertex, pui32Remap, pTmp);
+		RemapVertexArray(mesh.sBinormals.pData, mesh.sBinormals.nStride, mesh.nNumVertex, pui32Remap, pTmp);
+		RemapVertexArray(mesh.sVtxColours.pData, mesh.sVtxColours.nStride, mesh.nNumVertex, pui32Remap, pTmp);
+		RemapVertexArray(mesh.sBoneIdx.pData, mesh.sBoneIdx.nStride, mesh.nNumVertex, pui32Remap, pTmp);
+		RemapVertexArray(mesh.sBoneWeight.pData, mesh.sBoneWeight.nStride, mesh.nNumVertex, pui32Remap, pTmp);
+
+		for(i = 0; i < mesh.nNumUVW; ++i)
+			RemapVertexArray(mesh.psUVW[i].pData, mesh.psUVW[i].nStride, mesh.nNumVertex, pui32Remap, pTmp);
+	}
+
+	for(i = 0; i < nIdxNum; ++i)
+	{
+		pui32Idx[i] = pui32Remap[pui32Idx[i]];
+		PVRTVertexWrite(mesh.sFaces.pData + i * mesh.sFaces.nStride, mesh.sFaces.eType, pui32Idx[i]);
+	}
+
+	if(pfACMRAfter)
+		*pfACMRAfter = PVRTVertexCacheACMR(pui32Idx, mesh.nNumFaces, mesh.nNumVertex);
+
+done:
+	FREE(pui32Idx);
+	FREE(pui32Remap);
+	FREE(pTmp);
+	return eRet;
+}
+
+#if !defined(PVRT_FIXED_POINT_ENABLE)
+/*!***************************************************************************
+ @Struct		SPackArray
+ @Brief			A vertex array of a mesh being packed, and its new format
+*****************************************************************************/
+struct SPackArray
+{
+	CPODData			*pData;		/*!< Array of the mesh */
+	const PVRTuint8		*pSrc;		/*!< First element of the original data */
+	PVRTuint32			nSrcStride;	/*!< Stride of the original data */
+	EPVRTDataType		eSrcType;	/*!< Type of the original data */
+	PVRTuint32			nSrcCnt;	/*!< Components per element of the original data */
+	PVRTuint32			nSrcSize;	/*!< Size in bytes of an original element */
+	EPVRTDataType		eType;		/*!< Packed type */
+	PVRTuint32			n;			/*!< Packed values per vertex */
+	size_t				nOffset;	/*!< Offset of the packed element in the vertex */
+	unsigned int		ui32Pack;	/*!< EPODPackData flag the array is packed with; 0 if copied */
+	PVRTVECTOR3f		vScale;		/*!< Positions and texture coordinates: original = packed * scale + offset */
+	PVRTVECTOR3f		vOffset;
+};
+
+/*!***************************************************************************
+ @Function			PackRange
+ @Modified			sArray		Array to quantise; its source must be float
+ @Input				nNumVertex	Number of vertices
+ @Description		Fills the scale and offset that map each channel's range
+					onto the shorts [-32767, 32767].
+*****************************************************************************/
+static void PackRange(SPackArray &sArray, const unsigned int nNumVertex)
+{
+	float afMin[3], afMax[3];
+	unsigned int i, j;
+
+	for(j = 0; j < 3; ++j)
+	{
+		afMin[j] = 0.0f;
+		afMax[j] = 0.0f;
+	}
+
+	for(i = 0; i < nNumVertex; ++i)
+	{
+		const float * const pf = (const float*) (sArray.pSrc + i * sArray.nSrcStride);
+
+		for(j = 0; j < sArray.n; ++j)
+		{
+			if(!i || pf[j] < afMin[j])	afMin[j] = pf[j];
+			if(!i || pf[j] > afMax[j])	afMax[j] = pf[j];
+		}
+	}
+
+	float * const pfScale	= &sArray.vScale.x;
+	float * const pfOffset	= &sArray.vOffset.x;
+	for(j = 0; j < 3; ++j)
+	{
+		pfScale[j]	= afMax[j] > afMin[j] ? (afMax[j] - afMin[j]) / 65534.0f : 1.0f;
+		pfOffset[j]	= afMin[j] + 32767.0f * pfScale[j];
+	}
+}
+
+/*!***************************************************************************
+ @Function			PackShorts
+ @Input				sArray		Array being quantised
+ @Input				pf			Original values
+ @Output			pOut		Packed values
+ @Return			Largest error of the packed values
+ @Description		Quantises positions or texture coordinates to shorts.
+*****************************************************************************/
+static float PackShorts(const SPackArray &sArray, const float * const pf, PVRTuint8 * const pOut)
+{
+	const float * const pfScale		= &sArray.vScale.x;
+	const float * const pfOffset	= &sArray.vOffset.x;
+	float fError = 0.0f;
+
+	for(unsigned int j = 0; j < sArray.n; ++j)
+	{
+		float fPacked = floorf((pf[j] - pfOffset[j]) / pfScale[j] + 0.5f);
+		fPacked = PVRT_MAX(-32767.0f, PVRT_MIN(32767.0f, fPacked));
+
+		const short i16Packed = (short) fPacked;
+		memcpy(pOut + j * sizeof(i16Packed), &i16Packed, sizeof(i16Packed));
+
+		fError = PVRT_MAX(fError, (float) fabs(fPacked * pfScale[j] + pfOffset[j] - pf[j]));
+	}
+	return fError;
+}
+
+/*!***************************************************************************
+ @Function			PackDirection
+ @Input				pf			Original vector
+ @Output			pOut		Three normalised bytes
+ @Return			Angle in radians between the original and packed vectors
+ @Description		Quantises a normal, tangent or binormal to near unit length
+					normalised bytes. Of the codes next to the exact value,
+					the one closest in direction is chosen.
+*****************************************************************************/
+static float PackDirection(const float * const pf, PVRTuint8 * const pOut)
+{
+	float fLength = sqrtf(pf[0] * pf[0] + pf[1] * pf[1] + pf[2] * pf[2]);
+	float afFloor[3], afBest[3], fBestCos = -2.0f;
+	unsigned int i, j;
+
+	if(fLength <= 0.0f)
+	{
+		memset(pOut, 0, 3);
+		return 0.0f;
+	}
+
+	for(j = 0; j < 3; ++j)
+		afFloor[j] = floorf(pf[j] / fLength * 127.0f);
+
+	for(i = 0; i < 8; ++i)
+	{
+		float afCode[3], fCodeLength;
+
+		for(j = 0; j < 3; ++j)
+			afCode[j] = PVRT_MAX(-127.0f, PVRT_MIN(127.0f, afFloor[j] + (float)((i >> j) & 1)));
+
+		fCodeLength = sqrtf(afCode[0] * afCode[0] + afCode[1] * afCode[1] + afCode[2] * afCode[2]);
+		if(fCodeLength <= 0.0f)
+			continue;
+
+		const float fCos = (afCode[0] * pf[0] + afCode[1] * pf[1] + afCode[2] * pf[2]) / (fCodeLength * fLength);
+		if(fCos > fBestCos)
+		{
+			fBestCos = fCos;
+			for(j = 0; j < 3; ++j)
+				afBest[j] = afCode[j];
+		}
+	}
+
+	for(j = 0; j < 3; ++j)
+		pOut[j] = (PVRTuint8)(signed char) afBest[j];
+
+	return acosf(PVRT_MIN(1.0f, fBestCos));
+}
+
+/*!***************************************************************************
+ @Function			PackWeights
+ @Input				pf			Original weights
+ @Input				n			Number of weights
+ @Output			pOut		Normalised unsigned bytes
+ @Return			Largest error of the packed weights
+ @Description		Quantises bone weights, rounding so that the packed
+					weights add up to the rounded sum of the originals.
+*****************************************************************************/
+static float PackWeights(const float * const pf, const unsigned int n, PVRTuint8 * const pOut)
+{
+	float fSum = 0.0f, fError = 0.0f;
+	int i32Total = 0, i32Target;
+	unsigned int j;
+
+	for(j = 0; j < n; ++j)
+	{
+		const float fWeight = PVRT_MAX(0.0f, PVRT_MIN(1.0f, pf[j]));
+		pOut[j] = (PVRTuint8) floorf(fWeight * 255.0f);
+		i32Total += pOut[j];
+		fSum += fWeight;
+	}
+
+	// Hand the rounding remainder to the weights that lost most to the floor
+	i32Target = (int) PVRT_MIN(255.0f * n, floorf(fSum * 255.0f + 0.5f));
+	while(i32Total < i32Target)
+	{
+		unsigned int jBest = 0;
+		float fBestLoss = -1.0f;
+
+		for(j = 0; j < n; ++j)
+		{
+			const float fLoss = PVRT_MIN(1.0f, pf[j]) * 255.0f - pOut[j];
+			if(pOut[j] < 255 && fLoss > fBestLoss)
+			{
+				fBestLoss	= fLoss;
+				jBest		= j;
+			}
+		}
+		++pOut[jBest];
+		++i32Total;
+	}
+
+	for(j = 0; j < n; ++j)
+		fError = PVRT_MAX(fError, (float) fabs(pOut[j] / 255.0f - pf[j]));
+	return fError;
+}
+
+/*!***************************************************************************
+ @Function		PVRTModelPODPackVertexData
+ @Input			pod					Scene owning the mesh
+ @Modified		mesh				Mesh to modify
+ @Input			ui32Pack			EPODPackData flags of the attributes to quantise
+ @Input			ui32AlignToNBytes	Align the vertex stride to this no. of bytes
+ @Output		psReport			If not NULL, the size savings, the largest
+									error of each kind of attribute, and the
+									texture coordinate unpacking
+ @Return		PVR_SUCCESS, or PVR_FAIL if the mesh belongs to a cooked
+				scene or memory runs out
+ @Description	Quantises the chosen float attributes of the mesh and
+				interleaves all of its vertex data into one buffer. Each
+				attribute starts on a 4 byte boundary.
+*****************************************************************************/
+EPVRTError PVRTModelPODPackVertexData(
+	const CPVRTModelPOD	&pod,
+	SPODMesh			&mesh,
+	const unsigned int	ui32Pack,
+	const unsigned int	ui32AlignToNBytes,
+	SPODPackReport		* const psReport)
+{
+	SPackArray		*psArrays = 0;
+	PVRTuint8		*pNew = 0;
+	CPODData		*apData[7];
+	unsigned int	i, j, nArrays, nMaxArrays;
+	size_t			nStride, nBytesBefore;
+	PVRTVECTOR4f	v;
+
+	if(psReport)
+	{
+		memset(psReport, 0, sizeof(*psReport));
+		for(i = 0; i < PVRTMODELPOD_PACK_MAX_UVW; ++i)
+		{
+			psReport->avUVWScale[i].x = 1.0f;
+			psReport->avUVWScale[i].y = 1.0f;
+			psReport->avUVWScale[i].z = 1.0f;
+		}
+	}
+
+	// The meshes of a cooked scene are never freed, so neither would the packed data be
+	if(pod.IsMappedData(&mesh))
+		return PVR_FAIL;
+
+	if(!mesh.nNumVertex)
+		return PVR_SUCCESS;
+
+	// Collect the arrays the mesh has, and choose their packed formats
+	nMaxArrays = 7 + mesh.nNumUVW;
+	if(!SafeAlloc(psArrays, nMaxArrays))
+		return PVR_FAIL;
+
+	apData[0] = &mesh.sVertex;
+	apData[1] = &mesh.sNormals;
+	apData[2] = &mesh.sTangents;
+	apData[3] = &mesh.sBinormals;
+	apData[4] = &mesh.sVtxColours;
+	apData[5] = &mesh.sBoneIdx;
+	apData[6] = &mesh.sBoneWeight;
+
+	nArrays			= 0;
+	nBytesBefore	= mesh.pInterleaved ? mesh.nNumVertex * mesh.sVertex.nStride : 0;
+	for(i = 0; i < nMaxArrays; ++i)
+	{
+		CPODData &data = i < 7 ? *apData[i] : mesh.psUVW[i - 7];
+
+		if(!data.n || !data.nStride || (!data.pData && !mesh.pInterleaved))
+			continue;
+
+		SPackArray &sArray	= psArrays[nArrays++];
+		sArray.pData		= &data;
+		sArray.pSrc			= mesh.pInterleaved ? mesh.pInterleaved + (size_t) data.pData : data.pData;
+		sArray.nSrcStride	= data.nStride;
+		sArray.eSrcType		= data.eType;
+		sArray.nSrcCnt		= (PVRTuint32) (data.n * PVRTModelPODDataTypeComponentCount(data.eType));
+		sArray.nSrcSize		= (PVRTuint32) PVRTModelPODDataStride(data);
+		sArray.eType		= data.eType;
+		sArray.n			= data.n;
+		sArray.ui32Pack		= 0;
+
+		if(!mesh.pInterleaved)
+			nBytesBefore += mesh.nNumVertex * data.nStride;
+
+		const bool bFloat = data.eType == EPODDataFloat;
+
+		if(i == 0 && bFloat && data.n == 3 && (ui32Pack & ePODPackPositions))
+		{
+			sArray.eType	= EPODDataShort;
+			sArray.ui32Pack	= ePODPackPositions;
+			PackRange(sArray, mesh.nNumVertex);
+		}
+		else if(i >= 1 && i <= 3 && bFloat && data.n == 3 && (ui32Pack & ePODPackNormals))
+		{
+			sArray.eType	= EPODDataByteNorm;
+			sArray.ui32Pack	= ePODPackNormals;
+		}
+		else if(i >= 7 && i - 7 < PVRTMODELPOD_PACK_MAX_UVW && bFloat && data.n <= 3 && (ui32Pack & ePODPackUVWs))
+		{
+			sArray.eType	= EPODDataShort;
+			sArray.ui32Pack	= ePODPackUVWs;
+			PackRange(sArray, mesh.nNumVertex);
+
+			if(psReport)
+			{
+				psReport->avUVWScale[i - 7]		= sArray.vScale;
+				psReport->avUVWOffset[i - 7]	= sArray.vOffset;
+			}
+		}
+		else if(i == 6 && bFloat && data.n <= 4 && (ui32Pack & ePODPackBoneWeights))
+		{
+			sArray.eType	= EPODDataUnsignedByteNorm;
+			sArray.ui32Pack	= ePODPackBoneWeights;
+		}
+		else if(i == 5 && data.eType != EPODDataUnsignedByte && data.eType != EPODDataUBYTE4 && sArray.nSrcCnt <= 4 && (ui32Pack & ePODPackBoneWeights))
+		{
+			// Only if every index fits in a byte
+			bool bFits = true;
+			for(j = 0; j < mesh.nNumVertex && bFits; ++j)
+			{
+				PVRTVertexRead(&v, sArray.pSrc + j * sArray.nSrcStride, sArray.eSrcType, sArray.nSrcCnt);
+				bFits = v.x < 256.0f && v.y < 256.0f && v.z < 256.0f && (sArray.nSrcCnt < 4 || v.w < 256.0f);
+			}
+
+			if(bFits)
+			{
+				sArray.eType	= EPODDataUnsignedByte;
+				sArray.n		= sArray.nSrcCnt;
+				sArray.ui32Pack	= ePODPackBoneWeights;
+			}
+		}
+	}
+
+	// Lay out the packed vertex
+	nStride = 0;
+	for(i = 0; i < nArrays; ++i)
+	{
+		SPackArray &sArray = psArrays[i];
+
+		sArray.nOffset	= (nStride + 3) & ~(size_t) 3;
+		nStride			= sArray.nOffset + PVRTModelPODDataTypeSize(sArray.eType) * sArray.n;
+	}
+
+	nStride = (nStride + 3) & ~(size_t) 3;
+	if(ui32AlignToNBytes > 1)
+		nStride += (ui32AlignToNBytes - (nStride % ui32AlignToNBytes)) % ui32AlignToNBytes;
+
+	if(!nStride || !SafeAlloc(pNew, mesh.nNumVertex * nStride))
+	{
+		FREE(psArrays);
+		return nStride ? PVR_FAIL : PVR_SUCCESS;
+	}
+
+	// Pack the vertices
+	for(i = 0; i < mesh.nNumVertex; ++i)
+	{
+		for(j = 0; j < nArrays; ++j)
+		{
+			const SPackArray	&sArray	= psArrays[j];
+			const PVRTuint8		*pSrc	= sArray.pSrc + i * sArray.nSrcStride;
+			PVRTuint8			*pOut	= pNew + i * nStride + sArray.nOffset;
+			float				fError;
+
+			if(!sArray.ui32Pack)
+			{
+				memcpy(pOut, pSrc, sArray.nSrcSize);
+				continue;
+			}
+
+			PVRTVertexRead(&v, pSrc, sArray.eSrcType, sArray.nSrcCnt);
+
+			switch(sArray.ui32Pack)
+			{
+			case ePODPackPositions:
+				fError = PackShorts(sArray, &v.x, pOut);
+				if(psReport)
+					psReport->fPositionError = PVRT_MAX(psReport->fPositionError, fError);
+				break;
+
+			case ePODPackNormals:
+				fError = PackDirection(&v.x, pOut);
+				if(psReport)
+					psReport->fNormalError = PVRT_MAX(psReport->fNormalError, fError);
+				break;
+
+			case ePODPackUVWs:
+				fError = PackShorts(sArray, &v.x, pOut);
+				if(psReport)
+					psReport->fUVWError = PVRT_MAX(psReport->fUVWError, fError);
+				break;
+
+			case ePODPackBoneWeights:
+				if(sArray.eType == EPODDataUnsignedByte)
+				{
+					// Bone indices
+					const float *pf = &v.x;
+					for(unsigned int k = 0; k < sArray.n; ++k)
+						pOut[k] = (PVRTuint8) pf[k];
+					break;
+				}
+
+				fError = PackWeights(&v.x, sArray.n, pOut);
+				if(psReport)
+					psReport->fBoneWeightError = PVRT_MAX(psReport->fBoneWeightError, fError);
+				break;
+			}
+		}
+	}
+
+	// Replace the vertex data, leaving any borrowed from the file mapping to it
+	if(mesh.pInterleaved)
+	{
+		FreeUnlessMapped(pod, mesh.pInterleaved);
+	}
+	else
+	{
+		for(i = 0; i < nArrays; ++i)
+			FreeUnlessMapped(pod, psArrays[i].pData->pData);
+	}
+
+	for(i = 0; i < nArrays; ++i)
+	{
+		const SPackArray &sArray = psArrays[i];
+
+		sArray.pData->eType		= sArray.eType;
+		sArray.pData->n			= sArray.n;
+		sArray.pData->nStride	= (PVRTuint32) nStride;
+		sArray.pData->pData		= (PVRTuint8*) sArray.nOffset;
+
+		if(sArray.ui32Pack == ePODPackPositions)
+		{
+			PVRTMATRIX mScale, mOffset;
+
+			// Unpack to the space of the original positions, then apply the original unpacking
+			PVRTMatrixScaling(mScale, sArray.vScale.x, sArray.vScale.y, sArray.vScale.z);
+			PVRTMatrixTranslation(mOffset, sArray.vOffset.x, sArray.vOffset.y, sArray.vOffset.z);
+			PVRTMatrixMultiply(mScale, mScale, mOffset);
+			PVRTMatrixMultiply(mesh.mUnpackMatrix, mScale, mesh.mUnpackMatrix);
+		}
+	}
+	mesh.pInterleaved = pNew;
+
+	if(psReport)
+	{
+		psReport->nBytesBefore	= (PVRTuint32) nBytesBefore;
+		psReport->nBytesAfter	= (PVRTuint32) (mesh.nNumVertex * nStride);
+	}
+
+	FREE(psArrays);
+	return PVR_SUCCESS;
+}
+#endif
+
 /*!***************************************************************************
  @Function		PVRTModelPODCountIndices
  @Input			mesh		Mesh
@@ -29,6 +29,9 @@
 // PVRTMODELPOD Scene Flags
 #define PVRTMODELPODSF_FIXED	(0x00000001)   /*!< PVRTMODELPOD Fixed-point 16.16 data (otherwise float) flag */
 
+#define PVRTMODELPOD_PACK_MAX_UVW	(8)	/*!< Texture coordinate sets PVRTModelPODPackVertexData() can quantise */
+#define PVRTMODELPOD_SPLIT_MAX_VERTICES	(65536)	/*!< Vertices a mesh can keep in CPVRTModelPOD::SplitMeshes() by default: all 16 bit indices */
+
 /****************************************************************************
 ** Enumerations
 ****************************************************************************/
@@ -115,6 +118,19 @@ enum EPODBlendOp
 	ePODBlendOp_REVERSE_SUBTRACT
 };
 
+/*!****************************************************************************
+ @Struct      EPODPackData
+ @Brief       Enum for the vertex attributes PVRTModelPODPackVertexData quantises
+******************************************************************************/
+enum EPODPackData
+{
+	ePODPackPositions	= 0x01,	/*!< Float positions to shorts, unpacked by mUnpackMatrix */
+	ePODPackNormals		= 0x02,	/*!< Float normals, tangents and binormals to normalised bytes */
+	ePODPackUVWs		= 0x04,	/*!< Float texture coordinates to shorts, with a scale and offset per channel */
+	ePODPackBoneWeights	= 0x08,	/*!< Float bone weights to normalised unsigned bytes, bone indices to unsigned bytes */
+	ePODPackAll			= 0x0F
+};
+
 /****************************************************************************
 ** Structures
 ****************************************************************************/
@@ -193,6 +209,21 @@ struct SPODMesh {
 	PVRTMATRIX			mUnpackMatrix;	/*!< A matrix used for unscaling scaled vertex data created with PVRTModelPODScaleAndConvertVtxData*/
 };
 
+/*!****************************************************************************
+ @Struct      SPODPackReport
+ @Brief       Struct for the results of PVRTModelPODPackVertexData
+******************************************************************************/
+struct SPODPackReport {
+	PVRTuint32			nBytesBefore;		/*!< Size of the vertex data before packing */
+	PVRTuint32			nBytesAfter;		/*!< Size of the packed, interleaved vertex data */
+	float				fPositionError;		/*!< Largest error of a position component, in model units */
+	float				fNormalError;		/*!< Largest angle between a normal, tangent or binormal and its packed value, in radians */
+	float				fUVWError;			/*!< Largest error of a texture coordinate component */
+	float				fBoneWeightError;	/*!< Largest error of a bone weight */
+	PVRTVECTOR3f		avUVWScale[PVRTMODELPOD_PACK_MAX_UVW];	/*!< Per packed texture coordinate set: original = packed * scale + offset */
+	PVRTVECTOR3f		avUVWOffset[PVRTMODELPOD_PACK_MAX_UVW];	/*!< Per packed texture coordinate set: see avUVWScale */
+};
+
 /*!****************************************************************************
  @Struct      SPODNode
  @Brief       Struct for storing POD node data
@@ -348,6 +379,87 @@ public:
 		char			* const pszHistory = NULL,
 		const size_t	historyCount = 0);
 
+	/*!***************************************************************************
+	@Function			ReadFromFileMapped
+	@Input				pszFileName		Filename to load
+	@Return			PVR_SUCCESS if successful, PVR_FAIL if not
+	@Description		Loads the specified ".POD" file by mapping it into memory
+						instead of reading it into a temporary buffer. Vertex,
+						index and animation arrays that are suitably aligned and
+						need no endian conversion are left pointing directly into
+						the mapped file; everything else is copied as normal.
+						The mapping is private, so mapped arrays may still be
+						modified in place, but they must not be freed or
+						reallocated (use IsMappedData() to check). The
+						PVRTModelPOD*() tools that take the CPVRTModelPOD first
+						give a mesh its own copy of each array it borrows from
+						the mapping, so they may be used on mapped scenes, and
+						on those read by ReadFromFileLazy(). They fail on scenes
+						read by ReadFromFileCooked(), whose arrays all belong to
+						the cooked file. The mapping is released by Destroy().
+						If the file cannot be mapped, this falls back to
+						ReadFromFile().
+	*****************************************************************************/
+	EPVRTError ReadFromFileMapped(
+		const char		* const pszFileName);
+
+	/*!***************************************************************************
+	@Function			ReadFromFileCooked
+	@Input				pszFileName			Filename to load
+	@Input				pszSourceFileName	If not NULL, the POD file the scene must
+										have been cooked from
+	@Return			PVR_SUCCESS if successful, PVR_FAIL if not
+	@Description		Loads a cooked scene written by SaveCooked(). A cooked
+						file holds the scene exactly as it is laid out in
+						memory, with an offset table of its pointers, so it is
+						loaded by mapping or reading the file and fixing up
+						those pointers; nothing is parsed or converted.
+						Any processing, such as interleaving or converting
+						vertex data, is done when cooking. Cooked files are
+						tied to the byte order, pointer size and VERTTYPE of the
+						machine that cooked them; others fail to load.
+						All of the scene's arrays belong to the cooked file (see
+						IsMappedData()), so they may be modified in place but
+						must not be freed or reallocated. The file is released
+						by Destroy().
+						If pszSourceFileName is given, the file fails to load
+						unless it was saved with that source file, and the
+						source has the size and modification time it had then,
+						so a stale cooked file is never used in its place.
+	*****************************************************************************/
+	EPVRTError ReadFromFileCooked(
+		const char		* const pszFileName,
+		const char		* const pszSourceFileName = 0);
+
+	/*!***************************************************************************
+	@Function			ReadFromFileLazy
+	@Input				pszFileName		Filename to load
+	@Return			PVR_SUCCESS if successful, PVR_FAIL if not
+	@Description		Loads the specified ".POD" file without the vertex and
+						index data of its meshes or the animation of its nodes,
+						for files holding far more than is used at once.
+						Everything else is loaded, including the counts, types
+						and bone batches of the meshes, so the scene is complete
+						except that each mesh's data pointers, including
+						pInterleaved, are NULL until LoadMesh() is called, and
+						each animated node has only the frame 0 key of each
+						animated array, and no animation flags, until
+						LoadNodeAnimation() is called.
+						UnloadMesh() and UnloadNodeAnimation() return them to
+						that state. The file is mapped, or read into memory
+						where it cannot be, and is kept until Destroy(); loaded
+						arrays may point into it, as with ReadFromFileMapped().
+						Functions that walk the whole scene, such as SavePOD(),
+						BakeAnimation() and the PVRTModelPOD*() tools, only see
+						what is loaded at the time.
+						This only saves time and memory when the caller goes on
+						to load part of the scene. cocos3d's CC3PODResource
+						builds every mesh and node animation as it loads, so it
+						does not use this.
+	*****************************************************************************/
+	EPVRTError ReadFromFileLazy(
+		const char		* const pszFileName);
+
 	/*!***************************************************************************
 	@Function			ReadFromMemory
 	@Input				pData			Data to load
@@ -435,6 +547,99 @@ public:
 	*************************************************************************/
 	bool IsLoaded();
 
+	/*!***********************************************************************
+	@Function		IsMappedData
+	@Input			pData			Pointer to test
+	@Return			true if pData points into the file mapped by ReadFromFileMapped()
+								or ReadFromFileLazy(), or loaded by ReadFromFileCooked()
+	@Description	Used to find out whether an array belongs to the mapped file,
+					in which case it is owned by this class and must not be freed.
+	*************************************************************************/
+	bool IsMappedData(const void * const pData) const;
+
+	/*!***********************************************************************
+	@Function		LoadMesh
+	@Input			ui32Mesh		Index of the mesh
+	@Return			PVR_SUCCESS if successful, PVR_FAIL if not
+	@Description	Loads the vertex and index data of a mesh of a scene read
+					by ReadFromFileLazy(). Meshes of scenes loaded any other
+					way are always loaded.
+	*************************************************************************/
+	EPVRTError LoadMesh(const unsigned int ui32Mesh);
+
+	/*!***********************************************************************
+	@Function		UnloadMesh
+	@Input			ui32Mesh		Index of the mesh
+	@Description	Frees the vertex and index data of a mesh loaded by
+					LoadMesh(). The data must have the layout it was loaded
+					with, so a mesh that has been converted or interleaved
+					since must not be unloaded.
+	*************************************************************************/
+	void UnloadMesh(const unsigned int ui32Mesh);
+
+	/*!***********************************************************************
+	@Function		IsMeshLoaded
+	@Input			ui32Mesh		Index of the mesh
+	@Return			true if the vertex and index data of the mesh is loaded
+	*************************************************************************/
+	bool IsMeshLoaded(const unsigned int ui32Mesh) const;
+
+	/*!***********************************************************************
+	@Function		LoadNodeAnimation
+	@Input			ui32Node		Index of the node
+	@Return			PVR_SUCCESS if successful, PVR_FAIL if not
+	@Description	Loads the animation of a node of a scene read by
+					ReadFromFileLazy(). The world matrices cached for frames
+					other than 0 are flushed; those of frame 0, and the bind
+					pose, stay as solved from the frame 0 keys when loading.
+					If the animation is baked, the node is baked again.
+	*************************************************************************/
+	EPVRTError LoadNodeAnimation(const unsigned int ui32Node);
+
+	/*!***********************************************************************
+	@Function		UnloadNodeAnimation
+	@Input			ui32Node		Index of the node
+	@Description	Frees the animation of a node loaded by
+					LoadNodeAnimation(), leaving the node with the frame 0
+					key of each animated array.
+	*************************************************************************/
+	void UnloadNodeAnimation(const unsigned int ui32Node);
+
+	/*!***********************************************************************
+	@Function		IsNodeAnimationLoaded
+	@Input			ui32Node		Index of the node
+	@Return			true if the animation of the node is loaded, or it has
+					none
+	*************************************************************************/
+	bool IsNodeAnimationLoaded(const unsigned int ui32Node) const;
+
+	/*!***********************************************************************
+	@Function		SplitMeshes
+	@Input			ui32MaxVertices	Most vertices a mesh may keep; at most 65536
+	@Return			PVR_SUCCESS if every indexed mesh now has 16 bit indices,
+					PVR_FAIL if a mesh could not be split or memory ran out
+	@Description	Splits each indexed triangle list with more vertices than
+					ui32MaxVertices into chunks that can be drawn with 16 bit
+					indices, e.g. by OpenGL ES 1.1. Each chunk is grown across
+					shared vertices, so it covers one area of the mesh and few
+					vertices are repeated along the seams. It has its own
+					compact vertex data, in the mesh's layout, and keeps the
+					triangles of each bone batch together, with the bones of
+					the batches they came from.
+					The first chunk replaces the mesh, and the others are
+					added to the end of the mesh array. Each of them is drawn
+					by a new mesh node, a child of the node that drew the mesh
+					with no transformation of its own, named after it with the
+					chunk number. The new mesh nodes follow the old ones, so
+					the indices of the nodes after those go up. The indices of
+					the other indexed meshes are narrowed to 16 bits. Stripped
+					meshes cannot be split. Scenes read by ReadFromMemory(),
+					ReadFromFileCooked() or ReadFromFileLazy() cannot be
+					changed. Call this before creating any
+					CPVRTModelPODContext for the scene.
+	*************************************************************************/
+	EPVRTError SplitMeshes(const unsigned int ui32MaxVertices = PVRTMODELPOD_SPLIT_MAX_VERTICES);
+
 	/*!***************************************************************************
 	 @Function		Destroy
 	 @Description	Frees the memory allocated to store the scene in pScene.
@@ -584,6 +789,20 @@ public:
 	*****************************************************************************/
 	PVRTMat4 GetWorldMatrix(const SPODNode& node) const;
 
+	/*!***************************************************************************
+	 @Function		GetAllWorldMatrices
+	 @Output		pmWorld			Array of nNumNode matrices
+	 @Input			fFrame			Frame number
+	 @Description	Generates the world matrix of every node at the given frame.
+					The hierarchy is sorted by depth when the scene is loaded,
+					so this is a single parent-before-child sweep in which each
+					matrix is computed once. Does not use or change the
+					current frame or the matrix cache.
+	*****************************************************************************/
+	void GetAllWorldMatrices(
+		PVRTMATRIX		* const pmWorld,
+		const VERTTYPE	fFrame) const;
+
 	/*!***************************************************************************
 	 @Function		GetBoneWorldMatrix
 	 @Output		mOut			Bone world matrix
@@ -607,6 +826,56 @@ public:
 		const SPODNode	&NodeMesh,
 		const SPODNode	&NodeBone);
 
+	/*!***************************************************************************
+	 @Function		GetSkinPalette
+	 @Output		pmPalette		Array of at least nBatchBoneMax matrices
+	 @Input			NodeMesh		Mesh node being drawn; must be one of the
+									first nNumMeshNode nodes
+	 @Input			nBatch			Bone batch of the mesh
+	 @Return		Number of matrices written
+	 @Description	Fills pmPalette with GetBoneWorldMatrix() for every bone
+					of the given batch, in batch order, at the current frame.
+					The frame 0 inverse bind matrices are computed once when
+					the scene is loaded (or by FlushCache()), so no matrix
+					inversion is done per call.
+	*****************************************************************************/
+	unsigned int GetSkinPalette(
+		PVRTMATRIX			* const pmPalette,
+		const SPODNode		&NodeMesh,
+		const unsigned int	nBatch) const;
+
+	/*!***************************************************************************
+	 @Function		BakeAnimation
+	 @Return		PVR_SUCCESS if successful, PVR_FAIL if not
+	 @Description	Resamples the position, rotation and scale animation of
+					every node into contiguous per-channel, per-frame arrays,
+					so that EvaluateAllNodes() can process all nodes in one
+					pass. Call again after editing animation data or calling
+					InitImpl(). LoadNodeAnimation() and UnloadNodeAnimation()
+					bake the node they change. Not available in fixed-point
+					builds.
+	*****************************************************************************/
+	EPVRTError BakeAnimation();
+
+	/*!***************************************************************************
+	 @Function		HasBakedAnimation
+	 @Return		true if BakeAnimation() has been called successfully
+	*****************************************************************************/
+	bool HasBakedAnimation() const;
+
+	/*!***************************************************************************
+	 @Function		EvaluateAllNodes
+	 @Output		pmLocal			Array of nNumNode matrices
+	 @Input			fFrame			Frame number
+	 @Description	Generates the transformation of every node relative to its
+					parent at the given frame. Uses the baked animation if
+					available. Does not use or change the current frame, so
+					may be called from several threads at once.
+	*****************************************************************************/
+	void EvaluateAllNodes(
+		PVRTMATRIX		* const pmLocal,
+		const VERTTYPE	fFrame) const;
+
 	/*!***************************************************************************
 	 @Function		GetCamera
 	 @Output		vFrom			Position of the camera
@@ -698,8 +967,143 @@ public:
 	*****************************************************************************/
 	EPVRTError SavePOD(const char * const pszFilename, const char * const pszExpOpt = 0, const char * const pszHistory = 0);
 
+	/*!***************************************************************************
+	 @Function		SaveCooked
+	 @Input			pszFilename			Filename to save to
+	 @Input			pszSourceFilename	If not NULL, the POD file the scene was
+										read from
+	 @Return		PVR_SUCCESS if successful, PVR_FAIL if not
+	 @Description	Save the scene as a cooked file, for loading with
+					ReadFromFileCooked() on machines of the same kind. The
+					size and modification time of pszSourceFilename are
+					stored, for ReadFromFileCooked() to check.
+	*****************************************************************************/
+	EPVRTError SaveCooked(const char * const pszFilename, const char * const pszSourceFilename = 0);
+
 private:
 	SPVRTPODImpl	*m_pImpl;	/*!< Internal implementation data */
+
+	friend class CPVRTModelPODContext;
+};
+
+/*!***************************************************************************
+ @Class CPVRTModelPODContext
+ @Brief Animation state for one instance of a shared CPVRTModelPOD.
+		Each context has its own frame and world-matrix cache and only reads
+		from the model, so one loaded model can be animated at different
+		frames by many instances, each context being used from its own
+		thread. The model must outlive its contexts and must not be edited
+		while they are in use.
+*****************************************************************************/
+class CPVRTModelPODContext
+{
+public:
+	/*!***************************************************************************
+	 @Function		Constructor
+	 @Description	Constructor for CPVRTModelPODContext class
+	*****************************************************************************/
+	CPVRTModelPODContext();
+
+	/*!***************************************************************************
+	 @Function		Destructor
+	 @Description	Destructor for CPVRTModelPODContext class
+	*****************************************************************************/
+	~CPVRTModelPODContext();
+
+	/*!***************************************************************************
+	 @Function		Init
+	 @Input			pod				The loaded model to animate
+	 @Return		PVR_SUCCESS if successful, PVR_FAIL if not
+	 @Description	Attaches the context to a model and sets frame 0.
+	*****************************************************************************/
+	EPVRTError Init(const CPVRTModelPOD &pod);
+
+	/*!***************************************************************************
+	 @Function		Destroy
+	 @Description	Frees the context's cache and detaches it from its model.
+	*****************************************************************************/
+	void Destroy();
+
+	/*!***************************************************************************
+	 @Function		SetFrame
+	 @Input			fFrame			Frame number
+	 @Description	Set the animation frame for which subsequent Get*() calls
+					should return data.
+	*****************************************************************************/
+	void SetFrame(const VERTTYPE fFrame);
+
+	/*!***************************************************************************
+	 @Function		GetFrame
+	 @Return		The current frame number
+	*****************************************************************************/
+	VERTTYPE GetFrame() const;
+
+	/*!***************************************************************************
+	 @Function		GetWorldMatrices
+	 @Return		Array of the world matrices of all nodes at the current frame
+	 @Description	Solves the whole hierarchy the first time it is needed after
+					SetFrame(); later calls for the same frame are free.
+	*****************************************************************************/
+	const PVRTMATRIX* GetWorldMatrices();
+
+	/*!***************************************************************************
+	 @Function		GetWorldMatrix
+	 @Output		mOut			World matrix
+	 @Input			node			Node of the model to get the world matrix of
+	 @Description	Generates the world matrix for the given node at the
+					current frame of this context.
+	*****************************************************************************/
+	void GetWorldMatrix(
+		PVRTMATRIX		&mOut,
+		const SPODNode	&node);
+
+	/*!***************************************************************************
+	 @Function		GetBoneWorldMatrix
+	 @Output		mOut			Bone world matrix
+	 @Input			NodeMesh		Mesh to take the world matrix from
+	 @Input			NodeBone		Bone to take the matrix from
+	 @Description	Generates the world matrix for the given bone at the
+					current frame of this context.
+	*****************************************************************************/
+	void GetBoneWorldMatrix(
+		PVRTMATRIX		&mOut,
+		const SPODNode	&NodeMesh,
+		const SPODNode	&NodeBone);
+
+	/*!***************************************************************************
+	 @Function		GetSkinPalette
+	 @Output		pmPalette		Array of at least nBatchBoneMax matrices
+	 @Input			NodeMesh		Mesh node being drawn
+	 @Input			nBatch			Bone batch of the mesh
+	 @Return		Number of matrices written
+	 @Description	As CPVRTModelPOD::GetSkinPalette(), at the current frame of
+					this context.
+	*****************************************************************************/
+	unsigned int GetSkinPalette(
+		PVRTMATRIX			* const pmPalette,
+		const SPODNode		&NodeMesh,
+		const unsigned int	nBatch);
+
+protected:
+	const CPVRTModelPOD	*m_pPOD;		/*!< The model being animated */
+	VERTTYPE			m_fFrame;		/*!< Current frame */
+	bool				m_bValid;		/*!< Does m_pmWorld hold the current frame? */
+	PVRTMATRIX			*m_pmWorld;		/*!< World matrix of every node */
+
+private:
+	/*!***************************************************************************
+	 @Function		Copy constructor
+	 @Description	Not implemented. A context owns its world-matrix cache, so
+					it cannot be copied; create and Init() another context.
+	*****************************************************************************/
+	CPVRTModelPODContext(const CPVRTModelPODContext &context);
+
+	/*!***************************************************************************
+	 @Function		operator=
+	 @Description	Not implemented. A context owns its world-matrix cache, so
+					it cannot be copied; create and Init() another context.
+	*****************************************************************************/
+	CPVRTModelPODContext& operator=(const CPVRTModelPODContext &context);
 };
 
 /****************************************************************************
@@ -751,6 +1155,16 @@ unsigned int PVRTModelPODGetAnimArraySize(unsigned int *pAnimDataIdx, unsigned i
 *****************************************************************************/
 #if !defined(PVRT_FIXED_POINT_ENABLE)
 EPVRTError PVRTModelPODScaleAndConvertVtxData(SPODMesh &mesh, const EPVRTDataType eNewType);
+
+/*!***************************************************************************
+ @Function		PVRTModelPODScaleAndConvertVtxData
+ @Input			pod			Scene owning the mesh
+ @Modified		mesh		POD mesh to scale and convert the mesh data
+ @Input			eNewType	The data type to scale and convert the vertex data to
+ @Return		PVR_SUCCESS on success and PVR_FAIL on failure.
+ @Description	As PVRTModelPODScaleAndConvertVtxData(mesh, ...), for mapped scenes (see ReadFromFileMapped()).
+*****************************************************************************/
+EPVRTError PVRTModelPODScaleAndConvertVtxData(const CPVRTModelPOD &pod, SPODMesh &mesh, const EPVRTDataType eNewType);
 #endif
 /*!***************************************************************************
  @Function		PVRTModelPODDataConvert
@@ -761,6 +1175,19 @@ EPVRTError PVRTModelPODScaleAndConvertVtxData(SPODMesh &mesh, const EPVRTDataTyp
 *****************************************************************************/
 void PVRTModelPODDataConvert(CPODData &data, const unsigned int nCnt, const EPVRTDataType eNewType);
 
+/*!***************************************************************************
+ @Function		PVRTModelPODDataConvert
+ @Input			pod			Scene owning the data
+ @Modified		data		Data elements to convert
+ @Input			nCnt		Number of elements
+ @Input			eNewType	New type of elements
+ @Return		PVR_SUCCESS, or PVR_FAIL if the data belongs to a scene read
+				by ReadFromFileCooked(), or memory runs out
+ @Description	As PVRTModelPODDataConvert(data, ...), but first copies the
+				array if it is borrowed from the file mapping of the scene.
+*****************************************************************************/
+EPVRTError PVRTModelPODDataConvert(const CPVRTModelPOD &pod, CPODData &data, const unsigned int nCnt, const EPVRTDataType eNewType);
+
 /*!***************************************************************************
  @Function			PVRTModelPODDataShred
  @Modified			data		Data elements to modify
@@ -792,6 +1219,16 @@ void PVRTModelPODReorderFaces(SPODMesh &mesh, const int i32El1, const int i32El2
 *****************************************************************************/
 void PVRTModelPODToggleInterleaved(SPODMesh &mesh, unsigned int ui32AlignToNBytes = 1);
 
+/*!***************************************************************************
+ @Function		PVRTModelPODToggleInterleaved
+ @Input			pod			Scene owning the mesh
+ @Modified		mesh		Mesh to modify
+ @Input			ui32AlignToNBytes Align the interleaved data to this no. of bytes.
+ @Return		PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description	As PVRTModelPODToggleInterleaved(mesh, ...), for mapped scenes (see ReadFromFileMapped()).
+*****************************************************************************/
+EPVRTError PVRTModelPODToggleInterleaved(const CPVRTModelPOD &pod, SPODMesh &mesh, unsigned int ui32AlignToNBytes = 1);
+
 /*!***************************************************************************
  @Function		PVRTModelPODDeIndex
  @Modified		mesh		Mesh to modify
@@ -800,6 +1237,15 @@ void PVRTModelPODToggleInterleaved(SPODMesh &mesh, unsigned int ui32AlignToNByte
 *****************************************************************************/
 void PVRTModelPODDeIndex(SPODMesh &mesh);
 
+/*!***************************************************************************
+ @Function		PVRTModelPODDeIndex
+ @Input			pod			Scene owning the mesh
+ @Modified		mesh		Mesh to modify
+ @Return		PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description	As PVRTModelPODDeIndex(mesh), for mapped scenes (see ReadFromFileMapped()).
+*****************************************************************************/
+EPVRTError PVRTModelPODDeIndex(const CPVRTModelPOD &pod, SPODMesh &mesh);
+
 /*!***************************************************************************
  @Function		PVRTModelPODToggleStrips
  @Modified		mesh		Mesh to modify
@@ -807,6 +1253,77 @@ void PVRTModelPODDeIndex(SPODMesh &mesh);
 *****************************************************************************/
 void PVRTModelPODToggleStrips(SPODMesh &mesh);
 
+/*!***************************************************************************
+ @Function		PVRTModelPODToggleStrips
+ @Input			pod			Scene owning the mesh
+ @Modified		mesh		Mesh to modify
+ @Return		PVR_SUCCESS if successful, PVR_FAIL if not
+ @Description	As PVRTModelPODToggleStrips(mesh), for mapped scenes (see ReadFromFileMapped()).
+*****************************************************************************/
+EPVRTError PVRTModelPODToggleStrips(const CPVRTModelPOD &pod, SPODMesh &mesh);
+
+/*!***************************************************************************
+ @Function		PVRTModelPODOptimiseVertexCache
+ @Modified		mesh			Mesh to modify; must be an indexed triangle list
+ @Output		pfACMRBefore	If not NULL, the average cache miss ratio of
+								the original triangle order
+ @Output		pfACMRAfter		If not NULL, the average cache miss ratio of
+								the new triangle order
+ @Return		PVR_SUCCESS, or PVR_FAIL if the mesh is stripped, has an
+				index out of range, or memory runs out
+ @Description	Reorders the triangles of the mesh for post-transform vertex
+				cache reuse, then renumbers the vertices in the order the new
+				triangle list first uses them, so that vertex fetches walk
+				forwards through memory. Each bone batch is reordered on its
+				own, so the triangles stay within their batch ranges. Works
+				on interleaved and non-interleaved meshes. The ratios are
+				measured with a simulated FIFO cache of
+				PVRT_VERTEX_CACHE_SIZE entries.
+*****************************************************************************/
+EPVRTError PVRTModelPODOptimiseVertexCache(
+	SPODMesh	&mesh,
+	float		* const pfACMRBefore = NULL,
+	float		* const pfACMRAfter = NULL);
+
+/*!***************************************************************************
+ @Function		PVRTModelPODPackVertexData
+ @Input			pod					Scene owning the mesh
+ @Modified		mesh				Mesh to modify
+ @Input			ui32Pack			EPODPackData flags of the attributes to quantise
+ @Input			ui32AlignToNBytes	Align the vertex stride to this no. of bytes
+ @Output		psReport			If not NULL, the size savings, the largest
+									error of each kind of attribute, and the
+									texture coordinate unpacking
+ @Return		PVR_SUCCESS, or PVR_FAIL if the mesh belongs to a cooked
+				scene or memory runs out
+ @Description	Quantises the chosen float attributes of the mesh and
+				interleaves all of its vertex data into one buffer. Each
+				attribute starts on a 4 byte boundary.
+				- Positions become shorts spanning the bounding box. The
+				  mesh's mUnpackMatrix maps them back to model space.
+				- Normals, tangents and binormals become near unit length
+				  normalised bytes, rounded to the nearest direction.
+				- Texture coordinates become shorts spanning the range of
+				  each channel. psReport holds the scale and offset to apply,
+				  e.g. through the texture matrix.
+				- Bone weights become normalised unsigned bytes that keep
+				  their sum, and bone indices below 256 become unsigned bytes.
+				  OpenGL ES 1.1 palette skinning only reads fixed or float
+				  weights, so leave ePODPackBoneWeights out for it.
+				Other attributes are copied unchanged. The arrays replaced
+				are freed, except those borrowed from the file mapping of
+				the scene, which are left to it. This function isn't
+				compiled in for fixed point builds.
+*****************************************************************************/
+#if !defined(PVRT_FIXED_POINT_ENABLE)
+EPVRTError PVRTModelPODPackVertexData(
+	const CPVRTModelPOD	&pod,
+	SPODMesh			&mesh,
+	const unsigned int	ui32Pack = ePODPackAll,
+	const unsigned int	ui32AlignToNBytes = 4,
+	SPODPackReport		* const psReport = NULL);
+#endif
+
 /*!***************************************************************************
  @Function		PVRTModelPODCountIndices
  @Input			mesh		Mesh
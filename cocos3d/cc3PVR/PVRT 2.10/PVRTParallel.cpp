@@ -0,0 +1,351 @@
+/******************************************************************************
+
+ @File         PVRTParallel.cpp
+
+ @Title        PVRTParallel
+
+ @Version
+
+ @Copyright    Copyright (c) Imagination Technologies Limited.
+
+ @Platform     ANSI compatible
+
+ @Description  Worker pool shared by PVRTParallelFor and PVRTParallelQueue.
+               The workers are started by the first call that needs them
+               and are joined at exit.
+
+******************************************************************************/
+
+/****************************************************************************
+** Includes
+****************************************************************************/
+#include <stdlib.h>
+
+#include "PVRTParallel.h"
+
+#ifdef PVRT_PARALLEL_PTHREADS
+/****************************************************************************
+** Structures
+****************************************************************************/
+/*!***************************************************************************
+ @Struct		SPVRTParallelTask
+ @Brief			A task queued for the workers
+*****************************************************************************/
+struct SPVRTParallelTask
+{
+	PFNPVRTParallelTask	pfnTask;
+	void				*pUserData;
+	unsigned int		*pui32Running;	// If not NULL, counts the workers running tasks of a PVRTParallelFor call
+	SPVRTParallelTask	*pNext;
+};
+
+/*!***************************************************************************
+ @Struct		SPVRTParallelFor
+ @Brief			State shared by the threads of one PVRTParallelFor call
+*****************************************************************************/
+struct SPVRTParallelFor
+{
+	PFNPVRTParallelJob	pfnJob;
+	void				*pUserData;
+	unsigned int		ui32NumJobs;
+	unsigned int		ui32NextJob;
+	pthread_mutex_t		mutex;
+};
+
+/****************************************************************************
+** Local data
+****************************************************************************/
+static pthread_mutex_t		s_PoolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t		s_PoolTaskCond = PTHREAD_COND_INITIALIZER;	// Signalled when a task is queued
+static pthread_cond_t		s_PoolDoneCond = PTHREAD_COND_INITIALIZER;	// Signalled when a counted task finishes
+static pthread_t			s_aPoolThreads[PVRT_PARALLEL_MAX_THREADS];
+static unsigned int			s_ui32NumPoolThreads = 0;
+static bool					s_bPoolStarted = false;
+static bool					s_bPoolQuit = false;
+static SPVRTParallelTask	*s_pPoolHead = 0;
+static SPVRTParallelTask	*s_pPoolTail = 0;
+
+/****************************************************************************
+** Local code
+****************************************************************************/
+/*!***************************************************************************
+ @Function		PoolThreadMain
+ @Description	Runs queued tasks until the pool is stopped.
+*****************************************************************************/
+static void* PoolThreadMain(void*)
+{
+	pthread_mutex_lock(&s_PoolMutex);
+
+	for(;;)
+	{
+		while(!s_pPoolHead && !s_bPoolQuit)
+			pthread_cond_wait(&s_PoolTaskCond, &s_PoolMutex);
+
+		if(s_bPoolQuit)
+			break;
+
+		SPVRTParallelTask *pTask = s_pPoolHead;
+		s_pPoolHead = pTask->pNext;
+		if(!s_pPoolHead)
+			s_pPoolTail = 0;
+
+		// Counted while the lock is held, so the caller cannot miss it
+		if(pTask->pui32Running)
+			++*pTask->pui32Running;
+
+		pthread_mutex_unlock(&s_PoolMutex);
+		pTask->pfnTask(pTask->pUserData);
+		pthread_mutex_lock(&s_PoolMutex);
+
+		if(pTask->pui32Running)
+		{
+			--*pTask->pui32Running;
+			pthread_cond_broadcast(&s_PoolDoneCond);
+		}
+		delete pTask;
+	}
+
+	pthread_mutex_unlock(&s_PoolMutex);
+	return 0;
+}
+
+/*!***************************************************************************
+ @Function		PoolStopAtExit
+ @Description	atexit() handler for PVRTParallelStop().
+*****************************************************************************/
+static void PoolStopAtExit()
+{
+	PVRTParallelStop();
+}
+
+/*!***************************************************************************
+ @Function		PoolStartLocked
+ @Return		Number of workers in the pool
+ @Description	Starts the workers the first time it is called. Must be
+				called with the pool lock held.
+*****************************************************************************/
+static unsigned int PoolStartLocked()
+{
+	if(!s_bPoolStarted && !s_bPoolQuit)
+	{
+		const unsigned int ui32NumThreads = PVRT_MAX(PVRTParallelThreadCount() - 1, (unsigned int) PVRT_PARALLEL_MIN_WORKERS);
+
+		s_bPoolStarted = true;
+
+		while(s_ui32NumPoolThreads < ui32NumThreads &&
+			pthread_create(&s_aPoolThreads[s_ui32NumPoolThreads], 0, &PoolThreadMain, 0) == 0)
+		{
+			++s_ui32NumPoolThreads;
+		}
+
+		if(s_ui32NumPoolThreads)
+			atexit(&PoolStopAtExit);
+	}
+	return s_bPoolQuit ? 0 : s_ui32NumPoolThreads;
+}
+
+/*!***************************************************************************
+ @Function		PoolPushLocked
+ @Input			pTask			Task to queue
+ @Input			bFront			Queue the task ahead of the others
+ @Description	Queues a task. Must be called with the pool lock held.
+*****************************************************************************/
+static void PoolPushLocked(SPVRTParallelTask *pTask, const bool bFront)
+{
+	if(bFront)
+	{
+		pTask->pNext = s_pPoolHead;
+		s_pPoolHead = pTask;
+		if(!s_pPoolTail)
+			s_pPoolTail = pTask;
+	}
+	else
+	{
+		pTask->pNext = 0;
+		if(s_pPoolTail)
+			s_pPoolTail->pNext = pTask;
+		else
+			s_pPoolHead = pTask;
+		s_pPoolTail = pTask;
+	}
+}
+
+/*!***************************************************************************
+ @Function		ParallelForWork
+ @Input			pUserData		The SPVRTParallelFor of the call
+ @Description	Takes jobs of a PVRTParallelFor call until there are none
+				left. Run by the calling thread and by the workers helping it.
+*****************************************************************************/
+static void ParallelForWork(void *pUserData)
+{
+	SPVRTParallelFor &state = *(SPVRTParallelFor*) pUserData;
+
+	for(;;)
+	{
+		pthread_mutex_lock(&state.mutex);
+		unsigned int ui32Job = state.ui32NextJob++;
+		pthread_mutex_unlock(&state.mutex);
+
+		if(ui32Job >= state.ui32NumJobs)
+			return;
+
+		state.pfnJob(state.pUserData, ui32Job);
+	}
+}
+#endif
+
+/****************************************************************************
+** Functions
+****************************************************************************/
+/*!***************************************************************************
+ @Function		PVRTParallelFor
+ @Input			pfnJob			Job function
+ @Input			pUserData		Data passed to every job
+ @Input			ui32NumJobs		Number of jobs; pfnJob is called for 0..ui32NumJobs-1
+ @Input			ui32MaxThreads	Maximum number of threads to use, including the
+								calling thread. 0 means PVRTParallelThreadCount().
+ @Description	Runs ui32NumJobs jobs over a number of threads and returns once
+				they have all completed.
+*****************************************************************************/
+void PVRTParallelFor(
+	PFNPVRTParallelJob	pfnJob,
+	void				*pUserData,
+	const unsigned int	ui32NumJobs,
+	unsigned int		ui32MaxThreads)
+{
+	if(!ui32MaxThreads)
+		ui32MaxThreads = PVRTParallelThreadCount();
+
+	ui32MaxThreads = PVRT_MIN(ui32MaxThreads, ui32NumJobs);
+	ui32MaxThreads = PVRT_MIN(ui32MaxThreads, (unsigned int) PVRT_PARALLEL_MAX_THREADS);
+
+#ifdef PVRT_PARALLEL_PTHREADS
+	if(ui32MaxThreads > 1)
+	{
+		SPVRTParallelFor	state;
+		unsigned int		ui32Running = 0;
+
+		state.pfnJob		= pfnJob;
+		state.pUserData		= pUserData;
+		state.ui32NumJobs	= ui32NumJobs;
+		state.ui32NextJob	= 0;
+		pthread_mutex_init(&state.mutex, 0);
+
+		// Helpers go ahead of queued I/O, which would otherwise hold them up
+		pthread_mutex_lock(&s_PoolMutex);
+		const unsigned int ui32NumHelpers = PVRT_MIN(ui32MaxThreads - 1, PoolStartLocked());
+
+		for(unsigned int i = 0; i < ui32NumHelpers; ++i)
+		{
+			SPVRTParallelTask *pTask = new SPVRTParallelTask;
+			pTask->pfnTask		= &ParallelForWork;
+			pTask->pUserData	= &state;
+			pTask->pui32Running	= &ui32Running;
+			PoolPushLocked(pTask, true);
+		}
+		pthread_cond_broadcast(&s_PoolTaskCond);
+		pthread_mutex_unlock(&s_PoolMutex);
+
+		ParallelForWork(&state);
+
+		// Helpers that have not started by now have nothing left to do
+		pthread_mutex_lock(&s_PoolMutex);
+		SPVRTParallelTask **ppTask = &s_pPoolHead;
+		s_pPoolTail = 0;
+
+		while(*ppTask)
+		{
+			SPVRTParallelTask *pTask = *ppTask;
+
+			if(pTask->pUserData == &state && pTask->pfnTask == &ParallelForWork)
+			{
+				*ppTask = pTask->pNext;
+				delete pTask;
+				continue;
+			}
+
+			s_pPoolTail = pTask;
+			ppTask = &pTask->pNext;
+		}
+
+		while(ui32Running)
+			pthread_cond_wait(&s_PoolDoneCond, &s_PoolMutex);
+
+		pthread_mutex_unlock(&s_PoolMutex);
+		pthread_mutex_destroy(&state.mutex);
+		return;
+	}
+#endif
+
+	for(unsigned int i = 0; i < ui32NumJobs; ++i)
+		pfnJob(pUserData, i);
+}
+
+/*!***************************************************************************
+ @Function		PVRTParallelQueue
+ @Input			pfnTask			Task function
+ @Input			pUserData		Data passed to the task
+ @Return		true if the task was queued, false if it was run on the
+				calling thread
+ @Description	Runs a task on the worker pool without waiting for it.
+*****************************************************************************/
+bool PVRTParallelQueue(PFNPVRTParallelTask pfnTask, void *pUserData)
+{
+	if(!pfnTask)
+		return false;
+
+#ifdef PVRT_PARALLEL_PTHREADS
+	pthread_mutex_lock(&s_PoolMutex);
+
+	if(PoolStartLocked())
+	{
+		SPVRTParallelTask *pTask = new SPVRTParallelTask;
+		pTask->pfnTask		= pfnTask;
+		pTask->pUserData	= pUserData;
+		pTask->pui32Running	= 0;
+		PoolPushLocked(pTask, false);
+
+		pthread_cond_signal(&s_PoolTaskCond);
+		pthread_mutex_unlock(&s_PoolMutex);
+		return true;
+	}
+
+	pthread_mutex_unlock(&s_PoolMutex);
+#endif
+
+	pfnTask(pUserData);
+	return false;
+}
+
+/*!***************************************************************************
+ @Function		PVRTParallelStop
+ @Description	Joins the workers once they finish the tasks they are running,
+				and drops the tasks still queued.
+*****************************************************************************/
+void PVRTParallelStop()
+{
+#ifdef PVRT_PARALLEL_PTHREADS
+	pthread_mutex_lock(&s_PoolMutex);
+	s_bPoolQuit = true;
+	pthread_cond_broadcast(&s_PoolTaskCond);
+	pthread_mutex_unlock(&s_PoolMutex);
+
+	for(unsigned int i = 0; i < s_ui32NumPoolThreads; ++i)
+		pthread_join(s_aPoolThreads[i], 0);
+	s_ui32NumPoolThreads = 0;
+
+	pthread_mutex_lock(&s_PoolMutex);
+	while(s_pPoolHead)
+	{
+		SPVRTParallelTask *pTask = s_pPoolHead;
+		s_pPoolHead = pTask->pNext;
+		delete pTask;
+	}
+	s_pPoolTail = 0;
+	pthread_mutex_unlock(&s_PoolMutex);
+#endif
+}
+
+/*****************************************************************************
+ End of file (PVRTParallel.cpp)
+*****************************************************************************/
@@ -0,0 +1,116 @@
+/******************************************************************************
+
+ @File         PVRTParallel.h
+
+ @Title        PVRTParallel
+
+ @Version
+
+ @Copyright    Copyright (c) Imagination Technologies Limited.
+
+ @Platform     ANSI compatible
+
+ @Description  Worker pool used to spread independent jobs over the
+               available processor cores, and to run tasks such as file
+               reads in the background. Where threads are not available
+               the work is simply run in order on the calling thread.
+
+******************************************************************************/
+#ifndef _PVRTPARALLEL_H_
+#define _PVRTPARALLEL_H_
+
+#include "PVRTGlobal.h"
+
+#if defined(__APPLE__) || defined(__linux__)
+#include <pthread.h>
+#include <unistd.h>
+#define PVRT_PARALLEL_PTHREADS
+#endif
+
+/*! Maximum number of threads, including the caller, used by PVRTParallelFor */
+#define PVRT_PARALLEL_MAX_THREADS	(16)
+
+/*! Minimum number of workers in the pool, so that queued I/O can overlap even on one core */
+#define PVRT_PARALLEL_MIN_WORKERS	(2)
+
+/*!***************************************************************************
+ @Function		PFNPVRTParallelJob
+ @Input			pUserData		The user data passed to PVRTParallelFor
+ @Input			ui32Job			Index of the job to run
+ @Description	A job run by PVRTParallelFor. Jobs may run concurrently and
+				in any order, so each must only write data that belongs to
+				its own index.
+*****************************************************************************/
+typedef void (*PFNPVRTParallelJob)(void *pUserData, const unsigned int ui32Job);
+
+/*!***************************************************************************
+ @Function		PFNPVRTParallelTask
+ @Input			pUserData		The user data passed to PVRTParallelQueue
+ @Description	A task run by PVRTParallelQueue.
+*****************************************************************************/
+typedef void (*PFNPVRTParallelTask)(void *pUserData);
+
+/*!***************************************************************************
+ @Function		PVRTParallelThreadCount
+ @Return		The number of threads worth using for parallel work
+ @Description	Returns the number of online processors, clamped to
+				PVRT_PARALLEL_MAX_THREADS. Returns 1 where threads are not
+				supported.
+*****************************************************************************/
+inline unsigned int PVRTParallelThreadCount()
+{
+#ifdef PVRT_PARALLEL_PTHREADS
+	long i32Count = sysconf(_SC_NPROCESSORS_ONLN);
+	if(i32Count < 1)
+		return 1;
+	return (unsigned int) PVRT_MIN(i32Count, (long) PVRT_PARALLEL_MAX_THREADS);
+#else
+	return 1;
+#endif
+}
+
+/*!***************************************************************************
+ @Function		PVRTParallelFor
+ @Input			pfnJob			Job function
+ @Input			pUserData		Data passed to every job
+ @Input			ui32NumJobs		Number of jobs; pfnJob is called for 0..ui32NumJobs-1
+ @Input			ui32MaxThreads	Maximum number of threads to use, including the
+								calling thread. 0 means PVRTParallelThreadCount().
+ @Description	Runs ui32NumJobs jobs over a number of threads and returns once
+				they have all completed. The calling thread takes part in the
+				work, helped by workers of the pool that are free, so this
+				degrades gracefully to a plain loop if none are. It may be
+				called from within a job.
+*****************************************************************************/
+void PVRTParallelFor(
+	PFNPVRTParallelJob	pfnJob,
+	void				*pUserData,
+	const unsigned int	ui32NumJobs,
+	unsigned int		ui32MaxThreads = 0);
+
+/*!***************************************************************************
+ @Function		PVRTParallelQueue
+ @Input			pfnTask			Task function
+ @Input			pUserData		Data passed to the task
+ @Return		true if the task was queued, false if it was run on the
+				calling thread
+ @Description	Runs a task on the worker pool without waiting for it. Tasks
+				start in the order they are queued, after any PVRTParallelFor
+				work. Where threads are not supported, or cannot be started,
+				the task is run before this returns.
+*****************************************************************************/
+bool PVRTParallelQueue(PFNPVRTParallelTask pfnTask, void *pUserData);
+
+/*!***************************************************************************
+ @Function		PVRTParallelStop
+ @Description	Joins the workers once they finish the tasks they are running,
+				and drops the tasks still queued. Called at exit; afterwards
+				all work runs on the calling thread.
+*****************************************************************************/
+void PVRTParallelStop();
+
+#endif /* _PVRTPARALLEL_H_ */
+
+/*****************************************************************************
+ End of file (PVRTParallel.h)
+*****************************************************************************/
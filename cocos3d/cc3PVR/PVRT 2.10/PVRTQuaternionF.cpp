@@ -19,6 +19,7 @@
 #include <string.h>
 #include "PVRTFixedPoint.h"		// Only needed for trig function float lookups
 #include "PVRTQuaternion.h"
+#include "PVRTSimd.h"
 
 
 /****************************************************************************
@@ -241,6 +242,39 @@ void PVRTMatrixRotationQuaternionF(
 	pQ = &quat;
 #endif
 
+#ifdef PVRT_SIMD
+	/* The diagonal, the sums and the differences are each computed three at
+	   a time, with the same products in the same order as the scalar code,
+	   then shuffled into rows. */
+	const PVRTSIMDVEC vQ	= PVRTSimdLoad(&pQ->x);
+	const PVRTSIMDVEC vQ2	= PVRTSimdAdd(vQ, vQ);
+	const PVRTSIMDVEC vZero	= PVRTSimdSplat(0.0f);
+	PVRTSIMDVEC vDiag, vProd, vProdW, vSum, vDiff, vLo, vHi;
+
+	// [1 - 2YY - 2ZZ, 1 - 2XX - 2ZZ, 1 - 2XX - 2YY]
+	vDiag = PVRTSimdSub(PVRTSimdSplat(1.0f), PVRTSimdMul(PVRTSimdShuffle<1, 0, 0, 3>(vQ2, vQ2), PVRTSimdShuffle<1, 0, 0, 3>(vQ, vQ)));
+	vDiag = PVRTSimdSub(vDiag, PVRTSimdMul(PVRTSimdShuffle<2, 2, 1, 3>(vQ2, vQ2), PVRTSimdShuffle<2, 2, 1, 3>(vQ, vQ)));
+
+	// [2XY, 2XZ, 2YZ] and [2ZW, 2YW, 2XW]
+	vProd	= PVRTSimdMul(PVRTSimdShuffle<0, 0, 1, 3>(vQ2, vQ2), PVRTSimdShuffle<1, 2, 2, 3>(vQ, vQ));
+	vProdW	= PVRTSimdMul(PVRTSimdShuffle<2, 1, 0, 3>(vQ2, vQ2), PVRTSimdShuffle<3, 3, 3, 3>(vQ, vQ));
+
+	// [f4, f2, f9] and [f1, f8, f6]
+	vSum	= PVRTSimdAdd(vProd, vProdW);
+	vDiff	= PVRTSimdSub(vProd, vProdW);
+
+	vLo = PVRTSimdShuffle<0, 1, 0, 2>(vDiag, vDiff);	// [f0 f5 f1 f6]
+	vHi = PVRTSimdShuffle<1, 2, 0, 0>(vSum, vZero);		// [f2 f9 0 0]
+	PVRTSimdStore(&mOut.f[0], PVRTSimdShuffle<0, 2, 0, 2>(vLo, vHi));
+
+	vLo = PVRTSimdShuffle<0, 0, 1, 2>(vSum, vDiag);		// [f4 f4 f5 f10]
+	vHi = PVRTSimdShuffle<2, 2, 0, 0>(vDiff, vZero);	// [f6 f6 0 0]
+	PVRTSimdStore(&mOut.f[4], PVRTSimdShuffle<0, 2, 0, 2>(vLo, vHi));
+
+	vLo = PVRTSimdShuffle<1, 1, 2, 2>(vDiff, vSum);		// [f8 f8 f9 f9]
+	vHi = PVRTSimdShuffle<2, 2, 0, 0>(vDiag, vZero);	// [f10 f10 0 0]
+	PVRTSimdStore(&mOut.f[8], PVRTSimdShuffle<0, 2, 0, 2>(vLo, vHi));
+#else
     /* Fill matrix members */
 	mOut.f[0] = 1.0f - 2.0f*pQ->y*pQ->y - 2.0f*pQ->z*pQ->z;
 	mOut.f[1] = 2.0f*pQ->x*pQ->y - 2.0f*pQ->z*pQ->w;
@@ -256,6 +290,7 @@ void PVRTMatrixRotationQuaternionF(
 	mOut.f[9] = 2.0f*pQ->y*pQ->z + 2.0f*pQ->x*pQ->w;
 	mOut.f[10] = 1.0f - 2.0f*pQ->x*pQ->x - 2*pQ->y*pQ->y;
 	mOut.f[11] = 0.0f;
+#endif
 
 	mOut.f[12] = 0.0f;
 	mOut.f[13] = 0.0f;
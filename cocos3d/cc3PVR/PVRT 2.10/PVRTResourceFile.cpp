@@ -21,8 +21,31 @@
 #include "PVRTResourceFile.h"
 #include "PVRTString.h"
 #include "PVRTMemoryFileSystem.h"
+#include "PVRTParallel.h"
+
+#if defined(__APPLE__) || defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define PVRTMEMORYFILESYSTEM_MMAP	// MountPack() can map pack files
+#endif
+
+#ifdef PVRT_PARALLEL_PTHREADS
+#define PVRTRESOURCEFILE_PTHREADS	// Prefetch() reads files on the PVRTParallel workers
+#endif
+
+/****************************************************************************
+** Defines
+****************************************************************************/
+#define PVRTPACK_MAGIC			(0x4B505650)	// "PVPK", little endian
+#define PVRTPACK_VERSION		(1)
+#define PVRTPACK_HEADER_SIZE	(16)			// Magic, version, file count, reserved
+#define PVRTPACK_ENTRY_SIZE		(16)			// Name offset and length, data offset and size
+#define PVRTPACK_ALIGN			(16)			// Alignment of the file data in a pack
 
 CPVRTString CPVRTResourceFile::s_ReadPath;
+bool CPVRTResourceFile::s_bMemoryFilesFirst = false;
 
 static void* LoadFileFunc(const char* pFilename, char** pData, size_t &size)
 {
@@ -67,6 +90,246 @@ static bool ReleaseFileFunc(void* handle)
 	return false;
 }
 
+/****************************************************************************
+** Local code: memory file system
+****************************************************************************/
+
+/*!***************************************************************************
+@Function		HashFilename
+@Input			pszFilename		Name of a file
+@Return			32 bit FNV-1a hash of the name
+*****************************************************************************/
+static unsigned int HashFilename(const char* pszFilename)
+{
+	unsigned int ui32Hash = 2166136261u;
+
+	while (*pszFilename)
+	{
+		ui32Hash ^= (unsigned char) *pszFilename++;
+		ui32Hash *= 16777619u;
+	}
+	return ui32Hash;
+}
+
+/*!***************************************************************************
+@Function		PackRead32
+@Input			pu8Data			Pointer into a pack
+@Return			The little endian 32 bit value at pu8Data
+@Description	Packs are read in place, so values may be unaligned.
+*****************************************************************************/
+static unsigned int PackRead32(const unsigned char* pu8Data)
+{
+	return (unsigned int) pu8Data[0] | ((unsigned int) pu8Data[1] << 8) |
+		((unsigned int) pu8Data[2] << 16) | ((unsigned int) pu8Data[3] << 24);
+}
+
+/*!***************************************************************************
+@Function		PackWrite32
+@Output			pu8Data			Pointer into a pack
+@Input			ui32Value		Value to store little endian at pu8Data
+*****************************************************************************/
+static void PackWrite32(unsigned char* pu8Data, unsigned int ui32Value)
+{
+	pu8Data[0] = (unsigned char) ui32Value;
+	pu8Data[1] = (unsigned char) (ui32Value >> 8);
+	pu8Data[2] = (unsigned char) (ui32Value >> 16);
+	pu8Data[3] = (unsigned char) (ui32Value >> 24);
+}
+
+/*!***************************************************************************
+@Function		PackIsEmptyFile
+@Input			pszFilename		Name of a file, relative to the
+								CPVRTResourceFile read path
+@Return			true if the file exists and is empty
+@Description	CPVRTResourceFile does not open empty files, so SavePack asks
+				here before it gives up on a file.
+*****************************************************************************/
+static bool PackIsEmptyFile(const char* pszFilename)
+{
+	CPVRTString Path(CPVRTResourceFile::GetReadPath());
+	Path += pszFilename;
+
+	FILE* pFile = fopen(Path.c_str(), "rb");
+	if (!pFile)
+		return false;
+
+	bool bEmpty = fseek(pFile, 0, SEEK_END) == 0 && ftell(pFile) == 0;
+	fclose(pFile);
+	return bEmpty;
+}
+
+/****************************************************************************
+** Local code: I/O threads
+****************************************************************************/
+enum EPrefetchState
+{
+	ePrefetchQueued,
+	ePrefetchLoading,
+	ePrefetchLoaded,
+	ePrefetchFailed
+};
+
+/*!***************************************************************************
+ @Struct		SPrefetch
+ @Brief			A file being read, or read, ahead of being opened
+*****************************************************************************/
+struct SPrefetch
+{
+	CPVRTString			Filename;		// As requested
+	CPVRTString			Path;			// Read path and filename at the time of the request
+	PFNLoadFileFunc		pfnLoad;		// Load and release functions at the time of the request
+	PFNReleaseFileFunc	pfnRelease;
+	PFNPrefetchCallback	pfnCallback;
+	void				*pUserData;
+	void				*pHandle;
+	char				*pData;
+	size_t				Size;
+	EPrefetchState		eState;
+	SPrefetch			*pNext;
+};
+
+#ifdef PVRTRESOURCEFILE_PTHREADS
+static pthread_mutex_t	s_IOMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t	s_IODoneCond = PTHREAD_COND_INITIALIZER;	// Signalled when a prefetch finishes
+static bool				s_bIOQuit = false;
+#endif
+static SPrefetch		*s_pPrefetches = 0;		// Guarded by s_IOMutex
+
+static void IOLock()
+{
+#ifdef PVRTRESOURCEFILE_PTHREADS
+	pthread_mutex_lock(&s_IOMutex);
+#endif
+}
+
+static void IOUnlock()
+{
+#ifdef PVRTRESOURCEFILE_PTHREADS
+	pthread_mutex_unlock(&s_IOMutex);
+#endif
+}
+
+/*!***************************************************************************
+@Function		PrefetchJob
+@Input			pUserData		The SPrefetch to read
+@Description	Reads a prefetched file. Only this job touches the file and
+				data of the prefetch until its state says it has finished.
+*****************************************************************************/
+static void PrefetchJob(void* pUserData)
+{
+	SPrefetch* pPrefetch = (SPrefetch*) pUserData;
+
+	IOLock();
+	pPrefetch->eState = ePrefetchLoading;
+	IOUnlock();
+
+	char* pData = 0;
+	size_t Size = 0;
+	void* pHandle = pPrefetch->pfnLoad(pPrefetch->Path.c_str(), &pData, Size);
+	bool bLoaded = pData && Size;
+
+	// The prefetch may be taken and deleted as soon as it is unlocked
+	CPVRTString Filename(pPrefetch->Filename);
+	PFNPrefetchCallback pfnCallback = pPrefetch->pfnCallback;
+	void* pCallbackData = pPrefetch->pUserData;
+
+	IOLock();
+	pPrefetch->pHandle = pHandle;
+	pPrefetch->pData = pData;
+	pPrefetch->Size = Size;
+	pPrefetch->eState = bLoaded ? ePrefetchLoaded : ePrefetchFailed;
+#ifdef PVRTRESOURCEFILE_PTHREADS
+	pthread_cond_broadcast(&s_IODoneCond);
+#endif
+	IOUnlock();
+
+	if (pfnCallback)
+		pfnCallback(Filename.c_str(), bLoaded, pCallbackData);
+}
+
+/*!***************************************************************************
+@Function		WaitForPrefetchLocked
+@Input			Path			Read path and filename of a prefetch
+@Return			Link to the first finished prefetch of the path, or to the
+				NULL at the end of the list if there is none
+@Description	Blocks until the first prefetch of the path has finished.
+				Must be called with the I/O lock held.
+*****************************************************************************/
+static SPrefetch** WaitForPrefetchLocked(const CPVRTString& Path)
+{
+	for (;;)
+	{
+		SPrefetch** ppPrefetch = &s_pPrefetches;
+		while (*ppPrefetch && (*ppPrefetch)->Path != Path)
+			ppPrefetch = &(*ppPrefetch)->pNext;
+
+		if (!*ppPrefetch)
+			return ppPrefetch;
+
+#ifdef PVRTRESOURCEFILE_PTHREADS
+		// Jobs left queued at exit never run
+		if ((*ppPrefetch)->eState == ePrefetchLoading || ((*ppPrefetch)->eState == ePrefetchQueued && !s_bIOQuit))
+		{
+			pthread_cond_wait(&s_IODoneCond, &s_IOMutex);
+			continue;
+		}
+#endif
+		return ppPrefetch;
+	}
+}
+
+/*!***************************************************************************
+@Function		TakePrefetch
+@Input			Path			Read path and filename of a prefetch
+@Return			The first prefetch of the path, unlinked, or NULL
+@Description	Waits for the first prefetch of the path to finish, then hands
+				it to the caller to delete.
+*****************************************************************************/
+static SPrefetch* TakePrefetch(const CPVRTString& Path)
+{
+	IOLock();
+	SPrefetch** ppPrefetch = WaitForPrefetchLocked(Path);
+	SPrefetch* pPrefetch = *ppPrefetch;
+
+	if (pPrefetch)
+		*ppPrefetch = pPrefetch->pNext;
+
+	IOUnlock();
+	return pPrefetch;
+}
+
+/*!***************************************************************************
+ @Class			CIOAtExit
+ @Brief			Stops the I/O threads and releases unused prefetches at exit
+*****************************************************************************/
+class CIOAtExit
+{
+public:
+	~CIOAtExit()
+	{
+		// Each worker finishes the read it is running; queued reads are dropped
+		PVRTParallelStop();
+
+#ifdef PVRTRESOURCEFILE_PTHREADS
+		pthread_mutex_lock(&s_IOMutex);
+		s_bIOQuit = true;
+		pthread_cond_broadcast(&s_IODoneCond);
+		pthread_mutex_unlock(&s_IOMutex);
+#endif
+		while (s_pPrefetches)
+		{
+			SPrefetch* pPrefetch = s_pPrefetches;
+			s_pPrefetches = pPrefetch->pNext;
+
+			if (pPrefetch->eState == ePrefetchLoaded && pPrefetch->pfnRelease)
+				pPrefetch->pfnRelease(pPrefetch->pHandle);
+
+			delete pPrefetch;
+		}
+	}
+};
+static CIOAtExit s_IOAtExit;
+
 PFNLoadFileFunc CPVRTResourceFile::s_pLoadFileFunc = &LoadFileFunc;
 PFNReleaseFileFunc CPVRTResourceFile::s_pReleaseFileFunc = &ReleaseFileFunc;
 
@@ -111,6 +374,18 @@ void CPVRTResourceFile::SetLoadReleaseFunctions(void* pLoadFileFunc, void* pRele
 	}
 }
 
+/*!***************************************************************************
+@Function			SetMemoryFilesFirst
+@Input				bFirst Whether to look in CPVRTMemoryFileSystem before the read path
+@Description		By default a file is looked for in the read path, and only then in
+					CPVRTMemoryFileSystem. Looking in memory first saves a failed file open
+					for every file registered in memory or in a mounted pack.
+*****************************************************************************/
+void CPVRTResourceFile::SetMemoryFilesFirst(bool bFirst)
+{
+	s_bMemoryFilesFirst = bFirst;
+}
+
 /*!***************************************************************************
 @Function			CPVRTResourceFile
 @Input				pszFilename Name of the file you would like to open
@@ -123,13 +398,44 @@ CPVRTResourceFile::CPVRTResourceFile(const char* const pszFilename) :
 	m_pData(0),
 	m_Handle(0)
 {
+	if (s_bMemoryFilesFirst)
+	{
+		m_bOpen = m_bMemoryFile = CPVRTMemoryFileSystem::GetFile(pszFilename, (const void**)(&m_pData), &m_Size);
+		if (m_bOpen)
+			return;
+	}
+
 	CPVRTString Path(s_ReadPath);
 	Path += pszFilename;
 
-	m_Handle = s_pLoadFileFunc(Path.c_str(), (char**) &m_pData, m_Size);
+	// Take the data of a prefetch if there is one, or else read it now
+	SPrefetch* pPrefetch = TakePrefetch(Path);
+
+	if (pPrefetch && pPrefetch->eState == ePrefetchLoaded)
+	{
+		m_Handle = pPrefetch->pHandle;
+		m_pData = pPrefetch->pData;
+		m_Size = pPrefetch->Size;
+	}
+	else
+	{
+		m_Handle = s_pLoadFileFunc(Path.c_str(), (char**) &m_pData, m_Size);
+	}
+	delete pPrefetch;
 	m_bOpen = (m_pData && m_Size) != 0;
 
+	// An empty file is not open, so release what the load function returned for it
 	if (!m_bOpen)
+	{
+		if (m_Handle && s_pReleaseFileFunc)
+			s_pReleaseFileFunc(m_Handle);
+
+		m_Handle = 0;
+		m_pData = 0;
+		m_Size = 0;
+	}
+
+	if (!m_bOpen && !s_bMemoryFilesFirst)
 	{
 		m_bOpen = m_bMemoryFile = CPVRTMemoryFileSystem::GetFile(pszFilename, (const void**)(&m_pData), &m_Size);
 	}
@@ -219,6 +525,130 @@ void CPVRTResourceFile::Close()
 	}
 }
 
+/*!***************************************************************************
+@Function			Prefetch
+@Input				pszFilename Name of the file you would like to open later
+@Input				pfnCallback Function to call once the file has been read, or NULL
+@Input				pUserData Data passed to pfnCallback
+@Description		Queues the file to be read from the read path on an I/O thread. The
+					next CPVRTResourceFile opened with the same name and read path takes
+					the prefetched data, waiting for the read to finish if need be. Each
+					prefetch is taken by one open. pfnCallback is called on the I/O
+					thread, with bLoaded false if the file could not be read; it should
+					not open other files that are still being prefetched. The load
+					function must be thread safe. Where threads are not supported the
+					file is read before this returns.
+*****************************************************************************/
+void CPVRTResourceFile::Prefetch(const char* pszFilename, PFNPrefetchCallback pfnCallback, void* pUserData)
+{
+	if (!pszFilename)
+		return;
+
+	// Files that are opened from memory need no prefetching
+	if (s_bMemoryFilesFirst && CPVRTMemoryFileSystem::GetFile(pszFilename, 0, 0))
+	{
+		if (pfnCallback)
+			pfnCallback(pszFilename, true, pUserData);
+		return;
+	}
+
+	SPrefetch* pPrefetch = new SPrefetch;
+	pPrefetch->Filename = pszFilename;
+	pPrefetch->Path = s_ReadPath;
+	pPrefetch->Path += pszFilename;
+	pPrefetch->pfnLoad = s_pLoadFileFunc;
+	pPrefetch->pfnRelease = s_pReleaseFileFunc;
+	pPrefetch->pfnCallback = pfnCallback;
+	pPrefetch->pUserData = pUserData;
+	pPrefetch->pHandle = 0;
+	pPrefetch->pData = 0;
+	pPrefetch->Size = 0;
+	pPrefetch->eState = ePrefetchQueued;
+
+	IOLock();
+	pPrefetch->pNext = s_pPrefetches;
+	s_pPrefetches = pPrefetch;
+	IOUnlock();
+
+	QueueIOJob(&PrefetchJob, pPrefetch);
+}
+
+/*!***************************************************************************
+@Function			Prefetch
+@Input				ppszFilenames Names of the files you would like to open later
+@Input				i32NumFiles Number of files
+@Input				pfnCallback Function to call once each file has been read, or NULL
+@Input				pUserData Data passed to pfnCallback
+@Description		Queues each of the files as Prefetch() does, in order.
+*****************************************************************************/
+void CPVRTResourceFile::Prefetch(const char* const* ppszFilenames, int i32NumFiles, PFNPrefetchCallback pfnCallback, void* pUserData)
+{
+	for (int i = 0; i < i32NumFiles; ++i)
+		Prefetch(ppszFilenames[i], pfnCallback, pUserData);
+}
+
+/*!***************************************************************************
+@Function			WaitForPrefetch
+@Input				pszFilename Name of a prefetched file
+@Returns			true if the file was prefetched and has been read
+@Description		Blocks until the prefetch of the file has finished. The data stays
+					prefetched for the next CPVRTResourceFile opened with the name.
+*****************************************************************************/
+bool CPVRTResourceFile::WaitForPrefetch(const char* pszFilename)
+{
+	if (!pszFilename)
+		return false;
+
+	CPVRTString Path(s_ReadPath);
+	Path += pszFilename;
+
+	IOLock();
+	SPrefetch* pPrefetch = *WaitForPrefetchLocked(Path);
+	bool bLoaded = pPrefetch && pPrefetch->eState == ePrefetchLoaded;
+	IOUnlock();
+
+	return bLoaded;
+}
+
+/*!***************************************************************************
+@Function			DiscardPrefetch
+@Input				pszFilename Name of a prefetched file
+@Description		Releases the prefetched data of a file that will not be opened,
+					waiting for its read to finish if need be.
+*****************************************************************************/
+void CPVRTResourceFile::DiscardPrefetch(const char* pszFilename)
+{
+	if (!pszFilename)
+		return;
+
+	CPVRTString Path(s_ReadPath);
+	Path += pszFilename;
+
+	SPrefetch* pPrefetch = TakePrefetch(Path);
+	if (!pPrefetch)
+		return;
+
+	if (pPrefetch->eState == ePrefetchLoaded && pPrefetch->pfnRelease)
+		pPrefetch->pfnRelease(pPrefetch->pHandle);
+
+	delete pPrefetch;
+}
+
+/*!***************************************************************************
+@Function			QueueIOJob
+@Input				pfnJob Function to run
+@Input				pUserData Data passed to pfnJob
+@Returns			true if the job was queued, false if it was run on the calling thread
+@Description		Runs a job on the PVRTParallel worker pool, which Prefetch() also
+					reads files on. Jobs start in the order they are queued.
+					Where threads are not supported, or cannot be started, the job
+					is run before this returns.
+*****************************************************************************/
+bool CPVRTResourceFile::QueueIOJob(PFNIOJobFunc pfnJob, void* pUserData)
+{
+	return PVRTParallelQueue(pfnJob, pUserData);
+}
+
 /****************************************************************************
 ** class CPVRTMemoryFileSystem
 ****************************************************************************/
@@ -226,6 +656,10 @@ CPVRTMemoryFileSystem::CAtExit CPVRTMemoryFileSystem::s_AtExit;
 CPVRTMemoryFileSystem::SFileInfo* CPVRTMemoryFileSystem::s_pFileInfo = 0;
 int CPVRTMemoryFileSystem::s_i32Capacity = 0;
 int CPVRTMemoryFileSystem::s_i32NumFiles = 0;
+int* CPVRTMemoryFileSystem::s_pi32Hash = 0;
+int CPVRTMemoryFileSystem::s_i32HashSize = 0;
+CPVRTMemoryFileSystem::SPackInfo* CPVRTMemoryFileSystem::s_pPackInfo = 0;
+int CPVRTMemoryFileSystem::s_i32NumPacks = 0;
 
 /*!***************************************************************************
 @Function		Destructor
@@ -244,6 +678,21 @@ CPVRTMemoryFileSystem::CAtExit::~CAtExit()
 		}
 	}
 	delete [] CPVRTMemoryFileSystem::s_pFileInfo;
+	delete [] CPVRTMemoryFileSystem::s_pi32Hash;
+
+	for (int i = 0; i < CPVRTMemoryFileSystem::s_i32NumPacks; ++i)
+	{
+		SPackInfo& Pack = CPVRTMemoryFileSystem::s_pPackInfo[i];
+#ifdef PVRTMEMORYFILESYSTEM_MMAP
+		if (Pack.bMapped)
+			munmap((void*)Pack.pData, Pack.Size);
+#endif
+		if (Pack.bAllocated)
+			delete [] (char*)Pack.pData;
+
+		delete [] Pack.pszNames;
+	}
+	delete [] CPVRTMemoryFileSystem::s_pPackInfo;
 }
 
 CPVRTMemoryFileSystem::CPVRTMemoryFileSystem(const char* pszFilename, const void* pBuffer, size_t Size, bool bCopy)
@@ -264,18 +713,21 @@ void CPVRTMemoryFileSystem::RegisterMemoryFile(const char* pszFilename, const vo
 {
 	if (s_i32NumFiles == s_i32Capacity)
 	{
-		SFileInfo* pFileInfo = new SFileInfo[s_i32Capacity + 10];
-		memcpy(pFileInfo, s_pFileInfo, sizeof(SFileInfo) * s_i32Capacity);
+		// Grow geometrically, as mounted packs can register thousands of files
+		int i32Capacity = s_i32Capacity ? s_i32Capacity * 2 : 16;
+		SFileInfo* pFileInfo = new SFileInfo[i32Capacity];
+		if (s_i32Capacity)
+			memcpy(pFileInfo, s_pFileInfo, sizeof(SFileInfo) * s_i32Capacity);
 		delete [] s_pFileInfo;
 		s_pFileInfo = pFileInfo;
-		s_i32Capacity += 10;
+		s_i32Capacity = i32Capacity;
 	}
 
 	s_pFileInfo[s_i32NumFiles].pszFilename = pszFilename;
 	s_pFileInfo[s_i32NumFiles].pBuffer = pBuffer;
 	if (bCopy)
 	{
-		char* pszNewFilename = new char[strlen(pszFilename)];
+		char* pszNewFilename = new char[strlen(pszFilename) + 1];
 		strcpy(pszNewFilename, pszFilename);
 		s_pFileInfo[s_i32NumFiles].pszFilename = pszNewFilename;
 
@@ -285,6 +737,7 @@ void CPVRTMemoryFileSystem::RegisterMemoryFile(const char* pszFilename, const vo
 	}
 	s_pFileInfo[s_i32NumFiles].Size = Size;
 	s_pFileInfo[s_i32NumFiles].bAllocated = bCopy;
+	HashFile(s_i32NumFiles);
 	++s_i32NumFiles;
 }
 
@@ -299,16 +752,14 @@ void CPVRTMemoryFileSystem::RegisterMemoryFile(const char* pszFilename, const vo
 *****************************************************************************/
 bool CPVRTMemoryFileSystem::GetFile(const char* pszFilename, const void** ppBuffer, size_t* pSize)
 {
-	for (int i = 0; i < s_i32NumFiles; ++i)
-	{
-		if (strcmp(s_pFileInfo[i].pszFilename, pszFilename) == 0)
-		{
-			if (ppBuffer) *ppBuffer = s_pFileInfo[i].pBuffer;
-			if (pSize) *pSize = s_pFileInfo[i].Size;
-			return true;
-		}
-	}
-	return false;
+	int i32Index = FindFile(pszFilename);
+
+	if (i32Index < 0)
+		return false;
+
+	if (ppBuffer) *ppBuffer = s_pFileInfo[i32Index].pBuffer;
+	if (pSize) *pSize = s_pFileInfo[i32Index].Size;
+	return true;
 }
 
 /*!***************************************************************************
@@ -330,11 +781,304 @@ int CPVRTMemoryFileSystem::GetNumFiles()
 *****************************************************************************/
 const char* CPVRTMemoryFileSystem::GetFilename(int i32Index)
 {
-	if (i32Index < 0 || i32Index > s_i32NumFiles) return 0;
+	if (i32Index < 0 || i32Index >= s_i32NumFiles) return 0;
 
 	return s_pFileInfo[i32Index].pszFilename;
 }
 
+/*!***************************************************************************
+@Function		MountPack
+@Input			pszPackFilename	Name of the pack file, relative to the
+								CPVRTResourceFile read path
+@Input			pszDirectory	Prefix for the names of the packed files
+@Return			true if the pack was mounted, false otherwise
+@Description	Registers every file of a pack written by SavePack. The pack
+				is mapped into memory where the platform allows, or else
+				read in one go, and stays there until exit. Each file is
+				registered as pszDirectory followed by its packed name, so
+				pass "Textures/" to mount the pack as a Textures directory.
+*****************************************************************************/
+bool CPVRTMemoryFileSystem::MountPack(const char* pszPackFilename, const char* pszDirectory)
+{
+	if (!pszPackFilename)
+		return false;
+
+#ifdef PVRTMEMORYFILESYSTEM_MMAP
+	CPVRTString Path(CPVRTResourceFile::GetReadPath());
+	Path += pszPackFilename;
+
+	int fd = open(Path.c_str(), O_RDONLY);
+	if (fd >= 0)
+	{
+		struct stat sStat;
+		void* pData = MAP_FAILED;
+
+		if (fstat(fd, &sStat) == 0 && sStat.st_size > 0)
+			pData = mmap(0, (size_t) sStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		close(fd);	// The mapping holds its own reference to the file
+
+		if (pData != MAP_FAILED)
+		{
+			if (AddPack(pData, (size_t) sStat.st_size, pszDirectory, true, false))
+				return true;
+
+			munmap(pData, (size_t) sStat.st_size);
+			return false;
+		}
+	}
+#endif
+
+	// Fall back to reading the whole pack, which also finds packs held in memory
+	CPVRTResourceFile File(pszPackFilename);
+	if (!File.IsOpen())
+		return false;
+
+	char* pData = new char[File.Size()];
+	memcpy(pData, File.DataPtr(), File.Size());
+
+	if (AddPack(pData, File.Size(), pszDirectory, false, true))
+		return true;
+
+	delete [] pData;
+	return false;
+}
+
+/*!***************************************************************************
+@Function		MountPack
+@Input			pPack			Pointer to the pack data
+@Input			Size			Pack size
+@Input			pszDirectory	Prefix for the names of the packed files
+@Return			true if the pack was mounted, false otherwise
+@Description	Registers every file of a pack that is already in memory,
+				without copying it. The pack data must outlive its use.
+*****************************************************************************/
+bool CPVRTMemoryFileSystem::MountPack(const void* pPack, size_t Size, const char* pszDirectory)
+{
+	return AddPack(pPack, Size, pszDirectory, false, false);
+}
+
+/*!***************************************************************************
+@Function		SavePack
+@Input			pszPackFilename	Name of the pack file to write
+@Input			ppszFilenames	Names of the files to pack
+@Input			i32NumFiles		Number of files to pack
+@Return			true if the pack was written, false otherwise
+@Description	Writes a pack for MountPack: a header and an index, then the
+				names, then the file data. Each file is read through
+				CPVRTResourceFile and is packed under the name given.
+				Empty files are packed as entries of size zero.
+*****************************************************************************/
+bool CPVRTMemoryFileSystem::SavePack(const char* pszPackFilename, const char* const* ppszFilenames, int i32NumFiles)
+{
+	if (!pszPackFilename || i32NumFiles < 0 || (i32NumFiles && !ppszFilenames))
+		return false;
+
+	// Lay out the index. The names follow it and each file is aligned after them
+	unsigned char* pu8Index = new unsigned char[PVRTPACK_HEADER_SIZE + PVRTPACK_ENTRY_SIZE * i32NumFiles];
+	size_t Offset = PVRTPACK_HEADER_SIZE + PVRTPACK_ENTRY_SIZE * i32NumFiles;
+	bool bRet = true;
+
+	PackWrite32(pu8Index, PVRTPACK_MAGIC);
+	PackWrite32(pu8Index + 4, PVRTPACK_VERSION);
+	PackWrite32(pu8Index + 8, (unsigned int) i32NumFiles);
+	PackWrite32(pu8Index + 12, 0);
+
+	for (int i = 0; i < i32NumFiles; ++i)
+	{
+		size_t NameLength = strlen(ppszFilenames[i]);
+		PackWrite32(pu8Index + PVRTPACK_HEADER_SIZE + PVRTPACK_ENTRY_SIZE * i, (unsigned int) Offset);
+		PackWrite32(pu8Index + PVRTPACK_HEADER_SIZE + PVRTPACK_ENTRY_SIZE * i + 4, (unsigned int) NameLength);
+		Offset += NameLength + 1;
+	}
+
+	for (int i = 0; i < i32NumFiles && bRet; ++i)
+	{
+		CPVRTResourceFile File(ppszFilenames[i]);
+		bRet = File.IsOpen() || PackIsEmptyFile(ppszFilenames[i]);
+
+		Offset = (Offset + PVRTPACK_ALIGN - 1) & ~(size_t)(PVRTPACK_ALIGN - 1);
+		PackWrite32(pu8Index + PVRTPACK_HEADER_SIZE + PVRTPACK_ENTRY_SIZE * i + 8, (unsigned int) Offset);
+		PackWrite32(pu8Index + PVRTPACK_HEADER_SIZE + PVRTPACK_ENTRY_SIZE * i + 12, (unsigned int) File.Size());
+		Offset += File.Size();
+	}
+
+	// Offsets and sizes are 32 bit
+	bRet = bRet && Offset <= 0xFFFFFFFF;
+
+	FILE* pFile = bRet ? fopen(pszPackFilename, "wb") : 0;
+	if (!pFile)
+	{
+		delete [] pu8Index;
+		return false;
+	}
+
+	Offset = PVRTPACK_HEADER_SIZE + PVRTPACK_ENTRY_SIZE * i32NumFiles;
+	bRet = fwrite(pu8Index, 1, Offset, pFile) == Offset;
+
+	for (int i = 0; i < i32NumFiles && bRet; ++i)
+	{
+		size_t NameSize = strlen(ppszFilenames[i]) + 1;
+		bRet = fwrite(ppszFilenames[i], 1, NameSize, pFile) == NameSize;
+		Offset += NameSize;
+	}
+
+	for (int i = 0; i < i32NumFiles && bRet; ++i)
+	{
+		static const char pPadding[PVRTPACK_ALIGN] = { 0 };
+		size_t DataOffset = PackRead32(pu8Index + PVRTPACK_HEADER_SIZE + PVRTPACK_ENTRY_SIZE * i + 8);
+		size_t DataSize = PackRead32(pu8Index + PVRTPACK_HEADER_SIZE + PVRTPACK_ENTRY_SIZE * i + 12);
+
+		// The file must not have changed since the index was laid out
+		CPVRTResourceFile File(ppszFilenames[i]);
+		bRet = File.IsOpen() ? File.Size() == DataSize : (!DataSize && PackIsEmptyFile(ppszFilenames[i]));
+		bRet = bRet && fwrite(pPadding, 1, DataOffset - Offset, pFile) == DataOffset - Offset;
+		bRet = bRet && (!DataSize || fwrite(File.DataPtr(), 1, DataSize, pFile) == DataSize);
+		Offset = DataOffset + DataSize;
+	}
+
+	bRet = fclose(pFile) == 0 && bRet;
+	delete [] pu8Index;
+	return bRet;
+}
+
+/*!***************************************************************************
+@Function		FindFile
+@Input			pszFilename		Name of file to look up
+@Return			Index of the first file registered under the name, or -1
+*****************************************************************************/
+int CPVRTMemoryFileSystem::FindFile(const char* pszFilename)
+{
+	if (!s_i32HashSize || !pszFilename)
+		return -1;
+
+	unsigned int ui32Slot = HashFilename(pszFilename) & (s_i32HashSize - 1);
+
+	// The table is never full, so the probe always ends at an empty slot
+	while (s_pi32Hash[ui32Slot] >= 0)
+	{
+		if (strcmp(s_pFileInfo[s_pi32Hash[ui32Slot]].pszFilename, pszFilename) == 0)
+			return s_pi32Hash[ui32Slot];
+
+		ui32Slot = (ui32Slot + 1) & (s_i32HashSize - 1);
+	}
+	return -1;
+}
+
+/*!***************************************************************************
+@Function		HashFile
+@Input			i32Index		Index of the file to add to the table
+@Description	Adds a file to the name table, growing the table as needed.
+				A name that is already in the table keeps its first file.
+*****************************************************************************/
+void CPVRTMemoryFileSystem::HashFile(int i32Index)
+{
+	if ((i32Index + 1) * 2 > s_i32HashSize)
+	{
+		// Double the table and add back the files registered so far
+		int i32HashSize = s_i32HashSize ? s_i32HashSize * 2 : 64;
+		delete [] s_pi32Hash;
+		s_pi32Hash = new int[i32HashSize];
+		s_i32HashSize = i32HashSize;
+		memset(s_pi32Hash, 0xff, sizeof(int) * i32HashSize);
+
+		for (int i = 0; i < i32Index; ++i)
+			HashFile(i);
+	}
+
+	const char* pszFilename = s_pFileInfo[i32Index].pszFilename;
+	unsigned int ui32Slot = HashFilename(pszFilename) & (s_i32HashSize - 1);
+
+	while (s_pi32Hash[ui32Slot] >= 0)
+	{
+		if (strcmp(s_pFileInfo[s_pi32Hash[ui32Slot]].pszFilename, pszFilename) == 0)
+			return;
+
+		ui32Slot = (ui32Slot + 1) & (s_i32HashSize - 1);
+	}
+	s_pi32Hash[ui32Slot] = i32Index;
+}
+
+/*!***************************************************************************
+@Function		AddPack
+@Input			pPack			Pointer to the pack data
+@Input			Size			Pack size
+@Input			pszDirectory	Prefix for the names of the packed files
+@Input			bMapped			The pack data is a mapping to release at exit
+@Input			bAllocated		The pack data is an allocation to free at exit
+@Return			true if the pack was valid and its files were registered
+*****************************************************************************/
+bool CPVRTMemoryFileSystem::AddPack(const void* pPack, size_t Size, const char* pszDirectory, bool bMapped, bool bAllocated)
+{
+	const unsigned char* pu8Pack = (const unsigned char*) pPack;
+
+	if (!pu8Pack || Size < PVRTPACK_HEADER_SIZE ||
+		PackRead32(pu8Pack) != PVRTPACK_MAGIC || PackRead32(pu8Pack + 4) != PVRTPACK_VERSION)
+		return false;
+
+	unsigned int ui32NumFiles = PackRead32(pu8Pack + 8);
+	if (ui32NumFiles > (Size - PVRTPACK_HEADER_SIZE) / PVRTPACK_ENTRY_SIZE)
+		return false;
+
+	// Check the whole index before registering anything
+	size_t DirectoryLength = pszDirectory ? strlen(pszDirectory) : 0;
+	size_t NamesSize = 0;
+
+	for (unsigned int i = 0; i < ui32NumFiles; ++i)
+	{
+		const unsigned char* pu8Entry = pu8Pack + PVRTPACK_HEADER_SIZE + PVRTPACK_ENTRY_SIZE * i;
+		size_t NameOffset = PackRead32(pu8Entry);
+		size_t NameLength = PackRead32(pu8Entry + 4);
+		size_t DataOffset = PackRead32(pu8Entry + 8);
+		size_t DataSize = PackRead32(pu8Entry + 12);
+
+		if (NameOffset >= Size || NameLength >= Size - NameOffset || pu8Pack[NameOffset + NameLength] != 0)
+			return false;
+
+		if (DataOffset > Size || DataSize > Size - DataOffset)
+			return false;
+
+		NamesSize += DirectoryLength + NameLength + 1;
+	}
+
+	if (s_i32NumPacks == 0 || (s_i32NumPacks & (s_i32NumPacks - 1)) == 0)
+	{
+		// Grow to the next power of two
+		SPackInfo* pPackInfo = new SPackInfo[s_i32NumPacks ? s_i32NumPacks * 2 : 1];
+		if (s_i32NumPacks)
+			memcpy(pPackInfo, s_pPackInfo, sizeof(SPackInfo) * s_i32NumPacks);
+		delete [] s_pPackInfo;
+		s_pPackInfo = pPackInfo;
+	}
+
+	SPackInfo& Pack = s_pPackInfo[s_i32NumPacks++];
+	Pack.pData = pPack;
+	Pack.Size = Size;
+	Pack.pszNames = DirectoryLength ? new char[NamesSize] : 0;
+	Pack.bMapped = bMapped;
+	Pack.bAllocated = bAllocated;
+
+	// Without a directory the names are used in place
+	char* pszName = Pack.pszNames;
+
+	for (unsigned int i = 0; i < ui32NumFiles; ++i)
+	{
+		const unsigned char* pu8Entry = pu8Pack + PVRTPACK_HEADER_SIZE + PVRTPACK_ENTRY_SIZE * i;
+		const char* pszPackedName = (const char*) pu8Pack + PackRead32(pu8Entry);
+
+		if (pszName)
+		{
+			memcpy(pszName, pszDirectory, DirectoryLength);
+			memcpy(pszName + DirectoryLength, pszPackedName, PackRead32(pu8Entry + 4) + 1);
+			pszPackedName = pszName;
+			pszName += DirectoryLength + PackRead32(pu8Entry + 4) + 1;
+		}
+
+		RegisterMemoryFile(pszPackedName, pu8Pack + PackRead32(pu8Entry + 8), PackRead32(pu8Entry + 12), false);
+	}
+	return true;
+}
+
 
 /*****************************************************************************
  End of file (PVRTResourceFile.cpp)
@@ -21,6 +21,8 @@
 
 typedef void* (*PFNLoadFileFunc)(const char*, char** pData, size_t &size);
 typedef bool  (*PFNReleaseFileFunc)(void* handle);
+typedef void  (*PFNIOJobFunc)(void* pUserData);
+typedef void  (*PFNPrefetchCallback)(const char* pszFilename, bool bLoaded, void* pUserData);
 
 /*!***************************************************************************
  @Class CPVRTResourceFile
@@ -52,6 +54,70 @@ public:
 	*****************************************************************************/
 	static void SetLoadReleaseFunctions(void* pLoadFileFunc, void* pReleaseFileFunc);
 
+	/*!***************************************************************************
+	@Function			SetMemoryFilesFirst
+	@Input				bFirst Whether to look in CPVRTMemoryFileSystem before the read path
+	@Description		By default a file is looked for in the read path, and only then in
+						CPVRTMemoryFileSystem. Looking in memory first saves a failed file open
+						for every file registered in memory or in a mounted pack.
+	*****************************************************************************/
+	static void SetMemoryFilesFirst(bool bFirst);
+
+	/*!***************************************************************************
+	@Function			Prefetch
+	@Input				pszFilename Name of the file you would like to open later
+	@Input				pfnCallback Function to call once the file has been read, or NULL
+	@Input				pUserData Data passed to pfnCallback
+	@Description		Queues the file to be read from the read path on an I/O thread. The
+						next CPVRTResourceFile opened with the same name and read path takes
+						the prefetched data, waiting for the read to finish if need be. Each
+						prefetch is taken by one open. pfnCallback is called on the I/O
+						thread, with bLoaded false if the file could not be read; it should
+						not open other files that are still being prefetched. The load
+						function must be thread safe. Where threads are not supported the
+						file is read before this returns.
+	*****************************************************************************/
+	static void Prefetch(const char* pszFilename, PFNPrefetchCallback pfnCallback = 0, void* pUserData = 0);
+
+	/*!***************************************************************************
+	@Function			Prefetch
+	@Input				ppszFilenames Names of the files you would like to open later
+	@Input				i32NumFiles Number of files
+	@Input				pfnCallback Function to call once each file has been read, or NULL
+	@Input				pUserData Data passed to pfnCallback
+	@Description		Queues each of the files as Prefetch() does, in order.
+	*****************************************************************************/
+	static void Prefetch(const char* const* ppszFilenames, int i32NumFiles, PFNPrefetchCallback pfnCallback = 0, void* pUserData = 0);
+
+	/*!***************************************************************************
+	@Function			WaitForPrefetch
+	@Input				pszFilename Name of a prefetched file
+	@Returns			true if the file was prefetched and has been read
+	@Description		Blocks until the prefetch of the file has finished. The data stays
+						prefetched for the next CPVRTResourceFile opened with the name.
+	*****************************************************************************/
+	static bool WaitForPrefetch(const char* pszFilename);
+
+	/*!***************************************************************************
+	@Function			DiscardPrefetch
+	@Input				pszFilename Name of a prefetched file
+	@Description		Releases the prefetched data of a file that will not be opened,
+						waiting for its read to finish if need be.
+	*****************************************************************************/
+	static void DiscardPrefetch(const char* pszFilename);
+
+	/*!***************************************************************************
+	@Function			QueueIOJob
+	@Input				pfnJob Function to run
+	@Input				pUserData Data passed to pfnJob
+	@Returns			true if the job was queued, false if it was run on the calling thread
+	@Description		Runs a job on the PVRTParallel worker pool, which Prefetch() also
+						reads files on. Jobs start in the order they are queued.
+						Where threads are not supported, or cannot be started, the job
+						is run before this returns.
+	*****************************************************************************/
+	static bool QueueIOJob(PFNIOJobFunc pfnJob, void* pUserData);
+
 	/*!***************************************************************************
 	@Function			CPVRTResourceFile
 	@Input				pszFilename Name of the file you would like to open
@@ -116,6 +182,7 @@ protected:
 	void *m_Handle;
 
 	static CPVRTString s_ReadPath;
+	static bool s_bMemoryFilesFirst;
 	static PFNLoadFileFunc s_pLoadFileFunc;
 	static PFNReleaseFileFunc s_pReleaseFileFunc;
 };
@@ -0,0 +1,281 @@
+/******************************************************************************
+
+ @File         PVRTSimd.h
+
+ @Title        PVRTSimd
+
+ @Version
+
+ @Copyright    Copyright (c) Imagination Technologies Limited.
+
+ @Platform     ANSI compatible
+
+ @Description  Thin wrapper over the 4-wide float instructions of the target
+               (SSE on x86, NEON on ARM), used by the matrix and transform
+               functions. PVRT_SIMD is defined when one of the backends is
+               available; otherwise callers use their scalar code.
+
+               Define PVRT_NO_SIMD to force the scalar code. The vector paths
+               keep the same multiplication and addition order as the scalar
+               code and do not use fused multiply-add, so both give the same
+               results (ARMv7 NEON flushes denormals to zero).
+
+******************************************************************************/
+#ifndef _PVRTSIMD_H_
+#define _PVRTSIMD_H_
+
+#include "PVRTGlobal.h"
+
+#if !defined(PVRT_NO_SIMD) && !defined(PVRT_FIXED_POINT_ENABLE)
+	#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+		#include <xmmintrin.h>
+		#define PVRT_SIMD
+		#define PVRT_SIMD_SSE
+	#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+		#include <arm_neon.h>
+		#define PVRT_SIMD
+		#define PVRT_SIMD_NEON
+	#endif
+#endif
+
+#ifdef PVRT_SIMD
+
+/****************************************************************************
+** Types
+****************************************************************************/
+#ifdef PVRT_SIMD_SSE
+typedef __m128		PVRTSIMDVEC;
+#else
+typedef float32x4_t	PVRTSIMDVEC;
+#endif
+
+/****************************************************************************
+** Functions
+****************************************************************************/
+
+/*!***************************************************************************
+ @Function		PVRTSimdLoad
+ @Input			pf		Four floats; need not be aligned
+ @Return		The loaded vector
+*****************************************************************************/
+inline PVRTSIMDVEC PVRTSimdLoad(const float * const pf)
+{
+#ifdef PVRT_SIMD_SSE
+	return _mm_loadu_ps(pf);
+#else
+	return vld1q_f32(pf);
+#endif
+}
+
+/*!***************************************************************************
+ @Function		PVRTSimdStore
+ @Output		pf		Destination for four floats; need not be aligned
+ @Input			v		Vector to store
+*****************************************************************************/
+inline void PVRTSimdStore(float * const pf, const PVRTSIMDVEC v)
+{
+#ifdef PVRT_SIMD_SSE
+	_mm_storeu_ps(pf, v);
+#else
+	vst1q_f32(pf, v);
+#endif
+}
+
+/*!***************************************************************************
+ @Function		PVRTSimdSet
+ @Return		The vector [x y z w]
+*****************************************************************************/
+inline PVRTSIMDVEC PVRTSimdSet(const float x, const float y, const float z, const float w)
+{
+#ifdef PVRT_SIMD_SSE
+	return _mm_setr_ps(x, y, z, w);
+#else
+	const float af[4] = { x, y, z, w };
+	return vld1q_f32(af);
+#endif
+}
+
+/*!***************************************************************************
+ @Function		PVRTSimdSplat
+ @Return		The vector [f f f f]
+*****************************************************************************/
+inline PVRTSIMDVEC PVRTSimdSplat(const float f)
+{
+#ifdef PVRT_SIMD_SSE
+	return _mm_set1_ps(f);
+#else
+	return vdupq_n_f32(f);
+#endif
+}
+
+/*!***************************************************************************
+ @Function		PVRTSimdAdd
+ @Return		a + b, per component
+*****************************************************************************/
+inline PVRTSIMDVEC PVRTSimdAdd(const PVRTSIMDVEC a, const PVRTSIMDVEC b)
+{
+#ifdef PVRT_SIMD_SSE
+	return _mm_add_ps(a, b);
+#else
+	return vaddq_f32(a, b);
+#endif
+}
+
+/*!***************************************************************************
+ @Function		PVRTSimdSub
+ @Return		a - b, per component
+*****************************************************************************/
+inline PVRTSIMDVEC PVRTSimdSub(const PVRTSIMDVEC a, const PVRTSIMDVEC b)
+{
+#ifdef PVRT_SIMD_SSE
+	return _mm_sub_ps(a, b);
+#else
+	return vsubq_f32(a, b);
+#endif
+}
+
+/*!***************************************************************************
+ @Function		PVRTSimdMul
+ @Return		a * b, per component
+*****************************************************************************/
+inline PVRTSIMDVEC PVRTSimdMul(const PVRTSIMDVEC a, const PVRTSIMDVEC b)
+{
+#ifdef PVRT_SIMD_SSE
+	return _mm_mul_ps(a, b);
+#else
+	return vmulq_f32(a, b);
+#endif
+}
+
+/*!***************************************************************************
+ @Function		PVRTSimdScale
+ @Return		v * f, per component
+*****************************************************************************/
+inline PVRTSIMDVEC PVRTSimdScale(const PVRTSIMDVEC v, const float f)
+{
+#ifdef PVRT_SIMD_SSE
+	return _mm_mul_ps(v, _mm_set1_ps(f));
+#else
+	return vmulq_n_f32(v, f);
+#endif
+}
+
+/*!***************************************************************************
+ @Function		PVRTSimdNeg
+ @Return		-v, per component. Only the sign bits are flipped, as with
+				the scalar unary minus.
+*****************************************************************************/
+inline PVRTSIMDVEC PVRTSimdNeg(const PVRTSIMDVEC v)
+{
+#ifdef PVRT_SIMD_SSE
+	return _mm_xor_ps(v, _mm_set1_ps(-0.0f));
+#else
+	return vnegq_f32(v);
+#endif
+}
+
+/*!***************************************************************************
+ @Function		PVRTSimdXorSign
+ @Input			v		Vector to change the signs of
+ @Input			vSign	Vector of 0.0f and -0.0f components
+ @Return		v with the sign of each component flipped where vSign is -0.0f.
+				Flipping is exact, as with the scalar unary minus.
+*****************************************************************************/
+inline PVRTSIMDVEC PVRTSimdXorSign(const PVRTSIMDVEC v, const PVRTSIMDVEC vSign)
+{
+#ifdef PVRT_SIMD_SSE
+	return _mm_xor_ps(v, vSign);
+#else
+	return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(v), vreinterpretq_u32_f32(vSign)));
+#endif
+}
+
+/*!***************************************************************************
+ @Function		PVRTSimdShuffle
+ @Input			a, b	Vectors to take the components from
+ @Return		The vector [a[X] a[Y] b[Z] b[W]]
+ @Description	Component indices are 0 to 3. Use the same vector for a and b
+				to reorder the components of one vector.
+*****************************************************************************/
+template<int X, int Y, int Z, int W>
+inline PVRTSIMDVEC PVRTSimdShuffle(const PVRTSIMDVEC a, const PVRTSIMDVEC b)
+{
+#ifdef PVRT_SIMD_SSE
+	return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+#elif defined(__clang__)
+	return __builtin_shufflevector(a, b, X, Y, Z + 4, W + 4);
+#else
+	float af[8];
+
+	vst1q_f32(&af[0], a);
+	vst1q_f32(&af[4], b);
+	return PVRTSimdSet(af[X], af[Y], af[Z + 4], af[W + 4]);
+#endif
+}
+
+/*!***************************************************************************
+ @Function		PVRTSimdTranspose
+ @Modified		v0, v1, v2, v3	The rows of a 4x4 matrix, replaced by its
+								columns
+*****************************************************************************/
+inline void PVRTSimdTranspose(PVRTSIMDVEC &v0, PVRTSIMDVEC &v1, PVRTSIMDVEC &v2, PVRTSIMDVEC &v3)
+{
+#ifdef PVRT_SIMD_SSE
+	_MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+#else
+	const float32x4x2_t v01 = vtrnq_f32(v0, v1);
+	const float32x4x2_t v23 = vtrnq_f32(v2, v3);
+
+	v0 = vcombine_f32(vget_low_f32(v01.val[0]), vget_low_f32(v23.val[0]));
+	v1 = vcombine_f32(vget_low_f32(v01.val[1]), vget_low_f32(v23.val[1]));
+	v2 = vcombine_f32(vget_high_f32(v01.val[0]), vget_high_f32(v23.val[0]));
+	v3 = vcombine_f32(vget_high_f32(v01.val[1]), vget_high_f32(v23.val[1]));
+#endif
+}
+
+/*!***************************************************************************
+ @Function		PVRTSimdNonNegativeMask
+ @Return		A 4 bit mask with bit i set if component i of v is >= 0.
+				NaN components give a clear bit.
+*****************************************************************************/
+inline unsigned int PVRTSimdNonNegativeMask(const PVRTSIMDVEC v)
+{
+#ifdef PVRT_SIMD_SSE
+	return (unsigned int) _mm_movemask_ps(_mm_cmpge_ps(v, _mm_setzero_ps()));
+#else
+	static const uint32_t c_au32Bits[4] = { 1, 2, 4, 8 };
+	const uint32x4_t u = vandq_u32(vcgeq_f32(v, vdupq_n_f32(0.0f)), vld1q_u32(c_au32Bits));
+	const uint32x2_t u2 = vorr_u32(vget_low_u32(u), vget_high_u32(u));
+	return (unsigned int) (vget_lane_u32(u2, 0) | vget_lane_u32(u2, 1));
+#endif
+}
+
+/*!***************************************************************************
+ @Function		PVRTSimdCombine
+ @Input			v0, v1, v2, v3	Vectors to combine
+ @Input			pf				Four weights
+ @Return		((v0*pf[0] + v1*pf[1]) + v2*pf[2]) + v3*pf[3]
+ @Description	The building block of the 4x4 matrix products: a weighted sum
+				of four rows, summed in the same order as the scalar code.
+*****************************************************************************/
+inline PVRTSIMDVEC PVRTSimdCombine(
+	const PVRTSIMDVEC	v0,
+	const PVRTSIMDVEC	v1,
+	const PVRTSIMDVEC	v2,
+	const PVRTSIMDVEC	v3,
+	const float			* const pf)
+{
+	PVRTSIMDVEC vRet;
+
+	vRet = PVRTSimdAdd(PVRTSimdScale(v0, pf[0]), PVRTSimdScale(v1, pf[1]));
+	vRet = PVRTSimdAdd(vRet, PVRTSimdScale(v2, pf[2]));
+	return PVRTSimdAdd(vRet, PVRTSimdScale(v3, pf[3]));
+}
+
+#endif /* PVRT_SIMD */
+
+#endif /* _PVRTSIMD_H_ */
+
+/*****************************************************************************
+ End of file (PVRTSimd.h)
+*****************************************************************************/
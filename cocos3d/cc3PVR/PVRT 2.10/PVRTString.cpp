@@ -39,8 +39,9 @@ const size_t CPVRTString::npos = (size_t) -1;
 @Description		Constructor
 ************************************************************************/
 CPVRTString::CPVRTString(const char* _Ptr, size_t _Count) :
-m_pString(0), m_Capacity(0)
+m_pString(m_aLocal), m_Size(0), m_Capacity(c_LocalCapacity)
 {
+	m_aLocal[0] = 0;
 	if (_Count == npos)
 	{
 		if (_Ptr == NULL)
@@ -64,8 +65,9 @@ m_pString(0), m_Capacity(0)
 @Description		Constructor
 ************************************************************************/
 CPVRTString::CPVRTString(const CPVRTString& _Right, size_t _Roff, size_t _Count) :
-m_pString(0), m_Capacity(0)
+m_pString(m_aLocal), m_Size(0), m_Capacity(c_LocalCapacity)
 {
+	m_aLocal[0] = 0;
 	assign(_Right, _Roff, _Count);
 }
 
@@ -76,8 +78,9 @@ m_pString(0), m_Capacity(0)
 @Description		Constructor
 *************************************************************************/
 CPVRTString::CPVRTString(size_t _Count, char _Ch) :
-m_pString(0), m_Capacity(0)
+m_pString(m_aLocal), m_Size(0), m_Capacity(c_LocalCapacity)
 {
+	m_aLocal[0] = 0;
 	assign(_Count,_Ch);
 }
 
@@ -87,20 +90,36 @@ m_pString(0), m_Capacity(0)
 @Description		Constructor
 *************************************************************************/
 CPVRTString::CPVRTString(const char _Ch) :
-m_pString(0), m_Capacity(0)
-{  	
+m_pString(m_aLocal), m_Size(0), m_Capacity(c_LocalCapacity)
+{
+	m_aLocal[0] = 0;  	
 	assign( 1, _Ch);
 }
 
 /*!***********************************************************************
 @Function			CPVRTString
-@Description		Constructor
+@Description		Constructor. Does not allocate: short strings are
+					held in storage inside the object.
 *************************************************************************/
 CPVRTString::CPVRTString() :
-m_Size(0), m_Capacity(1)
+m_pString(m_aLocal), m_Size(0), m_Capacity(c_LocalCapacity)
+{
+	m_aLocal[0] = 0;
+}
+
+#ifdef PVRTSTRING_MOVE
+/*!***********************************************************************
+@Function			CPVRTString
+@Input				_Right	A string to move from. Left empty.
+@Description		Move constructor. Takes over the buffer of _Right
+					instead of copying it.
+*************************************************************************/
+CPVRTString::CPVRTString(CPVRTString&& _Right) :
+m_pString(m_aLocal), m_Size(0), m_Capacity(c_LocalCapacity)
 {
-	m_pString = (char*)calloc(1, 1);
+	take(_Right);
 }
+#endif
 
 /*!***********************************************************************
 @Function			~CPVRTString
@@ -108,13 +127,82 @@ m_Size(0), m_Capacity(1)
 *************************************************************************/
 CPVRTString::~CPVRTString()
 {
-	if (m_pString)
+	if (m_pString != m_aLocal)
 	{
 		free(m_pString);
-		m_pString=NULL;
 	}
+	m_pString=NULL;
+}
+
+/*!***********************************************************************
+@Function			grow
+@Input				_Count	Number of chars the string must hold
+@Description		Makes room for _Count chars plus the null terminator,
+					keeping the contents. The buffer at least doubles in
+					size, so a sequence of appends takes amortized
+					constant time per char.
+*************************************************************************/
+void CPVRTString::grow(size_t _Count)
+{
+	if (_Count < m_Capacity)
+	{
+		return;
+	}
+	size_t newCapacity = m_Capacity * 2;
+	if (newCapacity < _Count + 1)
+	{
+		newCapacity = _Count + 1;	// +1 for null termination
+	}
+	reallocate(newCapacity);
+}
+
+/*!***********************************************************************
+@Function			reallocate
+@Input				_Capacity	New buffer size, including the null terminator
+@Description		Moves the contents to a heap buffer of _Capacity bytes.
+*************************************************************************/
+void CPVRTString::reallocate(size_t _Capacity)
+{
+	if (m_pString == m_aLocal)
+	{
+		m_pString = (char*)malloc(_Capacity);
+		memcpy(m_pString, m_aLocal, m_Size + 1);
+	}
+	else
+	{
+		m_pString = (char*)realloc(m_pString, _Capacity);
+	}
+	m_Capacity = _Capacity;
 }
 
+#ifdef PVRTSTRING_MOVE
+/*!***********************************************************************
+@Function			take
+@Input				_Right	A string to move from
+@Description		Takes the contents of _Right and leaves it empty.
+					This string must not own a heap buffer.
+*************************************************************************/
+void CPVRTString::take(CPVRTString& _Right)
+{
+	if (_Right.m_pString == _Right.m_aLocal)
+	{
+		memcpy(m_aLocal, _Right.m_aLocal, _Right.m_Size + 1);
+		m_pString = m_aLocal;
+	}
+	else
+	{
+		m_pString = _Right.m_pString;
+	}
+	m_Size = _Right.m_Size;
+	m_Capacity = _Right.m_Capacity;
+
+	_Right.m_pString = _Right.m_aLocal;
+	_Right.m_aLocal[0] = 0;
+	_Right.m_Size = 0;
+	_Right.m_Capacity = c_LocalCapacity;
+}
+#endif
+
 /*!***********************************************************************
 @Function			append
 @Input				_Ptr	A string
@@ -139,33 +227,25 @@ CPVRTString& CPVRTString::append(const char* _Ptr)
 *************************************************************************/
 CPVRTString& CPVRTString::append(const char* _Ptr, size_t _Count)
 {
-	char* pString = m_pString;
-	size_t newCapacity = _Count + m_Size + 1;	// +1 for null termination
-
-	// extend CPVRTString if necessary
-	if (m_Capacity < newCapacity)
+	// extend CPVRTString if necessary, keeping hold of _Ptr if it points into it
+	if (m_Capacity <= m_Size + _Count)
 	{
-		pString = (char*)malloc(newCapacity);
-		m_Capacity = newCapacity;				 // Using low memory profile (but very slow append)
-		memmove(pString, m_pString, m_Size);
-		pString[m_Capacity-1]='\0';
+		if (_Ptr >= m_pString && _Ptr <= m_pString + m_Size)
+		{
+			size_t offset = _Ptr - m_pString;
+			grow(m_Size + _Count);
+			_Ptr = m_pString + offset;
+		}
+		else
+		{
+			grow(m_Size + _Count);
+		}
 	}
 
 	// append chars from _Ptr
-	memmove(pString + m_Size, _Ptr, _Count);
+	memmove(m_pString + m_Size, _Ptr, _Count);
 	m_Size += _Count;
-	pString[m_Size] = 0;
-
-	// remove old CPVRTString if necessary
-	if (pString != m_pString)
-	{
-		if (m_pString)
-		{
-			free(m_pString);
-			m_pString=NULL;
-		}
-		m_pString = pString;
-	}
+	m_pString[m_Size] = 0;
 	return *this;
 }
 
@@ -214,35 +294,12 @@ CPVRTString& CPVRTString::append(const CPVRTString& _Str, size_t _Off, size_t _C
 *************************************************************************/
 CPVRTString& CPVRTString::append(size_t _Count, char _Ch)
 {
-	char* pString = m_pString;
-	size_t newCapacity = _Count + m_Size + 1;	// +1 for null termination
 	// extend CPVRTString if necessary
-	if (m_Capacity < newCapacity)
-	{
-		pString = (char*)malloc(newCapacity);
-		m_Capacity = newCapacity;
-		memmove(pString, m_pString, m_Size+1);
-	}
+	grow(m_Size + _Count);
 
-	char* newChar = &pString[m_Size];
-	// fill new space with _Ch
-	for(size_t i=0;i<_Count;++i)
-	{
-		*newChar++ = _Ch;
-	}
-	*newChar = '\0';		// set null terminator
-	m_Size+=_Count;			// adjust length of string for new characters
-
-	// remove old CPVRTString if necessary
-	if (pString != m_pString)
-	{
-		if (m_pString)
-		{
-			free(m_pString);
-			m_pString=NULL;
-		}
-		m_pString = pString;
-	}
+	memset(m_pString + m_Size, _Ch, _Count);	// fill new space with _Ch
+	m_Size+=_Count;								// adjust length of string for new characters
+	m_pString[m_Size] = '\0';					// set null terminator
 	return *this;
 }
 
@@ -269,32 +326,17 @@ CPVRTString& CPVRTString::assign(const char* _Ptr)
 @Description		Assigns the string to the string _Ptr
 *************************************************************************/
 CPVRTString& CPVRTString::assign(const char* _Ptr, size_t _Count)
-{	
-	char* pString = m_pString;
+{
+	// _Ptr can only point into this string if it fits the current buffer
 	if (m_Capacity <= _Count)
 	{
-		if (m_pString != NULL)
-		{
-			free(m_pString);
-			m_pString=NULL;
-		}
-		pString = (char*)malloc(_Count + 1);
-		m_Capacity = _Count+1;
+		m_Size = 0;
+		reallocate(_Count + 1);
 	}
 	m_Size = _Count;
 
-	memmove(pString, _Ptr, m_Size);
-	pString[m_Size] = 0;
-
-	if (pString != m_pString)
-	{
-		if (m_pString)
-		{
-			free(m_pString);
-			m_pString=NULL;
-		}
-		m_pString = pString;
-	}
+	memmove(m_pString, _Ptr, m_Size);
+	m_pString[m_Size] = 0;
 	return *this;
 }
 
@@ -337,13 +379,8 @@ CPVRTString& CPVRTString::assign(size_t _Count,char _Ch)
 {
 	if (m_Capacity <= _Count)
 	{
-		if (m_pString)
-		{
-			free(m_pString);
-			m_pString=NULL;
-		}
-		m_pString = (char*)malloc(_Count + 1);
-		m_Capacity = _Count+1;
+		m_Size = 0;
+		reallocate(_Count + 1);
 	}
 	m_Size = _Count;
 	memset(m_pString, _Ch, _Count);
@@ -381,14 +418,9 @@ size_t CPVRTString::capacity() const
 *************************************************************************/
 void CPVRTString::clear()
 {
-	if (m_pString)
-	{
-		free(m_pString);
-		m_pString=NULL;
-	}
-	m_pString = (char*)calloc(1, 1);
+	// Keep the buffer, so that a reserve() still holds
 	m_Size = 0;
-	m_Capacity = 1;
+	m_pString[0] = 0;
 }
 
 /*!***********************************************************************
@@ -1483,8 +1515,7 @@ void CPVRTString::reserve(size_t _Count)
 {
 	if (_Count >= m_Capacity)
 	{
-		m_pString = (char*)realloc(m_pString, _Count + 1);
-		m_Capacity = _Count + 1;
+		reallocate(_Count + 1);
 	}
 }
 
@@ -1541,15 +1572,42 @@ CPVRTString CPVRTString::substr(size_t _Off, size_t _Count) const
 *************************************************************************/
 void CPVRTString::swap(CPVRTString& _Str)
 {
+	if (&_Str == this)
+	{
+		return;
+	}
+
+	// Strings held in the local storage are copied, heap buffers are swapped
+	char aLocal[c_LocalCapacity];
 	size_t Size = _Str.m_Size;
 	size_t Capacity = _Str.m_Capacity;
 	char* pString = _Str.m_pString;
+	if (pString == _Str.m_aLocal)
+	{
+		memcpy(aLocal, _Str.m_aLocal, Size + 1);
+		pString = NULL;
+	}
+
+	if (m_pString == m_aLocal)
+	{
+		memcpy(_Str.m_aLocal, m_aLocal, m_Size + 1);
+		_Str.m_pString = _Str.m_aLocal;
+	}
+	else
+	{
+		_Str.m_pString = m_pString;
+	}
 	_Str.m_Size = m_Size;
 	_Str.m_Capacity = m_Capacity;
-	_Str.m_pString = m_pString;
+
+	if (pString == NULL)
+	{
+		memcpy(m_aLocal, aLocal, Size + 1);
+		pString = m_aLocal;
+	}
+	m_pString = pString;
 	m_Size = Size;
 	m_Capacity = Capacity;
-	m_pString = pString;
 }
 
 /*!***********************************************************************
@@ -1669,6 +1727,29 @@ CPVRTString& CPVRTString::operator=(const CPVRTString& _Right)
 	return assign(_Right);
 }
 
+#ifdef PVRTSTRING_MOVE
+/*!***********************************************************************
+@Function			=
+@Input				_Right A string to move from. Left empty.
+@Returns			An updated string
+@Description		Move assignment. Takes over the buffer of _Right
+					instead of copying it.
+*************************************************************************/
+CPVRTString& CPVRTString::operator=(CPVRTString&& _Right)
+{
+	if (&_Right != this)
+	{
+		if (m_pString != m_aLocal)
+		{
+			free(m_pString);
+			m_pString = m_aLocal;
+		}
+		take(_Right);
+	}
+	return *this;
+}
+#endif
+
 /*!***********************************************************************
 @Function			[]
 @Input				_Off An index into the string
@@ -1700,7 +1781,11 @@ CPVRTString::reference CPVRTString::operator[](size_t _Off)
 *************************************************************************/
 CPVRTString operator+ (const CPVRTString& _Left, const CPVRTString& _Right)
 {
-	return CPVRTString(_Left).append(_Right);
+	CPVRTString strResult;
+	strResult.reserve(_Left.length() + _Right.length());
+	strResult.append(_Left);
+	strResult.append(_Right);
+	return strResult;
 }
 
 /*!***********************************************************************
@@ -1712,7 +1797,11 @@ CPVRTString operator+ (const CPVRTString& _Left, const CPVRTString& _Right)
 *************************************************************************/
 CPVRTString operator+ (const CPVRTString& _Left, const char* _Right)
 {
-	return CPVRTString(_Left).append(_Right);
+	CPVRTString strResult;
+	strResult.reserve(_Left.length() + (_Right ? strlen(_Right) : 0));
+	strResult.append(_Left);
+	strResult.append(_Right);
+	return strResult;
 }
 
 /*!***********************************************************************
@@ -1724,7 +1813,11 @@ CPVRTString operator+ (const CPVRTString& _Left, const char* _Right)
 *************************************************************************/
 CPVRTString operator+ (const CPVRTString& _Left, const char _Right)
 {
-	return CPVRTString(_Left).append(_Right);
+	CPVRTString strResult;
+	strResult.reserve(_Left.length() + 1);
+	strResult.append(_Left);
+	strResult.append(1, _Right);
+	return strResult;
 }
 
 /*!***********************************************************************
@@ -1736,7 +1829,12 @@ CPVRTString operator+ (const CPVRTString& _Left, const char _Right)
 *************************************************************************/
 CPVRTString operator+ (const char* _Left, const CPVRTString& _Right)
 {
-	return CPVRTString(_Left).append(_Right);
+	size_t leftLength = _Left ? strlen(_Left) : 0;
+	CPVRTString strResult;
+	strResult.reserve(leftLength + _Right.length());
+	strResult.append(_Left, leftLength);
+	strResult.append(_Right);
+	return strResult;
 }
 
 /*!***********************************************************************
@@ -1748,7 +1846,11 @@ CPVRTString operator+ (const char* _Left, const CPVRTString& _Right)
 *************************************************************************/
 CPVRTString operator+ (const char _Left, const CPVRTString& _Right)
 {
-	return CPVRTString(_Left).append(_Right);
+	CPVRTString strResult;
+	strResult.reserve(1 + _Right.length());
+	strResult.append(1, _Left);
+	strResult.append(_Right);
+	return strResult;
 }
 
 /*************************************************************************
@@ -21,6 +21,15 @@
 #include <stdio.h>
 #define _USING_PVRTSTRING_
 
+// Move construction and assignment need rvalue references
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+#define PVRTSTRING_MOVE
+#elif defined(__has_feature)
+#if __has_feature(cxx_rvalue_references)
+#define PVRTSTRING_MOVE
+#endif
+#endif
+
 /*!***************************************************************************
 @Class CPVRTString
 @Brief A string class
@@ -84,10 +93,21 @@ public:
 
 	/*!***********************************************************************
 	@Function			CPVRTString
-	@Description		Constructor
+	@Description		Constructor. Does not allocate: short strings are
+						held in storage inside the object.
 	************************************************************************/
 	CPVRTString();
 
+#ifdef PVRTSTRING_MOVE
+	/*!***********************************************************************
+	@Function			CPVRTString
+	@Input				_Right	A string to move from. Left empty.
+	@Description		Move constructor. Takes over the buffer of _Right
+						instead of copying it.
+	************************************************************************/
+	CPVRTString(CPVRTString&& _Right);
+#endif
+
 	/*!***********************************************************************
 	@Function			~CPVRTString
 	@Description		Destructor
@@ -726,7 +746,9 @@ public:
 	/*!***********************************************************************
 	@Function			reserve
 	@Input				_Count Size of string to reserve
-	@Description		Reserves space for _Count number of chars
+	@Description		Reserves space for _Count number of chars. The space
+						is kept until the string outgrows it: clear() and
+						assignments that fit do not release it.
 	*************************************************************************/
 	void reserve(size_t _Count = 0);
 
@@ -836,6 +858,17 @@ public:
 	*************************************************************************/
 	CPVRTString& operator=(const CPVRTString& _Right);
 
+#ifdef PVRTSTRING_MOVE
+	/*!***********************************************************************
+	@Function			=
+	@Input				_Right A string to move from. Left empty.
+	@Returns			An updated string
+	@Description		Move assignment. Takes over the buffer of _Right
+						instead of copying it.
+	*************************************************************************/
+	CPVRTString& operator=(CPVRTString&& _Right);
+#endif
+
 	/*!***********************************************************************
 	@Function			[]
 	@Input				_Off An index into the string
@@ -899,9 +932,43 @@ public:
 	friend CPVRTString operator+ (const char _Left, const CPVRTString& _Right);
 
 protected:
+	// Strings of up to c_LocalCapacity - 1 chars are held in m_aLocal
+	// and need no heap allocation. m_pString always points at the
+	// current buffer, which is m_aLocal or a malloc'd block.
+	enum { c_LocalCapacity = 24 };
+
 	char* m_pString;
 	size_t m_Size;
-	size_t m_Capacity;
+	size_t m_Capacity;		// Size of the buffer, including the null terminator
+	char m_aLocal[c_LocalCapacity];
+
+private:
+	/*!***********************************************************************
+	@Function			grow
+	@Input				_Count	Number of chars the string must hold
+	@Description		Makes room for _Count chars plus the null terminator,
+						keeping the contents. The buffer at least doubles in
+						size, so a sequence of appends takes amortized
+						constant time per char.
+	*************************************************************************/
+	void grow(size_t _Count);
+
+	/*!***********************************************************************
+	@Function			reallocate
+	@Input				_Capacity	New buffer size, including the null terminator
+	@Description		Moves the contents to a heap buffer of _Capacity bytes.
+	*************************************************************************/
+	void reallocate(size_t _Capacity);
+
+#ifdef PVRTSTRING_MOVE
+	/*!***********************************************************************
+	@Function			take
+	@Input				_Right	A string to move from
+	@Description		Takes the contents of _Right and leaves it empty.
+						This string must not own a heap buffer.
+	*************************************************************************/
+	void take(CPVRTString& _Right);
+#endif
 };
 
 /*************************************************************************
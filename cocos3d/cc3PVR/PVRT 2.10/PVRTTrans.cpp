@@ -20,6 +20,7 @@
 #include "PVRTFixedPoint.h"
 #include "PVRTMatrix.h"
 #include "PVRTTrans.h"
+#include "PVRTSimd.h"
 
 /****************************************************************************
 ** Functions
@@ -293,6 +294,206 @@ bool PVRTBoundingBoxIsVisible(
 	}
 }
 
+/* Number of boxes PVRTBoundingBoxArrayIsVisible converts to SoA form at a time */
+#define PVRT_CULL_BATCH	(32)
+
+/*!***************************************************************************
+ @Struct			SPVRTCullPlanes
+ @Brief				The five planes tested by PVRTBoundingBoxIsVisible
+					(-w <= x <= w, -w <= y <= w, z >= 0) in object space, with
+					the absolute values of their normals for the extent term.
+*****************************************************************************/
+struct SPVRTCullPlanes
+{
+	VERTTYPE	a[5], b[5], c[5], d[5];
+	VERTTYPE	fAbsA[5], fAbsB[5], fAbsC[5];
+};
+
+/*!***************************************************************************
+ @Function			PVRTCullPlanesExtract
+ @Output			sPlanes
+ @Input				pMatrix		World, View & Projection matrices combined
+ @Description		Extracts the clip planes from the columns of pMatrix.
+*****************************************************************************/
+static void PVRTCullPlanesExtract(
+	SPVRTCullPlanes		&sPlanes,
+	const PVRTMATRIX	* const pMatrix)
+{
+	const VERTTYPE	*pf = pMatrix->f;
+	int				i;
+
+	/* w + x, w - x, w + y, w - y */
+	for(i = 0; i < 2; ++i)
+	{
+		sPlanes.a[i*2]   = pf[ 3] + pf[i];		sPlanes.a[i*2+1] = pf[ 3] - pf[i];
+		sPlanes.b[i*2]   = pf[ 7] + pf[4+i];	sPlanes.b[i*2+1] = pf[ 7] - pf[4+i];
+		sPlanes.c[i*2]   = pf[11] + pf[8+i];	sPlanes.c[i*2+1] = pf[11] - pf[8+i];
+		sPlanes.d[i*2]   = pf[15] + pf[12+i];	sPlanes.d[i*2+1] = pf[15] - pf[12+i];
+	}
+
+	/* z */
+	sPlanes.a[4] = pf[ 2];
+	sPlanes.b[4] = pf[ 6];
+	sPlanes.c[4] = pf[10];
+	sPlanes.d[4] = pf[14];
+
+	for(i = 0; i < 5; ++i)
+	{
+		sPlanes.fAbsA[i] = PVRTABS(sPlanes.a[i]);
+		sPlanes.fAbsB[i] = PVRTABS(sPlanes.b[i]);
+		sPlanes.fAbsC[i] = PVRTABS(sPlanes.c[i]);
+	}
+}
+
+/*!***************************************************************************
+ @Function			PVRTCullPlanesTest
+ @Input				sPlanes
+ @Input				pBoxes
+ @Input				i		Index of the box to test
+ @Return			true if the box is not wholly outside any of the planes
+ @Description		A box is outside a plane if its corner furthest along the
+					plane normal is; the distance of that corner is the
+					distance of the centre plus the extents projected onto the
+					absolute normal.
+*****************************************************************************/
+static bool PVRTCullPlanesTest(
+	const SPVRTCullPlanes		&sPlanes,
+	const PVRTBOUNDINGBOXSOA	* const pBoxes,
+	const int					i)
+{
+	for(int nPlane = 0; nPlane < 5; ++nPlane)
+	{
+		VERTTYPE fDist;
+
+		fDist =	VERTTYPEMUL(sPlanes.a[nPlane], pBoxes->pfCentreX[i]) +
+				VERTTYPEMUL(sPlanes.b[nPlane], pBoxes->pfCentreY[i]) +
+				VERTTYPEMUL(sPlanes.c[nPlane], pBoxes->pfCentreZ[i]) +
+				sPlanes.d[nPlane];
+		fDist +=	VERTTYPEMUL(sPlanes.fAbsA[nPlane], pBoxes->pfExtentX[i]) +
+					VERTTYPEMUL(sPlanes.fAbsB[nPlane], pBoxes->pfExtentY[i]) +
+					VERTTYPEMUL(sPlanes.fAbsC[nPlane], pBoxes->pfExtentZ[i]);
+
+		/* Written so that NaN distances cull, as in the SIMD path */
+		if(!(fDist >= 0))
+			return false;
+	}
+
+	return true;
+}
+
+/*!***************************************************************************
+ @Function			PVRTBoundingBoxArrayIsVisible
+ @Output			pu32Visible			Visibility bitmask; needs (nNumberOfBoxes+31)/32 words
+ @Input				pBoundingBoxes		Array of bounding boxes
+ @Input				nNumberOfBoxes		Number of bounding boxes
+ @Input				pMatrix				World, View & Projection matrices combined
+ @Description		Determine which of a number of bounding boxes are "visible".
+					Bit (i & 31) of pu32Visible[i >> 5] is set if box i is
+					visible, using the same test as PVRTBoundingBoxIsVisible.
+					The boxes must be axis aligned, as built by
+					PVRTBoundingBoxCompute; only Point[0] and Point[7] are read.
+*****************************************************************************/
+void PVRTBoundingBoxArrayIsVisible(
+	PVRTuint32				* const pu32Visible,
+	const PVRTBOUNDINGBOX	* const pBoundingBoxes,
+	const int				nNumberOfBoxes,
+	const PVRTMATRIX		* const pMatrix)
+{
+	VERTTYPE			fCentre[3][PVRT_CULL_BATCH], fExtent[3][PVRT_CULL_BATCH];
+	PVRTBOUNDINGBOXSOA	sBoxes;
+	int					i, j, nCount;
+
+	sBoxes.pfCentreX = fCentre[0];	sBoxes.pfExtentX = fExtent[0];
+	sBoxes.pfCentreY = fCentre[1];	sBoxes.pfExtentY = fExtent[1];
+	sBoxes.pfCentreZ = fCentre[2];	sBoxes.pfExtentZ = fExtent[2];
+
+	/* Convert a batch at a time; PVRT_CULL_BATCH is a multiple of 32 so each
+	   batch fills whole words of the bitmask */
+	for(i = 0; i < nNumberOfBoxes; i += PVRT_CULL_BATCH)
+	{
+		nCount = PVRT_MIN(PVRT_CULL_BATCH, nNumberOfBoxes - i);
+
+		for(j = 0; j < nCount; ++j)
+		{
+			const PVRTVECTOR3 &vMin = pBoundingBoxes[i+j].Point[0];
+			const PVRTVECTOR3 &vMax = pBoundingBoxes[i+j].Point[7];
+
+			fCentre[0][j] = VERTTYPEDIV(vMax.x + vMin.x, f2vt(2.0f));
+			fCentre[1][j] = VERTTYPEDIV(vMax.y + vMin.y, f2vt(2.0f));
+			fCentre[2][j] = VERTTYPEDIV(vMax.z + vMin.z, f2vt(2.0f));
+			fExtent[0][j] = VERTTYPEDIV(vMax.x - vMin.x, f2vt(2.0f));
+			fExtent[1][j] = VERTTYPEDIV(vMax.y - vMin.y, f2vt(2.0f));
+			fExtent[2][j] = VERTTYPEDIV(vMax.z - vMin.z, f2vt(2.0f));
+		}
+
+		PVRTBoundingBoxSoAIsVisible(&pu32Visible[i >> 5], &sBoxes, nCount, pMatrix);
+	}
+}
+
+/*!***************************************************************************
+ @Function			PVRTBoundingBoxSoAIsVisible
+ @Output			pu32Visible			Visibility bitmask; needs (nNumberOfBoxes+31)/32 words
+ @Input				pBoxes				Centres and half extents of the boxes
+ @Input				nNumberOfBoxes		Number of boxes
+ @Input				pMatrix				World, View & Projection matrices combined
+ @Description		As PVRTBoundingBoxArrayIsVisible, for boxes already in
+					structure of arrays form. Four boxes are tested at a time
+					where SIMD is available.
+*****************************************************************************/
+void PVRTBoundingBoxSoAIsVisible(
+	PVRTuint32					* const pu32Visible,
+	const PVRTBOUNDINGBOXSOA	* const pBoxes,
+	const int					nNumberOfBoxes,
+	const PVRTMATRIX			* const pMatrix)
+{
+	SPVRTCullPlanes	sPlanes;
+	int				i, nEnd;
+
+	PVRTCullPlanesExtract(sPlanes, pMatrix);
+
+	for(int nWord = 0; nWord * 32 < nNumberOfBoxes; ++nWord)
+	{
+		PVRTuint32 u32Bits = 0;
+
+		i = nWord * 32;
+		nEnd = PVRT_MIN(i + 32, nNumberOfBoxes);
+
+#ifdef PVRT_SIMD
+		for(; i + 4 <= nEnd; i += 4)
+		{
+			const PVRTSIMDVEC vCX = PVRTSimdLoad(&pBoxes->pfCentreX[i]);
+			const PVRTSIMDVEC vCY = PVRTSimdLoad(&pBoxes->pfCentreY[i]);
+			const PVRTSIMDVEC vCZ = PVRTSimdLoad(&pBoxes->pfCentreZ[i]);
+			const PVRTSIMDVEC vEX = PVRTSimdLoad(&pBoxes->pfExtentX[i]);
+			const PVRTSIMDVEC vEY = PVRTSimdLoad(&pBoxes->pfExtentY[i]);
+			const PVRTSIMDVEC vEZ = PVRTSimdLoad(&pBoxes->pfExtentZ[i]);
+			unsigned int u32Lanes = 0xF;
+
+			for(int nPlane = 0; nPlane < 5 && u32Lanes; ++nPlane)
+			{
+				PVRTSIMDVEC vDist, vRadius;
+
+				vDist = PVRTSimdAdd(PVRTSimdScale(vCX, sPlanes.a[nPlane]), PVRTSimdScale(vCY, sPlanes.b[nPlane]));
+				vDist = PVRTSimdAdd(PVRTSimdAdd(vDist, PVRTSimdScale(vCZ, sPlanes.c[nPlane])), PVRTSimdSplat(sPlanes.d[nPlane]));
+				vRadius = PVRTSimdAdd(PVRTSimdScale(vEX, sPlanes.fAbsA[nPlane]), PVRTSimdScale(vEY, sPlanes.fAbsB[nPlane]));
+				vRadius = PVRTSimdAdd(vRadius, PVRTSimdScale(vEZ, sPlanes.fAbsC[nPlane]));
+
+				u32Lanes &= PVRTSimdNonNegativeMask(PVRTSimdAdd(vDist, vRadius));
+			}
+
+			u32Bits |= (PVRTuint32) u32Lanes << (i & 31);
+		}
+#endif
+		for(; i < nEnd; ++i)
+		{
+			if(PVRTCullPlanesTest(sPlanes, pBoxes, i))
+				u32Bits |= 1u << (i & 31);
+		}
+
+		pu32Visible[nWord] = u32Bits;
+	}
+}
+
 /*!***************************************************************************
  @Function Name		PVRTTransformVec3Array
  @Output			pOut				Destination for transformed vectors
@@ -319,6 +520,24 @@ void PVRTTransformVec3Array(
 	pSrc = pV;
 	pDst = pOut;
 
+#ifdef PVRT_SIMD
+	const PVRTSIMDVEC vRow0 = PVRTSimdLoad(&pMatrix->f[ 0]);
+	const PVRTSIMDVEC vRow1 = PVRTSimdLoad(&pMatrix->f[ 4]);
+	const PVRTSIMDVEC vRow2 = PVRTSimdLoad(&pMatrix->f[ 8]);
+	const PVRTSIMDVEC vRow3 = PVRTSimdLoad(&pMatrix->f[12]);
+
+	for (i=0; i<nNumberOfVertices; ++i)
+	{
+		PVRTSIMDVEC v;
+
+		v = PVRTSimdAdd(PVRTSimdScale(vRow0, pSrc->x), PVRTSimdScale(vRow1, pSrc->y));
+		v = PVRTSimdAdd(PVRTSimdAdd(v, PVRTSimdScale(vRow2, pSrc->z)), vRow3);
+		PVRTSimdStore(&pDst->x, v);
+
+		pDst = (PVRTVECTOR4*)((char*)pDst + nOutStride);
+		pSrc = (PVRTVECTOR3*)((char*)pSrc + nInStride);
+	}
+#else
 	/* Transform all vertices with *pMatrix */
 	for (i=0; i<nNumberOfVertices; ++i)
 	{
@@ -342,6 +561,7 @@ void PVRTTransformVec3Array(
 		pDst = (PVRTVECTOR4*)((char*)pDst + nOutStride);
 		pSrc = (PVRTVECTOR3*)((char*)pSrc + nInStride);
 	}
+#endif
 }
 
 /*!***************************************************************************
@@ -367,22 +587,49 @@ void PVRTTransformArray(
 {
 	int			i;
 
+#ifdef PVRT_SIMD
+	const PVRTSIMDVEC vRow0 = PVRTSimdLoad(&pMatrix->f[ 0]);
+	const PVRTSIMDVEC vRow1 = PVRTSimdLoad(&pMatrix->f[ 4]);
+	const PVRTSIMDVEC vRow2 = PVRTSimdLoad(&pMatrix->f[ 8]);
+	const PVRTSIMDVEC vRow3 = PVRTSimdScale(PVRTSimdLoad(&pMatrix->f[12]), fW);
+	float fOut[4];
+
+	for (i=0; i<nNumberOfVertices; ++i)
+	{
+		PVRTSIMDVEC v;
+
+		v = PVRTSimdAdd(PVRTSimdScale(vRow0, pV[i].x), PVRTSimdScale(vRow1, pV[i].y));
+		v = PVRTSimdAdd(PVRTSimdAdd(v, PVRTSimdScale(vRow2, pV[i].z)), vRow3);
+
+		/* Stored via fOut, as a 4 float store would overwrite the next input
+		   when transforming in place */
+		PVRTSimdStore(fOut, v);
+		pTransformedVertex[i].x = fOut[0];
+		pTransformedVertex[i].y = fOut[1];
+		pTransformedVertex[i].z = fOut[2];
+	}
+#else
 	/* Transform all vertices with *pMatrix */
 	for (i=0; i<nNumberOfVertices; ++i)
 	{
-		pTransformedVertex[i].x =	VERTTYPEMUL(pMatrix->f[ 0], pV[i].x) +
-									VERTTYPEMUL(pMatrix->f[ 4], pV[i].y) +
-									VERTTYPEMUL(pMatrix->f[ 8], pV[i].z) +
+		/* Read the whole vertex first, as it is overwritten when
+		   transforming in place */
+		const PVRTVECTOR3 vIn = pV[i];
+
+		pTransformedVertex[i].x =	VERTTYPEMUL(pMatrix->f[ 0], vIn.x) +
+									VERTTYPEMUL(pMatrix->f[ 4], vIn.y) +
+									VERTTYPEMUL(pMatrix->f[ 8], vIn.z) +
 									VERTTYPEMUL(pMatrix->f[12], fW);
-		pTransformedVertex[i].y =	VERTTYPEMUL(pMatrix->f[ 1], pV[i].x) +
-									VERTTYPEMUL(pMatrix->f[ 5], pV[i].y) +
-									VERTTYPEMUL(pMatrix->f[ 9], pV[i].z) +
+		pTransformedVertex[i].y =	VERTTYPEMUL(pMatrix->f[ 1], vIn.x) +
+									VERTTYPEMUL(pMatrix->f[ 5], vIn.y) +
+									VERTTYPEMUL(pMatrix->f[ 9], vIn.z) +
 									VERTTYPEMUL(pMatrix->f[13], fW);
-		pTransformedVertex[i].z =	VERTTYPEMUL(pMatrix->f[ 2], pV[i].x) +
-									VERTTYPEMUL(pMatrix->f[ 6], pV[i].y) +
-									VERTTYPEMUL(pMatrix->f[10], pV[i].z) +
+		pTransformedVertex[i].z =	VERTTYPEMUL(pMatrix->f[ 2], vIn.x) +
+									VERTTYPEMUL(pMatrix->f[ 6], vIn.y) +
+									VERTTYPEMUL(pMatrix->f[10], vIn.z) +
 									VERTTYPEMUL(pMatrix->f[14], fW);
 	}
+#endif
 }
 
 /*!***************************************************************************
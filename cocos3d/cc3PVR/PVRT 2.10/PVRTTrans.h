@@ -25,6 +25,17 @@ typedef struct PVRTBOUNDINGBOX_TAG
 	PVRTVECTOR3	Point[8];
 } PVRTBOUNDINGBOX, *LPPVRTBOUNDINGBOX;
 
+/*!***************************************************************************
+ @Struct			PVRTBOUNDINGBOXSOA
+ @Brief				Axis aligned boxes stored as separate arrays of centres and
+					half extents, one value per box in each array.
+*****************************************************************************/
+typedef struct PVRTBOUNDINGBOXSOA_TAG
+{
+	const VERTTYPE	*pfCentreX, *pfCentreY, *pfCentreZ;
+	const VERTTYPE	*pfExtentX, *pfExtentY, *pfExtentZ;
+} PVRTBOUNDINGBOXSOA;
+
 /****************************************************************************
 ** Functions
 ****************************************************************************/
@@ -91,6 +102,40 @@ bool PVRTBoundingBoxIsVisible(
 	const PVRTMATRIX		* const pMatrix,
 	bool					* const pNeedsZClipping);
 
+/*!***************************************************************************
+ @Function			PVRTBoundingBoxArrayIsVisible
+ @Output			pu32Visible			Visibility bitmask; needs (nNumberOfBoxes+31)/32 words
+ @Input				pBoundingBoxes		Array of bounding boxes
+ @Input				nNumberOfBoxes		Number of bounding boxes
+ @Input				pMatrix				World, View & Projection matrices combined
+ @Description		Determine which of a number of bounding boxes are "visible".
+					Bit (i & 31) of pu32Visible[i >> 5] is set if box i is
+					visible, using the same test as PVRTBoundingBoxIsVisible.
+					The boxes must be axis aligned, as built by
+					PVRTBoundingBoxCompute; only Point[0] and Point[7] are read.
+*****************************************************************************/
+void PVRTBoundingBoxArrayIsVisible(
+	PVRTuint32				* const pu32Visible,
+	const PVRTBOUNDINGBOX	* const pBoundingBoxes,
+	const int				nNumberOfBoxes,
+	const PVRTMATRIX		* const pMatrix);
+
+/*!***************************************************************************
+ @Function			PVRTBoundingBoxSoAIsVisible
+ @Output			pu32Visible			Visibility bitmask; needs (nNumberOfBoxes+31)/32 words
+ @Input				pBoxes				Centres and half extents of the boxes
+ @Input				nNumberOfBoxes		Number of boxes
+ @Input				pMatrix				World, View & Projection matrices combined
+ @Description		As PVRTBoundingBoxArrayIsVisible, for boxes already in
+					structure of arrays form. Four boxes are tested at a time
+					where SIMD is available.
+*****************************************************************************/
+void PVRTBoundingBoxSoAIsVisible(
+	PVRTuint32					* const pu32Visible,
+	const PVRTBOUNDINGBOXSOA	* const pBoxes,
+	const int					nNumberOfBoxes,
+	const PVRTMATRIX			* const pMatrix);
+
 /*!***************************************************************************
  @Function Name		PVRTTransformVec3Array
  @Output			pOut				Destination for transformed vectors
@@ -15,6 +15,7 @@
 ******************************************************************************/
 
 #include "PVRTVector.h"
+#include "PVRTSimd.h"
 
 #include <math.h>
 
@@ -226,6 +227,18 @@
 	PVRTMat4 PVRTMat4::operator*(const PVRTMat4& rhs) const
 	{
 		PVRTMat4 out;
+#ifdef PVRT_SIMD
+		// each column of out is a weighted sum of the columns of this matrix
+		const PVRTSIMDVEC vCol0 = PVRTSimdLoad(&f[0]);
+		const PVRTSIMDVEC vCol1 = PVRTSimdLoad(&f[4]);
+		const PVRTSIMDVEC vCol2 = PVRTSimdLoad(&f[8]);
+		const PVRTSIMDVEC vCol3 = PVRTSimdLoad(&f[12]);
+
+		PVRTSimdStore(&out.f[0], PVRTSimdCombine(vCol0, vCol1, vCol2, vCol3, &rhs.f[0]));
+		PVRTSimdStore(&out.f[4], PVRTSimdCombine(vCol0, vCol1, vCol2, vCol3, &rhs.f[4]));
+		PVRTSimdStore(&out.f[8], PVRTSimdCombine(vCol0, vCol1, vCol2, vCol3, &rhs.f[8]));
+		PVRTSimdStore(&out.f[12], PVRTSimdCombine(vCol0, vCol1, vCol2, vCol3, &rhs.f[12]));
+#else
 		// col 1
 		out.f[0] =	VERTTYPEMUL(f[0],rhs.f[0])+VERTTYPEMUL(f[4],rhs.f[1])+VERTTYPEMUL(f[8],rhs.f[2])+VERTTYPEMUL(f[12],rhs.f[3]);
 		out.f[1] =	VERTTYPEMUL(f[1],rhs.f[0])+VERTTYPEMUL(f[5],rhs.f[1])+VERTTYPEMUL(f[9],rhs.f[2])+VERTTYPEMUL(f[13],rhs.f[3]);
@@ -249,6 +262,7 @@
 		out.f[13] =	VERTTYPEMUL(f[1],rhs.f[12])+VERTTYPEMUL(f[5],rhs.f[13])+VERTTYPEMUL(f[9],rhs.f[14])+VERTTYPEMUL(f[13],rhs.f[15]);
 		out.f[14] =	VERTTYPEMUL(f[2],rhs.f[12])+VERTTYPEMUL(f[6],rhs.f[13])+VERTTYPEMUL(f[10],rhs.f[14])+VERTTYPEMUL(f[14],rhs.f[15]);
 		out.f[15] =	VERTTYPEMUL(f[3],rhs.f[12])+VERTTYPEMUL(f[7],rhs.f[13])+VERTTYPEMUL(f[11],rhs.f[14])+VERTTYPEMUL(f[15],rhs.f[15]);
+#endif
 		return out;
 	}
 
@@ -26,20 +26,55 @@
 #include "PVRTFixedPoint.h"
 #include "PVRTMatrix.h"
 #include "PVRTVertex.h"
+#include "PVRTParallel.h"
 
 /****************************************************************************
 ** Defines
 ****************************************************************************/
+/* Number of triangles handled by each per-triangle job of PVRTVertexGenerateTangentSpace */
+#define PVRT_TANGENT_JOB_TRIS	(4096)
+
+/* Number of vertices handled by each per-vertex job of PVRTVertexGenerateTangentSpace */
+#define PVRT_TANGENT_JOB_VERTS	(4096)
+
+/* Meshes with fewer triangles than this are done on the calling thread */
+#define PVRT_TANGENT_PARALLEL_MIN_TRIS	(2 * PVRT_TANGENT_JOB_TRIS)
 
 /****************************************************************************
 ** Macros
 ****************************************************************************/
-#define MAX_VERTEX_OUT (3*nVtxNum)
 
 /****************************************************************************
 ** Structures
 ****************************************************************************/
 
+/*!***************************************************************************
+ @Struct			SPVRTTangentJob
+ @Brief				Data shared by the jobs of PVRTVertexGenerateTangentSpace
+*****************************************************************************/
+struct SPVRTTangentJob
+{
+	const char			*pVtx;
+	unsigned int		nStride;
+	unsigned int		nOffsetPos, nOffsetNor, nOffsetTex, nOffsetTan, nOffsetBin;
+	EPVRTDataType		eTypePos, eTypeNor, eTypeTex, eTypeTan, eTypeBin;
+	const unsigned int	*pui32Idx;
+	unsigned int		nTriNum;
+	unsigned int		nVtxNum;
+	float				fSplitDifference;
+	PVRTVECTOR3f		*pvTan;		// Tangent wanted at each triangle corner (3*triangle+corner)
+	PVRTVECTOR3f		*pvBin;		// Bitangent wanted at each triangle corner
+	const unsigned int	*pnVtxOffset;	// The corners using vertex n are pnVtxCorner[pnVtxOffset[n]] to pnVtxCorner[pnVtxOffset[n+1]-1]
+	const unsigned int	*pnVtxCorner;	// Triangle corners (3*triangle+corner) grouped by vertex, in triangle order
+	unsigned int		*pnCorner;		// Tangent space chosen for each entry of pnVtxCorner, numbered per vertex
+	unsigned int		*pnVtxOut;		// Number of tangent spaces of each vertex, then the first output vertex of each
+	const unsigned int	*pnJobScratch;	// Start of each per-vertex job's scratch, which is sized for its most shared vertex
+	unsigned int		*pnFirst, *pnLast, *pnNext;	// Members of each tangent space of a vertex, as lists of indices into its run
+	PVRTVECTOR3f		*pvTanSum, *pvBinSum;		// Summed tangent space of each tangent space of a vertex
+	unsigned int		*pui32IdxNew;	// New index array
+	char				*pVtxOut;		// Output vertices
+};
+
 /****************************************************************************
 ** Constants
 ****************************************************************************/
@@ -48,6 +83,165 @@
 ** Local function definitions
 ****************************************************************************/
 
+/*!***************************************************************************
+ @Function			PVRTVertexTangentJob
+ @Input				pUserData		The SPVRTTangentJob
+ @Input				ui32Job			Job index; selects a range of triangles
+ @Description		Calculates the tangent space each triangle in the range
+					wants at each of its corners.
+*****************************************************************************/
+static void PVRTVertexTangentJob(void *pUserData, const unsigned int ui32Job)
+{
+	const SPVRTTangentJob &sJob = *(const SPVRTTangentJob*) pUserData;
+	float			pfPos[3][4], pfNor[3][4], pfTex[3][4];
+	unsigned int	nTri, nEnd, i;
+
+	nTri = ui32Job * PVRT_TANGENT_JOB_TRIS;
+	nEnd = PVRT_MIN(nTri + PVRT_TANGENT_JOB_TRIS, sJob.nTriNum);
+
+	for(; nTri < nEnd; ++nTri)
+	{
+		for(i = 0; i < 3; ++i)
+		{
+			const char *pV = &sJob.pVtx[sJob.pui32Idx[3*nTri+i] * sJob.nStride];
+
+			PVRTVertexRead((PVRTVECTOR4f*) &pfPos[i][0], pV + sJob.nOffsetPos, sJob.eTypePos, 3);
+			PVRTVertexRead((PVRTVECTOR4f*) &pfNor[i][0], pV + sJob.nOffsetNor, sJob.eTypeNor, 3);
+			PVRTVertexRead((PVRTVECTOR4f*) &pfTex[i][0], pV + sJob.nOffsetTex, sJob.eTypeTex, 3);
+		}
+
+		for(i = 0; i < 3; ++i)
+		{
+			PVRTVertexTangentBitangent(
+				&sJob.pvTan[3*nTri+i],
+				&sJob.pvBin[3*nTri+i],
+				(PVRTVECTOR3f*) &pfNor[i][0],
+				pfPos[i], pfPos[(i+1)%3], pfPos[(i+2)%3],
+				pfTex[i], pfTex[(i+1)%3], pfTex[(i+2)%3]);
+		}
+	}
+}
+
+/*!***************************************************************************
+ @Function			PVRTVertexTangentGroupJob
+ @Input				pUserData		The SPVRTTangentJob
+ @Input				ui32Job			Job index; selects a range of vertices
+ @Description		Groups the tangent spaces wanted at each vertex in the
+					range. A corner joins the first group whose members it
+					all matches, otherwise it starts a new group.
+*****************************************************************************/
+static void PVRTVertexTangentGroupJob(void *pUserData, const unsigned int ui32Job)
+{
+	const SPVRTTangentJob &sJob = *(const SPVRTTangentJob*) pUserData;
+	const unsigned int cnListEnd = 0xFFFFFFFF;
+	unsigned int * const pnFirst	= &sJob.pnFirst[sJob.pnJobScratch[ui32Job]];
+	unsigned int * const pnLast		= &sJob.pnLast[sJob.pnJobScratch[ui32Job]];
+	unsigned int * const pnNext		= &sJob.pnNext[sJob.pnJobScratch[ui32Job]];
+	unsigned int	nVert, nVertEnd, nCurr, nBase, nEnd, nSpaces, i, j;
+
+	nVert		= ui32Job * PVRT_TANGENT_JOB_VERTS;
+	nVertEnd	= PVRT_MIN(nVert + PVRT_TANGENT_JOB_VERTS, sJob.nVtxNum);
+
+	for(; nVert < nVertEnd; ++nVert) {
+		nBase	= sJob.pnVtxOffset[nVert];
+		nEnd	= sJob.pnVtxOffset[nVert+1];
+		nSpaces	= 0;
+
+		for(nCurr = nBase; nCurr < nEnd; ++nCurr) {
+			const PVRTVECTOR3f &vTan = sJob.pvTan[sJob.pnVtxCorner[nCurr]];
+			const PVRTVECTOR3f &vBin = sJob.pvBin[sJob.pnVtxCorner[nCurr]];
+
+			for(i = 0; i < nSpaces; ++i) {
+				// Check all the shared vertices which match
+				for(j = pnFirst[i]; j != cnListEnd; j = pnNext[j]) {
+					if(PVRTMatrixVec3DotProductF(vTan, sJob.pvTan[sJob.pnVtxCorner[nBase + j]]) < sJob.fSplitDifference)
+						break;
+					if(PVRTMatrixVec3DotProductF(vBin, sJob.pvBin[sJob.pnVtxCorner[nBase + j]]) < sJob.fSplitDifference)
+						break;
+				}
+
+				// Did all the existing members match?
+				if(j == cnListEnd)
+					break;
+			}
+
+			// Append to the matching tangent space, or start a new one
+			j = nCurr - nBase;
+			pnNext[j] = cnListEnd;
+			if(i == nSpaces)
+				pnFirst[nSpaces++] = j;
+			else
+				pnNext[pnLast[i]] = j;
+			pnLast[i] = j;
+			sJob.pnCorner[nCurr] = i;
+		}
+
+		_ASSERT(nSpaces >= 1);
+		sJob.pnVtxOut[nVert] = nSpaces;
+	}
+}
+
+/*!***************************************************************************
+ @Function			PVRTVertexTangentOutputJob
+ @Input				pUserData		The SPVRTTangentJob
+ @Input				ui32Job			Job index; selects a range of vertices
+ @Description		Writes one output vertex per tangent space of each vertex
+					in the range, and points the triangle corners at them.
+*****************************************************************************/
+static void PVRTVertexTangentOutputJob(void *pUserData, const unsigned int ui32Job)
+{
+	const SPVRTTangentJob &sJob = *(const SPVRTTangentJob*) pUserData;
+	PVRTVECTOR3f * const pvTanSum	= &sJob.pvTanSum[sJob.pnJobScratch[ui32Job]];
+	PVRTVECTOR3f * const pvBinSum	= &sJob.pvBinSum[sJob.pnJobScratch[ui32Job]];
+	unsigned int	nVert, nVertEnd, nCurr, nEnd, nOut, nSpaces, i;
+
+	nVert		= ui32Job * PVRT_TANGENT_JOB_VERTS;
+	nVertEnd	= PVRT_MIN(nVert + PVRT_TANGENT_JOB_VERTS, sJob.nVtxNum);
+
+	for(; nVert < nVertEnd; ++nVert) {
+		nEnd	= sJob.pnVtxOffset[nVert+1];
+		nOut	= sJob.pnVtxOut[nVert];
+		nSpaces	= 0;
+
+		// Sum the tangents & bitangents, so we can average them
+		for(nCurr = sJob.pnVtxOffset[nVert]; nCurr < nEnd; ++nCurr) {
+			const PVRTVECTOR3f &vTan = sJob.pvTan[sJob.pnVtxCorner[nCurr]];
+			const PVRTVECTOR3f &vBin = sJob.pvBin[sJob.pnVtxCorner[nCurr]];
+
+			i = sJob.pnCorner[nCurr];
+			if(i == nSpaces) {
+				memset(&pvTanSum[i], 0, sizeof(*pvTanSum));
+				memset(&pvBinSum[i], 0, sizeof(*pvBinSum));
+				++nSpaces;
+			}
+
+			pvTanSum[i].x += vTan.x;
+			pvTanSum[i].y += vTan.y;
+			pvTanSum[i].z += vTan.z;
+
+			pvBinSum[i].x += vBin.x;
+			pvBinSum[i].y += vBin.y;
+			pvBinSum[i].z += vBin.z;
+
+			// Update triangle indices to use this vtx
+			sJob.pui32IdxNew[sJob.pnVtxCorner[nCurr]] = nOut + i;
+		}
+
+		for(i = 0; i < nSpaces; ++i) {
+			float pfTan[4], pfBin[4];
+			char *pOut = &sJob.pVtxOut[(nOut + i) * sJob.nStride];
+
+			PVRTMatrixVec3NormalizeF(*(PVRTVECTOR3f*) &pfTan[0], pvTanSum[i]);
+			PVRTMatrixVec3NormalizeF(*(PVRTVECTOR3f*) &pfBin[0], pvBinSum[i]);
+			pfTan[3] = pfBin[3] = 0;
+
+			memcpy(pOut, &sJob.pVtx[nVert*sJob.nStride], sJob.nStride);
+			PVRTVertexWrite(pOut + sJob.nOffsetTan, sJob.eTypeTan, 3, (PVRTVECTOR4f*) &pfTan[0]);
+			PVRTVertexWrite(pOut + sJob.nOffsetBin, sJob.eTypeBin, 3, (PVRTVECTOR4f*) &pfBin[0]);
+		}
+	}
+}
+
 /*****************************************************************************
 ** Functions
 *****************************************************************************/
@@ -549,6 +743,9 @@ void PVRTVertexTangentBitangent(
  @Input				eTypeBin			Data type of the bitangent
  @Input				nTriNum				Number of triangles
  @Input				fSplitDifference	Split a vertex if the DP3 of tangents/bitangents are below this (range -1..1)
+ @Input				ui32MaxThreads		Threads to spread the work over; 0 uses all processors,
+										1 (the default) runs on the calling thread. Meshes of
+										fewer than 8192 triangles always run on the calling thread
  @Return			PVR_FAIL if there was a problem.
  @Description		Calculates the tangent space for all supplied vertices.
 					Writes tangent and bitangent vectors to the output
@@ -559,6 +756,10 @@ void PVRTVertexTangentBitangent(
 					uses fSplitDifference - of the DP3 of two desired
 					tangents or two desired bitangents is higher than this,
 					the vertex will be split.
+					There is no limit on the number of triangles sharing a
+					vertex; the triangles using each vertex are gathered into
+					one compact list so the time taken is linear in the size
+					of the mesh.
 *****************************************************************************/
 EPVRTError PVRTVertexGenerateTangentSpace(
 	unsigned int	* const pnVtxNumOut,
@@ -578,47 +779,44 @@ EPVRTError PVRTVertexGenerateTangentSpace(
 	const unsigned int	nOffsetBin,
 	EPVRTDataType	eTypeBin,
 	const unsigned int	nTriNum,
-	const float		fSplitDifference)
+	const float		fSplitDifference,
+	const unsigned int	ui32MaxThreads)
 {
-	const int cnMaxSharedVtx = 32;
-	struct SVtxData
-	{
-		int				n;							// Number of items in following arrays, AKA number of tris using this vtx
-		PVRTVECTOR3f	pvTan[cnMaxSharedVtx];		// Tangent (one per triangle referencing this vtx)
-		PVRTVECTOR3f	pvBin[cnMaxSharedVtx];		// Bitangent (one per triangle referencing this vtx)
-		int				pnTri[cnMaxSharedVtx];		// Triangle index (one per triangle referencing this vtx)
-	};
-	SVtxData		*psVtxData;		// Array of desired tangent spaces per vertex
-	SVtxData		*psTSpass;		// Array of *different* tangent spaces desired for current vertex
-	unsigned int	nTSpassLen;
-	SVtxData		*psVtx, *psCmp;
-	unsigned int	nVert, nCurr, i, j;	// Loop counters
+	SPVRTTangentJob	sJob;
+	unsigned int	*pnVtxOffset;	// The corners using vertex n are pnVtxCorner[pnVtxOffset[n]] to pnVtxCorner[pnVtxOffset[n+1]-1]
+	unsigned int	*pnVtxCorner;	// Triangle corners (3*triangle+corner) grouped by vertex, in triangle order
+	unsigned int	*pnJobScratch;	// Start of each per-vertex job's scratch
+	unsigned int	nVert, nCurr, nNum, nMax, nJob, nVtxJobs, nThreads;
 	unsigned int	nIdx0, nIdx1, nIdx2;
-	float			pfPos0[4], pfPos1[4], pfPos2[4];
-	float			pfTex0[4], pfTex1[4], pfTex2[4];
-	float			pfNor0[4], pfNor1[4], pfNor2[4];
 	unsigned int	*pui32IdxNew;		// New index array, this will be copied over the input array
+	EPVRTError		eRet = PVR_FAIL;
 
 	// Initialise the outputs
 	*pnVtxNumOut	= 0;
-	*pVtxOut		= (char*)malloc(MAX_VERTEX_OUT * nStride);
-	if(!*pVtxOut)
-	{
-		return PVR_FAIL;
-	}
+	*pVtxOut		= 0;
+
+	// Small meshes are not worth handing to other threads
+	nThreads	= nTriNum < PVRT_TANGENT_PARALLEL_MIN_TRIS ? 1 : ui32MaxThreads;
+	nVtxJobs	= (nVtxNum + PVRT_TANGENT_JOB_VERTS - 1) / PVRT_TANGENT_JOB_VERTS;
 
 	// Allocate some work space
+	memset(&sJob, 0, sizeof(sJob));
 	pui32IdxNew		= (unsigned int*)malloc(nTriNum * 3 * sizeof(*pui32IdxNew));
-	_ASSERT(pui32IdxNew);
-	psVtxData		= (SVtxData*)calloc(nVtxNum, sizeof(*psVtxData));
-	_ASSERT(psVtxData);
-	psTSpass		= (SVtxData*)calloc(cnMaxSharedVtx, sizeof(*psTSpass));
-	_ASSERT(psTSpass);
-	if(!pui32IdxNew || !psVtxData || !psTSpass)
+	pnVtxOffset		= (unsigned int*)calloc(nVtxNum + 1, sizeof(*pnVtxOffset));
+	pnVtxCorner		= (unsigned int*)malloc(nTriNum * 3 * sizeof(*pnVtxCorner));
+	pnJobScratch	= (unsigned int*)calloc(nVtxJobs + 1, sizeof(*pnJobScratch));
+	sJob.pnCorner	= (unsigned int*)malloc(nTriNum * 3 * sizeof(*sJob.pnCorner));
+	sJob.pnVtxOut	= (unsigned int*)malloc((nVtxNum + 1) * sizeof(*sJob.pnVtxOut));
+	sJob.pvTan		= (PVRTVECTOR3f*)malloc(nTriNum * 3 * sizeof(*sJob.pvTan));
+	sJob.pvBin		= (PVRTVECTOR3f*)malloc(nTriNum * 3 * sizeof(*sJob.pvBin));
+
+	if(!pui32IdxNew || !pnVtxOffset || !pnJobScratch || !sJob.pnVtxOut ||
+		((!pnVtxCorner || !sJob.pnCorner || !sJob.pvTan || !sJob.pvBin) && nTriNum))
 	{
-		return PVR_FAIL;
+		goto fail;
 	}
 
+	// Count the triangles using each vertex
 	for(nCurr = 0; nCurr < nTriNum; ++nCurr) {
 		nIdx0 = pui32Idx[3*nCurr+0];
 		nIdx1 = pui32Idx[3*nCurr+1];
@@ -630,166 +828,123 @@ EPVRTError PVRTVertexGenerateTangentSpace(
 
 		if(nIdx0 == nIdx1 || nIdx1 == nIdx2 || nIdx0 == nIdx2) {
 			_RPT0(_CRT_WARN,"GenerateTangentSpace(): Degenerate triangle found.\n");
-			return PVR_FAIL;
-		}
-
-		if(
-			psVtxData[nIdx0].n >= cnMaxSharedVtx ||
-			psVtxData[nIdx1].n >= cnMaxSharedVtx ||
-			psVtxData[nIdx2].n >= cnMaxSharedVtx)
-		{
-			_RPT0(_CRT_WARN,"GenerateTangentSpace(): Too many tris sharing a vtx.\n");
-			return PVR_FAIL;
+			goto fail;
 		}
 
-		PVRTVertexRead((PVRTVECTOR4f*) &pfPos0[0], (char*)&pVtx[nIdx0 * nStride] + nOffsetPos, eTypePos, 3);
-		PVRTVertexRead((PVRTVECTOR4f*) &pfPos1[0], (char*)&pVtx[nIdx1 * nStride] + nOffsetPos, eTypePos, 3);
-		PVRTVertexRead((PVRTVECTOR4f*) &pfPos2[0], (char*)&pVtx[nIdx2 * nStride] + nOffsetPos, eTypePos, 3);
-
-		PVRTVertexRead((PVRTVECTOR4f*) &pfNor0[0], (char*)&pVtx[nIdx0 * nStride] + nOffsetNor, eTypeNor, 3);
-		PVRTVertexRead((PVRTVECTOR4f*) &pfNor1[0], (char*)&pVtx[nIdx1 * nStride] + nOffsetNor, eTypeNor, 3);
-		PVRTVertexRead((PVRTVECTOR4f*) &pfNor2[0], (char*)&pVtx[nIdx2 * nStride] + nOffsetNor, eTypeNor, 3);
-
-		PVRTVertexRead((PVRTVECTOR4f*) &pfTex0[0], (char*)&pVtx[nIdx0 * nStride] + nOffsetTex, eTypeTex, 3);
-		PVRTVertexRead((PVRTVECTOR4f*) &pfTex1[0], (char*)&pVtx[nIdx1 * nStride] + nOffsetTex, eTypeTex, 3);
-		PVRTVertexRead((PVRTVECTOR4f*) &pfTex2[0], (char*)&pVtx[nIdx2 * nStride] + nOffsetTex, eTypeTex, 3);
-
-		PVRTVertexTangentBitangent(
-			&psVtxData[nIdx0].pvTan[psVtxData[nIdx0].n],
-			&psVtxData[nIdx0].pvBin[psVtxData[nIdx0].n],
-			(PVRTVECTOR3f*) &pfNor0[0],
-			pfPos0, pfPos1, pfPos2,
-			pfTex0, pfTex1, pfTex2);
-
-		PVRTVertexTangentBitangent(
-			&psVtxData[nIdx1].pvTan[psVtxData[nIdx1].n],
-			&psVtxData[nIdx1].pvBin[psVtxData[nIdx1].n],
-			(PVRTVECTOR3f*) &pfNor1[0],
-			pfPos1, pfPos2, pfPos0,
-			pfTex1, pfTex2, pfTex0);
-
-		PVRTVertexTangentBitangent(
-			&psVtxData[nIdx2].pvTan[psVtxData[nIdx2].n],
-			&psVtxData[nIdx2].pvBin[psVtxData[nIdx2].n],
-			(PVRTVECTOR3f*) &pfNor2[0],
-			pfPos2, pfPos0, pfPos1,
-			pfTex2, pfTex0, pfTex1);
-
-		psVtxData[nIdx0].pnTri[psVtxData[nIdx0].n] = nCurr;
-		psVtxData[nIdx1].pnTri[psVtxData[nIdx1].n] = nCurr;
-		psVtxData[nIdx2].pnTri[psVtxData[nIdx2].n] = nCurr;
-
-		++psVtxData[nIdx0].n;
-		++psVtxData[nIdx1].n;
-		++psVtxData[nIdx2].n;
+		++pnVtxOffset[nIdx0];
+		++pnVtxOffset[nIdx1];
+		++pnVtxOffset[nIdx2];
 	}
 
-	// Now let's go through the vertices calculating avg tangent-spaces; create new vertices if necessary
-	for(nVert = 0; nVert < nVtxNum; ++nVert) {
-		psVtx = &psVtxData[nVert];
-
-		// Start out with no output vertices required for this input vertex
-		nTSpassLen = 0;
-
-		// Run through each desired tangent space for this vertex
-		for(nCurr = 0; nCurr < (unsigned int) psVtx->n; ++nCurr) {
-			// Run through the possible vertices we can share with to see if we match
-			for(i = 0; i < nTSpassLen; ++i) {
-				psCmp = &psTSpass[i];
-
-				// Check all the shared vertices which match
-				for(j = 0; j < (unsigned int) psCmp->n; ++j) {
-					if(PVRTMatrixVec3DotProductF(psVtx->pvTan[nCurr], psCmp->pvTan[j]) < fSplitDifference)
-						break;
-					if(PVRTMatrixVec3DotProductF(psVtx->pvBin[nCurr], psCmp->pvBin[j]) < fSplitDifference)
-						break;
-				}
-
-				// Did all the existing vertices match?
-				if(j == (unsigned int) psCmp->n) {
-					// Yes, so add to list
-					_ASSERT(psCmp->n < cnMaxSharedVtx);
-					psCmp->pvTan[psCmp->n] = psVtx->pvTan[nCurr];
-					psCmp->pvBin[psCmp->n] = psVtx->pvBin[nCurr];
-					psCmp->pnTri[psCmp->n] = psVtx->pnTri[nCurr];
-					++psCmp->n;
-					break;
-				}
-			}
-
-			if(i == nTSpassLen) {
-				// We never found another matching matrix, so let's add this as a different one
-				_ASSERT(nTSpassLen < cnMaxSharedVtx);
-				psTSpass[nTSpassLen].pvTan[0] = psVtx->pvTan[nCurr];
-				psTSpass[nTSpassLen].pvBin[0] = psVtx->pvBin[nCurr];
-				psTSpass[nTSpassLen].pnTri[0] = psVtx->pnTri[nCurr];
-				psTSpass[nTSpassLen].n = 1;
-				++nTSpassLen;
-			}
+	// Turn the counts into the end of each vertex's run, then fill the runs
+	// backwards so that each ends up in triangle order and pnVtxOffset[n]
+	// ends up at its start. Each per-vertex job gets scratch for the most
+	// shared vertex in its range.
+	for(nVert = 0, nNum = 0, nMax = 0; nVert < nVtxNum; ++nVert) {
+		nMax = PVRT_MAX(nMax, pnVtxOffset[nVert]);
+		nNum += pnVtxOffset[nVert];
+		pnVtxOffset[nVert] = nNum;
+
+		if((nVert + 1) % PVRT_TANGENT_JOB_VERTS == 0 || nVert + 1 == nVtxNum) {
+			nJob = nVert / PVRT_TANGENT_JOB_VERTS;
+			pnJobScratch[nJob + 1] = pnJobScratch[nJob] + nMax;
+			nMax = 0;
 		}
+	}
+	pnVtxOffset[nVtxNum] = nNum;
 
-		// OK, now we have 'nTSpassLen' different desired matrices, so we need to add that many to output
-		_ASSERT(nTSpassLen >= 1);
-		for(nCurr = 0; nCurr < nTSpassLen; ++nCurr) {
-			psVtx = &psTSpass[nCurr];
-
-			memset(&pfPos0, 0, sizeof(pfPos0));
-			memset(&pfPos1, 0, sizeof(pfPos1));
-
-			for(i = 0; i < (unsigned int) psVtx->n; ++i) {
-				// Sum the tangent & bitangents, so we can average them
-				pfPos0[0] += psVtx->pvTan[i].x;
-				pfPos0[1] += psVtx->pvTan[i].y;
-				pfPos0[2] += psVtx->pvTan[i].z;
-
-				pfPos1[0] += psVtx->pvBin[i].x;
-				pfPos1[1] += psVtx->pvBin[i].y;
-				pfPos1[2] += psVtx->pvBin[i].z;
+	for(nCurr = nTriNum * 3; nCurr-- > 0; ) {
+		pnVtxCorner[--pnVtxOffset[pui32Idx[nCurr]]] = nCurr;
+	}
 
-				// Update triangle indices to use this vtx
-				if(pui32Idx[3 * psVtx->pnTri[i] + 0] == nVert) {
-					pui32IdxNew[3 * psVtx->pnTri[i] + 0] = *pnVtxNumOut;
+	// Per-vertex scratch; no more than one entry per corner in all
+	nMax = pnJobScratch[nVtxJobs];
+	if(nMax) {
+		sJob.pnFirst	= (unsigned int*)malloc(nMax * sizeof(*sJob.pnFirst));
+		sJob.pnLast		= (unsigned int*)malloc(nMax * sizeof(*sJob.pnLast));
+		sJob.pnNext		= (unsigned int*)malloc(nMax * sizeof(*sJob.pnNext));
+		sJob.pvTanSum	= (PVRTVECTOR3f*)malloc(nMax * sizeof(*sJob.pvTanSum));
+		sJob.pvBinSum	= (PVRTVECTOR3f*)malloc(nMax * sizeof(*sJob.pvBinSum));
+		if(!sJob.pnFirst || !sJob.pnLast || !sJob.pnNext || !sJob.pvTanSum || !sJob.pvBinSum)
+			goto fail;
+	}
 
-				} else if(pui32Idx[3 * psVtx->pnTri[i] + 1] == nVert) {
-					pui32IdxNew[3 * psVtx->pnTri[i] + 1] = *pnVtxNumOut;
+	// Calculate the tangent space each triangle wants at each of its corners
+	sJob.pVtx				= pVtx;
+	sJob.nStride			= nStride;
+	sJob.nOffsetPos			= nOffsetPos;
+	sJob.nOffsetNor			= nOffsetNor;
+	sJob.nOffsetTex			= nOffsetTex;
+	sJob.nOffsetTan			= nOffsetTan;
+	sJob.nOffsetBin			= nOffsetBin;
+	sJob.eTypePos			= eTypePos;
+	sJob.eTypeNor			= eTypeNor;
+	sJob.eTypeTex			= eTypeTex;
+	sJob.eTypeTan			= eTypeTan;
+	sJob.eTypeBin			= eTypeBin;
+	sJob.pui32Idx			= pui32Idx;
+	sJob.nTriNum			= nTriNum;
+	sJob.nVtxNum			= nVtxNum;
+	sJob.fSplitDifference	= fSplitDifference;
+	sJob.pnVtxOffset		= pnVtxOffset;
+	sJob.pnVtxCorner		= pnVtxCorner;
+	sJob.pnJobScratch		= pnJobScratch;
+	sJob.pui32IdxNew		= pui32IdxNew;
+
+	PVRTParallelFor(
+		PVRTVertexTangentJob, &sJob,
+		(nTriNum + PVRT_TANGENT_JOB_TRIS - 1) / PVRT_TANGENT_JOB_TRIS,
+		nThreads);
+
+	// Group the tangent spaces wanted at each vertex
+	PVRTParallelFor(PVRTVertexTangentGroupJob, &sJob, nVtxJobs, nThreads);
+
+	// Turn the number of tangent spaces of each vertex into its first output vertex
+	for(nVert = 0, nNum = 0; nVert < nVtxNum; ++nVert) {
+		nCurr = sJob.pnVtxOut[nVert];
+		sJob.pnVtxOut[nVert] = nNum;
+		nNum += nCurr;
+	}
+	sJob.pnVtxOut[nVtxNum] = nNum;
 
-				} else if(pui32Idx[3 * psVtx->pnTri[i] + 2] == nVert) {
-					pui32IdxNew[3 * psVtx->pnTri[i] + 2] = *pnVtxNumOut;
+	// Now output one vertex per tangent space
+	*pVtxOut = (char*)malloc(nNum * nStride);
+	if(!*pVtxOut && nNum)
+		goto fail;
 
-				} else {
-					_ASSERT(0);
-				}
-			}
+	sJob.pVtxOut = *pVtxOut;
+	PVRTParallelFor(PVRTVertexTangentOutputJob, &sJob, nVtxJobs, nThreads);
+	*pnVtxNumOut = nNum;
 
-			PVRTMatrixVec3NormalizeF(*(PVRTVECTOR3f*) &pfPos0[0], *(PVRTVECTOR3f*) &pfPos0[0]);
-			PVRTMatrixVec3NormalizeF(*(PVRTVECTOR3f*) &pfPos1[0], *(PVRTVECTOR3f*) &pfPos1[0]);
+	memcpy(pui32Idx, pui32IdxNew, nTriNum * 3 * sizeof(*pui32IdxNew));
 
-			if(*pnVtxNumOut >= MAX_VERTEX_OUT) {
-				_RPT0(_CRT_WARN,"PVRTVertexGenerateTangentSpace() ran out of working space! (Too many split vertices)\n");
-				return PVR_FAIL;
-			}
+	_RPT3(_CRT_WARN, "GenerateTangentSpace(): %d tris, %d vtx in, %d vtx out\n", nTriNum, nVtxNum, *pnVtxNumOut);
+	_ASSERT(*pnVtxNumOut >= nVtxNum);
 
-			memcpy(&(*pVtxOut)[(*pnVtxNumOut) * nStride], &pVtx[nVert*nStride], nStride);
-			PVRTVertexWrite((char*)&(*pVtxOut)[(*pnVtxNumOut) * nStride] + nOffsetTan, eTypeTan, 3, (PVRTVECTOR4f*) &pfPos0[0]);
-			PVRTVertexWrite((char*)&(*pVtxOut)[(*pnVtxNumOut) * nStride] + nOffsetBin, eTypeBin, 3, (PVRTVECTOR4f*) &pfPos1[0]);
+	eRet = PVR_SUCCESS;
 
-			++*pnVtxNumOut;
-		}
+fail:
+	if(eRet != PVR_SUCCESS)
+	{
+		FREE(*pVtxOut);
+		*pnVtxNumOut = 0;
 	}
 
-	FREE(psTSpass);
-	FREE(psVtxData);
-
-	*pVtxOut = (char*)realloc(*pVtxOut, *pnVtxNumOut * nStride);
-	_ASSERT(*pVtxOut);
-
-	memcpy(pui32Idx, pui32IdxNew, nTriNum * 3 * sizeof(*pui32IdxNew));
+	FREE(sJob.pvBinSum);
+	FREE(sJob.pvTanSum);
+	FREE(sJob.pnNext);
+	FREE(sJob.pnLast);
+	FREE(sJob.pnFirst);
+	FREE(sJob.pvBin);
+	FREE(sJob.pvTan);
+	FREE(sJob.pnVtxOut);
+	FREE(sJob.pnCorner);
+	FREE(pnJobScratch);
+	FREE(pnVtxCorner);
+	FREE(pnVtxOffset);
 	FREE(pui32IdxNew);
 
-	_RPT3(_CRT_WARN, "GenerateTangentSpace(): %d tris, %d vtx in, %d vtx out\n", nTriNum, nVtxNum, *pnVtxNumOut);
-	_ASSERT(*pnVtxNumOut >= nVtxNum);
-
-	return PVR_SUCCESS;
+	return eRet;
 }
 
 /*****************************************************************************
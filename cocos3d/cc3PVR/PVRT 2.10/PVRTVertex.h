@@ -145,6 +145,9 @@ void PVRTVertexTangentBitangent(
  @Input				eTypeBin			Data type of the bitangent
  @Input				nTriNum				Number of triangles
  @Input				fSplitDifference	Split a vertex if the DP3 of tangents/bitangents are below this (range -1..1)
+ @Input				ui32MaxThreads		Threads to spread the work over; 0 uses all processors,
+										1 (the default) runs on the calling thread. Meshes of
+										fewer than 8192 triangles always run on the calling thread
  @Return			PVR_FAIL if there was a problem.
  @Description		Calculates the tangent space for all supplied vertices.
 					Writes tangent and bitangent vectors to the output
@@ -155,6 +158,10 @@ void PVRTVertexTangentBitangent(
 					uses fSplitDifference - of the DP3 of two desired
 					tangents or two desired bitangents is higher than this,
 					the vertex will be split.
+					There is no limit on the number of triangles sharing a
+					vertex; the triangles using each vertex are gathered into
+					one compact list so the time taken is linear in the size
+					of the mesh.
 *****************************************************************************/
 EPVRTError PVRTVertexGenerateTangentSpace(
 	unsigned int	* const pnVtxNumOut,
@@ -174,7 +181,8 @@ EPVRTError PVRTVertexGenerateTangentSpace(
 	const unsigned int	nOffsetBin,
 	EPVRTDataType	eTypeBin,
 	const unsigned int	nTriNum,
-	const float		fSplitDifference);
+	const float		fSplitDifference,
+	const unsigned int	ui32MaxThreads = 1);
 
 
 #endif /* _PVRTVERTEX_H_ */
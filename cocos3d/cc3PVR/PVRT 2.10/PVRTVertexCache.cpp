@@ -0,0 +1,375 @@
+/******************************************************************************
+
+ @File         PVRTVertexCache.cpp
+
+ @Title        PVRTVertexCache
+
+ @Version
+
+ @Copyright    Copyright (c) Imagination Technologies Limited.
+
+ @Platform     ANSI compatible
+
+ @Description  Reorders indexed triangle lists for post-transform vertex
+               cache reuse, reorders vertices for fetch locality, and
+               measures the average cache miss ratio (ACMR) of an index
+               list.
+
+******************************************************************************/
+
+/****************************************************************************
+** Includes
+****************************************************************************/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "PVRTGlobal.h"
+#include "PVRTVertexCache.h"
+
+/****************************************************************************
+** Defines
+****************************************************************************/
+/* Size of the LRU cache the triangle order is scored against */
+#define FORSYTH_CACHE_SIZE			(32)
+#define FORSYTH_CACHE_DECAY_POWER	(1.5f)
+#define FORSYTH_LAST_TRI_SCORE		(0.75f)
+#define FORSYTH_VALENCE_BOOST_SCALE	(2.0f)
+#define FORSYTH_VALENCE_BOOST_POWER	(0.5f)
+
+/* Valences with a precomputed score; higher ones are computed as needed */
+#define FORSYTH_VALENCE_TABLE_SIZE	(32)
+
+/* Marks a vertex that is not in the cache, or the lack of a best triangle */
+#define FORSYTH_NONE				(0xFFFFFFFF)
+
+/****************************************************************************
+** Structures
+****************************************************************************/
+/*!***************************************************************************
+@Class CForsythScores
+@Brief Score contributions of a vertex's cache position and valence
+*****************************************************************************/
+class CForsythScores
+{
+public:
+	float	m_afCachePos[FORSYTH_CACHE_SIZE];
+	float	m_afValence[FORSYTH_VALENCE_TABLE_SIZE];
+
+/*!***************************************************************************
+ @Function		CForsythScores
+ @Description	Fills the score tables
+*****************************************************************************/
+	CForsythScores()
+	{
+		for(unsigned int i = 0; i < FORSYTH_CACHE_SIZE; ++i)
+		{
+			// The vertices of the last triangle get a fixed score, so that the
+			// next triangle does not simply reuse the same edge
+			if(i < 3)
+				m_afCachePos[i] = FORSYTH_LAST_TRI_SCORE;
+			else
+				m_afCachePos[i] = powf(1.0f - (float)(i - 3) / (float)(FORSYTH_CACHE_SIZE - 3), FORSYTH_CACHE_DECAY_POWER);
+		}
+
+		m_afValence[0] = 0.0f;
+		for(unsigned int i = 1; i < FORSYTH_VALENCE_TABLE_SIZE; ++i)
+			m_afValence[i] = ValenceScore(i);
+	}
+
+/*!***************************************************************************
+ @Function		ValenceScore
+ @Input			ui32Valence		Number of triangles still to be drawn
+ @Return		The score boost of the vertex
+ @Description	Vertices with few triangles left are boosted, so that lone
+				triangles are not left behind to be drawn later with cold
+				vertices.
+*****************************************************************************/
+	static float ValenceScore(const unsigned int ui32Valence)
+	{
+		return FORSYTH_VALENCE_BOOST_SCALE * powf((float)ui32Valence, -FORSYTH_VALENCE_BOOST_POWER);
+	}
+
+/*!***************************************************************************
+ @Function		Score
+ @Input			ui32CachePos	Position in the LRU cache, or FORSYTH_NONE
+ @Input			ui32Valence		Number of triangles still to be drawn
+ @Return		The score of the vertex; -1 when it has no triangles left
+*****************************************************************************/
+	float Score(const unsigned int ui32CachePos, const unsigned int ui32Valence) const
+	{
+		if(!ui32Valence)
+			return -1.0f;
+
+		float fScore = ui32CachePos < FORSYTH_CACHE_SIZE ? m_afCachePos[ui32CachePos] : 0.0f;
+
+		if(ui32Valence < FORSYTH_VALENCE_TABLE_SIZE)
+			return fScore + m_afValence[ui32Valence];
+		return fScore + ValenceScore(ui32Valence);
+	}
+};
+
+/****************************************************************************
+** Functions
+****************************************************************************/
+
+/*!***************************************************************************
+ @Function		PVRTVertexCacheACMR
+ @Input			pui32Idx		Triangle list indices
+ @Input			ui32TriNum		Number of triangles
+ @Input			ui32VtxNum		Number of vertices; all indices must be less
+ @Input			ui32CacheSize	Number of entries of the simulated cache
+ @Return		Average number of cache misses per triangle, from 0.5 at best
+				for large regular meshes to 3 at worst
+ @Description	Runs the index list through a simulated FIFO vertex cache and
+				counts the vertices that have to be transformed.
+*****************************************************************************/
+float PVRTVertexCacheACMR(
+	const unsigned int	* const pui32Idx,
+	const unsigned int	ui32TriNum,
+	const unsigned int	ui32VtxNum,
+	const unsigned int	ui32CacheSize)
+{
+	if(!ui32TriNum || !ui32VtxNum)
+		return 0.0f;
+
+	// One more than the miss that last pushed each vertex into the cache; 0 if never
+	unsigned int *pui32Pushed = (unsigned int*)calloc(ui32VtxNum, sizeof(*pui32Pushed));
+	if(!pui32Pushed)
+		return 0.0f;
+
+	unsigned int ui32Misses = 0;
+	for(unsigned int i = 0; i < ui32TriNum * 3; ++i)
+	{
+		const unsigned int ui32Vtx = pui32Idx[i];
+
+		// The FIFO holds the vertices of the last ui32CacheSize misses
+		if(!pui32Pushed[ui32Vtx] || ui32Misses - (pui32Pushed[ui32Vtx] - 1) > ui32CacheSize)
+		{
+			++ui32Misses;
+			pui32Pushed[ui32Vtx] = ui32Misses;
+		}
+	}
+
+	FREE(pui32Pushed);
+	return (float)ui32Misses / (float)ui32TriNum;
+}
+
+/*!***************************************************************************
+ @Function		PVRTVertexCacheOptimise
+ @Modified		pui32Idx		Triangle list indices
+ @Input			ui32TriNum		Number of triangles
+ @Input			ui32VtxNum		Number of vertices; all indices must be less
+ @Return		PVR_SUCCESS, or PVR_FAIL if out of memory
+ @Description	Reorders the triangles of the list for post-transform vertex
+				cache reuse, using Tom Forsyth's linear-speed vertex cache
+				optimisation. The vertices of each triangle keep their
+				order, so the winding is unchanged. The result does not
+				depend on the exact size of the hardware cache.
+*****************************************************************************/
+EPVRTError PVRTVertexCacheOptimise(
+	unsigned int		* const pui32Idx,
+	const unsigned int	ui32TriNum,
+	const unsigned int	ui32VtxNum)
+{
+	static const CForsythScores	c_sScores;
+
+	unsigned int	*pui32Valence, *pui32TriStart, *pui32VtxTris, *pui32Out;
+	float			*pfVtxScore;
+	unsigned char	*pbDrawn;
+	unsigned int	aui32Cache[FORSYTH_CACHE_SIZE + 3], aui32NewCache[FORSYTH_CACHE_SIZE + 3];
+	unsigned int	ui32CacheNum, ui32NewCacheNum;
+	unsigned int	ui32Best, ui32NextUndrawn;
+	unsigned int	i, j, k;
+	float			fBestScore;
+
+	if(ui32TriNum < 2)
+		return PVR_SUCCESS;
+
+	pui32Valence	= (unsigned int*)calloc(ui32VtxNum, sizeof(*pui32Valence));
+	pui32TriStart	= (unsigned int*)malloc((ui32VtxNum + 1) * sizeof(*pui32TriStart));
+	pui32VtxTris	= (unsigned int*)malloc(ui32TriNum * 3 * sizeof(*pui32VtxTris));
+	pui32Out		= (unsigned int*)malloc(ui32TriNum * 3 * sizeof(*pui32Out));
+	pfVtxScore		= (float*)malloc(ui32VtxNum * sizeof(*pfVtxScore));
+	pbDrawn			= (unsigned char*)calloc(ui32TriNum, sizeof(*pbDrawn));
+
+	if(!pui32Valence || !pui32TriStart || !pui32VtxTris || !pui32Out || !pfVtxScore || !pbDrawn)
+	{
+		FREE(pui32Valence);
+		FREE(pui32TriStart);
+		FREE(pui32VtxTris);
+		FREE(pui32Out);
+		FREE(pfVtxScore);
+		FREE(pbDrawn);
+		return PVR_FAIL;
+	}
+
+	// List the triangles of each vertex. pui32Valence counts the triangles
+	// still to be drawn, which are kept at the front of each vertex's list.
+	for(i = 0; i < ui32TriNum * 3; ++i)
+		++pui32Valence[pui32Idx[i]];
+
+	pui32TriStart[0] = 0;
+	for(i = 0; i < ui32VtxNum; ++i)
+		pui32TriStart[i + 1] = pui32TriStart[i] + pui32Valence[i];
+
+	memset(pui32Valence, 0, ui32VtxNum * sizeof(*pui32Valence));
+	for(i = 0; i < ui32TriNum * 3; ++i)
+	{
+		const unsigned int ui32Vtx = pui32Idx[i];
+		pui32VtxTris[pui32TriStart[ui32Vtx] + pui32Valence[ui32Vtx]++] = i / 3;
+	}
+
+	// Initial scores
+	for(i = 0; i < ui32VtxNum; ++i)
+		pfVtxScore[i] = c_sScores.Score(FORSYTH_NONE, pui32Valence[i]);
+
+	ui32Best	= 0;
+	fBestScore	= -1.0f;
+	for(i = 0; i < ui32TriNum; ++i)
+	{
+		const float fScore = pfVtxScore[pui32Idx[3 * i]] + pfVtxScore[pui32Idx[3 * i + 1]] + pfVtxScore[pui32Idx[3 * i + 2]];
+		if(fScore > fBestScore)
+		{
+			fBestScore	= fScore;
+			ui32Best	= i;
+		}
+	}
+
+	ui32CacheNum	= 0;
+	ui32NextUndrawn	= 0;
+
+	for(unsigned int ui32Drawn = 0; ui32Drawn < ui32TriNum; ++ui32Drawn)
+	{
+		// When no triangle touches the cache, continue from the first one
+		// not drawn yet, as the input order is usually coherent
+		if(ui32Best == FORSYTH_NONE)
+		{
+			while(pbDrawn[ui32NextUndrawn])
+				++ui32NextUndrawn;
+			ui32Best = ui32NextUndrawn;
+		}
+
+		const unsigned int * const pui32Tri = &pui32Idx[3 * ui32Best];
+		memcpy(&pui32Out[3 * ui32Drawn], pui32Tri, 3 * sizeof(*pui32Out));
+		pbDrawn[ui32Best] = 1;
+
+		// Take the triangle off the lists of its vertices, and put the
+		// vertices at the front of the cache
+		ui32NewCacheNum = 0;
+		for(j = 0; j < 3; ++j)
+		{
+			const unsigned int ui32Vtx		= pui32Tri[j];
+			unsigned int * const pui32Tris	= &pui32VtxTris[pui32TriStart[ui32Vtx]];
+
+			for(k = 0; k < pui32Valence[ui32Vtx]; ++k)
+			{
+				if(pui32Tris[k] == ui32Best)
+				{
+					pui32Tris[k] = pui32Tris[--pui32Valence[ui32Vtx]];
+					break;
+				}
+			}
+
+			// Degenerate triangles use a vertex more than once
+			if(!ui32NewCacheNum || aui32NewCache[0] != ui32Vtx)
+			{
+				if(ui32NewCacheNum < 2 || aui32NewCache[1] != ui32Vtx)
+					aui32NewCache[ui32NewCacheNum++] = ui32Vtx;
+			}
+		}
+
+		for(j = 0; j < ui32CacheNum; ++j)
+		{
+			const unsigned int ui32Vtx = aui32Cache[j];
+			if(ui32Vtx != pui32Tri[0] && ui32Vtx != pui32Tri[1] && ui32Vtx != pui32Tri[2])
+				aui32NewCache[ui32NewCacheNum++] = ui32Vtx;
+		}
+
+		// Rescore the vertices that moved in or out of the cache
+		for(j = 0; j < ui32NewCacheNum; ++j)
+		{
+			const unsigned int ui32Vtx = aui32NewCache[j];
+			pfVtxScore[ui32Vtx] = c_sScores.Score(j < FORSYTH_CACHE_SIZE ? j : FORSYTH_NONE, pui32Valence[ui32Vtx]);
+		}
+
+		// Rescore their triangles, and choose the best for the next draw
+		ui32Best	= FORSYTH_NONE;
+		fBestScore	= -1.0f;
+		for(j = 0; j < ui32NewCacheNum; ++j)
+		{
+			const unsigned int ui32Vtx			= aui32NewCache[j];
+			const unsigned int * const pui32Tris	= &pui32VtxTris[pui32TriStart[ui32Vtx]];
+
+			for(k = 0; k < pui32Valence[ui32Vtx]; ++k)
+			{
+				const unsigned int ui32Tri	= pui32Tris[k];
+				const unsigned int *pui32V	= &pui32Idx[3 * ui32Tri];
+
+				const float fScore			= pfVtxScore[pui32V[0]] + pfVtxScore[pui32V[1]] + pfVtxScore[pui32V[2]];
+
+				if(fScore > fBestScore)
+				{
+					fBestScore	= fScore;
+					ui32Best	= ui32Tri;
+				}
+			}
+		}
+
+		ui32CacheNum = PVRT_MIN(ui32NewCacheNum, (unsigned int) FORSYTH_CACHE_SIZE);
+		memcpy(aui32Cache, aui32NewCache, ui32CacheNum * sizeof(*aui32Cache));
+	}
+
+	memcpy(pui32Idx, pui32Out, ui32TriNum * 3 * sizeof(*pui32Idx));
+
+	FREE(pui32Valence);
+	FREE(pui32TriStart);
+	FREE(pui32VtxTris);
+	FREE(pui32Out);
+	FREE(pfVtxScore);
+	FREE(pbDrawn);
+	return PVR_SUCCESS;
+}
+
+/*!***************************************************************************
+ @Function		PVRTVertexCacheRemap
+ @Output		pui32Remap		ui32VtxNum entries: the new index of each vertex
+ @Input			pui32Idx		Indices
+ @Input			ui32IdxNum		Number of indices
+ @Input			ui32VtxNum		Number of vertices; all indices must be less
+ @Return		Number of vertices the indices reference
+ @Description	Numbers the vertices in the order the indices first use them,
+				so that vertex fetches walk forwards through memory. Vertices
+				that are not referenced are numbered last, in their original
+				order. The remap is a permutation of [0, ui32VtxNum).
+*****************************************************************************/
+unsigned int PVRTVertexCacheRemap(
+	unsigned int		* const pui32Remap,
+	const unsigned int	* const pui32Idx,
+	const unsigned int	ui32IdxNum,
+	const unsigned int	ui32VtxNum)
+{
+	unsigned int i, ui32Next, ui32Used;
+
+	for(i = 0; i < ui32VtxNum; ++i)
+		pui32Remap[i] = FORSYTH_NONE;
+
+	ui32Next = 0;
+	for(i = 0; i < ui32IdxNum; ++i)
+	{
+		if(pui32Remap[pui32Idx[i]] == FORSYTH_NONE)
+			pui32Remap[pui32Idx[i]] = ui32Next++;
+	}
+	ui32Used = ui32Next;
+
+	for(i = 0; i < ui32VtxNum; ++i)
+	{
+		if(pui32Remap[i] == FORSYTH_NONE)
+			pui32Remap[i] = ui32Next++;
+	}
+	return ui32Used;
+}
+
+/*****************************************************************************
+ End of file (PVRTVertexCache.cpp)
+*****************************************************************************/
@@ -0,0 +1,91 @@
+/******************************************************************************
+
+ @File         PVRTVertexCache.h
+
+ @Title        PVRTVertexCache
+
+ @Version
+
+ @Copyright    Copyright (c) Imagination Technologies Limited.
+
+ @Platform     ANSI compatible
+
+ @Description  Reorders indexed triangle lists for post-transform vertex
+               cache reuse, reorders vertices for fetch locality, and
+               measures the average cache miss ratio (ACMR) of an index
+               list.
+
+******************************************************************************/
+#ifndef _PVRTVERTEXCACHE_H_
+#define _PVRTVERTEXCACHE_H_
+
+#include "PVRTGlobal.h"
+#include "PVRTError.h"
+
+/****************************************************************************
+** Defines
+****************************************************************************/
+/*! Size of the FIFO vertex cache simulated by PVRTVertexCacheACMR by default */
+#define PVRT_VERTEX_CACHE_SIZE		(16)
+
+/****************************************************************************
+** Functions
+****************************************************************************/
+
+/*!***************************************************************************
+ @Function		PVRTVertexCacheACMR
+ @Input			pui32Idx		Triangle list indices
+ @Input			ui32TriNum		Number of triangles
+ @Input			ui32VtxNum		Number of vertices; all indices must be less
+ @Input			ui32CacheSize	Number of entries of the simulated cache
+ @Return		Average number of cache misses per triangle, from 0.5 at best
+				for large regular meshes to 3 at worst
+ @Description	Runs the index list through a simulated FIFO vertex cache and
+				counts the vertices that have to be transformed.
+*****************************************************************************/
+float PVRTVertexCacheACMR(
+	const unsigned int	* const pui32Idx,
+	const unsigned int	ui32TriNum,
+	const unsigned int	ui32VtxNum,
+	const unsigned int	ui32CacheSize = PVRT_VERTEX_CACHE_SIZE);
+
+/*!***************************************************************************
+ @Function		PVRTVertexCacheOptimise
+ @Modified		pui32Idx		Triangle list indices
+ @Input			ui32TriNum		Number of triangles
+ @Input			ui32VtxNum		Number of vertices; all indices must be less
+ @Return		PVR_SUCCESS, or PVR_FAIL if out of memory
+ @Description	Reorders the triangles of the list for post-transform vertex
+				cache reuse, using Tom Forsyth's linear-speed vertex cache
+				optimisation. The vertices of each triangle keep their
+				order, so the winding is unchanged. The result does not
+				depend on the exact size of the hardware cache.
+*****************************************************************************/
+EPVRTError PVRTVertexCacheOptimise(
+	unsigned int		* const pui32Idx,
+	const unsigned int	ui32TriNum,
+	const unsigned int	ui32VtxNum);
+
+/*!***************************************************************************
+ @Function		PVRTVertexCacheRemap
+ @Output		pui32Remap		ui32VtxNum entries: the new index of each vertex
+ @Input			pui32Idx		Indices
+ @Input			ui32IdxNum		Number of indices
+ @Input			ui32VtxNum		Number of vertices; all indices must be less
+ @Return		Number of vertices the indices reference
+ @Description	Numbers the vertices in the order the indices first use them,
+				so that vertex fetches walk forwards through memory. Vertices
+				that are not referenced are numbered last, in their original
+				order. The remap is a permutation of [0, ui32VtxNum).
+*****************************************************************************/
+unsigned int PVRTVertexCacheRemap(
+	unsigned int		* const pui32Remap,
+	const unsigned int	* const pui32Idx,
+	const unsigned int	ui32IdxNum,
+	const unsigned int	ui32VtxNum);
+
+#endif /* _PVRTVERTEXCACHE_H_ */
+
+/*****************************************************************************
+ End of file (PVRTVertexCache.h)
+*****************************************************************************/
@@ -35,14 +35,16 @@
 @class CC3FaceArray;
 
 /** Indicates that a face has no neighbour over a particular edge. */
-#define kCC3FaceNoNeighbour  ((GLushort)~0)
+#define kCC3FaceNoNeighbour  ((GLuint)~0)
 
 /**
  * For each edge in a face, contains an index to the adjacent face,
  * or kCC3FaceNoNeighbour if the face has no neighbour over that edge.
+ *
+ * The edge at index N runs from vertex N of the face to vertex N+1 (wrapping to vertex 0).
  */
 typedef struct {
-	GLushort edges[3];		/**< Indices to the 3 neighbouring faces, in winding order. */
+	GLuint edges[3];		/**< Indices to the 3 neighbouring faces, in winding order. */
 } CC3FaceNeighbours;
 
 /** Returns a string description of the specified CC3FaceNeighbours struct. */
@@ -51,6 +53,32 @@ static inline NSString* NSStringFromCC3FaceNeighbours(CC3FaceNeighbours faceNeig
 			faceNeighbours.edges[0], faceNeighbours.edges[1], faceNeighbours.edges[2]];
 }
 
+/**
+ * Populates the specified array of faceCount CC3FaceNeighbours structures with the
+ * neighbours of each face in a list of triangles.
+ *
+ * The vertexIndices argument points to (faceCount * 3) vertex indices, three per face,
+ * in winding order, as used when drawing with GL_TRIANGLES. The indexSize argument
+ * specifies the size, in bytes, of each index, and must be 1, 2 or 4. Because of this,
+ * the function can be used directly on the face index data of a mesh loaded from a
+ * POD file (the pData of the sFaces member of a SPODMesh), as well as on the face
+ * indices extracted from a CC3Mesh.
+ *
+ * Two faces are neighbours over an edge if the edge has the same two vertex indices
+ * in both faces, in either direction. If more than two faces share an edge, the faces
+ * are paired up in face order, and each face is paired with the next face that has
+ * not already been paired over that edge. Edges that have no neighbour are set to
+ * kCC3FaceNoNeighbour.
+ *
+ * The edges are matched through a hash table, so the time taken grows linearly with
+ * the number of faces. Returns NO, and leaves the neighbours array unchanged, if the
+ * temporary memory could not be allocated, or if the arguments are invalid.
+ */
+BOOL CC3FaceNeighboursPopulate(CC3FaceNeighbours* neighbours,
+							   const GLvoid* vertexIndices,
+							   GLuint indexSize,
+							   GLuint faceCount);
+
 /**
  * A CC3Mesh holds the 3D mesh for a CC3MeshNode. The CC3MeshNode enapsulates a reference
  * to the CC3Mesh.
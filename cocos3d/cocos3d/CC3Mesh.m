@@ -38,6 +38,7 @@
 				forCount: (GLuint) vertexCount
 			 withVisitor: (CC3NodeDrawingVisitor*) visitor;
 -(CC3FaceIndices) uncachedFaceIndicesAt: (GLsizei) faceIndex;
+-(void) getVertexIndices: (GLuint*) vtxIndices ofFaceAt: (GLsizei) faceIndex;
 -(BOOL) switchingMesh;
 @end
 
@@ -350,6 +351,11 @@ static GLuint lastAssignedMeshTag;
 
 -(CC3FaceIndices) uncachedFaceIndicesAt: (GLsizei) faceIndex { return kCC3FaceIndicesZero; }
 
+/** Populates the three vertex indices of the specified face, without narrowing them to GLushort. */
+-(void) getVertexIndices: (GLuint*) vtxIndices ofFaceAt: (GLsizei) faceIndex {
+	vtxIndices[0] = vtxIndices[1] = vtxIndices[2] = 0;
+}
+
 -(CC3FaceIndices) faceIndicesAt: (GLsizei) faceIndex {
 	return [self.faces indicesAt: faceIndex];
 }
@@ -403,6 +409,105 @@ static GLuint currentMeshTag = 0;
 @end
 
 
+#pragma mark -
+#pragma mark Face neighbour functions
+
+/** Marks an unused slot in the edge table used by CC3FaceNeighboursPopulate. */
+#define kCC3EdgeSlotEmpty		((GLuint)~0)
+
+/** Marks a slot in the edge table whose edge has been paired, and can be stepped over. */
+#define kCC3EdgeSlotPaired		((GLuint)~1)
+
+/** The most faces CC3FaceNeighboursPopulate accepts, so that twice the edge count fits in a GLuint. */
+#define kCC3FaceNeighboursMaxFaces	(0x7FFFFFFFu / 6)
+
+/** Returns the vertex index at the specified position in an array of indices of the specified size. */
+static inline GLuint CC3VertexIndexAt(const GLvoid* vertexIndices, GLuint indexSize, GLuint idxPos) {
+	switch (indexSize) {
+		case 1: return ((const GLubyte*)vertexIndices)[idxPos];
+		case 2: return ((const GLushort*)vertexIndices)[idxPos];
+		default: return ((const GLuint*)vertexIndices)[idxPos];
+	}
+}
+
+/**
+ * Returns the end vertices of the specified edge, where an edge is identified by
+ * (faceIndex * 3 + edgeIndexInFace), ordered so that the lower index is in *pLow.
+ */
+static inline void CC3EdgeEnds(const GLvoid* vertexIndices, GLuint indexSize, GLuint edgeIdx,
+							   GLuint* pLow, GLuint* pHigh) {
+	GLuint start = CC3VertexIndexAt(vertexIndices, indexSize, edgeIdx);
+	GLuint end = CC3VertexIndexAt(vertexIndices, indexSize, (edgeIdx % 3 < 2) ? (edgeIdx + 1) : (edgeIdx - 2));
+	*pLow = MIN(start, end);
+	*pHigh = MAX(start, end);
+}
+
+/** Returns a hash of the two end vertices of an edge. */
+static inline GLuint CC3EdgeHash(GLuint low, GLuint high) {
+	GLuint h = (low * 0x9E3779B1u) ^ (high * 0x85EBCA77u);
+	return h ^ (h >> 15);
+}
+
+BOOL CC3FaceNeighboursPopulate(CC3FaceNeighbours* neighbours,
+							   const GLvoid* vertexIndices,
+							   GLuint indexSize,
+							   GLuint faceCount) {
+	if ( !(indexSize == 1 || indexSize == 2 || indexSize == 4) ) return NO;
+	if (faceCount > kCC3FaceNeighboursMaxFaces) return NO;
+	if ( !faceCount ) return YES;
+	if ( !neighbours || !vertexIndices ) return NO;
+
+	// Size the table to at least twice the number of edges. Since slots are never reused,
+	// the table never becomes more than half full, and each lookup stays short.
+	GLuint edgeCount = faceCount * 3;
+	GLuint slotCount = 1;
+	while (slotCount < edgeCount * 2) slotCount <<= 1;
+	GLuint slotMask = slotCount - 1;
+	
+	GLuint* slots = malloc(slotCount * sizeof(GLuint));
+	if ( !slots ) return NO;
+	memset(slots, 0xFF, slotCount * sizeof(GLuint));	// kCC3EdgeSlotEmpty
+
+	for (GLuint faceIdx = 0; faceIdx < faceCount; faceIdx++) {
+		GLuint* neighbourEdge = neighbours[faceIdx].edges;
+		neighbourEdge[0] = neighbourEdge[1] = neighbourEdge[2] = kCC3FaceNoNeighbour;
+	}
+
+	// Visit the edges in face order. Each edge is paired with the first edge in the table
+	// that has the same end points and belongs to another face. If there is none, the edge
+	// is added to the end of its probe sequence, so that the table keeps edges with the same
+	// end points in face order, and the pairing matches that of a face-by-face search.
+	for (GLuint e1Idx = 0; e1Idx < edgeCount; e1Idx++) {
+		GLuint f1Idx = e1Idx / 3;
+		GLuint e1Low, e1High;
+		CC3EdgeEnds(vertexIndices, indexSize, e1Idx, &e1Low, &e1High);
+
+		GLuint slotIdx = CC3EdgeHash(e1Low, e1High) & slotMask;
+		while (YES) {
+			GLuint e2Idx = slots[slotIdx];
+			if (e2Idx == kCC3EdgeSlotEmpty) {
+				slots[slotIdx] = e1Idx;
+				break;
+			}
+			if (e2Idx != kCC3EdgeSlotPaired && (e2Idx / 3) != f1Idx) {
+				GLuint e2Low, e2High;
+				CC3EdgeEnds(vertexIndices, indexSize, e2Idx, &e2Low, &e2High);
+				if (e1Low == e2Low && e1High == e2High) {
+					neighbours[f1Idx].edges[e1Idx % 3] = e2Idx / 3;
+					neighbours[e2Idx / 3].edges[e2Idx % 3] = f1Idx;
+					slots[slotIdx] = kCC3EdgeSlotPaired;
+					break;
+				}
+			}
+			slotIdx = (slotIdx + 1) & slotMask;
+		}
+	}
+
+	free(slots);
+	return YES;
+}
+
+
 #pragma mark -
 #pragma mark CC3FaceArray
 
@@ -849,84 +954,34 @@ static GLuint currentMeshTag = 0;
 	if ( !neighbours ) [self allocateNeighbours];
 	
 	GLsizei faceCnt = self.faceCount;
+	if ( !neighbours || faceCnt <= 0 ) return;
 	
-	// Break all neighbour links. Done in batch so that we can skip
-	// testing neighbour connections from both directions later.
-	for (int faceIdx = 0; faceIdx < faceCnt; faceIdx++) {
-		GLushort* neighbourEdge = neighbours[faceIdx].edges;
-		neighbourEdge[0] = neighbourEdge[1] = neighbourEdge[2] = kCC3FaceNoNeighbour;
+	// Gather the vertex indices of all the faces into a triangle list, regardless of
+	// the drawing mode of the mesh, and match the edges of the faces in one pass.
+	// The indices are gathered as GLuints, because faceIndicesAt: narrows them to
+	// GLushort, which would pair up the wrong faces in a mesh with many vertices.
+	GLuint* faceIndices = malloc(faceCnt * 3 * sizeof(GLuint));
+	if ( !faceIndices ) {
+		LogError(@"%@ could not allocate memory to populate neighbours for %u faces", self, faceCnt);
+		return;
+	}
+	for (GLsizei faceIdx = 0; faceIdx < faceCnt; faceIdx++) {
+		[mesh getVertexIndices: &faceIndices[faceIdx * 3] ofFaceAt: faceIdx];
 	}
 	
-	// Iterate through all the faces
-	for (int f1Idx = 0; f1Idx < faceCnt; f1Idx++) {
-
-		// Get the neighbours of the current face, and if any of the edges still
-		// need to have a neighbour assigned, look for them. We check this early
-		// to avoid iterating through the remaining faces
-		GLushort* f1Neighbours = neighbours[f1Idx].edges;
-		if (f1Neighbours[0] == kCC3FaceNoNeighbour ||
-			f1Neighbours[1] == kCC3FaceNoNeighbour ||
-			f1Neighbours[2] == kCC3FaceNoNeighbour) {
-
-			// For the current face, retrieve the vertex indices
-			GLushort* f1Vertices = [mesh faceIndicesAt: f1Idx].vertices;
-			
-			// Iterate through all the faces beyond the current face
-			for (int f2Idx = f1Idx + 1; f2Idx < faceCnt; f2Idx++) {
-
-				// Get the neighbours of the other face, and if any of the edges still
-				// need to have a neighbour assigned, see if any of the edges between
-				// the current face and other face match. We check for neighbours early
-				// to avoid iterating through all the face combinations.
-				GLushort* f2Neighbours = neighbours[f2Idx].edges;
-				if (f2Neighbours[0] == kCC3FaceNoNeighbour ||
-					f2Neighbours[1] == kCC3FaceNoNeighbour ||
-					f2Neighbours[2] == kCC3FaceNoNeighbour) {
-				
-					// For the other face, retrieve the vertex indices
-					GLushort* f2Vertices = [mesh faceIndicesAt: f2Idx].vertices;
-					
-					// Compare each edge of the current face with each edge of the other face
-					for (int f1EdgeIdx = 0; f1EdgeIdx < 3; f1EdgeIdx++) {
-						
-						// If this edge already has a neighbour, skip it
-						if (f1Neighbours[f1EdgeIdx] == (GLushort)kCC3FaceNoNeighbour) {
-							
-							// Get the end points of an edge of the current face
-							GLushort f1EdgeStart = f1Vertices[f1EdgeIdx];
-							GLushort f1EdgeEnd = f1Vertices[(f1EdgeIdx < 2) ? (f1EdgeIdx + 1) : 0];
-							
-							// Iterate each edge of other face and compare against current face edge
-							for (int f2EdgeIdx = 0; f2EdgeIdx < 3; f2EdgeIdx++) {
-								
-								// If this edge already has a neighbour, skip it
-								if (f2Neighbours[f2EdgeIdx] == (GLushort)kCC3FaceNoNeighbour) {
-									
-									// Get the end points of an edge of the other face
-									GLushort f2EdgeStart = f2Vertices[f2EdgeIdx];
-									GLushort f2EdgeEnd = f2Vertices[(f2EdgeIdx < 2) ? (f2EdgeIdx + 1) : 0];
-									
-									// If the two edges have the same endpoints, mark each as a neighbour of the other
-									if ((f1EdgeStart == f2EdgeStart && f1EdgeEnd == f2EdgeEnd) ||
-										(f1EdgeStart == f2EdgeEnd && f1EdgeEnd == f2EdgeStart) ){
-										f1Neighbours[f1EdgeIdx] = f2Idx;
-										f2Neighbours[f2EdgeIdx] = f1Idx;
-										LogCleanTrace(@"Matched face %@ with face %@",
-													  NSStringFromCC3FaceIndices(f1Indices),
-													  NSStringFromCC3FaceIndices(f2Indices));
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-			LogCleanTrace(@"Face %i has indices %@ and neighbours %@", f1Idx,
-						  NSStringFromCC3FaceIndices([mesh faceIndicesAt: f1Idx]),
-						  NSStringFromCC3FaceNeighbours(neighbours[f1Idx]));
-		}
-		
+	if ( !CC3FaceNeighboursPopulate(neighbours, faceIndices, sizeof(GLuint), faceCnt) ) {
+		LogError(@"%@ could not populate neighbours for %u faces", self, faceCnt);
+		free(faceIndices);
+		return;
+	}
+	
+	for (GLsizei faceIdx = 0; faceIdx < faceCnt; faceIdx++) {
+		LogCleanTrace(@"Face %i has indices (%u, %u, %u) and neighbours %@", faceIdx,
+					  faceIndices[faceIdx * 3], faceIndices[faceIdx * 3 + 1], faceIndices[faceIdx * 3 + 2],
+					  NSStringFromCC3FaceNeighbours(neighbours[faceIdx]));
 	}
+	free(faceIndices);
+
 	neighboursAreDirty = NO;
 	LogTrace(@"%@ finished building neighbours", self);
 }
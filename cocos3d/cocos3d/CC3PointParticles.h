@@ -278,6 +278,7 @@ static const CC3PointParticleVertexContent kCC3PointParticleContentSize		= 1 <<
 	BOOL isEmitting;
 	BOOL wasStarted;
 	BOOL verticesAreDirty;
+	BOOL particleNormalsAreDirty;
 }
 
 /**
@@ -1545,3 +1546,188 @@ static const CC3PointParticleVertexContent kCC3PointParticleContentSize		= 1 <<
 -(void) updateLife: (ccTime) dt;
 
 @end
+
+
+#pragma mark -
+#pragma mark CC3PointParticleStore
+
+/**
+ * CC3PointParticleStore holds the state of a collection of uniformly evolving particles
+ * as a structure of arrays, with one contiguous array for each component of each type
+ * of particle data. This layout lets the particles be updated in tight loops over each
+ * array, without any per-particle messaging, and lets the compiler vectorize those loops.
+ *
+ * The living particles occupy the first count elements of each array. Each particle
+ * moves, and changes color and size, uniformly, in the same way as a particle of type
+ * CC3UniformEvolutionParticle, and expires when its timeToLive drops to zero.
+ *
+ * All arrays are carved from a single block of memory, allocated with the
+ * CC3PointParticleStoreAllocate function and released with the
+ * CC3PointParticleStoreDeallocate function.
+ */
+typedef struct {
+	GLuint capacity;			/**< The number of particles the arrays have room for. */
+	GLuint count;				/**< The number of living particles, at the start of each array. */
+	GLfloat* locationX;			/**< The X component of the location of each particle. */
+	GLfloat* locationY;			/**< The Y component of the location of each particle. */
+	GLfloat* locationZ;			/**< The Z component of the location of each particle. */
+	GLfloat* velocityX;			/**< The X component of the velocity of each particle. */
+	GLfloat* velocityY;			/**< The Y component of the velocity of each particle. */
+	GLfloat* velocityZ;			/**< The Z component of the velocity of each particle. */
+	GLfloat* colorR;			/**< The red component of the color of each particle. */
+	GLfloat* colorG;			/**< The green component of the color of each particle. */
+	GLfloat* colorB;			/**< The blue component of the color of each particle. */
+	GLfloat* colorA;			/**< The alpha component of the color of each particle. */
+	GLfloat* colorVelocityR;	/**< The rate of change of the red component of the color of each particle. */
+	GLfloat* colorVelocityG;	/**< The rate of change of the green component of the color of each particle. */
+	GLfloat* colorVelocityB;	/**< The rate of change of the blue component of the color of each particle. */
+	GLfloat* colorVelocityA;	/**< The rate of change of the alpha component of the color of each particle. */
+	GLfloat* size;				/**< The nominal size of each particle. */
+	GLfloat* sizeVelocity;		/**< The rate of change of the size of each particle. */
+	ccTime* timeToLive;			/**< The remaining life of each particle. */
+} CC3PointParticleStore;
+
+/**
+ * Describes where each type of particle content lives in an interleaved vertex array.
+ * An offset of -1 indicates that the vertices do not contain that type of content.
+ */
+typedef struct {
+	GLvoid* vertices;			/**< The start of the vertex data. */
+	GLuint stride;				/**< The number of bytes between consecutive vertices. */
+	GLint locationOffset;		/**< The offset to the CC3Vector location within each vertex. */
+	GLint normalOffset;			/**< The offset to the CC3Vector normal within each vertex, or -1. */
+	GLint colorOffset;			/**< The offset to the ccColor4B color within each vertex, or -1. */
+	GLint sizeOffset;			/**< The offset to the GLfloat point size within each vertex, or -1. */
+	GLfloat sizeScale;			/**< The factor applied to each particle size as it is copied to the vertices. */
+} CC3PointParticleVertexLayout;
+
+/**
+ * Allocates the arrays of the specified store to hold the specified number of particles,
+ * releasing any arrays previously allocated, and sets the count of particles to zero.
+ * Returns whether the memory could be allocated.
+ */
+BOOL CC3PointParticleStoreAllocate(CC3PointParticleStore* store, GLuint capacity);
+
+/** Releases the arrays of the specified store. It is safe to invoke this more than once. */
+void CC3PointParticleStoreDeallocate(CC3PointParticleStore* store);
+
+/**
+ * Advances all of the living particles in the specified store by the specified interval.
+ *
+ * The interval is subtracted from the timeToLive of each particle, and each velocity is
+ * multiplied by the interval and added to the corresponding location, color and size.
+ * Color components are clamped to the range zero to one.
+ *
+ * Particles whose timeToLive drops to zero or below are not removed by this function.
+ * Use the CC3PointParticleStoreRemoveExpired function to remove them.
+ */
+void CC3PointParticleStoreUpdate(CC3PointParticleStore* store, ccTime dt);
+
+/**
+ * Removes all particles whose timeToLive is zero or less from the specified store,
+ * moving the remaining particles down, in their existing order, to fill the gaps.
+ * Returns the number of particles removed.
+ */
+GLuint CC3PointParticleStoreRemoveExpired(CC3PointParticleStore* store);
+
+/**
+ * Copies the location, color and size of the specified range of particles in the
+ * specified store into the vertices described by the specified layout. Particle N
+ * is copied to vertex N. Normals are not copied.
+ */
+void CC3PointParticleStoreCopyToVertices(const CC3PointParticleStore* store,
+										 GLuint firstParticle,
+										 GLuint particleCount,
+										 const CC3PointParticleVertexLayout* layout);
+
+/** Returns the location of the particle at the specified index in the specified store. */
+static inline CC3Vector CC3PointParticleStoreLocationAt(const CC3PointParticleStore* store, GLuint index) {
+	return cc3v(store->locationX[index], store->locationY[index], store->locationZ[index]);
+}
+
+/** Sets the location of the particle at the specified index in the specified store. */
+static inline void CC3PointParticleStoreSetLocation(CC3PointParticleStore* store, GLuint index, CC3Vector aLocation) {
+	store->locationX[index] = aLocation.x;
+	store->locationY[index] = aLocation.y;
+	store->locationZ[index] = aLocation.z;
+}
+
+/** Sets the velocity of the particle at the specified index in the specified store. */
+static inline void CC3PointParticleStoreSetVelocity(CC3PointParticleStore* store, GLuint index, CC3Vector aVelocity) {
+	store->velocityX[index] = aVelocity.x;
+	store->velocityY[index] = aVelocity.y;
+	store->velocityZ[index] = aVelocity.z;
+}
+
+/** Sets the color of the particle at the specified index in the specified store. */
+static inline void CC3PointParticleStoreSetColor4F(CC3PointParticleStore* store, GLuint index, ccColor4F aColor) {
+	store->colorR[index] = aColor.r;
+	store->colorG[index] = aColor.g;
+	store->colorB[index] = aColor.b;
+	store->colorA[index] = aColor.a;
+}
+
+/** Sets the rate of change of the color of the particle at the specified index in the specified store. */
+static inline void CC3PointParticleStoreSetColorVelocity(CC3PointParticleStore* store, GLuint index, ccColor4F aColorVelocity) {
+	store->colorVelocityR[index] = aColorVelocity.r;
+	store->colorVelocityG[index] = aColorVelocity.g;
+	store->colorVelocityB[index] = aColorVelocity.b;
+	store->colorVelocityA[index] = aColorVelocity.a;
+}
+
+
+#pragma mark -
+#pragma mark CC3PointParticleStoreEmitter
+
+/**
+ * CC3PointParticleStoreEmitter is a CC3MortalPointParticleEmitter that does not use
+ * particle objects. Instead, the state of all of its particles is held in a single
+ * CC3PointParticleStore, as contiguous arrays of locations, velocities, colors, sizes,
+ * and remaining lifetimes.
+ *
+ * On each update, all particles are advanced in one pass over those arrays, expired
+ * particles are removed in bulk, and the locations, colors and sizes of the particles
+ * are copied directly into the interleaved vertex data of the particle mesh. This avoids
+ * the per-particle message dispatching of the object-based emitters, and makes this
+ * emitter suitable for large numbers of particles.
+ *
+ * The particles behave in the same way as particles of type CC3UniformEvolutionParticle.
+ * When a particle is emitted, its timeToLive is set to a random value between the values
+ * of the minParticleLifeSpan and maxParticleLifeSpan properties, its location, velocity,
+ * and color and size velocities are set to zero, and its color and size are set to the
+ * diffuseColor and particleSize properties of this emitter. The initializeParticleAt:
+ * method is then invoked to allow subclasses to initialize the particle further.
+ *
+ * Because there are no particle objects, the particles property of this emitter is
+ * always empty, and the initializeParticle: and initializeMortalParticle: methods
+ * are not invoked. Subclasses override initializeParticleAt: instead.
+ */
+@interface CC3PointParticleStoreEmitter : CC3MortalPointParticleEmitter {
+	CC3PointParticleStore particleStore;
+}
+
+/**
+ * The store holding the state of the particles of this emitter.
+ *
+ * The arrays of the store are allocated by the populateForMaxParticles:... methods.
+ * Particle data may be changed directly, and will be copied to the mesh on the next update.
+ */
+@property(nonatomic, readonly) CC3PointParticleStore* particleStore;
+
+/**
+ * Template method that initializes the particle at the specified index in the particleStore.
+ * This method is invoked automatically from the emitParticle method, after the standard
+ * initial state of the particle has been set, and just before the particle is emitted.
+ *
+ * This implementation does nothing. Subclasses override to set the location, velocity,
+ * color, size and timeToLive of the particle, using the CC3PointParticleStore functions.
+ * To abort the emission of the particle, set its timeToLive to zero or a negative value.
+ * As with CC3PointParticleStoreRemoveExpired, a particle whose timeToLive is zero or
+ * less is considered expired.
+ *
+ * This method is invoked automatically by the emitter when a particle is emitted.
+ * Usually the application never has need to invoke this method directly.
+ */
+-(void) initializeParticleAt: (GLuint) particleIndex;
+
+@end
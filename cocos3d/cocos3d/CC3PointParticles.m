@@ -60,6 +60,7 @@
 -(void) removeParticleAtIndex: (GLuint) anIndex;
 -(void) setParticleNormal: (CC3PointParticle*) pointParticle;
 -(void) updateParticleNormals: (CC3NodeUpdatingVisitor*) visitor;
+-(void) pointParticleNormalsToCameraAt: (CC3Vector) camLoc;
 -(void) updateParticleMesh;
 -(void) markVerticesDirty;
 -(GLfloat) normalizeParticleSizeToDevice: (GLfloat) aSize;
@@ -496,13 +497,38 @@
 			// Get the direction to the camera and transform it to local coordinates
 			CC3Vector camDir = CC3VectorDifference(gCamLoc, self.globalLocation);
 			camDir = [self.transformMatrixInverted transformDirection: camDir];
-			for (CC3PointParticle* p in particles) {
-				[p pointNormalToCameraAt: camDir];
-			}
+			[self pointParticleNormalsToCameraAt: camDir];
 		}
 	}
 }
 
+/**
+ * Points the normal vector of each particle to the camera, which is at the specified
+ * location, expressed in terms of the local coordinate system of this emitter.
+ *
+ * All of the normals are calculated in a single pass directly over the vertex content,
+ * rather than through each particle. Since only the normals change, the vertices are not
+ * marked as dirty. Instead, only the normals are marked for updating in the GL buffer.
+ */
+-(void) pointParticleNormalsToCameraAt: (CC3Vector) camLoc {
+	CC3PointParticleMesh* pm = self.particleMesh;
+	CC3VertexLocations* vLocs = pm.vertexLocations;
+	CC3VertexNormals* vNorms = pm.vertexNormals;
+	if ( !(vLocs.elements && vNorms.elements) ) return;
+
+	GLsizei locStride = vLocs.elementStride;
+	GLsizei normStride = vNorms.elementStride;
+	GLbyte* pLoc = (GLbyte*)vLocs.elements + vLocs.elementOffset;
+	GLbyte* pNorm = (GLbyte*)vNorms.elements + vNorms.elementOffset;
+	for (GLuint pIdx = 0; pIdx < particleCount; pIdx++) {
+		CC3Vector* pLocation = (CC3Vector*)pLoc;
+		*(CC3Vector*)pNorm = CC3VectorNormalize(CC3VectorDifference(camLoc, *pLocation));
+		pLoc += locStride;
+		pNorm += normStride;
+	}
+	particleNormalsAreDirty = YES;
+}
+
 /**
  * Remove the current particle from the active particles, but keep it cached
  * for future use. To do this, decrement the particle count and swap the current
@@ -526,6 +552,8 @@
 /**
  * Updates the particle mesh by updating the particle count, copying the particle
  * vertex data to the GL buffer, and updating the bounding volume of this node.
+ *
+ * If only the particle normals have changed, only the normals are copied to the GL buffer.
  */
 -(void) updateParticleMesh {
 	CC3PointParticleMesh* pm = self.particleMesh;
@@ -535,7 +563,11 @@
 		[pm updateGLBuffers];
 		[self rebuildBoundingVolume];
 		verticesAreDirty = NO;
+	} else if (particleNormalsAreDirty) {
+		LogTrace(@"%@ updating normals of %i particles", self, particleCount);
+		[pm.vertexNormals updateGLBufferStartingAt: 0 forLength: particleCount];
 	}
+	particleNormalsAreDirty = NO;
 }
 
 /** If transitioning to emitting from not, mark as such and reset timers. */
@@ -1206,3 +1238,285 @@ static GLfloat deviceScaleFactor = 0.0f;
 }
 
 @end
+
+
+#pragma mark -
+#pragma mark CC3PointParticleStore
+
+/** The number of GLfloat arrays in a CC3PointParticleStore. */
+#define kCC3PointParticleStoreArrayCount	17
+
+BOOL CC3PointParticleStoreAllocate(CC3PointParticleStore* store, GLuint capacity) {
+	CC3PointParticleStoreDeallocate(store);
+	if ( !capacity ) return YES;
+
+	GLfloat* block = malloc(capacity * kCC3PointParticleStoreArrayCount * sizeof(GLfloat));
+	if ( !block ) return NO;
+
+	GLfloat** arrays[kCC3PointParticleStoreArrayCount] = {
+		&store->locationX, &store->locationY, &store->locationZ,
+		&store->velocityX, &store->velocityY, &store->velocityZ,
+		&store->colorR, &store->colorG, &store->colorB, &store->colorA,
+		&store->colorVelocityR, &store->colorVelocityG, &store->colorVelocityB, &store->colorVelocityA,
+		&store->size, &store->sizeVelocity, (GLfloat**)&store->timeToLive,
+	};
+	for (GLuint i = 0; i < kCC3PointParticleStoreArrayCount; i++) {
+		*arrays[i] = block + (i * capacity);
+	}
+	store->capacity = capacity;
+	store->count = 0;
+	return YES;
+}
+
+void CC3PointParticleStoreDeallocate(CC3PointParticleStore* store) {
+	free(store->locationX);		// Start of the single block holding all the arrays
+	memset(store, 0, sizeof(CC3PointParticleStore));
+}
+
+/** Adds the product of the velocities and the interval to the values, in one vectorizable pass. */
+static inline void CC3PointParticleStoreIntegrate(GLfloat* restrict values,
+												  const GLfloat* restrict velocities,
+												  GLuint count, GLfloat dt) {
+	for (GLuint i = 0; i < count; i++) {
+		values[i] = values[i] + (velocities[i] * dt);
+	}
+}
+
+/** Adds the product of the velocities and the interval to the color components, clamping each to the range 0 to 1. */
+static inline void CC3PointParticleStoreIntegrateColor(GLfloat* restrict values,
+													   const GLfloat* restrict velocities,
+													   GLuint count, GLfloat dt) {
+	for (GLuint i = 0; i < count; i++) {
+		GLfloat v = values[i] + (velocities[i] * dt);
+		values[i] = MIN(MAX(v, 0.0f), 1.0f);
+	}
+}
+
+void CC3PointParticleStoreUpdate(CC3PointParticleStore* store, ccTime dt) {
+	GLuint pCnt = store->count;
+	ccTime* ttl = store->timeToLive;
+	for (GLuint i = 0; i < pCnt; i++) {
+		ttl[i] -= dt;
+	}
+	CC3PointParticleStoreIntegrate(store->locationX, store->velocityX, pCnt, dt);
+	CC3PointParticleStoreIntegrate(store->locationY, store->velocityY, pCnt, dt);
+	CC3PointParticleStoreIntegrate(store->locationZ, store->velocityZ, pCnt, dt);
+	CC3PointParticleStoreIntegrateColor(store->colorR, store->colorVelocityR, pCnt, dt);
+	CC3PointParticleStoreIntegrateColor(store->colorG, store->colorVelocityG, pCnt, dt);
+	CC3PointParticleStoreIntegrateColor(store->colorB, store->colorVelocityB, pCnt, dt);
+	CC3PointParticleStoreIntegrateColor(store->colorA, store->colorVelocityA, pCnt, dt);
+	CC3PointParticleStoreIntegrate(store->size, store->sizeVelocity, pCnt, dt);
+}
+
+GLuint CC3PointParticleStoreRemoveExpired(CC3PointParticleStore* store) {
+	GLuint pCnt = store->count;
+	const ccTime* ttl = store->timeToLive;
+	
+	// Skip the leading run of living particles, which stay where they are
+	GLuint srcIdx = 0;
+	while (srcIdx < pCnt && ttl[srcIdx] > 0.0f) srcIdx++;
+	if (srcIdx == pCnt) return 0;
+
+	// Slide the remaining living particles down over the gaps left by expired particles
+	GLfloat* arrays[kCC3PointParticleStoreArrayCount] = {
+		store->locationX, store->locationY, store->locationZ,
+		store->velocityX, store->velocityY, store->velocityZ,
+		store->colorR, store->colorG, store->colorB, store->colorA,
+		store->colorVelocityR, store->colorVelocityG, store->colorVelocityB, store->colorVelocityA,
+		store->size, store->sizeVelocity, (GLfloat*)store->timeToLive,
+	};
+	GLuint dstIdx = srcIdx;
+	for (; srcIdx < pCnt; srcIdx++) {
+		if (ttl[srcIdx] > 0.0f) {
+			for (GLuint a = 0; a < kCC3PointParticleStoreArrayCount; a++) {
+				arrays[a][dstIdx] = arrays[a][srcIdx];
+			}
+			dstIdx++;
+		}
+	}
+	store->count = dstIdx;
+	return pCnt - dstIdx;
+}
+
+void CC3PointParticleStoreCopyToVertices(const CC3PointParticleStore* store,
+										 GLuint firstParticle,
+										 GLuint particleCount,
+										 const CC3PointParticleVertexLayout* layout) {
+	GLuint endParticle = firstParticle + particleCount;
+	GLuint stride = layout->stride;
+	GLbyte* vtx = (GLbyte*)layout->vertices + (firstParticle * stride);
+
+	GLbyte* pLoc = vtx + layout->locationOffset;
+	for (GLuint i = firstParticle; i < endParticle; i++, pLoc += stride) {
+		*(CC3Vector*)pLoc = CC3PointParticleStoreLocationAt(store, i);
+	}
+
+	if (layout->colorOffset >= 0) {
+		GLbyte* pColor = vtx + layout->colorOffset;
+		for (GLuint i = firstParticle; i < endParticle; i++, pColor += stride) {
+			ccColor4B* c = (ccColor4B*)pColor;
+			c->r = CCColorByteFromFloat(store->colorR[i]);
+			c->g = CCColorByteFromFloat(store->colorG[i]);
+			c->b = CCColorByteFromFloat(store->colorB[i]);
+			c->a = CCColorByteFromFloat(store->colorA[i]);
+		}
+	}
+
+	if (layout->sizeOffset >= 0) {
+		GLbyte* pSize = vtx + layout->sizeOffset;
+		GLfloat sizeScale = layout->sizeScale;
+		for (GLuint i = firstParticle; i < endParticle; i++, pSize += stride) {
+			*(GLfloat*)pSize = store->size[i] * sizeScale;
+		}
+	}
+}
+
+
+#pragma mark -
+#pragma mark CC3PointParticleStoreEmitter
+
+@interface CC3PointParticleStoreEmitter (TemplateMethods)
+-(CC3PointParticleVertexLayout) particleVertexLayout;
+-(void) copyParticlesToVerticesFrom: (GLuint) firstParticle forCount: (GLuint) pCount;
+@end
+
+@implementation CC3PointParticleStoreEmitter
+
+-(void) dealloc {
+	CC3PointParticleStoreDeallocate(&particleStore);
+	[super dealloc];
+}
+
+-(CC3PointParticleStore*) particleStore { return &particleStore; }
+
+
+#pragma mark Allocation and initialization
+
+-(id) initWithTag: (GLuint) aTag withName: (NSString*) aName {
+	if ( (self = [super initWithTag: aTag withName: aName]) ) {
+		memset(&particleStore, 0, sizeof(CC3PointParticleStore));
+	}
+	return self;
+}
+
+-(void) populateForMaxParticles: (GLuint) numParticles
+						 ofType: (id) aParticleClass
+					 containing: (CC3PointParticleVertexContent) contentTypes {
+	[super populateForMaxParticles: numParticles ofType: aParticleClass containing: contentTypes];
+	if ( !CC3PointParticleStoreAllocate(&particleStore, maxParticles) ) {
+		LogError(@"%@ could not allocate storage for %u particles", self, maxParticles);
+		maxParticles = 0;
+	}
+}
+
+
+#pragma mark Updating
+
+/** Returns the layout of the particle content within the interleaved vertices of the mesh. */
+-(CC3PointParticleVertexLayout) particleVertexLayout {
+	CC3PointParticleMesh* pm = self.particleMesh;
+	CC3VertexLocations* vLocs = pm.vertexLocations;
+	CC3PointParticleVertexLayout layout;
+	layout.vertices = vLocs.elements;
+	layout.stride = vLocs.elementStride;
+	layout.locationOffset = vLocs.elementOffset;
+	layout.normalOffset = pm.hasNormals ? pm.vertexNormals.elementOffset : -1;
+	layout.colorOffset = pm.hasColors ? pm.vertexColors.elementOffset : -1;
+	layout.sizeOffset = pm.hasPointSizes ? pm.vertexPointSizes.elementOffset : -1;
+	layout.sizeScale = [self normalizeParticleSizeToDevice: 1.0f];
+	return layout;
+}
+
+-(void) copyParticlesToVerticesFrom: (GLuint) firstParticle forCount: (GLuint) pCount {
+	if ( !pCount ) return;
+	CC3PointParticleVertexLayout layout = self.particleVertexLayout;
+	CC3PointParticleStoreCopyToVertices(&particleStore, firstParticle, pCount, &layout);
+
+	// The store does not hold normals, so rather than leaving the normal of a particle behind
+	// when the particle moves to another slot, point the normal of each copied particle at the camera.
+	if (layout.normalOffset >= 0) {
+		CC3Vector camDir = CC3VectorDifference(self.activeCamera.globalLocation, self.globalLocation);
+		camDir = [self.transformMatrixInverted transformDirection: camDir];
+		GLbyte* pNorm = (GLbyte*)layout.vertices + (firstParticle * layout.stride) + layout.normalOffset;
+		GLuint endParticle = firstParticle + pCount;
+		for (GLuint pIdx = firstParticle; pIdx < endParticle; pIdx++, pNorm += layout.stride) {
+			CC3Vector pLoc = CC3PointParticleStoreLocationAt(&particleStore, pIdx);
+			*(CC3Vector*)pNorm = CC3VectorNormalize(CC3VectorDifference(camDir, pLoc));
+		}
+	}
+	[self markVerticesDirty];
+}
+
+/**
+ * Sets the standard initial state of the next particle in the store, invokes the
+ * initializeParticleAt: method, and if the particle was not aborted, adds it to
+ * the living particles and copies it into the mesh vertices.
+ */
+-(BOOL) emitParticle {
+	if (self.isFull) return NO;
+
+	GLuint pIdx = particleStore.count;
+	CC3PointParticleStoreSetLocation(&particleStore, pIdx, kCC3VectorZero);
+	CC3PointParticleStoreSetVelocity(&particleStore, pIdx, kCC3VectorZero);
+	CC3PointParticleStoreSetColor4F(&particleStore, pIdx, self.diffuseColor);
+	CC3PointParticleStoreSetColorVelocity(&particleStore, pIdx, (ccColor4F){0.0f, 0.0f, 0.0f, 0.0f});
+	particleStore.size[pIdx] = particleSize;
+	particleStore.sizeVelocity[pIdx] = 0.0f;
+	particleStore.timeToLive[pIdx] = CC3RandomFloatBetween(minParticleLifeSpan, maxParticleLifeSpan);
+
+	[self initializeParticleAt: pIdx];
+	if (particleStore.timeToLive[pIdx] <= 0.0f) return NO;		// Expired, as in CC3PointParticleStoreRemoveExpired
+
+	particleStore.count++;
+	particleCount = particleStore.count;
+	[self copyParticlesToVerticesFrom: pIdx forCount: 1];
+	return YES;
+}
+
+-(void) initializeParticleAt: (GLuint) particleIndex {}
+
+/** Advances all the particles in one pass, removes expired particles, and copies the rest to the mesh. */
+-(void) updateParticles: (ccTime) dt {
+	if ( !particleCount ) return;
+
+	CC3PointParticleStoreUpdate(&particleStore, dt);
+	CC3PointParticleStoreRemoveExpired(&particleStore);
+	particleCount = particleStore.count;
+	[self copyParticlesToVerticesFrom: 0 forCount: particleCount];
+	[self markVerticesDirty];		// Also covers the case where all particles expired
+}
+
+/** Removes the particle by moving the last living particle into its place. */
+-(void) removeParticleAtIndex: (GLuint) anIndex {
+	if (anIndex >= particleStore.count) return;		// Also covers an empty store
+
+	GLuint lastIdx = particleStore.count - 1;
+	if (anIndex < lastIdx) {
+		CC3PointParticleStoreSetLocation(&particleStore, anIndex, CC3PointParticleStoreLocationAt(&particleStore, lastIdx));
+		particleStore.velocityX[anIndex] = particleStore.velocityX[lastIdx];
+		particleStore.velocityY[anIndex] = particleStore.velocityY[lastIdx];
+		particleStore.velocityZ[anIndex] = particleStore.velocityZ[lastIdx];
+		particleStore.colorR[anIndex] = particleStore.colorR[lastIdx];
+		particleStore.colorG[anIndex] = particleStore.colorG[lastIdx];
+		particleStore.colorB[anIndex] = particleStore.colorB[lastIdx];
+		particleStore.colorA[anIndex] = particleStore.colorA[lastIdx];
+		particleStore.colorVelocityR[anIndex] = particleStore.colorVelocityR[lastIdx];
+		particleStore.colorVelocityG[anIndex] = particleStore.colorVelocityG[lastIdx];
+		particleStore.colorVelocityB[anIndex] = particleStore.colorVelocityB[lastIdx];
+		particleStore.colorVelocityA[anIndex] = particleStore.colorVelocityA[lastIdx];
+		particleStore.size[anIndex] = particleStore.size[lastIdx];
+		particleStore.sizeVelocity[anIndex] = particleStore.sizeVelocity[lastIdx];
+		particleStore.timeToLive[anIndex] = particleStore.timeToLive[lastIdx];
+		[self copyParticlesToVerticesFrom: anIndex forCount: 1];
+	}
+	particleStore.count = lastIdx;
+	particleCount = lastIdx;
+	[self markVerticesDirty];
+}
+
+-(void) stop {
+	[super stop];
+	particleStore.count = 0;
+}
+
+@end
@@ -38,6 +38,88 @@
 static const GLfloat kCC3DefaultShadowVolumeVertexOffsetFactor = 0.001;
 
 
+#pragma mark -
+#pragma mark Shadow volume functions
+
+/**
+ * Describes the faces of a shadow-casting mesh, as flat arrays of data, for use by the
+ * shadow volume functions. All data is in the local coordinate system of the shadow caster.
+ */
+typedef struct {
+	const GLvoid* vertexLocations;				/**< The vertex locations, each starting with the three floats of a CC3Vector. */
+	GLuint vertexStride;						/**< The number of bytes between vertex locations, or zero if tightly packed. */
+	const CC3FaceIndices* faceIndices;			/**< The vertex indices of each face, or NULL if each face uses the next three vertex locations. */
+	const CC3Plane* facePlanes;					/**< The plane of each face. */
+	const CC3FaceNeighbours* faceNeighbours;	/**< The neighbouring faces of each face. */
+	GLuint faceCount;							/**< The number of faces. */
+} CC3ShadowCasterFaces;
+
+/** Describes how the shadow volume functions construct a shadow volume from a shadow caster. */
+typedef struct {
+	CC3Vector4 lightPosition;		/**< The homogeneous location of the light, in the local coordinates of the shadow caster. */
+	CC3Vector4 vertexOffset;		/**< Added to each shadow caster vertex, to move the shadow volume away from the light. */
+	GLfloat expansionLimitFactor;	/**< How far the sides of a capped shadow from a locational light may expand. */
+	BOOL shouldShadowFrontFaces;	/**< Whether the faces of the shadow caster that face the light cast shadows. */
+	BOOL shouldShadowBackFaces;		/**< Whether the faces of the shadow caster that face away from the light cast shadows. */
+	BOOL shouldAddEndCaps;			/**< Whether the shadow casting faces are added to close off the near end of the volume. */
+	BOOL shouldCapFarEnd;			/**< Whether the sides from a locational light are limited in size so they can be capped at infinity. */
+	BOOL shouldDrawTerminator;		/**< Whether only the terminator edges are added, as lines, instead of the shadow volume. */
+} CC3ShadowVolumeSettings;
+
+/**
+ * Populates the facePlanes array with the plane of each of the faces described by the
+ * vertexLocations, vertexStride, faceIndices and faceCount members of the scFaces struct.
+ * The facePlanes member of scFaces is ignored, and the facePlanes array may be the one it
+ * points to.
+ *
+ * Each plane is calculated in the same way as the CC3FacePlane function.
+ */
+void CC3ShadowCasterFacesPopulatePlanes(const CC3ShadowCasterFaces* scFaces, CC3Plane* facePlanes);
+
+/**
+ * Classifies each of the specified faces as illuminated or dark, relative to the specified
+ * homogeneous light location, and records the result as a bitmask in the litFaces array.
+ *
+ * Bit (faceIndex % 32) of litFaces[faceIndex / 32] is set if the face is illuminated, with
+ * the same result as the CC3Vector4IsInFrontOfPlane function. The litFaces array must have
+ * room for ((faceCount + 31) / 32) elements. Four faces are classified at a time, using the
+ * vector instructions of the processor, where they are available.
+ */
+void CC3ShadowCasterFacesClassify(const CC3Plane* facePlanes, GLuint faceCount,
+								  CC3Vector4 lightPosition, GLuint* litFaces);
+
+/**
+ * Returns the number of vertices that the CC3ShadowVolumePopulate function will add for the
+ * specified shadow caster faces, classified by the CC3ShadowCasterFacesClassify function into
+ * the specified litFaces bitmask, using the specified settings.
+ *
+ * Only the face neighbours and litFaces are read, so this is fast enough to be used to size
+ * the vertex array before populating it.
+ */
+GLuint CC3ShadowVolumeVertexCount(const CC3ShadowCasterFaces* scFaces,
+								  const GLuint* litFaces,
+								  const CC3ShadowVolumeSettings* settings);
+
+/**
+ * Populates the specified array of homogeneous vertex locations with the shadow volume
+ * of the specified shadow caster faces, classified by the CC3ShadowCasterFacesClassify
+ * function into the specified litFaces bitmask, using the specified settings, and returns
+ * the number of vertices added.
+ *
+ * The vertices form triangles, or lines if the shouldDrawTerminator member of the settings
+ * is YES. The svVertices array must have room for the number of vertices returned by the
+ * CC3ShadowVolumeVertexCount function.
+ *
+ * Terminator edges are the edges between an illuminated and a dark face, plus any edges
+ * without a neighbouring face, of faces that cast shadows. Each terminator edge is extruded
+ * away from the light, and each shadow casting face is optionally added as an end cap.
+ */
+GLuint CC3ShadowVolumePopulate(CC3Vector4* svVertices,
+							   const CC3ShadowCasterFaces* scFaces,
+							   const GLuint* litFaces,
+							   const CC3ShadowVolumeSettings* settings);
+
+
 #pragma mark -
 #pragma mark CC3ShadowVolumeMeshNode
 
@@ -74,6 +156,8 @@ static const GLfloat kCC3DefaultShadowVolumeVertexOffsetFactor = 0.001;
 	BOOL shouldShadowBackFaces;
 	BOOL useDepthFailAlgorithm;
 	BOOL shouldAddEndCapsOnlyWhenNeeded;
+	GLvoid* faceWorkspace;
+	size_t faceWorkspaceLength;
 }
 
 /**
@@ -34,6 +34,218 @@
 #import "CC3ParametricMeshNodes.h"
 #import "CC3OpenGLES11Engine.h"
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CC3_SHADOW_VOLUME_NEON
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define CC3_SHADOW_VOLUME_SSE
+#endif
+
+
+#pragma mark -
+#pragma mark Shadow volume functions
+
+/** Returns the location of the specified vertex of the specified shadow caster face. */
+static inline CC3Vector CC3ShadowCasterVertexAt(const CC3ShadowCasterFaces* scFaces,
+												GLuint faceIdx, GLuint faceVtxIdx) {
+	GLuint vtxIdx = scFaces->faceIndices
+						? scFaces->faceIndices[faceIdx].vertices[faceVtxIdx]
+						: (faceIdx * 3 + faceVtxIdx);
+	GLuint vtxStride = scFaces->vertexStride ? scFaces->vertexStride : sizeof(CC3Vector);
+	return *(const CC3Vector*)((const GLbyte*)scFaces->vertexLocations + (vtxIdx * vtxStride));
+}
+
+/** Returns whether the specified face is marked as illuminated in the specified bitmask. */
+static inline BOOL CC3ShadowCasterFaceIsLit(const GLuint* litFaces, GLuint faceIdx) {
+	return (litFaces[faceIdx >> 5] >> (faceIdx & 31)) & 1;
+}
+
+void CC3ShadowCasterFacesPopulatePlanes(const CC3ShadowCasterFaces* scFaces, CC3Plane* facePlanes) {
+	GLuint faceCnt = scFaces->faceCount;
+	for (GLuint faceIdx = 0; faceIdx < faceCnt; faceIdx++) {
+		facePlanes[faceIdx] = CC3PlaneFromLocations(CC3ShadowCasterVertexAt(scFaces, faceIdx, 0),
+													CC3ShadowCasterVertexAt(scFaces, faceIdx, 1),
+													CC3ShadowCasterVertexAt(scFaces, faceIdx, 2));
+	}
+}
+
+void CC3ShadowCasterFacesClassify(const CC3Plane* facePlanes, GLuint faceCount,
+								  CC3Vector4 lightPosition, GLuint* litFaces) {
+	memset(litFaces, 0, ((faceCount + 31) >> 5) * sizeof(GLuint));
+
+	// Classify four faces at a time, by transposing four planes into vectors of their
+	// a, b, c & d components. The dot products with the light are summed in the same
+	// order as CC3Vector4Dot, so each face is classified exactly as it is one at a time.
+	GLuint faceIdx = 0;
+#if defined(CC3_SHADOW_VOLUME_SSE)
+	__m128 lx = _mm_set1_ps(lightPosition.x);
+	__m128 ly = _mm_set1_ps(lightPosition.y);
+	__m128 lz = _mm_set1_ps(lightPosition.z);
+	__m128 lw = _mm_set1_ps(lightPosition.w);
+	__m128 zero = _mm_setzero_ps();
+	for (; faceIdx + 4 <= faceCount; faceIdx += 4) {
+		__m128 a = _mm_loadu_ps(&facePlanes[faceIdx].a);
+		__m128 b = _mm_loadu_ps(&facePlanes[faceIdx + 1].a);
+		__m128 c = _mm_loadu_ps(&facePlanes[faceIdx + 2].a);
+		__m128 d = _mm_loadu_ps(&facePlanes[faceIdx + 3].a);
+		_MM_TRANSPOSE4_PS(a, b, c, d);
+		__m128 dot = _mm_add_ps(_mm_mul_ps(a, lx), _mm_mul_ps(b, ly));
+		dot = _mm_add_ps(dot, _mm_mul_ps(c, lz));
+		dot = _mm_add_ps(dot, _mm_mul_ps(d, lw));
+		GLuint litBits = (GLuint)_mm_movemask_ps(_mm_cmpgt_ps(dot, zero));
+		litFaces[faceIdx >> 5] |= litBits << (faceIdx & 31);
+	}
+#elif defined(CC3_SHADOW_VOLUME_NEON)
+	static const uint32_t laneBits[4] = { 1, 2, 4, 8 };
+	uint32x4_t laneMask = vld1q_u32(laneBits);
+	float32x4_t zero = vdupq_n_f32(0.0f);
+	for (; faceIdx + 4 <= faceCount; faceIdx += 4) {
+		float32x4x4_t p = vld4q_f32(&facePlanes[faceIdx].a);
+		float32x4_t dot = vaddq_f32(vmulq_n_f32(p.val[0], lightPosition.x),
+									vmulq_n_f32(p.val[1], lightPosition.y));
+		dot = vaddq_f32(dot, vmulq_n_f32(p.val[2], lightPosition.z));
+		dot = vaddq_f32(dot, vmulq_n_f32(p.val[3], lightPosition.w));
+		uint32x4_t lanes = vandq_u32(vcgtq_f32(dot, zero), laneMask);
+		uint32x2_t pairs = vorr_u32(vget_low_u32(lanes), vget_high_u32(lanes));
+		GLuint litBits = vget_lane_u32(pairs, 0) | vget_lane_u32(pairs, 1);
+		litFaces[faceIdx >> 5] |= litBits << (faceIdx & 31);
+	}
+#endif
+	for (; faceIdx < faceCount; faceIdx++) {
+		if (CC3Vector4IsInFrontOfPlane(lightPosition, facePlanes[faceIdx])) {
+			litFaces[faceIdx >> 5] |= 1u << (faceIdx & 31);
+		}
+	}
+}
+
+/**
+ * Adds the shadow volume of the specified faces to the specified vertex array, and returns
+ * the number of vertices added. If svVertices is NULL, only the vertices are counted, and
+ * the vertex locations of the faces are not read.
+ *
+ * The faces and edges are visited in order, and each shadow volume face is added with the
+ * same winding as the dark face of the terminator edge it extrudes.
+ */
+static GLuint CC3ShadowVolumeAddVertices(CC3Vector4* svVertices,
+										 const CC3ShadowCasterFaces* scFaces,
+										 const GLuint* litFaces,
+										 const CC3ShadowVolumeSettings* settings) {
+	CC3Vector4 lightPos = settings->lightPosition;
+	CC3Vector4 vtxOffset = settings->vertexOffset;
+	CC3Vector4 dirFarLoc = CC3Vector4HomogeneousNegate(lightPos);
+	BOOL isDirectionalLight = CC3Vector4IsDirectional(lightPos);
+	GLuint edgeVtxCount = settings->shouldDrawTerminator ? 2
+							: (isDirectionalLight ? 3
+							   : (settings->shouldCapFarEnd ? 9 : 6));
+	GLuint svVtxIdx = 0;
+	
+	GLuint faceCnt = scFaces->faceCount;
+	for (GLuint faceIdx = 0; faceIdx < faceCnt; faceIdx++) {
+		BOOL isFaceLit = CC3ShadowCasterFaceIsLit(litFaces, faceIdx);
+		BOOL isShadowing = isFaceLit ? settings->shouldShadowFrontFaces : settings->shouldShadowBackFaces;
+		BOOL isCapping = settings->shouldAddEndCaps &&
+						 (isFaceLit ? settings->shouldShadowBackFaces : settings->shouldShadowFrontFaces);
+		
+		// Find the terminator edges of this face. An edge is a terminator edge if it has no
+		// neighbour and the face casts a shadow, or if the neighbour has the opposite illumination.
+		// Each edge between two faces is only considered from the face with the lower index.
+		const GLuint* neighbourEdges = scFaces->faceNeighbours[faceIdx].edges;
+		BOOL isTerminatorEdge[3];
+		BOOL hasTerminatorEdge = NO;
+		for (int edgeIdx = 0; edgeIdx < 3; edgeIdx++) {
+			GLuint neighbourFaceIdx = neighbourEdges[edgeIdx];
+			if (neighbourFaceIdx == kCC3FaceNoNeighbour) {
+				isTerminatorEdge[edgeIdx] = isShadowing;
+			} else if (neighbourFaceIdx > faceIdx) {
+				isTerminatorEdge[edgeIdx] = (CC3ShadowCasterFaceIsLit(litFaces, neighbourFaceIdx) != isFaceLit);
+			} else {
+				isTerminatorEdge[edgeIdx] = NO;
+			}
+			hasTerminatorEdge |= isTerminatorEdge[edgeIdx];
+		}
+		
+		if ( !svVertices ) {
+			if (isCapping) svVtxIdx += 3;
+			for (int edgeIdx = 0; edgeIdx < 3; edgeIdx++) {
+				if (isTerminatorEdge[edgeIdx]) svVtxIdx += edgeVtxCount;
+			}
+			continue;
+		}
+		if ( !(isCapping || hasTerminatorEdge) ) continue;
+		
+		// Convert the face to homogeneous locations, nudged away from the light
+		CC3Vector4 vertices4d[3];
+		for (int faceVtxIdx = 0; faceVtxIdx < 3; faceVtxIdx++) {
+			vertices4d[faceVtxIdx] = CC3Vector4Add(CC3Vector4FromCC3Vector(CC3ShadowCasterVertexAt(scFaces, faceIdx, faceVtxIdx), 1.0f),
+												   vtxOffset);
+		}
+		
+		// The near end cap has the winding of the face if it is lit, and the opposite if it is dark
+		if (isCapping) {
+			svVertices[svVtxIdx++] = vertices4d[0];
+			svVertices[svVtxIdx++] = vertices4d[isFaceLit ? 1 : 2];
+			svVertices[svVtxIdx++] = vertices4d[isFaceLit ? 2 : 1];
+		}
+		
+		for (int edgeIdx = 0; edgeIdx < 3; edgeIdx++) {
+			if ( !isTerminatorEdge[edgeIdx] ) continue;
+			
+			int nextIdx = (edgeIdx < 2) ? (edgeIdx + 1) : 0;
+			CC3Vector4 edgeStartLoc = vertices4d[isFaceLit ? edgeIdx : nextIdx];
+			CC3Vector4 edgeEndLoc = vertices4d[isFaceLit ? nextIdx : edgeIdx];
+			
+			if (settings->shouldDrawTerminator) {
+				svVertices[svVtxIdx++] = edgeStartLoc;
+				svVertices[svVtxIdx++] = edgeEndLoc;
+			} else if (isDirectionalLight) {
+				// A single triangle out to the point at infinity opposite the light
+				svVertices[svVtxIdx++] = edgeStartLoc;
+				svVertices[svVtxIdx++] = dirFarLoc;
+				svVertices[svVtxIdx++] = edgeEndLoc;
+			} else {
+				// Two triangles extending the edge away from the light, either to infinity, or to
+				// a limited distance, from which the sides continue out in parallel to be capped
+				CC3Vector4 farStartLoc, farEndLoc;
+				if (settings->shouldCapFarEnd) {
+					farStartLoc = CC3Vector4Add(edgeStartLoc, CC3Vector4ScaleUniform(CC3Vector4Difference(edgeStartLoc, lightPos),
+																					 settings->expansionLimitFactor));
+					farEndLoc = CC3Vector4Add(edgeEndLoc, CC3Vector4ScaleUniform(CC3Vector4Difference(edgeEndLoc, lightPos),
+																				 settings->expansionLimitFactor));
+				} else {
+					farStartLoc = CC3Vector4Difference(edgeStartLoc, lightPos);
+					farEndLoc = CC3Vector4Difference(edgeEndLoc, lightPos);
+				}
+				svVertices[svVtxIdx++] = edgeStartLoc;
+				svVertices[svVtxIdx++] = farStartLoc;
+				svVertices[svVtxIdx++] = farEndLoc;
+				svVertices[svVtxIdx++] = edgeStartLoc;
+				svVertices[svVtxIdx++] = farEndLoc;
+				svVertices[svVtxIdx++] = edgeEndLoc;
+				if (settings->shouldCapFarEnd) {
+					svVertices[svVtxIdx++] = farStartLoc;
+					svVertices[svVtxIdx++] = dirFarLoc;
+					svVertices[svVtxIdx++] = farEndLoc;
+				}
+			}
+		}
+	}
+	return svVtxIdx;
+}
+
+GLuint CC3ShadowVolumeVertexCount(const CC3ShadowCasterFaces* scFaces,
+								  const GLuint* litFaces,
+								  const CC3ShadowVolumeSettings* settings) {
+	return CC3ShadowVolumeAddVertices(NULL, scFaces, litFaces, settings);
+}
+
+GLuint CC3ShadowVolumePopulate(CC3Vector4* svVertices,
+							   const CC3ShadowCasterFaces* scFaces,
+							   const GLuint* litFaces,
+							   const CC3ShadowVolumeSettings* settings) {
+	return CC3ShadowVolumeAddVertices(svVertices, scFaces, litFaces, settings);
+}
+
 
 @interface CC3Node (TemplateMethods)
 -(void) processUpdateBeforeTransform: (CC3NodeUpdatingVisitor*) visitor;
@@ -59,23 +271,8 @@
 -(void) populateShadowMesh;
 -(void) updateStencilAlgorithm;
 -(CC3Vector4) shadowVolumeVertexOffsetForLightAt: (CC3Vector4) localLightPos;
--(BOOL) addShadowVolumeCapFor: (BOOL) isFaceLit
-						 face: (CC3Vector4*) vertices
-				   forLightAt: (CC3Vector4) lightPosition
-			  startingAtIndex: (GLsizei*) shdwVtxIdx;
--(BOOL) addTerminatorLineFrom: (CC3Vector4) edgeStartLoc
-						   to: (CC3Vector4) edgeEndLoc
-			  startingAtIndex: (GLsizei*) shdwVtxIdx;
--(BOOL) addShadowVolumeSideFrom: (CC3Vector4) edgeStartLoc
-							 to: (CC3Vector4) edgeEndLoc
-		  forDirectionalLightAt: (CC3Vector4) lightPosition
-				startingAtIndex: (GLsizei*) shdwVtxIdx;
--(BOOL) addShadowVolumeSideFrom: (CC3Vector4) edgeStartLoc
-							 to: (CC3Vector4) edgeEndLoc
-						withCap: (BOOL) doesRequireCapping
-		   forLocationalLightAt: (CC3Vector4) lightPosition
-				startingAtIndex: (GLsizei*) shdwVtxIdx;
--(CC3Vector4) expand: (CC3Vector4) edgeLoc awayFromLocationalLightAt: (CC3Vector4) lightLoc;
+-(BOOL) populateShadowCasterFaces: (CC3ShadowCasterFaces*) scFaces litFaces: (GLuint**) litFaces;
+-(GLvoid*) faceWorkspaceOfLength: (size_t) length;
 -(void) drawToStencilIncrementing: (BOOL) isIncrementing
 					  withVisitor: (CC3NodeDrawingVisitor*) visitor;
 @property(nonatomic, readonly) CC3MeshNode* shadowCaster;
@@ -90,6 +287,7 @@
 -(void) dealloc {
 	[light removeShadow: self];		// Will also set light to nil
 	LogCleanTrace(@"Removed %@ from %@ leaving %i shadows", self, light, light.shadows.count);
+	free(faceWorkspace);
 	[super dealloc];
 }
 
@@ -214,6 +412,8 @@
 		shadowVolumeVertexOffsetFactor = 0;
 		shadowExpansionLimitFactor = 100;
 		self.pureColor = kCCC4FYellow;		// For terminator lines
+		faceWorkspace = NULL;
+		faceWorkspaceLength = 0;
 	}
 	return self;
 }
@@ -318,16 +518,20 @@
 }
 
 /**
- * Populates the shadow volume mesh by iterating through all the faces in the mesh of
- * the shadow casting node, looking for all pairs of neighbouring faces where one face
- * is in illuminated (facing towards the light) and the other is dark (facing away from
- * the light). The set of edges between these pairs forms the terminator of the mesh,
- * where the mesh on one side of the terminator is illuminated and the other is dark.
+ * Populates the shadow volume mesh by classifying all the faces in the mesh of the
+ * shadow casting node as illuminated (facing towards the light) or dark (facing away
+ * from the light), and then looking for all pairs of neighbouring faces where one face
+ * is illuminated and the other is dark. The set of edges between these pairs forms the
+ * terminator of the mesh, where the mesh on one side of the terminator is illuminated
+ * and the other is dark.
  *
  * The shadow volume is then constructed by extruding each edge line segment in the
  * terminator out to infinity in the direction away from the light source, forming a
  * tube of infinite length.
  *
+ * The work is done on flat arrays of face data, by the shadow volume functions, which
+ * write the shadow volume vertices directly into the vertex locations of this mesh.
+ *
  * Uses the 4D homogeneous location of the light in the global coordinate system.
  * When using the light location this method transforms this location to the local
  * coordinates system of the shadow caster.
@@ -335,9 +539,6 @@
 -(void) populateShadowMesh {
 	
 	CC3MeshNode* scNode = self.shadowCaster;
-	GLsizei faceCnt = scNode.faceCount;
-	GLsizei shdwVtxIdx = 0;
-	BOOL wasMeshExpanded = NO;
 	BOOL doesRequireCapping = useDepthFailAlgorithm || !shouldAddEndCapsOnlyWhenNeeded;
 	
 	// Transform the 4D position of the light into the local coordinates of the shadow caster.
@@ -345,22 +546,8 @@
 	CC3Vector4 localLightPosition = [scNode.transformMatrixInverted
 									 transformHomogeneousVector: lightPosition];
 	
-	// Determine whether we want to nudge the shadow volume vertices away from the shadow caster
-	BOOL isNudgingVertices = (shadowVolumeVertexOffsetFactor != 0.0f);
-	CC3Vector4 svVtxNudge = isNudgingVertices
-								? [self shadowVolumeVertexOffsetForLightAt: localLightPosition]
-								: kCC3Vector4Zero;
-	
-	//	if (doesRequireCapping) LogCleanDebug(@"Populating %@ with end caps", self);
-	
-	//	if ( [scNode.name isEqualToString: @"GeoSphere01"] ) {
-	//		LogCleanDebug(@"Populating %@ with %i faces for light at %@ and %@ end caps",
-	//					  self, faceCnt, NSStringFromCC3Vector4(lightPosition),
-	//					  (doesRequireCapping ? @"including" : @"excluding"));
-	//	}
-	
 	LogCleanTrace(@"Populating %@ with %i faces for light at %@ and %@ end caps",
-				  self, faceCnt, NSStringFromCC3Vector4(lightPosition),
+				  self, scNode.faceCount, NSStringFromCC3Vector4(lightPosition),
 				  (doesRequireCapping ? @"including" : @"excluding"));
 	
 	LogCleanTrace(@"%@ global light location: %@ shadow local light: %@ %@ inverted: %@",
@@ -369,120 +556,41 @@
 				  scNode.transformMatrix,
 				  scNode.transformMatrixInverted);
 	
-	// Iterate through all the faces in the mesh of the shadow caster.
-	for (GLsizei faceIdx = 0; faceIdx < faceCnt; faceIdx++) {
-		
-		// Retrieve the current face, convert it to 4D homogeneous locations
-		CC3Face face = [scNode deformedFaceAt: faceIdx];
-		CC3Vector4 vertices4d[3];
-		vertices4d[0] = CC3Vector4FromCC3Vector(face.vertices[0], 1.0f);
-		vertices4d[1] = CC3Vector4FromCC3Vector(face.vertices[1], 1.0f);
-		vertices4d[2] = CC3Vector4FromCC3Vector(face.vertices[2], 1.0f);
-		
-		// If needed, nudge the shadow volume face away from the
-		// shadow caster face in the direction away from the light
-		if (isNudgingVertices) {
-			vertices4d[0] = CC3Vector4Add(vertices4d[0], svVtxNudge);
-			vertices4d[1] = CC3Vector4Add(vertices4d[1], svVtxNudge);
-			vertices4d[2] = CC3Vector4Add(vertices4d[2], svVtxNudge);
-		}
-		
-		// Determine whether the face is illuminated.
-		BOOL isFaceLit = CC3Vector4IsInFrontOfPlane(localLightPosition, [scNode deformedFacePlaneAt: faceIdx]);
-		
-		LogCleanTrace(@"Face %i of %@ is %@. Indices: %@, Vertices: %@, plane: %@, neighbours: %@",
-					  faceIdx, scNode, (isFaceLit ? @"illuminated" : @"dark"),
-					  NSStringFromCC3FaceIndices([scNode faceIndicesAt: faceIdx]),
-					  NSStringFromCC3Face([scNode deformedFaceAt: faceIdx]),
-					  NSStringFromCC3Plane([scNode deformedFacePlaneAt: faceIdx]),
-					  NSStringFromCC3FaceNeighbours([scNode faceNeighboursAt: faceIdx]));
-		
-		// If we're drawing end-caps, and this face is part of an end-cap, draw it.
-		// It's part of an end-cap if it's a dark face and shadowing is based on front
-		// faces (typical), or it's a lit face and shadowing is (also) based on back faces
-		// (as with some open meshes).
-		if (doesRequireCapping && (isFaceLit ? shouldShadowBackFaces : shouldShadowFrontFaces) && !shouldDrawTerminator) {
-			LogCleanTrace(@"%@ adding end cap for face %i", self, faceIdx);
-			wasMeshExpanded |= [self addShadowVolumeCapFor: isFaceLit
-													  face: vertices4d
-												forLightAt: localLightPosition
-										   startingAtIndex: &shdwVtxIdx];
-		}
-		
-		// Now check the neighbouring face on the other side of each edge of this face.
-		CC3FaceNeighbours neighbours = [scNode faceNeighboursAt: faceIdx];
-		for (int edgeIdx = 0; edgeIdx < 3; edgeIdx++) {
-			
-			// Get the index of the face on the other side of this edge
-			GLushort neighbourFaceIdx = neighbours.edges[edgeIdx];
-			
-			// Check if this edge is part of the terminator. It is if either:
-			//   - There is no neighbouring face on this edge, and either the face is lit
-			//     and front faces are being shadowed, or the face is dark and back faces
-			//     are being shadowed.
-			//   - The neighbour has the opposite illumination than the current face
-			//     (ie- lit/dark or dark/lit) AND we haven't encountered this edge before
-			//     during this iteration, (ie- don't double count). The double-count test
-			//     is accomplished by only accepting the neighbouring face if it has a
-			//     larger index than the current face.
-			BOOL isTerminatorEdge = NO;
-			if (neighbourFaceIdx == kCC3FaceNoNeighbour) {
-				isTerminatorEdge = isFaceLit ? shouldShadowFrontFaces : shouldShadowBackFaces;
-			} else if (neighbourFaceIdx > faceIdx) {		// Don't double count edges
-				BOOL isNeighbourFaceLit = CC3Vector4IsInFrontOfPlane(localLightPosition, [scNode deformedFacePlaneAt: neighbourFaceIdx]);
-				isTerminatorEdge = (isNeighbourFaceLit != isFaceLit);
-			}
-			
-			if (isTerminatorEdge) {
-				
-				// We've found a terminator edge!
-				LogCleanTrace(@"\tNeighbouring face %u is %@. We have a terminator edge.",
-							  neighbourFaceIdx, ((neighbourFaceIdx == kCC3FaceNoNeighbour)
-												 ? @"missing" 
-												 : (isFaceLit ? @"dark" : @"illuminated")));
-				
-				// Get the end points of the terminator edge that we will be extruding.
-				// To have the normals of the shadow volume mesh point outwards, we want the
-				// winding of the extruded face to be the same as the dark face. So, choose
-				// the start and end of the edge based on which face of this pair is illuminated.
-				CC3Vector4 edgeStartLoc, edgeEndLoc;
-				if (isFaceLit) {
-					edgeStartLoc = vertices4d[edgeIdx];
-					edgeEndLoc = vertices4d[(edgeIdx < 2) ? (edgeIdx + 1) : 0];
-				} else {
-					edgeStartLoc = vertices4d[(edgeIdx < 2) ? (edgeIdx + 1) : 0];
-					edgeEndLoc = vertices4d[edgeIdx];
-				}
-				
-				if (self.shouldDrawTerminator && self.visible) {
-					// Draw the terminator line instead of a shadow
-					wasMeshExpanded |= [self addTerminatorLineFrom: edgeStartLoc
-																to: edgeEndLoc
-												   startingAtIndex: &shdwVtxIdx];
-				} else if (CC3Vector4IsDirectional(localLightPosition)) {
-					// Draw the shadow from a directional light
-					wasMeshExpanded |= [self addShadowVolumeSideFrom: edgeStartLoc
-																  to: edgeEndLoc
-											   forDirectionalLightAt: localLightPosition
-													 startingAtIndex: &shdwVtxIdx];
-				} else {
-					// Draw the shadow from a locational light, possibly closing off the far end
-					wasMeshExpanded |= [self addShadowVolumeSideFrom: edgeStartLoc
-																  to: edgeEndLoc
-															 withCap: doesRequireCapping
-												forLocationalLightAt: localLightPosition
-													 startingAtIndex: &shdwVtxIdx];
-				}
-			} else {
-				LogCleanTrace(@"\tNeighbouring face %u is %@. Not a terminator edge.",
-							  neighbourFaceIdx, (isFaceLit ? @"illuminated" : @"dark"));
-			}
-		}
+	CC3ShadowCasterFaces scFaces;
+	GLuint* litFaces;
+	if ( ![self populateShadowCasterFaces: &scFaces litFaces: &litFaces] ) {
+		mesh.vertexCount = 0;
+		return;
+	}
+	
+	// Determine whether we want to nudge the shadow volume vertices away from the shadow caster
+	CC3ShadowVolumeSettings svSettings;
+	svSettings.lightPosition = localLightPosition;
+	svSettings.vertexOffset = (shadowVolumeVertexOffsetFactor != 0.0f)
+								? [self shadowVolumeVertexOffsetForLightAt: localLightPosition]
+								: kCC3Vector4Zero;
+	svSettings.expansionLimitFactor = shadowExpansionLimitFactor;
+	svSettings.shouldShadowFrontFaces = shouldShadowFrontFaces;
+	svSettings.shouldShadowBackFaces = shouldShadowBackFaces;
+	svSettings.shouldAddEndCaps = doesRequireCapping && !shouldDrawTerminator;
+	svSettings.shouldCapFarEnd = doesRequireCapping;
+	svSettings.shouldDrawTerminator = shouldDrawTerminator && self.visible;
+	
+	// Classify all the faces against the light in one pass, then size the shadow
+	// volume mesh, and add the terminator edges and end caps straight into it.
+	CC3ShadowCasterFacesClassify(scFaces.facePlanes, scFaces.faceCount, localLightPosition, litFaces);
+	GLuint shdwVtxCount = CC3ShadowVolumeVertexCount(&scFaces, litFaces, &svSettings);
+	BOOL wasMeshExpanded = [mesh ensureCapacity: shdwVtxCount];
+	if (shdwVtxCount) {
+		CC3VertexLocations* svLocs = ((CC3VertexArrayMesh*)mesh).vertexLocations;
+		NSAssert1(svLocs.elementSize == 4 && svLocs.elementStride == sizeof(CC3Vector4),
+				  @"%@ shadow volume vertex locations must be tightly packed homogeneous locations", self);
+		CC3ShadowVolumePopulate((CC3Vector4*)[svLocs addressOfElement: 0], &scFaces, litFaces, &svSettings);
 	}
 	
 	// Update the vertex count of the shadow volume mesh, based on how many sides we've added.
-	mesh.vertexCount = shdwVtxIdx;
-	LogCleanTrace(@"%@ setting vertex count to %u", self, shdwVtxIdx);
+	mesh.vertexCount = shdwVtxCount;
+	LogCleanTrace(@"%@ setting vertex count to %u", self, shdwVtxCount);
 	
 	// If the mesh is using GL VBO's, update them. If the mesh was expanded,
 	// recreate the VBO's, otherwise update them.
@@ -498,180 +606,83 @@
 }
 
 /**
- * Adds a side to the shadow volume, by extruding the specified terminator edge of
- * the specified shadow caster mesh to infinity. The light source is directional
- * at the specified position. The shadow volume vertices are added starting at the
- * specified vertex index.
- * 
- * For a directional light, the shadow volume sides are parallel and can therefore
- * be described as meeting at a single point at infinity. We therefore only need to
- * add a single triangle, whose far point is in the opposite direction of the light.
- */
--(BOOL) addShadowVolumeSideFrom: (CC3Vector4) edgeStartLoc
-							 to: (CC3Vector4) edgeEndLoc
-		  forDirectionalLightAt: (CC3Vector4) lightPosition
-				startingAtIndex: (GLsizei*) shdwVtxIdx {
-	
-	// Get the location of the single point at infinity from the light direction.
-	CC3Vector4 farLoc = CC3Vector4HomogeneousNegate(lightPosition);
-	
-	// Ensure the mesh has enough capacity for another triangle.
-	BOOL wasMeshExpanded = [mesh ensureCapacity: (*shdwVtxIdx + 3)];
-	
-	// Add a single triangle from the edge to a single point at infinity,
-	// with the same winding as the dark face.
-	[mesh setVertexHomogeneousLocation: edgeStartLoc at: (*shdwVtxIdx)++];
-	[mesh setVertexHomogeneousLocation: farLoc at: (*shdwVtxIdx)++];
-	[mesh setVertexHomogeneousLocation: edgeEndLoc at: (*shdwVtxIdx)++];
-	
-	LogCleanTrace(@"%@ drawing shadow volume side face for directional light", self);
-	
-	return wasMeshExpanded;
-}
-
-/**
- * Adds a side to the shadow volume, by extruding the specified terminator edge of
- * the specified shadow caster mesh to infinity. The light source is positional at
- * the specified position. The shadow volume vertices are added starting at the
- * specified vertex index.
- * 
- * For a locational light, the shadow volume sides are not parallel and expand as
- * they extend away from the shadow casting object. If the shadow volume does not
- * need to be capped off at the far end, the shadow expands to infinity.
+ * Populates the specified structure with flat arrays of the face data of the shadow caster,
+ * and returns, in litFaces, space for the bitmask of illuminated faces. Returns NO if the
+ * shadow caster has no faces, or if memory could not be allocated.
  *
- * However, if the shadow volume needs to be capped off at the far end, the shadow
- * is allowed to expand behind the shadow-caster to a distance equivalent to the
- * distance from the light to the shadow-caster, multiplied by the value of the
- * shadowExpansionLimitFactor property. At that point, the shadow volume will
- * extend out to infinity at that same size.
- * 
- * For the shadow volume segment that expands in size, each side is a trapezoid
- * formed by projecting a vector from the light, through each terminator edge
- * vertex, out to either infinity of the distance determined by the value of the
- * shadowExpansionLimitFactor property. Then, from that distance to infinity,
- * the shadow volume side behaves as if it originated from a directional light,
- * and is constructed from a single triangle, extending out to infinity in the
- * opposite direction of the light.
+ * If the shadow caster caches its faces, the cached face indices, planes and deformed vertex
+ * locations are used directly, along with the vertex locations of the mesh. Otherwise, each
+ * deformed face is retrieved once, into the workspace of this node, and its plane calculated.
  */
--(BOOL) addShadowVolumeSideFrom: (CC3Vector4) edgeStartLoc
-							 to: (CC3Vector4) edgeEndLoc
-						withCap: (BOOL) doesRequireCapping
-		   forLocationalLightAt: (CC3Vector4) lightPosition
-				startingAtIndex: (GLsizei*) shdwVtxIdx {
-
-	CC3Vector4 farStartLoc, farEndLoc;
-
-	if (doesRequireCapping) {
-		// We need to cap this shadow volume at infinity, so allow the shadow volume
-		// to expand only for a distance equivalent to the distance from the light to
-		// the vertex, mulitiplied by the shadowExpansionLimitFactor property.
-		farStartLoc = [self expand: edgeStartLoc awayFromLocationalLightAt: lightPosition];
-		farEndLoc = [self expand: edgeEndLoc awayFromLocationalLightAt: lightPosition];
-	} else {
-		// We don't need to cap this shadow volume, so allow the shadow volume to expand
-		// to infinity in a direction away from the light, through the edge points.
-		// The W component of the result of each subtraction will be zero, indicating
-		// a point at infinity.
-		farStartLoc = CC3Vector4Difference(edgeStartLoc, lightPosition);
-		farEndLoc = CC3Vector4Difference(edgeEndLoc, lightPosition);
-	}
-	
-	// Ensure the mesh has enough capacity for another two triangles.
-	BOOL wasMeshExpanded = [mesh ensureCapacity: (*shdwVtxIdx + 6)];
+-(BOOL) populateShadowCasterFaces: (CC3ShadowCasterFaces*) scFaces litFaces: (GLuint**) litFaces {
+	CC3MeshNode* scNode = self.shadowCaster;
+	CC3Mesh* scMesh = scNode.mesh;
+	GLsizei faceCnt = scNode.faceCount;
+	if (faceCnt <= 0) return NO;
 	
-	// The shadow volume faces have the same winding as the dark face.
-	// First triangular face:
-	[mesh setVertexHomogeneousLocation: edgeStartLoc at: (*shdwVtxIdx)++];
-	[mesh setVertexHomogeneousLocation: farStartLoc at: (*shdwVtxIdx)++];
-	[mesh setVertexHomogeneousLocation: farEndLoc at: (*shdwVtxIdx)++];
+	memset(scFaces, 0, sizeof(CC3ShadowCasterFaces));
+	scFaces->faceCount = faceCnt;
+	scFaces->faceNeighbours = scMesh.faces.neighbours;
+	if ( !scFaces->faceNeighbours ) return NO;
 	
-	// Second triangular face:
-	[mesh setVertexHomogeneousLocation: edgeStartLoc at: (*shdwVtxIdx)++];
-	[mesh setVertexHomogeneousLocation: farEndLoc at: (*shdwVtxIdx)++];
-	[mesh setVertexHomogeneousLocation: edgeEndLoc at: (*shdwVtxIdx)++];
-
-	if (doesRequireCapping) {
-		// To cap, extend from the limited expansion points out to infinity in
-		// a direction away from the light, as if the light was directional.
-		// These segments will be parallel to each other, and the shadow will
-		// expand no further.
-		wasMeshExpanded |= [self addShadowVolumeSideFrom: farStartLoc
-													  to: farEndLoc
-								   forDirectionalLightAt: lightPosition
-										 startingAtIndex: shdwVtxIdx];
+	BOOL isSkinned = [scNode isKindOfClass: [CC3SkinMeshNode class]];
+	BOOL needsPlanes = YES;
+	if (scNode.shouldCacheFaces) {
+		scFaces->faceIndices = scMesh.faces.indices;
+		if (isSkinned) {
+			scFaces->vertexLocations = ((CC3SkinMeshNode*)scNode).deformedFaces.deformedVertexLocations;
+		} else if ([scMesh isKindOfClass: [CC3VertexArrayMesh class]]) {
+			CC3VertexLocations* vLocs = ((CC3VertexArrayMesh*)scMesh).vertexLocations;
+			if (vLocs.elements && vLocs.elementType == GL_FLOAT && vLocs.elementSize == 3) {
+				scFaces->vertexLocations = [vLocs addressOfElement: 0];
+				scFaces->vertexStride = vLocs.elementStride;
+				scFaces->facePlanes = scMesh.faces.planes;
+				needsPlanes = NO;
+			}
+		}
 	}
+	BOOL needsVertices = !(scFaces->faceIndices && scFaces->vertexLocations);
 	
-	LogCleanTrace(@"%@ drawing shadow volume side face for positional light", self);
-	
-	return wasMeshExpanded;
-}
-
-/** 
- * Expands the location of an terminator edge vertex in the direction away from the locational
- * light at the specified location. The vertex is moved away from the light along the vector
- * from the light to the vertex, a distance equal to the distance between the light and the
- * vertex, multiplied by the value of the shadowExpansionLimitFactor property.
- */
--(CC3Vector4) expand: (CC3Vector4) edgeLoc awayFromLocationalLightAt: (CC3Vector4) lightLoc {
-	CC3Vector4 extDir = CC3Vector4Difference(edgeLoc, lightLoc);
-	CC3Vector4 extrusion = CC3Vector4ScaleUniform(extDir, shadowExpansionLimitFactor);
-	return CC3Vector4Add(edgeLoc, extrusion);
-}
-
-/**
- * Adds a face to the cap at the near end of the shadow volume.
- *
- * The winding order of the end-cap faces is determined from the winding order of
- * the model face, taking into consideration whether the face is lit or not.
- */
--(BOOL) addShadowVolumeCapFor: (BOOL) isFaceLit
-						 face: (CC3Vector4*) vertices
-				   forLightAt: (CC3Vector4) lightPosition
-			  startingAtIndex: (GLsizei*) shdwVtxIdx {
-	
-	// Ensure the mesh has enough capacity for another triangle.
-	BOOL wasMeshExpanded = [mesh ensureCapacity: (*shdwVtxIdx + 3)];
+	// Lay out the workspace as the planes, then the vertices, if needed, then the lit faces bitmask
+	size_t litLen = ((faceCnt + 31) >> 5) * sizeof(GLuint);
+	size_t planesLen = needsPlanes ? (faceCnt * sizeof(CC3Plane)) : 0;
+	size_t vtxLen = needsVertices ? (faceCnt * 3 * sizeof(CC3Vector)) : 0;
+	GLbyte* workspace = [self faceWorkspaceOfLength: (planesLen + vtxLen + litLen)];
+	if ( !workspace ) return NO;
 	
-	// Add a single triangle face to the cap at the near end, built from the vertices
-	// of the shadow caster face at the specified index. If the face is lit, use the
-	// same winding order. If the face is dark, use the opposite winding.
-	if (isFaceLit) {
-		[mesh setVertexHomogeneousLocation: vertices[0] at: (*shdwVtxIdx)++];
-		[mesh setVertexHomogeneousLocation: vertices[1] at: (*shdwVtxIdx)++];
-		[mesh setVertexHomogeneousLocation: vertices[2] at: (*shdwVtxIdx)++];
-	} else {
-		[mesh setVertexHomogeneousLocation: vertices[0] at: (*shdwVtxIdx)++];
-		[mesh setVertexHomogeneousLocation: vertices[2] at: (*shdwVtxIdx)++];
-		[mesh setVertexHomogeneousLocation: vertices[1] at: (*shdwVtxIdx)++];
+	if (needsVertices) {
+		CC3Vector* vtxLocs = (CC3Vector*)(workspace + planesLen);
+		for (GLsizei faceIdx = 0; faceIdx < faceCnt; faceIdx++) {
+			CC3Face face = [scNode deformedFaceAt: faceIdx];
+			vtxLocs[faceIdx * 3] = face.vertices[0];
+			vtxLocs[faceIdx * 3 + 1] = face.vertices[1];
+			vtxLocs[faceIdx * 3 + 2] = face.vertices[2];
+		}
+		scFaces->vertexLocations = vtxLocs;
+		scFaces->vertexStride = sizeof(CC3Vector);
+		scFaces->faceIndices = NULL;
 	}
-
-	LogCleanTrace(@"%@ drawing shadow volume near %@end cap face (%@, %@, %@)",
-				  self, (CC3Vector4IsLocational(lightPosition) ? @"and far " : @""),
-				  NSStringFromCC3Vector4(vertices[0]),
-				  NSStringFromCC3Vector4(vertices[1]),
-				  NSStringFromCC3Vector4(vertices[2]));
-	
-	return wasMeshExpanded;
+	if (needsPlanes) {
+		CC3Plane* facePlanes = (CC3Plane*)workspace;
+		CC3ShadowCasterFacesPopulatePlanes(scFaces, facePlanes);
+		scFaces->facePlanes = facePlanes;
+	}
+	*litFaces = (GLuint*)(workspace + planesLen + vtxLen);
+	return YES;
 }
 
-/**
- * When drawing the terminator line of the mesh, just add the two line
- * endpoints, and don't make use of infinitely extruded endpoints.
- */
--(BOOL) addTerminatorLineFrom: (CC3Vector4) edgeStartLoc
-						   to: (CC3Vector4) edgeEndLoc
-			  startingAtIndex: (GLsizei*) shdwVtxIdx {
-	
-	// Ensure the mesh has enough capacity for another line
-	BOOL wasMeshExpanded = [mesh ensureCapacity: (*shdwVtxIdx + 2)];
-	
-	// Add just the two end points of the terminator edge
-	[mesh setVertexHomogeneousLocation: edgeStartLoc at: (*shdwVtxIdx)++];
-	[mesh setVertexHomogeneousLocation: edgeEndLoc at: (*shdwVtxIdx)++];
-	
-	LogCleanTrace(@"%@ drawing terminator line", self);
-	
-	return wasMeshExpanded;
+/** Returns a workspace of at least the specified length, owned by this node. */
+-(GLvoid*) faceWorkspaceOfLength: (size_t) length {
+	if (length > faceWorkspaceLength) {
+		GLvoid* newWorkspace = realloc(faceWorkspace, length);
+		if ( !newWorkspace ) {
+			LogError(@"%@ could not allocate %lu bytes of face workspace", self, (unsigned long)length);
+			return NULL;
+		}
+		faceWorkspace = newWorkspace;
+		faceWorkspaceLength = length;
+	}
+	return faceWorkspace;
 }
 
 
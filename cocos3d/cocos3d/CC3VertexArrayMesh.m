@@ -835,6 +835,17 @@
 	return kCC3FaceIndicesZero;
 }
 
+-(void) getVertexIndices: (GLuint*) vtxIndices ofFaceAt: (GLsizei) faceIndex {
+	if (vertexIndices) {
+		[vertexIndices getVertexIndices: vtxIndices ofFaceAt: faceIndex];
+	} else if (vertexLocations) {
+		[vertexLocations getVertexIndices: vtxIndices ofFaceAt: faceIndex];
+	} else {
+		NSAssert1(NO, @"%@ has no drawable vertex array and cannot retrieve indices for a face.", self);
+		vtxIndices[0] = vtxIndices[1] = vtxIndices[2] = 0;
+	}
+}
+
 -(GLsizei) faceCountFromVertexCount: (GLsizei) vc {
 	if (vertexIndices) return [vertexIndices faceCountFromVertexCount: vc];
 	if (vertexLocations) return [vertexLocations faceCountFromVertexCount: vc];
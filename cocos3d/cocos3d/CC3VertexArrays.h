@@ -742,9 +742,21 @@
  *
  * This method takes into consideration the drawingMode of this vertex array,
  * and any padding (stride) between the vertex indices.
+ *
+ * The indices in the returned face are of type GLushort. If this array may contain more
+ * than 65536 vertices, use the getVertexIndices:ofFaceAt: method instead.
  */
 -(CC3FaceIndices) faceIndicesAt: (GLsizei) faceIndex;
 
+/**
+ * Populates the specified array of three GLuints with the indices of the vertices of the
+ * face from the mesh at the specified index, in winding order.
+ *
+ * This method behaves the same as the faceIndicesAt: method, except that the indices are
+ * not narrowed to GLushort, so faces at the end of a large vertex array are not truncated.
+ */
+-(void) getVertexIndices: (GLuint*) vtxIndices ofFaceAt: (GLsizei) faceIndex;
+
 @end
 
 
@@ -1510,6 +1522,16 @@ static const CGRect kCC3UnitTextureRectangle = { {0.0, 0.0}, {1.0, 1.0} };
  */
 -(CC3FaceIndices) faceIndicesAt: (GLsizei) faceIndex;
 
+/**
+ * Populates the specified array of three GLuints with the vertex indices of the face
+ * from the mesh at the specified index, read at the width of the elementType property.
+ *
+ * This method behaves the same as the faceIndicesAt: method, except that the position
+ * of the face within this index array is not narrowed to GLushort, so faces beyond the
+ * first 65536 elements are read correctly.
+ */
+-(void) getVertexIndices: (GLuint*) vtxIndices ofFaceAt: (GLsizei) faceIndex;
+
 /**
  * Convenience method to populate this index array from the specified run-length
  * encoded array.
@@ -428,7 +428,7 @@ static GLuint lastAssignedVertexArrayTag;
 #pragma mark CC3DrawableVertexArray
 
 @interface CC3DrawableVertexArray (TemplateMethods)
--(CC3FaceIndices) faceIndicesAt: (GLsizei) faceIndex fromStripOfLength: (GLsizei) stripLen;
+-(void) getVertexIndices: (GLuint*) vtxIndices ofFaceAt: (GLsizei) faceIndex fromStripOfLength: (GLsizei) stripLen;
 @end
 
 @implementation CC3DrawableVertexArray
@@ -570,13 +570,19 @@ static GLuint lastAssignedVertexArrayTag;
 	}
 }
 
+-(CC3FaceIndices) faceIndicesAt: (GLsizei) faceIndex {
+	GLuint vtxIndices[3];
+	[self getVertexIndices: vtxIndices ofFaceAt: faceIndex];
+	return CC3FaceIndicesMake(vtxIndices[0], vtxIndices[1], vtxIndices[2]);
+}
+
 /**
  * If drawing is being done with strips, accumulate the number of faces per strip
  * prior to the strip that contains the specified face, then add the offset to
  * the face within that strip to retrieve the correct face from that strip.
  * If strips are not in use, simply extract the face from the full element array.
  */
--(CC3FaceIndices) faceIndicesAt: (GLsizei) faceIndex {
+-(void) getVertexIndices: (GLuint*) vtxIndices ofFaceAt: (GLsizei) faceIndex {
 	if (stripCount) {
 		// Mesh is divided into strips. Find the strip that contains the face,
 		// by accumulating faces and element counts until we reach the strip
@@ -589,63 +595,84 @@ static GLuint lastAssignedVertexArrayTag;
 			GLsizei stripLen = stripLengths[i];
 			nextStripStartFaceCnt += [self faceCountFromVertexCount: stripLen];
 			if (nextStripStartFaceCnt > faceIndex) {
-				CC3FaceIndices faceIndices = [self faceIndicesAt: (faceIndex - currStripStartFaceCnt)
-											   fromStripOfLength: stripLen];
+				[self getVertexIndices: vtxIndices
+							  ofFaceAt: (faceIndex - currStripStartFaceCnt)
+					 fromStripOfLength: stripLen];
 				// Offset the indices of the face by the number of elements
-				// accumulated from all the previous strips and return them.
-				faceIndices.vertices[0] += stripStartVtxCnt;
-				faceIndices.vertices[1] += stripStartVtxCnt;
-				faceIndices.vertices[2] += stripStartVtxCnt;
-				return faceIndices;
+				// accumulated from all the previous strips.
+				vtxIndices[0] += stripStartVtxCnt;
+				vtxIndices[1] += stripStartVtxCnt;
+				vtxIndices[2] += stripStartVtxCnt;
+				return;
 			}
 			currStripStartFaceCnt = nextStripStartFaceCnt;
 			stripStartVtxCnt += stripLen;
 		}
 		NSAssert3(NO, @"%@ requested face index %i is larger than face count %i",
 				  self, faceIndex, [self faceCount]);
-		return kCC3FaceIndicesZero;
+		vtxIndices[0] = vtxIndices[1] = vtxIndices[2] = 0;
 	} else {
 		// Mesh is monolithic. Simply extract the face from the elements array.
-		return [self faceIndicesAt: faceIndex fromStripOfLength: elementCount];
+		[self getVertexIndices: vtxIndices ofFaceAt: faceIndex fromStripOfLength: elementCount];
 	}
 }
 
 /**
- * Returns the indicies for the face at the specified face index,
- * within an array of vertices of the specified length.
+ * Populates the specified array with the indicies for the face at the
+ * specified face index, within an array of vertices of the specified length.
  */
--(CC3FaceIndices) faceIndicesAt: (GLsizei) faceIndex fromStripOfLength: (GLsizei) stripLen {
-	GLsizei firstVtxIdx;			// The first index of the face.
+-(void) getVertexIndices: (GLuint*) vtxIndices ofFaceAt: (GLsizei) faceIndex fromStripOfLength: (GLsizei) stripLen {
+	GLuint firstVtxIdx;			// The first index of the face.
 	switch (self.drawingMode) {
 		case GL_TRIANGLES:
 			firstVtxIdx = faceIndex * 3;
-			return CC3FaceIndicesMake(firstVtxIdx, firstVtxIdx + 1, firstVtxIdx + 2);
+			vtxIndices[0] = firstVtxIdx;
+			vtxIndices[1] = firstVtxIdx + 1;
+			vtxIndices[2] = firstVtxIdx + 2;
+			return;
 		case GL_TRIANGLE_STRIP:
 			firstVtxIdx = faceIndex;
+			vtxIndices[0] = firstVtxIdx;
 			if (CC3IntIsEven(faceIndex)) {		// The winding order alternates
-				return CC3FaceIndicesMake(firstVtxIdx, firstVtxIdx + 1, firstVtxIdx + 2);
+				vtxIndices[1] = firstVtxIdx + 1;
+				vtxIndices[2] = firstVtxIdx + 2;
 			} else {
-				return CC3FaceIndicesMake(firstVtxIdx, firstVtxIdx + 2, firstVtxIdx + 1);
+				vtxIndices[1] = firstVtxIdx + 2;
+				vtxIndices[2] = firstVtxIdx + 1;
 			}
+			return;
 		case GL_TRIANGLE_FAN:
 			firstVtxIdx = faceIndex + 1;
-			return CC3FaceIndicesMake(0, firstVtxIdx, firstVtxIdx + 1);
+			vtxIndices[0] = 0;
+			vtxIndices[1] = firstVtxIdx;
+			vtxIndices[2] = firstVtxIdx + 1;
+			return;
 		case GL_LINES:
 			firstVtxIdx = faceIndex * 2;
-			return CC3FaceIndicesMake(firstVtxIdx, firstVtxIdx + 1, 0);
+			vtxIndices[0] = firstVtxIdx;
+			vtxIndices[1] = firstVtxIdx + 1;
+			vtxIndices[2] = 0;
+			return;
 		case GL_LINE_STRIP:
 			firstVtxIdx = faceIndex;
-			return CC3FaceIndicesMake(firstVtxIdx, firstVtxIdx + 1, 0);
+			vtxIndices[0] = firstVtxIdx;
+			vtxIndices[1] = firstVtxIdx + 1;
+			vtxIndices[2] = 0;
+			return;
 		case GL_LINE_LOOP:
 			firstVtxIdx = faceIndex;
-			GLsizei nextVtxIdx = (faceIndex < stripLen - 1) ? firstVtxIdx + 1 : 0;
-			return CC3FaceIndicesMake(firstVtxIdx, nextVtxIdx, 0);
+			vtxIndices[0] = firstVtxIdx;
+			vtxIndices[1] = (faceIndex < stripLen - 1) ? firstVtxIdx + 1 : 0;
+			vtxIndices[2] = 0;
+			return;
 		case GL_POINTS:
-			firstVtxIdx = faceIndex;
-			return CC3FaceIndicesMake(firstVtxIdx, 0, 0);
+			vtxIndices[0] = faceIndex;
+			vtxIndices[1] = vtxIndices[2] = 0;
+			return;
 		default:
 			NSAssert2(NO, @"%@ encountered unknown drawing mode %u", self, self.drawingMode);
-			return kCC3FaceIndicesZero;
+			vtxIndices[0] = vtxIndices[1] = vtxIndices[2] = 0;
+			return;
 	}
 }
 
@@ -1401,11 +1428,11 @@ static BOOL defaultExpectsVerticallyFlippedTextures = YES;
 	}
 }
 
--(CC3FaceIndices) faceIndicesAt: (GLsizei) faceIndex {
-	CC3FaceIndices idxIndices = [super faceIndicesAt: faceIndex];
-	return CC3FaceIndicesMake([self indexAt: idxIndices.vertices[0]],
-							  [self indexAt: idxIndices.vertices[1]],
-							  [self indexAt: idxIndices.vertices[2]]);
+-(void) getVertexIndices: (GLuint*) vtxIndices ofFaceAt: (GLsizei) faceIndex {
+	[super getVertexIndices: vtxIndices ofFaceAt: faceIndex];
+	vtxIndices[0] = [self indexAt: vtxIndices[0]];
+	vtxIndices[1] = [self indexAt: vtxIndices[1]];
+	vtxIndices[2] = [self indexAt: vtxIndices[2]];
 }
 
 -(void) bindGLWithVisitor: (CC3NodeDrawingVisitor*) visitor {
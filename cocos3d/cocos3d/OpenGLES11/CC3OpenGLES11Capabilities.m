@@ -39,7 +39,7 @@
 @implementation CC3OpenGLES11StateTrackerServerCapability
 
 -(void) setGLValue {
-	if (value) {
+	if (self.value) {
 		glEnable(name);
 	} else {
 		glDisable(name);
@@ -55,7 +55,7 @@
 @implementation CC3OpenGLES11StateTrackerClientCapability
 
 -(void) setGLValue {
-	if (value) {
+	if (self.value) {
 		glEnableClientState(name);
 	} else {
 		glDisableClientState(name);
@@ -0,0 +1,318 @@
+/*
+ * CC3OpenGLES11CommandStream.h
+ *
+ * cocos3d 0.7.1
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2012 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+
+/** @file */	// Doxygen marker
+
+/**
+ * This file defines the binary format of the GL command streams written by the
+ * GL recorder (see CC3OpenGLES11Recorder.h).
+ *
+ * It deliberately depends only on the standard C integer types, and not on any GL
+ * header, so that offline tools can read a command stream on machines that have
+ * no OpenGL ES implementation at all.
+ *
+ * A command stream starts with a CC3GLCommandStreamHeader, followed by a sequence
+ * of commands. Each command is a CC3GLCommandHeader, followed by the number of
+ * 32-bit parameter words indicated in the header, followed by the number of bytes
+ * of captured pointer data indicated in the header. The data is padded with zeros
+ * to a multiple of four bytes, so that every command header is 32-bit aligned.
+ *
+ * Parameter words hold the scalar parameters of the GL call, in the order they
+ * appear in the GL function signature. Integer and enum parameters are stored as
+ * their 32-bit values, and float parameters are stored as their IEEE bit patterns.
+ * Pointer parameters that refer to data that is read by the GL call are stored as
+ * the low 32 bits of the pointer, which is the offset when a buffer is bound, and
+ * the data they point to is captured as the command data, up to the size that the
+ * GL call will read. Pointer parameters that GL writes to (eg. glGet* results) are
+ * not recorded.
+ *
+ * Values are written in the byte order of the recording device. Readers can use the
+ * byteOrderMark in the stream header to detect a stream of the opposite byte order.
+ */
+
+#include <stdint.h>
+
+/** The magic bytes at the start of every command stream. */
+#define kCC3GLCommandStreamMagic			"CC3GLCMD"
+
+/** The current version of the command stream format. */
+#define kCC3GLCommandStreamVersion			1
+
+/** The byteOrderMark of a command stream that was written in the byte order of the reader. */
+#define kCC3GLCommandStreamByteOrderMark	0x01020304
+
+/** The header at the start of a command stream. */
+typedef struct {
+	char magic[8];				/**< Always kCC3GLCommandStreamMagic, without a terminating null. */
+	uint32_t version;			/**< The command stream format version. */
+	uint32_t byteOrderMark;		/**< kCC3GLCommandStreamByteOrderMark, in the byte order of the recording device. */
+} CC3GLCommandStreamHeader;
+
+/** The header at the start of each command in a command stream. */
+typedef struct {
+	uint16_t opcode;			/**< The CC3GLCommandOpcode of the command. */
+	uint16_t wordCount;			/**< The number of 32-bit parameter words following this header. */
+	uint32_t dataLength;		/**< The number of bytes of captured data following the words, before padding. */
+} CC3GLCommandHeader;
+
+/** Returns the number of bytes occupied by the command data of the specified length, including padding. */
+static inline uint32_t CC3GLCommandPaddedDataLength(uint32_t dataLength) {
+	return (dataLength + 3) & ~(uint32_t)3;
+}
+
+/**
+ * The broad categories of GL commands, used by tools to summarize a command stream:
+ *
+ *   - kCC3GLCommandCategoryMarker: A command that does not correspond to a GL call.
+ *   - kCC3GLCommandCategoryState: A call that changes GL state, and is therefore a
+ *     candidate for being redundant if it sets the same state twice in a row.
+ *   - kCC3GLCommandCategoryMatrix: A call that modifies the current matrix stack.
+ *   - kCC3GLCommandCategoryDraw: A call that draws into the framebuffer.
+ *   - kCC3GLCommandCategoryUpload: A call that fills buffer, texture or renderbuffer storage.
+ *   - kCC3GLCommandCategoryObject: A call that creates, deletes or maps a GL object.
+ *   - kCC3GLCommandCategoryQuery: A call that reads information back from GL.
+ *   - kCC3GLCommandCategorySync: A call that flushes or waits for the GL pipeline.
+ */
+typedef enum {
+	kCC3GLCommandCategoryMarker = 0,
+	kCC3GLCommandCategoryState,
+	kCC3GLCommandCategoryMatrix,
+	kCC3GLCommandCategoryDraw,
+	kCC3GLCommandCategoryUpload,
+	kCC3GLCommandCategoryObject,
+	kCC3GLCommandCategoryQuery,
+	kCC3GLCommandCategorySync
+} CC3GLCommandCategory;
+
+/**
+ * The list of GL commands that can appear in a command stream, with their categories.
+ *
+ * This list defines the opcode values, so new commands must only ever be added to the end.
+ */
+#define CC3GLCommandList(CMD)	\
+	CMD(glAlphaFunc, State)	\
+	CMD(glClearColor, State)	\
+	CMD(glClearDepthf, State)	\
+	CMD(glClipPlanef, State)	\
+	CMD(glColor4f, State)	\
+	CMD(glDepthRangef, State)	\
+	CMD(glFogf, State)	\
+	CMD(glFogfv, State)	\
+	CMD(glFrustumf, Matrix)	\
+	CMD(glGetClipPlanef, Query)	\
+	CMD(glGetFloatv, Query)	\
+	CMD(glGetLightfv, Query)	\
+	CMD(glGetMaterialfv, Query)	\
+	CMD(glGetTexEnvfv, Query)	\
+	CMD(glGetTexParameterfv, Query)	\
+	CMD(glLightModelf, State)	\
+	CMD(glLightModelfv, State)	\
+	CMD(glLightf, State)	\
+	CMD(glLightfv, State)	\
+	CMD(glLineWidth, State)	\
+	CMD(glLoadMatrixf, Matrix)	\
+	CMD(glMaterialf, State)	\
+	CMD(glMaterialfv, State)	\
+	CMD(glMultMatrixf, Matrix)	\
+	CMD(glMultiTexCoord4f, State)	\
+	CMD(glNormal3f, State)	\
+	CMD(glOrthof, Matrix)	\
+	CMD(glPointParameterf, State)	\
+	CMD(glPointParameterfv, State)	\
+	CMD(glPointSize, State)	\
+	CMD(glPolygonOffset, State)	\
+	CMD(glRotatef, Matrix)	\
+	CMD(glScalef, Matrix)	\
+	CMD(glTexEnvf, State)	\
+	CMD(glTexEnvfv, State)	\
+	CMD(glTexParameterf, State)	\
+	CMD(glTexParameterfv, State)	\
+	CMD(glTranslatef, Matrix)	\
+	CMD(glActiveTexture, State)	\
+	CMD(glAlphaFuncx, State)	\
+	CMD(glBindBuffer, State)	\
+	CMD(glBindTexture, State)	\
+	CMD(glBlendFunc, State)	\
+	CMD(glBufferData, Upload)	\
+	CMD(glBufferSubData, Upload)	\
+	CMD(glClear, Draw)	\
+	CMD(glClearColorx, State)	\
+	CMD(glClearDepthx, State)	\
+	CMD(glClearStencil, State)	\
+	CMD(glClientActiveTexture, State)	\
+	CMD(glClipPlanex, State)	\
+	CMD(glColor4ub, State)	\
+	CMD(glColor4x, State)	\
+	CMD(glColorMask, State)	\
+	CMD(glColorPointer, State)	\
+	CMD(glCompressedTexImage2D, Upload)	\
+	CMD(glCompressedTexSubImage2D, Upload)	\
+	CMD(glCopyTexImage2D, Upload)	\
+	CMD(glCopyTexSubImage2D, Upload)	\
+	CMD(glCullFace, State)	\
+	CMD(glDeleteBuffers, Object)	\
+	CMD(glDeleteTextures, Object)	\
+	CMD(glDepthFunc, State)	\
+	CMD(glDepthMask, State)	\
+	CMD(glDepthRangex, State)	\
+	CMD(glDisable, State)	\
+	CMD(glDisableClientState, State)	\
+	CMD(glDrawArrays, Draw)	\
+	CMD(glDrawElements, Draw)	\
+	CMD(glEnable, State)	\
+	CMD(glEnableClientState, State)	\
+	CMD(glFinish, Sync)	\
+	CMD(glFlush, Sync)	\
+	CMD(glFogx, State)	\
+	CMD(glFogxv, State)	\
+	CMD(glFrontFace, State)	\
+	CMD(glFrustumx, Matrix)	\
+	CMD(glGetBooleanv, Query)	\
+	CMD(glGetBufferParameteriv, Query)	\
+	CMD(glGetClipPlanex, Query)	\
+	CMD(glGenBuffers, Object)	\
+	CMD(glGenTextures, Object)	\
+	CMD(glGetError, Query)	\
+	CMD(glGetFixedv, Query)	\
+	CMD(glGetIntegerv, Query)	\
+	CMD(glGetLightxv, Query)	\
+	CMD(glGetMaterialxv, Query)	\
+	CMD(glGetPointerv, Query)	\
+	CMD(glGetString, Query)	\
+	CMD(glGetTexEnviv, Query)	\
+	CMD(glGetTexEnvxv, Query)	\
+	CMD(glGetTexParameteriv, Query)	\
+	CMD(glGetTexParameterxv, Query)	\
+	CMD(glHint, State)	\
+	CMD(glIsBuffer, Query)	\
+	CMD(glIsEnabled, Query)	\
+	CMD(glIsTexture, Query)	\
+	CMD(glLightModelx, State)	\
+	CMD(glLightModelxv, State)	\
+	CMD(glLightx, State)	\
+	CMD(glLightxv, State)	\
+	CMD(glLineWidthx, State)	\
+	CMD(glLoadIdentity, Matrix)	\
+	CMD(glLoadMatrixx, Matrix)	\
+	CMD(glLogicOp, State)	\
+	CMD(glMaterialx, State)	\
+	CMD(glMaterialxv, State)	\
+	CMD(glMatrixMode, State)	\
+	CMD(glMultMatrixx, Matrix)	\
+	CMD(glMultiTexCoord4x, State)	\
+	CMD(glNormal3x, State)	\
+	CMD(glNormalPointer, State)	\
+	CMD(glOrthox, Matrix)	\
+	CMD(glPixelStorei, State)	\
+	CMD(glPointParameterx, State)	\
+	CMD(glPointParameterxv, State)	\
+	CMD(glPointSizex, State)	\
+	CMD(glPolygonOffsetx, State)	\
+	CMD(glPopMatrix, Matrix)	\
+	CMD(glPushMatrix, Matrix)	\
+	CMD(glReadPixels, Query)	\
+	CMD(glRotatex, Matrix)	\
+	CMD(glSampleCoverage, State)	\
+	CMD(glSampleCoveragex, State)	\
+	CMD(glScalex, Matrix)	\
+	CMD(glScissor, State)	\
+	CMD(glShadeModel, State)	\
+	CMD(glStencilFunc, State)	\
+	CMD(glStencilMask, State)	\
+	CMD(glStencilOp, State)	\
+	CMD(glTexCoordPointer, State)	\
+	CMD(glTexEnvi, State)	\
+	CMD(glTexEnvx, State)	\
+	CMD(glTexEnviv, State)	\
+	CMD(glTexEnvxv, State)	\
+	CMD(glTexImage2D, Upload)	\
+	CMD(glTexParameteri, State)	\
+	CMD(glTexParameterx, State)	\
+	CMD(glTexParameteriv, State)	\
+	CMD(glTexParameterxv, State)	\
+	CMD(glTexSubImage2D, Upload)	\
+	CMD(glTranslatex, Matrix)	\
+	CMD(glVertexPointer, State)	\
+	CMD(glViewport, State)	\
+	CMD(glCurrentPaletteMatrixOES, State)	\
+	CMD(glLoadPaletteFromModelViewMatrixOES, Matrix)	\
+	CMD(glMatrixIndexPointerOES, State)	\
+	CMD(glWeightPointerOES, State)	\
+	CMD(glPointSizePointerOES, State)	\
+	CMD(glDrawTexsOES, Draw)	\
+	CMD(glDrawTexiOES, Draw)	\
+	CMD(glDrawTexxOES, Draw)	\
+	CMD(glDrawTexsvOES, Draw)	\
+	CMD(glDrawTexivOES, Draw)	\
+	CMD(glDrawTexxvOES, Draw)	\
+	CMD(glDrawTexfOES, Draw)	\
+	CMD(glDrawTexfvOES, Draw)	\
+	CMD(glBlendEquationOES, State)	\
+	CMD(glIsRenderbufferOES, Query)	\
+	CMD(glBindRenderbufferOES, State)	\
+	CMD(glDeleteRenderbuffersOES, Object)	\
+	CMD(glGenRenderbuffersOES, Object)	\
+	CMD(glRenderbufferStorageOES, Upload)	\
+	CMD(glGetRenderbufferParameterivOES, Query)	\
+	CMD(glIsFramebufferOES, Query)	\
+	CMD(glBindFramebufferOES, State)	\
+	CMD(glDeleteFramebuffersOES, Object)	\
+	CMD(glGenFramebuffersOES, Object)	\
+	CMD(glCheckFramebufferStatusOES, Query)	\
+	CMD(glFramebufferRenderbufferOES, Object)	\
+	CMD(glFramebufferTexture2DOES, Object)	\
+	CMD(glGetFramebufferAttachmentParameterivOES, Query)	\
+	CMD(glGenerateMipmapOES, Upload)	\
+	CMD(glGetBufferPointervOES, Query)	\
+	CMD(glMapBufferOES, Object)	\
+	CMD(glUnmapBufferOES, Object)
+
+#define CC3GLCommandOpcodeEntry(glName, category)	kCC3GLCmd_##glName,
+
+/**
+ * The opcodes of the commands in a command stream.
+ *
+ * In addition to one opcode for each GL call, named kCC3GLCmd_ followed by the name
+ * of the GL function, there are two marker opcodes:
+ *
+ *   - kCC3GLCmdFrame: Marks the start of a frame. It has a single parameter word
+ *     holding the index of the frame, starting at zero, and no data.
+ *
+ *   - kCC3GLCmdClientArray: Holds the contents of a vertex array that is read from
+ *     client memory, rather than from a buffer, by the draw command that follows it.
+ *     The parameter words hold the array (eg. GL_VERTEX_ARRAY), the texture unit index
+ *     for GL_TEXTURE_COORD_ARRAY, the element size, the element type, the stride, and
+ *     the index of the first captured vertex. The data holds the captured vertices.
+ */
+typedef enum {
+	kCC3GLCmdFrame = 0,
+	kCC3GLCmdClientArray,
+	CC3GLCommandList(CC3GLCommandOpcodeEntry)
+	kCC3GLCmdCount
+} CC3GLCommandOpcode;
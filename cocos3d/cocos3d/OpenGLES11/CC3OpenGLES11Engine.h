@@ -95,6 +95,7 @@
  *      which is nil, unless your application sets a tracker manager there.
  */
 @interface CC3OpenGLES11Engine : CC3OpenGLES11StateTracker {
+	CC3GLESStateCache stateCache;
 	CCArray* trackersToOpen;
 	CCArray* trackersToClose;
 	CC3OpenGLES11Platform* platform;
@@ -113,6 +114,15 @@
 	BOOL trackerToOpenWasAdded;
 }
 
+/**
+ * The compact cache holding the values of all of the primitive trackers attached to this engine.
+ *
+ * Each CC3OpenGLES11StateTrackerPrimitive is a facade over an entry in this cache. Code that sets
+ * GL state frequently can use the inline CC3GLESStateCache functions with this cache, and the
+ * stateEntry property of a tracker, to filter redundant state changes without messaging the tracker.
+ */
+@property(nonatomic, readonly) CC3GLESStateCache* stateCache;
+
 /**
  * A collection of trackers that are to opened when this instance is opened
  * at the start of each frame render cycle.
@@ -120,6 +130,10 @@
  * Initially, most trackers are added to this collection automatically, but
  * any trackers that are set to read their GL state only once are removed
  * once the GL value has been read.
+ *
+ * Primitive trackers whose GL values can be read by the stateCache are not
+ * added to this collection, and are instead opened in a single pass over
+ * the stateCache.
  */
 @property(nonatomic, readonly) CCArray* trackersToOpen;
 
@@ -197,6 +211,9 @@
  * All gl* function calls that make changes to GL engine state made between
  * the invocation of this open method and the corresponding close method
  * MUST be routed through this CC3OpenGLES11Engine singleton.
+ *
+ * When the GL_RECORDING_ENABLED compiler switch is set, this method also marks
+ * the start of a new frame in any GL command stream that is being recorded.
  */
 -(void) open;
 
@@ -215,9 +232,9 @@
  * Invoked automatically when a tracker has been added somewhere in the hierarchy.
  *
  * When the CC3OpenGGLES11Engine singleton is created, all primitive element trackers
- * (CC3OpenGLES11StateTrackerPrimitive) are added using this method. When the open
- * method of this instance is invoked, those that need to read their original value
- * from the GL engine do so.
+ * (CC3OpenGLES11StateTrackerPrimitive) that read their own values from the GL engine
+ * are added using this method. When the open method of this instance is invoked, those
+ * that need to read their original value from the GL engine do so.
  *
  * Most trackers only need to be opened once in order to read the original value
  * from the GL engine. Once that has occurred, the tracker will be removed from
@@ -64,6 +64,7 @@
 	[appExtensions release];
 	[trackersToOpen release];
 	[trackersToClose releaseAsUnretained];		// Clears without releasing each element.
+	CC3GLESStateCacheDeallocate(&stateCache);
 
 	[super dealloc];
 }
@@ -71,11 +72,14 @@
 /** Wait a minute! I AM the engine! */
 -(CC3OpenGLES11Engine*) engine { return self; }
 
+-(CC3GLESStateCache*) stateCache { return &stateCache; }
+
 -(id) init {
 	if ( (self = [super init]) ) {
 		trackersToClose = [[CCArray arrayWithCapacity: 200] retain];
 		isClosing = NO;
 		trackerToOpenWasAdded = NO;
+		CC3GLESStateCacheInitialize(&stateCache);		// Must be ready before trackers are added
 		[self initializeTrackers];
 	}
 	return self;
@@ -116,6 +120,13 @@ static CC3OpenGLES11Engine* engine;
 }
 
 -(void) open {
+
+#if GL_RECORDING_ENABLED
+	CC3GLRecorderMarkFrame();
+#endif
+
+	// Read or reset the values of primitive trackers in one pass over the state cache.
+	CC3GLESStateCacheOpen(&stateCache);
 	
 	// Open each tracker that is to be opened.
 	LogTrace(@"%@ opening %i trackers", [self class], trackersToOpen.count);
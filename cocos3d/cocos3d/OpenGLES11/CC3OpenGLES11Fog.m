@@ -38,7 +38,7 @@
 @implementation CC3OpenGLES11StateTrackerFogColor
 
 -(void) setGLValue {
-	glFogfv(name, (GLfloat*)&value);
+	glFogfv(name, CC3GLESStateCacheFloats(stateCache, stateEntry));
 }
 
 +(CC3GLESStateOriginalValueHandling) defaultOriginalValueHandling {
@@ -54,7 +54,7 @@
 @implementation CC3OpenGLES11StateTrackerFogFloat
 
 -(void) setGLValue {
-	glFogf(name, value);
+	glFogf(name, self.value);
 }
 
 +(CC3GLESStateOriginalValueHandling) defaultOriginalValueHandling {
@@ -70,7 +70,7 @@
 @implementation CC3OpenGLES11StateTrackerFogEnumeration
 
 -(void) setGLValue {
-	glFogx(name, value);
+	glFogx(name, self.value);
 }
 
 +(CC3GLESStateOriginalValueHandling) defaultOriginalValueHandling {
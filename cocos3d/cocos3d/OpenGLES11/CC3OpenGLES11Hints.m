@@ -38,19 +38,19 @@
 @implementation CC3OpenGLES11StateTrackerHintEnumeration
 
 -(void) setGLValue {
-	glHint(name, value);
+	glHint(name, self.value);
 }
 
 -(void) useNicest {
-	value = GL_NICEST;
+	[self setValueRaw: GL_NICEST];
 }
 
 -(void) useFastest {
-	value = GL_FASTEST;
+	[self setValueRaw: GL_FASTEST];
 }
 
 -(void) useDontCare {
-	value = GL_DONT_CARE;
+	[self setValueRaw: GL_DONT_CARE];
 }
 
 +(CC3GLESStateOriginalValueHandling) defaultOriginalValueHandling {
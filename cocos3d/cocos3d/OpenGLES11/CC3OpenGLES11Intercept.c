@@ -32,10 +32,25 @@
 #include <OpenGLES/ES1/gl.h>
 #include <OpenGLES/ES1/glext.h>
 #include "CC3OpenGLES11Utility.h"
+#include "CC3OpenGLES11Recorder.h"
 // This file deliberately does NOT include the CC3OpenGLES11Intercept.h file
 // because doing so would swap out the actual gl* calls! This implementation
 // file must have access to the actual gl* functions.
 
+#ifndef GL_LOGGING_ENABLED
+#	define GL_LOGGING_ENABLED		0
+#endif
+
+// The intercepted calls are logged only when logging is enabled. They may also be
+// intercepted just to be recorded, in which case nothing is printed.
+#if GL_LOGGING_ENABLED
+#	define LogGLCall(...)	printf(__VA_ARGS__)
+#	define LogGLData(...)	PrintGLData(__VA_ARGS__)
+#else
+#	define LogGLCall(...)
+#	define LogGLData(...)
+#endif
+
 #ifndef kPrintGLDataVertexCount
 #	define kPrintGLDataVertexCount 8
 #endif
@@ -98,756 +113,900 @@ void PrintGLData(GLint elemSize, GLenum dataType, GLsizei stride, GLuint elemCou
 #pragma mark OpenGLES base
 
 void glAlphaFuncLogged(GLenum func, GLclampf ref) {
-	printf("glAlphaFunc(%s, %.2f)\n", GLEnumName(func), ref);
+	LogGLCall("glAlphaFunc(%s, %.2f)\n", GLEnumName(func), ref);
+	CC3GLRecord(kCC3GLCmd_glAlphaFunc, func, CC3GLFloatWord(ref));
 	glAlphaFunc(func, ref);
 }
 
 void glClearColorLogged(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha) {
-	printf("glClearColor(%.2f, %.2f, %.2f, %.2f)\n", red, green, blue, alpha);
+	LogGLCall("glClearColor(%.2f, %.2f, %.2f, %.2f)\n", red, green, blue, alpha);
+	CC3GLRecord(kCC3GLCmd_glClearColor, CC3GLFloatWord(red), CC3GLFloatWord(green), CC3GLFloatWord(blue), CC3GLFloatWord(alpha));
 	glClearColor(red, green, blue, alpha);
 }
 
 void glClearDepthfLogged(GLclampf depth) {
-	printf("glClearDepthf(%.2f)\n", depth);
+	LogGLCall("glClearDepthf(%.2f)\n", depth);
+	CC3GLRecord(kCC3GLCmd_glClearDepthf, CC3GLFloatWord(depth));
 	glClearDepthf(depth);
 }
 
 void glClipPlanefLogged(GLenum plane, const GLfloat *equation) {
-	printf("glClipPlanef(%s, %p)\n", GLEnumName(plane), equation);
+	LogGLCall("glClipPlanef(%s, %p)\n", GLEnumName(plane), equation);
+	CC3GLRecordData(kCC3GLCmd_glClipPlanef, equation, 4 * sizeof(GLfloat), plane);
 	glClipPlanef(plane, equation);
 }
 
 void glColor4fLogged(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
-	printf("glColor4f(%.2f, %.2f, %.2f, %.2f)\n", red, green, blue, alpha);
+	LogGLCall("glColor4f(%.2f, %.2f, %.2f, %.2f)\n", red, green, blue, alpha);
+	CC3GLRecord(kCC3GLCmd_glColor4f, CC3GLFloatWord(red), CC3GLFloatWord(green), CC3GLFloatWord(blue), CC3GLFloatWord(alpha));
 	glColor4f(red, green, blue, alpha);
 }
 
 void glDepthRangefLogged(GLclampf zNear, GLclampf zFar) {
-	printf("glDepthRangef(%.2f, %.2f)\n", zNear, zFar);
+	LogGLCall("glDepthRangef(%.2f, %.2f)\n", zNear, zFar);
+	CC3GLRecord(kCC3GLCmd_glDepthRangef, CC3GLFloatWord(zNear), CC3GLFloatWord(zFar));
 	glDepthRangef(zNear, zFar);
 }
 
 void glFogfLogged(GLenum pname, GLfloat param) {
-	printf("glFogf(%s, %.2f)\n", GLEnumName(pname), param);
+	LogGLCall("glFogf(%s, %.2f)\n", GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glFogf, pname, CC3GLFloatWord(param));
 	glFogf(pname, param);
 }
 
 void glFogfvLogged(GLenum pname, const GLfloat *params) {
-	printf("glFogfv(%s, %p)\n", GLEnumName(pname), params);
+	LogGLCall("glFogfv(%s, %p)\n", GLEnumName(pname), params);
+	CC3GLRecordData(kCC3GLCmd_glFogfv, params, CC3GLParameterCount(pname) * sizeof(GLfloat), pname);
 	glFogfv(pname, params);
 }
 
 void glFrustumfLogged(GLfloat left, GLfloat right, GLfloat bottom, GLfloat top, GLfloat zNear, GLfloat zFar) {
-	printf("glFrustumf(%.2f, %.2f, %.2f, %.2f, %.2f, %.2f)\n", left, right, bottom, top, zNear, zFar);
+	LogGLCall("glFrustumf(%.2f, %.2f, %.2f, %.2f, %.2f, %.2f)\n", left, right, bottom, top, zNear, zFar);
+	CC3GLRecord(kCC3GLCmd_glFrustumf, CC3GLFloatWord(left), CC3GLFloatWord(right), CC3GLFloatWord(bottom), CC3GLFloatWord(top), CC3GLFloatWord(zNear), CC3GLFloatWord(zFar));
 	glFrustumf(left, right, bottom, top, zNear, zFar);
 }
 
 void glGetClipPlanefLogged(GLenum pname, GLfloat *equation) {
-	printf("glGetClipPlanef(%s, %p)\n", GLEnumName(pname), equation);
+	LogGLCall("glGetClipPlanef(%s, %p)\n", GLEnumName(pname), equation);
+	CC3GLRecord(kCC3GLCmd_glGetClipPlanef, pname);
 	glGetClipPlanef(pname, equation);
 }
 
 void glGetFloatvLogged(GLenum pname, GLfloat *params) {
-	printf("glGetFloatv(%s, %p)\n", GLEnumName(pname), params);
+	LogGLCall("glGetFloatv(%s, %p)\n", GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetFloatv, pname);
 	glGetFloatv(pname, params);
 }
 
 void glGetLightfvLogged(GLenum light, GLenum pname, GLfloat *params) {
-	printf("glGetLightfv(%s, %s, %p)\n", GLEnumName(light), GLEnumName(pname), params);
+	LogGLCall("glGetLightfv(%s, %s, %p)\n", GLEnumName(light), GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetLightfv, light, pname);
 	glGetLightfv(light, pname, params);
 }
 
 void glGetMaterialfvLogged(GLenum face, GLenum pname, GLfloat *params) {
-	printf("glGetMaterialfv(%s, %s, %p)\n", GLEnumName(face), GLEnumName(pname), params);
+	LogGLCall("glGetMaterialfv(%s, %s, %p)\n", GLEnumName(face), GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetMaterialfv, face, pname);
 	glGetMaterialfv(face, pname, params);
 }
 
 void glGetTexEnvfvLogged(GLenum env, GLenum pname, GLfloat *params) {
-	printf("glGetTexEnvfv(%s, %s, %p)\n", GLEnumName(env), GLEnumName(pname), params);
+	LogGLCall("glGetTexEnvfv(%s, %s, %p)\n", GLEnumName(env), GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetTexEnvfv, env, pname);
 	glGetTexEnvfv(env, pname, params);
 }
 
 void glGetTexParameterfvLogged(GLenum target, GLenum pname, GLfloat *params) {
-	printf("glGetTexParameterfv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	LogGLCall("glGetTexParameterfv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetTexParameterfv, target, pname);
 	glGetTexParameterfv(target, pname, params);
 }
 
 void glLightModelfLogged(GLenum pname, GLfloat param) {
-	printf("glLightModelf(%s, %.2f)\n", GLEnumName(pname), param);
+	LogGLCall("glLightModelf(%s, %.2f)\n", GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glLightModelf, pname, CC3GLFloatWord(param));
 	glLightModelf(pname, param);
 }
 
 void glLightModelfvLogged(GLenum pname, const GLfloat *params) {
-	printf("glLightModelfv(%s, %p)\n", GLEnumName(pname), params);
+	LogGLCall("glLightModelfv(%s, %p)\n", GLEnumName(pname), params);
+	CC3GLRecordData(kCC3GLCmd_glLightModelfv, params, CC3GLParameterCount(pname) * sizeof(GLfloat), pname);
 	glLightModelfv(pname, params);
 }
 
 void glLightfLogged(GLenum light, GLenum pname, GLfloat param) {
-	printf("glLightf(%s, %s, %.2f)\n", GLEnumName(light), GLEnumName(pname), param);
+	LogGLCall("glLightf(%s, %s, %.2f)\n", GLEnumName(light), GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glLightf, light, pname, CC3GLFloatWord(param));
 	glLightf(light, pname, param);
 }
 
 void glLightfvLogged(GLenum light, GLenum pname, const GLfloat *params) {
-	printf("glLightfv(%s, %s, %p)\n", GLEnumName(light), GLEnumName(pname), params);
-	PrintGLData(1, GL_FLOAT, 0, 4, params);
+	LogGLCall("glLightfv(%s, %s, %p)\n", GLEnumName(light), GLEnumName(pname), params);
+	LogGLData(1, GL_FLOAT, 0, 4, params);
+	CC3GLRecordData(kCC3GLCmd_glLightfv, params, CC3GLParameterCount(pname) * sizeof(GLfloat), light, pname);
 	glLightfv(light, pname, params);
 }
 
 void glLineWidthLogged(GLfloat width) {
-	printf("glLineWidth(%.2f)\n", width);
+	LogGLCall("glLineWidth(%.2f)\n", width);
+	CC3GLRecord(kCC3GLCmd_glLineWidth, CC3GLFloatWord(width));
 	glLineWidth(width);
 }
 
 void glLoadMatrixfLogged(const GLfloat *m) {
-	printf("glLoadMatrixf(%p)\n", m);
+	LogGLCall("glLoadMatrixf(%p)\n", m);
+	CC3GLRecordCommandData(kCC3GLCmd_glLoadMatrixf, m, 16 * sizeof(GLfloat));
 	glLoadMatrixf(m);
 }
 
 void glMaterialfLogged(GLenum face, GLenum pname, GLfloat param) {
-	printf("glMaterialf(%s, %s, %.2f)\n", GLEnumName(face), GLEnumName(pname), param);
+	LogGLCall("glMaterialf(%s, %s, %.2f)\n", GLEnumName(face), GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glMaterialf, face, pname, CC3GLFloatWord(param));
 	glMaterialf(face, pname, param);
 }
 
 void glMaterialfvLogged(GLenum face, GLenum pname, const GLfloat *params) {
-	printf("glMaterialfv(%s, %s, %p)\n", GLEnumName(face), GLEnumName(pname), params);
-	PrintGLData(1, GL_FLOAT, 0, 4, params);
+	LogGLCall("glMaterialfv(%s, %s, %p)\n", GLEnumName(face), GLEnumName(pname), params);
+	LogGLData(1, GL_FLOAT, 0, 4, params);
+	CC3GLRecordData(kCC3GLCmd_glMaterialfv, params, CC3GLParameterCount(pname) * sizeof(GLfloat), face, pname);
 	glMaterialfv(face, pname, params);
 }
 
 void glMultMatrixfLogged(const GLfloat *m) {
-	printf("glMultMatrixf(%p)\n", m);
+	LogGLCall("glMultMatrixf(%p)\n", m);
+	CC3GLRecordCommandData(kCC3GLCmd_glMultMatrixf, m, 16 * sizeof(GLfloat));
 	glMultMatrixf(m);
 }
 
 void glMultiTexCoord4fLogged(GLenum target, GLfloat s, GLfloat t, GLfloat r, GLfloat q) {
-	printf("glMultiTexCoord4f(%s, %.2f, %.2f, %.2f, %.2f)\n", GLEnumName(target), s, t, r, q);
+	LogGLCall("glMultiTexCoord4f(%s, %.2f, %.2f, %.2f, %.2f)\n", GLEnumName(target), s, t, r, q);
+	CC3GLRecord(kCC3GLCmd_glMultiTexCoord4f, target, CC3GLFloatWord(s), CC3GLFloatWord(t), CC3GLFloatWord(r), CC3GLFloatWord(q));
 	glMultiTexCoord4f(target, s, t, r, q);
 }
 
 void glNormal3fLogged(GLfloat nx, GLfloat ny, GLfloat nz) {
-	printf("glNormal3f(%.2f, %.2f, %.2f)\n", nx, ny, nz);
+	LogGLCall("glNormal3f(%.2f, %.2f, %.2f)\n", nx, ny, nz);
+	CC3GLRecord(kCC3GLCmd_glNormal3f, CC3GLFloatWord(nx), CC3GLFloatWord(ny), CC3GLFloatWord(nz));
 	glNormal3f(nx, ny, nz);
 }
 
 void glOrthofLogged(GLfloat left, GLfloat right, GLfloat bottom, GLfloat top, GLfloat zNear, GLfloat zFar) {
-	printf("glOrthof(%.2f, %.2f, %.2f, %.2f, %.2f, %.2f)\n", left, right, bottom, top, zNear, zFar);
+	LogGLCall("glOrthof(%.2f, %.2f, %.2f, %.2f, %.2f, %.2f)\n", left, right, bottom, top, zNear, zFar);
+	CC3GLRecord(kCC3GLCmd_glOrthof, CC3GLFloatWord(left), CC3GLFloatWord(right), CC3GLFloatWord(bottom), CC3GLFloatWord(top), CC3GLFloatWord(zNear), CC3GLFloatWord(zFar));
 	glOrthof(left, right, bottom, top, zNear, zFar);
 }
 
 void glPointParameterfLogged(GLenum pname, GLfloat param) {
-	printf("glPointParameterf(%s, %.2f)\n", GLEnumName(pname), param);
+	LogGLCall("glPointParameterf(%s, %.2f)\n", GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glPointParameterf, pname, CC3GLFloatWord(param));
 	glPointParameterf(pname, param);
 }
 
 void glPointParameterfvLogged(GLenum pname, const GLfloat *params) {
-	printf("glPointParameterfv(%s, %p)\n", GLEnumName(pname), params);
+	LogGLCall("glPointParameterfv(%s, %p)\n", GLEnumName(pname), params);
+	CC3GLRecordData(kCC3GLCmd_glPointParameterfv, params, CC3GLParameterCount(pname) * sizeof(GLfloat), pname);
 	glPointParameterfv(pname, params);
 }
 
 void glPointSizeLogged(GLfloat size) {
-	printf("glPointSize(%.2f)\n", size);
+	LogGLCall("glPointSize(%.2f)\n", size);
+	CC3GLRecord(kCC3GLCmd_glPointSize, CC3GLFloatWord(size));
 	glPointSize(size);
 }
 
 void glPolygonOffsetLogged(GLfloat factor, GLfloat units) {
-	printf("glPolygonOffset(%.2f, %.2f)\n", factor, units);
+	LogGLCall("glPolygonOffset(%.2f, %.2f)\n", factor, units);
+	CC3GLRecord(kCC3GLCmd_glPolygonOffset, CC3GLFloatWord(factor), CC3GLFloatWord(units));
 	glPolygonOffset(factor, units);
 }
 
 void glRotatefLogged(GLfloat angle, GLfloat x, GLfloat y, GLfloat z) {
-	printf("glRotatef(%.2f, %.2f, %.2f, %.2f)\n", angle, x, y, z);
+	LogGLCall("glRotatef(%.2f, %.2f, %.2f, %.2f)\n", angle, x, y, z);
+	CC3GLRecord(kCC3GLCmd_glRotatef, CC3GLFloatWord(angle), CC3GLFloatWord(x), CC3GLFloatWord(y), CC3GLFloatWord(z));
 	glRotatef(angle, x, y, z);
 }
 
 void glScalefLogged(GLfloat x, GLfloat y, GLfloat z) {
-	printf("glScalef(%.2f, %.2f, %.2f)\n", x, y, z);
+	LogGLCall("glScalef(%.2f, %.2f, %.2f)\n", x, y, z);
+	CC3GLRecord(kCC3GLCmd_glScalef, CC3GLFloatWord(x), CC3GLFloatWord(y), CC3GLFloatWord(z));
 	glScalef(x, y, z);
 }
 
 void glTexEnvfLogged(GLenum target, GLenum pname, GLfloat param) {
-	printf("glTexEnvf(%s, %s, %.2f)\n", GLEnumName(target), GLEnumName(pname), param);
+	LogGLCall("glTexEnvf(%s, %s, %.2f)\n", GLEnumName(target), GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glTexEnvf, target, pname, CC3GLFloatWord(param));
 	glTexEnvf(target, pname, param);
 }
 
 void glTexEnvfvLogged(GLenum target, GLenum pname, const GLfloat *params) {
-	printf("glTexEnvfv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	LogGLCall("glTexEnvfv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	CC3GLRecordData(kCC3GLCmd_glTexEnvfv, params, CC3GLParameterCount(pname) * sizeof(GLfloat), target, pname);
 	glTexEnvfv(target, pname, params);
 }
 
 void glTexParameterfLogged(GLenum target, GLenum pname, GLfloat param) {
-	printf("glTexParameterf(%s, %s, %.2f)\n", GLEnumName(target), GLEnumName(pname), param);
+	LogGLCall("glTexParameterf(%s, %s, %.2f)\n", GLEnumName(target), GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glTexParameterf, target, pname, CC3GLFloatWord(param));
 	glTexParameterf(target, pname, param);
 }
 
 void glTexParameterfvLogged(GLenum target, GLenum pname, const GLfloat *params) {
-	printf("glTexParameterfv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	LogGLCall("glTexParameterfv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	CC3GLRecordData(kCC3GLCmd_glTexParameterfv, params, CC3GLParameterCount(pname) * sizeof(GLfloat), target, pname);
 	glTexParameterfv(target, pname, params);
 }
 
 void glTranslatefLogged(GLfloat x, GLfloat y, GLfloat z) {
-	printf("glTranslatef(%.2f, %.2f, %.2f)\n", x, y, z);
+	LogGLCall("glTranslatef(%.2f, %.2f, %.2f)\n", x, y, z);
+	CC3GLRecord(kCC3GLCmd_glTranslatef, CC3GLFloatWord(x), CC3GLFloatWord(y), CC3GLFloatWord(z));
 	glTranslatef(x, y, z);
 }
 
 void glActiveTextureLogged(GLenum texture) {
-	printf("glActiveTexture(%s)\n", GLEnumName(texture));
+	LogGLCall("glActiveTexture(%s)\n", GLEnumName(texture));
+	CC3GLRecord(kCC3GLCmd_glActiveTexture, texture);
 	glActiveTexture(texture);
 }
 
 void glAlphaFuncxLogged(GLenum func, GLclampx ref) {
-	printf("glAlphaFuncx(%s, %i)\n", GLEnumName(func), ref);
+	LogGLCall("glAlphaFuncx(%s, %i)\n", GLEnumName(func), ref);
+	CC3GLRecord(kCC3GLCmd_glAlphaFuncx, func, (GLuint)ref);
 	glAlphaFuncx(func, ref);
 }
 
 void glBindBufferLogged(GLenum target, GLuint buffer) {
-	printf("glBindBuffer(%s, %u)\n", GLEnumName(target), buffer);
+	LogGLCall("glBindBuffer(%s, %u)\n", GLEnumName(target), buffer);
+	CC3GLRecord(kCC3GLCmd_glBindBuffer, target, buffer);
 	glBindBuffer(target, buffer);
 }
 
 void glBindTextureLogged(GLenum target, GLuint texture) {
-	printf("glBindTexture(%s, %u)\n", GLEnumName(target), texture);
+	LogGLCall("glBindTexture(%s, %u)\n", GLEnumName(target), texture);
+	CC3GLRecord(kCC3GLCmd_glBindTexture, target, texture);
 	glBindTexture(target, texture);
 }
 
 void glBlendFuncLogged(GLenum sfactor, GLenum dfactor) {
-	printf("glBlendFunc(%s, %s)\n", GLEnumName(sfactor), GLEnumName(dfactor));
+	LogGLCall("glBlendFunc(%s, %s)\n", GLEnumName(sfactor), GLEnumName(dfactor));
+	CC3GLRecord(kCC3GLCmd_glBlendFunc, sfactor, dfactor);
 	glBlendFunc(sfactor, dfactor);
 }
 
 void glBufferDataLogged(GLenum target, GLsizeiptr size, const GLvoid *data, GLenum usage) {
-	printf("glBufferData(%s, %ld, %p, %s)\n", GLEnumName(target), (long)size, data, GLEnumName(usage));
+	LogGLCall("glBufferData(%s, %ld, %p, %s)\n", GLEnumName(target), (long)size, data, GLEnumName(usage));
 	switch (target) {
 		case GL_ARRAY_BUFFER:
-			printf("As floats:");
-			PrintGLData(1, GL_FLOAT, 0, kPrintGLDataBufferDataCount, data);
+			LogGLCall("As floats:");
+			LogGLData(1, GL_FLOAT, 0, kPrintGLDataBufferDataCount, data);
 			break;
 		case GL_ELEMENT_ARRAY_BUFFER:
-			printf("As shorts:");
-			PrintGLData(1, GL_UNSIGNED_SHORT, 0, kPrintGLDataBufferDataCount, data);
+			LogGLCall("As shorts:");
+			LogGLData(1, GL_UNSIGNED_SHORT, 0, kPrintGLDataBufferDataCount, data);
 			break;
 		default:
 			break;
 	}
+	CC3GLRecordData(kCC3GLCmd_glBufferData, data, size, target, (GLuint)size, CC3GLPointerWord(data), usage);
 	glBufferData(target, size, data, usage);
 }
 
 void glBufferSubDataLogged(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid *data) {
-	printf("glBufferSubData(%s, %ld, %ld, %p)\n", GLEnumName(target), (long)offset, (long)size, data);
+	LogGLCall("glBufferSubData(%s, %ld, %ld, %p)\n", GLEnumName(target), (long)offset, (long)size, data);
 	switch (target) {
 		case GL_ARRAY_BUFFER:
-			printf("As floats:");
-			PrintGLData(1, GL_FLOAT, 0, kPrintGLDataBufferDataCount, data + offset);
+			LogGLCall("As floats:");
+			LogGLData(1, GL_FLOAT, 0, kPrintGLDataBufferDataCount, data + offset);
 			break;
 		case GL_ELEMENT_ARRAY_BUFFER:
-			printf("As shorts:");
-			PrintGLData(1, GL_UNSIGNED_SHORT, 0, kPrintGLDataBufferDataCount, data + offset);
+			LogGLCall("As shorts:");
+			LogGLData(1, GL_UNSIGNED_SHORT, 0, kPrintGLDataBufferDataCount, data + offset);
 			break;
 		default:
 			break;
 	}
+	CC3GLRecordData(kCC3GLCmd_glBufferSubData, data, size, target, (GLuint)offset, (GLuint)size, CC3GLPointerWord(data));
 	glBufferSubData(target, offset, size, data);
 }
 
 void glClearLogged(GLbitfield mask) {
-	printf("glClear(%X)\n", mask);
+	LogGLCall("glClear(%X)\n", mask);
+	CC3GLRecord(kCC3GLCmd_glClear, mask);
 	glClear(mask);
 }
 
 void glClearColorxLogged(GLclampx red, GLclampx green, GLclampx blue, GLclampx alpha) {
-	printf("glClearColorx(%i, %i, %i, %i)\n", red, green, blue, alpha);
+	LogGLCall("glClearColorx(%i, %i, %i, %i)\n", red, green, blue, alpha);
+	CC3GLRecord(kCC3GLCmd_glClearColorx, (GLuint)red, (GLuint)green, (GLuint)blue, (GLuint)alpha);
 	glClearColorx(red, green, blue, alpha);
 }
 
 void glClearDepthxLogged(GLclampx depth) {
-	printf("glClearDepthx(%i)\n", depth);
+	LogGLCall("glClearDepthx(%i)\n", depth);
+	CC3GLRecord(kCC3GLCmd_glClearDepthx, (GLuint)depth);
 	glClearDepthx(depth);
 }
 
 void glClearStencilLogged(GLint s) {
-	printf("glClearStencil(%i)\n", s);
+	LogGLCall("glClearStencil(%i)\n", s);
+	CC3GLRecord(kCC3GLCmd_glClearStencil, (GLuint)s);
 	glClearStencil(s);
 }
 
 void glClientActiveTextureLogged(GLenum texture) {
-	printf("glClientActiveTexture(%s)\n", GLEnumName(texture));
+	LogGLCall("glClientActiveTexture(%s)\n", GLEnumName(texture));
+	CC3GLRecord(kCC3GLCmd_glClientActiveTexture, texture);
 	glClientActiveTexture(texture);
 }
 
 void glClipPlanexLogged(GLenum plane, const GLfixed *equation) {
-	printf("glClipPlanex(%s, %p)\n", GLEnumName(plane), equation);
+	LogGLCall("glClipPlanex(%s, %p)\n", GLEnumName(plane), equation);
+	CC3GLRecordData(kCC3GLCmd_glClipPlanex, equation, 4 * sizeof(GLfixed), plane);
 	glClipPlanex(plane, equation);
 }
 
 void glColor4ubLogged(GLubyte red, GLubyte green, GLubyte blue, GLubyte alpha) {
-	printf("glColor4ub(%u, %u, %u, %u)\n", red, green, blue, alpha);
+	LogGLCall("glColor4ub(%u, %u, %u, %u)\n", red, green, blue, alpha);
+	CC3GLRecord(kCC3GLCmd_glColor4ub, (GLuint)red, (GLuint)green, (GLuint)blue, (GLuint)alpha);
 	glColor4ub(red, green, blue, alpha);
 }
 
 void glColor4xLogged(GLfixed red, GLfixed green, GLfixed blue, GLfixed alpha) {
-	printf("glColor4x(%i, %i, %i, %i)\n", red, green, blue, alpha);
+	LogGLCall("glColor4x(%i, %i, %i, %i)\n", red, green, blue, alpha);
+	CC3GLRecord(kCC3GLCmd_glColor4x, (GLuint)red, (GLuint)green, (GLuint)blue, (GLuint)alpha);
 	glColor4x(red, green, blue, alpha);
 }
 
 void glColorMaskLogged(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) {
-	printf("glColorMask(%u, %u, %u, %u)\n", red, green, blue, alpha);
+	LogGLCall("glColorMask(%u, %u, %u, %u)\n", red, green, blue, alpha);
+	CC3GLRecord(kCC3GLCmd_glColorMask, (GLuint)red, (GLuint)green, (GLuint)blue, (GLuint)alpha);
 	glColorMask(red, green, blue, alpha);
 }
 
 void glColorPointerLogged(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer) {
-	printf("glColorPointer(%i, %s, %i, %p)\n", size, GLEnumName(type), stride, pointer);
-	PrintGLData(size, type, stride, kPrintGLDataVertexCount, pointer);
+	LogGLCall("glColorPointer(%i, %s, %i, %p)\n", size, GLEnumName(type), stride, pointer);
+	LogGLData(size, type, stride, kPrintGLDataVertexCount, pointer);
+	CC3GLRecordVertexArray(kCC3GLCmd_glColorPointer, GL_COLOR_ARRAY, size, type, stride, pointer);
 	glColorPointer(size, type, stride, pointer);
 }
 
 void glCompressedTexImage2DLogged(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid *data) {
-	printf("glCompressedTexImage2D(%s, %i, %s, %i, %i, %i, %i, %p)\n", GLEnumName(target), level, GLEnumName(internalformat), width, height, border, imageSize, data);
+	LogGLCall("glCompressedTexImage2D(%s, %i, %s, %i, %i, %i, %i, %p)\n", GLEnumName(target), level, GLEnumName(internalformat), width, height, border, imageSize, data);
+	CC3GLRecordData(kCC3GLCmd_glCompressedTexImage2D, data, imageSize, target, (GLuint)level, internalformat, (GLuint)width, (GLuint)height, (GLuint)border, (GLuint)imageSize, CC3GLPointerWord(data));
 	glCompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
 }
 
 void glCompressedTexSubImage2DLogged(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const GLvoid *data) {
-	printf("glCompressedTexSubImage2D(%s, %i, %i, %i, %i, %i, %s, %i, %p)\n", GLEnumName(target), level, xoffset, yoffset, width, height, GLEnumName(format), imageSize, data);
+	LogGLCall("glCompressedTexSubImage2D(%s, %i, %i, %i, %i, %i, %s, %i, %p)\n", GLEnumName(target), level, xoffset, yoffset, width, height, GLEnumName(format), imageSize, data);
+	CC3GLRecordData(kCC3GLCmd_glCompressedTexSubImage2D, data, imageSize, target, (GLuint)level, (GLuint)xoffset, (GLuint)yoffset, (GLuint)width, (GLuint)height, format, (GLuint)imageSize, CC3GLPointerWord(data));
 	glCompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize, data);
 }
 
 void glCopyTexImage2DLogged(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border) {
-	printf("glCopyTexImage2D(%s, %i, %s, %i, %i, %i, %i, %i)\n", GLEnumName(target), level, GLEnumName(internalformat), x, y, width, height, border);
+	LogGLCall("glCopyTexImage2D(%s, %i, %s, %i, %i, %i, %i, %i)\n", GLEnumName(target), level, GLEnumName(internalformat), x, y, width, height, border);
+	CC3GLRecord(kCC3GLCmd_glCopyTexImage2D, target, (GLuint)level, internalformat, (GLuint)x, (GLuint)y, (GLuint)width, (GLuint)height, (GLuint)border);
 	glCopyTexImage2D(target, level, internalformat, x, y, width, height, border);
 }
 
 void glCopyTexSubImage2DLogged(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height) {
-	printf("glCopyTexSubImage2D(%s, %i, %i, %i, %i, %i, %i, %i)\n", GLEnumName(target), level, xoffset, yoffset, x, y, width, height);
+	LogGLCall("glCopyTexSubImage2D(%s, %i, %i, %i, %i, %i, %i, %i)\n", GLEnumName(target), level, xoffset, yoffset, x, y, width, height);
+	CC3GLRecord(kCC3GLCmd_glCopyTexSubImage2D, target, (GLuint)level, (GLuint)xoffset, (GLuint)yoffset, (GLuint)x, (GLuint)y, (GLuint)width, (GLuint)height);
 	glCopyTexSubImage2D(target, level, xoffset, yoffset, x, y, width, height);
 }
 
 void glCullFaceLogged(GLenum mode) {
-	printf("glCullFace(%s)\n", GLEnumName(mode));
+	LogGLCall("glCullFace(%s)\n", GLEnumName(mode));
+	CC3GLRecord(kCC3GLCmd_glCullFace, mode);
 	glCullFace(mode);
 }
 
 void glDeleteBuffersLogged(GLsizei n, const GLuint *buffers) {
-	printf("glDeleteBuffers(%i, %p)\n", n, buffers);
+	LogGLCall("glDeleteBuffers(%i, %p)\n", n, buffers);
+	CC3GLRecordData(kCC3GLCmd_glDeleteBuffers, buffers, n * sizeof(GLuint), (GLuint)n);
 	glDeleteBuffers(n, buffers);
 }
 
 void glDeleteTexturesLogged(GLsizei n, const GLuint *textures) {
-	printf("glDeleteTextures(%i, %p)\n", n, textures);
+	LogGLCall("glDeleteTextures(%i, %p)\n", n, textures);
+	CC3GLRecordData(kCC3GLCmd_glDeleteTextures, textures, n * sizeof(GLuint), (GLuint)n);
 	glDeleteTextures(n, textures);
 }
 
 void glDepthFuncLogged(GLenum func) {
-	printf("glDepthFunc(%s)\n", GLEnumName(func));
+	LogGLCall("glDepthFunc(%s)\n", GLEnumName(func));
+	CC3GLRecord(kCC3GLCmd_glDepthFunc, func);
 	glDepthFunc(func);
 }
 
 void glDepthMaskLogged(GLboolean flag) {
-	printf("glDepthMask(%u)\n", flag);
+	LogGLCall("glDepthMask(%u)\n", flag);
+	CC3GLRecord(kCC3GLCmd_glDepthMask, (GLuint)flag);
 	glDepthMask(flag);
 }
 
 void glDepthRangexLogged(GLclampx zNear, GLclampx zFar) {
-	printf("glDepthRangex()\n");
+	LogGLCall("glDepthRangex()\n");
+	CC3GLRecord(kCC3GLCmd_glDepthRangex, (GLuint)zNear, (GLuint)zFar);
 	glDepthRangex(zNear, zFar);
 }
 
 void glDisableLogged(GLenum cap) {
-	printf("glDisable(%s)\n", GLEnumName(cap));
+	LogGLCall("glDisable(%s)\n", GLEnumName(cap));
+	CC3GLRecord(kCC3GLCmd_glDisable, cap);
 	glDisable(cap);
 }
 
 void glDisableClientStateLogged(GLenum array) {
-	printf("glDisableClientState(%s)\n", GLEnumName(array));
+	LogGLCall("glDisableClientState(%s)\n", GLEnumName(array));
+	CC3GLRecord(kCC3GLCmd_glDisableClientState, array);
 	glDisableClientState(array);
 }
 
 void glDrawArraysLogged(GLenum mode, GLint first, GLsizei count) {
-	printf("glDrawArrays(%s, %i, %i)\n", GLEnumName(mode), first, count);
+	LogGLCall("glDrawArrays(%s, %i, %i)\n", GLEnumName(mode), first, count);
+	CC3GLRecordDrawArrays(mode, first, count);
 	glDrawArrays(mode, first, count);
 }
 
 void glDrawElementsLogged(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices) {
-	printf("glDrawElements(%s, %i, %s, %p)\n", GLEnumName(mode), count, GLEnumName(type), indices);
-	PrintGLData(1, type, 0, kPrintGLDataVertexCount, indices);
+	LogGLCall("glDrawElements(%s, %i, %s, %p)\n", GLEnumName(mode), count, GLEnumName(type), indices);
+	LogGLData(1, type, 0, kPrintGLDataVertexCount, indices);
+	CC3GLRecordDrawElements(mode, count, type, indices);
 	glDrawElements(mode, count, type, indices);
 }
 
 void glEnableLogged(GLenum cap) {
-	printf("glEnable(%s)\n", GLEnumName(cap));
+	LogGLCall("glEnable(%s)\n", GLEnumName(cap));
+	CC3GLRecord(kCC3GLCmd_glEnable, cap);
 	glEnable(cap);
 }
 
 void glEnableClientStateLogged(GLenum array) {
-	printf("glEnableClientState(%s)\n", GLEnumName(array));
+	LogGLCall("glEnableClientState(%s)\n", GLEnumName(array));
+	CC3GLRecord(kCC3GLCmd_glEnableClientState, array);
 	glEnableClientState(array);
 }
 
 void glFinishLogged() {
-	printf("glFinish()\n");
+	LogGLCall("glFinish()\n");
+	CC3GLRecordCommand(kCC3GLCmd_glFinish);
 	glFinish();
 }
 
 void glFlushLogged() {
-	printf("glFlush()\n");
+	LogGLCall("glFlush()\n");
+	CC3GLRecordCommand(kCC3GLCmd_glFlush);
 	glFlush();
 }
 
 void glFogxLogged(GLenum pname, GLfixed param) {
-	printf("glFogx(%s, %i)\n", GLEnumName(pname), param);
+	LogGLCall("glFogx(%s, %i)\n", GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glFogx, pname, (GLuint)param);
 	glFogx(pname, param);
 }
 
 void glFogxvLogged(GLenum pname, const GLfixed *params) {
-	printf("glFogxv(%s, %p)\n", GLEnumName(pname), params);
+	LogGLCall("glFogxv(%s, %p)\n", GLEnumName(pname), params);
+	CC3GLRecordData(kCC3GLCmd_glFogxv, params, CC3GLParameterCount(pname) * sizeof(GLfixed), pname);
 	glFogxv(pname, params);
 }
 
 void glFrontFaceLogged(GLenum mode) {
-	printf("glFrontFace(%s)\n", GLEnumName(mode));
+	LogGLCall("glFrontFace(%s)\n", GLEnumName(mode));
+	CC3GLRecord(kCC3GLCmd_glFrontFace, mode);
 	glFrontFace(mode);
 }
 
 void glFrustumxLogged(GLfixed left, GLfixed right, GLfixed bottom, GLfixed top, GLfixed zNear, GLfixed zFar) {
-	printf("glFrustumx(%i, %i, %i, %i, %i, %i)\n", left, right, bottom, top, zNear, zFar);
+	LogGLCall("glFrustumx(%i, %i, %i, %i, %i, %i)\n", left, right, bottom, top, zNear, zFar);
+	CC3GLRecord(kCC3GLCmd_glFrustumx, (GLuint)left, (GLuint)right, (GLuint)bottom, (GLuint)top, (GLuint)zNear, (GLuint)zFar);
 	glFrustumx(left, right, bottom, top, zNear, zFar);
 }
 
 void glGetBooleanvLogged(GLenum pname, GLboolean *params) {
-	printf("glGetBooleanv(%s, %p)\n", GLEnumName(pname), params);
+	LogGLCall("glGetBooleanv(%s, %p)\n", GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetBooleanv, pname);
 	glGetBooleanv(pname, params);
 }
 
 void glGetBufferParameterivLogged(GLenum target, GLenum pname, GLint *params) {
-	printf("glGetBufferParameteriv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	LogGLCall("glGetBufferParameteriv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetBufferParameteriv, target, pname);
 	glGetBufferParameteriv(target, pname, params);
 }
 
 void glGetClipPlanexLogged(GLenum pname, GLfixed eqn[4]) {
-	printf("glGetClipPlanex(%s, %i, %i, %i, %i)\n", GLEnumName(pname), eqn[0], eqn[1], eqn[2], eqn[3]);
+	LogGLCall("glGetClipPlanex(%s, %i, %i, %i, %i)\n", GLEnumName(pname), eqn[0], eqn[1], eqn[2], eqn[3]);
+	CC3GLRecord(kCC3GLCmd_glGetClipPlanex, pname);
 	glGetClipPlanex(pname, eqn);
 }
 
 void glGenBuffersLogged(GLsizei n, GLuint *buffers) {
-	printf("glGenBuffers(%i, %p)\n", n, buffers);
+	LogGLCall("glGenBuffers(%i, %p)\n", n, buffers);
 	glGenBuffers(n, buffers);
+	CC3GLRecordData(kCC3GLCmd_glGenBuffers, buffers, n * sizeof(GLuint), (GLuint)n);
 }
 
 void glGenTexturesLogged(GLsizei n, GLuint *textures) {
-	printf("glGenTextures(%i, %p)\n", n, textures);
+	LogGLCall("glGenTextures(%i, %p)\n", n, textures);
 	glGenTextures(n, textures);
+	CC3GLRecordData(kCC3GLCmd_glGenTextures, textures, n * sizeof(GLuint), (GLuint)n);
 }
 
 GLenum glGetErrorLogged() {
-	printf("glGetError()\n");
+	LogGLCall("glGetError()\n");
+	CC3GLRecordCommand(kCC3GLCmd_glGetError);
 	return glGetError();
 }
 
 void glGetFixedvLogged(GLenum pname, GLfixed *params) {
-	printf("glGetFixedv()\n");
+	LogGLCall("glGetFixedv()\n");
+	CC3GLRecord(kCC3GLCmd_glGetFixedv, pname);
 	glGetFixedv(pname, params);
 }
 
 void glGetIntegervLogged(GLenum pname, GLint *params) {
-	printf("glGetIntegerv(%s, %p)\n", GLEnumName(pname), params);
+	LogGLCall("glGetIntegerv(%s, %p)\n", GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetIntegerv, pname);
 	glGetIntegerv(pname, params);
 }
 
 void glGetLightxvLogged(GLenum light, GLenum pname, GLfixed *params) {
-	printf("glGetLightxv(%s, %s, %p)\n", GLEnumName(light), GLEnumName(pname), params);
+	LogGLCall("glGetLightxv(%s, %s, %p)\n", GLEnumName(light), GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetLightxv, light, pname);
 	glGetLightxv(light, pname, params);
 }
 
 void glGetMaterialxvLogged(GLenum face, GLenum pname, GLfixed *params) {
-	printf("glGetMaterialxv(%s, %s, %p)\n", GLEnumName(face), GLEnumName(pname), params);
-	PrintGLData(1, GL_FIXED, 0, 4, params);
+	LogGLCall("glGetMaterialxv(%s, %s, %p)\n", GLEnumName(face), GLEnumName(pname), params);
+	LogGLData(1, GL_FIXED, 0, 4, params);
+	CC3GLRecord(kCC3GLCmd_glGetMaterialxv, face, pname);
 	glGetMaterialxv(face, pname, params);
 }
 
 void glGetPointervLogged(GLenum pname, void **params) {
-	printf("glGetPointerv(%s, %p)\n", GLEnumName(pname), params);
+	LogGLCall("glGetPointerv(%s, %p)\n", GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetPointerv, pname);
 	glGetPointerv(pname, params);
 }
 
 const GLubyte* glGetStringLogged(GLenum name) {
+	CC3GLRecord(kCC3GLCmd_glGetString, name);
 	const GLubyte* str = glGetString(name);
-	printf("glGetString(%s) = %s", GLEnumName(name), str);
+	LogGLCall("glGetString(%s) = %s", GLEnumName(name), str);
 	return str;
 }
 
 void glGetTexEnvivLogged(GLenum env, GLenum pname, GLint *params) {
-	printf("glGetTexEnviv(%s, %s, %p)\n", GLEnumName(env), GLEnumName(pname), params);
+	LogGLCall("glGetTexEnviv(%s, %s, %p)\n", GLEnumName(env), GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetTexEnviv, env, pname);
 	glGetTexEnviv(env, pname, params);
 }
 
 void glGetTexEnvxvLogged(GLenum env, GLenum pname, GLfixed *params) {
-	printf("glGetTexEnvxv(%s, %s, %p)\n", GLEnumName(env), GLEnumName(pname), params);
+	LogGLCall("glGetTexEnvxv(%s, %s, %p)\n", GLEnumName(env), GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetTexEnvxv, env, pname);
 	glGetTexEnvxv(env, pname, params);
 }
 
 void glGetTexParameterivLogged(GLenum target, GLenum pname, GLint *params) {
-	printf("glGetTexParameteriv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	LogGLCall("glGetTexParameteriv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetTexParameteriv, target, pname);
 	glGetTexParameteriv(target, pname, params);
 }
 
 void glGetTexParameterxvLogged(GLenum target, GLenum pname, GLfixed *params) {
-	printf("glGetTexParameterxv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	LogGLCall("glGetTexParameterxv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetTexParameterxv, target, pname);
 	glGetTexParameterxv(target, pname, params);
 }
 
 void glHintLogged(GLenum target, GLenum mode) {
-	printf("glHint(%s, %s)\n", GLEnumName(target), GLEnumName(mode));
+	LogGLCall("glHint(%s, %s)\n", GLEnumName(target), GLEnumName(mode));
+	CC3GLRecord(kCC3GLCmd_glHint, target, mode);
 	glHint(target, mode);
 }
 
 GLboolean glIsBufferLogged(GLuint buffer) {
-	printf("glIsBuffer(%u)\n", buffer);
+	LogGLCall("glIsBuffer(%u)\n", buffer);
+	CC3GLRecord(kCC3GLCmd_glIsBuffer, buffer);
 	return glIsBuffer(buffer);
 }
 
 GLboolean glIsEnabledLogged(GLenum cap) {
-	printf("glIsEnabled(%s)\n", GLEnumName(cap));
+	LogGLCall("glIsEnabled(%s)\n", GLEnumName(cap));
+	CC3GLRecord(kCC3GLCmd_glIsEnabled, cap);
 	return glIsEnabled(cap);
 }
 
 GLboolean glIsTextureLogged(GLuint texture) {
-	printf("glIsTexture(%u)\n", texture);
+	LogGLCall("glIsTexture(%u)\n", texture);
+	CC3GLRecord(kCC3GLCmd_glIsTexture, texture);
 	return glIsTexture(texture);
 }
 
 void glLightModelxLogged(GLenum pname, GLfixed param) {
-	printf("glLightModelx(%s, %i)\n", GLEnumName(pname), param);
+	LogGLCall("glLightModelx(%s, %i)\n", GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glLightModelx, pname, (GLuint)param);
 	glLightModelx(pname, param);
 }
 
 void glLightModelxvLogged(GLenum pname, const GLfixed *params) {
-	printf("glLightModelxv(%s, %p)\n", GLEnumName(pname), params);
+	LogGLCall("glLightModelxv(%s, %p)\n", GLEnumName(pname), params);
+	CC3GLRecordData(kCC3GLCmd_glLightModelxv, params, CC3GLParameterCount(pname) * sizeof(GLfixed), pname);
 	glLightModelxv(pname, params);
 }
 
 void glLightxLogged(GLenum light, GLenum pname, GLfixed param) {
-	printf("glLightx(%s, %s, %i)\n", GLEnumName(light), GLEnumName(pname), param);
+	LogGLCall("glLightx(%s, %s, %i)\n", GLEnumName(light), GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glLightx, light, pname, (GLuint)param);
 	glLightx(light, pname, param);
 }
 
 void glLightxvLogged(GLenum light, GLenum pname, const GLfixed *params) {
-	printf("glLightxv(%s, %s, %p)\n", GLEnumName(light), GLEnumName(pname), params);
-	PrintGLData(1, GL_FIXED, 0, 4, params);
+	LogGLCall("glLightxv(%s, %s, %p)\n", GLEnumName(light), GLEnumName(pname), params);
+	LogGLData(1, GL_FIXED, 0, 4, params);
+	CC3GLRecordData(kCC3GLCmd_glLightxv, params, CC3GLParameterCount(pname) * sizeof(GLfixed), light, pname);
 	glLightxv(light, pname, params);
 }
 
 void glLineWidthxLogged(GLfixed width) {
-	printf("glLineWidthx(%i)\n", width);
+	LogGLCall("glLineWidthx(%i)\n", width);
+	CC3GLRecord(kCC3GLCmd_glLineWidthx, (GLuint)width);
 	glLineWidthx(width);
 }
 
 void glLoadIdentityLogged() {
-	printf("glLoadIdentity()\n");
+	LogGLCall("glLoadIdentity()\n");
+	CC3GLRecordCommand(kCC3GLCmd_glLoadIdentity);
 	glLoadIdentity();
 }
 
 void glLoadMatrixxLogged(const GLfixed *m) {
-	printf("glLoadMatrixx(%p)\n", m);
+	LogGLCall("glLoadMatrixx(%p)\n", m);
+	CC3GLRecordCommandData(kCC3GLCmd_glLoadMatrixx, m, 16 * sizeof(GLfixed));
 	glLoadMatrixx(m);
 }
 
 void glLogicOpLogged(GLenum opcode) {
-	printf("glLogicOp(%s)\n", GLEnumName(opcode));
+	LogGLCall("glLogicOp(%s)\n", GLEnumName(opcode));
+	CC3GLRecord(kCC3GLCmd_glLogicOp, opcode);
 	glLogicOp(opcode);
 }
 
 void glMaterialxLogged(GLenum face, GLenum pname, GLfixed param) {
-	printf("glMaterialx(%s, %s, %i)\n", GLEnumName(face), GLEnumName(pname), param);
+	LogGLCall("glMaterialx(%s, %s, %i)\n", GLEnumName(face), GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glMaterialx, face, pname, (GLuint)param);
 	glMaterialx(face, pname, param);
 }
 
 void glMaterialxvLogged(GLenum face, GLenum pname, const GLfixed *params) {
-	printf("glMaterialxv(%s, %s, %p)\n", GLEnumName(face), GLEnumName(pname), params);
+	LogGLCall("glMaterialxv(%s, %s, %p)\n", GLEnumName(face), GLEnumName(pname), params);
+	CC3GLRecordData(kCC3GLCmd_glMaterialxv, params, CC3GLParameterCount(pname) * sizeof(GLfixed), face, pname);
 	glMaterialxv(face, pname, params);
 }
 
 void glMatrixModeLogged(GLenum mode) {
-	printf("glMatrixMode(%s)\n", GLEnumName(mode));
+	LogGLCall("glMatrixMode(%s)\n", GLEnumName(mode));
+	CC3GLRecord(kCC3GLCmd_glMatrixMode, mode);
 	glMatrixMode(mode);
 }
 
 void glMultMatrixxLogged(const GLfixed *m) {
-	printf("glMultMatrixx(%p)\n", m);
+	LogGLCall("glMultMatrixx(%p)\n", m);
+	CC3GLRecordCommandData(kCC3GLCmd_glMultMatrixx, m, 16 * sizeof(GLfixed));
 	glMultMatrixx(m);
 }
 
 void glMultiTexCoord4xLogged(GLenum target, GLfixed s, GLfixed t, GLfixed r, GLfixed q) {
-	printf("glMultiTexCoord4x(%s, %i, %i, %i, %i)\n", GLEnumName(target), s, t, r, q);
+	LogGLCall("glMultiTexCoord4x(%s, %i, %i, %i, %i)\n", GLEnumName(target), s, t, r, q);
+	CC3GLRecord(kCC3GLCmd_glMultiTexCoord4x, target, (GLuint)s, (GLuint)t, (GLuint)r, (GLuint)q);
 	glMultiTexCoord4x(target, s, t, r, q);
 }
 
 void glNormal3xLogged(GLfixed nx, GLfixed ny, GLfixed nz) {
-	printf("glNormal3x(%i, %i, %i)\n", nx, ny, nz);
+	LogGLCall("glNormal3x(%i, %i, %i)\n", nx, ny, nz);
+	CC3GLRecord(kCC3GLCmd_glNormal3x, (GLuint)nx, (GLuint)ny, (GLuint)nz);
 	glNormal3x(nx, ny, nz);
 }
 
 void glNormalPointerLogged(GLenum type, GLsizei stride, const GLvoid *pointer) {
-	printf("glNormalPointer(%s, %i, %p)\n", GLEnumName(type), stride, pointer);
-	PrintGLData(3, type, stride, kPrintGLDataVertexCount, pointer);
+	LogGLCall("glNormalPointer(%s, %i, %p)\n", GLEnumName(type), stride, pointer);
+	LogGLData(3, type, stride, kPrintGLDataVertexCount, pointer);
+	CC3GLRecordVertexArray(kCC3GLCmd_glNormalPointer, GL_NORMAL_ARRAY, 3, type, stride, pointer);
 	glNormalPointer(type, stride, pointer);
 }
 
 void glOrthoxLogged(GLfixed left, GLfixed right, GLfixed bottom, GLfixed top, GLfixed zNear, GLfixed zFar) {
-	printf("glOrthox(%i, %i, %i, %i, %i, %i)\n", left, right, bottom, top, zNear, zFar);
+	LogGLCall("glOrthox(%i, %i, %i, %i, %i, %i)\n", left, right, bottom, top, zNear, zFar);
+	CC3GLRecord(kCC3GLCmd_glOrthox, (GLuint)left, (GLuint)right, (GLuint)bottom, (GLuint)top, (GLuint)zNear, (GLuint)zFar);
 	glOrthox(left, right, bottom, top, zNear, zFar);
 }
 
 void glPixelStoreiLogged(GLenum pname, GLint param) {
-	printf("glPixelStorei(%s, %i)\n", GLEnumName(pname), param);
+	LogGLCall("glPixelStorei(%s, %i)\n", GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glPixelStorei, pname, (GLuint)param);
 	glPixelStorei(pname, param);
 }
 
 void glPointParameterxLogged(GLenum pname, GLfixed param) {
-	printf("glPointParameterx(%s, %i)\n", GLEnumName(pname), param);
+	LogGLCall("glPointParameterx(%s, %i)\n", GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glPointParameterx, pname, (GLuint)param);
 	glPointParameterx(pname, param);
 }
 
 void glPointParameterxvLogged(GLenum pname, const GLfixed *params) {
-	printf("glPointParameterxv(%s, %p)\n", GLEnumName(pname), params);
+	LogGLCall("glPointParameterxv(%s, %p)\n", GLEnumName(pname), params);
+	CC3GLRecordData(kCC3GLCmd_glPointParameterxv, params, CC3GLParameterCount(pname) * sizeof(GLfixed), pname);
 	glPointParameterxv(pname, params);
 }
 
 void glPointSizexLogged(GLfixed size) {
-	printf("glPointSizex(%i)\n", size);
+	LogGLCall("glPointSizex(%i)\n", size);
+	CC3GLRecord(kCC3GLCmd_glPointSizex, (GLuint)size);
 	glPointSizex(size);
 }
 
 void glPolygonOffsetxLogged(GLfixed factor, GLfixed units) {
-	printf("glPolygonOffsetx(%i, %i)\n", factor, units);
+	LogGLCall("glPolygonOffsetx(%i, %i)\n", factor, units);
+	CC3GLRecord(kCC3GLCmd_glPolygonOffsetx, (GLuint)factor, (GLuint)units);
 	glPolygonOffsetx(factor, units);
 }
 
 void glPopMatrixLogged() {
-	printf("glPopMatrix()\n");
+	LogGLCall("glPopMatrix()\n");
+	CC3GLRecordCommand(kCC3GLCmd_glPopMatrix);
 	glPopMatrix();
 }
 
 void glPushMatrixLogged() {
-	printf("glPushMatrix()\n");
+	LogGLCall("glPushMatrix()\n");
+	CC3GLRecordCommand(kCC3GLCmd_glPushMatrix);
 	glPushMatrix();
 }
 
 void glReadPixelsLogged(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid *pixels) {
-	printf("glReadPixels(%i, %i, %i, %i, %s, %s, %p)\n", x, y, width, height, GLEnumName(format), GLEnumName(type), pixels);
+	LogGLCall("glReadPixels(%i, %i, %i, %i, %s, %s, %p)\n", x, y, width, height, GLEnumName(format), GLEnumName(type), pixels);
+	CC3GLRecord(kCC3GLCmd_glReadPixels, (GLuint)x, (GLuint)y, (GLuint)width, (GLuint)height, format, type);
 	glReadPixels(x, y, width, height, format, type, pixels);
 }
 
 void glRotatexLogged(GLfixed angle, GLfixed x, GLfixed y, GLfixed z) {
-	printf("glRotatex(%i, %i, %i, %i)\n", angle, x, y, z);
+	LogGLCall("glRotatex(%i, %i, %i, %i)\n", angle, x, y, z);
+	CC3GLRecord(kCC3GLCmd_glRotatex, (GLuint)angle, (GLuint)x, (GLuint)y, (GLuint)z);
 	glRotatex(angle, x, y, z);
 }
 
 void glSampleCoverageLogged(GLclampf value, GLboolean invert) {
-	printf("glSampleCoverage(%.2f, %u)\n", value, invert);
+	LogGLCall("glSampleCoverage(%.2f, %u)\n", value, invert);
+	CC3GLRecord(kCC3GLCmd_glSampleCoverage, CC3GLFloatWord(value), (GLuint)invert);
 	glSampleCoverage(value, invert);
 }
 
 void glSampleCoveragexLogged(GLclampx value, GLboolean invert) {
-	printf("glSampleCoveragex(%i, %u)\n", value, invert);
+	LogGLCall("glSampleCoveragex(%i, %u)\n", value, invert);
+	CC3GLRecord(kCC3GLCmd_glSampleCoveragex, (GLuint)value, (GLuint)invert);
 	glSampleCoveragex(value, invert);
 }
 
 void glScalexLogged(GLfixed x, GLfixed y, GLfixed z) {
-	printf("glScalex(%i, %i, %i)\n", x, y, z);
+	LogGLCall("glScalex(%i, %i, %i)\n", x, y, z);
+	CC3GLRecord(kCC3GLCmd_glScalex, (GLuint)x, (GLuint)y, (GLuint)z);
 	glScalex(x, y, z);
 }
 
 void glScissorLogged(GLint x, GLint y, GLsizei width, GLsizei height) {
-	printf("glScissor(%i, %i, %i, %i)\n", x, y, width, height);
+	LogGLCall("glScissor(%i, %i, %i, %i)\n", x, y, width, height);
+	CC3GLRecord(kCC3GLCmd_glScissor, (GLuint)x, (GLuint)y, (GLuint)width, (GLuint)height);
 	glScissor(x, y, width, height);
 }
 
 void glShadeModelLogged(GLenum mode) {
-	printf("glShadeModel(%s)\n", GLEnumName(mode));
+	LogGLCall("glShadeModel(%s)\n", GLEnumName(mode));
+	CC3GLRecord(kCC3GLCmd_glShadeModel, mode);
 	glShadeModel(mode);
 }
 
 void glStencilFuncLogged(GLenum func, GLint ref, GLuint mask) {
-	printf("glStencilFunc(%s, %i, %u)\n", GLEnumName(func), ref, mask);
+	LogGLCall("glStencilFunc(%s, %i, %u)\n", GLEnumName(func), ref, mask);
+	CC3GLRecord(kCC3GLCmd_glStencilFunc, func, (GLuint)ref, mask);
 	glStencilFunc( func, ref, mask);
 }
 
 void glStencilMaskLogged(GLuint mask) {
-	printf("glStencilMask(%u)\n", mask);
+	LogGLCall("glStencilMask(%u)\n", mask);
+	CC3GLRecord(kCC3GLCmd_glStencilMask, mask);
 	glStencilMask(mask);
 }
 
 void glStencilOpLogged(GLenum fail, GLenum zfail, GLenum zpass) {
-	printf("glStencilOp(%s, %s, %s)\n", GLEnumName(fail), GLEnumName(zfail), GLEnumName(zpass));
+	LogGLCall("glStencilOp(%s, %s, %s)\n", GLEnumName(fail), GLEnumName(zfail), GLEnumName(zpass));
+	CC3GLRecord(kCC3GLCmd_glStencilOp, fail, zfail, zpass);
 	glStencilOp(fail, zfail, zpass);
 }
 
 void glTexCoordPointerLogged(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer) {
-	printf("glTexCoordPointer(%i, %s, %i, %p)\n", size, GLEnumName(type), stride, pointer);
-	PrintGLData(size, type, stride, kPrintGLDataVertexCount, pointer);
+	LogGLCall("glTexCoordPointer(%i, %s, %i, %p)\n", size, GLEnumName(type), stride, pointer);
+	LogGLData(size, type, stride, kPrintGLDataVertexCount, pointer);
+	CC3GLRecordVertexArray(kCC3GLCmd_glTexCoordPointer, GL_TEXTURE_COORD_ARRAY, size, type, stride, pointer);
 	glTexCoordPointer(size, type, stride, pointer);
 }
 
 void glTexEnviLogged(GLenum target, GLenum pname, GLint param) {
-	printf("glTexEnvi(%s, %s, %i)\n", GLEnumName(target), GLEnumName(pname), param);
+	LogGLCall("glTexEnvi(%s, %s, %i)\n", GLEnumName(target), GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glTexEnvi, target, pname, (GLuint)param);
 	glTexEnvi(target, pname, param);
 }
 
 void glTexEnvxLogged(GLenum target, GLenum pname, GLfixed param) {
-	printf("glTexEnvx(%s, %s, %i)\n", GLEnumName(target), GLEnumName(pname), param);
+	LogGLCall("glTexEnvx(%s, %s, %i)\n", GLEnumName(target), GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glTexEnvx, target, pname, (GLuint)param);
 	glTexEnvx(target, pname, param);
 }
 
 void glTexEnvivLogged(GLenum target, GLenum pname, const GLint *params) {
-	printf("glTexEnviv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	LogGLCall("glTexEnviv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	CC3GLRecordData(kCC3GLCmd_glTexEnviv, params, CC3GLParameterCount(pname) * sizeof(GLint), target, pname);
 	glTexEnviv(target, pname, params);
 }
 
 void glTexEnvxvLogged(GLenum target, GLenum pname, const GLfixed *params) {
-	printf("glTexEnvxv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	LogGLCall("glTexEnvxv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	CC3GLRecordData(kCC3GLCmd_glTexEnvxv, params, CC3GLParameterCount(pname) * sizeof(GLfixed), target, pname);
 	glTexEnvxv(target, pname, params);
 }
 
 void glTexImage2DLogged(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels) {
-	printf("glTexImage2D(%s, %i, %i, %i, %i, %i, %s, %s, %p)\n", GLEnumName(target), level, internalformat, width, height, border, GLEnumName(format), GLEnumName(type), pixels);
+	LogGLCall("glTexImage2D(%s, %i, %i, %i, %i, %i, %s, %s, %p)\n", GLEnumName(target), level, internalformat, width, height, border, GLEnumName(format), GLEnumName(type), pixels);
+	CC3GLRecordData(kCC3GLCmd_glTexImage2D, pixels, CC3GLPixelDataLength(width, height, format, type), target, (GLuint)level, (GLuint)internalformat, (GLuint)width, (GLuint)height, (GLuint)border, format, type, CC3GLPointerWord(pixels));
 	glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
 }
 
 void glTexParameteriLogged(GLenum target, GLenum pname, GLint param) {
-	printf("glTexParameteri(%s, %s, %i)\n", GLEnumName(target), GLEnumName(pname), param);
+	LogGLCall("glTexParameteri(%s, %s, %i)\n", GLEnumName(target), GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glTexParameteri, target, pname, (GLuint)param);
 	glTexParameteri(target, pname, param);
 }
 
 void glTexParameterxLogged(GLenum target, GLenum pname, GLfixed param) {
-	printf("glTexParameterx(%s, %s, %i)\n", GLEnumName(target), GLEnumName(pname), param);
+	LogGLCall("glTexParameterx(%s, %s, %i)\n", GLEnumName(target), GLEnumName(pname), param);
+	CC3GLRecord(kCC3GLCmd_glTexParameterx, target, pname, (GLuint)param);
 	glTexParameterx(target, pname, param);
 }
 
 void glTexParameterivLogged(GLenum target, GLenum pname, const GLint *params) {
-	printf("glTexParameteriv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	LogGLCall("glTexParameteriv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	CC3GLRecordData(kCC3GLCmd_glTexParameteriv, params, CC3GLParameterCount(pname) * sizeof(GLint), target, pname);
 	glTexParameteriv(target, pname, params);
 }
 
 void glTexParameterxvLogged(GLenum target, GLenum pname, const GLfixed *params) {
-	printf("glTexParameterxv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	LogGLCall("glTexParameterxv(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	CC3GLRecordData(kCC3GLCmd_glTexParameterxv, params, CC3GLParameterCount(pname) * sizeof(GLfixed), target, pname);
 	glTexParameterxv(target, pname, params);
 }
 
 void glTexSubImage2DLogged(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels) {
-	printf("glTexSubImage2D(%s, %i, %i, %i, %i, %i, %s, %s, %p)\n", GLEnumName(target), level, xoffset, yoffset, width, height, GLEnumName(format), GLEnumName(type), pixels);
+	LogGLCall("glTexSubImage2D(%s, %i, %i, %i, %i, %i, %s, %s, %p)\n", GLEnumName(target), level, xoffset, yoffset, width, height, GLEnumName(format), GLEnumName(type), pixels);
+	CC3GLRecordData(kCC3GLCmd_glTexSubImage2D, pixels, CC3GLPixelDataLength(width, height, format, type), target, (GLuint)level, (GLuint)xoffset, (GLuint)yoffset, (GLuint)width, (GLuint)height, format, type, CC3GLPointerWord(pixels));
 	glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
 }
 
 void glTranslatexLogged(GLfixed x, GLfixed y, GLfixed z) {
-	printf("glTranslatex(%i, %i, %i)\n", x, y, z);
+	LogGLCall("glTranslatex(%i, %i, %i)\n", x, y, z);
+	CC3GLRecord(kCC3GLCmd_glTranslatex, (GLuint)x, (GLuint)y, (GLuint)z);
 	glTranslatex(x, y, z);
 }
 
 void glVertexPointerLogged(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer) {
-	printf("glVertexPointer(%i, %s, %i, %p)\n", size, GLEnumName(type), stride, pointer);
-	PrintGLData(size, type, stride, kPrintGLDataVertexCount, pointer);
+	LogGLCall("glVertexPointer(%i, %s, %i, %p)\n", size, GLEnumName(type), stride, pointer);
+	LogGLData(size, type, stride, kPrintGLDataVertexCount, pointer);
+	CC3GLRecordVertexArray(kCC3GLCmd_glVertexPointer, GL_VERTEX_ARRAY, size, type, stride, pointer);
 	glVertexPointer(size, type, stride, pointer);
 }
 
 void glViewportLogged(GLint x, GLint y, GLsizei width, GLsizei height) {
-	printf("glViewport(%i, %i, %i, %i)\n", x, y, width, height);
+	LogGLCall("glViewport(%i, %i, %i, %i)\n", x, y, width, height);
+	CC3GLRecord(kCC3GLCmd_glViewport, (GLuint)x, (GLuint)y, (GLuint)width, (GLuint)height);
 	glViewport(x, y, width, height);
 }
 
@@ -855,70 +1014,83 @@ void glViewportLogged(GLint x, GLint y, GLsizei width, GLsizei height) {
 #pragma mark OpenGLES extensions from gl.h base file
 
 void glCurrentPaletteMatrixOESLogged(GLuint matrixpaletteindex) {
-	printf("glCurrentPaletteMatrixOES(%u)\n", matrixpaletteindex);
+	LogGLCall("glCurrentPaletteMatrixOES(%u)\n", matrixpaletteindex);
+	CC3GLRecord(kCC3GLCmd_glCurrentPaletteMatrixOES, matrixpaletteindex);
 	glCurrentPaletteMatrixOES(matrixpaletteindex);
 }
 
 void glLoadPaletteFromModelViewMatrixOESLogged() {
-	printf("glLoadPaletteFromModelViewMatrixOES()\n");
+	LogGLCall("glLoadPaletteFromModelViewMatrixOES()\n");
+	CC3GLRecordCommand(kCC3GLCmd_glLoadPaletteFromModelViewMatrixOES);
 	glLoadPaletteFromModelViewMatrixOES();
 }
 
 void glMatrixIndexPointerOESLogged(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer) {
-	printf("glMatrixIndexPointerOES(%i, %s, %i, %p)\n", size, GLEnumName(type), stride, pointer);
-	PrintGLData(size, type, stride, kPrintGLDataVertexCount, pointer);
+	LogGLCall("glMatrixIndexPointerOES(%i, %s, %i, %p)\n", size, GLEnumName(type), stride, pointer);
+	LogGLData(size, type, stride, kPrintGLDataVertexCount, pointer);
+	CC3GLRecordVertexArray(kCC3GLCmd_glMatrixIndexPointerOES, GL_MATRIX_INDEX_ARRAY_OES, size, type, stride, pointer);
 	glMatrixIndexPointerOES(size, type, stride, pointer);
 }
 
 void glWeightPointerOESLogged(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer) {
-	printf("glWeightPointerOES(%i, %s, %i, %p)\n", size, GLEnumName(type), stride, pointer);
-	PrintGLData(size, type, stride, kPrintGLDataVertexCount, pointer);
+	LogGLCall("glWeightPointerOES(%i, %s, %i, %p)\n", size, GLEnumName(type), stride, pointer);
+	LogGLData(size, type, stride, kPrintGLDataVertexCount, pointer);
+	CC3GLRecordVertexArray(kCC3GLCmd_glWeightPointerOES, GL_WEIGHT_ARRAY_OES, size, type, stride, pointer);
 	glWeightPointerOES(size, type, stride, pointer);
 }
 
 void glPointSizePointerOESLogged(GLenum type, GLsizei stride, const GLvoid *pointer) {
-	printf("glPointSizePointerOES(%s, %i, %p)\n", GLEnumName(type), stride, pointer);
-	PrintGLData(1, type, stride, kPrintGLDataVertexCount, pointer);
+	LogGLCall("glPointSizePointerOES(%s, %i, %p)\n", GLEnumName(type), stride, pointer);
+	LogGLData(1, type, stride, kPrintGLDataVertexCount, pointer);
+	CC3GLRecordVertexArray(kCC3GLCmd_glPointSizePointerOES, GL_POINT_SIZE_ARRAY_OES, 1, type, stride, pointer);
 	glPointSizePointerOES(type, stride, pointer);
 }
 
 void glDrawTexsOESLogged(GLshort x, GLshort y, GLshort z, GLshort width, GLshort height) {
-	printf("glDrawTexsOES(%i, %i, %i, %i, %i)\n", x, y, z, width, height);
+	LogGLCall("glDrawTexsOES(%i, %i, %i, %i, %i)\n", x, y, z, width, height);
+	CC3GLRecord(kCC3GLCmd_glDrawTexsOES, (GLuint)x, (GLuint)y, (GLuint)z, (GLuint)width, (GLuint)height);
 	glDrawTexsOES(x, y, z, width, height);
 }
 
 void glDrawTexiOESLogged(GLint x, GLint y, GLint z, GLint width, GLint height) {
-	printf("glDrawTexiOES(%i, %i, %i, %i, %i)\n", x, y, z, width, height);
+	LogGLCall("glDrawTexiOES(%i, %i, %i, %i, %i)\n", x, y, z, width, height);
+	CC3GLRecord(kCC3GLCmd_glDrawTexiOES, (GLuint)x, (GLuint)y, (GLuint)z, (GLuint)width, (GLuint)height);
 	glDrawTexiOES(x, y, z, width, height);
 }
 
 void glDrawTexxOESLogged(GLfixed x, GLfixed y, GLfixed z, GLfixed width, GLfixed height) {
-	printf("glDrawTexxOES(%i, %i, %i, %i, %i)\n", x, y, z, width, height);
+	LogGLCall("glDrawTexxOES(%i, %i, %i, %i, %i)\n", x, y, z, width, height);
+	CC3GLRecord(kCC3GLCmd_glDrawTexxOES, (GLuint)x, (GLuint)y, (GLuint)z, (GLuint)width, (GLuint)height);
 	glDrawTexxOES(x, y, z, width, height);
 }
 
 void glDrawTexsvOESLogged(const GLshort *coords) {
-	printf("glDrawTexsvOES(%p)\n", coords);
+	LogGLCall("glDrawTexsvOES(%p)\n", coords);
+	CC3GLRecordCommandData(kCC3GLCmd_glDrawTexsvOES, coords, 5 * sizeof(GLshort));
 	glDrawTexsvOES(coords);
 }
 
 void glDrawTexivOESLogged(const GLint *coords) {
-	printf("glDrawTexivOES(%p)\n", coords);
+	LogGLCall("glDrawTexivOES(%p)\n", coords);
+	CC3GLRecordCommandData(kCC3GLCmd_glDrawTexivOES, coords, 5 * sizeof(GLint));
 	glDrawTexivOES(coords);
 }
 
 void glDrawTexxvOESLogged(const GLfixed *coords) {
-	printf("glDrawTexxvOES(%p)\n", coords);
+	LogGLCall("glDrawTexxvOES(%p)\n", coords);
+	CC3GLRecordCommandData(kCC3GLCmd_glDrawTexxvOES, coords, 5 * sizeof(GLfixed));
 	glDrawTexxvOES(coords);
 }
 
 void glDrawTexfOESLogged(GLfloat x, GLfloat y, GLfloat z, GLfloat width, GLfloat height) {
-	printf("glDrawTexfOES(%.2f, %.2f, %.2f, %.2f, %.2f)\n", x, y, z, width, height);
+	LogGLCall("glDrawTexfOES(%.2f, %.2f, %.2f, %.2f, %.2f)\n", x, y, z, width, height);
+	CC3GLRecord(kCC3GLCmd_glDrawTexfOES, CC3GLFloatWord(x), CC3GLFloatWord(y), CC3GLFloatWord(z), CC3GLFloatWord(width), CC3GLFloatWord(height));
 	glDrawTexfOES(x, y, z, width, height);
 }
 
 void glDrawTexfvOESLogged(const GLfloat *coords) {
-	printf("glDrawTexfvOES(%p)\n", coords);
+	LogGLCall("glDrawTexfvOES(%p)\n", coords);
+	CC3GLRecordCommandData(kCC3GLCmd_glDrawTexfvOES, coords, 5 * sizeof(GLfloat));
 	glDrawTexfvOES(coords);
 }
 
@@ -926,97 +1098,116 @@ void glDrawTexfvOESLogged(const GLfloat *coords) {
 #pragma mark OpenGLES extensions from glext.h extensions file
 
 void glBlendEquationOESLogged(GLenum mode) {
-	printf("glBlendEquationOES(%s)\n", GLEnumName(mode));
+	LogGLCall("glBlendEquationOES(%s)\n", GLEnumName(mode));
+	CC3GLRecord(kCC3GLCmd_glBlendEquationOES, mode);
 	glBlendEquationOES(mode);
 }
 
 GLboolean glIsRenderbufferOESLogged(GLuint renderbuffer) {
-	printf("glIsRenderbufferOES(%u)\n", renderbuffer);
+	LogGLCall("glIsRenderbufferOES(%u)\n", renderbuffer);
+	CC3GLRecord(kCC3GLCmd_glIsRenderbufferOES, renderbuffer);
 	return glIsRenderbufferOES(renderbuffer);
 }
 
 void glBindRenderbufferOESLogged(GLenum target, GLuint renderbuffer) {
-	printf("glBindRenderbufferOES(%s, %u)\n", GLEnumName(target), renderbuffer);
+	LogGLCall("glBindRenderbufferOES(%s, %u)\n", GLEnumName(target), renderbuffer);
+	CC3GLRecord(kCC3GLCmd_glBindRenderbufferOES, target, renderbuffer);
 	glBindRenderbufferOES(target, renderbuffer);
 }
 
 void glDeleteRenderbuffersOESLogged(GLsizei n, const GLuint* renderbuffers) {
-	printf("glDeleteRenderbuffersOES(%i, %p)\n", n, renderbuffers);
+	LogGLCall("glDeleteRenderbuffersOES(%i, %p)\n", n, renderbuffers);
+	CC3GLRecordData(kCC3GLCmd_glDeleteRenderbuffersOES, renderbuffers, n * sizeof(GLuint), (GLuint)n);
 	glDeleteRenderbuffersOES(n, renderbuffers);
 }
 
 void glGenRenderbuffersOESLogged(GLsizei n, GLuint* renderbuffers) {
-	printf("glGenRenderbuffersOES(%i, %p)\n", n, renderbuffers);
+	LogGLCall("glGenRenderbuffersOES(%i, %p)\n", n, renderbuffers);
 	glGenRenderbuffersOES(n, renderbuffers);
+	CC3GLRecordData(kCC3GLCmd_glGenRenderbuffersOES, renderbuffers, n * sizeof(GLuint), (GLuint)n);
 }
 
 void glRenderbufferStorageOESLogged(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) {
-	printf("glRenderbufferStorageOES(%s, %s, %i, %i)\n", GLEnumName(target), GLEnumName(internalformat), width, height);
+	LogGLCall("glRenderbufferStorageOES(%s, %s, %i, %i)\n", GLEnumName(target), GLEnumName(internalformat), width, height);
+	CC3GLRecord(kCC3GLCmd_glRenderbufferStorageOES, target, internalformat, (GLuint)width, (GLuint)height);
 	glRenderbufferStorageOES(target, internalformat, width, height);
 }
 
 void glGetRenderbufferParameterivOESLogged(GLenum target, GLenum pname, GLint* params) {
-	printf("glGetRenderbufferParameterivOES(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	LogGLCall("glGetRenderbufferParameterivOES(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetRenderbufferParameterivOES, target, pname);
 	glGetRenderbufferParameterivOES(target, pname, params);
 }
 
 GLboolean glIsFramebufferOESLogged(GLuint framebuffer) {
-	printf("glIsFramebufferOES(%u)\n", framebuffer);
+	LogGLCall("glIsFramebufferOES(%u)\n", framebuffer);
+	CC3GLRecord(kCC3GLCmd_glIsFramebufferOES, framebuffer);
 	return glIsFramebufferOES(framebuffer);
 }
 
 void glBindFramebufferOESLogged(GLenum target, GLuint framebuffer) {
-	printf("glBindFramebufferOES(%s, %u)\n", GLEnumName(target), framebuffer);
+	LogGLCall("glBindFramebufferOES(%s, %u)\n", GLEnumName(target), framebuffer);
+	CC3GLRecord(kCC3GLCmd_glBindFramebufferOES, target, framebuffer);
 	glBindFramebufferOES(target, framebuffer);
 }
 
 void glDeleteFramebuffersOESLogged(GLsizei n, const GLuint* framebuffers) {
-	printf("glDeleteFramebuffersOES(%i, %p)\n", n, framebuffers);
+	LogGLCall("glDeleteFramebuffersOES(%i, %p)\n", n, framebuffers);
+	CC3GLRecordData(kCC3GLCmd_glDeleteFramebuffersOES, framebuffers, n * sizeof(GLuint), (GLuint)n);
 	glDeleteFramebuffersOES(n, framebuffers);
 }
 
 void glGenFramebuffersOESLogged(GLsizei n, GLuint* framebuffers) {
-	printf("glGenFramebuffersOES(%i, %p)\n", n, framebuffers);
+	LogGLCall("glGenFramebuffersOES(%i, %p)\n", n, framebuffers);
 	glGenFramebuffersOES(n, framebuffers);
+	CC3GLRecordData(kCC3GLCmd_glGenFramebuffersOES, framebuffers, n * sizeof(GLuint), (GLuint)n);
 }
 
 GLenum glCheckFramebufferStatusOESLogged(GLenum target) {
-	printf("glCheckFramebufferStatusOES(%s)\n", GLEnumName(target));
+	LogGLCall("glCheckFramebufferStatusOES(%s)\n", GLEnumName(target));
+	CC3GLRecord(kCC3GLCmd_glCheckFramebufferStatusOES, target);
 	return glCheckFramebufferStatusOES(target);
 }
 
 void glFramebufferRenderbufferOESLogged(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) {
-	printf("glFramebufferRenderbufferOES(%s, %s, %s, %u)\n", GLEnumName(target), GLEnumName(attachment), GLEnumName(renderbuffertarget), renderbuffer);
+	LogGLCall("glFramebufferRenderbufferOES(%s, %s, %s, %u)\n", GLEnumName(target), GLEnumName(attachment), GLEnumName(renderbuffertarget), renderbuffer);
+	CC3GLRecord(kCC3GLCmd_glFramebufferRenderbufferOES, target, attachment, renderbuffertarget, renderbuffer);
 	glFramebufferRenderbufferOES(target, attachment, renderbuffertarget, renderbuffer);
 }
 
 void glFramebufferTexture2DOESLogged(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) {
-	printf("glFramebufferTexture2DOES(%s, %s, %s, %u, %i)\n", GLEnumName(target), GLEnumName(attachment), GLEnumName(textarget), texture, level);
+	LogGLCall("glFramebufferTexture2DOES(%s, %s, %s, %u, %i)\n", GLEnumName(target), GLEnumName(attachment), GLEnumName(textarget), texture, level);
+	CC3GLRecord(kCC3GLCmd_glFramebufferTexture2DOES, target, attachment, textarget, texture, (GLuint)level);
 	glFramebufferTexture2DOES(target, attachment, textarget, texture, level);
 }
 
 void glGetFramebufferAttachmentParameterivOESLogged(GLenum target, GLenum attachment, GLenum pname, GLint* params) {
-	printf("glGetFramebufferAttachmentParameterivOES(%s, %s, %s, %p)\n", GLEnumName(target), GLEnumName(attachment), GLEnumName(pname), params);
+	LogGLCall("glGetFramebufferAttachmentParameterivOES(%s, %s, %s, %p)\n", GLEnumName(target), GLEnumName(attachment), GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetFramebufferAttachmentParameterivOES, target, attachment, pname);
 	glGetFramebufferAttachmentParameterivOES(target, attachment, pname, params);
 }
 
 void glGenerateMipmapOESLogged(GLenum target) {
-	printf("glGenerateMipmapOES(%s)\n", GLEnumName(target));
+	LogGLCall("glGenerateMipmapOES(%s)\n", GLEnumName(target));
+	CC3GLRecord(kCC3GLCmd_glGenerateMipmapOES, target);
 	glGenerateMipmapOES(target);
 }
 
 void glGetBufferPointervOESLogged(GLenum target, GLenum pname, GLvoid **params) {
-	printf("glGetBufferPointervOES(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	LogGLCall("glGetBufferPointervOES(%s, %s, %p)\n", GLEnumName(target), GLEnumName(pname), params);
+	CC3GLRecord(kCC3GLCmd_glGetBufferPointervOES, target, pname);
 	glGetBufferPointervOES(target, pname, params);
 }
 
 GLvoid* glMapBufferOESLogged(GLenum target, GLenum access) {
-	printf("glMapBufferOES(%s, %s)\n", GLEnumName(target), GLEnumName(access));
+	LogGLCall("glMapBufferOES(%s, %s)\n", GLEnumName(target), GLEnumName(access));
+	CC3GLRecord(kCC3GLCmd_glMapBufferOES, target, access);
 	return glMapBufferOES(target, access);
 }
 
 GLboolean glUnmapBufferOESLogged(GLenum target) {
-	printf("glUnmapBufferOES(%s)\n", GLEnumName(target));
+	LogGLCall("glUnmapBufferOES(%s)\n", GLEnumName(target));
+	CC3GLRecord(kCC3GLCmd_glUnmapBufferOES, target);
 	return glUnmapBufferOES(target);
 }
 
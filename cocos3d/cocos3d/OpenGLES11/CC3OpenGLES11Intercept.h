@@ -80,16 +80,26 @@
  * Use the compiler parameter kPrintGLDataBufferDataCount to control how many elements
  * of the data should be logged when data is passed as buffer data (eg. glBufferData).
  * The default value is 64.
+ *
+ * The same interception can be used to record all GL calls into a binary command stream,
+ * by setting the compiler switch GL_RECORDING_ENABLED to 1. Recording can be enabled with
+ * or without logging. See the notes for CC3OpenGLES11Recorder.h for more on recording.
+ * The default value of this switch is 0, so GL recording is turned off by default.
  */
 
 #include <OpenGLES/ES1/gl.h>
+#include "CC3OpenGLES11Recorder.h"
 
 
 #ifndef GL_LOGGING_ENABLED
 #	define GL_LOGGING_ENABLED		0
 #endif
 
-#if defined(GL_LOGGING_ENABLED) && GL_LOGGING_ENABLED
+#ifndef GL_RECORDING_ENABLED
+#	define GL_RECORDING_ENABLED		0
+#endif
+
+#if (defined(GL_LOGGING_ENABLED) && GL_LOGGING_ENABLED) || (defined(GL_RECORDING_ENABLED) && GL_RECORDING_ENABLED)
  
 #pragma mark OpenGLES base
 
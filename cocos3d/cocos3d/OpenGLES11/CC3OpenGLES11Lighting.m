@@ -62,22 +62,22 @@
 }
 
 -(void) getGLValue {
-	glGetLightfv(self.glLightIndex, name, (GLfloat*)&originalValue);
+	glGetLightfv(self.glLightIndex, name, CC3GLESStateCacheOriginalFloats(stateCache, stateEntry));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ %@ read GL value %.2f (was tracking %@)",
 			 [self class], NSStringFromGLEnum(self.glLightIndex), NSStringFromGLEnum(name),
-			 originalValue, (valueIsKnown ? [NSString stringWithFormat: @"%.2f", value] : @"UNKNOWN"));
+			 self.originalValue, (self.valueIsKnown ? [NSString stringWithFormat: @"%.2f", self.value] : @"UNKNOWN"));
 }
 
 -(void) setGLValue {
-	glLightf(self.glLightIndex, name, value);
+	glLightf(self.glLightIndex, name, self.value);
 }
 
 -(void) logSetValue: (BOOL) wasSet {
 	LogTrace(@"%@ %@ %@ %@ = %.2f", [self class], NSStringFromGLEnum(self.glLightIndex),
-			 (wasSet ? @"set" : @"reused"), NSStringFromGLEnum(name), value);
+			 (wasSet ? @"set" : @"reused"), NSStringFromGLEnum(name), self.value);
 }
 
 @end
@@ -112,22 +112,22 @@
 }
 
 -(void) getGLValue {
-	glGetLightfv(self.glLightIndex, name, (GLfloat*)&originalValue);
+	glGetLightfv(self.glLightIndex, name, CC3GLESStateCacheOriginalFloats(stateCache, stateEntry));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ %@ read GL value %@ (was tracking %@)", 
 			 [self class], NSStringFromGLEnum(self.glLightIndex), NSStringFromGLEnum(name),
-			 NSStringFromCCC4F(originalValue), (valueIsKnown ? NSStringFromCCC4F(value) : @"UNKNOWN"));
+			 NSStringFromCCC4F(self.originalValue), (self.valueIsKnown ? NSStringFromCCC4F(self.value) : @"UNKNOWN"));
 }
 
 -(void) setGLValue {
-	glLightfv(self.glLightIndex, name, (GLfloat*)&value);
+	glLightfv(self.glLightIndex, name, CC3GLESStateCacheFloats(stateCache, stateEntry));
 }
 
 -(void) logSetValue: (BOOL) wasSet {
 	LogTrace(@"%@ %@ %@ %@ = %@", [self class], NSStringFromGLEnum(self.glLightIndex),
-			 (wasSet ? @"set" : @"reused"), NSStringFromGLEnum(name), NSStringFromCCC4F(value));
+			 (wasSet ? @"set" : @"reused"), NSStringFromGLEnum(name), NSStringFromCCC4F(self.value));
 }
 
 @end
@@ -162,22 +162,22 @@
 }
 
 -(void) getGLValue {
-	glGetLightfv(self.glLightIndex, name, (GLfloat*)&originalValue);
+	glGetLightfv(self.glLightIndex, name, CC3GLESStateCacheOriginalFloats(stateCache, stateEntry));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ %@ read GL value %@ (was tracking %@)", 
 			 [self class], NSStringFromGLEnum(self.glLightIndex), NSStringFromGLEnum(name),
-			 NSStringFromCC3Vector(originalValue), (valueIsKnown ? NSStringFromCC3Vector(value) : @"UNKNOWN"));
+			 NSStringFromCC3Vector(self.originalValue), (self.valueIsKnown ? NSStringFromCC3Vector(self.value) : @"UNKNOWN"));
 }
 
 -(void) setGLValue {
-	glLightfv(self.glLightIndex, name, (GLfloat*)&value);
+	glLightfv(self.glLightIndex, name, CC3GLESStateCacheFloats(stateCache, stateEntry));
 }
 
 -(void) logSetValue: (BOOL) wasSet {
 	LogTrace(@"%@ %@ %@ %@ = %@", [self class], NSStringFromGLEnum(self.glLightIndex),
-			 (wasSet ? @"set" : @"reused"), NSStringFromGLEnum(name), NSStringFromCC3Vector(value));
+			 (wasSet ? @"set" : @"reused"), NSStringFromGLEnum(name), NSStringFromCC3Vector(self.value));
 }
 
 @end
@@ -212,22 +212,22 @@
 }
 
 -(void) getGLValue {
-	glGetLightfv(self.glLightIndex, name, (GLfloat*)&originalValue);
+	glGetLightfv(self.glLightIndex, name, CC3GLESStateCacheOriginalFloats(stateCache, stateEntry));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ %@ read GL value %@ (was tracking %@)", 
 			 [self class], NSStringFromGLEnum(self.glLightIndex), NSStringFromGLEnum(name),
-			 NSStringFromCC3Vector4(originalValue), (valueIsKnown ? NSStringFromCC3Vector4(value) : @"UNKNOWN"));
+			 NSStringFromCC3Vector4(self.originalValue), (self.valueIsKnown ? NSStringFromCC3Vector4(self.value) : @"UNKNOWN"));
 }
 
 -(void) setGLValue {
-	glLightfv(self.glLightIndex, name, (GLfloat*)&value);
+	glLightfv(self.glLightIndex, name, CC3GLESStateCacheFloats(stateCache, stateEntry));
 }
 
 -(void) logSetValue: (BOOL) wasSet {
 	LogTrace(@"%@ %@ %@ %@ = %@", [self class], NSStringFromGLEnum(self.glLightIndex),
-			 (wasSet ? @"set" : @"reused"), NSStringFromGLEnum(name), NSStringFromCC3Vector4(value));
+			 (wasSet ? @"set" : @"reused"), NSStringFromGLEnum(name), NSStringFromCC3Vector4(self.value));
 }
 
 @end
@@ -339,7 +339,7 @@
 
 @implementation CC3OpenGLES11StateTrackerSceneLightColor
 
--(void) setGLValue { glLightModelfv(name, (GLfloat*)&value); }
+-(void) setGLValue { glLightModelfv(name, CC3GLESStateCacheFloats(stateCache, stateEntry)); }
 
 @end
 
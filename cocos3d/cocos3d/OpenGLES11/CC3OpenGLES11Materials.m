@@ -47,11 +47,11 @@
 @implementation CC3OpenGLES11StateTrackerMaterialColor
 
 -(void) getGLValue {
-	glGetMaterialfv(GL_FRONT, name, (GLfloat*)&originalValue);
+	glGetMaterialfv(GL_FRONT, name, CC3GLESStateCacheOriginalFloats(stateCache, stateEntry));
 }
 
 -(void) setGLValue {
-	glMaterialfv(GL_FRONT_AND_BACK, name, (GLfloat*)&value);
+	glMaterialfv(GL_FRONT_AND_BACK, name, CC3GLESStateCacheFloats(stateCache, stateEntry));
 }
 
 @end
@@ -63,11 +63,11 @@
 @implementation CC3OpenGLES11StateTrackerMaterialFloat
 
 -(void) getGLValue {
-	glGetMaterialfv(GL_FRONT, name, (GLfloat*)&originalValue);
+	glGetMaterialfv(GL_FRONT, name, CC3GLESStateCacheOriginalFloats(stateCache, stateEntry));
 }
 
 -(void) setGLValue {
-	glMaterialf(GL_FRONT_AND_BACK, name, value);
+	glMaterialf(GL_FRONT_AND_BACK, name, self.value);
 }
 
 @end
@@ -0,0 +1,489 @@
+/*
+ * CC3OpenGLES11Recorder.c
+ *
+ * cocos3d 0.7.1
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2012 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ *
+ * See header file CC3OpenGLES11Recorder.h for full API documentation.
+ */
+
+#include "CC3OpenGLES11Recorder.h"
+#include "CC3OpenGLES11Utility.h"
+#include <stdio.h>
+#include <stdlib.h>
+// This file deliberately does NOT include the CC3OpenGLES11Intercept.h file, because
+// the GL state queried when recording starts must not itself be recorded or logged.
+
+/** Buffered commands are written to the file once they reach this length. */
+#define kCC3GLRecorderFlushLength		(64 * 1024)
+
+/** The maximum number of texture units whose texture coordinate arrays are tracked. */
+#define kCC3GLRecorderMaxTextureUnits	8
+
+/** The vertex arrays tracked by the recorder. Texture coordinate arrays follow these, one per texture unit. */
+typedef enum {
+	kCC3GLRecordedArrayVertex = 0,
+	kCC3GLRecordedArrayNormal,
+	kCC3GLRecordedArrayColor,
+	kCC3GLRecordedArrayPointSize,
+	kCC3GLRecordedArrayWeight,
+	kCC3GLRecordedArrayMatrixIndex,
+	kCC3GLRecordedArrayTexCoord0,
+	kCC3GLRecordedArrayCount = kCC3GLRecordedArrayTexCoord0 + kCC3GLRecorderMaxTextureUnits
+} CC3GLRecordedArrayIndex;
+
+/** The specification of a vertex array, as last set through a GL pointer function. */
+typedef struct {
+	const GLvoid* pointer;		/**< The pointer, or the offset if buffer is not zero. */
+	GLuint buffer;				/**< The array buffer bound when the pointer was specified. */
+	GLint size;					/**< The number of components in each element. */
+	GLenum type;				/**< The type of each component. */
+	GLsizei stride;				/**< The stride between elements, or zero if tightly packed. */
+	GLboolean isEnabled;		/**< Whether the client state of the array is enabled. */
+} CC3GLRecordedArray;
+
+GLboolean CC3GLRecorderIsActive = GL_FALSE;
+
+static FILE* recorderFile = NULL;
+static GLubyte* recorderBuffer = NULL;
+static GLuint recorderLength = 0;
+static GLuint recorderCapacity = 0;
+static GLuint recorderFrameIndex = 0;
+static GLuint recorderArrayBuffer = 0;
+static GLuint recorderElementArrayBuffer = 0;
+static GLuint recorderClientTextureUnit = 0;
+static GLint recorderUnpackAlignment = 4;
+static CC3GLRecordedArray recorderArrays[kCC3GLRecordedArrayCount];
+
+
+#pragma mark Tracking GL state
+
+/** Returns the index of the tracked vertex array for the specified client state, or -1 if it is not tracked. */
+static GLint CC3GLRecordedArrayIndexFor(GLenum array) {
+	switch (array) {
+		case GL_VERTEX_ARRAY:
+			return kCC3GLRecordedArrayVertex;
+		case GL_NORMAL_ARRAY:
+			return kCC3GLRecordedArrayNormal;
+		case GL_COLOR_ARRAY:
+			return kCC3GLRecordedArrayColor;
+		case GL_POINT_SIZE_ARRAY_OES:
+			return kCC3GLRecordedArrayPointSize;
+		case GL_WEIGHT_ARRAY_OES:
+			return kCC3GLRecordedArrayWeight;
+		case GL_MATRIX_INDEX_ARRAY_OES:
+			return kCC3GLRecordedArrayMatrixIndex;
+		case GL_TEXTURE_COORD_ARRAY:
+			if (recorderClientTextureUnit >= kCC3GLRecorderMaxTextureUnits) return -1;
+			return kCC3GLRecordedArrayTexCoord0 + recorderClientTextureUnit;
+		default:
+			return -1;
+	}
+}
+
+/** Reads the specification of the specified vertex array from GL into the tracked array. */
+static void CC3GLRecorderReadArray(GLint arrayIndex, GLenum array, GLenum sizeName, GLenum typeName,
+								   GLenum strideName, GLenum bufferName, GLenum pointerName) {
+	CC3GLRecordedArray* ra = &recorderArrays[arrayIndex];
+	GLint value;
+	GLvoid* pointer;
+
+	ra->isEnabled = glIsEnabled(array);
+	if (sizeName) {
+		glGetIntegerv(sizeName, &value);
+		ra->size = value;
+	}
+	glGetIntegerv(typeName, &value);
+	ra->type = (GLenum)value;
+	glGetIntegerv(strideName, &value);
+	ra->stride = value;
+	glGetIntegerv(bufferName, &value);
+	ra->buffer = (GLuint)value;
+	glGetPointerv(pointerName, &pointer);
+	ra->pointer = pointer;
+}
+
+/**
+ * Reads the GL state that determines how the data of later calls is captured. The OES
+ * matrix palette and point size arrays cannot be reliably queried on all devices, and
+ * are assumed to be disabled until their client state is recorded.
+ */
+static void CC3GLRecorderReadState(void) {
+	GLint value;
+	GLint maxTexUnits;
+
+	memset(recorderArrays, 0, sizeof(recorderArrays));
+	recorderArrays[kCC3GLRecordedArrayNormal].size = 3;
+	recorderArrays[kCC3GLRecordedArrayPointSize].size = 1;
+
+	glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &value);
+	recorderArrayBuffer = (GLuint)value;
+	glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &value);
+	recorderElementArrayBuffer = (GLuint)value;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &recorderUnpackAlignment);
+
+	CC3GLRecorderReadArray(kCC3GLRecordedArrayVertex, GL_VERTEX_ARRAY, GL_VERTEX_ARRAY_SIZE,
+						   GL_VERTEX_ARRAY_TYPE, GL_VERTEX_ARRAY_STRIDE,
+						   GL_VERTEX_ARRAY_BUFFER_BINDING, GL_VERTEX_ARRAY_POINTER);
+	CC3GLRecorderReadArray(kCC3GLRecordedArrayNormal, GL_NORMAL_ARRAY, 0,
+						   GL_NORMAL_ARRAY_TYPE, GL_NORMAL_ARRAY_STRIDE,
+						   GL_NORMAL_ARRAY_BUFFER_BINDING, GL_NORMAL_ARRAY_POINTER);
+	CC3GLRecorderReadArray(kCC3GLRecordedArrayColor, GL_COLOR_ARRAY, GL_COLOR_ARRAY_SIZE,
+						   GL_COLOR_ARRAY_TYPE, GL_COLOR_ARRAY_STRIDE,
+						   GL_COLOR_ARRAY_BUFFER_BINDING, GL_COLOR_ARRAY_POINTER);
+
+	// Texture coordinate arrays are per texture unit, so visit each unit, then restore the original
+	glGetIntegerv(GL_CLIENT_ACTIVE_TEXTURE, &value);
+	recorderClientTextureUnit = (GLuint)value - GL_TEXTURE0;
+	glGetIntegerv(GL_MAX_TEXTURE_UNITS, &maxTexUnits);
+	if (maxTexUnits > kCC3GLRecorderMaxTextureUnits) maxTexUnits = kCC3GLRecorderMaxTextureUnits;
+	for (GLint tu = 0; tu < maxTexUnits; tu++) {
+		glClientActiveTexture(GL_TEXTURE0 + tu);
+		CC3GLRecorderReadArray(kCC3GLRecordedArrayTexCoord0 + tu, GL_TEXTURE_COORD_ARRAY,
+							   GL_TEXTURE_COORD_ARRAY_SIZE, GL_TEXTURE_COORD_ARRAY_TYPE,
+							   GL_TEXTURE_COORD_ARRAY_STRIDE, GL_TEXTURE_COORD_ARRAY_BUFFER_BINDING,
+							   GL_TEXTURE_COORD_ARRAY_POINTER);
+	}
+	glClientActiveTexture(GL_TEXTURE0 + recorderClientTextureUnit);
+}
+
+/** Updates the tracked GL state from a command that is being appended to the command stream. */
+static void CC3GLRecorderTrackCommand(CC3GLCommandOpcode opcode, GLuint wordCount, const GLuint* words) {
+	GLint arrayIndex;
+	switch (opcode) {
+		case kCC3GLCmd_glBindBuffer:
+			if (wordCount < 2) return;
+			if (words[0] == GL_ARRAY_BUFFER) recorderArrayBuffer = words[1];
+			if (words[0] == GL_ELEMENT_ARRAY_BUFFER) recorderElementArrayBuffer = words[1];
+			return;
+		case kCC3GLCmd_glClientActiveTexture:
+			if (wordCount < 1) return;
+			recorderClientTextureUnit = words[0] - GL_TEXTURE0;
+			return;
+		case kCC3GLCmd_glEnableClientState:
+		case kCC3GLCmd_glDisableClientState:
+			if (wordCount < 1) return;
+			arrayIndex = CC3GLRecordedArrayIndexFor(words[0]);
+			if (arrayIndex >= 0) {
+				recorderArrays[arrayIndex].isEnabled = (opcode == kCC3GLCmd_glEnableClientState);
+			}
+			return;
+		case kCC3GLCmd_glPixelStorei:
+			if (wordCount < 2) return;
+			if (words[0] == GL_UNPACK_ALIGNMENT) recorderUnpackAlignment = (GLint)words[1];
+			return;
+		default:
+			return;
+	}
+}
+
+
+#pragma mark Writing the command stream
+
+/** Writes the buffered commands to the file. */
+static void CC3GLRecorderFlush(void) {
+	GLuint length = recorderLength;
+	recorderLength = 0;
+	if (recorderFile && length && fwrite(recorderBuffer, 1, length, recorderFile) != length) {
+		printf("CC3GLRecorder could not write to the command stream file. Recording stopped.\n");
+		CC3GLRecorderStop();
+	}
+}
+
+/** Ensures the command buffer can hold the specified number of additional bytes. */
+static GLboolean CC3GLRecorderEnsureCapacity(GLuint length) {
+	if (recorderLength + length <= recorderCapacity) return GL_TRUE;
+
+	GLuint newCapacity = recorderCapacity ? recorderCapacity : kCC3GLRecorderFlushLength * 2;
+	while (newCapacity < recorderLength + length) newCapacity *= 2;
+	GLubyte* newBuffer = realloc(recorderBuffer, newCapacity);
+	if ( !newBuffer ) {
+		printf("CC3GLRecorder could not allocate %u bytes for the command buffer. Recording stopped.\n", newCapacity);
+		CC3GLRecorderStop();
+		return GL_FALSE;
+	}
+	recorderBuffer = newBuffer;
+	recorderCapacity = newCapacity;
+	return GL_TRUE;
+}
+
+void CC3GLRecorderAppend(CC3GLCommandOpcode opcode, GLuint wordCount, const GLuint* words,
+						 const GLvoid* data, GLuint dataLength) {
+	if ( !CC3GLRecorderIsActive ) return;
+	if ( !data ) dataLength = 0;
+
+	CC3GLRecorderTrackCommand(opcode, wordCount, words);
+	if (opcode == kCC3GLCmd_glDeleteBuffers) {
+		const GLuint* names = data;
+		for (GLuint i = 0; i < dataLength / sizeof(GLuint); i++) {
+			if (names[i] == recorderArrayBuffer) recorderArrayBuffer = 0;
+			if (names[i] == recorderElementArrayBuffer) recorderElementArrayBuffer = 0;
+		}
+	}
+
+	GLuint wordsLength = wordCount * (GLuint)sizeof(GLuint);
+	GLuint paddedLength = CC3GLCommandPaddedDataLength(dataLength);
+	GLuint commandLength = (GLuint)sizeof(CC3GLCommandHeader) + wordsLength + paddedLength;
+	if ( !CC3GLRecorderEnsureCapacity(commandLength) ) return;
+
+	CC3GLCommandHeader header;
+	header.opcode = (uint16_t)opcode;
+	header.wordCount = (uint16_t)wordCount;
+	header.dataLength = dataLength;
+
+	GLubyte* p = recorderBuffer + recorderLength;
+	memcpy(p, &header, sizeof(header));
+	p += sizeof(header);
+	if (wordsLength) memcpy(p, words, wordsLength);
+	p += wordsLength;
+	if (dataLength) memcpy(p, data, dataLength);
+	memset(p + dataLength, 0, paddedLength - dataLength);
+	recorderLength += commandLength;
+
+	if (recorderLength >= kCC3GLRecorderFlushLength) CC3GLRecorderFlush();
+}
+
+
+#pragma mark Recording control
+
+GLboolean CC3GLRecorderStart(const char* filePath) {
+	CC3GLRecorderStop();
+
+	recorderFile = fopen(filePath, "wb");
+	if ( !recorderFile ) {
+		printf("CC3GLRecorder could not create the command stream file %s.\n", filePath);
+		return GL_FALSE;
+	}
+
+	CC3GLCommandStreamHeader header;
+	memcpy(header.magic, kCC3GLCommandStreamMagic, sizeof(header.magic));
+	header.version = kCC3GLCommandStreamVersion;
+	header.byteOrderMark = kCC3GLCommandStreamByteOrderMark;
+	fwrite(&header, sizeof(header), 1, recorderFile);
+
+	CC3GLRecorderReadState();
+	recorderFrameIndex = 0;
+	recorderLength = 0;
+	CC3GLRecorderIsActive = GL_TRUE;
+	return GL_TRUE;
+}
+
+void CC3GLRecorderStop(void) {
+	if ( !recorderFile ) return;
+
+	// If the flush fails, it stops the recorder itself
+	CC3GLRecorderFlush();
+	if ( !recorderFile ) return;
+
+	fclose(recorderFile);
+	recorderFile = NULL;
+
+	CC3GLRecorderIsActive = GL_FALSE;
+	free(recorderBuffer);
+	recorderBuffer = NULL;
+	recorderLength = 0;
+	recorderCapacity = 0;
+}
+
+void CC3GLRecorderMarkFrame(void) {
+	if ( !CC3GLRecorderIsActive ) return;
+	GLuint frameIndex = recorderFrameIndex++;
+	CC3GLRecorderAppend(kCC3GLCmdFrame, 1, &frameIndex, NULL, 0);
+}
+
+
+#pragma mark Recording vertex arrays and draws
+
+void CC3GLRecordVertexArray(CC3GLCommandOpcode opcode, GLenum array, GLint size,
+							GLenum type, GLsizei stride, const GLvoid* pointer) {
+	if ( !CC3GLRecorderIsActive ) return;
+
+	GLint arrayIndex = CC3GLRecordedArrayIndexFor(array);
+	if (arrayIndex >= 0) {
+		CC3GLRecordedArray* ra = &recorderArrays[arrayIndex];
+		ra->pointer = pointer;
+		ra->buffer = recorderArrayBuffer;
+		ra->size = size;
+		ra->type = type;
+		ra->stride = stride;
+	}
+
+	// The normal and point size pointer functions do not take a size parameter
+	if (array == GL_NORMAL_ARRAY || array == GL_POINT_SIZE_ARRAY_OES) {
+		GLuint words[] = { type, (GLuint)stride, CC3GLPointerWord(pointer) };
+		CC3GLRecorderAppend(opcode, 3, words, NULL, 0);
+	} else {
+		GLuint words[] = { (GLuint)size, type, (GLuint)stride, CC3GLPointerWord(pointer) };
+		CC3GLRecorderAppend(opcode, 4, words, NULL, 0);
+	}
+}
+
+/** Returns the array enum for the tracked vertex array at the specified index. */
+static GLenum CC3GLRecordedArrayEnum(GLint arrayIndex) {
+	switch (arrayIndex) {
+		case kCC3GLRecordedArrayVertex:
+			return GL_VERTEX_ARRAY;
+		case kCC3GLRecordedArrayNormal:
+			return GL_NORMAL_ARRAY;
+		case kCC3GLRecordedArrayColor:
+			return GL_COLOR_ARRAY;
+		case kCC3GLRecordedArrayPointSize:
+			return GL_POINT_SIZE_ARRAY_OES;
+		case kCC3GLRecordedArrayWeight:
+			return GL_WEIGHT_ARRAY_OES;
+		case kCC3GLRecordedArrayMatrixIndex:
+			return GL_MATRIX_INDEX_ARRAY_OES;
+		default:
+			return GL_TEXTURE_COORD_ARRAY;
+	}
+}
+
+/** Returns whether any enabled vertex array is read from client memory. */
+static GLboolean CC3GLRecorderHasClientArrays(void) {
+	for (GLint i = 0; i < kCC3GLRecordedArrayCount; i++) {
+		CC3GLRecordedArray* ra = &recorderArrays[i];
+		if (ra->isEnabled && !ra->buffer && ra->pointer) return GL_TRUE;
+	}
+	return GL_FALSE;
+}
+
+/**
+ * Records the contents of the specified range of vertices of each enabled vertex array
+ * that is read from client memory.
+ */
+static void CC3GLRecordClientArrays(GLint first, GLsizei count) {
+	if (first < 0 || count <= 0) return;
+
+	for (GLint i = 0; i < kCC3GLRecordedArrayCount; i++) {
+		CC3GLRecordedArray* ra = &recorderArrays[i];
+		if ( !(ra->isEnabled && !ra->buffer && ra->pointer) ) continue;
+
+		GLuint elementLength = ra->size * (GLuint)GLElementTypeSize(ra->type);
+		if ( !elementLength ) continue;
+		GLuint stride = ra->stride ? (GLuint)ra->stride : elementLength;
+		GLuint dataLength = stride * (count - 1) + elementLength;
+		GLuint texUnit = (i >= kCC3GLRecordedArrayTexCoord0) ? (i - kCC3GLRecordedArrayTexCoord0) : 0;
+
+		GLuint words[] = { CC3GLRecordedArrayEnum(i), texUnit, (GLuint)ra->size,
+						   ra->type, (GLuint)ra->stride, (GLuint)first };
+		CC3GLRecorderAppend(kCC3GLCmdClientArray, 6, words,
+							(const GLubyte*)ra->pointer + (stride * first), dataLength);
+	}
+}
+
+void CC3GLRecordDrawArrays(GLenum mode, GLint first, GLsizei count) {
+	if ( !CC3GLRecorderIsActive ) return;
+
+	CC3GLRecordClientArrays(first, count);
+	GLuint words[] = { mode, (GLuint)first, (GLuint)count };
+	CC3GLRecorderAppend(kCC3GLCmd_glDrawArrays, 3, words, NULL, 0);
+}
+
+void CC3GLRecordDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices) {
+	if ( !CC3GLRecorderIsActive ) return;
+
+	GLuint words[] = { mode, (GLuint)count, type, CC3GLPointerWord(indices) };
+
+	// Indices in a bound buffer cannot be read, so neither can the range of vertices they use
+	if (recorderElementArrayBuffer || !indices || count <= 0) {
+		CC3GLRecorderAppend(kCC3GLCmd_glDrawElements, 4, words, NULL, 0);
+		return;
+	}
+
+	// Find the range of vertices used by the indices, and capture those from any client arrays
+	GLuint indexSize = (GLuint)GLElementTypeSize(type);
+	if (indexSize && CC3GLRecorderHasClientArrays()) {
+		GLuint minIndex = ~0U, maxIndex = 0;
+		for (GLsizei i = 0; i < count; i++) {
+			GLuint idx = (indexSize == sizeof(GLubyte))
+							? ((const GLubyte*)indices)[i]
+							: ((const GLushort*)indices)[i];
+			if (idx < minIndex) minIndex = idx;
+			if (idx > maxIndex) maxIndex = idx;
+		}
+		CC3GLRecordClientArrays(minIndex, maxIndex - minIndex + 1);
+	}
+	CC3GLRecorderAppend(kCC3GLCmd_glDrawElements, 4, words, indices, count * indexSize);
+}
+
+
+#pragma mark Data sizes
+
+GLuint CC3GLParameterCount(GLenum pname) {
+	switch (pname) {
+		case GL_AMBIENT:
+		case GL_DIFFUSE:
+		case GL_SPECULAR:
+		case GL_EMISSION:
+		case GL_POSITION:
+		case GL_AMBIENT_AND_DIFFUSE:
+		case GL_LIGHT_MODEL_AMBIENT:
+		case GL_FOG_COLOR:
+		case GL_TEXTURE_ENV_COLOR:
+			return 4;
+		case GL_SPOT_DIRECTION:
+		case GL_POINT_DISTANCE_ATTENUATION:
+			return 3;
+		default:
+			return 1;
+	}
+}
+
+GLuint CC3GLPixelDataLength(GLsizei width, GLsizei height, GLenum format, GLenum type) {
+	if (width <= 0 || height <= 0) return 0;
+
+	GLuint pixelSize;
+	switch (type) {
+		case GL_UNSIGNED_SHORT_5_6_5:
+		case GL_UNSIGNED_SHORT_4_4_4_4:
+		case GL_UNSIGNED_SHORT_5_5_5_1:
+			pixelSize = 2;
+			break;
+		case GL_UNSIGNED_BYTE:
+			switch (format) {
+				case GL_ALPHA:
+				case GL_LUMINANCE:
+					pixelSize = 1;
+					break;
+				case GL_LUMINANCE_ALPHA:
+					pixelSize = 2;
+					break;
+				case GL_RGB:
+					pixelSize = 3;
+					break;
+				default:
+					pixelSize = 4;
+					break;
+			}
+			break;
+		default:
+			return 0;
+	}
+
+	GLuint align = (recorderUnpackAlignment > 0) ? (GLuint)recorderUnpackAlignment : 1;
+	GLuint rowLength = width * pixelSize;
+	GLuint alignedRowLength = (rowLength + align - 1) / align * align;
+	return alignedRowLength * (height - 1) + rowLength;
+}
@@ -0,0 +1,184 @@
+/*
+ * CC3OpenGLES11Recorder.h
+ *
+ * cocos3d 0.7.1
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2012 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+
+/** @file */	// Doxygen marker
+
+/**
+ * This file adds the ability to record the OpenGL ES 1.1 gl* calls made by the
+ * application into a compact binary command stream, whose format is described in
+ * CC3OpenGLES11CommandStream.h. The command stream can then be analyzed, or replayed
+ * against a null driver, by the offline CC3GLCommandTool found in the Tools folder,
+ * on any machine, including those without a GPU.
+ *
+ * Recording uses the same call-interception mechanism as GL logging. To enable it,
+ * set the compiler switch GL_RECORDING_ENABLED to 1, as described in the notes for
+ * CC3OpenGLES11Intercept.h. With the switch set, nothing is recorded until the
+ * application invokes CC3GLRecorderStart, and recording continues until it invokes
+ * CC3GLRecorderStop. The CC3OpenGLES11Engine marks the start of each frame in the
+ * command stream when it is opened.
+ *
+ * The recorder keeps track of the buffer bindings and vertex array pointers, so that
+ * vertex and index data that is drawn from client memory, rather than from buffers,
+ * is captured along with the draw call that reads it. Vertex data drawn from client
+ * memory using glDrawElements with a bound index buffer cannot be sized without
+ * reading back that buffer, and so is not captured.
+ *
+ * Like the GL calls it records, the recorder is not thread-safe, and must be used
+ * from the thread that owns the GL context.
+ */
+
+#include <OpenGLES/ES1/gl.h>
+#include <OpenGLES/ES1/glext.h>
+#include <string.h>
+#include "CC3OpenGLES11CommandStream.h"
+
+
+#pragma mark -
+#pragma mark Recording control
+
+/**
+ * Starts recording GL calls into a new command stream in the file at the specified path,
+ * replacing any existing file. If recording was already active, the previous command
+ * stream is first closed, as if CC3GLRecorderStop had been invoked.
+ *
+ * Returns GL_TRUE if recording was started, or GL_FALSE if the file could not be created.
+ *
+ * This has no effect on the recorded GL calls unless the GL_RECORDING_ENABLED compiler
+ * switch is set to 1.
+ */
+GLboolean CC3GLRecorderStart(const char* filePath);
+
+/** Stops recording, writing any buffered commands to the file and closing it. */
+void CC3GLRecorderStop(void);
+
+/**
+ * Marks the start of a new frame in the command stream. Tools use this marker to
+ * break the stream into frames.
+ */
+void CC3GLRecorderMarkFrame(void);
+
+/** Whether GL calls are currently being recorded. Maintained by CC3GLRecorderStart & CC3GLRecorderStop. */
+extern GLboolean CC3GLRecorderIsActive;
+
+
+#pragma mark -
+#pragma mark Recording commands
+
+/**
+ * Appends a command to the command stream, consisting of the specified opcode, followed
+ * by the specified number of parameter words, followed by dataLength bytes copied from
+ * the specified data pointer. The data may be NULL if dataLength is zero.
+ *
+ * The recorder also watches the recorded buffer bindings, client state changes, and
+ * pixel store settings, in order to know how to capture the data of later calls.
+ *
+ * Most callers should use the CC3GLRecord family of macros instead of calling this directly.
+ */
+void CC3GLRecorderAppend(CC3GLCommandOpcode opcode, GLuint wordCount, const GLuint* words,
+						 const GLvoid* data, GLuint dataLength);
+
+/**
+ * Records a call to a vertex array pointer function (eg. glVertexPointer), identified by
+ * the specified opcode, for the specified array (eg. GL_VERTEX_ARRAY). The array
+ * specification is remembered so that its contents can be captured when it is drawn
+ * from client memory.
+ */
+void CC3GLRecordVertexArray(CC3GLCommandOpcode opcode, GLenum array, GLint size,
+							GLenum type, GLsizei stride, const GLvoid* pointer);
+
+/**
+ * Records a call to glDrawArrays, preceded by the contents of any enabled vertex arrays
+ * that will be read from client memory.
+ */
+void CC3GLRecordDrawArrays(GLenum mode, GLint first, GLsizei count);
+
+/**
+ * Records a call to glDrawElements, including the indices if they are read from client
+ * memory, preceded by the contents of any enabled vertex arrays that will be read from
+ * client memory.
+ */
+void CC3GLRecordDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices);
+
+/**
+ * Returns the number of values read by a GL parameter-vector call (eg. glLightfv)
+ * for the specified parameter name.
+ */
+GLuint CC3GLParameterCount(GLenum pname);
+
+/**
+ * Returns the number of bytes of pixel data read by glTexImage2D or glTexSubImage2D for
+ * an image of the specified dimensions, format and type, taking into consideration the
+ * current GL_UNPACK_ALIGNMENT setting.
+ */
+GLuint CC3GLPixelDataLength(GLsizei width, GLsizei height, GLenum format, GLenum type);
+
+/** Returns the specified float as a parameter word holding its bit pattern. */
+static inline GLuint CC3GLFloatWord(GLfloat f) {
+	GLuint word;
+	memcpy(&word, &f, sizeof(word));
+	return word;
+}
+
+/** Returns the specified pointer as a parameter word holding its low 32 bits. */
+static inline GLuint CC3GLPointerWord(const GLvoid* p) { return (GLuint)(unsigned long)p; }
+
+/**
+ * Records a GL call with the specified opcode and no parameters.
+ * Does nothing if recording is not active.
+ */
+#define CC3GLRecordCommand(opcode)	\
+	do { if (CC3GLRecorderIsActive) CC3GLRecorderAppend((opcode), 0, NULL, NULL, 0); } while (0)
+
+/**
+ * Records a GL call with the specified opcode and no parameter words, along with
+ * dataLength bytes of data read from the specified pointer.
+ * Does nothing if recording is not active.
+ */
+#define CC3GLRecordCommandData(opcode, data, dataLength)	\
+	do { if (CC3GLRecorderIsActive) CC3GLRecorderAppend((opcode), 0, NULL, (data), (GLuint)(dataLength)); } while (0)
+
+/**
+ * Records a GL call with the specified opcode and parameter words.
+ * Does nothing if recording is not active.
+ */
+#define CC3GLRecord(opcode, ...)	\
+	CC3GLRecordData(opcode, NULL, 0, __VA_ARGS__)
+
+/**
+ * Records a GL call with the specified opcode and parameter words, along with dataLength
+ * bytes of data read from the specified pointer. Does nothing if recording is not active.
+ */
+#define CC3GLRecordData(opcode, data, dataLength, ...)	\
+	do {	\
+		if (CC3GLRecorderIsActive) {	\
+			const GLuint _cc3Words[] = { __VA_ARGS__ };	\
+			CC3GLRecorderAppend((opcode), sizeof(_cc3Words) / sizeof(GLuint), _cc3Words,	\
+								(data), (GLuint)(dataLength));	\
+		}	\
+	} while (0)
@@ -54,7 +54,7 @@
 }
 
 -(void) setGLValue {
-	glPointParameterf(name, value);
+	glPointParameterf(name, self.value);
 }
 
 @end
@@ -70,7 +70,7 @@
 }
 
 -(void) setGLValue {
-	glPointParameterfv(name, (GLfloat*)&value);
+	glPointParameterfv(name, CC3GLESStateCacheFloats(stateCache, stateEntry));
 }
 
 @end
@@ -0,0 +1,258 @@
+/*
+ * CC3OpenGLES11StateCache.c
+ *
+ * cocos3d 0.7.1
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2012 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ *
+ * See header file CC3OpenGLES11StateCache.h for full API documentation.
+ */
+
+#include "CC3OpenGLES11StateCache.h"
+#include "CC3OpenGLES11Intercept.h"
+#include <stdlib.h>
+
+/** The number of entries for which space is allocated when the first entry is added. */
+#define kCC3GLESStateCacheInitialEntryCapacity	128
+
+/** The number of GLuint words needed to hold a bitfield with the specified number of bits. */
+#define CC3GLESStateBitWords(bitCount)	(((bitCount) + 31) >> 5)
+
+void CC3GLESStateCacheInitialize(CC3GLESStateCache* sc) {
+	memset(sc, 0, sizeof(CC3GLESStateCache));
+}
+
+void CC3GLESStateCacheDeallocate(CC3GLESStateCache* sc) {
+	free(sc->entries);
+	free(sc->booleanValues);
+	free(sc->booleanOriginals);
+	free(sc->knownBits);
+	free(sc->dirtyBits);
+	free(sc->alwaysSetBits);
+	free(sc->openBits);
+	free(sc->floatValues);
+	free(sc->floatOriginals);
+	free(sc->intValues);
+	free(sc->intOriginals);
+	free(sc->pointerValues);
+	free(sc->pointerOriginals);
+	CC3GLESStateCacheInitialize(sc);
+}
+
+/**
+ * Reallocates the specified array from the old length to the new length, in bytes,
+ * clearing the new space. Aborts if the memory cannot be allocated, since the GL
+ * state cannot be tracked without it.
+ */
+static void* CC3GLESStateCacheGrow(void* array, size_t oldLength, size_t newLength) {
+	char* newArray = realloc(array, newLength);
+	if ( !newArray ) abort();
+	memset(newArray + oldLength, 0, newLength - oldLength);
+	return newArray;
+}
+
+/** Ensures there is space for at least one more entry in the specified cache. */
+static void CC3GLESStateCacheEnsureEntryCapacity(CC3GLESStateCache* sc) {
+	if (sc->entryCount < sc->entryCapacity) return;
+
+	GLuint oldCap = sc->entryCapacity;
+	GLuint newCap = oldCap ? (oldCap * 2) : kCC3GLESStateCacheInitialEntryCapacity;
+	size_t oldBitLen = CC3GLESStateBitWords(oldCap) * sizeof(GLuint);
+	size_t newBitLen = CC3GLESStateBitWords(newCap) * sizeof(GLuint);
+
+	sc->entries = CC3GLESStateCacheGrow(sc->entries,
+										oldCap * sizeof(CC3GLESStateEntry),
+										newCap * sizeof(CC3GLESStateEntry));
+	sc->booleanValues = CC3GLESStateCacheGrow(sc->booleanValues, oldBitLen, newBitLen);
+	sc->booleanOriginals = CC3GLESStateCacheGrow(sc->booleanOriginals, oldBitLen, newBitLen);
+	sc->knownBits = CC3GLESStateCacheGrow(sc->knownBits, oldBitLen, newBitLen);
+	sc->dirtyBits = CC3GLESStateCacheGrow(sc->dirtyBits, oldBitLen, newBitLen);
+	sc->alwaysSetBits = CC3GLESStateCacheGrow(sc->alwaysSetBits, oldBitLen, newBitLen);
+	sc->openBits = CC3GLESStateCacheGrow(sc->openBits, oldBitLen, newBitLen);
+	sc->entryCapacity = newCap;
+}
+
+/**
+ * Reserves the specified number of elements in a pair of value arrays of the specified element
+ * size, growing the arrays if needed, and returns the index of the first reserved element.
+ */
+static GLuint CC3GLESStateCacheReserve(void** values, void** originals, GLuint* count,
+									   GLuint* capacity, GLuint width, size_t elemSize) {
+	GLuint offset = *count;
+	if (offset + width > *capacity) {
+		GLuint oldCap = *capacity;
+		GLuint newCap = oldCap ? (oldCap * 2) : kCC3GLESStateCacheInitialEntryCapacity;
+		while (offset + width > newCap) newCap *= 2;
+		*values = CC3GLESStateCacheGrow(*values, oldCap * elemSize, newCap * elemSize);
+		*originals = CC3GLESStateCacheGrow(*originals, oldCap * elemSize, newCap * elemSize);
+		*capacity = newCap;
+	}
+	*count = offset + width;
+	return offset;
+}
+
+GLuint CC3GLESStateCacheAddEntry(CC3GLESStateCache* sc, CC3GLESStateKind kind, GLuint width) {
+	CC3GLESStateCacheEnsureEntryCapacity(sc);
+
+	GLuint entryIdx = sc->entryCount++;
+	CC3GLESStateEntry* pEntry = &sc->entries[entryIdx];
+	pEntry->name = 0;
+	pEntry->kind = kind;
+	pEntry->width = width;
+	pEntry->readMode = kCC3GLESStateReadByOwner;
+	pEntry->originalValueHandling = kCC3GLESStateOriginalValueIgnore;
+
+	switch (kind) {
+		case kCC3GLESStateKindFloat:
+			pEntry->offset = CC3GLESStateCacheReserve((void**)&sc->floatValues, (void**)&sc->floatOriginals,
+													  &sc->floatCount, &sc->floatCapacity,
+													  width, sizeof(GLfloat));
+			break;
+		case kCC3GLESStateKindInteger:
+			pEntry->offset = CC3GLESStateCacheReserve((void**)&sc->intValues, (void**)&sc->intOriginals,
+													  &sc->intCount, &sc->intCapacity,
+													  width, sizeof(GLint));
+			break;
+		case kCC3GLESStateKindPointer:
+			pEntry->offset = CC3GLESStateCacheReserve((void**)&sc->pointerValues, (void**)&sc->pointerOriginals,
+													  &sc->pointerCount, &sc->pointerCapacity,
+													  width, sizeof(GLvoid*));
+			break;
+		default:		// Booleans are held in bitfields indexed by entry
+			pEntry->offset = 0;
+			break;
+	}
+	return entryIdx;
+}
+
+/** Returns whether the specified entry must be read from the GL engine on every open. */
+static inline GLboolean CC3GLESStateEntryShouldAlwaysRead(const CC3GLESStateEntry* pEntry) {
+	return pEntry->name &&
+			(pEntry->originalValueHandling == kCC3GLESStateOriginalValueReadAlways ||
+			 pEntry->originalValueHandling == kCC3GLESStateOriginalValueReadAlwaysAndRestore);
+}
+
+void CC3GLESStateCacheConfigureEntry(CC3GLESStateCache* sc, GLuint entry, GLenum name,
+									 CC3GLESStateReadMode readMode,
+									 CC3GLESStateOriginalValueHandling origValueHandling) {
+	CC3GLESStateEntry* pEntry = &sc->entries[entry];
+	pEntry->name = name;
+	pEntry->readMode = readMode;
+	pEntry->originalValueHandling = origValueHandling;
+	CC3GLESStateBitSet(sc->openBits, entry, (readMode != kCC3GLESStateReadByOwner));
+}
+
+/** Reads the original value of the specified entry from the GL engine, using the read mode of the entry. */
+static void CC3GLESStateCacheReadOriginal(CC3GLESStateCache* sc, GLuint entry) {
+	const CC3GLESStateEntry* pEntry = &sc->entries[entry];
+	switch (pEntry->readMode) {
+		case kCC3GLESStateReadBoolean: {
+			GLboolean glValue;
+			glGetBooleanv(pEntry->name, &glValue);
+			CC3GLESStateCacheSetOriginalBoolean(sc, entry, (glValue != GL_FALSE));
+			break;
+		}
+		case kCC3GLESStateReadFloat:
+			glGetFloatv(pEntry->name, CC3GLESStateCacheOriginalFloats(sc, entry));
+			break;
+		case kCC3GLESStateReadInteger:
+			glGetIntegerv(pEntry->name, CC3GLESStateCacheOriginalInts(sc, entry));
+			break;
+		default:
+			break;
+	}
+}
+
+void CC3GLESStateCacheRestoreOriginal(CC3GLESStateCache* sc, GLuint entry) {
+	const CC3GLESStateEntry* pEntry = &sc->entries[entry];
+	switch (pEntry->kind) {
+		case kCC3GLESStateKindBoolean:
+			CC3GLESStateCacheSetBoolean(sc, entry, CC3GLESStateCacheOriginalBoolean(sc, entry));
+			break;
+		case kCC3GLESStateKindFloat:
+			memcpy(CC3GLESStateCacheFloats(sc, entry),
+				   CC3GLESStateCacheOriginalFloats(sc, entry),
+				   pEntry->width * sizeof(GLfloat));
+			break;
+		case kCC3GLESStateKindInteger:
+			memcpy(CC3GLESStateCacheInts(sc, entry),
+				   CC3GLESStateCacheOriginalInts(sc, entry),
+				   pEntry->width * sizeof(GLint));
+			break;
+		case kCC3GLESStateKindPointer:
+			memcpy(CC3GLESStateCachePointer(sc, entry),
+				   CC3GLESStateCacheOriginalPointer(sc, entry),
+				   pEntry->width * sizeof(GLvoid*));
+			break;
+		default:
+			break;
+	}
+}
+
+void CC3GLESStateCacheOpenEntry(CC3GLESStateCache* sc, GLuint entry) {
+	const CC3GLESStateEntry* pEntry = &sc->entries[entry];
+	switch (pEntry->originalValueHandling) {
+		case kCC3GLESStateOriginalValueIgnore:
+			CC3GLESStateCacheSetKnown(sc, entry, GL_FALSE);
+			break;
+		case kCC3GLESStateOriginalValueReadOnce:
+		case kCC3GLESStateOriginalValueReadOnceAndRestore:
+			if (CC3GLESStateCacheIsKnown(sc, entry)) break;
+		case kCC3GLESStateOriginalValueReadAlways:
+		case kCC3GLESStateOriginalValueReadAlwaysAndRestore:
+			if (pEntry->name) {
+				CC3GLESStateCacheReadOriginal(sc, entry);
+				CC3GLESStateCacheRestoreOriginal(sc, entry);
+				CC3GLESStateCacheSetKnown(sc, entry, GL_TRUE);
+			} else {
+				CC3GLESStateCacheSetKnown(sc, entry, GL_FALSE);
+			}
+			break;
+		case kCC3GLESStateOriginalValueRestore:
+			CC3GLESStateCacheRestoreOriginal(sc, entry);
+			CC3GLESStateCacheSetKnown(sc, entry, GL_TRUE);
+			break;
+		default:
+			break;
+	}
+}
+
+void CC3GLESStateCacheOpen(CC3GLESStateCache* sc) {
+	GLuint wordCount = CC3GLESStateBitWords(sc->entryCount);
+	for (GLuint wordIdx = 0; wordIdx < wordCount; wordIdx++) {
+		GLuint bits = sc->openBits[wordIdx];
+		while (bits) {
+			GLuint bitIdx = __builtin_ctz(bits);
+			GLuint entry = (wordIdx << 5) + bitIdx;
+			bits &= bits - 1;
+
+			CC3GLESStateCacheOpenEntry(sc, entry);
+
+			// Only entries that must be read on every frame remain to be opened next time.
+			if ( !CC3GLESStateEntryShouldAlwaysRead(&sc->entries[entry]) ) {
+				sc->openBits[wordIdx] &= ~(1u << bitIdx);
+			}
+		}
+	}
+}
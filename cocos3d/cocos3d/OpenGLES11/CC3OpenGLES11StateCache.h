@@ -0,0 +1,398 @@
+/*
+ * CC3OpenGLES11StateCache.h
+ *
+ * cocos3d 0.7.1
+ * Author: Bill Hollings
+ * Copyright (c) 2010-2012 The Brenwill Workshop Ltd. All rights reserved.
+ * http://www.brenwill.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+
+/** @file */	// Doxygen marker
+
+
+#include <OpenGLES/ES1/gl.h>
+#include <OpenGLES/ES1/glext.h>
+#include <string.h>
+
+/**
+ * An enumeration of the techniques for handling the existing value of a GL state
+ * at the time the CC3OpenGLES11Engine singleton instance open method is invoked,
+ * combined with techniques for how to leave that GL state when the singleton
+ * close method is invoked, prior to the resumption of normal cocos2d 2D drawing.
+ * The following types of original value handling are available:
+ *
+ *   - kCC3GLESStateOriginalValueIgnore: The original value of the GL state when the 
+ *     CC3OpenGLES11Engine open method is invoked is ignored. The first subsequent
+ *     state change will always set the GL state. The GL state is left as-is when the
+ *     CC3OpenGLES11Engine close method is invoked.
+ *
+ *   - kCC3GLESStateOriginalValueReadOnce: The original GL state value is read once,
+ *     on the fist invocation of the CC3OpenGLES11Engine open method, and is remembered.
+ *     The value is assumed to always have this value at the time of any subsequent
+ *     invocations of the CC3OpenGLES11Engine open method. The first subsequent attempt
+ *     to change this GL state value will only be forwarded to the GL function if it is
+ *     different than this value. The GL state is left as-is when the CC3OpenGLES11Engine
+ *     close method is invoked.
+ *
+ *   - kCC3GLESStateOriginalValueReadAlways: The original GL state value is read on
+ *     every invocation of the CC3OpenGLES11Engine open method. The first subsequent
+ *     attempt to change this GL state value will only be forwarded to the GL function
+ *     if it is different than this value. The GL state is left as-is when the
+ *     CC3OpenGLES11Engine close method is invoked.
+ *
+ *   - kCC3GLESStateOriginalValueReadOnceAndRestore: The original GL state value is read
+ *     as described for kCC3GLESStateOriginalValueReadOnce. On every invocation of the
+ *     CC3OpenGLES11Engine close method, the GL state is ensured to be set back to this
+ *     value before 2D drawing resumes.
+ *
+ *   - kCC3GLESStateOriginalValueReadAlwaysAndRestore: The original GL state value is read
+ *     as described for kCC3GLESStateOriginalValueReadAlways. On every invocation of the
+ *     CC3OpenGLES11Engine close method, the GL state is ensured to be set back to this value
+ *     before 2D drawing resumes.
+ *
+ *   - kCC3GLESStateOriginalValueRestore: The original GL state value is set manually
+ *     during initialization. On every invocation of the CC3OpenGLES11Engine close method,
+ *     the GL state is ensured to be set back to this value before 2D drawing resumes.
+ *
+ * For maximum throughput in the GL engine, reading of GL state from the GL engine should
+ * be minimized. Therefore, the enumerations kCC3GLESStateOriginalValueReadAlways and
+ * kCC3GLESStateOriginalValueReadAlwaysAndRestore should be avoided whenever possible and
+ * only used as a last resort.
+ * 
+ * The enumeration kCC3GLESStateOriginalValueIgnore is best for GL state that has an
+ * unpredictable value when the CC3OpenGLES11Engine method is invoked, and where cocos2d
+ * does not expect the state to be in any particular value when 2D drawing resumes after
+ * 3D drawing is complete.
+ * 
+ * The enumeration kCC3GLESStateOriginalValueReadOnceAndRestore is best for GL state that
+ * must be left with a predictable value when the CC3OpenGLES11Engine close method is 
+ * invoked. This is typical for state that cocos2d expects to have a particular value 
+ * when 2D drawing resumes after 3D drawing is complete.
+ * 
+ * The enumeration kCC3GLESStateOriginalValueReadAlwaysAndRestore should only be used
+ * for GL state that is unpredictable when 3D drawing begins, but must be left in that
+ * same state when 2D drawing ends. This is rare, and should only be used as a last resort.
+ * 
+ * The enumeration kCC3GLESStateOriginalValueRestore should only be used when it is not
+ * possible to read the GL value from the GL engine. This is the case for a few OES state values.
+ * 
+ * The enumerations kCC3GLESStateOriginalValueReadOnce and kCC3GLESStateOriginalValueReadAlways
+ * have limited value, since they perform a GL read, but do not restore that value once 3D
+ * drawing is complete. It is generally better to simply use the enumeration
+ * kCC3GLESStateOriginalValueIgnore instead. However, kCC3GLESStateOriginalValueReadOnce can
+ * be useful for reading platform characteristics and limits.
+ */
+typedef enum {
+	kCC3GLESStateOriginalValueIgnore = 1,
+	kCC3GLESStateOriginalValueReadOnce,
+	kCC3GLESStateOriginalValueReadAlways,
+	kCC3GLESStateOriginalValueReadOnceAndRestore,
+	kCC3GLESStateOriginalValueReadAlwaysAndRestore,
+	kCC3GLESStateOriginalValueRestore
+} CC3GLESStateOriginalValueHandling;
+
+
+#pragma mark -
+#pragma mark CC3GLESStateCache
+
+/** The types of values that can be held by an entry in a CC3GLESStateCache. */
+typedef enum {
+	kCC3GLESStateKindBoolean = 1,		/**< A single bit, held in the booleanValues bitfield. */
+	kCC3GLESStateKindFloat,				/**< One or more GLfloats, packed into the floatValues array. */
+	kCC3GLESStateKindInteger,			/**< One or more GLints, packed into the intValues array. */
+	kCC3GLESStateKindPointer,			/**< A single pointer, held in the pointerValues array. */
+} CC3GLESStateKind;
+
+/**
+ * The GL function that the CC3GLESStateCacheOpen function can use to read the original value of
+ * an entry from the GL engine. Entries that need a more specialized GL function to read their
+ * value, such as glGetLightfv, use kCC3GLESStateReadByOwner, and are read by their owner.
+ */
+typedef enum {
+	kCC3GLESStateReadByOwner = 0,		/**< The original value is read by the owner of the entry. */
+	kCC3GLESStateReadBoolean,			/**< The original value is read with glGetBooleanv. */
+	kCC3GLESStateReadFloat,				/**< The original value is read with glGetFloatv. */
+	kCC3GLESStateReadInteger,			/**< The original value is read with glGetIntegerv. */
+} CC3GLESStateReadMode;
+
+/** Describes one GL state value held in a CC3GLESStateCache. */
+typedef struct {
+	GLenum name;						/**< The GL name of the state, or zero if it is not readable. */
+	GLuint offset;						/**< The index of the first element of the value in the array for its kind. */
+	GLubyte kind;						/**< The CC3GLESStateKind of the value. */
+	GLubyte width;						/**< The number of elements in the value. */
+	GLubyte readMode;					/**< The CC3GLESStateReadMode used to read the original value. */
+	GLubyte originalValueHandling;		/**< The CC3GLESStateOriginalValueHandling of the state. */
+} CC3GLESStateEntry;
+
+/**
+ * A compact block holding the current and original values of GL state, as last set in the GL engine.
+ *
+ * Each GL state value is identified by the index of its entry in this cache. The values themselves
+ * are held in packed arrays, one per kind of value. Boolean values, such as capabilities, are held
+ * as bits, and colors, vectors and light parameters are packed into contiguous runs of GLfloats.
+ *
+ * The bitfields are indexed by entry, and indicate whether the value of each entry in the GL engine
+ * is currently known, whether each entry has been set in the GL engine since it was last closed,
+ * and whether each entry should always be set in the GL engine, even if its value is unchanged.
+ *
+ * Entries are added using the CC3GLESStateCacheAddEntry function, and are never removed. The arrays
+ * grow as entries are added, so pointers to values should not be retained across additions.
+ */
+typedef struct {
+	CC3GLESStateEntry* entries;			/**< The entries in this cache. */
+	GLuint entryCount;					/**< The number of entries in this cache. */
+	GLuint entryCapacity;				/**< The number of entries that can be added before the arrays must grow. */
+	GLuint* booleanValues;				/**< Bitfield of the current value of boolean entries. */
+	GLuint* booleanOriginals;			/**< Bitfield of the original value of boolean entries. */
+	GLuint* knownBits;					/**< Bitfield indicating whether the value of each entry is known. */
+	GLuint* dirtyBits;					/**< Bitfield indicating whether each entry has been set since it was closed. */
+	GLuint* alwaysSetBits;				/**< Bitfield indicating whether each entry should always be set in GL. */
+	GLuint* openBits;					/**< Bitfield indicating which entries the next open will read or reset. */
+	GLfloat* floatValues;				/**< The current values of float entries. */
+	GLfloat* floatOriginals;			/**< The original values of float entries. */
+	GLuint floatCount;					/**< The number of elements used in the float arrays. */
+	GLuint floatCapacity;				/**< The number of elements allocated in the float arrays. */
+	GLint* intValues;					/**< The current values of integer entries. */
+	GLint* intOriginals;				/**< The original values of integer entries. */
+	GLuint intCount;					/**< The number of elements used in the integer arrays. */
+	GLuint intCapacity;					/**< The number of elements allocated in the integer arrays. */
+	const GLvoid** pointerValues;		/**< The current values of pointer entries. */
+	const GLvoid** pointerOriginals;	/**< The original values of pointer entries. */
+	GLuint pointerCount;				/**< The number of elements used in the pointer arrays. */
+	GLuint pointerCapacity;				/**< The number of elements allocated in the pointer arrays. */
+} CC3GLESStateCache;
+
+/** Initializes the specified cache to contain no entries. */
+void CC3GLESStateCacheInitialize(CC3GLESStateCache* sc);
+
+/** Releases the memory used by the specified cache, which is left empty. */
+void CC3GLESStateCacheDeallocate(CC3GLESStateCache* sc);
+
+/**
+ * Adds an entry of the specified kind and width to the specified cache, and returns the index of
+ * the new entry, which is used to identify it to the other functions. The value of the new entry
+ * is zero and unknown, and its original value handling is kCC3GLESStateOriginalValueIgnore.
+ */
+GLuint CC3GLESStateCacheAddEntry(CC3GLESStateCache* sc, CC3GLESStateKind kind, GLuint width);
+
+/**
+ * Sets the GL name, read mode, and original value handling of the specified entry.
+ *
+ * If the read mode is not kCC3GLESStateReadByOwner, the entry will be read or reset by the next
+ * invocation of the CC3GLESStateCacheOpen function, and, if the original value handling is
+ * kCC3GLESStateOriginalValueReadAlways or kCC3GLESStateOriginalValueReadAlwaysAndRestore,
+ * by every invocation after that.
+ */
+void CC3GLESStateCacheConfigureEntry(CC3GLESStateCache* sc, GLuint entry, GLenum name,
+									 CC3GLESStateReadMode readMode,
+									 CC3GLESStateOriginalValueHandling origValueHandling);
+
+/**
+ * Opens the specified entry, reading its original value from the GL engine, or resetting
+ * its current value, as determined by its original value handling. The entry must not use
+ * kCC3GLESStateReadByOwner, unless its original value handling does not need a GL read.
+ */
+void CC3GLESStateCacheOpenEntry(CC3GLESStateCache* sc, GLuint entry);
+
+/**
+ * Opens all of the entries that are due to be opened, in a single pass over the cache,
+ * reading their original values from the GL engine where required.
+ *
+ * Entries that use kCC3GLESStateReadByOwner are not opened by this function.
+ */
+void CC3GLESStateCacheOpen(CC3GLESStateCache* sc);
+
+/** Sets the current value of the specified entry to its original value. */
+void CC3GLESStateCacheRestoreOriginal(CC3GLESStateCache* sc, GLuint entry);
+
+/** Returns whether the specified bit is set in the specified bitfield. */
+static inline GLboolean CC3GLESStateBitIsSet(const GLuint* bits, GLuint index) {
+	return (bits[index >> 5] >> (index & 31)) & 1;
+}
+
+/** Sets the specified bit in the specified bitfield to the specified value. */
+static inline void CC3GLESStateBitSet(GLuint* bits, GLuint index, GLboolean isSet) {
+	GLuint mask = 1u << (index & 31);
+	if (isSet) {
+		bits[index >> 5] |= mask;
+	} else {
+		bits[index >> 5] &= ~mask;
+	}
+}
+
+/** Returns whether the value of the specified entry in the GL engine is known. */
+static inline GLboolean CC3GLESStateCacheIsKnown(const CC3GLESStateCache* sc, GLuint entry) {
+	return CC3GLESStateBitIsSet(sc->knownBits, entry);
+}
+
+/** Sets whether the value of the specified entry in the GL engine is known. */
+static inline void CC3GLESStateCacheSetKnown(CC3GLESStateCache* sc, GLuint entry, GLboolean isKnown) {
+	CC3GLESStateBitSet(sc->knownBits, entry, isKnown);
+}
+
+/** Sets whether the specified entry should always be set in the GL engine, and marks its value unknown. */
+static inline void CC3GLESStateCacheSetAlwaysSet(CC3GLESStateCache* sc, GLuint entry, GLboolean alwaysSet) {
+	CC3GLESStateBitSet(sc->alwaysSetBits, entry, alwaysSet);
+	CC3GLESStateBitSet(sc->knownBits, entry, GL_FALSE);
+}
+
+/** Returns whether the specified entry has been set in the GL engine since it was last closed. */
+static inline GLboolean CC3GLESStateCacheIsDirty(const CC3GLESStateCache* sc, GLuint entry) {
+	return CC3GLESStateBitIsSet(sc->dirtyBits, entry);
+}
+
+/**
+ * Marks the specified entry as having been set in the GL engine,
+ * and returns whether it was not already marked as such.
+ */
+static inline GLboolean CC3GLESStateCacheMarkDirty(CC3GLESStateCache* sc, GLuint entry) {
+	GLuint mask = 1u << (entry & 31);
+	GLuint* word = &sc->dirtyBits[entry >> 5];
+	if (*word & mask) return GL_FALSE;
+	*word |= mask;
+	return GL_TRUE;
+}
+
+/** Marks the specified entry as not having been set in the GL engine since it was last closed. */
+static inline void CC3GLESStateCacheClearDirty(CC3GLESStateCache* sc, GLuint entry) {
+	CC3GLESStateBitSet(sc->dirtyBits, entry, GL_FALSE);
+}
+
+/** Returns whether the GL engine must be set for the specified entry, regardless of its new value. */
+static inline GLboolean CC3GLESStateCacheMustSet(const CC3GLESStateCache* sc, GLuint entry) {
+	GLuint word = entry >> 5;
+	GLuint mask = 1u << (entry & 31);
+	return (sc->alwaysSetBits[word] & mask) || !(sc->knownBits[word] & mask);
+}
+
+/** Returns the current value of the specified boolean entry. */
+static inline GLboolean CC3GLESStateCacheBoolean(const CC3GLESStateCache* sc, GLuint entry) {
+	return CC3GLESStateBitIsSet(sc->booleanValues, entry);
+}
+
+/** Sets the current value of the specified boolean entry, without affecting whether it is known. */
+static inline void CC3GLESStateCacheSetBoolean(CC3GLESStateCache* sc, GLuint entry, GLboolean value) {
+	CC3GLESStateBitSet(sc->booleanValues, entry, value);
+}
+
+/** Returns the original value of the specified boolean entry. */
+static inline GLboolean CC3GLESStateCacheOriginalBoolean(const CC3GLESStateCache* sc, GLuint entry) {
+	return CC3GLESStateBitIsSet(sc->booleanOriginals, entry);
+}
+
+/** Sets the original value of the specified boolean entry. */
+static inline void CC3GLESStateCacheSetOriginalBoolean(CC3GLESStateCache* sc, GLuint entry, GLboolean value) {
+	CC3GLESStateBitSet(sc->booleanOriginals, entry, value);
+}
+
+/**
+ * Compares the specified value to the current value of the specified boolean entry, and if they
+ * differ, or if the GL engine must be set regardless, sets the current value and returns GL_TRUE,
+ * indicating that the caller must set the value in the GL engine. Otherwise returns GL_FALSE.
+ */
+static inline GLboolean CC3GLESStateCacheUpdateBoolean(CC3GLESStateCache* sc, GLuint entry, GLboolean value) {
+	if (CC3GLESStateCacheMustSet(sc, entry) || (CC3GLESStateCacheBoolean(sc, entry) != (value != GL_FALSE))) {
+		CC3GLESStateBitSet(sc->booleanValues, entry, value);
+		return GL_TRUE;
+	}
+	return GL_FALSE;
+}
+
+/** Returns a pointer to the current value of the specified float entry. */
+static inline GLfloat* CC3GLESStateCacheFloats(const CC3GLESStateCache* sc, GLuint entry) {
+	return sc->floatValues + sc->entries[entry].offset;
+}
+
+/** Returns a pointer to the original value of the specified float entry. */
+static inline GLfloat* CC3GLESStateCacheOriginalFloats(const CC3GLESStateCache* sc, GLuint entry) {
+	return sc->floatOriginals + sc->entries[entry].offset;
+}
+
+/**
+ * Compares the specified values to the current value of the specified float entry, and if they
+ * differ, or if the GL engine must be set regardless, sets the current value and returns GL_TRUE,
+ * indicating that the caller must set the value in the GL engine. Otherwise returns GL_FALSE.
+ *
+ * The values are compared element by element, in the same manner as the == operator.
+ */
+static inline GLboolean CC3GLESStateCacheUpdateFloats(CC3GLESStateCache* sc, GLuint entry, const GLfloat* values) {
+	GLfloat* current = CC3GLESStateCacheFloats(sc, entry);
+	GLuint width = sc->entries[entry].width;
+	GLboolean mustSet = CC3GLESStateCacheMustSet(sc, entry);
+	for (GLuint i = 0; i < width && !mustSet; i++) {
+		mustSet = (values[i] != current[i]);
+	}
+	if (mustSet) memcpy(current, values, width * sizeof(GLfloat));
+	return mustSet;
+}
+
+/** Returns a pointer to the current value of the specified integer entry. */
+static inline GLint* CC3GLESStateCacheInts(const CC3GLESStateCache* sc, GLuint entry) {
+	return sc->intValues + sc->entries[entry].offset;
+}
+
+/** Returns a pointer to the original value of the specified integer entry. */
+static inline GLint* CC3GLESStateCacheOriginalInts(const CC3GLESStateCache* sc, GLuint entry) {
+	return sc->intOriginals + sc->entries[entry].offset;
+}
+
+/**
+ * Compares the specified values to the current value of the specified integer entry, and if they
+ * differ, or if the GL engine must be set regardless, sets the current value and returns GL_TRUE,
+ * indicating that the caller must set the value in the GL engine. Otherwise returns GL_FALSE.
+ */
+static inline GLboolean CC3GLESStateCacheUpdateInts(CC3GLESStateCache* sc, GLuint entry, const GLint* values) {
+	GLint* current = CC3GLESStateCacheInts(sc, entry);
+	GLuint width = sc->entries[entry].width;
+	GLboolean mustSet = CC3GLESStateCacheMustSet(sc, entry);
+	for (GLuint i = 0; i < width && !mustSet; i++) {
+		mustSet = (values[i] != current[i]);
+	}
+	if (mustSet) memcpy(current, values, width * sizeof(GLint));
+	return mustSet;
+}
+
+/** Returns a pointer to the current value of the specified pointer entry. */
+static inline const GLvoid** CC3GLESStateCachePointer(const CC3GLESStateCache* sc, GLuint entry) {
+	return sc->pointerValues + sc->entries[entry].offset;
+}
+
+/** Returns a pointer to the original value of the specified pointer entry. */
+static inline const GLvoid** CC3GLESStateCacheOriginalPointer(const CC3GLESStateCache* sc, GLuint entry) {
+	return sc->pointerOriginals + sc->entries[entry].offset;
+}
+
+/**
+ * Compares the specified value to the current value of the specified pointer entry, and if they
+ * differ, or if the GL engine must be set regardless, sets the current value and returns GL_TRUE,
+ * indicating that the caller must set the value in the GL engine. Otherwise returns GL_FALSE.
+ */
+static inline GLboolean CC3GLESStateCacheUpdatePointer(CC3GLESStateCache* sc, GLuint entry, const GLvoid* value) {
+	const GLvoid** current = CC3GLESStateCachePointer(sc, entry);
+	if (CC3GLESStateCacheMustSet(sc, entry) || *current != value) {
+		*current = value;
+		return GL_TRUE;
+	}
+	return GL_FALSE;
+}
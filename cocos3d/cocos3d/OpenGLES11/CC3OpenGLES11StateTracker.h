@@ -33,86 +33,10 @@
 #import "ccTypes.h"
 #import "CC3Foundation.h"
 #import "CC3OpenGLES11Foundation.h"
+#import "CC3OpenGLES11StateCache.h"
 
 @class CC3OpenGLES11Engine;
 
-/**
- * An enumeration of the techniques for handling the existing value of a GL state
- * at the time the CC3OpenGLES11Engine singleton instance open method is invoked,
- * combined with techniques for how to leave that GL state when the singleton
- * close method is invoked, prior to the resumption of normal cocos2d 2D drawing.
- * The following types of original value handling are available:
- *
- *   - kCC3GLESStateOriginalValueIgnore: The original value of the GL state when the 
- *     CC3OpenGLES11Engine open method is invoked is ignored. The first subsequent
- *     state change will always set the GL state. The GL state is left as-is when the
- *     CC3OpenGLES11Engine close method is invoked.
- *
- *   - kCC3GLESStateOriginalValueReadOnce: The original GL state value is read once,
- *     on the fist invocation of the CC3OpenGLES11Engine open method, and is remembered.
- *     The value is assumed to always have this value at the time of any subsequent
- *     invocations of the CC3OpenGLES11Engine open method. The first subsequent attempt
- *     to change this GL state value will only be forwarded to the GL function if it is
- *     different than this value. The GL state is left as-is when the CC3OpenGLES11Engine
- *     close method is invoked.
- *
- *   - kCC3GLESStateOriginalValueReadAlways: The original GL state value is read on
- *     every invocation of the CC3OpenGLES11Engine open method. The first subsequent
- *     attempt to change this GL state value will only be forwarded to the GL function
- *     if it is different than this value. The GL state is left as-is when the
- *     CC3OpenGLES11Engine close method is invoked.
- *
- *   - kCC3GLESStateOriginalValueReadOnceAndRestore: The original GL state value is read
- *     as described for kCC3GLESStateOriginalValueReadOnce. On every invocation of the
- *     CC3OpenGLES11Engine close method, the GL state is ensured to be set back to this
- *     value before 2D drawing resumes.
- *
- *   - kCC3GLESStateOriginalValueReadAlwaysAndRestore: The original GL state value is read
- *     as described for kCC3GLESStateOriginalValueReadAlways. On every invocation of the
- *     CC3OpenGLES11Engine close method, the GL state is ensured to be set back to this value
- *     before 2D drawing resumes.
- *
- *   - kCC3GLESStateOriginalValueRestore: The original GL state value is set manually
- *     during initialization. On every invocation of the CC3OpenGLES11Engine close method,
- *     the GL state is ensured to be set back to this value before 2D drawing resumes.
- *
- * For maximum throughput in the GL engine, reading of GL state from the GL engine should
- * be minimized. Therefore, the enumerations kCC3GLESStateOriginalValueReadAlways and
- * kCC3GLESStateOriginalValueReadAlwaysAndRestore should be avoided whenever possible and
- * only used as a last resort.
- * 
- * The enumeration kCC3GLESStateOriginalValueIgnore is best for GL state that has an
- * unpredictable value when the CC3OpenGLES11Engine method is invoked, and where cocos2d
- * does not expect the state to be in any particular value when 2D drawing resumes after
- * 3D drawing is complete.
- * 
- * The enumeration kCC3GLESStateOriginalValueReadOnceAndRestore is best for GL state that
- * must be left with a predictable value when the CC3OpenGLES11Engine close method is 
- * invoked. This is typical for state that cocos2d expects to have a particular value 
- * when 2D drawing resumes after 3D drawing is complete.
- * 
- * The enumeration kCC3GLESStateOriginalValueReadAlwaysAndRestore should only be used
- * for GL state that is unpredictable when 3D drawing begins, but must be left in that
- * same state when 2D drawing ends. This is rare, and should only be used as a last resort.
- * 
- * The enumeration kCC3GLESStateOriginalValueRestore should only be used when it is not
- * possible to read the GL value from the GL engine. This is the case for a few OES state values.
- * 
- * The enumerations kCC3GLESStateOriginalValueReadOnce and kCC3GLESStateOriginalValueReadAlways
- * have limited value, since they perform a GL read, but do not restore that value once 3D
- * drawing is complete. It is generally better to simply use the enumeration
- * kCC3GLESStateOriginalValueIgnore instead. However, kCC3GLESStateOriginalValueReadOnce can
- * be useful for reading platform characteristics and limits.
- */
-typedef enum {
-	kCC3GLESStateOriginalValueIgnore = 1,
-	kCC3GLESStateOriginalValueReadOnce,
-	kCC3GLESStateOriginalValueReadAlways,
-	kCC3GLESStateOriginalValueReadOnceAndRestore,
-	kCC3GLESStateOriginalValueReadAlwaysAndRestore,
-	kCC3GLESStateOriginalValueRestore
-} CC3GLESStateOriginalValueHandling;
-
 
 #pragma mark -
 #pragma mark CC3OpenGLES11StateTracker
@@ -186,18 +110,60 @@ typedef enum {
 /**
  * A type of CC3OpenGLES11StateTracker that tracks the state of a single primitive GL state value.
  *
+ * The value itself is not held by the tracker, but in an entry in the CC3GLESStateCache of the
+ * CC3OpenGLES11Engine, where it can be compared and set, and read from the GL engine when the
+ * engine is opened, without messaging the tracker. The tracker properties act as a facade
+ * over that entry.
+ *
  * This is an abstract class. Subclasses will define tracking each type of primitive GL state data.
  */
 @interface CC3OpenGLES11StateTrackerPrimitive : CC3OpenGLES11StateTracker {
+	CC3GLESStateCache* stateCache;
+	GLuint stateEntry;
 	GLenum name;
 	GLubyte originalValueHandling;
-	BOOL valueIsKnown;
 	BOOL shouldAlwaysSetGL;
 }
 
 /** The enumerated name under which the GL engine identifies this state. */
 @property(nonatomic, assign) GLenum name;
 
+/**
+ * The cache holding the value of this tracker. This is the stateCache of the CC3OpenGLES11Engine.
+ *
+ * Performance-sensitive code can use the inline CC3GLESStateCache functions with this cache and
+ * the stateEntry property to access the value directly.
+ */
+@property(nonatomic, readonly) CC3GLESStateCache* stateCache;
+
+/** The index of the entry holding the value of this tracker in the stateCache. */
+@property(nonatomic, readonly) GLuint stateEntry;
+
+/**
+ * The kind of value held in the entry in the state cache for trackers of this class.
+ *
+ * This abstract implementation returns kCC3GLESStateKindInteger.
+ * Subclasses will override to return the kind of their value.
+ */
++(CC3GLESStateKind) stateKind;
+
+/**
+ * The number of elements in the value held in the entry in the state cache for trackers of this class.
+ *
+ * This implementation returns one. Subclasses with values containing more than one element will override.
+ */
++(GLuint) stateWidth;
+
+/**
+ * Returns how the stateCache can read the original value of this tracker from the GL engine, without
+ * messaging this tracker.
+ *
+ * This abstract implementation returns kCC3GLESStateReadByOwner, indicating that this tracker reads its
+ * own value, using the getGLValue method. Subclasses that use a standard glGet* function will return
+ * the corresponding read mode, unless the getGLValue method has been overridden by a further subclass.
+ */
+@property(nonatomic, readonly) CC3GLESStateReadMode stateReadMode;
+
 /**
  * The type of handling to apply to the value of the GL state at the time the open
  * and close method are invoked.
@@ -322,7 +288,7 @@ typedef enum {
  * Template method to get the value from the GL engine and store it as the original value.
  *
  * This abstract implementation does nothing. Subclasses will override to get the value
- * and store it in an original value instance variable of the appropriate type.
+ * and store it as the original value, using the appropriate variable type.
  *
  * The application should not invoke this method directly.
  */
@@ -359,8 +325,6 @@ typedef void( CC3SetGLBooleanFunction( GLboolean ) );
 
 /** A CC3OpenGLES11StateTrackerPrimitive that tracks a boolean GL state value. */
 @interface CC3OpenGLES11StateTrackerBoolean : CC3OpenGLES11StateTrackerPrimitive {
-	BOOL value;
-	BOOL originalValue;
 	CC3SetGLBooleanFunction* setGLFunction;
 }
 
@@ -441,8 +405,6 @@ typedef void( CC3SetGLFloatFunction( GLfloat ) );
 
 /** A CC3OpenGLES11StateTrackerPrimitive that tracks a float GL state value. */
 @interface CC3OpenGLES11StateTrackerFloat : CC3OpenGLES11StateTrackerPrimitive {
-	GLfloat value;
-	GLfloat originalValue;
 	CC3SetGLFloatFunction* setGLFunction;
 }
 
@@ -501,8 +463,6 @@ typedef void( CC3SetGLIntegerFunction( GLint ) );
 
 /** A CC3OpenGLES11StateTrackerPrimitive that tracks an integer GL state value. */
 @interface CC3OpenGLES11StateTrackerInteger : CC3OpenGLES11StateTrackerPrimitive {
-	GLint value;
-	GLint originalValue;
 	CC3SetGLIntegerFunction* setGLFunction;
 }
 
@@ -560,8 +520,6 @@ typedef void( CC3SetGLEnumerationFunction( GLenum ) );
 
 /** A CC3OpenGLES11StateTrackerPrimitive that tracks an enumerated GL state value. */
 @interface CC3OpenGLES11StateTrackerEnumeration : CC3OpenGLES11StateTrackerPrimitive {
-	GLenum value;
-	GLenum originalValue;
 	CC3SetGLEnumerationFunction* setGLFunction;
 }
 
@@ -620,8 +578,6 @@ typedef void( CC3SetGLColorFunction( GLfloat, GLfloat, GLfloat, GLfloat ) );
 
 /** A CC3OpenGLES11StateTrackerPrimitive that tracks a color GL state value. */
 @interface CC3OpenGLES11StateTrackerColor : CC3OpenGLES11StateTrackerPrimitive {
-	ccColor4F value;
-	ccColor4F originalValue;
 	CC3SetGLColorFunction* setGLFunction;
 }
 
@@ -757,8 +713,6 @@ typedef void( CC3SetGLViewportFunction( GLint, GLint, GLsizei, GLsizei ) );
  * open method, and to be automatically restored on each invocation of the close method.
  */
 @interface CC3OpenGLES11StateTrackerViewport : CC3OpenGLES11StateTrackerPrimitive {
-	CC3Viewport value;
-	CC3Viewport originalValue;
 	CC3SetGLViewportFunction* setGLFunction;
 }
 
@@ -813,10 +767,7 @@ typedef void( CC3SetGLViewportFunction( GLint, GLint, GLsizei, GLsizei ) );
 #pragma mark CC3OpenGLES11StateTrackerPointer
 
 /** A CC3OpenGLES11StateTrackerPrimitive that tracks a pointer GL state value. */
-@interface CC3OpenGLES11StateTrackerPointer : CC3OpenGLES11StateTrackerPrimitive {
-	GLvoid* value;
-	GLvoid* originalValue;
-}
+@interface CC3OpenGLES11StateTrackerPointer : CC3OpenGLES11StateTrackerPrimitive {}
 
 /** The current value of the GL state. */
 @property(nonatomic, assign) GLvoid* value;
@@ -831,10 +782,7 @@ typedef void( CC3SetGLViewportFunction( GLint, GLint, GLsizei, GLsizei ) );
 #pragma mark CC3OpenGLES11StateTrackerVector
 
 /** A CC3OpenGLES11StateTrackerPrimitive that tracks a 3D vector GL state value. */
-@interface CC3OpenGLES11StateTrackerVector : CC3OpenGLES11StateTrackerPrimitive {
-	CC3Vector value;
-	CC3Vector originalValue;
-}
+@interface CC3OpenGLES11StateTrackerVector : CC3OpenGLES11StateTrackerPrimitive {}
 
 /** The current value of the GL state. */
 @property(nonatomic, assign) CC3Vector value;
@@ -849,10 +797,7 @@ typedef void( CC3SetGLViewportFunction( GLint, GLint, GLsizei, GLsizei ) );
 #pragma mark CC3OpenGLES11StateTrackerVector4
 
 /** A CC3OpenGLES11StateTrackerPrimitive that tracks a 4D vector GL state value. */
-@interface CC3OpenGLES11StateTrackerVector4 : CC3OpenGLES11StateTrackerPrimitive {
-	CC3Vector4 value;
-	CC3Vector4 originalValue;
-}
+@interface CC3OpenGLES11StateTrackerVector4 : CC3OpenGLES11StateTrackerPrimitive {}
 
 /** The current value of the GL state. */
 @property(nonatomic, assign) CC3Vector4 value;
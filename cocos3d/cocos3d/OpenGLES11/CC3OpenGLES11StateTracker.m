@@ -93,19 +93,41 @@
 #pragma mark CC3OpenGLES11StateTrackerPrimitive
 
 @interface CC3OpenGLES11StateTrackerPrimitive (TemplateMethods)
+-(void) configureStateEntry;
 -(void) logGetGLValue;
 -(void) logSetValue;
 -(void) logReuseValue;
 @end
 
+/**
+ * Returns the specified read mode if the getGLValue method used by the specified tracker is the
+ * one defined by the specified class. Otherwise, a subclass reads the GL value in its own way,
+ * and kCC3GLESStateReadByOwner is returned.
+ */
+static CC3GLESStateReadMode CC3GLESStateReadModeFor(CC3OpenGLES11StateTrackerPrimitive* tracker,
+													Class readingClass,
+													CC3GLESStateReadMode readMode) {
+	SEL getSel = @selector(getGLValue);
+	BOOL isStandardRead = ([tracker methodForSelector: getSel] == [readingClass instanceMethodForSelector: getSel]);
+	return isStandardRead ? readMode : kCC3GLESStateReadByOwner;
+}
+
 @implementation CC3OpenGLES11StateTrackerPrimitive
 
-@synthesize name, valueIsKnown, shouldAlwaysSetGL;
+@synthesize stateCache, stateEntry, shouldAlwaysSetGL;
+
+-(GLenum) name { return name; }
+
+-(void) setName: (GLenum) aName {
+	name = aName;
+	[self configureStateEntry];
+}
 
 -(CC3GLESStateOriginalValueHandling) originalValueHandling { return originalValueHandling; }
 
 -(void) setOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling {
 	originalValueHandling = origValueHandling;
+	[self configureStateEntry];
 	self.valueIsKnown = NO;
 } 
 
@@ -113,13 +135,30 @@
 	return kCC3GLESStateOriginalValueIgnore;
 }
 
+-(BOOL) valueIsKnown { return CC3GLESStateCacheIsKnown(stateCache, stateEntry); }
+
+-(void) setValueIsKnown: (BOOL) aBoolean {
+	CC3GLESStateCacheSetKnown(stateCache, stateEntry, aBoolean);
+}
+
 -(void) setShouldAlwaysSetGL: (BOOL) aBoolean {
 	shouldAlwaysSetGL = aBoolean;
-	self.valueIsKnown = NO;
+	CC3GLESStateCacheSetAlwaysSet(stateCache, stateEntry, aBoolean);
 }
 
 +(BOOL) defaultShouldAlwaysSetGL { return NO; }
 
++(CC3GLESStateKind) stateKind { return kCC3GLESStateKindInteger; }
+
++(GLuint) stateWidth { return 1; }
+
+-(CC3GLESStateReadMode) stateReadMode { return kCC3GLESStateReadByOwner; }
+
+/** Updates the entry in the state cache with the name and original value handling of this tracker. */
+-(void) configureStateEntry {
+	CC3GLESStateCacheConfigureEntry(stateCache, stateEntry, name, self.stateReadMode, originalValueHandling);
+}
+
 -(BOOL) shouldAlwaysReadOriginal {
 	return name && (originalValueHandling == kCC3GLESStateOriginalValueReadAlways ||
 					originalValueHandling == kCC3GLESStateOriginalValueReadAlwaysAndRestore);
@@ -155,6 +194,9 @@
 			forState: (GLenum) aName
 andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling {
 	if ( (self = [super initWithParent: aTracker]) ) {
+		CC3OpenGLES11Engine* glesEngine = self.engine;
+		stateCache = (glesEngine ? glesEngine : [CC3OpenGLES11Engine engine]).stateCache;
+		stateEntry = CC3GLESStateCacheAddEntry(stateCache, [[self class] stateKind], [[self class] stateWidth]);
 		self.name = aName;
 		self.originalValueHandling = origValueHandling;
 		self.shouldAlwaysSetGL = [[self class] defaultShouldAlwaysSetGL];
@@ -171,29 +213,52 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 				andOriginalValueHandling: origValueHandling] autorelease];
 }
 
+/**
+ * Trackers whose values can be read by the state cache are opened by the
+ * CC3OpenGLES11Engine in one pass over the cache, and are not opened individually.
+ */
+-(void) notifyTrackerAdded {
+	if (stateCache->entries[stateEntry].readMode == kCC3GLESStateReadByOwner) {
+		[super notifyTrackerAdded];
+	}
+}
+
+/** Uses the dirty bit of the state cache entry to ensure this tracker is scheduled for closing only once. */
+-(void) notifyGLChanged {
+	if (CC3GLESStateCacheMarkDirty(stateCache, stateEntry)) {
+		[self.engine addTrackerToClose: self];
+	}
+}
+
 -(void) open {
+	// If the state cache can read the value, let it do all the work
+	if (stateCache->entries[stateEntry].readMode != kCC3GLESStateReadByOwner) {
+		CC3GLESStateCacheOpenEntry(stateCache, stateEntry);
+		return;
+	}
+
 	switch (originalValueHandling) {
 		case kCC3GLESStateOriginalValueIgnore:
-			valueIsKnown = NO;
+			self.valueIsKnown = NO;
 			break;
 		case kCC3GLESStateOriginalValueReadOnce:
 		case kCC3GLESStateOriginalValueReadOnceAndRestore:
-			if (valueIsKnown) break;
+			if (self.valueIsKnown) break;
 		case kCC3GLESStateOriginalValueReadAlways:
 		case kCC3GLESStateOriginalValueReadAlwaysAndRestore:
 			if (name) {
 				[self getGLValue];
 				[self logGetGLValue];
 				[self restoreOriginalValue];
-				valueIsKnown = YES;
+				self.valueIsKnown = YES;
 				LogGLErrorState(@"opening %@", self);
 			} else {
-				valueIsKnown = NO;
+				self.valueIsKnown = NO;
 			}
 			break;
 		case kCC3GLESStateOriginalValueRestore:
 			[self restoreOriginalValue];
-			valueIsKnown = YES;
+			self.valueIsKnown = YES;
 			break;
 		default:
 			NSAssert3(NO, @"%@ bad original value handling definition %u for capability %@",
@@ -204,19 +269,22 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 
 -(void) close {
 	[super close];
+	CC3GLESStateCacheClearDirty(stateCache, stateEntry);
 	if (self.shouldRestoreOriginalOnClose) {
 		[self restoreOriginalValue];
 		[self setGLValue];
 	}
-	valueIsKnown = self.valueIsKnownOnClose;
+	self.valueIsKnown = self.valueIsKnownOnClose;
 }
 
--(void) restoreOriginalValue {}
+-(void) restoreOriginalValue {
+	CC3GLESStateCacheRestoreOriginal(stateCache, stateEntry);
+}
 
 -(void) setGLValueAndNotify {
 	[self setGLValue];
 	[self notifyGLChanged];
-	valueIsKnown = YES;
+	CC3GLESStateCacheSetKnown(stateCache, stateEntry, YES);
 	[self logSetValue];
 }
 
@@ -244,7 +312,13 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 
 @implementation CC3OpenGLES11StateTrackerBoolean
 
-@synthesize value, originalValue, setGLFunction;
+@synthesize setGLFunction;
+
++(CC3GLESStateKind) stateKind { return kCC3GLESStateKindBoolean; }
+
+-(CC3GLESStateReadMode) stateReadMode {
+	return CC3GLESStateReadModeFor(self, [CC3OpenGLES11StateTrackerBoolean class], kCC3GLESStateReadBoolean);
+}
 
 -(id) initWithParent: (CC3OpenGLES11StateTracker*) aTracker
 			forState: (GLenum) aName
@@ -294,47 +368,50 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 				 andOriginalValueHandling: origValueHandling] autorelease];
 }
 
+-(BOOL) value { return CC3GLESStateCacheBoolean(stateCache, stateEntry); }
+
 -(void) setValue: (BOOL) aValue {
-	if (shouldAlwaysSetGL || !valueIsKnown || aValue != value) {
-		value = aValue;
+	if (CC3GLESStateCacheUpdateBoolean(stateCache, stateEntry, aValue)) {
 		[self setGLValueAndNotify];
 	} else {
 		[self logReuseValue];
-	}	
+	}
 }
 
 -(void) setValueRaw: (BOOL) aValue {
-	value = aValue;
+	CC3GLESStateCacheSetBoolean(stateCache, stateEntry, aValue);
+}
+
+-(BOOL) originalValue { return CC3GLESStateCacheOriginalBoolean(stateCache, stateEntry); }
+
+-(void) setOriginalValue: (BOOL) aValue {
+	CC3GLESStateCacheSetOriginalBoolean(stateCache, stateEntry, aValue);
 }
 
 -(void) setGLValue {
 	if( setGLFunction ) {
-		setGLFunction(value ? GL_TRUE : GL_FALSE);
+		setGLFunction(self.value ? GL_TRUE : GL_FALSE);
 	}
 }
 
 -(void) getGLValue {
 	GLboolean glValue;
 	glGetBooleanv(name, &glValue);
-	originalValue = (glValue != GL_FALSE);
+	self.originalValue = (glValue != GL_FALSE);
 }
 
 -(void) logSetValue {
-	LogTrace(@"%@ set %@ = %@", [self class], NSStringFromGLEnum(name), (value ? @"YES" : @"NO"));
+	LogTrace(@"%@ set %@ = %@", [self class], NSStringFromGLEnum(name), (self.value ? @"YES" : @"NO"));
 }
 
 -(void) logReuseValue: (BOOL) wasSet {
-	LogTrace(@"%@ reused %@ = %@", [self class], NSStringFromGLEnum(name), (value ? @"YES" : @"NO"));
+	LogTrace(@"%@ reused %@ = %@", [self class], NSStringFromGLEnum(name), (self.value ? @"YES" : @"NO"));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %@ (was tracking %@)", 
-			 [self class], NSStringFromGLEnum(name), (originalValue ? @"YES" : @"NO"),
-			 (valueIsKnown ? (value ? @"YES" : @"NO") : @"UNKNOWN"));
-}
-
--(void) restoreOriginalValue {
-	value = originalValue;
+			 [self class], NSStringFromGLEnum(name), (self.originalValue ? @"YES" : @"NO"),
+			 (self.valueIsKnown ? (self.value ? @"YES" : @"NO") : @"UNKNOWN"));
 }
 
 -(NSString*) description {
@@ -364,18 +441,18 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %@ (was tracking %@)", 
-			 [self class], NSStringFromGLEnum(name), (originalValue ? @"ENABLED" : @"DISABLED"),
-			 (valueIsKnown ? (value ? @"ENABLED" : @"DISABLED") : @"UNKNOWN"));
+			 [self class], NSStringFromGLEnum(name), (self.originalValue ? @"ENABLED" : @"DISABLED"),
+			 (self.valueIsKnown ? (self.value ? @"ENABLED" : @"DISABLED") : @"UNKNOWN"));
 }
 
 -(void) logSetValue {
 	LogTrace(@"%@ set %@ = %@", [self class],
-			 NSStringFromGLEnum(name), (value ? @"ENABLED" : @"DISABLED"));
+			 NSStringFromGLEnum(name), (self.value ? @"ENABLED" : @"DISABLED"));
 }
 
 -(void) logReuseValue {
 	LogTrace(@"%@ reuse %@ = %@", [self class],
-			 NSStringFromGLEnum(name), (value ? @"ENABLED" : @"DISABLED"));
+			 NSStringFromGLEnum(name), (self.value ? @"ENABLED" : @"DISABLED"));
 }
 
 @end
@@ -386,7 +463,13 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 
 @implementation CC3OpenGLES11StateTrackerFloat
 
-@synthesize value, originalValue, setGLFunction;
+@synthesize setGLFunction;
+
++(CC3GLESStateKind) stateKind { return kCC3GLESStateKindFloat; }
+
+-(CC3GLESStateReadMode) stateReadMode {
+	return CC3GLESStateReadModeFor(self, [CC3OpenGLES11StateTrackerFloat class], kCC3GLESStateReadFloat);
+}
 
 -(id) initWithParent: (CC3OpenGLES11StateTracker*) aTracker
 			forState: (GLenum) aName
@@ -438,45 +521,48 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 				andOriginalValueHandling: origValueHandling] autorelease];
 }
 
+-(GLfloat) value { return *CC3GLESStateCacheFloats(stateCache, stateEntry); }
+
 -(void) setValue: (GLfloat) aValue {
-	if (shouldAlwaysSetGL || !valueIsKnown || aValue != value) {
-		value = aValue;
+	if (CC3GLESStateCacheUpdateFloats(stateCache, stateEntry, &aValue)) {
 		[self setGLValueAndNotify];
 	} else {
 		[self logReuseValue];
-	}	
+	}
 }
 
 -(void) setValueRaw: (GLfloat) aValue {
-	value = aValue;
+	*CC3GLESStateCacheFloats(stateCache, stateEntry) = aValue;
+}
+
+-(GLfloat) originalValue { return *CC3GLESStateCacheOriginalFloats(stateCache, stateEntry); }
+
+-(void) setOriginalValue: (GLfloat) aValue {
+	*CC3GLESStateCacheOriginalFloats(stateCache, stateEntry) = aValue;
 }
 
 -(void) setGLValue {
 	if( setGLFunction ) {
-		setGLFunction(value);
+		setGLFunction(self.value);
 	}
 }
 
 -(void) getGLValue {
-	glGetFloatv(name, &originalValue);
+	glGetFloatv(name, CC3GLESStateCacheOriginalFloats(stateCache, stateEntry));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %.2f (was tracking %@)",
-			 [self class], NSStringFromGLEnum(name), originalValue,
-			 (valueIsKnown ? [NSString stringWithFormat: @"%.2f", value] : @"UNKNOWN"));
+			 [self class], NSStringFromGLEnum(name), self.originalValue,
+			 (self.valueIsKnown ? [NSString stringWithFormat: @"%.2f", self.value] : @"UNKNOWN"));
 }
 
 -(void) logSetValue {
-	LogTrace(@"%@ set %@ = %.2f", [self class], NSStringFromGLEnum(name), value);
+	LogTrace(@"%@ set %@ = %.2f", [self class], NSStringFromGLEnum(name), self.value);
 }
 
 -(void) logReuseValue {
-	LogTrace(@"%@ reuse %@ = %.2f", [self class], NSStringFromGLEnum(name), value);
-}
-
--(void) restoreOriginalValue {
-	value = originalValue;
+	LogTrace(@"%@ reuse %@ = %.2f", [self class], NSStringFromGLEnum(name), self.value);
 }
 
 -(NSString*) description {
@@ -492,7 +578,13 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 
 @implementation CC3OpenGLES11StateTrackerInteger
 
-@synthesize value, originalValue, setGLFunction;
+@synthesize setGLFunction;
+
++(CC3GLESStateKind) stateKind { return kCC3GLESStateKindInteger; }
+
+-(CC3GLESStateReadMode) stateReadMode {
+	return CC3GLESStateReadModeFor(self, [CC3OpenGLES11StateTrackerInteger class], kCC3GLESStateReadInteger);
+}
 
 -(id) initWithParent: (CC3OpenGLES11StateTracker*) aTracker
 			forState: (GLenum) aName
@@ -544,45 +636,48 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 				andOriginalValueHandling: origValueHandling] autorelease];
 }
 
+-(GLint) value { return *CC3GLESStateCacheInts(stateCache, stateEntry); }
+
 -(void) setValue: (GLint) aValue {
-	if (shouldAlwaysSetGL || !valueIsKnown || aValue != value) {
-		value = aValue;
+	if (CC3GLESStateCacheUpdateInts(stateCache, stateEntry, &aValue)) {
 		[self setGLValueAndNotify];
 	} else {
 		[self logReuseValue];
-	}	
+	}
 }
 
 -(void) setValueRaw: (GLint) aValue {
-	value = aValue;
+	*CC3GLESStateCacheInts(stateCache, stateEntry) = aValue;
+}
+
+-(GLint) originalValue { return *CC3GLESStateCacheOriginalInts(stateCache, stateEntry); }
+
+-(void) setOriginalValue: (GLint) aValue {
+	*CC3GLESStateCacheOriginalInts(stateCache, stateEntry) = aValue;
 }
 
 -(void) setGLValue {
 	if( setGLFunction ) {
-		setGLFunction(value);
+		setGLFunction(self.value);
 	}
 }
 
 -(void) getGLValue {
-	glGetIntegerv(name, &originalValue);
+	glGetIntegerv(name, CC3GLESStateCacheOriginalInts(stateCache, stateEntry));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %i (was tracking %@)",
-			 [self class], NSStringFromGLEnum(name), originalValue,
-			 (valueIsKnown ? [NSString stringWithFormat: @"%i", value] : @"UNKNOWN"));
+			 [self class], NSStringFromGLEnum(name), self.originalValue,
+			 (self.valueIsKnown ? [NSString stringWithFormat: @"%i", self.value] : @"UNKNOWN"));
 }
 
 -(void) logSetValue {
-	LogTrace(@"%@ set %@ = %i", [self class], NSStringFromGLEnum(name), value);
+	LogTrace(@"%@ set %@ = %i", [self class], NSStringFromGLEnum(name), self.value);
 }
 
 -(void) logReuseValue {
-	LogTrace(@"%@ reuse %@ = %i", [self class], NSStringFromGLEnum(name), value);
-}
-
--(void) restoreOriginalValue {
-	value = originalValue;
+	LogTrace(@"%@ reuse %@ = %i", [self class], NSStringFromGLEnum(name), self.value);
 }
 
 -(NSString*) description {
@@ -598,7 +693,13 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 
 @implementation CC3OpenGLES11StateTrackerEnumeration
 
-@synthesize value, originalValue, setGLFunction;
+@synthesize setGLFunction;
+
++(CC3GLESStateKind) stateKind { return kCC3GLESStateKindInteger; }
+
+-(CC3GLESStateReadMode) stateReadMode {
+	return CC3GLESStateReadModeFor(self, [CC3OpenGLES11StateTrackerEnumeration class], kCC3GLESStateReadInteger);
+}
 
 -(id) initWithParent: (CC3OpenGLES11StateTracker*) aTracker
 			forState: (GLenum) aName
@@ -650,45 +751,48 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 				andOriginalValueHandling: origValueHandling] autorelease];
 }
 
+-(GLenum) value { return (GLenum)*CC3GLESStateCacheInts(stateCache, stateEntry); }
+
 -(void) setValue: (GLenum) aValue {
-	if (shouldAlwaysSetGL || !valueIsKnown || aValue != value) {
-		value = aValue;
+	if (CC3GLESStateCacheUpdateInts(stateCache, stateEntry, (GLint*)&aValue)) {
 		[self setGLValueAndNotify];
 	} else {
 		[self logReuseValue];
-	}	
+	}
 }
 
 -(void) setValueRaw: (GLenum) aValue {
-	value = aValue;
+	*CC3GLESStateCacheInts(stateCache, stateEntry) = (GLint)aValue;
+}
+
+-(GLenum) originalValue { return (GLenum)*CC3GLESStateCacheOriginalInts(stateCache, stateEntry); }
+
+-(void) setOriginalValue: (GLenum) aValue {
+	*CC3GLESStateCacheOriginalInts(stateCache, stateEntry) = (GLint)aValue;
 }
 
 -(void) setGLValue {
 	if( setGLFunction ) {
-		setGLFunction(value);
+		setGLFunction(self.value);
 	}
 }
 
 -(void) getGLValue {
-	glGetIntegerv(name, (GLint*)&originalValue);
+	glGetIntegerv(name, CC3GLESStateCacheOriginalInts(stateCache, stateEntry));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %@ (was tracking %@)",
-			 [self class], NSStringFromGLEnum(name), NSStringFromGLEnum(originalValue),
-			 (valueIsKnown ? NSStringFromGLEnum(value) : @"UNKNOWN"));
+			 [self class], NSStringFromGLEnum(name), NSStringFromGLEnum(self.originalValue),
+			 (self.valueIsKnown ? NSStringFromGLEnum(self.value) : @"UNKNOWN"));
 }
 
 -(void) logSetValue {
-	LogTrace(@"%@ set %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromGLEnum(value));
+	LogTrace(@"%@ set %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromGLEnum(self.value));
 }
 
 -(void) logReuseValue {
-	LogTrace(@"%@ reuse %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromGLEnum(value));
-}
-
--(void) restoreOriginalValue {
-	value = originalValue;
+	LogTrace(@"%@ reuse %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromGLEnum(self.value));
 }
 
 -(NSString*) description {
@@ -704,7 +808,15 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 
 @implementation CC3OpenGLES11StateTrackerColor
 
-@synthesize value, originalValue, setGLFunction;
+@synthesize setGLFunction;
+
++(CC3GLESStateKind) stateKind { return kCC3GLESStateKindFloat; }
+
++(GLuint) stateWidth { return 4; }
+
+-(CC3GLESStateReadMode) stateReadMode {
+	return CC3GLESStateReadModeFor(self, [CC3OpenGLES11StateTrackerColor class], kCC3GLESStateReadFloat);
+}
 
 -(id) initWithParent: (CC3OpenGLES11StateTracker*) aTracker
 			forState: (GLenum) aName
@@ -756,45 +868,49 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 				andOriginalValueHandling: origValueHandling] autorelease];
 }
 
+-(ccColor4F) value { return *(ccColor4F*)CC3GLESStateCacheFloats(stateCache, stateEntry); }
+
 -(void) setValue: (ccColor4F) aColor {
-	if (shouldAlwaysSetGL || !valueIsKnown || !CCC4FAreEqual(aColor, value)) {
-		value = aColor;
+	if (CC3GLESStateCacheUpdateFloats(stateCache, stateEntry, (GLfloat*)&aColor)) {
 		[self setGLValueAndNotify];
 	} else {
 		[self logReuseValue];
-	}	
+	}
 }
 
 -(void) setValueRaw: (ccColor4F) aValue {
-	value = aValue;
+	*(ccColor4F*)CC3GLESStateCacheFloats(stateCache, stateEntry) = aValue;
+}
+
+-(ccColor4F) originalValue { return *(ccColor4F*)CC3GLESStateCacheOriginalFloats(stateCache, stateEntry); }
+
+-(void) setOriginalValue: (ccColor4F) aValue {
+	*(ccColor4F*)CC3GLESStateCacheOriginalFloats(stateCache, stateEntry) = aValue;
 }
 
 -(void) setGLValue {
 	if( setGLFunction ) {
-		setGLFunction(value.r, value.g, value.b, value.a);
+		ccColor4F aColor = self.value;
+		setGLFunction(aColor.r, aColor.g, aColor.b, aColor.a);
 	}
 }
 
 -(void) getGLValue {
-	glGetFloatv(name, (GLfloat*)&originalValue);
+	glGetFloatv(name, CC3GLESStateCacheOriginalFloats(stateCache, stateEntry));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %@ (was tracking %@)", 
-			 [self class], NSStringFromGLEnum(name), NSStringFromCCC4F(originalValue),
-			 (valueIsKnown ? NSStringFromCCC4F(value) : @"UNKNOWN"));
+			 [self class], NSStringFromGLEnum(name), NSStringFromCCC4F(self.originalValue),
+			 (self.valueIsKnown ? NSStringFromCCC4F(self.value) : @"UNKNOWN"));
 }
 
 -(void) logSetValue {
-	LogTrace(@"%@ set %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCCC4F(value));
+	LogTrace(@"%@ set %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCCC4F(self.value));
 }
 
 -(void) logReuseValue {
-	LogTrace(@"%@ reuse %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCCC4F(value));
-}
-
--(void) restoreOriginalValue {
-	value = originalValue;
+	LogTrace(@"%@ reuse %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCCC4F(self.value));
 }
 
 -(NSString*) description {
@@ -877,8 +993,7 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 }
 
 -(void) setValue: (ccColor4F) aColor {
-	if (shouldAlwaysSetGL || !valueIsKnown || !CCC4FAreEqual(aColor, value)) {
-		value = aColor;
+	if (CC3GLESStateCacheUpdateFloats(stateCache, stateEntry, (GLfloat*)&aColor)) {
 		[self setGLValueAndNotify];
 		fixedValueIsKnown = NO;
 	} else {
@@ -897,7 +1012,7 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 		[self setGLFixedValue];
 		[self notifyGLChanged];
 		fixedValueIsKnown = YES;
-		valueIsKnown = NO;
+		self.valueIsKnown = NO;
 		[self logSetFixedValue];
 	} else {
 		[self logReuseFixedValue];
@@ -932,7 +1047,15 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 
 @implementation CC3OpenGLES11StateTrackerViewport
 
-@synthesize value, originalValue, setGLFunction;
+@synthesize setGLFunction;
+
++(CC3GLESStateKind) stateKind { return kCC3GLESStateKindInteger; }
+
++(GLuint) stateWidth { return 4; }
+
+-(CC3GLESStateReadMode) stateReadMode {
+	return CC3GLESStateReadModeFor(self, [CC3OpenGLES11StateTrackerViewport class], kCC3GLESStateReadInteger);
+}
 
 -(id) initWithParent: (CC3OpenGLES11StateTracker*) aTracker
 			forState: (GLenum) aName
@@ -984,45 +1107,49 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 				andOriginalValueHandling: origValueHandling] autorelease];
 }
 
+-(CC3Viewport) value { return *(CC3Viewport*)CC3GLESStateCacheInts(stateCache, stateEntry); }
+
 -(void) setValue: (CC3Viewport) aViewport {
-	if (shouldAlwaysSetGL || !valueIsKnown || !CC3ViewportsAreEqual(aViewport, value)) {
-		value = aViewport;
+	if (CC3GLESStateCacheUpdateInts(stateCache, stateEntry, (GLint*)&aViewport)) {
 		[self setGLValueAndNotify];
 	} else {
 		[self logReuseValue];
-	}	
+	}
 }
 
 -(void) setValueRaw: (CC3Viewport) aValue {
-	value = aValue;
+	*(CC3Viewport*)CC3GLESStateCacheInts(stateCache, stateEntry) = aValue;
+}
+
+-(CC3Viewport) originalValue { return *(CC3Viewport*)CC3GLESStateCacheOriginalInts(stateCache, stateEntry); }
+
+-(void) setOriginalValue: (CC3Viewport) aValue {
+	*(CC3Viewport*)CC3GLESStateCacheOriginalInts(stateCache, stateEntry) = aValue;
 }
 
 -(void) setGLValue {
 	if( setGLFunction ) {
-		setGLFunction(value.x, value.y, value.w, value.h);
+		CC3Viewport vp = self.value;
+		setGLFunction(vp.x, vp.y, vp.w, vp.h);
 	}
 }
 
 -(void) getGLValue {
-	glGetIntegerv(name, (GLint*)&originalValue);
+	glGetIntegerv(name, CC3GLESStateCacheOriginalInts(stateCache, stateEntry));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %@ (was tracking %@)", 
-			 [self class], NSStringFromGLEnum(name), NSStringFromCC3Viewport(originalValue),
-			 (valueIsKnown ? NSStringFromCC3Viewport(value) : @"UNKNOWN"));
+			 [self class], NSStringFromGLEnum(name), NSStringFromCC3Viewport(self.originalValue),
+			 (self.valueIsKnown ? NSStringFromCC3Viewport(self.value) : @"UNKNOWN"));
 }
 
 -(void) logSetValue {
-	LogTrace(@"%@ set %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCC3Viewport(value));
+	LogTrace(@"%@ set %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCC3Viewport(self.value));
 }
 
 -(void) logReuseValue {
-	LogTrace(@"%@ reuse %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCC3Viewport(value));
-}
-
--(void) restoreOriginalValue {
-	value = originalValue;
+	LogTrace(@"%@ reuse %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCC3Viewport(self.value));
 }
 
 -(NSString*) description {
@@ -1038,41 +1165,46 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 
 @implementation CC3OpenGLES11StateTrackerPointer
 
-@synthesize value, originalValue;
++(CC3GLESStateKind) stateKind { return kCC3GLESStateKindPointer; }
+
+-(GLvoid*) value { return (GLvoid*)*CC3GLESStateCachePointer(stateCache, stateEntry); }
 
 -(void) setValue: (GLvoid*) aValue {
-	if (shouldAlwaysSetGL || !valueIsKnown || aValue != value) {
-		value = aValue;
+	if (CC3GLESStateCacheUpdatePointer(stateCache, stateEntry, aValue)) {
 		[self setGLValueAndNotify];
 	} else {
 		[self logReuseValue];
-	}	
+	}
 }
 
 -(void) setValueRaw: (GLvoid*) aValue {
-	value = aValue;
+	*CC3GLESStateCachePointer(stateCache, stateEntry) = aValue;
+}
+
+-(GLvoid*) originalValue { return (GLvoid*)*CC3GLESStateCacheOriginalPointer(stateCache, stateEntry); }
+
+-(void) setOriginalValue: (GLvoid*) aValue {
+	*CC3GLESStateCacheOriginalPointer(stateCache, stateEntry) = aValue;
 }
 
 -(void) getGLValue {
-	glGetIntegerv(name, (GLint*)&originalValue);
+	GLint glValue;
+	glGetIntegerv(name, &glValue);
+	self.originalValue = (GLvoid*)(long)glValue;
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %p (was tracking %@)",
-			 [self class], NSStringFromGLEnum(name), originalValue,
-			 (valueIsKnown ? [NSString stringWithFormat: @"%p", value] : @"UNKNOWN"));
+			 [self class], NSStringFromGLEnum(name), self.originalValue,
+			 (self.valueIsKnown ? [NSString stringWithFormat: @"%p", self.value] : @"UNKNOWN"));
 }
 
 -(void) logSetValue {
-	LogTrace(@"%@ set %@ = %p", [self class], NSStringFromGLEnum(name), value);
+	LogTrace(@"%@ set %@ = %p", [self class], NSStringFromGLEnum(name), self.value);
 }
 
 -(void) logReuseValue {
-	LogTrace(@"%@ reuse %@ = %p", [self class], NSStringFromGLEnum(name), value);
-}
-
--(void) restoreOriginalValue {
-	value = originalValue;
+	LogTrace(@"%@ reuse %@ = %p", [self class], NSStringFromGLEnum(name), self.value);
 }
 
 -(NSString*) description {
@@ -1088,41 +1220,50 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 
 @implementation CC3OpenGLES11StateTrackerVector
 
-@synthesize value, originalValue;
++(CC3GLESStateKind) stateKind { return kCC3GLESStateKindFloat; }
+
++(GLuint) stateWidth { return 3; }
+
+-(CC3GLESStateReadMode) stateReadMode {
+	return CC3GLESStateReadModeFor(self, [CC3OpenGLES11StateTrackerVector class], kCC3GLESStateReadFloat);
+}
+
+-(CC3Vector) value { return *(CC3Vector*)CC3GLESStateCacheFloats(stateCache, stateEntry); }
 
 -(void) setValue: (CC3Vector) aVector {
-	if (shouldAlwaysSetGL || !valueIsKnown || !CC3VectorsAreEqual(aVector, value)) {
-		value = aVector;
+	if (CC3GLESStateCacheUpdateFloats(stateCache, stateEntry, (GLfloat*)&aVector)) {
 		[self setGLValueAndNotify];
 	} else {
 		[self logReuseValue];
-	}	
+	}
 }
 
 -(void) setValueRaw: (CC3Vector) aValue {
-	value = aValue;
+	*(CC3Vector*)CC3GLESStateCacheFloats(stateCache, stateEntry) = aValue;
+}
+
+-(CC3Vector) originalValue { return *(CC3Vector*)CC3GLESStateCacheOriginalFloats(stateCache, stateEntry); }
+
+-(void) setOriginalValue: (CC3Vector) aValue {
+	*(CC3Vector*)CC3GLESStateCacheOriginalFloats(stateCache, stateEntry) = aValue;
 }
 
 -(void) getGLValue {
-	glGetFloatv(name, (GLfloat*)&originalValue);
+	glGetFloatv(name, CC3GLESStateCacheOriginalFloats(stateCache, stateEntry));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %@ (was tracking %@)", 
-			 [self class], NSStringFromGLEnum(name), NSStringFromCC3Vector(originalValue),
-			 (valueIsKnown ? NSStringFromCC3Vector(value) : @"UNKNOWN"));
+			 [self class], NSStringFromGLEnum(name), NSStringFromCC3Vector(self.originalValue),
+			 (self.valueIsKnown ? NSStringFromCC3Vector(self.value) : @"UNKNOWN"));
 }
 
 -(void) logSetValue {
-	LogTrace(@"%@ set %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCC3Vector(value));
+	LogTrace(@"%@ set %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCC3Vector(self.value));
 }
 
 -(void) logReuseValue {
-	LogTrace(@"%@ reuse %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCC3Vector(value));
-}
-
--(void) restoreOriginalValue {
-	value = originalValue;
+	LogTrace(@"%@ reuse %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCC3Vector(self.value));
 }
 
 -(NSString*) description {
@@ -1138,41 +1279,50 @@ andOriginalValueHandling: (CC3GLESStateOriginalValueHandling) origValueHandling
 
 @implementation CC3OpenGLES11StateTrackerVector4
 
-@synthesize value, originalValue;
++(CC3GLESStateKind) stateKind { return kCC3GLESStateKindFloat; }
+
++(GLuint) stateWidth { return 4; }
+
+-(CC3GLESStateReadMode) stateReadMode {
+	return CC3GLESStateReadModeFor(self, [CC3OpenGLES11StateTrackerVector4 class], kCC3GLESStateReadFloat);
+}
+
+-(CC3Vector4) value { return *(CC3Vector4*)CC3GLESStateCacheFloats(stateCache, stateEntry); }
 
 -(void) setValue: (CC3Vector4) aVector {
-	if (shouldAlwaysSetGL || !valueIsKnown || !CC3Vector4sAreEqual(aVector, value)) {
-		value = aVector;
+	if (CC3GLESStateCacheUpdateFloats(stateCache, stateEntry, (GLfloat*)&aVector)) {
 		[self setGLValueAndNotify];
 	} else {
 		[self logReuseValue];
-	}	
+	}
 }
 
 -(void) setValueRaw: (CC3Vector4) aValue {
-	value = aValue;
+	*(CC3Vector4*)CC3GLESStateCacheFloats(stateCache, stateEntry) = aValue;
+}
+
+-(CC3Vector4) originalValue { return *(CC3Vector4*)CC3GLESStateCacheOriginalFloats(stateCache, stateEntry); }
+
+-(void) setOriginalValue: (CC3Vector4) aValue {
+	*(CC3Vector4*)CC3GLESStateCacheOriginalFloats(stateCache, stateEntry) = aValue;
 }
 
 -(void) getGLValue {
-	glGetFloatv(name, (GLfloat*)&originalValue);
+	glGetFloatv(name, CC3GLESStateCacheOriginalFloats(stateCache, stateEntry));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %@ (was tracking %@)", 
-			 [self class], NSStringFromGLEnum(name), NSStringFromCC3Vector4(originalValue),
-			 (valueIsKnown ? NSStringFromCC3Vector4(value) : @"UNKNOWN"));
+			 [self class], NSStringFromGLEnum(name), NSStringFromCC3Vector4(self.originalValue),
+			 (self.valueIsKnown ? NSStringFromCC3Vector4(self.value) : @"UNKNOWN"));
 }
 
 -(void) logSetValue {
-	LogTrace(@"%@ set %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCC3Vector4(value));
+	LogTrace(@"%@ set %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCC3Vector4(self.value));
 }
 
 -(void) logReuseValue {
-	LogTrace(@"%@ reuse %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCC3Vector4(value));
-}
-
--(void) restoreOriginalValue {
-	value = originalValue;
+	LogTrace(@"%@ reuse %@ = %@", [self class], NSStringFromGLEnum(name), NSStringFromCC3Vector4(self.value));
 }
 
 -(NSString*) description {
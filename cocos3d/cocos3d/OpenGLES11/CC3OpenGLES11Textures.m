@@ -43,7 +43,7 @@
 }
 
 -(GLenum) glEnumValue {
-	return GL_TEXTURE0 + value;
+	return GL_TEXTURE0 + self.value;
 }
 
 -(void) setGLValue {
@@ -54,7 +54,7 @@
 
 -(void) getGLValue {
 	[super getGLValue];
-	originalValue -= GL_TEXTURE0;
+	self.originalValue -= GL_TEXTURE0;
 }
 
 -(NSString*) description {
@@ -82,7 +82,7 @@
 
 -(void) setGLValue {
 	[self.textureUnit activate];
-	glBindTexture(GL_TEXTURE_2D, value);
+	glBindTexture(GL_TEXTURE_2D, self.value);
 }
 
 -(void) unbind {
@@ -91,21 +91,21 @@
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %i (was tracking %@) for texture unit %@",
-			 [self class], NSStringFromGLEnum(name), originalValue,
-			 (valueIsKnown ? [NSString stringWithFormat: @"%i", value] : @"UNKNOWN"),
+			 [self class], NSStringFromGLEnum(name), self.originalValue,
+			 (self.valueIsKnown ? [NSString stringWithFormat: @"%i", self.value] : @"UNKNOWN"),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
 -(void) logSetValue {
 	LogTrace(@"%@ set %@ = %i for texture unit %@", [self class],
-			 NSStringFromGLEnum(name), value,
+			 NSStringFromGLEnum(name), self.value,
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 
 }
 
 -(void) logReuseValue {
 	LogTrace(@"%@ reuse %@ = %i for texture unit %@", [self class],
-			 NSStringFromGLEnum(name), value,
+			 NSStringFromGLEnum(name), self.value,
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 
 }
@@ -134,30 +134,30 @@
 
 -(void) getGLValue {
 	[self.textureUnit activate];
-	glGetTexEnviv(GL_TEXTURE_ENV, name, (GLint*)&originalValue);
+	glGetTexEnviv(GL_TEXTURE_ENV, name, CC3GLESStateCacheOriginalInts(stateCache, stateEntry));
 }
 
 -(void) setGLValue {
 	[self.textureUnit activate];
-	glTexEnvi(GL_TEXTURE_ENV, name, value);
+	glTexEnvi(GL_TEXTURE_ENV, name, self.value);
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %@ (was tracking %@) for texture unit %@",
-			 [self class], NSStringFromGLEnum(name), NSStringFromGLEnum(originalValue),
-			 (valueIsKnown ? NSStringFromGLEnum(value) : @"UNKNOWN"),
+			 [self class], NSStringFromGLEnum(name), NSStringFromGLEnum(self.originalValue),
+			 (self.valueIsKnown ? NSStringFromGLEnum(self.value) : @"UNKNOWN"),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
 -(void) logSetValue {
 	LogTrace(@"%@ set %@ = %@ for texture unit %@", [self class],
-			 NSStringFromGLEnum(name), NSStringFromGLEnum(value),
+			 NSStringFromGLEnum(name), NSStringFromGLEnum(self.value),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
 -(void) logReuseValue {
 	LogTrace(@"%@ reuse %@ = %@ for texture unit %@", [self class],
-			 NSStringFromGLEnum(name), NSStringFromGLEnum(value),
+			 NSStringFromGLEnum(name), NSStringFromGLEnum(self.value),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
@@ -181,30 +181,30 @@
 
 -(void) getGLValue {
 	[self.textureUnit activate];
-	glGetTexParameteriv(GL_TEXTURE_2D, name, (GLint*)&originalValue);
+	glGetTexParameteriv(GL_TEXTURE_2D, name, CC3GLESStateCacheOriginalInts(stateCache, stateEntry));
 }
 
 -(void) setGLValue {
 	[self.textureUnit activate];
-	glTexParameteri(GL_TEXTURE_2D, name, value);
+	glTexParameteri(GL_TEXTURE_2D, name, self.value);
 }
 
 -(void) logGetGLValue {
 	LogCleanTrace(@"%@ %@ read GL value %@ (was tracking %@) for texture unit %@",
-			 [self class], NSStringFromGLEnum(name), NSStringFromGLEnum(originalValue),
-			 (valueIsKnown ? NSStringFromGLEnum(value) : @"UNKNOWN"),
+			 [self class], NSStringFromGLEnum(name), NSStringFromGLEnum(self.originalValue),
+			 (self.valueIsKnown ? NSStringFromGLEnum(self.value) : @"UNKNOWN"),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
 -(void) logSetValue {
 	LogCleanTrace(@"%@ set %@ = %@ for texture unit %@", [self class],
-			 NSStringFromGLEnum(name), NSStringFromGLEnum(value),
+			 NSStringFromGLEnum(name), NSStringFromGLEnum(self.value),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
 -(void) logReuseValue {
 	LogCleanTrace(@"%@ reuse %@ = %@ for texture unit %@", [self class],
-			 NSStringFromGLEnum(name), NSStringFromGLEnum(value),
+			 NSStringFromGLEnum(name), NSStringFromGLEnum(self.value),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
@@ -228,30 +228,30 @@
 	[self.textureUnit activate];
 	GLint glValue;
 	glGetTexParameteriv(GL_TEXTURE_2D, name, &glValue);
-	originalValue = (glValue != GL_FALSE);
+	self.originalValue = (glValue != GL_FALSE);
 }
 
 -(void) setGLValue {
 	[self.textureUnit activate];
-	glTexParameteri(GL_TEXTURE_2D, name, (value ? GL_TRUE : GL_FALSE));
+	glTexParameteri(GL_TEXTURE_2D, name, (self.value ? GL_TRUE : GL_FALSE));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %@ (was tracking %@) for texture unit %@",
-			 [self class], NSStringFromGLEnum(name), (originalValue ? @"ENABLED" : @"DISABLED"),
-			 (valueIsKnown ? NSStringFromGLEnum(value) : @"UNKNOWN"),
+			 [self class], NSStringFromGLEnum(name), (self.originalValue ? @"ENABLED" : @"DISABLED"),
+			 (self.valueIsKnown ? NSStringFromGLEnum(self.value) : @"UNKNOWN"),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
 -(void) logSetValue {
 	LogTrace(@"%@ set %@ = %@ for texture unit %@", [self class],
-			 NSStringFromGLEnum(name), (value ? @"ENABLED" : @"DISABLED"),
+			 NSStringFromGLEnum(name), (self.value ? @"ENABLED" : @"DISABLED"),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
 -(void) logReuseValue {
 	LogTrace(@"%@ reuse %@ = %@ for texture unit %@", [self class],
-			 NSStringFromGLEnum(name), (value ? @"ENABLED" : @"DISABLED"),
+			 NSStringFromGLEnum(name), (self.value ? @"ENABLED" : @"DISABLED"),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
@@ -275,30 +275,30 @@
 
 -(void) getGLValue {
 	[self.textureUnit activate];
-	glGetTexEnvfv(GL_TEXTURE_ENV, name, (GLfloat*)&originalValue);
+	glGetTexEnvfv(GL_TEXTURE_ENV, name, CC3GLESStateCacheOriginalFloats(stateCache, stateEntry));
 }
 
 -(void) setGLValue {
 	[self.textureUnit activate];
-	glTexEnvfv(GL_TEXTURE_ENV, name, (GLfloat*)&value);
+	glTexEnvfv(GL_TEXTURE_ENV, name, CC3GLESStateCacheFloats(stateCache, stateEntry));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %@ (was tracking %@) for texture unit %@", 
-			 [self class], NSStringFromGLEnum(name), NSStringFromCCC4F(originalValue),
-			 (valueIsKnown ? NSStringFromCCC4F(value) : @"UNKNOWN"),
+			 [self class], NSStringFromGLEnum(name), NSStringFromCCC4F(self.originalValue),
+			 (self.valueIsKnown ? NSStringFromCCC4F(self.value) : @"UNKNOWN"),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
 -(void) logSetValue {
 	LogTrace(@"%@ set %@ = %@ for texture unit %@", [self class],
-			 NSStringFromGLEnum(name), NSStringFromCCC4F(value),
+			 NSStringFromGLEnum(name), NSStringFromCCC4F(self.value),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
 -(void) logReuseValue {
 	LogTrace(@"%@ reuse %@ = %@ for texture unit %@", [self class],
-			 NSStringFromGLEnum(name), NSStringFromCCC4F(value),
+			 NSStringFromGLEnum(name), NSStringFromCCC4F(self.value),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
@@ -332,20 +332,20 @@
 
 -(void) logSetValue {
 	LogTrace(@"%@ set %@ = %@ for texture unit %@", [self class],
-			 NSStringFromGLEnum(name), (value ? @"ENABLED" : @"DISABLED"),
+			 NSStringFromGLEnum(name), (self.value ? @"ENABLED" : @"DISABLED"),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
 -(void) logReuseValue {
 	LogTrace(@"%@ reuse %@ = %@ for texture unit %@", [self class],
-			 NSStringFromGLEnum(name), (value ? @"ENABLED" : @"DISABLED"),
+			 NSStringFromGLEnum(name), (self.value ? @"ENABLED" : @"DISABLED"),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %@ (was tracking %@) for texture unit %@", 
-			 [self class], NSStringFromGLEnum(name), (originalValue ? @"ENABLED" : @"DISABLED"),
-			 (valueIsKnown ? (value ? @"ENABLED" : @"DISABLED") : @"UNKNOWN"),
+			 [self class], NSStringFromGLEnum(name), (self.originalValue ? @"ENABLED" : @"DISABLED"),
+			 (self.valueIsKnown ? (self.value ? @"ENABLED" : @"DISABLED") : @"UNKNOWN"),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
@@ -366,12 +366,12 @@
 	GLint* origIntVal;
 	[self.textureUnit activate];
 	glGetTexEnviv(GL_POINT_SPRITE_OES, name, (GLint*)&origIntVal);
-	originalValue = (origIntVal != GL_FALSE);
+	self.originalValue = (origIntVal != GL_FALSE);
 }
 
 -(void) setGLValue {
 	[self.textureUnit activate];
-	glTexEnvi(GL_POINT_SPRITE_OES, name, (value ? GL_TRUE : GL_FALSE));
+	glTexEnvi(GL_POINT_SPRITE_OES, name, (self.value ? GL_TRUE : GL_FALSE));
 }
 
 @end
@@ -399,20 +399,20 @@
 
 -(void) logSetValue {
 	LogTrace(@"%@ set %@ = %@ for texture unit %@", [self class],
-			 NSStringFromGLEnum(name), (value ? @"ENABLED" : @"DISABLED"),
+			 NSStringFromGLEnum(name), (self.value ? @"ENABLED" : @"DISABLED"),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
 -(void) logReuseValue {
 	LogTrace(@"%@ reuse %@ = %@ for texture unit %@", [self class],
-			 NSStringFromGLEnum(name), (value ? @"ENABLED" : @"DISABLED"),
+			 NSStringFromGLEnum(name), (self.value ? @"ENABLED" : @"DISABLED"),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %@ (was tracking %@) for texture unit %@", 
-			 [self class], NSStringFromGLEnum(name), (originalValue ? @"ENABLED" : @"DISABLED"),
-			 (valueIsKnown ? (value ? @"ENABLED" : @"DISABLED") : @"UNKNOWN"),
+			 [self class], NSStringFromGLEnum(name), (self.originalValue ? @"ENABLED" : @"DISABLED"),
+			 (self.valueIsKnown ? (self.value ? @"ENABLED" : @"DISABLED") : @"UNKNOWN"),
 			 NSStringFromGLEnum(self.textureUnit.glEnumValue));
 }
 
@@ -52,17 +52,17 @@
 }
 
 -(void) setGLValue {
-	glBindBuffer(name, value);
+	glBindBuffer(name, self.value);
 }
 
 -(void) getGLValue {
-	glGetIntegerv(queryName, &originalValue);
+	glGetIntegerv(queryName, CC3GLESStateCacheOriginalInts(stateCache, stateEntry));
 }
 
 -(void) logGetGLValue {
 	LogTrace(@"%@ %@ read GL value %i (was tracking %@)",
-			 [self class], NSStringFromGLEnum(queryName), originalValue,
-			 (valueIsKnown ? [NSString stringWithFormat: @"%i", value] : @"UNKNOWN"));
+			 [self class], NSStringFromGLEnum(queryName), self.originalValue,
+			 (self.valueIsKnown ? [NSString stringWithFormat: @"%i", self.value] : @"UNKNOWN"));
 }
 
 -(void) unbind {